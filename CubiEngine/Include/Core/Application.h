@@ -4,6 +4,7 @@
 #include "Core/Input.h"
 
 class FRenderer;
+class FFramePipeline;
 
 class Application
 {
@@ -11,10 +12,17 @@ public:
     Application(const std::string& Title);
     virtual ~Application();
 
+    // -headless : hidden window and a headless RHI, -frames=N : quit after N frames and log the CPU frame cost.
+    // -bakepvs : bake and save the PVS of the startup scene, then quit.
+    // -set:Name=Value : overrides a render setting once the startup scene loaded, e.g. -set:ShadowMethod=2.
+    // -expectpasses=A,B : the run fails unless exactly these render passes were created.
+    // Returns false and logs the argument when a value does not parse.
+    bool ParseCommandLine(int Argc, char* Argv[]);
     bool Init(uint32_t Width, uint32_t Height);
 
-    void Run();
-    void Render(float DeltaTime);
+    // False if the run did not meet what the command line expected of it.
+    bool Run();
+    void Tick(float DeltaTime);
     void Cleanup();
 
     void HandleEvents();
@@ -25,8 +33,20 @@ private:
     std::string WindowTitle;
 
     bool IsRunning;
+    bool bHeadless = false;
+    uint32_t MaxFrames = 0u;
+    bool bBakePVS = false;
+    // -rendermode=N, -1 keeps the scene default.
+    int RenderingModeOverride = -1;
+    std::vector<std::pair<std::string, int>> RenderSettingOverrides;
+    bool bCheckRenderPasses = false;
+    std::vector<std::string> ExpectedRenderPasses;
+    uint32_t NumTickedFrames = 0u;
     
     FRenderer* D3DRenderer;
+    // Renders on its own thread while this thread ticks the next frame.
+    std::unique_ptr<FFramePipeline> FramePipeline;
+    std::vector<SDL_Event> UIEvents;
     FInput Input;
 
     std::chrono::high_resolution_clock::time_point PrevTime;
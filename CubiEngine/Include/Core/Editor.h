@@ -15,6 +15,7 @@ public:
 
     void RenderDebugProperties(FScene* Scene);
     void RenderCameraProperties(FScene* Scene);
+    void RenderSceneProperties(FScene* Scene);
     void RenderGIProperties(FScene* Scene);
     void RenderLightProperties(FScene* Scene);
     void RenderPostProcessProperties(FScene* Scene);
@@ -23,10 +24,14 @@ public:
 
     void OnWindowResized(uint32_t Width, uint32_t Height);
 
+    // Toggled on the game thread, the render thread reads it from the frame snapshot.
+    bool IsUIVisible() const { return bShowUI; }
+
 private:
     SDL_Window* Window;
     std::string IniFilePath;
     uint32_t FontDescriptorIndex{ 0xFFFFFFFFu };
 
     bool bShowUI = true;
+    int SelectedMeshIndex = 0;
 };
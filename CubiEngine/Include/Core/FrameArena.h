@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+// Bump allocator. Allocation moves a cursor, Reset hands everything back at once and never runs destructors,
+// so only put trivially destructible data or containers whose memory also comes from the arena in it.
+// Running out of space chains a new block, the next Reset coalesces the chain into a single larger block.
+class FLinearArena
+{
+public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 64u * 1024u;
+
+    FLinearArena() : FLinearArena(DEFAULT_BLOCK_SIZE) {}
+    explicit FLinearArena(size_t InBlockSize);
+    ~FLinearArena();
+    FLinearArena(const FLinearArena&) = delete;
+    FLinearArena& operator=(const FLinearArena&) = delete;
+
+    void* Allocate(size_t Size, size_t Alignment = alignof(std::max_align_t));
+
+    template<typename T, typename... Args>
+    T* New(Args&&... Arguments)
+    {
+        return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(Arguments)...);
+    }
+
+    void Reset();
+
+    size_t GetUsedBytes() const { return UsedBytes; }
+    size_t GetCapacity() const { return Capacity; }
+    // Largest number of bytes in use at a Reset so far.
+    size_t GetHighWaterMark() const { return HighWaterMark; }
+
+private:
+    struct FBlock
+    {
+        FBlock* Next;
+        size_t Size;
+    };
+
+    void AllocateBlock(size_t MinSize);
+    void FreeBlocks();
+
+    FBlock* CurrentBlock = nullptr;
+    uint8_t* Cursor = nullptr;
+    uint8_t* End = nullptr;
+
+    size_t BlockSize;
+    size_t UsedBytes = 0u;
+    size_t Capacity = 0u;
+    size_t HighWaterMark = 0u;
+};
+
+// STL allocator over an arena, deallocate is a no-op. Reserve up front where possible, a growing
+// container leaves its old buffers behind until the arena resets.
+template<typename T>
+class TArenaAllocator
+{
+public:
+    using value_type = T;
+
+    TArenaAllocator(FLinearArena& InArena) noexcept : Arena(&InArena) {}
+
+    template<typename U>
+    TArenaAllocator(const TArenaAllocator<U>& Other) noexcept : Arena(Other.Arena) {}
+
+    T* allocate(size_t Count)
+    {
+        return static_cast<T*>(Arena->Allocate(Count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {}
+
+    template<typename U>
+    bool operator==(const TArenaAllocator<U>& Other) const noexcept { return Arena == Other.Arena; }
+
+private:
+    template<typename U>
+    friend class TArenaAllocator;
+
+    FLinearArena* Arena;
+};
+
+template<typename T>
+using TArenaVector = std::vector<T, TArenaAllocator<T>>;
+
+// One arena per thread per frame in flight. A thread resets its own arena for the current frame the first
+// time it asks for it after BeginFrame, so no thread ever touches another's arena and the hot path takes no lock.
+// Memory handed out during frame N stays valid until frame N + FRAMES_IN_FLIGHT begins, which covers
+// anything the GPU reads while the frame is in flight.
+class FFrameArenas
+{
+public:
+    // Render thread, once per frame before the frame allocates anything.
+    void BeginFrame();
+
+    FLinearArena& GetThreadArena();
+
+private:
+    struct FThreadArenas
+    {
+        std::array<FLinearArena, FRAMES_IN_FLIGHT> Arenas;
+        uint64_t FrameIndex = 0u;
+    };
+
+    std::atomic<uint64_t> FrameIndex{ 0u };
+
+    // Owns every thread's arenas, threads only register here once.
+    std::mutex RegistrationMutex;
+    std::vector<std::unique_ptr<FThreadArenas>> ThreadArenas;
+};
+
+extern FFrameArenas GFrameArenas;
+
+inline FLinearArena& GetFrameArena()
+{
+    return GFrameArenas.GetThreadArena();
+}
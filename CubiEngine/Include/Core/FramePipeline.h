@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Scene/FrameSnapshot.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// What the render thread drives. FRenderer records and presents, a fake implementation
+// can simply count frames, which keeps the pipeline usable without a device or a window.
+class FFrameRenderer
+{
+public:
+    virtual ~FFrameRenderer() = default;
+
+    virtual void RenderFrame(const FFrameSnapshot& Snapshot) = 0;
+    // Called on the render thread once every submitted frame was rendered, waits for the GPU.
+    virtual void FlushFrames() = 0;
+};
+
+// Runs FFrameRenderer on its own thread so the game thread can build frame N + 1 while frame N is recorded.
+// Snapshots live in a small ring : the game thread fills one while the render thread reads another, and
+// BeginFrame blocks once MaxFramesAhead frames are waiting, which bounds input to display latency.
+class FFramePipeline
+{
+public:
+    explicit FFramePipeline(FFrameRenderer& InRenderer, uint32_t MaxFramesAhead = 1u);
+    ~FFramePipeline();
+
+    // Game thread. Returns the snapshot to fill for the next frame, blocking while the ring is full.
+    FFrameSnapshot& BeginFrame();
+    // Game thread. Publishes the snapshot returned by BeginFrame to the render thread.
+    void EndFrame();
+
+    // Blocks until every published frame was rendered and the renderer flushed the GPU.
+    // The render thread is idle when this returns, until the next EndFrame.
+    void Flush();
+    // Flushes and joins the render thread, frames published before Stop are always rendered.
+    void Stop();
+
+    uint64_t GetNumSubmittedFrames() const;
+    uint64_t GetNumRenderedFrames() const;
+
+private:
+    void RenderThreadLoop();
+
+    FFrameRenderer& Renderer;
+
+    std::vector<std::unique_ptr<FFrameSnapshot>> Snapshots;
+
+    mutable std::mutex Mutex;
+    std::condition_variable FrameSubmitted;
+    std::condition_variable FrameRendered;
+
+    uint64_t NumSubmittedFrames = 0u;
+    uint64_t NumRenderedFrames = 0u;
+    uint64_t NumFlushRequests = 0u;
+    uint64_t NumCompletedFlushes = 0u;
+    bool bFrameInProgress = false;
+    bool bQuit = false;
+
+    std::thread RenderThread;
+};
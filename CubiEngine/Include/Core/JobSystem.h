@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+struct FJob;
+class FJobSystem;
+
+// Tracks outstanding jobs. Jobs scheduled with a counter increment it when scheduled
+// and decrement it when they finish, so a counter doubles as a dependency for later jobs.
+class FJobCounter
+{
+public:
+    FJobCounter() = default;
+    FJobCounter(const FJobCounter&) = delete;
+    FJobCounter& operator=(const FJobCounter&) = delete;
+
+    bool IsDone() const { return Pending.load() == 0u && Busy.load() == 0u; }
+
+private:
+    friend class FJobSystem;
+
+    std::atomic<uint32_t> Pending{ 0u };
+    // Non zero while a finishing job is still touching the counter, keeps Wait from returning early.
+    std::atomic<uint32_t> Busy{ 0u };
+
+    std::mutex ContinuationMutex;
+    std::vector<FJob*> Continuations;
+};
+
+struct FJob
+{
+    std::function<void()> Function;
+    FJobCounter* Counter = nullptr;
+};
+
+// Chase-Lev work stealing deque. The owning worker pushes and pops at the bottom,
+// every other thread steals from the top.
+class FWorkStealingQueue
+{
+public:
+    FWorkStealingQueue(uint32_t InitialCapacity = 1024u);
+    ~FWorkStealingQueue();
+
+    void Push(FJob* Job);
+    FJob* Pop();
+    FJob* Steal();
+
+private:
+    struct FRingBuffer
+    {
+        explicit FRingBuffer(int64_t InCapacity);
+
+        FJob* Load(int64_t Index) const { return Items[Index & Mask].load(std::memory_order_relaxed); }
+        void Store(int64_t Index, FJob* Job) { Items[Index & Mask].store(Job, std::memory_order_relaxed); }
+        FRingBuffer* Grow(int64_t Bottom, int64_t Top) const;
+
+        int64_t Capacity;
+        int64_t Mask;
+        std::unique_ptr<std::atomic<FJob*>[]> Items;
+    };
+
+    alignas(64) std::atomic<int64_t> Top{ 0 };
+    alignas(64) std::atomic<int64_t> Bottom{ 0 };
+    std::atomic<FRingBuffer*> Buffer;
+
+    // Thieves may still read an old buffer after a grow, so retired buffers live until the queue dies.
+    std::vector<std::unique_ptr<FRingBuffer>> RetiredBuffers;
+};
+
+class FJobSystem
+{
+public:
+    // NumWorkers counts the calling thread, which becomes worker 0 and only runs jobs while waiting.
+    explicit FJobSystem(uint32_t NumWorkers = 0u);
+    ~FJobSystem();
+
+    void Run(std::function<void()> Function, FJobCounter* Counter = nullptr);
+    // Scheduled once Dependency has no pending jobs left.
+    void RunAfter(FJobCounter& Dependency, std::function<void()> Function, FJobCounter* Counter = nullptr);
+
+    // Executes other jobs until the counter drains instead of blocking the thread.
+    void Wait(const FJobCounter& Counter);
+
+    // Calls Function(Begin, End) over [0, Count). Ranges are split lazily down to a grain
+    // derived from Count and the worker count, never below MinGrainSize.
+    void ParallelFor(uint32_t Count, const std::function<void(uint32_t, uint32_t)>& Function, uint32_t MinGrainSize = 1u);
+
+    uint32_t GetNumWorkers() const { return static_cast<uint32_t>(Queues.size()); }
+
+private:
+    void WorkerLoop(uint32_t WorkerIndex);
+    void Schedule(FJob* Job);
+    FJob* FindJob(uint32_t WorkerIndex);
+    void Execute(FJob* Job);
+    void FinishJob(FJobCounter* Counter);
+    void ParallelForRange(uint32_t Begin, uint32_t End, uint32_t GrainSize,
+        const std::function<void(uint32_t, uint32_t)>& Function, FJobCounter* Counter);
+
+    std::vector<std::unique_ptr<FWorkStealingQueue>> Queues;
+    std::vector<std::thread> Workers;
+
+    // Jobs submitted from threads that are not workers.
+    std::mutex InjectionMutex;
+    std::deque<FJob*> InjectionQueue;
+    std::atomic<uint32_t> NumInjectedJobs{ 0u };
+
+    std::mutex SleepMutex;
+    std::condition_variable SleepCondition;
+    std::atomic<uint32_t> NumSleepingWorkers{ 0u };
+    std::atomic<uint64_t> WorkEpoch{ 0u };
+    std::atomic<bool> bQuit{ false };
+};
+
+extern FJobSystem* GJobSystem;
+
+void CreateJobSystem(uint32_t NumWorkers = 0u);
+void ReleaseJobSystem();
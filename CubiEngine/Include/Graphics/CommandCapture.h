@@ -0,0 +1,196 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <type_traits>
+
+class FContext;
+
+// Everything FContext can be asked to do, plus resource creations from the RHI.
+enum class ECapturedCommand : uint8_t
+{
+    ContextReset,
+    SetDescriptorHeaps,
+    SetPipelineState,
+    SetRaytracingPipelineState,
+    SetGraphicsRootSignature,
+    SetComputeRootSignature,
+    SetRoot32BitConstants,
+    SetComputeRootShaderResourceView,
+    SetComputeRootDescriptorTable,
+    SetRenderTargets,
+    ClearRenderTargetView,
+    ClearUnorderedAccessViewFloat,
+    ClearDepthStencilView,
+    SetViewport,
+    SetScissorRect,
+    SetPrimitiveTopology,
+    SetIndexBuffer,
+    DrawIndexedInstanced,
+    DrawInstanced,
+    ExecuteIndirect,
+    Dispatch,
+    DispatchRays,
+    CopyResource,
+    CopyTextureRegion,
+    ResourceBarriers,
+    BeginQuery,
+    EndQuery,
+    ResolveQueryData,
+    BeginEvent,
+    EndEvent,
+    CreateResource,
+    DiscardResource,
+    Count,
+};
+
+const char* GetCapturedCommandName(ECapturedCommand Command);
+
+// Every record is a header followed by PayloadSize bytes, padded to 8 bytes. Objects (resources, pipelines,
+// root signatures, query heaps) are referred to by ids handed out on first use, descriptors by their heap index,
+// so the stream does not depend on pointer values. Payloads have no implicit padding, which keeps the bytes
+// of two captures of the same frame identical.
+struct FCapturedCommandHeader
+{
+    ECapturedCommand Type;
+    uint8_t Reserved;
+    uint16_t PayloadSize;
+    uint32_t ContextId;
+};
+static_assert(sizeof(FCapturedCommandHeader) == 8u);
+
+namespace Capture
+{
+    using FObjectId = uint32_t;
+    constexpr FObjectId NULL_OBJECT = 0u;
+
+    struct FObject { FObjectId Id; };
+    struct FRoot32BitConstants { uint32_t bGraphics; uint32_t RootParameterIndex; uint32_t DestOffsetIn32BitValues; uint32_t Num32BitValues; };
+    struct FRootAddress { uint32_t RootParameterIndex; uint32_t Padding; uint64_t Address; };
+    struct FRenderTargets { uint32_t NumRtvs; uint32_t DsvIndex; uint32_t RtvIndices[8]; };
+    struct FClearRenderTarget { uint32_t RtvIndex; float Color[4]; };
+    struct FClearUnorderedAccessView { uint32_t UavIndex; FObjectId Resource; float Color[4]; };
+    struct FClearDepthStencil { uint32_t DsvIndex; };
+    struct FViewport { float TopLeftX; float TopLeftY; float Width; float Height; float MinDepth; float MaxDepth; };
+    struct FScissorRect { int32_t Left; int32_t Top; int32_t Right; int32_t Bottom; };
+    struct FPrimitiveTopology { uint32_t Topology; };
+    struct FIndexBuffer { FObjectId Resource; uint32_t SizeInBytes; };
+    struct FDrawIndexedInstanced { uint32_t IndexCount; uint32_t InstanceCount; uint32_t StartIndex; };
+    struct FDrawInstanced { uint32_t VertexCount; uint32_t InstanceCount; uint32_t StartVertex; uint32_t StartInstance; };
+    struct FExecuteIndirect { FObjectId CommandSignature; uint32_t MaxCommandCount; FObjectId ArgumentBuffer; uint32_t Padding; uint64_t ArgumentBufferOffset; };
+    struct FDispatch { uint32_t X; uint32_t Y; uint32_t Z; };
+    // GPU virtual addresses are only meaningful in the capturing process.
+    struct FDispatchRays { uint64_t Addresses[11]; uint32_t Width; uint32_t Height; uint32_t Depth; uint32_t Padding; };
+    struct FCopyResource { FObjectId Destination; FObjectId Source; };
+    struct FCopyLocation { FObjectId Resource; uint32_t Type; uint32_t SubresourceIndex; uint32_t Format; uint64_t Offset; uint32_t Width; uint32_t Height; uint32_t Depth; uint32_t RowPitch; };
+    struct FCopyTextureRegion { FCopyLocation Destination; FCopyLocation Source; uint32_t DstX; uint32_t DstY; uint32_t DstZ; uint32_t bHasSourceBox; uint32_t SourceBox[6]; };
+    // ResourceBarriers is a uint32_t count followed by that many entries.
+    struct FBarrier { uint32_t Type; uint32_t Flags; FObjectId Resource; FObjectId ResourceAfter; uint32_t Subresource; uint32_t StateBefore; uint32_t StateAfter; };
+    struct FQuery { FObjectId Heap; uint32_t Type; uint32_t Index; };
+    struct FResolveQueryData { FObjectId Heap; uint32_t Type; uint32_t StartIndex; uint32_t NumQueries; uint64_t DestinationOffset; };
+    struct FCreateResource { FObjectId Resource; uint32_t Dimension; uint64_t Width; uint32_t Height; uint32_t DepthOrArraySize; uint32_t MipLevels; uint32_t Format; uint32_t Flags; uint32_t Padding; };
+}
+
+// Byte stream of captured commands. Contexts record into it while it is attached through RHISetCommandCapture.
+class FCommandCapture
+{
+public:
+    FCommandCapture() = default;
+    FCommandCapture(const FCommandCapture&) = delete;
+    FCommandCapture& operator=(const FCommandCapture&) = delete;
+
+    Capture::FObjectId GetObjectId(const void* Object);
+    // Live pointer behind an id, only valid in the capturing process while the object is alive.
+    const void* GetObject(Capture::FObjectId Id) const;
+    uint32_t GetNumObjects() const;
+
+    // Points a loaded id at a live object, for captures saved by another process.
+    void BindObject(Capture::FObjectId Id, const void* Object);
+    bool AreAllObjectsBound() const;
+
+    template<typename T>
+    void Record(uint32_t ContextId, ECapturedCommand Type, const T& Payload)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Captured payloads must be trivially copyable.");
+        Record(ContextId, Type, &Payload, sizeof(T));
+    }
+    void Record(uint32_t ContextId, ECapturedCommand Type, const void* Payload = nullptr, size_t PayloadSize = 0u);
+
+    const std::vector<uint8_t>& GetStream() const { return Stream; }
+    uint32_t GetNumCommands() const { return NumCommands; }
+
+    // The object table is saved with the stream. Loading it back in the capturing process restores every id,
+    // any other process gets the ids unbound and has to BindObject them before an FD3D12CommandSink can replay.
+    bool SaveToFile(const std::string& Path) const;
+    bool LoadFromFile(const std::string& Path);
+
+private:
+    mutable std::mutex Mutex;
+    std::vector<uint8_t> Stream;
+    uint32_t NumCommands = 0u;
+
+    // Index 0 is NULL_OBJECT.
+    std::unordered_map<const void*, Capture::FObjectId> ObjectIds;
+    std::vector<const void*> Objects{ nullptr };
+};
+
+// Whether PayloadSize covers the Capture:: struct of the type, including the trailing arrays of
+// SetRoot32BitConstants, SetRenderTargets and ResourceBarriers.
+bool IsCapturedPayloadValid(const FCapturedCommandHeader& Header, const uint8_t* Payload);
+
+// Receives replayed commands. Payload points at PayloadSize bytes laid out as the Capture:: struct of the type.
+class FCommandSink
+{
+public:
+    virtual ~FCommandSink() = default;
+    virtual void Execute(const FCapturedCommandHeader& Header, const uint8_t* Payload) = 0;
+};
+
+// Re-encodes every command into another capture, no device needed. Replaying a capture into it must give
+// back the exact same bytes, which is how the stream format is checked headless.
+class FRecordingCommandSink : public FCommandSink
+{
+public:
+    explicit FRecordingCommandSink(FCommandCapture& InTarget) : Target(InTarget) {}
+
+    void Execute(const FCapturedCommandHeader& Header, const uint8_t* Payload) override;
+
+private:
+    FCommandCapture& Target;
+};
+
+// Re-issues the commands onto a single context. Objects are resolved through the source capture, so every id
+// must be bound to a live object, which a capture loaded in the capturing process already is. Good enough to
+// benchmark submission changes against a real frame. Resource creations are not replayed. Commands whose
+// payload is too short for their type are dropped.
+class FD3D12CommandSink : public FCommandSink
+{
+public:
+    FD3D12CommandSink(const FCommandCapture& InSource, FContext* InContext);
+
+    void Execute(const FCapturedCommandHeader& Header, const uint8_t* Payload) override;
+
+private:
+    template<typename T>
+    T* Resolve(Capture::FObjectId Id) const { return static_cast<T*>(const_cast<void*>(Source.GetObject(Id))); }
+
+    const FCommandCapture& Source;
+    FContext* Context;
+    bool bObjectsBound;
+};
+
+struct FReplayStats
+{
+    struct FCommandTiming
+    {
+        uint32_t Count = 0u;
+        double TotalMs = 0.0;
+    };
+
+    std::array<FCommandTiming, static_cast<size_t>(ECapturedCommand::Count)> PerCommand{};
+    uint32_t NumCommands = 0u;
+    double TotalMs = 0.0;
+};
+
+// Walks the stream in order and hands every command to the sink, timing each one.
+FReplayStats ReplayCommandStream(const std::vector<uint8_t>& Stream, FCommandSink& Sink);
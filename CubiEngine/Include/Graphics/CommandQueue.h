@@ -1,12 +1,17 @@
 #pragma once
 
+#include <atomic>
+#include <deque>
 #include "Graphics/Context.h"
+#include "Graphics/FenceWatcher.h"
 
 class FCommandQueue
 {
 public:
+    // Contexts submitted to the queue resolve their pending barriers against StateTable when it is given.
     FCommandQueue(ID3D12Device5* const device, const D3D12_COMMAND_LIST_TYPE commandListType,
-        const std::wstring_view name);
+        const std::wstring_view name, FResourceStateTable* const StateTable = nullptr);
+    ~FCommandQueue();
 
     ID3D12CommandQueue* const GetD3D12CommandQueue() const
     {
@@ -15,17 +20,49 @@ public:
 
     uint64_t Signal();
     bool IsFenceComplete(const uint64_t InFenceValue) const;
+    uint64_t GetCompletedFenceValue() const;
     void WaitForFenceValue(const uint64_t InFenceValue);
 
+    // GPU side wait, work submitted to this queue afterwards starts once Other reached InFenceValue.
+    void WaitForQueue(const FCommandQueue& Other, const uint64_t InFenceValue);
+
+    // Runs Callback on the fence watcher thread once InFenceValue retires, the caller does not block.
+    void OnFenceCompletion(const uint64_t InFenceValue, std::function<void()> Callback);
+
     void GetTimestampFrequency(UINT64* GpuFrequency);
 
     void ExecuteContext(FContext* Context);
 
+    // Runs at the start of every ExecuteContext, e.g. to submit pending uploads the context may read.
+    void SetPreExecuteCallback(std::function<void()> Callback) { PreExecuteCallback = std::move(Callback); }
+
+    // Waits for the GPU and for every completion callback registered so far.
     void Flush();
 
 private:
+    // Reused once the signal following their submission retired.
+    struct FBarrierCommandList
+    {
+        wrl::ComPtr<ID3D12CommandAllocator> CommandAllocator{};
+        wrl::ComPtr<ID3D12GraphicsCommandList> CommandList{};
+        // UINT64_MAX from recording until the signal after the submission is known.
+        uint64_t FenceValue{};
+    };
+
+    // Records the transitions a context needs before it runs into a list of their own.
+    FBarrierCommandList* RecordPendingBarriers(std::span<const D3D12_RESOURCE_BARRIER> Barriers);
+
+    ID3D12Device5* Device{};
+    D3D12_COMMAND_LIST_TYPE CommandListType{};
+    FResourceStateTable* ResourceStateTable{};
+    std::mutex BarrierCommandListMutex;
+    // A deque so lists in flight stay put while others are added.
+    std::deque<FBarrierCommandList> BarrierCommandLists{};
+
     wrl::ComPtr<ID3D12CommandQueue> D3D12CommandQueue{};
-    wrl::ComPtr<ID3D12Fence> Fence{};
+    std::unique_ptr<FD3D12Fence> Fence{};
+    std::unique_ptr<FFenceWatcher> FenceWatcher{};
+    std::function<void()> PreExecuteCallback{};
 
-    uint64_t CommandQueueFenceValue{};
+    std::atomic<uint64_t> CommandQueueFenceValue{};
 };
\ No newline at end of file
@@ -23,6 +23,11 @@ public:
         constexpr UINT Num32BitValues = static_cast<UINT>(sizeof(T) / sizeof(uint32_t));
         static_assert(Num32BitValues <= NUMBER_32_BIT_CONSTANTS, "Root constants exceed the root signature limit.");
         D3D12CommandList->SetComputeRoot32BitConstants(0u, Num32BitValues, RenderResources, 0u);
+
+        if (CommandCapture)
+        {
+            RecordRoot32BitConstants(false, 0u, RenderResources, Num32BitValues, 0u);
+        }
     }
 
     void Dispatch(const uint32_t ThreadGroupX, const uint32_t ThreadGroupY, const uint32_t ThreadGroupZ) const;
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <mutex>
+#include <optional>
+#include "Graphics/Resource.h"
+
+class FMemoryAllocator;
+
+// A sub-allocation of an FLinearConstantAllocator. Offset is from the start of the whole buffer, Index counts the
+// allocations of the frame, starting at 0.
+struct FConstantRange
+{
+    uint64_t Offset{};
+    uint32_t Size{};
+    uint32_t Index{};
+};
+
+// Bookkeeping of a bump allocator with one region per frame in flight, no device involved. BeginFrame rewinds the
+// next region, whatever was allocated in it FRAMES_IN_FLIGHT frames ago is gone. Allocations are aligned to the
+// constant buffer placement alignment, so each one can sit behind its own CBV.
+class FLinearConstantAllocator
+{
+public:
+    static constexpr uint32_t ALIGNMENT = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
+
+    explicit FLinearConstantAllocator(uint64_t InCapacityPerFrame);
+
+    // Moves to the next region, the frame that used it last must be done on the GPU.
+    void BeginFrame();
+
+    // nullopt once the region of the current frame is full.
+    std::optional<FConstantRange> Allocate(uint32_t Size);
+
+    uint32_t GetFrameIndex() const { return FrameIndex; }
+    uint64_t GetCapacityPerFrame() const { return CapacityPerFrame; }
+    uint64_t GetUsedBytes() const { return Cursor; }
+    uint32_t GetNumAllocations() const { return NumAllocations; }
+    // Most bytes a frame used so far.
+    uint64_t GetHighWaterMark() const { return HighWaterMark; }
+
+private:
+    uint64_t CapacityPerFrame;
+    uint32_t FrameIndex = 0u;
+    uint64_t Cursor = 0u;
+    uint32_t NumAllocations = 0u;
+    uint64_t HighWaterMark = 0u;
+};
+
+// Decides when a constant buffer filled every frame needs writing at all. The buffer keeps one copy per frame in
+// flight and moves on to the next copy only when the contents hash differently, so an unchanged buffer costs a hash
+// and no upload. Update at most once per frame : the copy written next was then replaced at least two frames ago,
+// and no frame still in flight reads it. The hash covers padding too, fill constants starting from a zeroed value.
+class FConstantDirtyTracker
+{
+public:
+    // Chain hashes through Seed to cover several values.
+    static uint64_t Hash(const void* Data, size_t Size, uint64_t Seed = 0u);
+
+    // Copy to write Data into, nullopt if the current copy already holds it.
+    std::optional<uint32_t> Update(const void* Data, size_t Size);
+
+    uint32_t GetCurrentCopy() const { return CurrentCopy; }
+    uint64_t GetNumUploads() const { return NumUploads; }
+    uint64_t GetNumSkipped() const { return NumSkipped; }
+
+private:
+    uint64_t ContentHash = 0u;
+    uint32_t CurrentCopy = 0u;
+    bool bWritten = false;
+
+    uint64_t NumUploads = 0u;
+    uint64_t NumSkipped = 0u;
+};
+
+// Memory and views behind an FConstantBufferAllocator. FD3D12ConstantBufferStorage is an upload buffer with CBVs
+// in the bindless heap, tests put plain memory behind it so the allocator runs without a device.
+class FConstantBufferStorage
+{
+public:
+    virtual ~FConstantBufferStorage() = default;
+
+    virtual uint8_t* GetMappedData() const = 0;
+    virtual uint32_t CreateCbv() = 0;
+    // Points Cbv at Size bytes at Offset of the buffer.
+    virtual void WriteCbv(uint32_t Cbv, uint64_t Offset, uint32_t Size) = 0;
+};
+
+class FD3D12ConstantBufferStorage : public FConstantBufferStorage
+{
+public:
+    FD3D12ConstantBufferStorage(FMemoryAllocator& MemoryAllocator, uint64_t SizeInBytes);
+
+    uint8_t* GetMappedData() const override { return MappedData; }
+    uint32_t CreateCbv() override;
+    void WriteCbv(uint32_t Cbv, uint64_t Offset, uint32_t Size) override;
+
+private:
+    FAllocation Allocation{};
+    uint8_t* MappedData{};
+};
+
+// Per frame constants out of one persistently mapped upload buffer, carved up by an FLinearConstantAllocator.
+// The n-th allocation of a frame reuses the CBV the n-th allocation had the last time that region was used, so
+// a steady frame writes descriptors but never allocates them.
+class FConstantBufferAllocator
+{
+public:
+    static constexpr uint64_t CAPACITY_PER_FRAME = 1024u * 1024u;
+
+    explicit FConstantBufferAllocator(FMemoryAllocator& MemoryAllocator);
+    // InStorage holds FRAMES_IN_FLIGHT regions of CapacityPerFrame, rounded up to the placement alignment.
+    FConstantBufferAllocator(std::unique_ptr<FConstantBufferStorage> InStorage, uint64_t CapacityPerFrame);
+
+    // Call once the frame that used the next region is done on the GPU.
+    void BeginFrame();
+
+    // CBV index of a copy of Data, valid until the end of the current frame.
+    uint32_t Allocate(const void* Data, uint32_t Size);
+
+    template<typename T>
+    uint32_t Allocate(const T& Data)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Constants must be trivially copyable.");
+        return Allocate(&Data, sizeof(T));
+    }
+
+private:
+    std::mutex Mutex;
+
+    FLinearConstantAllocator Allocator;
+    std::unique_ptr<FConstantBufferStorage> Storage;
+
+    std::array<std::vector<uint32_t>, FRAMES_IN_FLIGHT> FrameCbvs{};
+};
+
+// Constant buffer written every frame that only uploads when its contents change, see FConstantDirtyTracker.
+template<typename T>
+class TTrackedConstantBuffer
+{
+public:
+    void Init(std::wstring_view Name);
+
+    void Update(const T& Data)
+    {
+        if (const std::optional<uint32_t> Copy = Tracker.Update(&Data, sizeof(T)))
+        {
+            Buffers[*Copy].Update(&Data);
+        }
+    }
+
+    uint32_t GetCbvIndex() const { return Buffers[Tracker.GetCurrentCopy()].CbvIndex; }
+    const FConstantDirtyTracker& GetTracker() const { return Tracker; }
+
+private:
+    std::array<FBuffer, FRAMES_IN_FLIGHT> Buffers{};
+    FConstantDirtyTracker Tracker;
+};
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Graphics/Resource.h"
+#include "Graphics/CommandCapture.h"
+#include "Graphics/ResourceStateTracker.h"
 
 class FContext
 {
@@ -20,20 +22,51 @@ public:
 
     virtual void Reset();
     
+    // Skips the transition when Texture is already readable in a wider read-only state.
     void AddResourceBarrier(FTexture* Texture, const D3D12_RESOURCE_STATES NewState);
+    // Untracked, for resources that are not textures.
     void AddResourceBarrier(D3D12_RESOURCE_BARRIER& Barrier);
     void AddResourceBarrier(ID3D12Resource* const Resource, const D3D12_RESOURCE_STATES PreviousState, const D3D12_RESOURCE_STATES NewState);
 
+    // Exactly into NewState, the whole texture or one subresource. Dropped when already there.
+    void TransitionResource(FTexture* Texture, const D3D12_RESOURCE_STATES NewState,
+        uint32_t Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+    // Split transition, the texture is not used until EndTransition. See FResourceStateTracker::BeginTransition.
+    void BeginTransition(FTexture* Texture, const D3D12_RESOURCE_STATES NewState,
+        uint32_t Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+    void EndTransition(FTexture* Texture, uint32_t Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+
     void AddUAVBarrier(FTexture* Texture);
     void AddUAVBarrier(FBuffer& Buffer);
+    // After becomes the placed texture its memory belongs to, taking it from Before, or from any texture when Before
+    // is null. A render target or depth buffer is then undefined until cleared or discarded.
+    void AddAliasingBarrier(FTexture* Before, FTexture* After);
 
     void ExecuteResourceBarriers();
+    // Called by the queue submitting the context, see FResourceStateTracker::ResolvePendingBarriers.
+    void ResolvePendingBarriers(FResourceStateTable& Table, std::vector<D3D12_RESOURCE_BARRIER>& OutBarriers);
     void BeginEvent(const char* Name);
     void EndEvent(const char* Name);
 
+    // While set, every command is also recorded into Capture. See RHISetCommandCapture.
+    void SetCommandCapture(FCommandCapture* Capture) { CommandCapture = Capture; }
+
 protected:
+    // Call sites check CommandCapture first so payloads are only built while capturing.
+    template<typename T>
+    void RecordCommand(ECapturedCommand Type, const T& Payload) const
+    {
+        CommandCapture->Record(CommandCapture->GetObjectId(this), Type, Payload);
+    }
+    void RecordCommand(ECapturedCommand Type) const;
+    void RecordRoot32BitConstants(bool bGraphics, uint32_t RootParameterIndex, const void* Values,
+        uint32_t Num32BitValues, uint32_t DestOffsetIn32BitValues) const;
+    Capture::FObjectId GetCaptureId(const void* Object) const { return CommandCapture->GetObjectId(Object); }
+
+    FCommandCapture* CommandCapture = nullptr;
+
     wrl::ComPtr<ID3D12GraphicsCommandList4> D3D12CommandList{};
     wrl::ComPtr<ID3D12CommandAllocator> D3D12CommandAllocator{};
 
-    std::vector<CD3DX12_RESOURCE_BARRIER> ResourceBarriers;
+    FResourceStateTracker StateTracker;
 };
\ No newline at end of file
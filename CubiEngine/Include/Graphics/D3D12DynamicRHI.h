@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <mutex>
 #include <string>
@@ -9,6 +10,9 @@
 #include "Graphics/ComputeContext.h"
 #include "Graphics/Profiler.h"
 #include "Graphics/Query.h"
+#include "Graphics/UploadRing.h"
+#include "Graphics/ResourceStateTracker.h"
+#include "Graphics/DeferredReleaseQueue.h"
 
 class FMemoryAllocator;
 class FCopyContext;
@@ -16,12 +20,29 @@ class FGraphicsContext;
 class FMipmapGenerator;
 class FD3D12DynamicRHI;
 class FTextureManager;
+class FGeometryPool;
+class FConstantBufferAllocator;
+class FMaterialTable;
 
 struct FFenceValues
 {
     uint64_t DirectQueueFenceValue{};
 };
 
+// Running counts of RHI calls, cheap enough to keep in every build. Headless runs report them
+// next to the CPU frame time so a change in either shows up in the same log.
+struct FRHIStats
+{
+    std::atomic<uint32_t> NumTexturesCreated{};
+    std::atomic<uint32_t> NumBuffersCreated{};
+    std::atomic<uint32_t> NumPipelineStatesCreated{};
+    std::atomic<uint32_t> NumCopySubmissions{};
+    std::atomic<uint32_t> NumComputeSubmissions{};
+    // Uploads that found the upload ring full and had to submit or wait for the copy queue.
+    std::atomic<uint32_t> NumUploadRingStalls{};
+    std::atomic<uint32_t> NumFrames{};
+};
+
 static const D3D12_HEAP_PROPERTIES kDefaultHeapProps = {
     D3D12_HEAP_TYPE_DEFAULT, D3D12_CPU_PAGE_PROPERTY_UNKNOWN, D3D12_MEMORY_POOL_UNKNOWN, 0, 0 };
 
@@ -30,6 +51,8 @@ static const D3D12_HEAP_PROPERTIES kUploadHeapProps = {
 
 extern FD3D12DynamicRHI* GD3D12RHI;
 
+// A null WindowHandle creates a headless RHI : WARP stands in for the GPU and the swapchain is replaced by
+// plain render targets, so whole frames can be driven on machines without a GPU or a visible window.
 void CreateRHI(
     const uint32_t Width, const uint32_t Height,
     const DXGI_FORMAT SwapchainFormat, const HWND WindowHandle
@@ -47,9 +70,12 @@ IDXGIAdapter* RHIGetAdapter();
 IDXGIAdapter1* RHIGetAdapter1();
 
 FCommandQueue* RHIGetDirectCommandQueue();
+FCommandQueue* RHIGetComputeCommandQueue();
 
+// Returns right away, the pipeline compiles on the job system and is waited on when first bound.
 FPipelineState RHICreatePipelineState(const FGraphicsPipelineStateCreationDesc& Desc);
 FPipelineState RHICreatePipelineState(const FComputePipelineStateCreationDesc& Desc);
+ComPtr<ID3D12CommandSignature> RHICreateCommandSignature(const D3D12_COMMAND_SIGNATURE_DESC& Desc);
 
 FDescriptorHeap* RHIGetCbvSrvUavDescriptorHeap();
 FDescriptorHeap* RHIGetRtvDescriptorHeap();
@@ -73,10 +99,34 @@ void RHICreateRawBuffer(
 );
 
 std::unique_ptr<FTexture> RHICreateTexture(const FTextureCreationDesc& InTextureCreationDesc, const void* Data = nullptr);
+// Size and alignment a texture created from the desc takes in a heap.
+D3D12_RESOURCE_ALLOCATION_INFO RHIGetTextureAllocationInfo(const FTextureCreationDesc& TextureCreationDesc);
+// GPU memory for placed textures, released with the last reference to the returned allocation.
+wrl::ComPtr<D3D12MA::Allocation> RHIAllocateHeap(uint64_t Size, uint64_t Alignment, D3D12_HEAP_FLAGS HeapFlags);
+// Texture in the memory of Placement, which it may share with other placed textures. Its contents are undefined
+// until it is initialized after the aliasing barrier that makes it the active one, see FContext::AddAliasingBarrier.
+std::unique_ptr<FTexture> RHICreatePlacedTexture(const FTextureCreationDesc& TextureCreationDesc, const FTexturePlacement& Placement);
 
 template <typename T>
 FBuffer RHICreateBuffer(const FBufferCreationDesc& BufferCreationDesc, const std::span<const T> Data = {});
 FBuffer RHICreateBuffer(const FBufferCreationDesc& BufferCreationDesc, size_t TotalBytes);
+// Without initial data, structured views cover NumElements of ElementSizeInBytes.
+FBuffer RHICreateBuffer(const FBufferCreationDesc& BufferCreationDesc, size_t NumElements, size_t ElementSizeInBytes);
+
+// Both go out with the next upload batch, in the order they were called. Buffer must live in GPU memory.
+void RHIUploadBufferRegion(const FBuffer& Buffer, uint64_t DstOffset, const void* Data, uint64_t Size);
+void RHICopyBufferRegion(const FBuffer& DstBuffer, uint64_t DstOffset, const FBuffer& SrcBuffer, uint64_t SrcOffset, uint64_t Size);
+// Copies Data into this frame's constant memory, the returned CBV is only valid until the end of the current frame.
+uint32_t RHIAllocateConstants(const void* Data, uint32_t Size);
+template<typename T>
+uint32_t RHIAllocateConstants(const T& Data)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Constants must be trivially copyable.");
+    return RHIAllocateConstants(&Data, sizeof(T));
+}
+
+// Submits the upload batch now. A copy that reads a buffer written earlier in the same batch needs this in between.
+void RHIFlushUploads();
 
 FTexture* RHIGetCurrentBackBuffer();
 
@@ -86,10 +136,35 @@ void RHIEndFrame();
 void RHIResizeSwapchainResources(uint32_t InWidth, uint32_t InHeight);
 void RHIPresent();
 
-void RHIExecuteAndFlushComputeContext(std::unique_ptr<FComputeContext>&& ComputeContext);
+// Returns without waiting, the direct queue waits on the GPU for the compute work to finish.
+void RHIExecuteComputeContext(std::unique_ptr<FComputeContext>&& ComputeContext);
+// A compute list context for render graph passes on the async compute queue, reset and with the compute root
+// signature set. Submitting signals the compute queue and returns the fence value without making any queue wait,
+// the render graph places the waits. The context goes back to the pool once the GPU is done with it.
+FGraphicsContext* RHIAcquireAsyncComputeContext();
+uint64_t RHISubmitAsyncComputeContext(FGraphicsContext* Context);
 void RHIFlushAllQueue();
 
+// Destroys Object once the GPU is past the current frame, instead of flushing the GPU before releasing it. Any
+// thread, swept every frame, NumBytes counts in the pending bytes of the stats.
+template<typename T>
+void RHIDeferRelease(T&& Object, uint64_t NumBytes = 0u);
+// Same for what is not owned by one object, Release runs once the GPU is past the current frame, e.g. to free a
+// descriptor together with the allocation it points into.
+void RHIDeferReleaseCallback(std::function<void()> Release, uint64_t NumBytes = 0u);
+FDeferredReleaseStats RHIGetDeferredReleaseStats();
+
+// Attaches a capture to every context, commands and resource creations are recorded until it is detached with nullptr.
+void RHISetCommandCapture(FCommandCapture* Capture);
+
+bool RHIIsHeadless();
+const FRHIStats& RHIGetStats();
+
 FTextureManager* RHIGetTextureManager();
+FGeometryPool* RHIGetGeometryPool();
+FMaterialTable* RHIGetMaterialTable();
+// States the submitted command lists leave textures in, every texture is registered in it while it lives.
+FResourceStateTable& RHIGetResourceStateTable();
 
 class FD3D12DynamicRHI
 {
@@ -103,9 +178,13 @@ public:
     void ResizeSwapchainResources(uint32_t InWidth, uint32_t InHeight);
 
     FSampler CreateSampler(const FSamplerCreationDesc& Desc) const;
-    std::unique_ptr<FTexture> CreateTexture(const FTextureCreationDesc& InTextureCreationDesc, const void* Data = nullptr) const;
+    std::unique_ptr<FTexture> CreateTexture(const FTextureCreationDesc& InTextureCreationDesc, const void* Data = nullptr,
+        const FTexturePlacement* Placement = nullptr) const;
+    D3D12_RESOURCE_ALLOCATION_INFO GetTextureAllocationInfo(const FTextureCreationDesc& TextureCreationDesc) const;
+    wrl::ComPtr<D3D12MA::Allocation> AllocateHeap(uint64_t Size, uint64_t Alignment, D3D12_HEAP_FLAGS HeapFlags) const;
     FPipelineState CreatePipelineState(const FGraphicsPipelineStateCreationDesc& Desc) const;
     FPipelineState CreatePipelineState(const FComputePipelineStateCreationDesc& Desc) const;
+    ComPtr<ID3D12CommandSignature> CreateCommandSignature(const D3D12_COMMAND_SIGNATURE_DESC& Desc) const;
 
     void CreateBackBufferRTVs();
 
@@ -120,24 +199,38 @@ public:
     IDXGIAdapter* GetAdapter() const { return Adapter.Get(); }
     IDXGIAdapter1* GetAdapter1() const { return Adapter1.Get(); }
     FCommandQueue* GetDirectCommandQueue() const { return DirectCommandQueue.get(); }
+    FCommandQueue* GetComputeCommandQueue() const { return ComputeCommandQueue.get(); }
     FDescriptorHeap* GetCbvSrvUavDescriptorHeap() const { return CbvSrvUavDescriptorHeap.get(); }
     FDescriptorHeap* GetRtvDescriptorHeap() const { return RtvDescriptorHeap.get(); }
     FDescriptorHeap* GetDsvDescriptorHeap() const { return DsvDescriptorHeap.get(); }
     FDescriptorHeap* GetSamplerDescriptorHeap() const { return SamplerDescriptorHeap.get(); }
+    FDeferredReleaseQueue& GetDeferredReleaseQueue() const { return DeferredReleaseQueue; }
 
     FGraphicsContext* GetCurrentGraphicsContext() const { return PerFrameGraphicsContexts[CurrentFrameIndex].get(); }
     FTexture* GetCurrentBackBuffer() { return BackBuffers[CurrentFrameIndex].get(); }
 
     FGPUProfiler& GetGPUProfiler() { return GPUProfiler; }
 
-    void ExecuteAndFlushComputeContext(std::unique_ptr<FComputeContext>&& ComputeContext);
+    bool IsHeadless() const { return WindowHandle == nullptr; }
+
+    void SetCommandCapture(FCommandCapture* Capture);
+    const FRHIStats& GetStats() const { return Stats; }
+
+    void ExecuteComputeContext(std::unique_ptr<FComputeContext>&& ComputeContext);
+    FGraphicsContext* AcquireAsyncComputeContext();
+    uint64_t SubmitAsyncComputeContext(FGraphicsContext* Context);
 
     template <typename T>
     FBuffer CreateBuffer(const FBufferCreationDesc& BufferCreationDesc, const std::span<const T> Data = {}) const;
     FBuffer CreateBuffer(const FBufferCreationDesc& BufferCreationDesc, size_t TotalBytes) const;
+    FBuffer CreateBuffer(const FBufferCreationDesc& BufferCreationDesc, size_t NumElements, size_t ElementSizeInBytes) const;
 
     void CreateRawBuffer(ComPtr<ID3D12Resource>& outBuffer, uint64_t size, D3D12_RESOURCE_FLAGS flags, D3D12_RESOURCE_STATES initState, const D3D12_HEAP_PROPERTIES& heapProps) const;
 
+    void UploadBufferRegion(const FBuffer& Buffer, uint64_t DstOffset, const void* Data, uint64_t Size) const;
+    void CopyBufferRegion(const FBuffer& DstBuffer, uint64_t DstOffset, const FBuffer& SrcBuffer, uint64_t SrcOffset, uint64_t Size) const;
+    void FlushUploads() const;
+
     std::unique_ptr<FComputeContext> GetComputeContext();
 
     void GenerateMipmap(FTexture* Texture);
@@ -156,6 +249,10 @@ public:
     }
 
     FTextureManager* GetTextureManager() { return TextureManager.get(); }
+    FGeometryPool* GetGeometryPool() { return GeometryPool.get(); }
+    FConstantBufferAllocator* GetConstantBufferAllocator() { return ConstantBufferAllocator.get(); }
+    FMaterialTable* GetMaterialTable() { return MaterialTable.get(); }
+    FResourceStateTable& GetResourceStateTable() const { return ResourceStateTable; }
 
 private:
     void InitDeviceResources();
@@ -172,7 +269,25 @@ private:
     uint32_t CreateDsv(const FDsvCreationDesc& DsvCreationDesc, ID3D12Resource* const Resource) const;
     uint32_t CreateRtv(const FRtvCreationDesc& RtvCreationDesc, ID3D12Resource* const Resource) const;
 
-    HWND WindowHandle;
+    // Uploads do not stall the caller : the other queues wait on the copy fence on the GPU, and a fence
+    // callback frees the upload allocations and recycles the copy context once the copy retired.
+    FCopyContext* AcquireCopyContext() const;
+    void RecordResourceCreation(ID3D12Resource* Resource) const;
+    uint64_t SubmitCopyContext(FCopyContext* Context, std::vector<FAllocation>&& UploadAllocations) const;
+
+    // Resource creation stages its data in the upload ring and records the copy into one batch, submitted right
+    // before the next submission on the direct or compute queue. Ring space retires with the copy fence.
+    // Hold ResourceMutex across AllocateUpload and recording the copy, and get the batch context afterwards :
+    // a full ring submits the batch recorded so far.
+    FUploadRegion AllocateUpload(uint64_t Size, uint64_t Alignment) const;
+    FCopyContext* GetUploadBatchContext() const;
+
+    static constexpr uint64_t UPLOAD_RING_SIZE = 64u * 1024u * 1024u;
+    static constexpr uint64_t UPLOAD_BUFFER_ALIGNMENT = 16u;
+
+    HWND WindowHandle{};
+    uint32_t BackBufferWidth{};
+    uint32_t BackBufferHeight{};
 
     wrl::ComPtr<ID3D12Debug3> DebugInterface{};
     wrl::ComPtr<IDXGIFactory6> Factory{};
@@ -185,11 +300,19 @@ private:
     DXGI_FORMAT SwapchainFormat{};
     uint64_t CurrentFrameIndex{};
     std::array<FFenceValues, FRAMES_IN_FLIGHT> FenceValues{}; // Signal for Command Queue
+    // Declared before the command queues submitting against it and anything owning textures, which unregister
+    // from it when destroyed.
+    mutable FResourceStateTable ResourceStateTable;
     std::array<std::unique_ptr<FTexture>, FRAMES_IN_FLIGHT> BackBuffers{};
 
     std::array<std::unique_ptr<FGraphicsContext>, FRAMES_IN_FLIGHT> PerFrameGraphicsContexts{};
-    std::unique_ptr<FCopyContext> CopyContext;
+    // Declared before the command queues, whose fence callbacks return contexts here on shutdown.
+    mutable std::mutex ContextPoolMutex;
+    mutable std::vector<std::unique_ptr<FCopyContext>> CopyContexts;
+    mutable std::vector<FCopyContext*> FreeCopyContexts;
     std::queue<std::unique_ptr<FComputeContext>> ComputeContextQueue;
+    std::vector<std::unique_ptr<FGraphicsContext>> AsyncComputeContexts;
+    std::vector<FGraphicsContext*> FreeAsyncComputeContexts;
 
     std::unique_ptr<FDescriptorHeap> CbvSrvUavDescriptorHeap;
     std::unique_ptr<FDescriptorHeap> RtvDescriptorHeap;
@@ -200,17 +323,41 @@ private:
     std::unique_ptr<FCommandQueue> ComputeCommandQueue{};
     std::unique_ptr<FCommandQueue> CopyCommandQueue{};
     std::unique_ptr<FMemoryAllocator> MemoryAllocator{};
+    // Closed with the signal ending each frame, the other queues join the direct one within the frame. Emptied in the
+    // destructor while everything its entries release into is alive.
+    mutable FDeferredReleaseQueue DeferredReleaseQueue;
 
     mutable std::recursive_mutex ResourceMutex;
 
+    // Guarded by ResourceMutex.
+    std::unique_ptr<FUploadRing> UploadRing{};
+    mutable FCopyContext* UploadBatchContext{};
+    // Uploads too large for the ring, released once their batch retired.
+    mutable std::vector<FAllocation> UploadBatchAllocations{};
+
     std::unique_ptr<FMipmapGenerator> MipmapGenerator{};
 
     FGPUProfiler GPUProfiler{};
 
     std::unique_ptr<FQueryHeap> TimeStampQueryHeap;
     std::unique_ptr<FTextureManager> TextureManager;
+    std::unique_ptr<FGeometryPool> GeometryPool;
+    std::unique_ptr<FConstantBufferAllocator> ConstantBufferAllocator;
+    std::unique_ptr<FMaterialTable> MaterialTable;
+
+    mutable FRHIStats Stats{};
+    std::atomic<FCommandCapture*> CommandCapture{};
+
+    // Last member, in-flight compiles finish before anything they use is destroyed.
+    mutable FPipelineCompileQueue PipelineCompileQueue;
 };
 
+template<typename T>
+inline void RHIDeferRelease(T&& Object, uint64_t NumBytes)
+{
+    GD3D12RHI->GetDeferredReleaseQueue().Enqueue(FDeferredReleaseQueue::OPEN_BATCH, std::forward<T>(Object), NumBytes);
+}
+
 template<typename T>
 inline FBuffer RHICreateBuffer(const FBufferCreationDesc& BufferCreationDesc, const std::span<const T> Data)
 {
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <mutex>
+
+struct FDeferredReleaseStats
+{
+    uint32_t NumPending{};
+    uint64_t PendingBytes{};
+    // Highest PendingBytes reached since the queue was created.
+    uint64_t PeakPendingBytes{};
+    uint64_t NumReleased{};
+    uint64_t ReleasedBytes{};
+};
+
+// Objects the GPU may still read, kept alive until the fence value of their last use completes. No device
+// involved : anything movable can be enqueued, a resource, an allocation or a callback freeing something else,
+// and Retire is driven by a completed fence value, FFakeFence::GetCompletedValue to exercise it without a GPU.
+// Fence values all come from one fence.
+//
+// Entries whose last use is not submitted yet go in the open batch with OPEN_BATCH, CloseBatch tags them with the
+// fence value of the submission that follows it. Entries retire in order, one tagged with a lower fence value than
+// an entry enqueued before it waits for that one, so the per-frame sweep only looks at the front. Thread safe,
+// released objects are destroyed outside the lock.
+class FDeferredReleaseQueue
+{
+public:
+    static constexpr uint64_t OPEN_BATCH = UINT64_MAX;
+
+    ~FDeferredReleaseQueue();
+
+    // Object is destroyed once the fence reaches FenceValue. NumBytes only feeds the stats.
+    template<typename T>
+    void Enqueue(uint64_t FenceValue, T&& Object, uint64_t NumBytes = 0u)
+    {
+        EnqueueRelease(FenceValue, std::make_unique<TRelease<std::decay_t<T>>>(std::forward<T>(Object)), NumBytes);
+    }
+
+    // Release runs once the fence reaches FenceValue, on the thread calling Retire.
+    void EnqueueCallback(uint64_t FenceValue, std::function<void()> Release, uint64_t NumBytes = 0u);
+
+    // No-op if the open batch is empty.
+    void CloseBatch(uint64_t FenceValue);
+
+    // Returns the number of entries released, the open batch stays.
+    uint32_t Retire(uint64_t CompletedFenceValue);
+    // Open batch included, once nothing may use the entries anymore, on shutdown.
+    uint32_t RetireAll();
+
+    FDeferredReleaseStats GetStats() const;
+
+private:
+    struct FRelease
+    {
+        virtual ~FRelease() = default;
+    };
+
+    template<typename T>
+    struct TRelease final : FRelease
+    {
+        explicit TRelease(T&& InObject) : Object(std::move(InObject)) {}
+        explicit TRelease(const T& InObject) : Object(InObject) {}
+        T Object;
+    };
+
+    struct FCallbackRelease final : FRelease
+    {
+        explicit FCallbackRelease(std::function<void()> InCallback) : Callback(std::move(InCallback)) {}
+        ~FCallbackRelease() override { Callback(); }
+        std::function<void()> Callback;
+    };
+
+    struct FEntry
+    {
+        uint64_t FenceValue{};
+        uint64_t NumBytes{};
+        std::unique_ptr<FRelease> Release;
+    };
+
+    void EnqueueRelease(uint64_t FenceValue, std::unique_ptr<FRelease>&& Release, uint64_t NumBytes);
+
+    mutable std::mutex Mutex;
+    std::deque<FEntry> Entries;
+    std::vector<FEntry> OpenEntries;
+    FDeferredReleaseStats Stats{};
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+// Slots of a descriptor heap, no device involved. Allocation and free take no lock : each thread allocates from a
+// cache of its own, refilled a batch at a time from a global pool that is a lock-free stack of batches, and fresh
+// slots are carved off the end of the heap with one atomic add per batch.
+//
+// Frees are deferred. A freed slot is tagged with the fence value after which the GPU no longer reads it and goes
+// on a lock-free retired list. ReleaseRetired, run by one thread at a time, typically once per frame, moves the
+// slots whose fence value completed back to the pool in batches, so a slot is never handed out while in-flight
+// work may still read its descriptor. A slot whose last use is not submitted yet is freed into the open batch with
+// OPEN_BATCH, CloseBatch tags it with the fence value of the submission that follows, like
+// FDeferredReleaseQueue.
+//
+// A thread keeps at most one batch cached per allocator. Those slots stay with the thread until it allocates them,
+// when the heap runs out they are the only free slots it cannot reach.
+class FDescriptorAllocator
+{
+public:
+    static constexpr uint32_t MAX_BATCH_SIZE = 32u;
+    static constexpr uint64_t OPEN_BATCH = UINT64_MAX;
+
+    explicit FDescriptorAllocator(uint32_t InNumDescriptors);
+    ~FDescriptorAllocator();
+    FDescriptorAllocator(const FDescriptorAllocator&) = delete;
+    FDescriptorAllocator& operator=(const FDescriptorAllocator&) = delete;
+
+    // INVALID_INDEX_U32 once every slot is allocated, cached by another thread or waiting to retire.
+    uint32_t Allocate();
+    // The slot comes back once ReleaseRetired is given a completed fence value of at least FenceValue.
+    void Free(uint32_t Index, uint64_t FenceValue);
+    // Retires the open batch at FenceValue. A slot freed while it runs may be left for the next close.
+    void CloseBatch(uint64_t FenceValue);
+
+    // Returns the number of slots back in the pool. One caller at a time.
+    uint32_t ReleaseRetired(uint64_t CompletedFenceValue);
+
+    uint32_t GetNumDescriptors() const { return NumDescriptors; }
+    uint32_t GetBatchSize() const { return BatchSize; }
+    bool IsAllocated(uint32_t Index) const { return Index < NumDescriptors && Allocated[Index].load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) FThreadCache
+    {
+        std::array<uint32_t, MAX_BATCH_SIZE> Slots{};
+        uint32_t NumSlots = 0u;
+    };
+
+    FThreadCache& GetThreadCache();
+    bool Refill(FThreadCache& Cache);
+    // Slots linked through SlotNext, First heading the batch.
+    void PushBatch(uint32_t First, uint32_t Count);
+    // Links First to Last, already linked through SlotNext, on top of List.
+    void PushSlots(std::atomic<uint32_t>& List, uint32_t First, uint32_t Last);
+
+    const uint32_t NumDescriptors;
+    const uint32_t BatchSize;
+    // Tells the caches of this allocator apart from those of an allocator destroyed before at the same address.
+    const uint64_t Id;
+
+    // Per slot, only touched while the slot is free : the next slot of its batch or of the retired list, the batch
+    // below on the pool stack and the batch size when it heads a batch, and the fence value it retires at.
+    std::unique_ptr<uint32_t[]> SlotNext;
+    std::unique_ptr<std::atomic<uint32_t>[]> BatchNext;
+    std::unique_ptr<uint32_t[]> BatchCount;
+    std::unique_ptr<uint64_t[]> RetireFenceValue;
+    // Catches double frees and frees of slots never handed out.
+    std::unique_ptr<std::atomic<bool>[]> Allocated;
+
+    // Top batch of the pool in the low 32 bits, a counter bumped by every push and pop in the high ones so a pop
+    // racing with a pop and push of the same batch fails instead of linking a stale next.
+    alignas(64) std::atomic<uint64_t> FreeBatches;
+    alignas(64) std::atomic<uint32_t> NextFreshIndex{ 0u };
+    alignas(64) std::atomic<uint32_t> RetiredHead{ INVALID_INDEX_U32 };
+    alignas(64) std::atomic<uint32_t> OpenHead{ INVALID_INDEX_U32 };
+
+    // Owned by ReleaseRetired, slots whose fence value had not completed yet.
+    std::vector<uint32_t> WaitingSlots;
+
+    // Owns every thread's cache, threads only register here once.
+    std::mutex RegistrationMutex;
+    std::vector<std::unique_ptr<FThreadCache>> ThreadCaches;
+};
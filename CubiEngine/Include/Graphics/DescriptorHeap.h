@@ -1,6 +1,8 @@
 #pragma once
 
-#include <mutex>
+#include "Graphics/DescriptorAllocator.h"
+
+class FCommandQueue;
 
 struct FDescriptorHandle
 {
@@ -35,9 +37,20 @@ public:
         return i;
     }
 
+    // Lock free, see FDescriptorAllocator.
     uint32_t AllocateDescriptor();
+    // The slot waits in the open batch until CloseRetireBatch, and is handed out again once the retire queue
+    // completed that fence value and ReleaseRetiredDescriptors saw it. Without a retire queue, at the next
+    // ReleaseRetiredDescriptors.
     void FreeDescriptor(uint32_t Index);
 
+    void SetRetireQueue(const FCommandQueue* Queue) { RetireQueue = Queue; }
+    // At the end of the frame, with the value the retire queue signaled after the frame's work. Other threads
+    // signal the queue too, a value taken when the slot was freed could complete before the frame reading it.
+    void CloseRetireBatch(uint64_t FenceValue);
+    // Once per frame, from one thread.
+    void ReleaseRetiredDescriptors();
+
     void OffsetDescriptor(FDescriptorHandle& InHandle, const uint32_t Offset = 1u) const;
 
     ID3D12DescriptorHeap* const GetD3D12DescriptorHeap() const { return D3D12DescriptorHeap.Get(); }
@@ -49,8 +62,6 @@ private:
     uint32_t DescriptorSize{};
 
     FDescriptorHandle DescriptorHandleFromHeapStart;
-    uint32_t NextDescriptorIndex{};
-    std::vector<uint32_t> FreeDescriptorIndices;
-    std::vector<bool> AllocatedDescriptors;
-    std::mutex AllocationMutex;
+    std::unique_ptr<FDescriptorAllocator> Allocator;
+    const FCommandQueue* RetireQueue{};
 };
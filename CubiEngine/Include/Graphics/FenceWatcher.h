@@ -0,0 +1,101 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// CPU side view of a GPU timeline. FD3D12Fence wraps an ID3D12Fence, FFakeFence is signalled by hand
+// so anything built on the watcher can run without a device.
+class FGPUFence
+{
+public:
+    virtual ~FGPUFence() = default;
+
+    virtual uint64_t GetCompletedValue() const = 0;
+    // Blocks until Value completed or Interrupt was called. An Interrupt issued before the wait is not lost.
+    virtual void WaitForValue(uint64_t Value) = 0;
+    virtual void Interrupt() = 0;
+};
+
+class FD3D12Fence : public FGPUFence
+{
+public:
+    FD3D12Fence(ID3D12Device5* const Device, const std::wstring_view Name);
+    ~FD3D12Fence() override;
+
+    ID3D12Fence* GetD3D12Fence() const { return Fence.Get(); }
+
+    uint64_t GetCompletedValue() const override;
+    void WaitForValue(uint64_t Value) override;
+    void Interrupt() override;
+
+private:
+    wrl::ComPtr<ID3D12Fence> Fence{};
+    HANDLE CompletionEvent{};
+    HANDLE InterruptEvent{};
+};
+
+class FFakeFence : public FGPUFence
+{
+public:
+    void Signal(uint64_t Value);
+
+    uint64_t GetCompletedValue() const override;
+    void WaitForValue(uint64_t Value) override;
+    void Interrupt() override;
+
+private:
+    mutable std::mutex Mutex;
+    std::condition_variable Condition;
+    uint64_t CompletedValue = 0u;
+    bool bInterrupted = false;
+};
+
+// Runs callbacks from a dedicated thread once a fence value retires, so callers can schedule work
+// after the GPU instead of stalling on it. Callbacks for the same value run in registration order.
+// Keep them short (release a resource, recycle a context), hand anything heavy to the job system.
+// Destroying the watcher runs the callbacks whose value completed, it asserts when others are left.
+class FFenceWatcher
+{
+public:
+    explicit FFenceWatcher(FGPUFence& InFence);
+    ~FFenceWatcher();
+
+    // Always runs on the watcher thread, even if Value already completed.
+    void OnCompletion(uint64_t Value, std::function<void()> Callback);
+
+    // Blocks until every callback registered for Value or earlier has run. Not callable from a callback.
+    void WaitForCallbacks(uint64_t Value);
+
+    uint32_t GetNumPendingCallbacks() const;
+
+private:
+    struct FPendingCallback
+    {
+        uint64_t Value;
+        uint64_t Order;
+        std::function<void()> Callback;
+
+        // Min heap on (Value, Order).
+        bool operator<(const FPendingCallback& Other) const
+        {
+            return Value != Other.Value ? Value > Other.Value : Order > Other.Order;
+        }
+    };
+
+    void WatchLoop();
+
+    FGPUFence& Fence;
+
+    mutable std::mutex Mutex;
+    std::condition_variable CallbacksRetired;
+    std::priority_queue<FPendingCallback> PendingCallbacks;
+    uint64_t NextOrder = 0u;
+    // Value the watcher thread is blocked on, zero while it is not waiting.
+    uint64_t WaitingValue = 0u;
+    bool bRunningCallbacks = false;
+    bool bQuit = false;
+
+    std::thread Thread;
+};
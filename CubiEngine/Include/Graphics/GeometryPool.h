@@ -0,0 +1,149 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include "Graphics/Resource.h"
+#include "Graphics/TLSFAllocator.h"
+
+// Where one mesh lives in the pool, in elements of the streams. Indices are relative to BaseVertex.
+struct FGeometryRange
+{
+    uint32_t BaseVertex{};
+    uint32_t NumVertices{};
+    uint32_t FirstIndex{};
+    uint32_t NumIndices{};
+};
+
+struct FGeometryHandle
+{
+    uint32_t Index{ INVALID_INDEX_U32 };
+
+    bool IsValid() const { return Index != INVALID_INDEX_U32; }
+};
+
+struct FGeometryData
+{
+    std::span<const XMFLOAT3> Positions{};
+    std::span<const XMFLOAT2> TextureCoords{};
+    std::span<const XMFLOAT3> Normals{};
+    std::span<const XMFLOAT3> Tangents{};
+    std::span<const uint32_t> Indices{};
+};
+
+struct FGeometryPoolStats
+{
+    uint32_t NumAllocations{};
+    uint32_t NumVertices{};
+    uint32_t VertexCapacity{};
+    uint32_t NumIndices{};
+    uint32_t IndexCapacity{};
+    float VertexFragmentation{};
+    float IndexFragmentation{};
+    uint32_t NumGrows{};
+    uint32_t NumDefragments{};
+    uint32_t BufferGeneration{};
+};
+
+// Every mesh's vertices and indices, sub-allocated out of one buffer per stream instead of five buffers per mesh.
+// Shaders read a stream through its single bindless SRV and add BaseVertex themselves, draws pass FirstIndex as
+// the start index location. Growing and defragmenting copy into new buffers and retire the old ones once the
+// frames still reading them are done, so draws recorded before the move stay valid.
+class FGeometryPool
+{
+public:
+    enum EVertexStream : uint32_t
+    {
+        Position,
+        TextureCoord,
+        Normal,
+        Tangent,
+        NumVertexStreams,
+    };
+
+    FGeometryPool();
+
+    // Streams other than positions and indices may be empty, they are left uninitialized. Data is uploaded with
+    // the next upload batch.
+    FGeometryHandle Allocate(const FGeometryData& Data, std::wstring_view Name);
+    // The range is reused once the frames in flight that may still draw it are done.
+    void Free(FGeometryHandle Handle);
+
+    // Packs every range to the front of new buffers.
+    void Defragment();
+
+    // Call once per frame, releases what the frames in flight stopped using.
+    void BeginFrame();
+
+    const FGeometryRange& GetRange(FGeometryHandle Handle) const { return Entries[Handle.Index].Range; }
+
+    uint32_t GetVertexBufferSrv(EVertexStream Stream) const { return VertexBuffers[Stream].SrvIndex; }
+    uint32_t GetIndexBufferSrv() const { return IndexBuffer.SrvIndex; }
+    const FBuffer& GetVertexBuffer(EVertexStream Stream) const { return VertexBuffers[Stream]; }
+    const FBuffer& GetIndexBuffer() const { return IndexBuffer; }
+    // Changes whenever growing or defragmenting swapped in new buffers. Anything that copied the stream SRVs or
+    // the ranges somewhere has to copy them again.
+    uint32_t GetBufferGeneration() const { return BufferGeneration; }
+
+    FGeometryPoolStats GetStats() const;
+
+private:
+    static constexpr uint32_t INITIAL_VERTEX_CAPACITY = 256u * 1024u;
+    static constexpr uint32_t INITIAL_INDEX_CAPACITY = 1024u * 1024u;
+    // Compact instead of growing when at least this share of the free space is splintered.
+    static constexpr float DEFRAGMENT_THRESHOLD = 0.5f;
+
+    static constexpr std::array<uint32_t, NumVertexStreams> VERTEX_STRIDES = {
+        sizeof(XMFLOAT3), sizeof(XMFLOAT2), sizeof(XMFLOAT3), sizeof(XMFLOAT3),
+    };
+
+    struct FEntry
+    {
+        FGeometryRange Range{};
+        uint32_t VertexNode{ FTLSFAllocator::INVALID_NODE };
+        uint32_t IndexNode{ FTLSFAllocator::INVALID_NODE };
+    };
+
+    // In elements of the stream.
+    struct FCopyRange
+    {
+        uint32_t SrcOffset;
+        uint32_t DstOffset;
+        uint32_t Size;
+    };
+
+    struct FPendingFree
+    {
+        uint64_t FrameNumber;
+        uint32_t EntryIndex;
+    };
+
+    // Compacts or grows Allocator until it has a block of Size, false if the buffers cannot get that large.
+    // bVertices picks the vertex streams or the index buffer as the buffers behind Allocator.
+    bool Reserve(FTLSFAllocator& Allocator, uint32_t Size, bool bVertices);
+    void Compact(FTLSFAllocator& Allocator, bool bVertices);
+    // New buffers at the allocator's capacity, Copies carried over from the current ones.
+    void ReplaceBuffers(const std::vector<FCopyRange>& Copies, bool bVertices);
+    // Merges ranges that follow each other on both sides, so a packed pool moves in a handful of copies.
+    static void AddCopyRange(std::vector<FCopyRange>& Copies, uint32_t SrcOffset, uint32_t DstOffset, uint32_t Size);
+    static void CopyRanges(const FBuffer& DstBuffer, const FBuffer& SrcBuffer, const std::vector<FCopyRange>& Copies, uint32_t Stride);
+    FBuffer CreateStreamBuffer(uint32_t NumElements, uint32_t Stride, std::wstring_view Name) const;
+    void RetireBuffer(FBuffer&& Buffer);
+
+    mutable std::mutex Mutex;
+
+    FTLSFAllocator VertexAllocator;
+    FTLSFAllocator IndexAllocator;
+
+    std::array<FBuffer, NumVertexStreams> VertexBuffers{};
+    FBuffer IndexBuffer{};
+
+    // A deque so ranges handed out by GetRange stay put while entries are added.
+    std::deque<FEntry> Entries;
+    std::vector<uint32_t> FreeEntries;
+
+    std::deque<FPendingFree> PendingFrees;
+    uint64_t FrameNumber{};
+
+    uint32_t NumGrows{};
+    uint32_t NumDefragments{};
+};
@@ -12,13 +12,20 @@ class FQueryHeap;
 class FGraphicsContext : public FContext
 {
 public:
-    FGraphicsContext();
+    // A compute list only takes compute and copy work, for render graph passes on the async compute queue.
+    explicit FGraphicsContext(D3D12_COMMAND_LIST_TYPE Type = D3D12_COMMAND_LIST_TYPE_DIRECT);
     void SetDescriptorHeaps() const;
     void Reset();
+    // Starts a new command list on the same allocator once the previous one was submitted, to split a frame's work
+    // into several submissions. Bindings, root signatures included, start over.
+    void Reopen();
 
     void ClearRenderTargetView(const FTexture* InRenderTarget, std::span<const float, 4> Color);
     void ClearUnorderedAccessViewFloat(const FTexture* Texture, std::span<const float, 4> Color);
     void ClearDepthStencilView(const FTexture* Texture);
+    // Initializes a placed render target or depth buffer after its aliasing barrier without writing it, the texture
+    // has to be in the render target or depth write state.
+    void DiscardResource(const FTexture* Texture);
 
     void SetRenderTarget(const FTexture* RenderTarget) const;
     void SetRenderTarget(const FTexture* RenderTarget, const FTexture* DepthStencilTexture) const;
@@ -34,11 +41,13 @@ public:
     void SetPrimitiveTopologyLayout(const D3D_PRIMITIVE_TOPOLOGY PrimitiveTopology) const;
 
     void SetIndexBuffer(const FBuffer& Buffer) const;
-    void DrawIndexedInstanced(const uint32_t IndicesCount, const uint32_t InstanceCount = 1u) const;
+    void DrawIndexedInstanced(const uint32_t IndicesCount, const uint32_t InstanceCount = 1u, const uint32_t StartIndexLocation = 0u) const;
     void DrawInstanced(uint32_t VertexCountPerInstance,
         uint32_t InstanceCount,
         uint32_t StartVertexLocation,
         uint32_t StartInstanceLocation) const;
+    void ExecuteIndirect(ID3D12CommandSignature* const CommandSignature, uint32_t MaxCommandCount,
+        const FBuffer& ArgumentBuffer, uint64_t ArgumentBufferOffset = 0u) const;
 
     void SetGraphicsRootSignature() const;
     template<typename T>
@@ -47,6 +56,25 @@ public:
         SetRoot32BitConstants<T>(0u, RenderResources, true);
     }
 
+    // Update only [OffsetInBytes, OffsetInBytes + SizeInBytes) of the root constants, the rest keeps its previous value.
+    template<typename T>
+    void SetGraphicsRoot32BitConstants(const T* RenderResources, size_t OffsetInBytes, size_t SizeInBytes) const
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Root constants must be trivially copyable.");
+        static_assert(sizeof(T) / sizeof(uint32_t) <= NUMBER_32_BIT_CONSTANTS, "Root constants exceed the root signature limit.");
+        assert(OffsetInBytes % sizeof(uint32_t) == 0u && SizeInBytes % sizeof(uint32_t) == 0u);
+        assert(OffsetInBytes + SizeInBytes <= sizeof(T));
+
+        D3D12CommandList->SetGraphicsRoot32BitConstants(0u, static_cast<UINT>(SizeInBytes / sizeof(uint32_t)),
+            reinterpret_cast<const uint8_t*>(RenderResources) + OffsetInBytes, static_cast<UINT>(OffsetInBytes / sizeof(uint32_t)));
+
+        if (CommandCapture)
+        {
+            RecordRoot32BitConstants(true, 0u, reinterpret_cast<const uint8_t*>(RenderResources) + OffsetInBytes,
+                static_cast<uint32_t>(SizeInBytes / sizeof(uint32_t)), static_cast<uint32_t>(OffsetInBytes / sizeof(uint32_t)));
+        }
+    }
+
     void SetComputeRootSignature() const;
     void SetRaytracingComputeRootSignature() const;
     template<typename T>
@@ -96,5 +124,10 @@ private:
         {
             D3D12CommandList->SetComputeRoot32BitConstants(RootParameterIndex, Num32BitValues, RenderResources, 0u);
         }
+
+        if (CommandCapture)
+        {
+            RecordRoot32BitConstants(bGraphics, RootParameterIndex, RenderResources, Num32BitValues, 0u);
+        }
     }
 };
@@ -1,10 +1,13 @@
 #pragma once
 
+#include "Graphics/Resource.h"
 #include "ShaderInterlop/ConstantBuffers.hlsli"
 
 class FPBRMaterial
 {
 public:
+    ~FPBRMaterial();
+
     std::string Name{};
 
     uint32_t GetAlbedoSrv() const { return AlbedoTexture ? AlbedoTexture->SrvIndex : INVALID_INDEX_U32; };
@@ -31,11 +34,15 @@ public:
     std::unique_ptr<FTexture> ORMTexture;
     FSampler ORMSampler{};
 
-    FBuffer MaterialBuffer{};
-    interlop::MaterialBuffer MaterialBufferData;
-
-    uint32_t MaterialIndex{};
+    // Moves the material to the material table slot holding Parameters, the upload goes out with the next frame.
+    void SetParameters(const interlop::MaterialData& InParameters);
+    const interlop::MaterialData& GetParameters() const { return Parameters; }
+    // Slot in the material table, shared with every material that has the same parameters.
+    uint32_t MaterialIndex = INVALID_INDEX_U32;
 
-    EAlphaMode AlphaMode;
+    EAlphaMode AlphaMode = EAlphaMode::Opaque;
     double AlphaCutoff;
+
+private:
+    interlop::MaterialData Parameters{};
 };
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include "Graphics/Resource.h"
+#include "ShaderInterlop/ConstantBuffers.hlsli"
+
+// Consecutive slots of the material table.
+struct FMaterialSlotRange
+{
+    uint32_t FirstSlot{};
+    uint32_t NumSlots{};
+};
+
+// CPU side of the material table, no device involved. Identical parameter blocks share a slot, so the hundreds of
+// materials of a large scene only take as many slots as they have distinct parameters. Slots are never written while
+// referenced : editing a material moves it to another slot, and a slot whose last reference went is only reused
+// FRAMES_IN_FLIGHT frames later, so frames in flight keep reading what they recorded against.
+class FMaterialParameterTable
+{
+public:
+    static constexpr uint32_t INVALID_SLOT = INVALID_INDEX_U32;
+
+    explicit FMaterialParameterTable(uint32_t InitialCapacity);
+
+    // Slot holding Data, each Acquire needs a matching Release. Doubles the capacity when every slot is taken.
+    uint32_t Acquire(const interlop::MaterialData& Data);
+    void Release(uint32_t Slot);
+    // Acquire then Release, so replacing a block with itself keeps the slot.
+    uint32_t Replace(uint32_t Slot, const interlop::MaterialData& Data);
+
+    // Call once per frame, hands the slots released FRAMES_IN_FLIGHT frames ago back to the free list.
+    void BeginFrame();
+
+    // Slots written since the last call, sorted and merged into runs.
+    std::vector<FMaterialSlotRange> TakeDirtyRanges();
+
+    // Slots below GetNumSlots have been handed out at least once, the rest of the capacity never was.
+    std::span<const interlop::MaterialData> GetData() const { return std::span(Data).first(NumSlots); }
+    uint32_t GetCapacity() const { return static_cast<uint32_t>(Data.size()); }
+    uint32_t GetNumSlots() const { return NumSlots; }
+    uint32_t GetNumLiveSlots() const { return NumLiveSlots; }
+    uint32_t GetRefCount(uint32_t Slot) const { return Slots[Slot].RefCount; }
+    // Acquires that found their block already in the table.
+    uint32_t GetNumDeduplicated() const { return NumDeduplicated; }
+
+private:
+    struct FSlot
+    {
+        uint32_t RefCount{};
+        uint64_t Hash{};
+    };
+
+    struct FPendingFree
+    {
+        uint64_t FrameNumber;
+        uint32_t Slot;
+    };
+
+    uint32_t FindSlot(const interlop::MaterialData& Block, uint64_t Hash) const;
+    uint32_t AllocateSlot();
+
+    std::vector<interlop::MaterialData> Data;
+    std::vector<FSlot> Slots;
+    uint32_t NumSlots = 0u;
+    uint32_t NumLiveSlots = 0u;
+
+    std::vector<uint32_t> FreeSlots;
+    std::deque<FPendingFree> PendingFrees;
+    uint64_t FrameNumber = 0u;
+
+    // Live slots only, keyed by the hash of their block.
+    std::unordered_multimap<uint64_t, uint32_t> SlotsByHash;
+    std::vector<uint32_t> DirtySlots;
+
+    uint32_t NumDeduplicated = 0u;
+};
+
+// All material parameters in one structured buffer indexed by material id, in place of a constant buffer and a
+// CBV per material. Acquiring and editing only touch the CPU table, BeginFrame uploads the dirty runs with the
+// upload batch before anything of the frame records. A full table grows into a new buffer, the old one is retired
+// once the frames in flight are done with it.
+class FMaterialTable
+{
+public:
+    static constexpr uint32_t INITIAL_CAPACITY = 1024u;
+
+    FMaterialTable();
+
+    uint32_t Acquire(const interlop::MaterialData& Data);
+    void Release(uint32_t Slot);
+    uint32_t Replace(uint32_t Slot, const interlop::MaterialData& Data);
+
+    void BeginFrame();
+
+    // Changes when the table grows, read it when recording rather than caching it.
+    uint32_t GetSrv() const { return Buffer.SrvIndex; }
+
+    uint32_t GetNumLiveSlots() const;
+    uint32_t GetNumDeduplicated() const;
+
+private:
+    FBuffer CreateTableBuffer(uint32_t Capacity) const;
+
+    mutable std::mutex Mutex;
+    FMaterialParameterTable Table;
+
+    FBuffer Buffer{};
+};
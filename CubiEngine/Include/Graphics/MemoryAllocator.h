@@ -10,9 +10,16 @@ public:
 
     FAllocation CreateBufferResourceAllocation(const FBufferCreationDesc& BufferCreationDesc,
         const FResourceCreationDesc& ResourceCreationDesc);
-    FAllocation CreateTextureResourceAllocation(const FTextureCreationDesc& TextureCreationDesc, D3D12_RESOURCE_STATES& ResourceState, bool bUAVAllowed);
+    // With a Placement the texture is created in that memory and the allocation holds no memory of its own.
+    FAllocation CreateTextureResourceAllocation(const FTextureCreationDesc& TextureCreationDesc, D3D12_RESOURCE_STATES& ResourceState, bool bUAVAllowed,
+        const FTexturePlacement* Placement = nullptr);
+
+    D3D12_RESOURCE_ALLOCATION_INFO GetTextureAllocationInfo(const FTextureCreationDesc& TextureCreationDesc, bool bUAVAllowed) const;
+    // GPU memory in a heap of its own, for textures placed with CreateTextureResourceAllocation.
+    wrl::ComPtr<D3D12MA::Allocation> AllocateHeap(uint64_t Size, uint64_t Alignment, D3D12_HEAP_FLAGS HeapFlags);
 
 private:
+    wrl::ComPtr<ID3D12Device> Device{};
     wrl::ComPtr<D3D12MA::Allocator> DmaAllocator{};
     std::recursive_mutex ResourceAllocationMutex{};
 };
\ No newline at end of file
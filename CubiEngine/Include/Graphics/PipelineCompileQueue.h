@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Core/JobSystem.h"
+
+#include <exception>
+
+// Result of a compile scheduled on an FPipelineCompileQueue. Copies share the same result.
+template<typename T>
+class TCompileFuture
+{
+public:
+    TCompileFuture() = default;
+
+    bool IsValid() const { return State != nullptr; }
+    bool IsReady() const { return !State || State->Counter.IsDone(); }
+
+    // Runs other jobs until the compile finished instead of blocking, then rethrows whatever the compile threw.
+    const T& Get() const
+    {
+        assert(State);
+        if (!State->Counter.IsDone())
+        {
+            GJobSystem->Wait(State->Counter);
+        }
+        if (State->Error)
+        {
+            std::rethrow_exception(State->Error);
+        }
+        return State->Value;
+    }
+
+private:
+    friend class FPipelineCompileQueue;
+
+    struct FState
+    {
+        FJobCounter Counter;
+        T Value{};
+        std::exception_ptr Error{};
+    };
+
+    std::shared_ptr<FState> State;
+};
+
+// Runs shader and pipeline compiles across the job system. Callers enqueue everything they need up front and
+// only wait on the futures once the result is used, so independent compiles overlap on every core.
+// Without a job system the compile runs inline and the future is ready right away.
+class FPipelineCompileQueue
+{
+public:
+    FPipelineCompileQueue() = default;
+    FPipelineCompileQueue(const FPipelineCompileQueue&) = delete;
+    FPipelineCompileQueue& operator=(const FPipelineCompileQueue&) = delete;
+    ~FPipelineCompileQueue();
+
+    template<typename T>
+    TCompileFuture<T> Enqueue(std::function<T()> Compile)
+    {
+        TCompileFuture<T> Future;
+        Future.State = std::make_shared<typename TCompileFuture<T>::FState>();
+
+        auto Run = [State = Future.State, Compile = std::move(Compile)]()
+        {
+            // A worker must not unwind, the error is handed to whoever waits on the future.
+            try
+            {
+                State->Value = Compile();
+            }
+            catch (...)
+            {
+                State->Error = std::current_exception();
+            }
+        };
+
+        if (!GJobSystem)
+        {
+            Run();
+            return Future;
+        }
+
+        // Scheduled under the lock, until then the counter reads as done and must not be pruned.
+        std::lock_guard Lock(Mutex);
+        std::erase_if(InFlight, [](const FInFlightCompile& Compile) { return Compile.Counter->IsDone(); });
+        InFlight.push_back(FInFlightCompile{ .State = Future.State, .Counter = &Future.State->Counter });
+        NumEnqueued++;
+        GJobSystem->Run(std::move(Run), &Future.State->Counter);
+        return Future;
+    }
+
+    // Waits for everything enqueued so far, e.g. before the device goes away.
+    void WaitAll();
+
+    uint32_t GetNumPending() const;
+    uint32_t GetNumEnqueued() const;
+
+private:
+    struct FInFlightCompile
+    {
+        // Keeps the counter alive even if every future was dropped.
+        std::shared_ptr<void> State;
+        const FJobCounter* Counter;
+    };
+
+    mutable std::mutex Mutex;
+    std::vector<FInFlightCompile> InFlight;
+    uint32_t NumEnqueued = 0u;
+};
@@ -1,18 +1,52 @@
 #pragma once
 
 #include "Graphics/Resource.h"
+#include "Graphics/PipelineCompileQueue.h"
+#include "Graphics/ShaderPermutation.h"
+
+#include <variant>
 
 class FPipelineState
 {
 public:
     FPipelineState() = default;
+    // Compile on the calling thread.
     FPipelineState(ID3D12Device5* const device, const FGraphicsPipelineStateCreationDesc& pipelineStateCreationDesc);
     FPipelineState(ID3D12Device5* const device, const FComputePipelineStateCreationDesc& pipelineStateCreationDesc);
+    // Compile in flight on the pipeline compile queue.
+    explicit FPipelineState(TCompileFuture<wrl::ComPtr<ID3D12PipelineState>> InPendingPipelineState);
+
+    // False while the pipeline is still compiling, passes that can be skipped check this first.
+    bool IsReady() const { return PendingPipelineState.IsReady(); }
+    // Waits for a pending compile the first time it is used.
+    ID3D12PipelineState* Get() const;
     
     // The shader path passed in needs to be relative (with respect to root directory), it will internally find the
     // complete path (with respect to the executable).
     static void CreateBindlessRootSignature(ID3D12Device* const device, const std::wstring_view shaderPath);
     static inline wrl::ComPtr<ID3D12RootSignature> StaticRootSignature{};
 
+private:
     wrl::ComPtr<ID3D12PipelineState> PipelineStateObject{};
+    TCompileFuture<wrl::ComPtr<ID3D12PipelineState>> PendingPipelineState{};
+};
+
+// One pipeline per permutation of a shader, looked up by permutation key. Permutations are compiled on demand,
+// or all up front in the background with PrecompileAll. The descs string views must outlive this object.
+class FPipelineStatePermutations
+{
+public:
+    FPipelineStatePermutations() = default;
+    FPipelineStatePermutations(const FGraphicsPipelineStateCreationDesc& InDesc, FShaderPermutationDomain InDomain);
+    FPipelineStatePermutations(const FComputePipelineStateCreationDesc& InDesc, FShaderPermutationDomain InDomain);
+
+    void PrecompileAll();
+    const FPipelineState& Get(uint32_t Key);
+
+    const FShaderPermutationDomain& GetDomain() const { return Domain; }
+
+private:
+    std::variant<FGraphicsPipelineStateCreationDesc, FComputePipelineStateCreationDesc> Desc;
+    FShaderPermutationDomain Domain;
+    std::unordered_map<uint32_t, FPipelineState> PipelineStates;
 };
\ No newline at end of file
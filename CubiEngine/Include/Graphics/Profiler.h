@@ -4,21 +4,29 @@
 #include "WinPixEventRuntime/pix3.h"
 #include "Graphics/Query.h"
 #include "Graphics/GraphicsContext.h"
+#include "Core/FrameArena.h"
+
+class FCommandQueue;
 
 class FGPUEventNode
 {
 public:
-    FGPUEventNode(const char* Name, FGPUEventNode* Parent);
+    FGPUEventNode(const char* Name, FGPUEventNode* Parent, FLinearArena& Arena, FGraphicsContext* Context);
     void StartTiming();
     void StopTiming();
     double GetTiming(UINT64* ReadBackData);
     
     FGPUEventNode* Parent;
-    std::vector<FGPUEventNode*> Children;
+    TArenaVector<FGPUEventNode*> Children;
 
     FQueryLocation BeginQueryLocation;
     FQueryLocation EndQueryLocation;
 
+    // The timestamps go on the list of the queue running the event, an async compute pass times itself on its
+    // compute context. The queue's frequency converts its ticks.
+    FGraphicsContext* Context;
+    FCommandQueue* TimestampQueue;
+
     const char* Name;
 };
 
@@ -38,12 +46,18 @@ public:
     void EndFrame();
     void EndFrameAfterFence();
     void TraverseNode(FGPUEventNode* Node, UINT64* ReadBackData);
-    void PushEvent(const char* Name, bool bFrameStart = false);
+    // Context is the current graphics context when null.
+    void PushEvent(const char* Name, bool bFrameStart = false, FGraphicsContext* Context = nullptr);
     void PopEvent(bool bFrameEnd = false);
     void ResolveQueryData();
     std::vector<FProfileData>& GetProfileData() { return ProfileData; }
 
 private:
+    // Nodes of frame N are traversed at the end of frame N + FRAMES_IN_FLIGHT, after that frame built its own
+    // tree, hence one arena more than frames in flight. An arena is reset once its tree was traversed.
+    static constexpr uint32_t NUM_NODE_ARENAS = FRAMES_IN_FLIGHT + 1u;
+    std::array<FLinearArena, NUM_NODE_ARENAS> NodeArenas;
+
     FGPUEventNode* RootNode = nullptr;
     FGPUEventNode* CurrentEventNode = nullptr;
 
@@ -60,7 +74,7 @@ private:
 class GPUProfileScopedObject
 {
 public:
-    GPUProfileScopedObject(const char* Name);
+    GPUProfileScopedObject(const char* Name, FGraphicsContext* Context = nullptr);
     ~GPUProfileScopedObject();
 };
 
@@ -74,3 +88,7 @@ public:
 #define SCOPED_GPU_EVENT(NAME)\
     GPUProfileScopedObject GPUProfileEvent_##NAME = GPUProfileScopedObject(#NAME);
 
+// For work recorded on a context other than the current graphics one, e.g. an async compute pass.
+#define SCOPED_GPU_EVENT_ON_CONTEXT(GraphicsContext, NAME)\
+    GPUProfileScopedObject GPUProfileEvent_##NAME = GPUProfileScopedObject(#NAME, GraphicsContext);
+
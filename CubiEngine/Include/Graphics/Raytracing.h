@@ -31,15 +31,15 @@ class FRaytracingGeometry
 {
 public:
     FRaytracingGeometry() = delete;
+    // Float3 positions and 32 bit indices, each a range of a larger buffer.
     FRaytracingGeometry(
-        std::pair<ComPtr<ID3D12Resource>, uint32_t>& VertexBuffer,
-        std::pair<ComPtr<ID3D12Resource>, uint32_t>& IndexBuffer
+        ID3D12Resource* VertexBuffer, uint64_t VertexOffsetInBytes, uint32_t VertexCount,
+        ID3D12Resource* IndexBuffer, uint64_t IndexOffsetInBytes, uint32_t IndexCount
     );
 
     ID3D12Resource* GetBLAS() { return result.Get(); }
 
 private:
-    ComPtr<ID3D12Resource> scratch;
     ComPtr<ID3D12Resource> result;
 };
 
@@ -60,7 +60,6 @@ public:
     uint32_t GetTopLevelASResourceView() { return SrvIndex; };
     D3D12_GPU_VIRTUAL_ADDRESS GetTopLevelASGPUVirtualAddress() { return GPUVirtualAddress; };
 
-    ComPtr<ID3D12Resource> pScratch;
     ComPtr<ID3D12Resource> pResult;
     ComPtr<ID3D12Resource> pInstanceDesc;
 
@@ -73,6 +72,8 @@ public:
 private:
     FBuffer GeometryInfoBuffer{};
     FBuffer MaterialBuffer{};
+    // Geometry pool buffers the geometry infos point into.
+    uint32_t GeometryPoolGeneration{};
 };
 
 /*-----------------------------------------------------------------------
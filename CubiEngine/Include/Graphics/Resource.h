@@ -33,12 +33,17 @@ struct FGraphicsPipelineStateCreationDesc
 
     // advanced
     D3D12_DEPTH_WRITE_MASK DepthWriteMask{ D3D12_DEPTH_WRITE_MASK_ALL };
+
+    // "NAME" or "NAME=VALUE", applied to both shaders.
+    std::vector<std::wstring> Defines{};
 };
 
 struct FComputePipelineStateCreationDesc
 {
     ShaderModule ShaderModule{};
     std::wstring_view PipelineName{};
+
+    std::vector<std::wstring> Defines{};
 };
 
 struct FRaytracingPipelineStateCreationDesc
@@ -60,6 +65,13 @@ struct FAllocation
     wrl::ComPtr<ID3D12Resource> Resource{};
 };
 
+// Where a placed texture lives, Heap coming from RHIAllocateHeap.
+struct FTexturePlacement
+{
+    D3D12MA::Allocation* Heap = nullptr;
+    uint64_t Offset{};
+};
+
 struct FBuffer
 {
     // To be used primarily for constant buffers.
@@ -128,6 +140,9 @@ struct FTexture
 
     std::vector<uint32_t> MipUavIndex{};
 
+    uint32_t NumSubresources{ 1u };
+    // The state the work recorded so far leaves the texture in, RESOURCE_STATE_UNKNOWN while its subresources
+    // are in different states. Contexts expect the texture in it the first time they touch it.
     D3D12_RESOURCE_STATES ResourceState{};
 
     std::wstring DebugName{};
@@ -140,6 +155,8 @@ struct FTexture
     static bool IsCompressedFormat(DXGI_FORMAT Format);
 	static uint32_t GetBytesPerPixel(DXGI_FORMAT Format);
     static bool IsUAVAllowed(ETextureUsage Usage, DXGI_FORMAT Format);
+    // States a texture can be in while several readers use it at once.
+    static bool IsReadOnlyState(D3D12_RESOURCE_STATES State);
 
     operator bool() const
     {
@@ -155,19 +172,20 @@ struct FIntRect
     uint32_t Height;
 };
 
+// Textures of the frame being rendered, bound from the render graph once it is realized.
 struct FSceneTexture
 {
     FIntRect Size{};
-    std::unique_ptr<FTexture> GBufferA; // Albedo
-    std::unique_ptr<FTexture> GBufferB; // Normal
-    std::unique_ptr<FTexture> GBufferC; // AO + MetalRoughness
-    std::unique_ptr<FTexture> VelocityTexture;
+    FTexture* GBufferA{}; // Albedo
+    FTexture* GBufferB{}; // Normal
+    FTexture* GBufferC{}; // AO + MetalRoughness
+    FTexture* VelocityTexture{};
 
-    std::unique_ptr<FTexture> DepthTexture;
-    std::unique_ptr<FTexture> PrevDepthTexture;
+    FTexture* DepthTexture{};
+    FTexture* PrevDepthTexture{};
 
-    std::unique_ptr<FTexture> LDRTexture;
-    std::unique_ptr<FTexture> HDRTexture;
+    FTexture* LDRTexture{};
+    FTexture* HDRTexture{};
 };
 
 struct FCbvCreationDesc
@@ -235,7 +253,9 @@ enum class EBufferUsage
     IndexBuffer,
     StructuredBuffer,
     ConstantBuffer,
-    StructuredBufferUAV
+    StructuredBufferUAV,
+    // Upload heap structured buffer, rewritten by the CPU every frame and read by the GPU in place.
+    DynamicStructuredBuffer
 };
 
 struct FBufferCreationDesc
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+
+// State of a resource that is not known : no state recorded yet, or subresources in different states.
+inline constexpr D3D12_RESOURCE_STATES RESOURCE_STATE_UNKNOWN = static_cast<D3D12_RESOURCE_STATES>(~0u);
+
+// One state for the whole resource, or one per subresource once they differ.
+struct FSubresourceStates
+{
+    D3D12_RESOURCE_STATES Get(uint32_t Subresource) const
+    {
+        return PerSubresource.empty() ? State : PerSubresource[Subresource];
+    }
+    bool IsUniform() const { return PerSubresource.empty(); }
+
+    void SetAll(D3D12_RESOURCE_STATES NewState);
+    void Set(uint32_t Subresource, D3D12_RESOURCE_STATES NewState, uint32_t NumSubresources);
+
+    D3D12_RESOURCE_STATES State = RESOURCE_STATE_UNKNOWN;
+    std::vector<D3D12_RESOURCE_STATES> PerSubresource;
+};
+
+// The state every registered resource is left in by the command lists submitted so far, across all queues.
+// Resources are registered with the state they are created in. Thread safe.
+class FResourceStateTable
+{
+public:
+    void Register(ID3D12Resource* Resource, uint32_t NumSubresources, D3D12_RESOURCE_STATES State);
+    void Unregister(ID3D12Resource* Resource);
+
+    // RESOURCE_STATE_UNKNOWN for a resource that is not registered, or whose subresources differ.
+    D3D12_RESOURCE_STATES GetState(ID3D12Resource* Resource,
+        uint32_t Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES) const;
+
+private:
+    friend class FResourceStateTracker;
+
+    struct FEntry
+    {
+        uint32_t NumSubresources = 1u;
+        FSubresourceStates States;
+    };
+
+    mutable std::mutex Mutex;
+    std::unordered_map<ID3D12Resource*, FEntry> Entries;
+};
+
+// Barriers of one command list, from the state each subresource is in at that point of the list. No device
+// involved : Flush takes anything with a ResourceBarrier method, so a mock command list can stand in for the
+// real one.
+//
+// The first time the list touches a resource, the caller says which state it expects it in. The list transitions
+// from there and the expectation is checked against the state table when the list is submitted, where
+// ResolvePendingBarriers returns the transitions to run before the list for the resources that are elsewhere. A
+// resource whose state the caller does not know simply starts in the state it is first transitioned to, that
+// transition is left to submission.
+//
+// Transitions into the state a subresource is already in are dropped, and one following another on the same
+// subresource before the batch is flushed merges into it, so each batch goes out in a single ResourceBarrier call
+// with no transition the GPU would wait on for nothing.
+class FResourceStateTracker
+{
+public:
+    // StateBefore is only read the first time the list touches Resource, RESOURCE_STATE_UNKNOWN when the caller
+    // does not know it.
+    void Transition(ID3D12Resource* Resource, uint32_t NumSubresources, D3D12_RESOURCE_STATES StateBefore,
+        D3D12_RESOURCE_STATES StateAfter, uint32_t Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+
+    // Split transition : the GPU may start it at BeginTransition and has to finish it at EndTransition, overlapping
+    // it with the work recorded in between, which must not use the subresources. A resource the list has not
+    // touched yet has nothing to start from, its transition is left to submission and EndTransition does nothing.
+    void BeginTransition(ID3D12Resource* Resource, uint32_t NumSubresources, D3D12_RESOURCE_STATES StateBefore,
+        D3D12_RESOURCE_STATES StateAfter, uint32_t Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+    void EndTransition(ID3D12Resource* Resource, uint32_t Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+
+    void UAVBarrier(ID3D12Resource* Resource);
+    void AliasingBarrier(ID3D12Resource* Before, ID3D12Resource* After);
+    // Queued as is, for resources the tracker does not follow.
+    void AddBarrier(const D3D12_RESOURCE_BARRIER& Barrier);
+
+    // Queued since the last flush, in order.
+    std::span<const D3D12_RESOURCE_BARRIER> GetBarriers() const { return Barriers; }
+
+    template<typename TCommandList>
+    void Flush(TCommandList& CommandList)
+    {
+        if (Barriers.empty()) return;
+
+        CommandList.ResourceBarrier(static_cast<UINT>(Barriers.size()), Barriers.data());
+        Barriers.clear();
+    }
+
+    // Where the list leaves Resource so far, RESOURCE_STATE_UNKNOWN when it did not touch it or when its
+    // subresources differ.
+    D3D12_RESOURCE_STATES GetState(ID3D12Resource* Resource) const;
+
+    // On submission, with every batch flushed and every split transition ended. Appends to OutBarriers the
+    // transitions from the states in Table to the ones the list expects, then records in Table the states the
+    // list leaves its resources in, both under one lock. Resources Table does not know are left out. Resets the
+    // tracker for the next list.
+    void ResolvePendingBarriers(FResourceStateTable& Table, std::vector<D3D12_RESOURCE_BARRIER>& OutBarriers);
+
+    void Reset();
+
+private:
+    struct FTrackedResource
+    {
+        uint32_t NumSubresources = 1u;
+        // State each subresource is expected in when the list starts, and the one it is in at this point.
+        FSubresourceStates Initial;
+        FSubresourceStates Current;
+    };
+
+    struct FSplitTransition
+    {
+        ID3D12Resource* Resource = nullptr;
+        uint32_t Subresource{};
+        D3D12_RESOURCE_STATES StateBefore{};
+        D3D12_RESOURCE_STATES StateAfter{};
+    };
+
+    void TransitionSubresources(ID3D12Resource* Resource, uint32_t NumSubresources, D3D12_RESOURCE_STATES StateBefore,
+        D3D12_RESOURCE_STATES StateAfter, uint32_t Subresource, D3D12_RESOURCE_BARRIER_FLAGS Flags);
+    void QueueTransition(ID3D12Resource* Resource, uint32_t Subresource, D3D12_RESOURCE_STATES StateBefore,
+        D3D12_RESOURCE_STATES StateAfter, D3D12_RESOURCE_BARRIER_FLAGS Flags);
+    bool IsSplitInFlight(ID3D12Resource* Resource, uint32_t Subresource) const;
+
+    std::unordered_map<ID3D12Resource*, FTrackedResource> Resources;
+    std::vector<D3D12_RESOURCE_BARRIER> Barriers;
+    std::vector<FSplitTransition> SplitTransitions;
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+
+// Everything that decides what the compiler is asked to do. The include closure is not part of it, it is only
+// known after a compile and is checked against the manifest stored with the entry.
+struct FShaderCacheKey
+{
+    std::wstring SourcePath;
+    std::wstring EntryPoint;
+    std::wstring TargetProfile;
+    // Compiler arguments other than entry point and profile, defines included.
+    std::vector<std::wstring> Arguments;
+    uint64_t CompilerVersion = 0u;
+};
+
+struct FShaderCompileOutput
+{
+    std::vector<uint8_t> Object;
+    std::vector<uint8_t> RootSignature;
+    // Every file the compile read, the source included. Transitive includes are all in here.
+    std::vector<std::wstring> Dependencies;
+};
+
+// Returns false if the compile failed, nothing is cached then.
+using FShaderCompileFunction = std::function<bool(const FShaderCacheKey& Key, FShaderCompileOutput& Output)>;
+
+struct FShaderCacheStats
+{
+    uint32_t NumHits = 0u;
+    uint32_t NumMisses = 0u;
+    // Misses that had a manifest whose dependencies changed since.
+    uint32_t NumInvalidated = 0u;
+};
+
+// On-disk cache of compiled shaders, independent of DXC so it can be driven by any compile function.
+// Per key there is a manifest listing the content hash of every dependency, and the blob it produced. The blob
+// is addressed by the hash of the key and those dependency hashes, so touching any .hlsli in the include closure
+// points the key at a different blob and the stale one is never read.
+class FShaderCache
+{
+public:
+    explicit FShaderCache(const std::filesystem::path& InDirectory);
+
+    // Cached output if every recorded dependency still hashes the same, otherwise compiles and stores the result.
+    bool GetOrCompile(const FShaderCacheKey& Key, const FShaderCompileFunction& Compile, FShaderCompileOutput& Output);
+
+    bool Lookup(const FShaderCacheKey& Key, FShaderCompileOutput& Output);
+    void Store(const FShaderCacheKey& Key, const FShaderCompileOutput& Output);
+
+    FShaderCacheStats GetStats() const;
+
+    static uint64_t HashKey(const FShaderCacheKey& Key);
+
+private:
+    struct FFileHash
+    {
+        std::filesystem::file_time_type WriteTime;
+        uintmax_t Size = 0u;
+        uint64_t Hash = 0u;
+    };
+
+    // Content hash of a file, 0 if it cannot be read. Memoized on write time and size, so the same .hlsli is
+    // only read once however many shaders include it.
+    uint64_t HashFile(const std::wstring& Path);
+
+    std::filesystem::path GetManifestPath(uint64_t KeyHash) const;
+    std::filesystem::path GetBlobPath(uint64_t BlobHash) const;
+
+    std::filesystem::path Directory;
+
+    mutable std::mutex Mutex;
+    std::unordered_map<std::wstring, FFileHash> FileHashes;
+    FShaderCacheStats Stats;
+};
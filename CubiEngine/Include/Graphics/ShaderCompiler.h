@@ -17,6 +17,9 @@ enum class ShaderTypes : uint8_t
 
 namespace ShaderCompiler
 {
+    // Goes through the disk shader cache, DXC only runs when the source or any file it includes changed.
+    // Defines are given as "NAME" or "NAME=VALUE".
     Shader Compile(const ShaderTypes& shaderType, const std::wstring_view shaderPath,
-        const std::wstring_view entryPoint, const bool extractRootSignature = false);
+        const std::wstring_view entryPoint, const bool extractRootSignature = false,
+        const std::vector<std::wstring>& defines = {});
 }
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <functional>
+#include <span>
+
+// Settings a shader is specialized on at compile time instead of branching on at runtime. Every dimension
+// becomes a define NAME=Value, a permutation key packs one value per dimension in mixed radix.
+class FShaderPermutationDomain
+{
+public:
+    using FFilter = std::function<bool(std::span<const int32_t> Values)>;
+
+    // Each returns the dimension index used to read and write values.
+    uint32_t AddBool(std::wstring_view Name);
+    // Values 0 .. NumValues - 1.
+    uint32_t AddEnum(std::wstring_view Name, uint32_t NumValues);
+    // Values Min .. Max, both inclusive.
+    uint32_t AddIntRange(std::wstring_view Name, int32_t Min, int32_t Max);
+
+    // Returns false for combinations the shader does not support. Those are never compiled.
+    void SetFilter(FFilter InFilter) { Filter = std::move(InFilter); }
+
+    // Values holds one value per dimension, in the order the dimensions were added.
+    uint32_t GetKey(std::span<const int32_t> Values) const;
+    int32_t GetValue(uint32_t Key, uint32_t Dimension) const;
+    std::vector<int32_t> GetValues(uint32_t Key) const;
+
+    bool IsValid(uint32_t Key) const;
+    std::vector<uint32_t> GetValidKeys() const;
+    uint32_t GetNumPermutations() const { return NumPermutations; }
+    uint32_t GetNumDimensions() const { return static_cast<uint32_t>(Dimensions.size()); }
+
+    std::vector<std::wstring> GetDefines(uint32_t Key) const;
+
+private:
+    struct FDimension
+    {
+        std::wstring Name;
+        int32_t Min;
+        uint32_t NumValues;
+        // Product of NumValues of every dimension added before this one.
+        uint32_t Stride;
+    };
+
+    uint32_t AddDimension(std::wstring_view Name, int32_t Min, uint32_t NumValues);
+
+    std::vector<FDimension> Dimensions;
+    uint32_t NumPermutations = 1u;
+    FFilter Filter;
+};
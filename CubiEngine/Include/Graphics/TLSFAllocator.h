@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <vector>
+
+// Two level segregated fit allocator over a range of abstract units (vertices, indices, bytes), no memory of its
+// own. Free blocks are binned by size class : the first level is the power of two, the second level splits it in
+// SL_COUNT linear steps. Two bitmaps find a free block that is large enough in constant time, freeing merges
+// with the physical neighbours in constant time.
+class FTLSFAllocator
+{
+public:
+    static constexpr uint32_t INVALID_NODE = ~0u;
+
+    // Node identifies the allocation for Free. It stays the same across Compact, the offset does not.
+    struct FAllocation
+    {
+        uint32_t Node{ INVALID_NODE };
+        uint32_t Offset{};
+        uint32_t Size{};
+    };
+
+    // One live allocation moved by Compact. Moves come in ascending offsets with NewOffset <= OldOffset, so
+    // applying them in order is safe even in place.
+    struct FMove
+    {
+        uint32_t Node;
+        uint32_t OldOffset;
+        uint32_t NewOffset;
+        uint32_t Size;
+    };
+
+    explicit FTLSFAllocator(uint32_t InCapacity);
+
+    // nullopt if no free block can hold Size units.
+    std::optional<FAllocation> Allocate(uint32_t Size);
+    void Free(uint32_t Node);
+
+    // Appends NewCapacity - Capacity units of free space at the end.
+    void Grow(uint32_t NewCapacity);
+
+    // Packs every allocation to the front, leaving a single free block at the end.
+    std::vector<FMove> Compact();
+
+    uint32_t GetOffset(uint32_t Node) const { return Nodes[Node].Offset; }
+    uint32_t GetCapacity() const { return Capacity; }
+    uint32_t GetUsedSize() const { return UsedSize; }
+    uint32_t GetNumAllocations() const { return NumAllocations; }
+    uint32_t GetLargestFreeBlock() const;
+    // 0 when all free space is one block, approaches 1 as it splinters.
+    float GetFragmentation() const;
+
+private:
+    static constexpr uint32_t SL_LOG2 = 4u;
+    static constexpr uint32_t SL_COUNT = 1u << SL_LOG2;
+    static constexpr uint32_t FL_COUNT = 32u - SL_LOG2 + 1u;
+
+    struct FNode
+    {
+        uint32_t Offset = 0u;
+        uint32_t Size = 0u;
+        uint32_t PrevPhysical = INVALID_NODE;
+        uint32_t NextPhysical = INVALID_NODE;
+        // Links in the free list of the size class, or in UnusedNodes for recycled nodes.
+        uint32_t PrevFree = INVALID_NODE;
+        uint32_t NextFree = INVALID_NODE;
+        bool bFree = false;
+    };
+
+    // Size class that contains Size.
+    static void MapInsert(uint32_t Size, uint32_t& Fl, uint32_t& Sl);
+    // Smallest size class whose blocks are all at least Size.
+    static void MapSearch(uint32_t Size, uint32_t& Fl, uint32_t& Sl);
+
+    // Good fit in constant time, falls back to a scan of Size's own class. INVALID_NODE if nothing fits.
+    uint32_t FindFreeBlock(uint32_t Size) const;
+
+    uint32_t CreateNode(uint32_t Offset, uint32_t Size);
+    void ReleaseNode(uint32_t Node);
+    void InsertFreeBlock(uint32_t Node);
+    void RemoveFreeBlock(uint32_t Node);
+    // Links Node in after Prev, or first if Prev is INVALID_NODE.
+    void LinkPhysical(uint32_t Prev, uint32_t Node);
+    void UnlinkPhysical(uint32_t Node);
+
+    std::vector<FNode> Nodes;
+    uint32_t UnusedNodes = INVALID_NODE;
+
+    uint32_t FlBitmap = 0u;
+    std::array<uint32_t, FL_COUNT> SlBitmaps{};
+    std::array<std::array<uint32_t, SL_COUNT>, FL_COUNT> FreeLists{};
+
+    uint32_t FirstNode = INVALID_NODE;
+    uint32_t LastNode = INVALID_NODE;
+
+    uint32_t Capacity = 0u;
+    uint32_t UsedSize = 0u;
+    uint32_t NumAllocations = 0u;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Graphics/Resource.h"
+
+// A resource living for part of a frame : its memory requirements and the first and last pass using it, inclusive.
+struct FTransientResourceDesc
+{
+    uint64_t Size{};
+    // Power of two.
+    uint64_t Alignment{};
+    uint32_t FirstPass{};
+    uint32_t LastPass{};
+    // Only resources of the same category share a heap. On resource heap tier 1 render targets and depth buffers
+    // cannot go in the heap of other textures.
+    uint32_t HeapCategory{};
+};
+
+struct FTransientPlacement
+{
+    uint32_t Heap = INVALID_INDEX_U32;
+    uint64_t Offset{};
+};
+
+struct FTransientHeapDesc
+{
+    uint64_t Size{};
+    uint64_t Alignment{};
+    uint32_t HeapCategory{};
+};
+
+// Issued before Pass, makes ResourceAfter the resource its memory belongs to.
+struct FTransientAliasingBarrier
+{
+    uint32_t Pass{};
+    // INVALID_INDEX_U32 when the memory had more than one owner before, or only belonged to resources of the
+    // previous frame : the barrier then has no resource before, which covers any of them.
+    uint32_t ResourceBefore = INVALID_INDEX_U32;
+    uint32_t ResourceAfter{};
+
+    bool operator==(const FTransientAliasingBarrier&) const = default;
+};
+
+struct FTransientAliasingPlan
+{
+    // One per resource, in the order they were given.
+    std::vector<FTransientPlacement> Placements;
+    std::vector<FTransientHeapDesc> Heaps;
+    // Sorted by pass, then by resource after. A resource sharing its memory with no other needs none.
+    std::vector<FTransientAliasingBarrier> Barriers;
+
+    uint64_t HeapBytes{};
+    // What the resources would take with memory of their own.
+    uint64_t UnaliasedBytes{};
+};
+
+// Packs resources into one heap per category, no device involved. Two resources whose lifetimes overlap never
+// share memory, two that do not may. This colours the interval graph of the lifetimes with memory ranges instead
+// of whole heaps : resources go largest first, each one to the lowest offset where it fits around the resources
+// already placed that are alive at the same time, and the heap is as large as the highest range it ends up with.
+FTransientAliasingPlan PlanTransientAliasing(std::span<const FTransientResourceDesc> Resources,
+    uint64_t MinHeapAlignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <deque>
+#include <optional>
+#include "Graphics/Resource.h"
+
+class FMemoryAllocator;
+
+// Bookkeeping of a ring of upload memory, no device involved. Allocations made since the last CloseBatch form
+// the open batch, CloseBatch tags them with the fence value of the submission that reads them, and Retire hands
+// every batch whose fence completed back to the ring. Batches retire in order, so the ring only ever frees at
+// the tail. Drive Retire with FFakeFence::GetCompletedValue to exercise it without a GPU.
+class FUploadRingAllocator
+{
+public:
+    explicit FUploadRingAllocator(uint64_t InCapacity);
+
+    // Offset of Size bytes aligned to Alignment (a power of two), nullopt if the free space cannot hold them.
+    // Wrapping around skips the end of the ring, the skipped bytes retire with the allocation.
+    std::optional<uint64_t> Allocate(uint64_t Size, uint64_t Alignment);
+
+    // No-op if nothing was allocated since the last call.
+    void CloseBatch(uint64_t FenceValue);
+    void Retire(uint64_t CompletedFenceValue);
+
+    bool HasPendingBatches() const { return !Batches.empty(); }
+    // Fence value to wait on to get space back, only valid with pending batches.
+    uint64_t GetOldestPendingFenceValue() const { return Batches.front().FenceValue; }
+
+    uint64_t GetCapacity() const { return Capacity; }
+    // Includes padding and the open batch.
+    uint64_t GetUsedBytes() const { return UsedBytes; }
+
+private:
+    struct FBatch
+    {
+        uint64_t FenceValue;
+        // Head once the batch closed, the tail moves here when it retires.
+        uint64_t End;
+        uint64_t NumBytes;
+    };
+
+    uint64_t Capacity;
+    uint64_t Head = 0u;
+    uint64_t Tail = 0u;
+    uint64_t UsedBytes = 0u;
+    uint64_t OpenBatchBytes = 0u;
+    std::deque<FBatch> Batches;
+};
+
+// Where an upload writes its data and where the copy reads it from. CpuAddress points at Offset.
+struct FUploadRegion
+{
+    ID3D12Resource* Resource{};
+    uint64_t Offset{};
+    uint8_t* CpuAddress{};
+};
+
+// One persistently mapped upload buffer carved up by an FUploadRingAllocator.
+class FUploadRing
+{
+public:
+    FUploadRing(FMemoryAllocator& MemoryAllocator, uint64_t Capacity);
+
+    std::optional<FUploadRegion> Allocate(uint64_t Size, uint64_t Alignment);
+
+    FUploadRingAllocator& GetAllocator() { return Allocator; }
+    ID3D12Resource* GetResource() const { return Allocation.Resource.Get(); }
+
+private:
+    FAllocation Allocation{};
+    uint8_t* MappedData{};
+    FUploadRingAllocator Allocator;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cfloat>
+
+struct FAABB
+{
+    XMFLOAT3 Min{ FLT_MAX, FLT_MAX, FLT_MAX };
+    XMFLOAT3 Max{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+    bool IsValid() const { return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z; }
+    void Expand(const XMFLOAT3& Point);
+    void Expand(const FAABB& Other);
+    FAABB Transform(const XMMATRIX& Matrix) const;
+    bool Intersects(const FAABB& Other) const;
+};
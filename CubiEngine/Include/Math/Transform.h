@@ -8,9 +8,12 @@ public:
 	FTransform Multiply(const FTransform& Other) const;
 
 	XMMATRIX GetModelMatrix() const { return TransformMatrix; }
-	XMMATRIX GetInverseModelMatrix() const { return InverseTransformMatrix; }
+	XMMATRIX GetInverseModelMatrix() const;
 
 private:
     XMMATRIX TransformMatrix{ Dx::XMMatrixIdentity() };
-	XMMATRIX InverseTransformMatrix{ Dx::XMMatrixIdentity() };
+
+	// Inverted on demand, most transforms are never asked for it.
+	mutable XMMATRIX InverseTransformMatrix{ Dx::XMMatrixIdentity() };
+	mutable bool bInverseDirty = false;
 };
@@ -13,6 +13,7 @@ public:
     FBloomPass(const uint32_t Width, const uint32_t Height);
 
     void InitSizeDependantResource(uint32_t InWidth, uint32_t InHeight) override;
+    bool IsReady() const override { return GaussianBlurPipelineState.IsReady() && DownSamplePipelineState.IsReady(); }
 
     void AddBloomPass(FGraphicsContext* GraphicsContext, FScene* Scene, FTexture* HDR);
     void DownSampleSceneTexture(FGraphicsContext* GraphicsContext, FTexture* HDR);
@@ -22,8 +22,10 @@ public:
 
 private:
     FPipelineState GeometryPassPipelineState;
+    FPipelineState GeometryPassIndirectPipelineState;
     FPipelineState GeometryPassLightPipelineState;
 
-    FPipelineState LightPassPipelineState;
+    // Specialized on shadow method, SSAO and diffuse BRDF.
+    FPipelineStatePermutations LightPassPipelineStates;
 
 };
\ No newline at end of file
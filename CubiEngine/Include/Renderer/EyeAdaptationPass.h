@@ -20,7 +20,8 @@ public:
 private:
     FPipelineState GenerateHistogramPipelineState;
     FPipelineState CalcuateAverageLuminancePipelineState;
-    FPipelineState EyeAdaptationTonemappingPipelineState;
+    // Specialized on tone mapping method, gamma correction, bloom and eye adaptation.
+    FPipelineStatePermutations EyeAdaptationTonemappingPipelineStates;
 
     FBuffer HistogramBuffer;
     FBuffer AverageLuminanceBuffer;
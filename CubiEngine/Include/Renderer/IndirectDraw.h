@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Graphics/Resource.h"
+
+class FGraphicsContext;
+
+// One record of the indirect argument buffer. The layout has to match GetCommandSignatureArguments().
+struct FIndirectDrawArguments
+{
+    D3D12_INDEX_BUFFER_VIEW IndexBufferView;
+    uint32_t InstanceIndex;
+    D3D12_DRAW_INDEXED_ARGUMENTS DrawIndexedArguments;
+};
+
+struct FIndirectDrawItem
+{
+    D3D12_GPU_VIRTUAL_ADDRESS IndexBufferAddress;
+    uint32_t IndexBufferSizeInBytes;
+    uint32_t IndexCount;
+    uint32_t FirstIndex;
+};
+
+// Builds compacted indirect argument records on the CPU.
+// Does not touch the device, so it can be driven from tests or tools.
+class FIndirectDrawArgumentBuilder
+{
+public:
+    static constexpr uint32_t NUM_COMMAND_SIGNATURE_ARGUMENTS = 3u;
+    static std::array<D3D12_INDIRECT_ARGUMENT_DESC, NUM_COMMAND_SIGNATURE_ARGUMENTS> GetCommandSignatureArguments();
+
+    // Items are indexed by instance index. Only VisibleInstances are emitted, in the given order,
+    // and items without indices are dropped so the argument buffer stays dense.
+    void Build(std::span<const FIndirectDrawItem> Items, std::span<const uint32_t> VisibleInstances);
+
+    const std::vector<FIndirectDrawArguments>& GetArguments() const { return Arguments; }
+    uint32_t GetNumDraws() const { return static_cast<uint32_t>(Arguments.size()); }
+
+private:
+    std::vector<FIndirectDrawArguments> Arguments;
+};
+
+// Per frame argument buffer in upload memory, read by ExecuteIndirect in place.
+class FIndirectDrawBuffer
+{
+public:
+    explicit FIndirectDrawBuffer(std::wstring_view Name) : Name(Name) {}
+
+    void Upload(const FIndirectDrawArgumentBuilder& Builder);
+    void Execute(FGraphicsContext* const GraphicsContext) const;
+
+    uint32_t GetNumDraws() const { return NumDraws; }
+
+private:
+    static ID3D12CommandSignature* GetCommandSignature();
+
+    std::wstring Name;
+    std::array<FBuffer, FRAMES_IN_FLIGHT> ArgumentBuffers{};
+    uint32_t NumDraws = 0u;
+};
@@ -18,7 +18,8 @@ public:
 
     void DebugVisualize(FGraphicsContext* const GraphicsContext, FScene* Scene, FTexture* SrcTexture, FTexture* TargetTexture, uint32_t Width, uint32_t Height);
 
-    FPipelineState TonemappingPipelineState;
+    // Specialized on tone mapping method and gamma correction.
+    FPipelineStatePermutations TonemappingPipelineStates;
 
     FPipelineState DebugVisualizePipeline;
     FPipelineState DebugVisualizeDepthPipeline;
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+#include "Graphics/Resource.h"
+
+class FGraphicsContext;
+
+enum ERenderGraphPassFlags : uint32_t
+{
+    RenderGraphPassFlag_None = 0u,
+    // Kept even when nothing reads what it writes, for passes with side effects the graph does not see.
+    RenderGraphPassFlag_NeverCull = 1u << 0,
+    // Runs on the async compute queue, overlapping the graphics passes it does not depend on. The pass only records
+    // compute work and only declares states a compute queue can use.
+    RenderGraphPassFlag_AsyncCompute = 1u << 1,
+};
+
+enum class ERGQueue : uint8_t
+{
+    Graphics,
+    AsyncCompute,
+    Count,
+};
+
+struct FRGTextureHandle
+{
+    uint32_t Index = INVALID_INDEX_U32;
+
+    bool IsValid() const { return Index != INVALID_INDEX_U32; }
+    bool operator==(const FRGTextureHandle&) const = default;
+};
+
+// What a pass does with a texture. Reads in the same read-only state family merge, so consecutive readers
+// share a single transition.
+struct FRGTextureAccess
+{
+    FRGTextureHandle Texture{};
+    D3D12_RESOURCE_STATES State{};
+    bool bWrite = false;
+};
+
+inline FRGTextureAccess RGRead(FRGTextureHandle Texture, D3D12_RESOURCE_STATES State)
+{
+    return FRGTextureAccess{ .Texture = Texture, .State = State, .bWrite = false };
+}
+
+inline FRGTextureAccess RGWrite(FRGTextureHandle Texture, D3D12_RESOURCE_STATES State)
+{
+    return FRGTextureAccess{ .Texture = Texture, .State = State, .bWrite = true };
+}
+
+enum class ERGBarrierType : uint8_t
+{
+    Transition,
+    UAV,
+};
+
+struct FRGBarrier
+{
+    FRGTextureHandle Texture{};
+    ERGBarrierType Type = ERGBarrierType::Transition;
+    D3D12_RESOURCE_STATES StateBefore{};
+    D3D12_RESOURCE_STATES StateAfter{};
+
+    bool operator==(const FRGBarrier&) const = default;
+};
+
+// First and last position in the execution order a texture is used at.
+// Before the pass at Position runs on Queue, Queue waits for SignalQueue to finish everything up to and including
+// the pass at SignalPosition. Position is the number of live passes for the wait before the final barriers, and
+// SignalPosition is INVALID_INDEX_U32 for the graphics work recorded before the graph.
+struct FRGQueueWait
+{
+    ERGQueue Queue = ERGQueue::Graphics;
+    uint32_t Position{};
+    ERGQueue SignalQueue = ERGQueue::Graphics;
+    uint32_t SignalPosition{};
+
+    bool operator==(const FRGQueueWait&) const = default;
+};
+
+struct FRGLifetime
+{
+    uint32_t FirstPass = INVALID_INDEX_U32;
+    uint32_t LastPass = INVALID_INDEX_U32;
+};
+
+struct FRenderGraphStats
+{
+    uint32_t NumPasses{};
+    uint32_t NumCulledPasses{};
+    uint32_t NumBarriers{};
+    // Transient textures some live pass uses, and the pooled textures backing them.
+    uint32_t NumTransientTextures{};
+    uint32_t NumPhysicalTextures{};
+    uint32_t NumAsyncComputePasses{};
+    uint32_t NumQueueWaits{};
+};
+
+class FRenderGraphTexturePool;
+
+// A frame described as passes declaring what they read and write. Compile is CPU only : it culls passes nothing
+// depends on, derives the dependencies, plans the barriers in one batch per pass and assigns the transient
+// textures to physical ones, so it can be driven from tests. Realize and Execute then run the frame on a context.
+//
+// Passes run in the order they were added. Every dependency points from an earlier pass to a later one, so that
+// order is a topological order of the graph already, culling only takes passes out of it.
+//
+// Async compute passes keep that order among themselves on their own queue. Compile turns the dependencies crossing
+// queues into the fewest waits that cover them : each pass waits right before it runs, once per other queue, and
+// not at all when an earlier wait already covers it. Transitions the compute queue cannot make move to the graphics
+// queue, after the last pass using the texture before.
+class FRenderGraph
+{
+public:
+    using FExecuteFunction = std::function<void(FGraphicsContext* GraphicsContext)>;
+
+    // Transient texture, backed by a pooled texture for the length of the frame. Starts with undefined contents.
+    FRGTextureHandle CreateTexture(const FTextureCreationDesc& Desc);
+    // Texture owned outside the graph, its current state is where the graph starts from.
+    FRGTextureHandle ImportTexture(FTexture* Texture);
+    // Keeps the passes writing Texture alive. FinalState, when given, is the state the texture is left in.
+    void ExportTexture(FRGTextureHandle Texture, std::optional<D3D12_RESOURCE_STATES> FinalState = std::nullopt);
+
+    // A texture may appear once per pass.
+    uint32_t AddPass(std::string_view Name, std::vector<FRGTextureAccess> Accesses, FExecuteFunction Execute,
+        uint32_t Flags = RenderGraphPassFlag_None);
+
+    void Compile();
+
+    uint32_t GetNumPasses() const { return static_cast<uint32_t>(Passes.size()); }
+    const std::string& GetPassName(uint32_t Pass) const { return Passes[Pass].Name; }
+    bool IsPassCulled(uint32_t Pass) const { return Passes[Pass].bCulled; }
+    // Passes left after culling, in execution order.
+    std::span<const uint32_t> GetExecutionOrder() const { return ExecutionOrder; }
+    // Earlier live passes Pass has to wait for, sorted.
+    std::span<const uint32_t> GetDependencies(uint32_t Pass) const { return Passes[Pass].Dependencies; }
+    ERGQueue GetPassQueue(uint32_t Pass) const { return Passes[Pass].Queue; }
+    // Issued together before Pass runs, on its queue.
+    std::span<const FRGBarrier> GetBarriers(uint32_t Pass) const { return Passes[Pass].Barriers; }
+    // Issued on the graphics queue after Pass runs, for an async compute pass using the texture next.
+    std::span<const FRGBarrier> GetPostBarriers(uint32_t Pass) const { return Passes[Pass].PostBarriers; }
+    // Issued on the graphics queue before the first pass, for async compute passes using a texture first.
+    std::span<const FRGBarrier> GetPrologueBarriers() const { return PrologueBarriers; }
+    // Sorted by position, then by queue.
+    std::span<const FRGQueueWait> GetQueueWaits() const { return QueueWaits; }
+    // Issued after the last pass, moves exported textures to their final state.
+    std::span<const FRGBarrier> GetFinalBarriers() const { return FinalBarriers; }
+
+    FRGLifetime GetLifetime(FRGTextureHandle Texture) const { return Textures[Texture.Index].Lifetime; }
+    // Imported textures always have one, INVALID_INDEX_U32 for a transient texture no live pass uses.
+    uint32_t GetPhysicalTexture(FRGTextureHandle Texture) const { return Textures[Texture.Index].PhysicalTexture; }
+    uint32_t GetNumPhysicalTextures() const { return static_cast<uint32_t>(PhysicalTextures.size()); }
+    const FRenderGraphStats& GetStats() const { return Stats; }
+
+    // Backs every physical texture, imported ones by their texture and transient ones from the pool, where physical
+    // textures used at different times share memory.
+    void Realize(FRenderGraphTexturePool& Pool);
+    void Execute(FGraphicsContext* GraphicsContext);
+
+    // Valid between Realize and the end of the frame.
+    FTexture* GetTexture(FRGTextureHandle Texture) const;
+
+private:
+    struct FTextureEntry
+    {
+        FTextureCreationDesc Desc{};
+        FTexture* ImportedTexture = nullptr;
+        bool bExported = false;
+        std::optional<D3D12_RESOURCE_STATES> FinalState{};
+
+        FRGLifetime Lifetime{};
+        uint32_t PhysicalTexture = INVALID_INDEX_U32;
+    };
+
+    struct FPass
+    {
+        std::string Name;
+        std::vector<FRGTextureAccess> Accesses;
+        FExecuteFunction Execute;
+        uint32_t Flags = RenderGraphPassFlag_None;
+        ERGQueue Queue = ERGQueue::Graphics;
+
+        bool bCulled = false;
+        std::vector<uint32_t> Dependencies;
+        std::vector<FRGBarrier> Barriers;
+        std::vector<FRGBarrier> PostBarriers;
+        // Passes on other queues that have to be done with a texture before this pass uses it in the state their
+        // barriers left it in, or before this pass's barriers change that state.
+        std::vector<uint32_t> StateDependencies;
+    };
+
+    struct FPhysicalTexture
+    {
+        // Transient textures sharing this one, by first use.
+        std::vector<uint32_t> Textures;
+        bool bImported = false;
+        D3D12_RESOURCE_STATES InitialState{};
+        FTexture* Texture = nullptr;
+    };
+
+    // A physical texture taking its memory over from others before the pass at Position runs.
+    struct FAliasingActivation
+    {
+        uint32_t Position{};
+        uint32_t PhysicalTexture{};
+        FTexture* Before = nullptr;
+        // Render targets and depth buffers are discarded after the barrier, their memory holds another texture.
+        bool bDiscard = false;
+    };
+
+    void CullPasses();
+    void BuildDependencies();
+    void AssignPhysicalTextures();
+    void PlanBarriers();
+    void PlanQueueWaits();
+
+    std::vector<FTextureEntry> Textures;
+    std::vector<FPass> Passes;
+
+    std::vector<uint32_t> ExecutionOrder;
+    std::vector<FPhysicalTexture> PhysicalTextures;
+    std::vector<FRGBarrier> FinalBarriers;
+    std::vector<FRGBarrier> PrologueBarriers;
+    std::vector<FRGQueueWait> QueueWaits;
+    // Sorted by position.
+    std::vector<FAliasingActivation> AliasingActivations;
+
+    FRenderGraphStats Stats{};
+    bool bCompiled = false;
+};
+
+// A physical transient texture of a frame and the positions in the execution order it is used between.
+struct FRGTransientTextureRequest
+{
+    FTextureCreationDesc Desc{};
+    uint32_t FirstPass{};
+    uint32_t LastPass{};
+};
+
+// Textures backing transient render graph textures, placed in heaps they share with the textures of the same frame
+// they are never alive together with, as laid out by PlanTransientAliasing. A layout is handed out once per frame
+// and kept for the next frames asking for the same textures with the same lifetimes, so a steady frame creates
+// nothing. Textures keep the name of the first resource they were created for.
+class FRenderGraphTexturePool
+{
+public:
+    struct FAliasingBarrier
+    {
+        uint32_t Pass{};
+        // Null when the memory did not belong to a single texture before.
+        FTexture* Before = nullptr;
+        // Index in the requests.
+        uint32_t After{};
+    };
+
+    struct FLayout
+    {
+        // One per request, in the same order.
+        std::vector<FTexture*> Textures;
+        // Sorted by pass.
+        std::vector<FAliasingBarrier> AliasingBarriers;
+        uint64_t HeapBytes{};
+        uint64_t UnaliasedBytes{};
+    };
+
+    const FLayout& Acquire(std::span<const FRGTransientTextureRequest> Requests);
+
+    // Releases layouts no frame acquired for IdleFrames frames. The caller makes sure the GPU is done with
+    // frames that old.
+    bool ReleaseIfIdle(uint32_t IdleFrames);
+    void ReleaseAll();
+
+    uint32_t GetNumLayouts() const { return static_cast<uint32_t>(Layouts.size()); }
+
+private:
+    struct FPooledLayout
+    {
+        std::vector<FRGTransientTextureRequest> Requests;
+        // Before the textures, which go first.
+        std::vector<wrl::ComPtr<D3D12MA::Allocation>> Heaps;
+        std::vector<std::unique_ptr<FTexture>> Textures;
+        FLayout Layout;
+        uint32_t LastUsedFrame = 0u;
+    };
+
+    std::unique_ptr<FPooledLayout> CreateLayout(std::span<const FRGTransientTextureRequest> Requests) const;
+
+    // Pointers, a layout handed out stays where it is when another one is created.
+    std::vector<std::unique_ptr<FPooledLayout>> Layouts;
+};
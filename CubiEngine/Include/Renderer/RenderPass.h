@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+
 class FScene;
 
 class FRenderPass
@@ -12,7 +14,57 @@ public:
     void OnWindowResized(uint32_t InWidth, uint32_t InHeight);
     virtual void InitSizeDependantResource(uint32_t InWidth, uint32_t InHeight) = 0;
 
+    // False while pipelines of the pass are still compiling. Optional passes are skipped until then,
+    // everything else waits on its pipelines when first rendered.
+    virtual bool IsReady() const { return true; }
+
 protected:
     uint32_t Width;
     uint32_t Height;
+};
+
+// Owns a pass that is only constructed the first time a frame uses it, so modes and settings that are never
+// turned on cost neither startup time nor memory. A pass that went unused for a while can be released again.
+class FLazyRenderPass
+{
+public:
+    using FFactory = std::function<std::unique_ptr<FRenderPass>(uint32_t Width, uint32_t Height)>;
+
+    FLazyRenderPass(std::string_view InName, FFactory InFactory);
+    virtual ~FLazyRenderPass() = default;
+
+    // Creates the pass on first use and marks it used this frame.
+    FRenderPass* Get();
+
+    bool IsCreated() const { return Pass != nullptr; }
+    const std::string& GetName() const { return Name; }
+
+    // Size the pass is created with, resizes it if it already exists.
+    void SetSize(uint32_t InWidth, uint32_t InHeight);
+
+    // Releases the pass if no frame used it for IdleFrames frames. The caller makes sure the GPU is done with
+    // frames that old.
+    bool ReleaseIfIdle(uint32_t IdleFrames);
+
+private:
+    std::string Name;
+    FFactory Factory;
+    std::unique_ptr<FRenderPass> Pass;
+
+    uint32_t LastUsedFrame = 0u;
+    uint32_t Width = 0u;
+    uint32_t Height = 0u;
+};
+
+template<typename T>
+class TLazyRenderPass : public FLazyRenderPass
+{
+public:
+    explicit TLazyRenderPass(std::string_view InName)
+        : FLazyRenderPass(InName, [](uint32_t Width, uint32_t Height) { return std::make_unique<T>(Width, Height); })
+    {
+    }
+
+    T* Get() { return static_cast<T*>(FLazyRenderPass::Get()); }
+    T* operator->() { return Get(); }
 };
\ No newline at end of file
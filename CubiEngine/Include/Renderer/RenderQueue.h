@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ShaderInterlop/RenderResources.hlsli"
+
+class FMesh;
+class FGraphicsContext;
+
+struct FDrawCommand
+{
+    uint64_t SortKey;
+    const FMesh* Mesh;
+    uint32_t InstanceIndex;
+};
+
+struct FRenderQueueStats
+{
+    uint32_t NumDraws = 0u;
+    uint32_t NumIndexBufferBindsSkipped = 0u;
+    uint32_t NumTransformUpdatesSkipped = 0u;
+    uint32_t NumGeometryUpdatesSkipped = 0u;
+    uint32_t NumMaterialUpdatesSkipped = 0u;
+    // Radix passes where every key had the same digit, out of 8.
+    uint32_t NumSortPassesSkipped = 0u;
+};
+
+// Collects draws for a pass, orders them by a 64 bit sort key and submits them
+// while skipping state that did not change since the previous draw.
+//
+// Sort key layout (msb -> lsb) :
+// [63:60] pipeline | [59:56] coarse depth bucket | [55:42] material | [41:28] geometry | [27:0] view depth (front to back)
+//
+// Buckets double in size with distance, so near occluders still go first and early z culls most of what is behind them,
+// while draws inside a bucket batch by material. Material above all depth would shade hidden pixels, depth above all
+// material would rebind state on almost every draw.
+class FRenderQueue
+{
+public:
+    static constexpr uint32_t PIPELINE_BITS = 4u;
+    static constexpr uint32_t DEPTH_BUCKET_BITS = 4u;
+    static constexpr uint32_t MATERIAL_BITS = 14u;
+    static constexpr uint32_t GEOMETRY_BITS = 14u;
+
+    static uint64_t MakeSortKey(uint32_t PipelineId, uint32_t MaterialId, uint32_t GeometryId, float ViewDepth);
+
+    // Clears the draws and the stats.
+    void Reset();
+    void Add(const FMesh* Mesh, uint64_t SortKey, uint32_t InstanceIndex) { DrawCommands.push_back({ SortKey, Mesh, InstanceIndex }); }
+    void Sort();
+
+    void Submit(FGraphicsContext* const GraphicsContext, interlop::DeferredGPassRenderResources& RenderResources);
+
+    size_t GetNumDraws() const { return DrawCommands.size(); }
+    const std::vector<FDrawCommand>& GetDrawCommands() const { return DrawCommands; }
+    const FRenderQueueStats& GetStats() const { return Stats; }
+
+private:
+    std::vector<FDrawCommand> DrawCommands;
+    std::vector<FDrawCommand> SortScratch;
+    FRenderQueueStats Stats{};
+};
@@ -14,58 +14,95 @@
 #include "Renderer/RaytracingShadowPass.h"
 #include "Renderer/PathTracing.h"
 #include "Renderer/DenoisePass.h"
+#include "Renderer/RenderGraph.h"
+#include "Core/FramePipeline.h"
 
 class FInput;
 class FEditor;
+class FCommandCapture;
 struct SDL_Window;
 
-class FRenderer
+// The scene textures of a frame in its render graph. Depth buffers are imported, the rest is transient.
+struct FSceneTextureHandles
+{
+    FRGTextureHandle GBufferA;
+    FRGTextureHandle GBufferB;
+    FRGTextureHandle GBufferC;
+    FRGTextureHandle Velocity;
+
+    FRGTextureHandle Depth;
+    FRGTextureHandle PrevDepth;
+
+    FRGTextureHandle HDR;
+    FRGTextureHandle LDR;
+};
+
+class FRenderer : public FFrameRenderer
 {
 public:
     FRenderer(SDL_Window* Window, uint32_t Width, uint32_t Height);
     ~FRenderer();
 
     void Cleanup();
-    void GameTick(float DeltaTime, FInput* Input);
+    // Game thread.
+    void GameTick(float DeltaTime, FInput* Input, FFrameSnapshot& Snapshot);
+
+    // Render thread.
+    void RenderFrame(const FFrameSnapshot& Snapshot) override;
+    void FlushFrames() override;
+
     void BeginFrame(FGraphicsContext* GraphicsContext,FTexture* BackBuffer);
-    void CopyHistoricalTexture(FGraphicsContext* GraphicsContext);
     void Render();
+    void SaveFrameCapture(const FCommandCapture& FrameCapture) const;
     FTexture* RenderDeferredShading(FGraphicsContext* GraphicsContext);
     FTexture* RenderDebugRaytracingScene(FGraphicsContext* GraphicsContext);
     FTexture* RenderPathTracingScene(FGraphicsContext* GraphicsContext);
 
-    void RenderShadow(FGraphicsContext* GraphicsContext, FSceneTexture& SceneTexture);
+    FSceneTextureHandles AddSceneTextures(FRenderGraph& Graph);
+    void BindSceneTextures(const FRenderGraph& Graph, const FSceneTextureHandles& Textures);
 
     void OnWindowResized(uint32_t InWidth, uint32_t InHeight);
+    void ReleaseIdleRenderPasses();
+    std::vector<std::string> GetCreatedRenderPassNames() const;
+
+    FScene* GetScene() const { return Scene.get(); }
     void InitSizeDependantResource(uint32_t InWidth, uint32_t InHeight);
     void InitializeSceneTexture(uint32_t InWidth, uint32_t InHeight);
 
 private:
     FSceneTexture SceneTexture;
 
+    // Kept across frames, the previous depth is read by the next frame.
+    std::unique_ptr<FTexture> DepthTexture;
+    std::unique_ptr<FTexture> PrevDepthTexture;
+
+    FRenderGraphTexturePool TransientTexturePool;
+
     uint32_t Width{};
     uint32_t Height{};
 
     std::unique_ptr<FScene> Scene;
-    std::unique_ptr<FDeferredGPass> DeferredGPass;
-    std::unique_ptr<FDebugPass> DebugPass;
-    std::unique_ptr<FTemporalAAPass> TemporalAA;
-    std::unique_ptr<FPostProcess> PostProcess;
 
-    std::unique_ptr<FShadowDepthPass> ShadowDepthPass;
-    std::unique_ptr<FRaytracingShadowPass> RaytracingShadowPass;
+    // Created when a frame first needs them, see FLazyRenderPass.
+    TLazyRenderPass<FDeferredGPass> DeferredGPass{ "DeferredGPass" };
+    TLazyRenderPass<FDebugPass> DebugPass{ "DebugPass" };
+    TLazyRenderPass<FTemporalAAPass> TemporalAA{ "TemporalAA" };
+    TLazyRenderPass<FPostProcess> PostProcess{ "PostProcess" };
+
+    TLazyRenderPass<FShadowDepthPass> ShadowDepthPass{ "ShadowDepthPass" };
+    TLazyRenderPass<FRaytracingShadowPass> RaytracingShadowPass{ "RaytracingShadowPass" };
 
-    std::unique_ptr<FScreenSpaceGIPass> ScreenSpaceGI;
-    std::unique_ptr<FEyeAdaptationPass> EyeAdaptationPass;
-    std::unique_ptr<FBloomPass> BloomPass;
-    std::unique_ptr<FSSAOPass> SSAOPass;
+    TLazyRenderPass<FScreenSpaceGIPass> ScreenSpaceGI{ "ScreenSpaceGI" };
+    TLazyRenderPass<FEyeAdaptationPass> EyeAdaptationPass{ "EyeAdaptationPass" };
+    TLazyRenderPass<FBloomPass> BloomPass{ "BloomPass" };
+    TLazyRenderPass<FSSAOPass> SSAOPass{ "SSAOPass" };
 
-    std::unique_ptr<FRaytracingDebugScenePass> RaytracingDebugScenePass;
-    std::unique_ptr<FPathTracingPass> PathTracingPass;
+    TLazyRenderPass<FRaytracingDebugScenePass> RaytracingDebugScenePass{ "RaytracingDebugScenePass" };
+    TLazyRenderPass<FPathTracingPass> PathTracingPass{ "PathTracingPass" };
 
-    std::unique_ptr<FDenoisePass> DenoisePass;
+    TLazyRenderPass<FDenoisePass> DenoisePass{ "DenoisePass" };
 
     std::unique_ptr<FEditor> Editor;
 
-	std::vector<FRenderPass*> RenderPasses;
+	std::vector<FLazyRenderPass*> RenderPasses;
 };
\ No newline at end of file
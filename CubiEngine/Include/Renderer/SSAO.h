@@ -12,6 +12,7 @@ class FSSAOPass : public FRenderPass
 public:
     FSSAOPass(uint32_t Width, uint32_t Height);
     void InitSizeDependantResource(uint32_t InWidth, uint32_t InHeight) override;
+    bool IsReady() const override { return SSAOPipelineState.IsReady(); }
     
     void GenerateSSAOKernel();
     void AddSSAOPass(FGraphicsContext* GraphicsContext, FScene* Scene, FSceneTexture& SceneTexture);
@@ -12,12 +12,12 @@ class FScreenSpaceGIPass : public FRenderPass
 public:
     FScreenSpaceGIPass(uint32_t Width, uint32_t Height);
     void InitSizeDependantResource(uint32_t InWidth, uint32_t InHeight) override;
-    
-    void AddPass(FGraphicsContext* GraphicsContext, FScene* Scene, FSceneTexture& SceneTexture);
 
+    // Each step is its own render graph pass, Dst sizes the dispatch.
     void RaycastDiffuse(FGraphicsContext* const GraphicsContext, FScene* Scene, FSceneTexture& SceneTexture);
-    void Denoise(FGraphicsContext* const GraphicsContext, FScene* Scene, FSceneTexture& SceneTexture);
-    void DenoiseGaussianBlur(FGraphicsContext* const GraphicsContext, FScene* Scene, FSceneTexture& SceneTexture);
+    void DownSample(FGraphicsContext* const GraphicsContext, FTexture* Src, FTexture* Dst);
+    void GaussianBlur(FGraphicsContext* const GraphicsContext, FScene* Scene, FTexture* Src, FTexture* Dst, bool bHorizontal);
+    void UpSample(FGraphicsContext* const GraphicsContext, FTexture* Src, FTexture* Dst);
     void Resolve(FGraphicsContext* const GraphicsContext, FScene* Scene, FSceneTexture& SceneTexture);
     void UpdateHistory(FGraphicsContext* const GraphicsContext, FScene* Scene);
     void CompositionSSGI(FGraphicsContext* const GraphicsContext, FScene* Scene, FSceneTexture& SceneTexture);
@@ -27,8 +27,11 @@ private:
     std::unique_ptr<FTexture> MomentTexture;
 
     FPipelineState ShadowDepthPassPipelineState;
+    FPipelineState ShadowDepthPassIndirectPipelineState;
     FPipelineState VSMShadowDepthPassPipelineState;
     FPipelineState MomentPassPipelineState;
 
+    void RenderCascade(FGraphicsContext* GraphicsContext, FScene* Scene, int CascadeIndex);
+
     XMMATRIX ViewProjectionMatrix[4];
 };
\ No newline at end of file
@@ -7,7 +7,8 @@ class FCamera
 public:
     FCamera(uint32_t Width, uint32_t Height);
     
-    void Update(float DeltaTime, FInput* Input, uint32_t Width, uint32_t Height, bool bApplyTAAJitter, float CSMExponentialFactor);
+    // FrameIndex drives the TAA jitter sequence, it comes from the game thread rather than GFrameCount.
+    void Update(float DeltaTime, FInput* Input, uint32_t Width, uint32_t Height, bool bApplyTAAJitter, float CSMExponentialFactor, uint32_t FrameIndex);
     void UpdateMatrix(bool bApplyTAAJitter);
 
     void SetCamPosition(float X, float Y, float Z)
@@ -57,6 +58,7 @@ public:
 private:
     uint32_t Width;
     uint32_t Height;
+    uint32_t FrameIndex = 0u;
     float MovementSpeed{};
     float RotationSpeed{};
 
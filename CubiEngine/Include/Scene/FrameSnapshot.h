@@ -0,0 +1,51 @@
+#pragma once
+
+#include "ShaderInterlop/ConstantBuffers.hlsli"
+
+// Local TRS of the transform node the editor works on, the editor never reads the game thread hierarchy.
+struct FSelectedTransformSnapshot
+{
+    uint32_t MeshIndex = ~0u;
+    uint32_t Node = ~0u;
+    uint32_t Parent = ~0u;
+    XMFLOAT3 Translation{};
+    XMFLOAT4 Rotation{};
+    XMFLOAT3 Scale{};
+};
+
+// Everything the render thread needs from the game thread for one frame.
+// Written by FScene::CaptureFrameSnapshot on the game thread, read only once published to the render thread.
+struct FFrameSnapshot
+{
+    uint32_t FrameIndex = 0u;
+    float DeltaTime = 0.f;
+    float CPUFrameMsTime = 0.f;
+
+    interlop::SceneBuffer SceneBufferData{};
+    interlop::LightBuffer LightBufferData{};
+    interlop::ShadowBuffer ShadowBufferData{};
+
+    // Camera state read by passes and the editor outside of the scene buffer.
+    XMMATRIX InvViewProjectionMatrix{};
+    XMFLOAT3 CameraPosition{};
+    float CameraFovY = 0.f;
+    float CameraFarZ = 0.f;
+    bool bViewProjMatrixChanged = false;
+
+    // Meshes whose transform node moved this frame, with their new world matrix.
+    std::vector<uint32_t> MovedMeshes;
+    std::vector<Dx::XMFLOAT4X4> MovedMeshWorldMatrices;
+
+    FSelectedTransformSnapshot SelectedTransform{};
+
+    // Window events for the editor UI, which is built on the render thread.
+    std::vector<SDL_Event> UIEvents;
+    bool bShowEditor = true;
+
+    void Reset()
+    {
+        MovedMeshes.clear();
+        MovedMeshWorldMatrices.clear();
+        UIEvents.clear();
+    }
+};
@@ -6,6 +6,7 @@
 #include "ShaderInterlop/RenderResources.hlsli"
 #include "Scene/Mesh.h"
 #include "Math/Transform.h"
+#include "Scene/TransformHierarchy.h"
 
 
 class FGraphicsContext;
@@ -24,12 +25,16 @@ public:
     
     std::vector<std::unique_ptr<FMesh>> Meshes{};
 
+    // Node 0 is the model root, glTF nodes follow in breadth first order.
+    FTransformHierarchy TransformHierarchy;
+    std::vector<uint32_t> MeshTransformNodes{};
+
 private:
 	FModelCreationDesc ModelCreationDesc;
 
     void LoadSamplers(const tinygltf::Model& GLTFModel);
     void LoadMaterials(const tinygltf::Model& GLTFModel);
-    void LoadNode(uint32_t NodeIndex, const tinygltf::Model& GLTFModel, const FTransform& ParentTransform);
+    uint32_t LoadNode(uint32_t NodeIndex, const tinygltf::Model& GLTFModel, uint32_t ParentTransformNode);
     FSampler ResolveSampler(const tinygltf::Texture& Texture) const;
 
     FSampler DefaultSampler{};
@@ -13,4 +13,8 @@ public:
 
     interlop::LightBuffer LightBufferData;
     interlop::ShadowBuffer ShadowBufferData;
+
+private:
+    // Inputs of the last view space update, the positions are only recomputed when this changes.
+    uint64_t ViewUpdateHash = 0u;
 };
\ No newline at end of file
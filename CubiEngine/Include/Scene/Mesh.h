@@ -1,10 +1,12 @@
 #pragma once
 
+#include "Graphics/GeometryPool.h"
 #include "Graphics/Raytracing.h"
 #include "Graphics/Resource.h"
 #include "ShaderInterlop/RenderResources.hlsli"
 #include "ShaderInterlop/ConstantBuffers.hlsli"
 #include "Math/Transform.h"
+#include "Math/Bounds.h"
 
 class FPBRMaterial;
 class FGraphicsContext;
@@ -13,6 +15,11 @@ class FMesh
 {
 public:
     FMesh();
+    ~FMesh();
+
+    // Owns its range of the geometry pool.
+    FMesh(const FMesh&) = delete;
+    FMesh& operator=(const FMesh&) = delete;
 
     void Render(const FGraphicsContext* const GraphicsContext,
          interlop::UnlitPassRenderResources& UnlitRenderResources) const;
@@ -21,19 +28,32 @@ public:
     void Render(const FGraphicsContext* const GraphicsContext,
          interlop::ShadowDepthPassRenderResource& ShadowDepthPassRenderResource) const;
 
+    void SetTransformRenderResources(interlop::DeferredGPassRenderResources& DeferredGPassRenderResources) const;
+    void SetGeometryRenderResources(interlop::DeferredGPassRenderResources& DeferredGPassRenderResources) const;
+    void SetMaterialRenderResources(interlop::DeferredGPassRenderResources& DeferredGPassRenderResources) const;
+
+    interlop::InstanceData GetInstanceData() const;
+
+    // Uploads the geometry into the pool, replacing what the mesh had.
+    void SetGeometry(const FGeometryData& Data, std::wstring_view Name);
+    const FGeometryRange& GetGeometryRange() const;
+
     void GenerateRaytracingGeometry();
 
     void GatherRaytracingGeometry(std::vector<FRaytracingGeometryContext>& RaytracingGeometryContextList);
 
+    // Keep a CPU copy of the geometry for offline visibility baking.
+    void SetCPUGeometry(const std::vector<XMFLOAT3>& Positions, const std::vector<UINT>& Indices);
+    FAABB GetWorldBounds() const { return LocalBounds.Transform(GetModelMatrix()); }
+
 	XMMATRIX GetModelMatrix() const { return Transform.GetModelMatrix(); }
 	XMMATRIX GetInverseModelMatrix() const { return Transform.GetInverseModelMatrix(); }
 
-    FBuffer PositionBuffer{};
-    FBuffer TextureCoordsBuffer{};
-    FBuffer NormalBuffer{};
-    FBuffer TangentBuffer{};
-    FBuffer IndexBuffer{};
-    uint32_t IndicesCount{};
+    FGeometryHandle Geometry{};
+
+    std::vector<XMFLOAT3> CPUPositions{};
+    std::vector<UINT> CPUIndices{};
+    FAABB LocalBounds{};
     
     std::shared_ptr<FPBRMaterial> Material{};
 
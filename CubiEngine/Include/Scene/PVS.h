@@ -0,0 +1,75 @@
+#pragma once
+
+#include <span>
+#include "Math/Bounds.h"
+
+// Potentially visible set for static scenes.
+// Space is split into a uniform grid of cells, and each cell stores a zero run-length compressed bitset of visible meshes.
+// Baking only touches CPU side geometry, so it can run without a device or window.
+
+struct FPVSMeshGeometry
+{
+    // World space positions and triangle list indices.
+    std::vector<XMFLOAT3> Positions;
+    std::vector<uint32_t> Indices;
+    FAABB Bounds;
+};
+
+struct FPVSBakeSettings
+{
+    float CellSize = 2.f;
+    uint32_t SamplesPerCell = 16u;
+    uint32_t RaysPerSample = 256u;
+
+    // Positions and directions are stratified, so these counts cover a cell evenly rather than in clumps.
+
+    // 0 uses std::thread::hardware_concurrency().
+    uint32_t NumThreads = 0u;
+};
+
+class FPVS
+{
+public:
+    static constexpr uint32_t INVALID_CELL = ~0u;
+
+    bool IsValid() const { return NumCells > 0u; }
+    uint32_t GetNumMeshes() const { return NumMeshes; }
+    uint32_t GetNumCells() const { return NumCells; }
+    size_t GetCompressedSizeInBytes() const { return CompressedVisibility.size(); }
+    uint64_t GetSceneHash() const { return SceneHash; }
+
+    uint32_t GetCellIndex(const XMFLOAT3& Position) const;
+
+    // Decompress the visibility of a cell into one bit per mesh.
+    void DecodeCell(uint32_t CellIndex, std::vector<uint8_t>& OutVisibleBits) const;
+
+    bool Save(const std::string& Path) const;
+    // Rejects files whose header, offsets or compressed cells do not fit the file.
+    bool Load(const std::string& Path);
+
+    // SceneHash is stored with the result, see HashScenePlacement.
+    static std::unique_ptr<FPVS> Bake(const std::vector<FPVSMeshGeometry>& MeshGeometries, const FPVSBakeSettings& Settings, uint64_t SceneHash);
+
+    // Identifies where every mesh sits, a PVS is stale once this differs from the hash it was baked with.
+    // Values are quantized so recomposing the same transform does not change the hash.
+    static uint64_t HashScenePlacement(std::span<const Dx::XMFLOAT4X4> WorldMatrices, std::span<const FAABB> WorldBounds);
+
+    static bool IsVisible(const std::vector<uint8_t>& VisibleBits, uint32_t MeshIndex)
+    {
+        return (VisibleBits[MeshIndex >> 3] & (1u << (MeshIndex & 7u))) != 0;
+    }
+
+private:
+    static void CompressBits(const std::vector<uint8_t>& Bits, std::vector<uint8_t>& OutCompressed);
+    bool IsCellStreamValid(uint32_t CellIndex) const;
+
+    XMFLOAT3 GridOrigin{};
+    float CellSize = 1.f;
+    uint32_t GridDimension[3]{};
+    uint32_t NumCells = 0u;
+    uint32_t NumMeshes = 0u;
+    uint64_t SceneHash = 0u;
+
+    std::vector<uint32_t> CellOffsets;
+    std::vector<uint8_t> CompressedVisibility;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Math/Bounds.h"
+
+class FMesh;
+
+enum ERenderProxyFlags : uint32_t
+{
+    RenderProxyFlag_None = 0u,
+    RenderProxyFlag_Visible = 1u << 0,
+    RenderProxyFlag_CastShadow = 1u << 1,
+    RenderProxyFlag_RaytracingGeometry = 1u << 2,
+};
+
+// Refers to a proxy slot. The generation changes every time the slot is reused,
+// so a handle to a removed proxy never resolves to whatever took its place.
+struct FRenderProxyHandle
+{
+    static constexpr uint32_t INVALID_SLOT = 0xFFFFFFFF;
+
+    uint32_t Slot = INVALID_SLOT;
+    uint32_t Generation = 0u;
+
+    bool operator==(const FRenderProxyHandle& Other) const = default;
+};
+
+// Renderer side view of the scene meshes, stored as parallel arrays so culling,
+// sorting and instance upload walk contiguous memory instead of chasing FMesh pointers.
+// Dense indices are only valid until the next Remove, which swaps the last proxy into the hole.
+class FRenderProxyStore
+{
+public:
+    // ObjectId is the index the mesh was baked with (e.g. in the PVS), it survives swap and pop.
+    FRenderProxyHandle Add(FMesh* Mesh, uint32_t ObjectId);
+    bool Remove(FRenderProxyHandle Handle);
+    void Clear();
+
+    bool IsValid(FRenderProxyHandle Handle) const;
+    uint32_t GetDenseIndex(FRenderProxyHandle Handle) const;
+
+    void SetTransform(FRenderProxyHandle Handle, const XMMATRIX& WorldMatrix);
+    void SetFlags(FRenderProxyHandle Handle, uint32_t InFlags);
+
+    uint32_t Num() const { return static_cast<uint32_t>(Meshes.size()); }
+
+    std::span<const Dx::XMFLOAT4X4> GetWorldMatrices() const { return WorldMatrices; }
+    std::span<const Dx::XMFLOAT4X4> GetInverseWorldMatrices() const { return InverseWorldMatrices; }
+    std::span<const FAABB> GetWorldBounds() const { return WorldBounds; }
+    std::span<const uint32_t> GetPipelineIds() const { return PipelineIds; }
+    std::span<const uint32_t> GetMaterialIds() const { return MaterialIds; }
+    std::span<const uint32_t> GetGeometryIds() const { return GeometryIds; }
+    std::span<const uint32_t> GetObjectIds() const { return ObjectIds; }
+    std::span<const uint32_t> GetFlags() const { return Flags; }
+    std::span<FMesh* const> GetMeshes() const { return Meshes; }
+
+private:
+    // Dense, one entry per live proxy.
+    std::vector<Dx::XMFLOAT4X4> WorldMatrices;
+    std::vector<Dx::XMFLOAT4X4> InverseWorldMatrices;
+    std::vector<FAABB> LocalBounds;
+    std::vector<FAABB> WorldBounds;
+    std::vector<uint32_t> PipelineIds;
+    std::vector<uint32_t> MaterialIds;
+    std::vector<uint32_t> GeometryIds;
+    std::vector<uint32_t> ObjectIds;
+    std::vector<uint32_t> Flags;
+    std::vector<FMesh*> Meshes;
+    std::vector<uint32_t> DenseToSlot;
+
+    // Sparse, indexed by handle slot.
+    std::vector<uint32_t> SlotToDense;
+    std::vector<uint32_t> SlotGenerations;
+    std::vector<uint32_t> FreeSlots;
+};
@@ -5,7 +5,18 @@
 #include "Scene/Light.h"
 #include "Renderer/CubeMap.h"
 #include "Graphics/Raytracing.h"
+#include "Graphics/ConstantBufferAllocator.h"
 #include "Scene/Mesh.h"
+#include "Scene/PVS.h"
+#include "Scene/RenderProxy.h"
+#include "Scene/TransformHierarchy.h"
+#include "Renderer/RenderQueue.h"
+#include "Renderer/IndirectDraw.h"
+#include "Scene/FrameSnapshot.h"
+
+#include <functional>
+#include <future>
+#include <mutex>
 
 class FGraphicsContext;
 class FCamera;
@@ -25,14 +36,20 @@ struct FSceneRenderSettings
     FTexture* SelectedDebugTexture = nullptr;
     float VisualizeDebugMin = 0.f;
     float VisualizeDebugMax = 1.f;
+    // Record the RHI command stream of the next rendered frame to Captures/.
+    bool bCaptureNextFrame = false;
 
     int WhiteFurnaceMethod = 0;
     bool bUseEnergyCompensation = true;
 
     int DiffuseMethod = 0;
     int MaxFPS = 60;
+    // Render passes unused for this many frames are released, 0 keeps them alive.
+    int RenderPassIdleReleaseFrames = 600;
 
     int RenderingMode = 0;
+    bool bUsePVS = false;
+    bool bUseIndirectDraw = false;
     int PathTracingSamplePerPixel = 16;
     bool bEnablePathTracingDenoiser = true;
     bool bDenoiserAlbedoNormal = true;
@@ -55,6 +72,8 @@ struct FSceneRenderSettings
 
     // SSAO
     bool bUseSSAO = true;
+    // Overlaps the shadow pass on the async compute queue.
+    bool bSSAOAsyncCompute = true;
     int SSAOKernelSize = 64;
     float SSAOKernelRadius = 4e-3f;
     float SSAODepthBias = 1e-6f;
@@ -96,12 +115,22 @@ public:
     FScene(uint32_t Width, uint32_t Height);
     ~FScene();
 
-    void GameTick(float DeltaTime, FInput* Input, uint32_t Width, uint32_t Height);
+    // Game thread. Advances camera, transforms and lights, then fills Snapshot for the render thread.
+    void GameTick(float DeltaTime, FInput* Input, uint32_t Width, uint32_t Height, FFrameSnapshot& Snapshot);
     void HandleMaxTickRate();
 
+    // Render thread. Applies the snapshot to the render proxies and per frame buffers before recording.
+    void BeginRenderFrame(const FFrameSnapshot& Snapshot);
+    const FFrameSnapshot& GetFrameSnapshot() const { return *RenderSnapshot; }
+
+    // Camera, lights and the transform hierarchy belong to the game thread, the render thread
+    // (e.g. the editor) changes them through commands that run at the start of the next GameTick.
+    void EnqueueGameThreadCommand(std::function<void(FScene&)> Command);
+
     void UpdateBuffers();
     void AddModel(const FModelCreationDesc& Desc);
 	void AddMesh(FMesh* Mesh);
+    void SetMeshVisibility(uint32_t MeshIndex, bool bVisible);
     void AddLight(float Position[4], float Color[4], float Intensity = 1.f) { Light.AddLight(Position, Color, Intensity); }
 
     void RenderModels(FGraphicsContext* const GraphicsContext,
@@ -111,13 +140,21 @@ public:
     void RenderModels(FGraphicsContext* const GraphicsContext,
         interlop::ShadowDepthPassRenderResource& ShadowDepthPassRenderResource);
 
+    // Instance data and draw arguments come from GPU buffers, one ExecuteIndirect per call.
+    void RenderModels(FGraphicsContext* const GraphicsContext,
+        interlop::DeferredGPassIndirectRenderResources& DeferredGIndirectRenderResources);
+    void RenderModels(FGraphicsContext* const GraphicsContext,
+        interlop::ShadowDepthPassIndirectRenderResource& ShadowDepthPassIndirectRenderResource);
+
     void RenderLightsDeferred(FGraphicsContext* const GraphicsContext,
         interlop::DeferredGPassCubeRenderResources);
 
-    FBuffer& GetSceneBuffer() { return SceneBuffer[GFrameCount % FRAMES_IN_FLIGHT]; }
-    FBuffer& GetLightBuffer() { return LightBuffer[GFrameCount % FRAMES_IN_FLIGHT]; }
-    FBuffer& GetShadowBuffer() { return ShadowBuffer[GFrameCount % FRAMES_IN_FLIGHT]; }
-    FBuffer& GetDebugBuffer() { return DebugBuffer[GFrameCount % FRAMES_IN_FLIGHT]; }
+    // Valid for the frame UpdateBuffers last ran for.
+    uint32_t GetSceneBufferCbv() const { return SceneBufferCbv; }
+    uint32_t GetLightBufferCbv() const { return LightBuffer.GetCbvIndex(); }
+    uint32_t GetShadowBufferCbv() const { return ShadowBuffer.GetCbvIndex(); }
+    uint32_t GetDebugBufferCbv() const { return DebugBuffer.GetCbvIndex(); }
+    FBuffer& GetInstanceBuffer() { return InstanceBuffer[GFrameCount % FRAMES_IN_FLIGHT]; }
     FCamera& GetCamera() { return Camera; }
     FCubeMap* GetEnvironmentMap() { return (RenderSettings.WhiteFurnaceMethod == 0 || RenderSettings.WhiteFurnaceMethod == 3) ? EnviromentMap.get() : WhiteFurnaceMap.get(); }
     void RenderEnvironmentMap(FGraphicsContext* const GraphicsContext, FSceneTexture& SceneTexture);
@@ -125,7 +162,29 @@ public:
     void GenerateRaytracingScene(FGraphicsContext* const GraphicsContext);
 
     FRaytracingScene& GetRaytracingScene() { return RaytracingScene; }
-
+    const FRenderProxyStore& GetRenderProxies() const { return RenderProxies; }
+
+    // Move meshes by editing their node, the change is applied on the next GameTick.
+    FTransformHierarchy& GetTransformHierarchy() { return TransformHierarchy; }
+    uint32_t GetNumMeshes() const { return static_cast<uint32_t>(Meshes.size()); }
+    uint32_t GetMeshTransformNode(uint32_t MeshIndex) const { return MeshTransformNodes[MeshIndex]; }
+    // Game thread. The mesh whose transform node the snapshot carries for the editor.
+    void SetEditorSelectedMesh(uint32_t MeshIndex) { EditorSelectedMesh = MeshIndex; }
+
+    // Geometry is gathered on the calling thread, the rays are traced in the background and the first frame
+    // after the bake finished installs and saves the result.
+    void BakePVS(const FPVSBakeSettings& Settings);
+    bool IsBakingPVS() const { return PVSBakeTask.valid(); }
+    // Blocks until a running bake finished and installs it, for bakes without a frame loop.
+    void WaitForPVSBake();
+    bool LoadPVS();
+    const FPVS* GetPVS() const { return PVS.get(); }
+    uint32_t GetNumPVSCulledMeshes() const { return NumPVSCulledMeshes; }
+
+    const FRenderQueueStats& GetGPassRenderQueueStats() const { return GPassRenderQueue.GetStats(); }
+    uint32_t GetNumGPassIndirectDraws() const { return GPassIndirectDrawBuffer.GetNumDraws(); }
+
+    // Game thread state, the render thread reads the copy in the frame snapshot.
     FLight Light;
     float CPUFrameMsTime = 0;
 
@@ -144,16 +203,67 @@ private:
     
 	std::vector<std::unique_ptr<FMesh>> Meshes{};
 
+    // Meshes own the GPU resources, the proxy store is what the render paths iterate.
+    void AddRenderProxies(uint32_t FirstMeshIndex);
+    void UpdateTransforms(FFrameSnapshot& Snapshot);
+    void ApplyMovedMeshes(const FFrameSnapshot& Snapshot);
+    FRenderProxyStore RenderProxies;
+    std::vector<FRenderProxyHandle> MeshProxyHandles{};
+
+    FTransformHierarchy TransformHierarchy;
+    std::vector<uint32_t> MeshTransformNodes{};
+
     FCamera Camera;
-    std::array<FBuffer, FRAMES_IN_FLIGHT> SceneBuffer;
-    std::array<FBuffer, FRAMES_IN_FLIGHT> LightBuffer;
-    std::array<FBuffer, FRAMES_IN_FLIGHT> ShadowBuffer;
-    std::array<FBuffer, FRAMES_IN_FLIGHT> DebugBuffer;
+    // The scene buffer changes every frame (frame count, jitter) and lives in frame constant memory. The others
+    // mostly hold still and only upload when their contents change.
+    uint32_t SceneBufferCbv = INVALID_INDEX_U32;
+    TTrackedConstantBuffer<interlop::LightBuffer> LightBuffer;
+    TTrackedConstantBuffer<interlop::ShadowBuffer> ShadowBuffer;
+    TTrackedConstantBuffer<interlop::DebugBuffer> DebugBuffer;
+    std::array<FBuffer, FRAMES_IN_FLIGHT> InstanceBuffer;
     std::unique_ptr<FCubeMap> WhiteFurnaceMap{};
 
     std::chrono::high_resolution_clock::time_point PrevTime;
 
     FRaytracingScene RaytracingScene;
 
+    void UpdatePVSVisibility();
+    bool IsPotentiallyVisible(uint32_t MeshIndex) const;
+    uint64_t ComputePVSSceneHash() const;
+    void FinishPVSBake();
+    void InvalidatePVS(const std::string& Reason);
+
+    std::string PVSPath;
+    std::unique_ptr<FPVS> PVS{};
+    uint32_t PVSCameraCell = FPVS::INVALID_CELL;
+    std::vector<uint8_t> PVSVisibleBits{};
+    uint32_t NumPVSCulledMeshes = 0u;
+    std::future<std::unique_ptr<FPVS>> PVSBakeTask{};
+
+    void BuildGPassRenderQueue();
+    void UpdateInstanceBuffer();
+
+    FRenderQueue GPassRenderQueue;
+
+    std::vector<FIndirectDrawItem> IndirectDrawItems{};
+    std::vector<uint32_t> IndirectInstances{};
+    FIndirectDrawArgumentBuilder IndirectDrawArgumentBuilder;
+    FIndirectDrawBuffer GPassIndirectDrawBuffer{ L"GPass Indirect Argument Buffer" };
+    FIndirectDrawBuffer ShadowIndirectDrawBuffer{ L"Shadow Indirect Argument Buffer" };
+
     FSceneRenderSettings RenderSettings{};
+
+    void CaptureFrameSnapshot(FFrameSnapshot& Snapshot, float DeltaTime);
+    void ExecuteGameThreadCommands();
+
+    // Copy of RenderSettings the game thread reads, refreshed from the render thread once per frame.
+    FSceneRenderSettings GameThreadRenderSettings{};
+    uint32_t GameFrameIndex = 0u;
+    uint32_t EditorSelectedMesh = 0u;
+
+    const FFrameSnapshot* RenderSnapshot = nullptr;
+
+    std::mutex GameThreadCommandMutex;
+    std::vector<std::function<void(FScene&)>> GameThreadCommands{};
+    std::vector<std::function<void(FScene&)>> ExecutingGameThreadCommands{};
 };
@@ -0,0 +1,64 @@
+#pragma once
+
+// Runtime scene graph for transforms.
+// Nodes are updated parent before child (breadth first when built from a tree), so one linear pass
+// can propagate dirty flags and compose world matrices without recursion. That is the storage order until
+// a node is reparented under a later one, the update order is then rebuilt and node indices stay stable.
+// Local TRS lives in separate arrays and only dirty nodes are recomposed each update.
+class FTransformHierarchy
+{
+public:
+    static constexpr uint32_t INVALID_NODE = 0xFFFFFFFF;
+
+    // Parent has to be INVALID_NODE or an already added node.
+    uint32_t AddNode(uint32_t Parent, const XMFLOAT3& Translation, const XMFLOAT4& Rotation, const XMFLOAT3& Scale);
+    uint32_t AddNode(uint32_t Parent, const XMMATRIX& LocalMatrix);
+
+    // Appends every node of Other, returns the index its node 0 ended up at.
+    uint32_t Append(const FTransformHierarchy& Other);
+
+    // Moves Node and its descendants under NewParent (INVALID_NODE for a root) keeping their local transforms,
+    // the next Update recomposes them. Returns false and changes nothing if NewParent is Node or one of its descendants.
+    bool SetParent(uint32_t Node, uint32_t NewParent);
+
+    void SetLocalTranslation(uint32_t Node, const XMFLOAT3& Translation);
+    void SetLocalRotation(uint32_t Node, const XMFLOAT4& Rotation);
+    void SetLocalScale(uint32_t Node, const XMFLOAT3& Scale);
+
+    const XMFLOAT3& GetLocalTranslation(uint32_t Node) const { return LocalTranslations[Node]; }
+    const XMFLOAT4& GetLocalRotation(uint32_t Node) const { return LocalRotations[Node]; }
+    const XMFLOAT3& GetLocalScale(uint32_t Node) const { return LocalScales[Node]; }
+    uint32_t GetParent(uint32_t Node) const { return Parents[Node]; }
+
+    // Recomputes the world matrix of every dirty node and its descendants.
+    void Update();
+
+    XMMATRIX GetWorldMatrix(uint32_t Node) const { return XMLoadFloat4x4(&WorldMatrices[Node]); }
+    // Inverted on first request after the node moved.
+    XMMATRIX GetInverseWorldMatrix(uint32_t Node);
+
+    // Nodes whose world matrix changed during the last Update.
+    std::span<const uint32_t> GetUpdatedNodes() const { return UpdatedNodes; }
+    bool WasUpdated(uint32_t Node) const { return UpdatedFlags[Node] != 0u; }
+
+    uint32_t Num() const { return static_cast<uint32_t>(Parents.size()); }
+
+private:
+    void PushNode(uint32_t Parent, const XMFLOAT3& Translation, const XMFLOAT4& Rotation, const XMFLOAT3& Scale);
+    void SortUpdateOrder();
+
+    std::vector<uint32_t> Parents;
+    // Every node once, parents before their children.
+    std::vector<uint32_t> UpdateOrder;
+    std::vector<XMFLOAT3> LocalTranslations;
+    std::vector<XMFLOAT4> LocalRotations;
+    std::vector<XMFLOAT3> LocalScales;
+    std::vector<Dx::XMFLOAT4X4> WorldMatrices;
+    std::vector<Dx::XMFLOAT4X4> InverseWorldMatrices;
+
+    std::vector<uint8_t> DirtyFlags;
+    std::vector<uint8_t> InverseDirtyFlags;
+    std::vector<uint8_t> UpdatedFlags;
+    std::vector<uint32_t> UpdatedNodes;
+    std::vector<Dx::XMFLOAT4X4> LocalMatrixScratch;
+};
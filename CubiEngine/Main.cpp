@@ -3,12 +3,13 @@
 int main(int argc, char* argv[])
 {
     Application App("CubiEngine");
+    if (!App.ParseCommandLine(argc, argv)) {
+        return -1;
+    }
 
     if (!App.Init(InitialWidth, InitialHeight)) {
         return -1;
     }
 
-    App.Run();
-
-    return 0;
+    return App.Run() ? 0 : -1;
 }
\ No newline at end of file
@@ -1,9 +1,11 @@
 #include "Core/Application.h"
 #include "Core/FileSystem.h"
+#include "Core/JobSystem.h"
+#include "Core/FramePipeline.h"
 #include "Renderer/Renderer.h"
 #include "Graphics/D3D12DynamicRHI.h"
-
-#include <imgui_impl_sdl2.h>
+#include "Graphics/MaterialTable.h"
+#include <charconv>
 
 // Setting the Agility SDK parameters.
 extern "C"
@@ -26,6 +28,139 @@ Application::~Application()
 {
 }
 
+namespace
+{
+    // -name=value, the whole value has to parse.
+    template<typename T>
+    bool ParseArgumentValue(std::string_view Arg, std::string_view Prefix, T& OutValue)
+    {
+        const std::string_view Value = Arg.substr(Prefix.size());
+        const std::from_chars_result Result = std::from_chars(Value.data(), Value.data() + Value.size(), OutValue);
+        if (Value.empty() || Result.ec != std::errc{} || Result.ptr != Value.data() + Value.size())
+        {
+            Log(std::format("Invalid value in command line argument {}", Arg));
+            return false;
+        }
+        return true;
+    }
+
+    // Render settings -set: can override. Bools take 0 or 1.
+    struct FRenderSettingOverride
+    {
+        std::string_view Name;
+        int FSceneRenderSettings::* IntSetting;
+        bool FSceneRenderSettings::* BoolSetting;
+    };
+
+    constexpr FRenderSettingOverride RENDER_SETTING_OVERRIDES[] = {
+        { "ShadowMethod", &FSceneRenderSettings::ShadowMethod, nullptr },
+        { "GIMethod", &FSceneRenderSettings::GIMethod, nullptr },
+        { "ToneMappingMethod", &FSceneRenderSettings::ToneMappingMethod, nullptr },
+        { "bUseSSAO", nullptr, &FSceneRenderSettings::bUseSSAO },
+        { "bSSAOAsyncCompute", nullptr, &FSceneRenderSettings::bSSAOAsyncCompute },
+        { "bUseTaa", nullptr, &FSceneRenderSettings::bUseTaa },
+        { "bUseEyeAdaptation", nullptr, &FSceneRenderSettings::bUseEyeAdaptation },
+        { "bUseBloom", nullptr, &FSceneRenderSettings::bUseBloom },
+        { "bUseVSM", nullptr, &FSceneRenderSettings::bUseVSM },
+        { "bEnablePathTracingDenoiser", nullptr, &FSceneRenderSettings::bEnablePathTracingDenoiser },
+    };
+
+    const FRenderSettingOverride* FindRenderSettingOverride(std::string_view Name)
+    {
+        for (const FRenderSettingOverride& Override : RENDER_SETTING_OVERRIDES)
+        {
+            if (Override.Name == Name)
+            {
+                return &Override;
+            }
+        }
+        return nullptr;
+    }
+
+    std::vector<std::string> SplitList(std::string_view List)
+    {
+        std::vector<std::string> Items;
+        for (const auto Item : std::views::split(List, ','))
+        {
+            if (!Item.empty())
+            {
+                Items.emplace_back(Item.begin(), Item.end());
+            }
+        }
+        return Items;
+    }
+}
+
+bool Application::ParseCommandLine(int Argc, char* Argv[])
+{
+    for (int i = 1; i < Argc; i++)
+    {
+        const std::string_view Arg = Argv[i];
+        if (Arg == "-headless")
+        {
+            bHeadless = true;
+        }
+        else if (Arg == "-bakepvs")
+        {
+            bBakePVS = true;
+        }
+        else if (Arg.starts_with("-frames="))
+        {
+            if (!ParseArgumentValue(Arg, "-frames=", MaxFrames))
+            {
+                return false;
+            }
+        }
+        else if (Arg.starts_with("-rendermode="))
+        {
+            if (!ParseArgumentValue(Arg, "-rendermode=", RenderingModeOverride))
+            {
+                return false;
+            }
+            if (RenderingModeOverride < 0 || RenderingModeOverride > static_cast<int>(ERenderingMode::PathTracing))
+            {
+                Log(std::format("Unknown rendering mode in {}", Arg));
+                return false;
+            }
+        }
+        else if (Arg.starts_with("-set:"))
+        {
+            constexpr std::string_view Prefix = "-set:";
+            const size_t Separator = Arg.find('=');
+            const FRenderSettingOverride* Override = Separator == std::string_view::npos ? nullptr :
+                FindRenderSettingOverride(Arg.substr(Prefix.size(), Separator - Prefix.size()));
+            if (!Override)
+            {
+                Log(std::format("Unknown render setting in {}", Arg));
+                return false;
+            }
+
+            int Value = 0;
+            if (!ParseArgumentValue(Arg, Arg.substr(0, Separator + 1u), Value))
+            {
+                return false;
+            }
+            if (Override->BoolSetting && Value != 0 && Value != 1)
+            {
+                Log(std::format("{} takes 0 or 1", Override->Name));
+                return false;
+            }
+            RenderSettingOverrides.emplace_back(std::string(Override->Name), Value);
+        }
+        else if (Arg.starts_with("-expectpasses="))
+        {
+            bCheckRenderPasses = true;
+            ExpectedRenderPasses = SplitList(Arg.substr(std::string_view("-expectpasses=").size()));
+        }
+        else
+        {
+            Log(std::format("Ignoring unknown command line argument {}", Arg));
+        }
+    }
+
+    return true;
+}
+
 bool Application::Init(uint32_t Width, uint32_t Height)
 {
     FFileSystem::LocateRootDirectory();
@@ -37,7 +172,9 @@ bool Application::Init(uint32_t Width, uint32_t Height)
     }
 
     // Create the window
-    Window = SDL_CreateWindow(WindowTitle.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, Width, Height, SDL_WINDOW_RESIZABLE);
+    // Headless runs still need a window for SDL input and the editor, it is just never shown.
+    const uint32_t WindowFlags = bHeadless ? SDL_WINDOW_HIDDEN : SDL_WINDOW_RESIZABLE;
+    Window = SDL_CreateWindow(WindowTitle.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, Width, Height, WindowFlags);
     if (!Window) {
         std::cerr << "Failed to create window: " << SDL_GetError() << std::endl;
         SDL_Quit();
@@ -50,41 +187,146 @@ bool Application::Init(uint32_t Width, uint32_t Height)
     SDL_GetWindowWMInfo(Window, &wmInfo);
     WindowHandle = wmInfo.info.win.window;
 
+    // This thread, which goes on to run the game loop, becomes worker 0 of the job system. The render thread
+    // started by the frame pipeline is not a worker, its jobs go through the injection queue.
+    CreateJobSystem();
+
     // Initialize renderer
-    CreateRHI(Width, Height, DXGI_FORMAT_R10G10B10A2_UNORM, WindowHandle);
+    CreateRHI(Width, Height, DXGI_FORMAT_R10G10B10A2_UNORM, bHeadless ? nullptr : WindowHandle);
 
     D3DRenderer = new FRenderer(Window, Width, Height);
+    FSceneRenderSettings& Settings = D3DRenderer->GetScene()->GetRenderSettings();
+    if (RenderingModeOverride >= 0)
+    {
+        Settings.RenderingMode = RenderingModeOverride;
+    }
+    for (const auto& [Name, Value] : RenderSettingOverrides)
+    {
+        const FRenderSettingOverride* Override = FindRenderSettingOverride(Name);
+        if (Override->IntSetting)
+        {
+            Settings.*Override->IntSetting = Value;
+        }
+        else
+        {
+            Settings.*Override->BoolSetting = Value != 0;
+        }
+    }
+    FramePipeline = std::make_unique<FFramePipeline>(*D3DRenderer);
+
+    // Nothing is rendered yet, so the scene is only touched by this thread.
+    if (bBakePVS)
+    {
+        D3DRenderer->GetScene()->BakePVS(FPVSBakeSettings{});
+        D3DRenderer->GetScene()->WaitForPVSBake();
+    }
 
-    IsRunning = true;
+    IsRunning = !bBakePVS;
     return true;
 }
 
-void Application::Run()
+bool Application::Run()
 {
     std::chrono::high_resolution_clock Clock{};
+    const std::chrono::high_resolution_clock::time_point StartTime = Clock.now();
 
     while (IsRunning)
     {
         HandleEvents();
 
         const std::chrono::high_resolution_clock::time_point CurTime = Clock.now();
-        const float DeltaTime = std::chrono::duration_cast<std::chrono::milliseconds>(CurTime - PrevTime).count();
+        float DeltaTime = std::chrono::duration_cast<std::chrono::milliseconds>(CurTime - PrevTime).count();
         PrevTime = CurTime;
 
-        Render(DeltaTime);
+        // A fixed step keeps headless runs deterministic from one run to the next.
+        if (bHeadless)
+        {
+            DeltaTime = 1000.f / 60.f;
+        }
+
+        Tick(DeltaTime);
+
+        NumTickedFrames++;
+        if (MaxFrames != 0u && NumTickedFrames >= MaxFrames)
+        {
+            IsRunning = false;
+        }
+    }
+
+    // Includes rendering the frames still in the pipeline.
+    FramePipeline->Flush();
+
+    bool bSucceeded = true;
+    if (bCheckRenderPasses)
+    {
+        std::vector<std::string> CreatedRenderPasses = D3DRenderer->GetCreatedRenderPassNames();
+        std::ranges::sort(CreatedRenderPasses);
+        std::ranges::sort(ExpectedRenderPasses);
+        if (CreatedRenderPasses != ExpectedRenderPasses)
+        {
+            auto Join = [](const std::vector<std::string>& Names)
+            {
+                std::string Joined;
+                for (const std::string& Name : Names)
+                {
+                    Joined += Joined.empty() ? Name : ", " + Name;
+                }
+                return Joined;
+            };
+            Log(std::format("Render pass check failed. Expected : {}. Created : {}.", Join(ExpectedRenderPasses), Join(CreatedRenderPasses)));
+            bSucceeded = false;
+        }
+    }
+
+    if (MaxFrames != 0u && NumTickedFrames != 0u)
+    {
+        const float TotalMs = std::chrono::duration<float, std::milli>(Clock.now() - StartTime).count();
+        const FRHIStats& Stats = RHIGetStats();
+        Log(std::format("{} frames, {:.3f} ms per frame. Textures {}, buffers {}, pipeline states {}, copy submissions {}, compute submissions {}, upload ring stalls {}.",
+            NumTickedFrames, TotalMs / NumTickedFrames,
+            Stats.NumTexturesCreated.load(), Stats.NumBuffersCreated.load(), Stats.NumPipelineStatesCreated.load(),
+            Stats.NumCopySubmissions.load(), Stats.NumComputeSubmissions.load(), Stats.NumUploadRingStalls.load()));
+
+        // Which passes the settings of this run pulled in.
+        std::string RenderPassNames;
+        for (const std::string& Name : D3DRenderer->GetCreatedRenderPassNames())
+        {
+            RenderPassNames += RenderPassNames.empty() ? Name : ", " + Name;
+        }
+        Log(std::format("Render passes created : {}.", RenderPassNames));
+
+        const FGeometryPoolStats PoolStats = RHIGetGeometryPool()->GetStats();
+        Log(std::format("Geometry pool : {} meshes, vertices {} / {}, indices {} / {}, fragmentation {:.2f} / {:.2f}, grows {}, defragments {}.",
+            PoolStats.NumAllocations, PoolStats.NumVertices, PoolStats.VertexCapacity, PoolStats.NumIndices, PoolStats.IndexCapacity,
+            PoolStats.VertexFragmentation, PoolStats.IndexFragmentation, PoolStats.NumGrows, PoolStats.NumDefragments));
+
+        const FMaterialTable* MaterialTable = RHIGetMaterialTable();
+        Log(std::format("Material table : {} slots in use, {} materials deduplicated.",
+            MaterialTable->GetNumLiveSlots(), MaterialTable->GetNumDeduplicated()));
+
+        const FDeferredReleaseStats ReleaseStats = RHIGetDeferredReleaseStats();
+        Log(std::format("Deferred releases : {} pending ({} bytes, peak {}), {} released ({} bytes).",
+            ReleaseStats.NumPending, ReleaseStats.PendingBytes, ReleaseStats.PeakPendingBytes,
+            ReleaseStats.NumReleased, ReleaseStats.ReleasedBytes));
     }
 
     Cleanup();
+    return bSucceeded;
 }
 
-void Application::Render(float DeltaTime)
+void Application::Tick(float DeltaTime)
 {
-    D3DRenderer->GameTick(DeltaTime, &Input);
-    D3DRenderer->Render();
+    FFrameSnapshot& Snapshot = FramePipeline->BeginFrame();
+    Snapshot.UIEvents.swap(UIEvents);
+    D3DRenderer->GameTick(DeltaTime, &Input, Snapshot);
+    FramePipeline->EndFrame();
 }
 
 void Application::Cleanup()
 {
+    // Renders whatever was already submitted, then joins the render thread.
+    FramePipeline.reset();
+
     if (D3DRenderer) {
 		D3DRenderer->Cleanup();
         delete D3DRenderer;
@@ -92,6 +334,7 @@ void Application::Cleanup()
     }
 
     ReleaseRHI();
+    ReleaseJobSystem();
 
     SDL_DestroyWindow(Window);
     Window = nullptr;
@@ -104,7 +347,8 @@ void Application::HandleEvents()
     Input.Reset();
     while (SDL_PollEvent(&Event))
     {
-        ImGui_ImplSDL2_ProcessEvent(&Event);
+        // The editor runs on the render thread, it gets the events with the next frame snapshot.
+        UIEvents.push_back(Event);
 
         if (Event.type == SDL_QUIT)
         {
@@ -123,6 +367,8 @@ void Application::HandleEvents()
             uint32_t Height = Event.window.data2;
             // TODO : Window Resize
 
+            // Size dependent resources are recreated while the render thread is idle.
+            FramePipeline->Flush();
             D3DRenderer->OnWindowResized(Width, Height);
         }
         Input.ProcessEvent(Event);
@@ -65,7 +65,14 @@ void FEditor::GameTick(float DeltaTime, FInput* Input)
 
 void FEditor::Render(FGraphicsContext* GraphicsContext, FScene* Scene)
 {
-    if (!bShowUI) return;
+    // ImGui is only touched on the render thread, window events are forwarded through the snapshot.
+    const FFrameSnapshot& Snapshot = Scene->GetFrameSnapshot();
+    for (const SDL_Event& Event : Snapshot.UIEvents)
+    {
+        ImGui_ImplSDL2_ProcessEvent(&Event);
+    }
+
+    if (!Snapshot.bShowEditor) return;
 
     ImGui_ImplDX12_NewFrame();
     ImGui_ImplSDL2_NewFrame(Window);
@@ -108,6 +115,12 @@ void FEditor::Render(FGraphicsContext* GraphicsContext, FScene* Scene)
             ImGui::EndTabItem();
         }
 
+        if (ImGui::BeginTabItem("Scene"))
+        {
+            RenderSceneProperties(Scene);
+            ImGui::EndTabItem();
+        }
+
         if (ImGui::BeginTabItem("GI"))
         {
             RenderGIProperties(Scene);
@@ -189,6 +202,7 @@ void RenderRenderingProperties(FScene* Scene)
     AddCombo("Rendering Mode", renderingModeItems, IM_ARRAYSIZE(renderingModeItems), Settings.RenderingMode);
 
     ImGui::SliderInt("Max FPS", &Settings.MaxFPS, 30, 144);
+    ImGui::SliderInt("Release Idle Passes After", &Settings.RenderPassIdleReleaseFrames, 0, 3600);
 
     ImGui::Checkbox("Enable Diffuse", &Settings.bEnableDiffuse);
     ImGui::Checkbox("Enable Specular", &Settings.bEnableSpecular);
@@ -199,6 +213,45 @@ void RenderRenderingProperties(FScene* Scene)
 
     const char* wfItems[] = { "Off", "Sampling", "IBL", "Albedo only"};
     AddCombo("White Furnace Method", wfItems, IM_ARRAYSIZE(wfItems), Settings.WhiteFurnaceMethod);
+
+    ImGui::Separator();
+
+    ImGui::Checkbox("Use PVS", &Settings.bUsePVS);
+    if (Scene->IsBakingPVS())
+    {
+        ImGui::Text("Baking PVS...");
+    }
+    else if (ImGui::Button("Bake PVS"))
+    {
+        Scene->BakePVS(FPVSBakeSettings{});
+    }
+
+    if (ImGui::Button("Capture Frame"))
+    {
+        Settings.bCaptureNextFrame = true;
+    }
+
+    if (const FPVS* PVS = Scene->GetPVS())
+    {
+        std::string PVSString = std::format("PVS : {} cells, {} bytes, {} meshes culled",
+            PVS->GetNumCells(), PVS->GetCompressedSizeInBytes(), Scene->GetNumPVSCulledMeshes());
+        ImGui::Text(PVSString.c_str());
+    }
+
+    ImGui::Checkbox("Use Indirect Draw", &Settings.bUseIndirectDraw);
+    if (Settings.bUseIndirectDraw)
+    {
+        std::string IndirectString = std::format("GPass indirect draws : {}", Scene->GetNumGPassIndirectDraws());
+        ImGui::Text(IndirectString.c_str());
+    }
+    else
+    {
+        const FRenderQueueStats& QueueStats = Scene->GetGPassRenderQueueStats();
+        std::string QueueString = std::format("GPass draws : {}, skipped index buffer {} / transform {} / geometry {} / material {}, sort passes skipped {} / 8",
+            QueueStats.NumDraws, QueueStats.NumIndexBufferBindsSkipped, QueueStats.NumTransformUpdatesSkipped,
+            QueueStats.NumGeometryUpdatesSkipped, QueueStats.NumMaterialUpdatesSkipped, QueueStats.NumSortPassesSkipped);
+        ImGui::Text(QueueString.c_str());
+    }
 }
 
 void RenderPathTracingProperties(FScene* Scene)
@@ -227,9 +280,103 @@ void FEditor::RenderCameraProperties(FScene* Scene)
 {
     FSceneRenderSettings& Settings = Scene->GetRenderSettings();
     
-    ImGui::InputFloat3("Camera Position", &Scene->GetCamera().GetCameraPosition().x);
-    ImGui::SliderFloat("Fov", &Scene->GetCamera().FovY, 30.0f, 120.0f);
-    ImGui::SliderFloat("Far Clip Distance", &Scene->GetCamera().FarZ, 1000.0f, 10000.0f);
+    const FFrameSnapshot& Snapshot = Scene->GetFrameSnapshot();
+    XMFLOAT3 Position = Snapshot.CameraPosition;
+    float FovY = Snapshot.CameraFovY;
+    float FarZ = Snapshot.CameraFarZ;
+
+    bool bChanged = ImGui::InputFloat3("Camera Position", &Position.x);
+    bChanged |= ImGui::SliderFloat("Fov", &FovY, 30.0f, 120.0f);
+    bChanged |= ImGui::SliderFloat("Far Clip Distance", &FarZ, 1000.0f, 10000.0f);
+
+    if (bChanged)
+    {
+        Scene->EnqueueGameThreadCommand([Position, FovY, FarZ](FScene& GameScene)
+        {
+            GameScene.GetCamera().SetCamPosition(Position.x, Position.y, Position.z);
+            GameScene.GetCamera().FovY = FovY;
+            GameScene.GetCamera().FarZ = FarZ;
+        });
+    }
+}
+
+void FEditor::RenderSceneProperties(FScene* Scene)
+{
+    if (Scene->GetNumMeshes() == 0)
+    {
+        return;
+    }
+
+    if (ImGui::SliderInt("Mesh", &SelectedMeshIndex, 0, Scene->GetNumMeshes() - 1))
+    {
+        Scene->EnqueueGameThreadCommand([MeshIndex = static_cast<uint32_t>(SelectedMeshIndex)](FScene& GameScene)
+        {
+            GameScene.SetEditorSelectedMesh(MeshIndex);
+        });
+    }
+
+    // The hierarchy belongs to the game thread, which may be updating it right now. Only the copy in this
+    // frame's snapshot is read here, it lags a frame behind the slider when the selection changes.
+    const FSelectedTransformSnapshot& Selected = Scene->GetFrameSnapshot().SelectedTransform;
+    if (Selected.MeshIndex != static_cast<uint32_t>(SelectedMeshIndex))
+    {
+        return;
+    }
+    const uint32_t Node = Selected.Node;
+
+    ImGui::Text(std::format("Transform node : {}", Node).c_str());
+
+    // -1 makes the node a root, the local transform is kept so the mesh moves with its new parent.
+    int32_t ParentNode = Selected.Parent == FTransformHierarchy::INVALID_NODE ? -1 : static_cast<int32_t>(Selected.Parent);
+    if (ImGui::InputInt("Parent Node", &ParentNode))
+    {
+        Scene->EnqueueGameThreadCommand([Node, ParentNode](FScene& GameScene)
+        {
+            FTransformHierarchy& Hierarchy = GameScene.GetTransformHierarchy();
+            const uint32_t NewParent = ParentNode < 0 ? FTransformHierarchy::INVALID_NODE : static_cast<uint32_t>(ParentNode);
+            if ((NewParent != FTransformHierarchy::INVALID_NODE && NewParent >= Hierarchy.Num()) || !Hierarchy.SetParent(Node, NewParent))
+            {
+                Log(std::format("Transform node {} cannot be parented to {}.", Node, ParentNode));
+            }
+        });
+    }
+
+    XMFLOAT3 Translation = Selected.Translation;
+    if (ImGui::DragFloat3("Translation", &Translation.x, 0.05f))
+    {
+        Scene->EnqueueGameThreadCommand([Node, Translation](FScene& GameScene)
+        {
+            GameScene.GetTransformHierarchy().SetLocalTranslation(Node, Translation);
+        });
+    }
+
+    // Edited as pitch / yaw / roll in degrees, stored as a quaternion.
+    Dx::XMFLOAT4X4 Rotation;
+    XMStoreFloat4x4(&Rotation, Dx::XMMatrixRotationQuaternion(XMLoadFloat4(&Selected.Rotation)));
+    XMFLOAT3 Euler = {
+        Dx::XMConvertToDegrees(asinf(max(-1.f, min(1.f, -Rotation._32)))),
+        Dx::XMConvertToDegrees(atan2f(Rotation._31, Rotation._33)),
+        Dx::XMConvertToDegrees(atan2f(Rotation._12, Rotation._22)),
+    };
+    if (ImGui::DragFloat3("Rotation", &Euler.x, 0.5f))
+    {
+        XMFLOAT4 Quaternion;
+        XMStoreFloat4(&Quaternion, Dx::XMQuaternionRotationRollPitchYaw(
+            Dx::XMConvertToRadians(Euler.x), Dx::XMConvertToRadians(Euler.y), Dx::XMConvertToRadians(Euler.z)));
+        Scene->EnqueueGameThreadCommand([Node, Quaternion](FScene& GameScene)
+        {
+            GameScene.GetTransformHierarchy().SetLocalRotation(Node, Quaternion);
+        });
+    }
+
+    XMFLOAT3 Scale = Selected.Scale;
+    if (ImGui::DragFloat3("Scale", &Scale.x, 0.01f, 1e-3f, 1e3f))
+    {
+        Scene->EnqueueGameThreadCommand([Node, Scale](FScene& GameScene)
+        {
+            GameScene.GetTransformHierarchy().SetLocalScale(Node, Scale);
+        });
+    }
 }
 
 void FEditor::RenderGIProperties(FScene* Scene)
@@ -237,6 +384,7 @@ void FEditor::RenderGIProperties(FScene* Scene)
     FSceneRenderSettings& Settings = Scene->GetRenderSettings();
 
     ImGui::Checkbox("Use SSAO", &Settings.bUseSSAO);
+    ImGui::Checkbox("SSAO Async Compute", &Settings.bSSAOAsyncCompute);
     ImGui::SliderInt("SSAO Kernel Size", &Settings.SSAOKernelSize, 8, 64);
     ImGui::SliderFloat("SSAO Kernel Radius", &Settings.SSAOKernelRadius, 1e-3f, 1e-2f);
     ImGui::InputFloat("SSAO Depth Bias", &Settings.SSAODepthBias, 1e-6, 1e-5, "%.6f");
@@ -262,7 +410,9 @@ void FEditor::RenderGIProperties(FScene* Scene)
 void FEditor::RenderLightProperties(FScene* Scene)
 {
     FSceneRenderSettings& Settings = Scene->GetRenderSettings();
-    interlop::LightBuffer& LightBuffer = Scene->Light.LightBufferData;
+    // Edits a copy, the lights are owned by the game thread.
+    interlop::LightBuffer LightBuffer = Scene->GetFrameSnapshot().LightBufferData;
+    bool bLightChanged = false;
 
     ImGui::SliderFloat("Envmap Intensity", &Settings.EnvmapIntensity, 0.f, 100.f);
 
@@ -273,17 +423,17 @@ void FEditor::RenderLightProperties(FScene* Scene)
     {
         constexpr uint32_t DirectionalLightIndex = 0u;
         
-        ImGui::SliderFloat("Intensity", &LightBuffer.intensityDistance[DirectionalLightIndex].x, 0.0f, 1000.0f);
-        ImGui::SliderFloat("MaxDistance", &LightBuffer.intensityDistance[DirectionalLightIndex].y, 100.0f, 5000.0f);
+        bLightChanged |= ImGui::SliderFloat("Intensity", &LightBuffer.intensityDistance[DirectionalLightIndex].x, 0.0f, 1000.0f);
+        bLightChanged |= ImGui::SliderFloat("MaxDistance", &LightBuffer.intensityDistance[DirectionalLightIndex].y, 100.0f, 5000.0f);
 
         DirectX::XMFLOAT4& Position = LightBuffer.lightPosition[DirectionalLightIndex];
 
-        ImGui::SliderFloat3("Directional Light Directional", &Position.x, -1.0f, 1.0f);
+        bLightChanged |= ImGui::SliderFloat3("Directional Light Directional", &Position.x, -1.0f, 1.0f);
 
         //
         DirectX::XMFLOAT4& Color = LightBuffer.lightColor[DirectionalLightIndex];
 
-        ImGui::ColorPicker3("Light Color", &Color.x,
+        bLightChanged |= ImGui::ColorPicker3("Light Color", &Color.x,
             ImGuiColorEditFlags_PickerHueWheel | ImGuiColorEditFlags_DisplayRGB |
             ImGuiColorEditFlags_HDR);
 
@@ -296,15 +446,23 @@ void FEditor::RenderLightProperties(FScene* Scene)
     {
         if (ImGui::TreeNode(("Point Light " + std::to_string(i)).c_str()))
         {
-            ImGui::SliderFloat("Intensity", &LightBuffer.intensityDistance[i].x, 0.0f, 10000.0f);
-            ImGui::SliderFloat("MaxDistance", &LightBuffer.intensityDistance[i].y, 100.0f, 5000.0f);
+            bLightChanged |= ImGui::SliderFloat("Intensity", &LightBuffer.intensityDistance[i].x, 0.0f, 10000.0f);
+            bLightChanged |= ImGui::SliderFloat("MaxDistance", &LightBuffer.intensityDistance[i].y, 100.0f, 5000.0f);
             DirectX::XMFLOAT4& Position = LightBuffer.lightPosition[i];
-            ImGui::SliderFloat3("Light Position", &Position.x, -500, 500);
+            bLightChanged |= ImGui::SliderFloat3("Light Position", &Position.x, -500, 500);
 
             ImGui::TreePop();
         }
     }
 
+    if (bLightChanged)
+    {
+        Scene->EnqueueGameThreadCommand([LightBuffer](FScene& GameScene)
+        {
+            GameScene.Light.LightBufferData = LightBuffer;
+        });
+    }
+
     if (ImGui::TreeNode("Shadow"))
     {
         const char* shadowMethodItems[] = { "None", "ShadowMapping", "Raytracing Shadow" };
@@ -384,7 +542,7 @@ void FEditor::RenderGPUProfileData()
 void FEditor::RenderProfileProperties(FScene* Scene)
 {
     std::ostringstream oss;
-    oss << std::fixed << std::setprecision(2) << Scene->CPUFrameMsTime;
+    oss << std::fixed << std::setprecision(2) << Scene->GetFrameSnapshot().CPUFrameMsTime;
     std::string durationStr = oss.str();
     std::string NameString = "CPU : " + durationStr + "ms";
     ImGui::Text(NameString.c_str());
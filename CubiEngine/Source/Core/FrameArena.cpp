@@ -0,0 +1,136 @@
+#include "Core/FrameArena.h"
+
+FFrameArenas GFrameArenas{};
+
+namespace
+{
+    // Freed memory reads back as 0xDD in debug builds, stale pointers into a reset arena stand out.
+    constexpr int POISON_PATTERN = 0xDD;
+
+    constexpr size_t BLOCK_ALIGNMENT = alignof(std::max_align_t);
+
+    size_t AlignUp(size_t Value, size_t Alignment)
+    {
+        return (Value + Alignment - 1u) & ~(Alignment - 1u);
+    }
+
+    thread_local void* GCurrentThreadArenas = nullptr;
+}
+
+FLinearArena::FLinearArena(size_t InBlockSize)
+    : BlockSize(InBlockSize)
+{
+}
+
+FLinearArena::~FLinearArena()
+{
+    FreeBlocks();
+}
+
+void* FLinearArena::Allocate(size_t Size, size_t Alignment)
+{
+    assert((Alignment & (Alignment - 1u)) == 0u);
+
+    uint8_t* Aligned = reinterpret_cast<uint8_t*>(AlignUp(reinterpret_cast<size_t>(Cursor), Alignment));
+    if (!CurrentBlock || Aligned + Size > End)
+    {
+        AllocateBlock(Size + Alignment);
+        Aligned = reinterpret_cast<uint8_t*>(AlignUp(reinterpret_cast<size_t>(Cursor), Alignment));
+    }
+
+    UsedBytes += (Aligned - Cursor) + Size;
+    Cursor = Aligned + Size;
+    return Aligned;
+}
+
+void FLinearArena::Reset()
+{
+    HighWaterMark = max(HighWaterMark, UsedBytes);
+
+    // Overflowed last time around, grow so the same load fits in one block.
+    if (CurrentBlock && CurrentBlock->Next)
+    {
+        const size_t NewBlockSize = AlignUp(Capacity, BlockSize);
+        if constexpr (DEBUG_MODE)
+        {
+            Log(std::format("Frame arena overflowed ({} KB used), growing to {} KB.", UsedBytes / 1024u, NewBlockSize / 1024u));
+        }
+
+        FreeBlocks();
+        BlockSize = NewBlockSize;
+    }
+
+    if (CurrentBlock)
+    {
+        uint8_t* const Begin = reinterpret_cast<uint8_t*>(CurrentBlock) + AlignUp(sizeof(FBlock), BLOCK_ALIGNMENT);
+        if constexpr (DEBUG_MODE)
+        {
+            std::memset(Begin, POISON_PATTERN, Cursor - Begin);
+        }
+        Cursor = Begin;
+    }
+
+    UsedBytes = 0u;
+}
+
+void FLinearArena::AllocateBlock(size_t MinSize)
+{
+    const size_t HeaderSize = AlignUp(sizeof(FBlock), BLOCK_ALIGNMENT);
+    const size_t DataSize = max(BlockSize, AlignUp(MinSize, BLOCK_ALIGNMENT));
+
+    void* Memory = ::operator new(HeaderSize + DataSize, std::align_val_t{ BLOCK_ALIGNMENT });
+    FBlock* Block = new (Memory) FBlock{ .Next = CurrentBlock, .Size = DataSize };
+
+    // Whatever was left in the previous block is wasted, count it as used so the high-water mark covers it.
+    if (CurrentBlock)
+    {
+        UsedBytes += End - Cursor;
+    }
+
+    CurrentBlock = Block;
+    Cursor = static_cast<uint8_t*>(Memory) + HeaderSize;
+    End = Cursor + DataSize;
+    Capacity += DataSize;
+}
+
+void FLinearArena::FreeBlocks()
+{
+    while (CurrentBlock)
+    {
+        FBlock* Next = CurrentBlock->Next;
+        ::operator delete(CurrentBlock, std::align_val_t{ BLOCK_ALIGNMENT });
+        CurrentBlock = Next;
+    }
+
+    Cursor = nullptr;
+    End = nullptr;
+    Capacity = 0u;
+}
+
+void FFrameArenas::BeginFrame()
+{
+    FrameIndex.fetch_add(1u, std::memory_order_release);
+}
+
+FLinearArena& FFrameArenas::GetThreadArena()
+{
+    FThreadArenas* Arenas = static_cast<FThreadArenas*>(GCurrentThreadArenas);
+    if (!Arenas)
+    {
+        std::lock_guard Lock(RegistrationMutex);
+        Arenas = ThreadArenas.emplace_back(std::make_unique<FThreadArenas>()).get();
+        Arenas->FrameIndex = FrameIndex.load(std::memory_order_acquire);
+        GCurrentThreadArenas = Arenas;
+    }
+
+    const uint64_t CurrentFrameIndex = FrameIndex.load(std::memory_order_acquire);
+    FLinearArena& Arena = Arenas->Arenas[CurrentFrameIndex % FRAMES_IN_FLIGHT];
+    if (Arenas->FrameIndex != CurrentFrameIndex)
+    {
+        // Anything in this slot was allocated at least FRAMES_IN_FLIGHT frames ago.
+        Arena.Reset();
+        Arenas->FrameIndex = CurrentFrameIndex;
+    }
+
+    return Arena;
+}
@@ -0,0 +1,130 @@
+#include "Core/FramePipeline.h"
+
+FFramePipeline::FFramePipeline(FFrameRenderer& InRenderer, uint32_t MaxFramesAhead)
+    : Renderer(InRenderer)
+{
+    // One snapshot being written plus up to MaxFramesAhead waiting for or being rendered.
+    const uint32_t NumSnapshots = max(1u, MaxFramesAhead) + 1u;
+    for (uint32_t i = 0; i < NumSnapshots; i++)
+    {
+        Snapshots.push_back(std::make_unique<FFrameSnapshot>());
+    }
+
+    RenderThread = std::thread(&FFramePipeline::RenderThreadLoop, this);
+}
+
+FFramePipeline::~FFramePipeline()
+{
+    Stop();
+}
+
+FFrameSnapshot& FFramePipeline::BeginFrame()
+{
+    std::unique_lock Lock(Mutex);
+    assert(!bFrameInProgress);
+
+    // The slot of frame N is free once frame N - NumSnapshots was rendered.
+    const uint64_t NumSnapshots = Snapshots.size();
+    FrameRendered.wait(Lock, [&]() { return NumSubmittedFrames - NumRenderedFrames < NumSnapshots; });
+
+    bFrameInProgress = true;
+    FFrameSnapshot& Snapshot = *Snapshots[NumSubmittedFrames % NumSnapshots];
+    Snapshot.Reset();
+    return Snapshot;
+}
+
+void FFramePipeline::EndFrame()
+{
+    {
+        std::lock_guard Lock(Mutex);
+        assert(bFrameInProgress);
+        bFrameInProgress = false;
+        NumSubmittedFrames++;
+    }
+    FrameSubmitted.notify_one();
+}
+
+void FFramePipeline::Flush()
+{
+    std::unique_lock Lock(Mutex);
+    if (!RenderThread.joinable())
+    {
+        return;
+    }
+
+    const uint64_t FlushRequest = ++NumFlushRequests;
+    FrameSubmitted.notify_one();
+    FrameRendered.wait(Lock, [&]() { return NumCompletedFlushes >= FlushRequest; });
+}
+
+void FFramePipeline::Stop()
+{
+    if (!RenderThread.joinable())
+    {
+        return;
+    }
+
+    Flush();
+    {
+        std::lock_guard Lock(Mutex);
+        bQuit = true;
+    }
+    FrameSubmitted.notify_one();
+    RenderThread.join();
+}
+
+uint64_t FFramePipeline::GetNumSubmittedFrames() const
+{
+    std::lock_guard Lock(Mutex);
+    return NumSubmittedFrames;
+}
+
+uint64_t FFramePipeline::GetNumRenderedFrames() const
+{
+    std::lock_guard Lock(Mutex);
+    return NumRenderedFrames;
+}
+
+void FFramePipeline::RenderThreadLoop()
+{
+    std::unique_lock Lock(Mutex);
+    while (true)
+    {
+        FrameSubmitted.wait(Lock, [&]()
+        {
+            return bQuit || NumRenderedFrames < NumSubmittedFrames || NumCompletedFlushes < NumFlushRequests;
+        });
+
+        // Frames are always drained before a flush or quit is honoured.
+        if (NumRenderedFrames < NumSubmittedFrames)
+        {
+            const FFrameSnapshot& Snapshot = *Snapshots[NumRenderedFrames % Snapshots.size()];
+
+            Lock.unlock();
+            Renderer.RenderFrame(Snapshot);
+            Lock.lock();
+
+            NumRenderedFrames++;
+            FrameRendered.notify_all();
+            continue;
+        }
+
+        if (NumCompletedFlushes < NumFlushRequests)
+        {
+            const uint64_t FlushRequest = NumFlushRequests;
+
+            Lock.unlock();
+            Renderer.FlushFrames();
+            Lock.lock();
+
+            NumCompletedFlushes = FlushRequest;
+            FrameRendered.notify_all();
+            continue;
+        }
+
+        if (bQuit)
+        {
+            return;
+        }
+    }
+}
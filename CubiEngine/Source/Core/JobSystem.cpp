@@ -0,0 +1,390 @@
+#include "Core/JobSystem.h"
+
+FJobSystem* GJobSystem = nullptr;
+
+namespace
+{
+    constexpr uint32_t INVALID_WORKER = 0xFFFFFFFF;
+
+    // Spins before a worker goes to sleep, jobs often arrive in bursts.
+    constexpr uint32_t IDLE_SPIN_COUNT = 64u;
+
+    thread_local const FJobSystem* GCurrentJobSystem = nullptr;
+    thread_local uint32_t GCurrentWorkerIndex = INVALID_WORKER;
+}
+
+FWorkStealingQueue::FRingBuffer::FRingBuffer(int64_t InCapacity)
+    : Capacity(InCapacity)
+    , Mask(InCapacity - 1)
+    , Items(std::make_unique<std::atomic<FJob*>[]>(InCapacity))
+{
+    assert((InCapacity & (InCapacity - 1)) == 0);
+}
+
+FWorkStealingQueue::FRingBuffer* FWorkStealingQueue::FRingBuffer::Grow(int64_t Bottom, int64_t Top) const
+{
+    FRingBuffer* NewBuffer = new FRingBuffer(Capacity * 2);
+    for (int64_t i = Top; i < Bottom; i++)
+    {
+        NewBuffer->Store(i, Load(i));
+    }
+    return NewBuffer;
+}
+
+FWorkStealingQueue::FWorkStealingQueue(uint32_t InitialCapacity)
+    : Buffer(new FRingBuffer(InitialCapacity))
+{
+}
+
+FWorkStealingQueue::~FWorkStealingQueue()
+{
+    delete Buffer.load();
+}
+
+void FWorkStealingQueue::Push(FJob* Job)
+{
+    const int64_t B = Bottom.load(std::memory_order_relaxed);
+    const int64_t T = Top.load(std::memory_order_acquire);
+    FRingBuffer* CurrentBuffer = Buffer.load(std::memory_order_relaxed);
+
+    if (B - T > CurrentBuffer->Capacity - 1)
+    {
+        FRingBuffer* NewBuffer = CurrentBuffer->Grow(B, T);
+        RetiredBuffers.emplace_back(CurrentBuffer);
+        Buffer.store(NewBuffer, std::memory_order_release);
+        CurrentBuffer = NewBuffer;
+    }
+
+    CurrentBuffer->Store(B, Job);
+    // Publishes the item to thieves that acquire Bottom.
+    Bottom.store(B + 1, std::memory_order_release);
+}
+
+FJob* FWorkStealingQueue::Pop()
+{
+    const int64_t B = Bottom.load(std::memory_order_relaxed) - 1;
+    FRingBuffer* CurrentBuffer = Buffer.load(std::memory_order_relaxed);
+    Bottom.store(B, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t T = Top.load(std::memory_order_relaxed);
+
+    if (T > B)
+    {
+        // Empty.
+        Bottom.store(B + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    FJob* Job = CurrentBuffer->Load(B);
+    if (T == B)
+    {
+        // Last item, race the thieves for it.
+        if (!Top.compare_exchange_strong(T, T + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            Job = nullptr;
+        }
+        Bottom.store(B + 1, std::memory_order_relaxed);
+    }
+
+    return Job;
+}
+
+FJob* FWorkStealingQueue::Steal()
+{
+    int64_t T = Top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t B = Bottom.load(std::memory_order_acquire);
+
+    if (T >= B)
+    {
+        return nullptr;
+    }
+
+    FRingBuffer* CurrentBuffer = Buffer.load(std::memory_order_acquire);
+    FJob* Job = CurrentBuffer->Load(T);
+    if (!Top.compare_exchange_strong(T, T + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        // Lost to the owner or another thief.
+        return nullptr;
+    }
+
+    return Job;
+}
+
+FJobSystem::FJobSystem(uint32_t NumWorkers)
+{
+    if (NumWorkers == 0u)
+    {
+        NumWorkers = max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (uint32_t WorkerIndex = 0; WorkerIndex < NumWorkers; WorkerIndex++)
+    {
+        Queues.push_back(std::make_unique<FWorkStealingQueue>());
+    }
+
+    GCurrentJobSystem = this;
+    GCurrentWorkerIndex = 0u;
+
+    for (uint32_t WorkerIndex = 1; WorkerIndex < NumWorkers; WorkerIndex++)
+    {
+        Workers.emplace_back(&FJobSystem::WorkerLoop, this, WorkerIndex);
+    }
+}
+
+FJobSystem::~FJobSystem()
+{
+    {
+        std::lock_guard Lock(SleepMutex);
+        bQuit = true;
+    }
+    SleepCondition.notify_all();
+
+    for (std::thread& Worker : Workers)
+    {
+        Worker.join();
+    }
+
+    // Jobs nobody waited for are dropped, not run.
+    for (const std::unique_ptr<FWorkStealingQueue>& Queue : Queues)
+    {
+        while (FJob* Job = Queue->Steal())
+        {
+            delete Job;
+        }
+    }
+    for (FJob* Job : InjectionQueue)
+    {
+        delete Job;
+    }
+
+    if (GCurrentJobSystem == this)
+    {
+        GCurrentJobSystem = nullptr;
+        GCurrentWorkerIndex = INVALID_WORKER;
+    }
+}
+
+void FJobSystem::Run(std::function<void()> Function, FJobCounter* Counter)
+{
+    if (Counter)
+    {
+        Counter->Pending.fetch_add(1u);
+    }
+
+    Schedule(new FJob{ .Function = std::move(Function), .Counter = Counter });
+}
+
+void FJobSystem::RunAfter(FJobCounter& Dependency, std::function<void()> Function, FJobCounter* Counter)
+{
+    if (Counter)
+    {
+        Counter->Pending.fetch_add(1u);
+    }
+
+    FJob* Job = new FJob{ .Function = std::move(Function), .Counter = Counter };
+    {
+        // FinishJob drains continuations under the same lock after Pending reaches zero,
+        // so the job is either appended before the drain or sees zero here.
+        std::lock_guard Lock(Dependency.ContinuationMutex);
+        if (Dependency.Pending.load() != 0u)
+        {
+            Dependency.Continuations.push_back(Job);
+            return;
+        }
+    }
+
+    Schedule(Job);
+}
+
+void FJobSystem::Wait(const FJobCounter& Counter)
+{
+    const uint32_t WorkerIndex = GCurrentJobSystem == this ? GCurrentWorkerIndex : INVALID_WORKER;
+    while (!Counter.IsDone())
+    {
+        if (FJob* Job = FindJob(WorkerIndex))
+        {
+            Execute(Job);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void FJobSystem::ParallelFor(uint32_t Count, const std::function<void(uint32_t, uint32_t)>& Function, uint32_t MinGrainSize)
+{
+    if (Count == 0u)
+    {
+        return;
+    }
+
+    // A few ranges per worker leaves room for stealing to even out uneven ranges.
+    const uint32_t GrainSize = max(max(MinGrainSize, 1u), Count / (GetNumWorkers() * 4u));
+    if (Count <= GrainSize)
+    {
+        Function(0u, Count);
+        return;
+    }
+
+    FJobCounter Counter;
+    ParallelForRange(0u, Count, GrainSize, Function, &Counter);
+    Wait(Counter);
+}
+
+void FJobSystem::ParallelForRange(uint32_t Begin, uint32_t End, uint32_t GrainSize,
+    const std::function<void(uint32_t, uint32_t)>& Function, FJobCounter* Counter)
+{
+    // Hand the upper half to whoever steals it and keep splitting the lower half locally.
+    while (End - Begin > GrainSize)
+    {
+        const uint32_t Mid = Begin + (End - Begin) / 2u;
+        Run([this, Mid, End, GrainSize, &Function, Counter]()
+        {
+            ParallelForRange(Mid, End, GrainSize, Function, Counter);
+        }, Counter);
+        End = Mid;
+    }
+
+    Function(Begin, End);
+}
+
+void FJobSystem::WorkerLoop(uint32_t WorkerIndex)
+{
+    GCurrentJobSystem = this;
+    GCurrentWorkerIndex = WorkerIndex;
+
+    uint32_t IdleCount = 0u;
+    while (!bQuit.load(std::memory_order_relaxed))
+    {
+        const uint64_t Epoch = WorkEpoch.load();
+        if (FJob* Job = FindJob(WorkerIndex))
+        {
+            Execute(Job);
+            IdleCount = 0u;
+            continue;
+        }
+
+        if (++IdleCount < IDLE_SPIN_COUNT)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Schedule bumps the epoch before checking for sleepers, so a job pushed after the
+        // epoch was read above either fails the predicate or gets a notify.
+        std::unique_lock Lock(SleepMutex);
+        NumSleepingWorkers.fetch_add(1u);
+        SleepCondition.wait(Lock, [&]() { return bQuit.load() || WorkEpoch.load() != Epoch; });
+        NumSleepingWorkers.fetch_sub(1u);
+        IdleCount = 0u;
+    }
+}
+
+void FJobSystem::Schedule(FJob* Job)
+{
+    if (GCurrentJobSystem == this && GCurrentWorkerIndex != INVALID_WORKER)
+    {
+        Queues[GCurrentWorkerIndex]->Push(Job);
+    }
+    else
+    {
+        std::lock_guard Lock(InjectionMutex);
+        InjectionQueue.push_back(Job);
+        NumInjectedJobs.fetch_add(1u);
+    }
+
+    WorkEpoch.fetch_add(1u);
+    if (NumSleepingWorkers.load() > 0u)
+    {
+        std::lock_guard Lock(SleepMutex);
+        SleepCondition.notify_one();
+    }
+}
+
+FJob* FJobSystem::FindJob(uint32_t WorkerIndex)
+{
+    if (WorkerIndex != INVALID_WORKER)
+    {
+        if (FJob* Job = Queues[WorkerIndex]->Pop())
+        {
+            return Job;
+        }
+    }
+
+    if (NumInjectedJobs.load(std::memory_order_relaxed) > 0u)
+    {
+        std::lock_guard Lock(InjectionMutex);
+        if (!InjectionQueue.empty())
+        {
+            FJob* Job = InjectionQueue.front();
+            InjectionQueue.pop_front();
+            NumInjectedJobs.fetch_sub(1u);
+            return Job;
+        }
+    }
+
+    // Start at a different victim per worker so thieves do not all hammer queue 0.
+    const uint32_t NumQueues = GetNumWorkers();
+    const uint32_t FirstVictim = WorkerIndex != INVALID_WORKER ? WorkerIndex + 1u : 0u;
+    for (uint32_t i = 0; i < NumQueues; i++)
+    {
+        const uint32_t Victim = (FirstVictim + i) % NumQueues;
+        if (Victim == WorkerIndex)
+        {
+            continue;
+        }
+
+        if (FJob* Job = Queues[Victim]->Steal())
+        {
+            return Job;
+        }
+    }
+
+    return nullptr;
+}
+
+void FJobSystem::Execute(FJob* Job)
+{
+    Job->Function();
+    FinishJob(Job->Counter);
+    delete Job;
+}
+
+void FJobSystem::FinishJob(FJobCounter* Counter)
+{
+    if (!Counter)
+    {
+        return;
+    }
+
+    Counter->Busy.fetch_add(1u);
+    if (Counter->Pending.fetch_sub(1u) == 1u)
+    {
+        std::vector<FJob*> Continuations;
+        {
+            std::lock_guard Lock(Counter->ContinuationMutex);
+            Continuations.swap(Counter->Continuations);
+        }
+
+        for (FJob* Continuation : Continuations)
+        {
+            Schedule(Continuation);
+        }
+    }
+    // Last access, the owner may destroy the counter right after this.
+    Counter->Busy.fetch_sub(1u);
+}
+
+void CreateJobSystem(uint32_t NumWorkers)
+{
+    assert(GJobSystem == nullptr);
+    GJobSystem = new FJobSystem(NumWorkers);
+}
+
+void ReleaseJobSystem()
+{
+    delete GJobSystem;
+    GJobSystem = nullptr;
+}
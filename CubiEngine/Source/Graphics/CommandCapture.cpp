@@ -0,0 +1,587 @@
+#include "Graphics/CommandCapture.h"
+#include "Graphics/Context.h"
+#include "Graphics/D3D12DynamicRHI.h"
+#include "Graphics/DescriptorHeap.h"
+#include "Graphics/Query.h"
+#include "WinPixEventRuntime/pix3.h"
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+
+namespace
+{
+    constexpr uint32_t CAPTURE_FILE_MAGIC = 0x50414343; // "CCAP"
+    // Version 3 appends the object table.
+    constexpr uint32_t CAPTURE_FILE_VERSION = 3u;
+
+    size_t AlignPayloadSize(size_t Size)
+    {
+        return (Size + 7u) & ~size_t(7u);
+    }
+
+    template<typename T>
+    const T& As(const uint8_t* Payload)
+    {
+        return *reinterpret_cast<const T*>(Payload);
+    }
+
+    // Size of the fixed part of every payload, the trailing arrays are checked by IsCapturedPayloadValid.
+    size_t GetMinPayloadSize(ECapturedCommand Command)
+    {
+        switch (Command)
+        {
+        case ECapturedCommand::SetPipelineState:
+        case ECapturedCommand::SetRaytracingPipelineState:
+        case ECapturedCommand::SetGraphicsRootSignature:
+        case ECapturedCommand::SetComputeRootSignature:
+        case ECapturedCommand::DiscardResource: return sizeof(Capture::FObject);
+        case ECapturedCommand::SetRoot32BitConstants: return sizeof(Capture::FRoot32BitConstants);
+        case ECapturedCommand::SetComputeRootShaderResourceView:
+        case ECapturedCommand::SetComputeRootDescriptorTable: return sizeof(Capture::FRootAddress);
+        case ECapturedCommand::SetRenderTargets: return sizeof(Capture::FRenderTargets);
+        case ECapturedCommand::ClearRenderTargetView: return sizeof(Capture::FClearRenderTarget);
+        case ECapturedCommand::ClearUnorderedAccessViewFloat: return sizeof(Capture::FClearUnorderedAccessView);
+        case ECapturedCommand::ClearDepthStencilView: return sizeof(Capture::FClearDepthStencil);
+        case ECapturedCommand::SetViewport: return sizeof(Capture::FViewport);
+        case ECapturedCommand::SetScissorRect: return sizeof(Capture::FScissorRect);
+        case ECapturedCommand::SetPrimitiveTopology: return sizeof(Capture::FPrimitiveTopology);
+        case ECapturedCommand::SetIndexBuffer: return sizeof(Capture::FIndexBuffer);
+        case ECapturedCommand::DrawIndexedInstanced: return sizeof(Capture::FDrawIndexedInstanced);
+        case ECapturedCommand::DrawInstanced: return sizeof(Capture::FDrawInstanced);
+        case ECapturedCommand::ExecuteIndirect: return sizeof(Capture::FExecuteIndirect);
+        case ECapturedCommand::Dispatch: return sizeof(Capture::FDispatch);
+        case ECapturedCommand::DispatchRays: return sizeof(Capture::FDispatchRays);
+        case ECapturedCommand::CopyResource: return sizeof(Capture::FCopyResource);
+        case ECapturedCommand::CopyTextureRegion: return sizeof(Capture::FCopyTextureRegion);
+        case ECapturedCommand::ResourceBarriers: return sizeof(uint32_t);
+        case ECapturedCommand::BeginQuery:
+        case ECapturedCommand::EndQuery: return sizeof(Capture::FQuery);
+        case ECapturedCommand::ResolveQueryData: return sizeof(Capture::FResolveQueryData);
+        case ECapturedCommand::CreateResource: return sizeof(Capture::FCreateResource);
+        default: return 0u;
+        }
+    }
+
+    // Differs between processes, so a saved object table is only trusted by the process that wrote it.
+    uint64_t GetProcessCaptureToken()
+    {
+        static const uint64_t Token = (static_cast<uint64_t>(std::random_device{}()) << 32u)
+            ^ static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        return Token;
+    }
+
+    D3D12_TEXTURE_COPY_LOCATION ToCopyLocation(const Capture::FCopyLocation& Location, ID3D12Resource* Resource)
+    {
+        D3D12_TEXTURE_COPY_LOCATION Result{ .pResource = Resource, .Type = static_cast<D3D12_TEXTURE_COPY_TYPE>(Location.Type) };
+        if (Result.Type == D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX)
+        {
+            Result.SubresourceIndex = Location.SubresourceIndex;
+        }
+        else
+        {
+            Result.PlacedFootprint = D3D12_PLACED_SUBRESOURCE_FOOTPRINT{
+                .Offset = Location.Offset,
+                .Footprint = {
+                    .Format = static_cast<DXGI_FORMAT>(Location.Format),
+                    .Width = Location.Width,
+                    .Height = Location.Height,
+                    .Depth = Location.Depth,
+                    .RowPitch = Location.RowPitch,
+                },
+            };
+        }
+        return Result;
+    }
+}
+
+const char* GetCapturedCommandName(ECapturedCommand Command)
+{
+    static constexpr const char* Names[] = {
+        "ContextReset", "SetDescriptorHeaps", "SetPipelineState", "SetRaytracingPipelineState",
+        "SetGraphicsRootSignature", "SetComputeRootSignature", "SetRoot32BitConstants",
+        "SetComputeRootShaderResourceView", "SetComputeRootDescriptorTable", "SetRenderTargets",
+        "ClearRenderTargetView", "ClearUnorderedAccessViewFloat", "ClearDepthStencilView", "SetViewport",
+        "SetScissorRect", "SetPrimitiveTopology", "SetIndexBuffer", "DrawIndexedInstanced", "DrawInstanced",
+        "ExecuteIndirect", "Dispatch", "DispatchRays", "CopyResource", "CopyTextureRegion", "ResourceBarriers",
+        "BeginQuery", "EndQuery", "ResolveQueryData", "BeginEvent", "EndEvent", "CreateResource", "DiscardResource",
+    };
+    static_assert(_countof(Names) == static_cast<size_t>(ECapturedCommand::Count));
+
+    return Command < ECapturedCommand::Count ? Names[static_cast<size_t>(Command)] : "Unknown";
+}
+
+bool IsCapturedPayloadValid(const FCapturedCommandHeader& Header, const uint8_t* Payload)
+{
+    if (Header.Type >= ECapturedCommand::Count || Header.PayloadSize < GetMinPayloadSize(Header.Type))
+    {
+        return false;
+    }
+
+    switch (Header.Type)
+    {
+    case ECapturedCommand::SetRoot32BitConstants:
+        return Header.PayloadSize >= sizeof(Capture::FRoot32BitConstants)
+            + size_t(As<Capture::FRoot32BitConstants>(Payload).Num32BitValues) * sizeof(uint32_t);
+    case ECapturedCommand::SetRenderTargets:
+        return As<Capture::FRenderTargets>(Payload).NumRtvs <= _countof(Capture::FRenderTargets::RtvIndices);
+    case ECapturedCommand::ResourceBarriers:
+        return Header.PayloadSize >= sizeof(uint32_t) + size_t(As<uint32_t>(Payload)) * sizeof(Capture::FBarrier);
+    default:
+        return true;
+    }
+}
+
+Capture::FObjectId FCommandCapture::GetObjectId(const void* Object)
+{
+    if (!Object)
+    {
+        return Capture::NULL_OBJECT;
+    }
+
+    std::lock_guard Lock(Mutex);
+    auto [It, bInserted] = ObjectIds.try_emplace(Object, static_cast<Capture::FObjectId>(Objects.size()));
+    if (bInserted)
+    {
+        Objects.push_back(Object);
+    }
+    return It->second;
+}
+
+const void* FCommandCapture::GetObject(Capture::FObjectId Id) const
+{
+    std::lock_guard Lock(Mutex);
+    return Id < Objects.size() ? Objects[Id] : nullptr;
+}
+
+uint32_t FCommandCapture::GetNumObjects() const
+{
+    std::lock_guard Lock(Mutex);
+    return static_cast<uint32_t>(Objects.size());
+}
+
+void FCommandCapture::BindObject(Capture::FObjectId Id, const void* Object)
+{
+    assert(Id != Capture::NULL_OBJECT && Object);
+
+    std::lock_guard Lock(Mutex);
+    if (Id >= Objects.size())
+    {
+        Objects.resize(Id + 1u, nullptr);
+    }
+    if (Objects[Id])
+    {
+        ObjectIds.erase(Objects[Id]);
+    }
+    Objects[Id] = Object;
+    ObjectIds[Object] = Id;
+}
+
+bool FCommandCapture::AreAllObjectsBound() const
+{
+    std::lock_guard Lock(Mutex);
+    return std::find(Objects.begin() + 1, Objects.end(), nullptr) == Objects.end();
+}
+
+void FCommandCapture::Record(uint32_t ContextId, ECapturedCommand Type, const void* Payload, size_t PayloadSize)
+{
+    assert(PayloadSize <= UINT16_MAX);
+
+    const FCapturedCommandHeader Header{
+        .Type = Type,
+        .Reserved = 0u,
+        .PayloadSize = static_cast<uint16_t>(PayloadSize),
+        .ContextId = ContextId,
+    };
+
+    std::lock_guard Lock(Mutex);
+    const uint8_t* HeaderBytes = reinterpret_cast<const uint8_t*>(&Header);
+    Stream.insert(Stream.end(), HeaderBytes, HeaderBytes + sizeof(Header));
+    if (PayloadSize > 0u)
+    {
+        const uint8_t* PayloadBytes = static_cast<const uint8_t*>(Payload);
+        Stream.insert(Stream.end(), PayloadBytes, PayloadBytes + PayloadSize);
+    }
+    // Keeps every header and payload 8 byte aligned, padding is zeroed so the bytes stay deterministic.
+    Stream.resize(AlignPayloadSize(Stream.size()), 0u);
+    NumCommands++;
+}
+
+bool FCommandCapture::SaveToFile(const std::string& Path) const
+{
+    std::ofstream File(Path, std::ios::binary);
+    if (!File)
+    {
+        Log(std::format("Failed to open {} to save the command capture.", Path));
+        return false;
+    }
+
+    std::lock_guard Lock(Mutex);
+    const uint32_t FileHeader[] = {
+        CAPTURE_FILE_MAGIC, CAPTURE_FILE_VERSION, NumCommands, static_cast<uint32_t>(Stream.size()),
+        static_cast<uint32_t>(Objects.size()), 0u,
+    };
+    const uint64_t ProcessToken = GetProcessCaptureToken();
+    File.write(reinterpret_cast<const char*>(FileHeader), sizeof(FileHeader));
+    File.write(reinterpret_cast<const char*>(&ProcessToken), sizeof(ProcessToken));
+    File.write(reinterpret_cast<const char*>(Stream.data()), Stream.size());
+
+    // Index 0 is NULL_OBJECT and written as 0 like any other unbound entry.
+    for (const void* Object : Objects)
+    {
+        const uint64_t Address = reinterpret_cast<uint64_t>(Object);
+        File.write(reinterpret_cast<const char*>(&Address), sizeof(Address));
+    }
+    return File.good();
+}
+
+bool FCommandCapture::LoadFromFile(const std::string& Path)
+{
+    std::ifstream File(Path, std::ios::binary);
+    uint32_t FileHeader[6]{};
+    uint64_t ProcessToken = 0u;
+    if (!File || !File.read(reinterpret_cast<char*>(FileHeader), sizeof(FileHeader))
+        || !File.read(reinterpret_cast<char*>(&ProcessToken), sizeof(ProcessToken))
+        || FileHeader[0] != CAPTURE_FILE_MAGIC || FileHeader[1] != CAPTURE_FILE_VERSION || FileHeader[4] == 0u)
+    {
+        Log(std::format("{} is not a command capture.", Path));
+        return false;
+    }
+
+    std::vector<uint8_t> LoadedStream(FileHeader[3]);
+    std::vector<uint64_t> Addresses(FileHeader[4]);
+    if (!File.read(reinterpret_cast<char*>(LoadedStream.data()), LoadedStream.size())
+        || !File.read(reinterpret_cast<char*>(Addresses.data()), Addresses.size() * sizeof(uint64_t)))
+    {
+        Log(std::format("{} is truncated.", Path));
+        return false;
+    }
+
+    std::lock_guard Lock(Mutex);
+    NumCommands = FileHeader[2];
+    Stream = std::move(LoadedStream);
+
+    // Addresses are only live objects in the process that saved the capture. Elsewhere the ids are kept
+    // unbound so they still line up with the stream, and BindObject fills them in.
+    const bool bSameProcess = ProcessToken == GetProcessCaptureToken();
+    ObjectIds.clear();
+    Objects.assign(Addresses.size(), nullptr);
+    for (size_t Id = 1u; bSameProcess && Id < Addresses.size(); Id++)
+    {
+        Objects[Id] = reinterpret_cast<const void*>(Addresses[Id]);
+        ObjectIds.emplace(Objects[Id], static_cast<Capture::FObjectId>(Id));
+    }
+    return true;
+}
+
+void FRecordingCommandSink::Execute(const FCapturedCommandHeader& Header, const uint8_t* Payload)
+{
+    Target.Record(Header.ContextId, Header.Type, Payload, Header.PayloadSize);
+}
+
+FD3D12CommandSink::FD3D12CommandSink(const FCommandCapture& InSource, FContext* InContext)
+    : Source(InSource), Context(InContext), bObjectsBound(InSource.AreAllObjectsBound())
+{
+    if (!bObjectsBound)
+    {
+        Log("Command capture has unbound object ids, nothing will be replayed onto the context.");
+    }
+}
+
+void FD3D12CommandSink::Execute(const FCapturedCommandHeader& Header, const uint8_t* Payload)
+{
+    if (!bObjectsBound)
+    {
+        return;
+    }
+    if (!IsCapturedPayloadValid(Header, Payload))
+    {
+        Log(std::format("Dropped {} with a {} byte payload.", GetCapturedCommandName(Header.Type), Header.PayloadSize));
+        return;
+    }
+
+    ID3D12GraphicsCommandList4* CommandList = Context->GetD3D12CommandList();
+
+    switch (Header.Type)
+    {
+    case ECapturedCommand::SetDescriptorHeaps:
+    {
+        ID3D12DescriptorHeap* const DescriptorHeaps[] = {
+            RHIGetCbvSrvUavDescriptorHeap()->GetD3D12DescriptorHeap(),
+            RHIGetSamplerDescriptorHeap()->GetD3D12DescriptorHeap(),
+        };
+        CommandList->SetDescriptorHeaps(_countof(DescriptorHeaps), DescriptorHeaps);
+        break;
+    }
+    case ECapturedCommand::SetPipelineState:
+        CommandList->SetPipelineState(Resolve<ID3D12PipelineState>(As<Capture::FObject>(Payload).Id));
+        break;
+    case ECapturedCommand::SetRaytracingPipelineState:
+        CommandList->SetPipelineState1(Resolve<ID3D12StateObject>(As<Capture::FObject>(Payload).Id));
+        break;
+    case ECapturedCommand::SetGraphicsRootSignature:
+        CommandList->SetGraphicsRootSignature(Resolve<ID3D12RootSignature>(As<Capture::FObject>(Payload).Id));
+        break;
+    case ECapturedCommand::SetComputeRootSignature:
+        CommandList->SetComputeRootSignature(Resolve<ID3D12RootSignature>(As<Capture::FObject>(Payload).Id));
+        break;
+    case ECapturedCommand::SetRoot32BitConstants:
+    {
+        const Capture::FRoot32BitConstants& Constants = As<Capture::FRoot32BitConstants>(Payload);
+        const uint8_t* Values = Payload + sizeof(Capture::FRoot32BitConstants);
+        if (Constants.bGraphics)
+        {
+            CommandList->SetGraphicsRoot32BitConstants(Constants.RootParameterIndex, Constants.Num32BitValues, Values, Constants.DestOffsetIn32BitValues);
+        }
+        else
+        {
+            CommandList->SetComputeRoot32BitConstants(Constants.RootParameterIndex, Constants.Num32BitValues, Values, Constants.DestOffsetIn32BitValues);
+        }
+        break;
+    }
+    case ECapturedCommand::SetComputeRootShaderResourceView:
+    {
+        const Capture::FRootAddress& Root = As<Capture::FRootAddress>(Payload);
+        CommandList->SetComputeRootShaderResourceView(Root.RootParameterIndex, Root.Address);
+        break;
+    }
+    case ECapturedCommand::SetComputeRootDescriptorTable:
+    {
+        const Capture::FRootAddress& Root = As<Capture::FRootAddress>(Payload);
+        CommandList->SetComputeRootDescriptorTable(Root.RootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE{ .ptr = Root.Address });
+        break;
+    }
+    case ECapturedCommand::SetRenderTargets:
+    {
+        const Capture::FRenderTargets& Targets = As<Capture::FRenderTargets>(Payload);
+        std::array<D3D12_CPU_DESCRIPTOR_HANDLE, 8u> RtvHandles{};
+        for (uint32_t i = 0; i < Targets.NumRtvs; i++)
+        {
+            RtvHandles[i] = RHIGetRtvDescriptorHeap()->GetDescriptorHandleFromIndex(Targets.RtvIndices[i]).CpuDescriptorHandle;
+        }
+
+        D3D12_CPU_DESCRIPTOR_HANDLE DsvHandle{};
+        if (Targets.DsvIndex != INVALID_INDEX_U32)
+        {
+            DsvHandle = RHIGetDsvDescriptorHeap()->GetDescriptorHandleFromIndex(Targets.DsvIndex).CpuDescriptorHandle;
+        }
+
+        CommandList->OMSetRenderTargets(Targets.NumRtvs, Targets.NumRtvs > 0u ? RtvHandles.data() : nullptr, FALSE,
+            Targets.DsvIndex != INVALID_INDEX_U32 ? &DsvHandle : nullptr);
+        break;
+    }
+    case ECapturedCommand::ClearRenderTargetView:
+    {
+        const Capture::FClearRenderTarget& Clear = As<Capture::FClearRenderTarget>(Payload);
+        CommandList->ClearRenderTargetView(
+            RHIGetRtvDescriptorHeap()->GetDescriptorHandleFromIndex(Clear.RtvIndex).CpuDescriptorHandle, Clear.Color, 0u, nullptr);
+        break;
+    }
+    case ECapturedCommand::ClearUnorderedAccessViewFloat:
+    {
+        const Capture::FClearUnorderedAccessView& Clear = As<Capture::FClearUnorderedAccessView>(Payload);
+        const FDescriptorHandle UavHandle = RHIGetCbvSrvUavDescriptorHeap()->GetDescriptorHandleFromIndex(Clear.UavIndex);
+        CommandList->ClearUnorderedAccessViewFloat(UavHandle.GpuDescriptorHandle, UavHandle.CpuDescriptorHandle,
+            Resolve<ID3D12Resource>(Clear.Resource), Clear.Color, 0u, nullptr);
+        break;
+    }
+    case ECapturedCommand::ClearDepthStencilView:
+        CommandList->ClearDepthStencilView(
+            RHIGetDsvDescriptorHeap()->GetDescriptorHandleFromIndex(As<Capture::FClearDepthStencil>(Payload).DsvIndex).CpuDescriptorHandle,
+            D3D12_CLEAR_FLAG_DEPTH, 0.0f, 1u, 0u, nullptr);
+        break;
+    case ECapturedCommand::SetViewport:
+    {
+        const Capture::FViewport& Viewport = As<Capture::FViewport>(Payload);
+        const D3D12_VIEWPORT D3D12Viewport{ Viewport.TopLeftX, Viewport.TopLeftY, Viewport.Width, Viewport.Height, Viewport.MinDepth, Viewport.MaxDepth };
+        CommandList->RSSetViewports(1u, &D3D12Viewport);
+        break;
+    }
+    case ECapturedCommand::SetScissorRect:
+    {
+        const Capture::FScissorRect& Rect = As<Capture::FScissorRect>(Payload);
+        const D3D12_RECT D3D12Rect{ .left = Rect.Left, .top = Rect.Top, .right = Rect.Right, .bottom = Rect.Bottom };
+        CommandList->RSSetScissorRects(1u, &D3D12Rect);
+        break;
+    }
+    case ECapturedCommand::SetPrimitiveTopology:
+        CommandList->IASetPrimitiveTopology(static_cast<D3D_PRIMITIVE_TOPOLOGY>(As<Capture::FPrimitiveTopology>(Payload).Topology));
+        break;
+    case ECapturedCommand::SetIndexBuffer:
+    {
+        const Capture::FIndexBuffer& IndexBuffer = As<Capture::FIndexBuffer>(Payload);
+        const D3D12_INDEX_BUFFER_VIEW View{
+            .BufferLocation = Resolve<ID3D12Resource>(IndexBuffer.Resource)->GetGPUVirtualAddress(),
+            .SizeInBytes = IndexBuffer.SizeInBytes,
+            .Format = DXGI_FORMAT_R32_UINT,
+        };
+        CommandList->IASetIndexBuffer(&View);
+        break;
+    }
+    case ECapturedCommand::DrawIndexedInstanced:
+    {
+        const Capture::FDrawIndexedInstanced& Draw = As<Capture::FDrawIndexedInstanced>(Payload);
+        CommandList->DrawIndexedInstanced(Draw.IndexCount, Draw.InstanceCount, Draw.StartIndex, 0u, 0u);
+        break;
+    }
+    case ECapturedCommand::DrawInstanced:
+    {
+        const Capture::FDrawInstanced& Draw = As<Capture::FDrawInstanced>(Payload);
+        CommandList->DrawInstanced(Draw.VertexCount, Draw.InstanceCount, Draw.StartVertex, Draw.StartInstance);
+        break;
+    }
+    case ECapturedCommand::ExecuteIndirect:
+    {
+        const Capture::FExecuteIndirect& Indirect = As<Capture::FExecuteIndirect>(Payload);
+        CommandList->ExecuteIndirect(Resolve<ID3D12CommandSignature>(Indirect.CommandSignature), Indirect.MaxCommandCount,
+            Resolve<ID3D12Resource>(Indirect.ArgumentBuffer), Indirect.ArgumentBufferOffset, nullptr, 0u);
+        break;
+    }
+    case ECapturedCommand::Dispatch:
+    {
+        const Capture::FDispatch& Dispatch = As<Capture::FDispatch>(Payload);
+        CommandList->Dispatch(Dispatch.X, Dispatch.Y, Dispatch.Z);
+        break;
+    }
+    case ECapturedCommand::DispatchRays:
+    {
+        const Capture::FDispatchRays& Rays = As<Capture::FDispatchRays>(Payload);
+        const D3D12_DISPATCH_RAYS_DESC Desc{
+            .RayGenerationShaderRecord = { Rays.Addresses[0], Rays.Addresses[1] },
+            .MissShaderTable = { Rays.Addresses[2], Rays.Addresses[3], Rays.Addresses[4] },
+            .HitGroupTable = { Rays.Addresses[5], Rays.Addresses[6], Rays.Addresses[7] },
+            .CallableShaderTable = { Rays.Addresses[8], Rays.Addresses[9], Rays.Addresses[10] },
+            .Width = Rays.Width,
+            .Height = Rays.Height,
+            .Depth = Rays.Depth,
+        };
+        CommandList->DispatchRays(&Desc);
+        break;
+    }
+    case ECapturedCommand::CopyResource:
+    {
+        const Capture::FCopyResource& Copy = As<Capture::FCopyResource>(Payload);
+        CommandList->CopyResource(Resolve<ID3D12Resource>(Copy.Destination), Resolve<ID3D12Resource>(Copy.Source));
+        break;
+    }
+    case ECapturedCommand::CopyTextureRegion:
+    {
+        const Capture::FCopyTextureRegion& Copy = As<Capture::FCopyTextureRegion>(Payload);
+        const D3D12_TEXTURE_COPY_LOCATION Destination = ToCopyLocation(Copy.Destination, Resolve<ID3D12Resource>(Copy.Destination.Resource));
+        const D3D12_TEXTURE_COPY_LOCATION Source = ToCopyLocation(Copy.Source, Resolve<ID3D12Resource>(Copy.Source.Resource));
+        const D3D12_BOX Box{ Copy.SourceBox[0], Copy.SourceBox[1], Copy.SourceBox[2], Copy.SourceBox[3], Copy.SourceBox[4], Copy.SourceBox[5] };
+        CommandList->CopyTextureRegion(&Destination, Copy.DstX, Copy.DstY, Copy.DstZ, &Source, Copy.bHasSourceBox ? &Box : nullptr);
+        break;
+    }
+    case ECapturedCommand::ResourceBarriers:
+    {
+        const uint32_t NumBarriers = As<uint32_t>(Payload);
+        const Capture::FBarrier* Barriers = reinterpret_cast<const Capture::FBarrier*>(Payload + sizeof(uint32_t));
+
+        std::vector<D3D12_RESOURCE_BARRIER> D3D12Barriers(NumBarriers);
+        for (uint32_t i = 0; i < NumBarriers; i++)
+        {
+            const Capture::FBarrier& Barrier = Barriers[i];
+            D3D12_RESOURCE_BARRIER& D3D12Barrier = D3D12Barriers[i];
+            D3D12Barrier.Type = static_cast<D3D12_RESOURCE_BARRIER_TYPE>(Barrier.Type);
+            D3D12Barrier.Flags = static_cast<D3D12_RESOURCE_BARRIER_FLAGS>(Barrier.Flags);
+            if (D3D12Barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION)
+            {
+                D3D12Barrier.Transition = {
+                    .pResource = Resolve<ID3D12Resource>(Barrier.Resource),
+                    .Subresource = Barrier.Subresource,
+                    .StateBefore = static_cast<D3D12_RESOURCE_STATES>(Barrier.StateBefore),
+                    .StateAfter = static_cast<D3D12_RESOURCE_STATES>(Barrier.StateAfter),
+                };
+            }
+            else if (D3D12Barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_ALIASING)
+            {
+                D3D12Barrier.Aliasing = {
+                    .pResourceBefore = Resolve<ID3D12Resource>(Barrier.Resource),
+                    .pResourceAfter = Resolve<ID3D12Resource>(Barrier.ResourceAfter),
+                };
+            }
+            else
+            {
+                D3D12Barrier.UAV = { .pResource = Resolve<ID3D12Resource>(Barrier.Resource) };
+            }
+        }
+        CommandList->ResourceBarrier(NumBarriers, D3D12Barriers.data());
+        break;
+    }
+    case ECapturedCommand::BeginQuery:
+    case ECapturedCommand::EndQuery:
+    {
+        const Capture::FQuery& Query = As<Capture::FQuery>(Payload);
+        ID3D12QueryHeap* QueryHeap = Resolve<FQueryHeap>(Query.Heap)->GetD3D12QueryHeap();
+        if (Header.Type == ECapturedCommand::BeginQuery)
+        {
+            CommandList->BeginQuery(QueryHeap, static_cast<D3D12_QUERY_TYPE>(Query.Type), Query.Index);
+        }
+        else
+        {
+            CommandList->EndQuery(QueryHeap, static_cast<D3D12_QUERY_TYPE>(Query.Type), Query.Index);
+        }
+        break;
+    }
+    case ECapturedCommand::ResolveQueryData:
+    {
+        const Capture::FResolveQueryData& Resolved = As<Capture::FResolveQueryData>(Payload);
+        FQueryHeap* Heap = Resolve<FQueryHeap>(Resolved.Heap);
+        CommandList->ResolveQueryData(Heap->GetD3D12QueryHeap(), static_cast<D3D12_QUERY_TYPE>(Resolved.Type),
+            Resolved.StartIndex, Resolved.NumQueries, Heap->GetQueryReadbackBuffer(), Resolved.DestinationOffset);
+        break;
+    }
+    case ECapturedCommand::BeginEvent:
+    {
+        const std::string Name(reinterpret_cast<const char*>(Payload), Header.PayloadSize);
+        PIXBeginEvent(CommandList, PIX_COLOR(255, 255, 255), Name.c_str());
+        break;
+    }
+    case ECapturedCommand::EndEvent:
+        PIXEndEvent(CommandList);
+        break;
+    case ECapturedCommand::DiscardResource:
+        CommandList->DiscardResource(Resolve<ID3D12Resource>(As<Capture::FObject>(Payload).Id), nullptr);
+        break;
+    case ECapturedCommand::ContextReset:
+    case ECapturedCommand::CreateResource:
+    default:
+        // The target context is reset by the caller, resources already exist in this process.
+        break;
+    }
+}
+
+FReplayStats ReplayCommandStream(const std::vector<uint8_t>& Stream, FCommandSink& Sink)
+{
+    FReplayStats Stats{};
+    std::chrono::high_resolution_clock Clock{};
+
+    size_t Offset = 0u;
+    while (Offset + sizeof(FCapturedCommandHeader) <= Stream.size())
+    {
+        FCapturedCommandHeader Header;
+        std::memcpy(&Header, Stream.data() + Offset, sizeof(Header));
+        Offset += sizeof(Header);
+
+        if (Offset + Header.PayloadSize > Stream.size() || Header.Type >= ECapturedCommand::Count)
+        {
+            Log("Truncated or corrupt command stream, replay stopped.");
+            break;
+        }
+
+        const std::chrono::high_resolution_clock::time_point Start = Clock.now();
+        Sink.Execute(Header, Stream.data() + Offset);
+        const double Ms = std::chrono::duration<double, std::milli>(Clock.now() - Start).count();
+
+        FReplayStats::FCommandTiming& Timing = Stats.PerCommand[static_cast<size_t>(Header.Type)];
+        Timing.Count++;
+        Timing.TotalMs += Ms;
+        Stats.NumCommands++;
+        Stats.TotalMs += Ms;
+
+        Offset += AlignPayloadSize(Header.PayloadSize);
+    }
+
+    return Stats;
+}
@@ -1,8 +1,8 @@
 #include "Graphics/CommandQueue.h"
 
 FCommandQueue::FCommandQueue(ID3D12Device5* const device, const D3D12_COMMAND_LIST_TYPE commandListType,
-    const std::wstring_view name)
-    : CommandQueueFenceValue(0)
+    const std::wstring_view name, FResourceStateTable* const StateTable)
+    : Device(device), CommandListType(commandListType), ResourceStateTable(StateTable), CommandQueueFenceValue(0)
 {
     // Create the command queue based on list type.
     const D3D12_COMMAND_QUEUE_DESC commandQueueDesc = {
@@ -16,16 +16,24 @@ FCommandQueue::FCommandQueue(ID3D12Device5* const device, const D3D12_COMMAND_LI
     D3D12CommandQueue->SetName(name.data());
 
     // Create the fence (used for synchronization of CPU and GPU).
-    ThrowIfFailed(device->CreateFence(0u, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&Fence)));
-    Fence->SetName(name.data());
+    Fence = std::make_unique<FD3D12Fence>(device, name);
+    FenceWatcher = std::make_unique<FFenceWatcher>(*Fence);
+}
+
+FCommandQueue::~FCommandQueue()
+{
+    // Completion callbacks recycle contexts and free memory, run every one of them before the watcher thread
+    // stops. The watcher thread uses the fence, stop it before the fence goes.
+    Flush();
+    FenceWatcher.reset();
 }
 
 uint64_t FCommandQueue::Signal()
 {
-    CommandQueueFenceValue++;
-    ThrowIfFailed(D3D12CommandQueue->Signal(Fence.Get(), CommandQueueFenceValue));
+    const uint64_t FenceValue = ++CommandQueueFenceValue;
+    ThrowIfFailed(D3D12CommandQueue->Signal(Fence->GetD3D12Fence(), FenceValue));
 
-    return CommandQueueFenceValue;
+    return FenceValue;
 }
 
 bool FCommandQueue::IsFenceComplete(const uint64_t InFenceValue) const
@@ -33,11 +41,16 @@ bool FCommandQueue::IsFenceComplete(const uint64_t InFenceValue) const
     return Fence->GetCompletedValue() >= InFenceValue;
 }
 
+uint64_t FCommandQueue::GetCompletedFenceValue() const
+{
+    return Fence->GetCompletedValue();
+}
+
 void FCommandQueue::WaitForFenceValue(const uint64_t InFenceValue)
 {
     while (!IsFenceComplete(InFenceValue))
     {
-        ThrowIfFailed(Fence->SetEventOnCompletion(InFenceValue, nullptr));
+        ThrowIfFailed(Fence->GetD3D12Fence()->SetEventOnCompletion(InFenceValue, nullptr));
     }
     //if (!IsFenceComplete(InFenceValue))
     //{
@@ -45,6 +58,16 @@ void FCommandQueue::WaitForFenceValue(const uint64_t InFenceValue)
     //}
 }
 
+void FCommandQueue::WaitForQueue(const FCommandQueue& Other, const uint64_t InFenceValue)
+{
+    ThrowIfFailed(D3D12CommandQueue->Wait(Other.Fence->GetD3D12Fence(), InFenceValue));
+}
+
+void FCommandQueue::OnFenceCompletion(const uint64_t InFenceValue, std::function<void()> Callback)
+{
+    FenceWatcher->OnCompletion(InFenceValue, std::move(Callback));
+}
+
 void FCommandQueue::GetTimestampFrequency(UINT64* GpuFrequency)
 {
     D3D12CommandQueue->GetTimestampFrequency(GpuFrequency);
@@ -52,16 +75,71 @@ void FCommandQueue::GetTimestampFrequency(UINT64* GpuFrequency)
 
 void FCommandQueue::ExecuteContext(FContext* Context)
 {
+    if (PreExecuteCallback)
+    {
+        PreExecuteCallback();
+    }
+
     std::vector<ID3D12CommandList*> CommandLists{};
+    FBarrierCommandList* BarrierCommandList = nullptr;
 
     ThrowIfFailed(Context->GetD3D12CommandList()->Close());
+
+    // Resources the submissions so far left in another state than the context expects go there first.
+    if (ResourceStateTable)
+    {
+        std::vector<D3D12_RESOURCE_BARRIER> PendingBarriers{};
+        Context->ResolvePendingBarriers(*ResourceStateTable, PendingBarriers);
+        if (!PendingBarriers.empty())
+        {
+            BarrierCommandList = RecordPendingBarriers(PendingBarriers);
+            CommandLists.emplace_back(BarrierCommandList->CommandList.Get());
+        }
+    }
     CommandLists.emplace_back(Context->GetD3D12CommandList());
 
     D3D12CommandQueue->ExecuteCommandLists(CommandLists.size(), CommandLists.data());
+
+    if (BarrierCommandList)
+    {
+        // Signaled here rather than guessed before submitting, another thread may signal the queue in between.
+        const uint64_t FenceValue = Signal();
+        std::scoped_lock Lock(BarrierCommandListMutex);
+        BarrierCommandList->FenceValue = FenceValue;
+    }
+}
+
+FCommandQueue::FBarrierCommandList* FCommandQueue::RecordPendingBarriers(std::span<const D3D12_RESOURCE_BARRIER> Barriers)
+{
+    std::scoped_lock Lock(BarrierCommandListMutex);
+
+    auto Found = std::find_if(BarrierCommandLists.begin(), BarrierCommandLists.end(), [this](const FBarrierCommandList& List) {
+        return IsFenceComplete(List.FenceValue);
+    });
+    if (Found == BarrierCommandLists.end())
+    {
+        FBarrierCommandList& List = BarrierCommandLists.emplace_back();
+        ThrowIfFailed(Device->CreateCommandAllocator(CommandListType, IID_PPV_ARGS(&List.CommandAllocator)));
+        ThrowIfFailed(Device->CreateCommandList(0u, CommandListType, List.CommandAllocator.Get(), nullptr, IID_PPV_ARGS(&List.CommandList)));
+        List.CommandList->SetName(L"Pending Barrier Command List");
+        Found = std::prev(BarrierCommandLists.end());
+    }
+    else
+    {
+        ThrowIfFailed(Found->CommandAllocator->Reset());
+        ThrowIfFailed(Found->CommandList->Reset(Found->CommandAllocator.Get(), nullptr));
+    }
+
+    Found->CommandList->ResourceBarrier(static_cast<UINT>(Barriers.size()), Barriers.data());
+    ThrowIfFailed(Found->CommandList->Close());
+    Found->FenceValue = UINT64_MAX;
+
+    return &*Found;
 }
 
 void FCommandQueue::Flush()
 {
     const uint64_t FenceValue = Signal();
     WaitForFenceValue(FenceValue);
+    FenceWatcher->WaitForCallbacks(FenceValue);
 }
@@ -29,6 +29,11 @@ void FComputeContext::SetDescriptorHeaps() const
     };
 
     D3D12CommandList->SetDescriptorHeaps(static_cast<UINT>(descriptorHeaps.size()), descriptorHeaps.data());
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::SetDescriptorHeaps);
+    }
 }
 
 void FComputeContext::Reset()
@@ -41,10 +46,21 @@ void FComputeContext::Reset()
 void FComputeContext::SetComputeRootSignatureAndPipeline(const FPipelineState& PipelineState) const
 {
     D3D12CommandList->SetComputeRootSignature(FPipelineState::StaticRootSignature.Get());
-    D3D12CommandList->SetPipelineState(PipelineState.PipelineStateObject.Get());
+    D3D12CommandList->SetPipelineState(PipelineState.Get());
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::SetComputeRootSignature, Capture::FObject{ GetCaptureId(FPipelineState::StaticRootSignature.Get()) });
+        RecordCommand(ECapturedCommand::SetPipelineState, Capture::FObject{ GetCaptureId(PipelineState.Get()) });
+    }
 }
 
 void FComputeContext::Dispatch(const uint32_t ThreadGroupX, const uint32_t ThreadGroupY, const uint32_t ThreadGroupZ) const
 {
     D3D12CommandList->Dispatch(ThreadGroupX, ThreadGroupY, ThreadGroupZ);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::Dispatch, Capture::FDispatch{ ThreadGroupX, ThreadGroupY, ThreadGroupZ });
+    }
 }
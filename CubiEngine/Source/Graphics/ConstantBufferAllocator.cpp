@@ -0,0 +1,174 @@
+#include "Graphics/ConstantBufferAllocator.h"
+#include "Graphics/D3D12DynamicRHI.h"
+#include "Graphics/MemoryAllocator.h"
+#include "ShaderInterlop/ConstantBuffers.hlsli"
+
+namespace
+{
+    constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+    constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+    uint64_t AlignUp(uint64_t Value, uint64_t Alignment)
+    {
+        return (Value + Alignment - 1u) & ~(Alignment - 1u);
+    }
+}
+
+FLinearConstantAllocator::FLinearConstantAllocator(uint64_t InCapacityPerFrame)
+    : CapacityPerFrame(AlignUp(InCapacityPerFrame, ALIGNMENT))
+{
+}
+
+void FLinearConstantAllocator::BeginFrame()
+{
+    HighWaterMark = max(HighWaterMark, Cursor);
+
+    FrameIndex = (FrameIndex + 1u) % FRAMES_IN_FLIGHT;
+    Cursor = 0u;
+    NumAllocations = 0u;
+}
+
+std::optional<FConstantRange> FLinearConstantAllocator::Allocate(uint32_t Size)
+{
+    assert(Size > 0u);
+
+    const uint64_t AlignedSize = AlignUp(Size, ALIGNMENT);
+    if (Cursor + AlignedSize > CapacityPerFrame)
+    {
+        return std::nullopt;
+    }
+
+    const FConstantRange Range = {
+        .Offset = uint64_t(FrameIndex) * CapacityPerFrame + Cursor,
+        .Size = static_cast<uint32_t>(AlignedSize),
+        .Index = NumAllocations,
+    };
+
+    Cursor += AlignedSize;
+    NumAllocations++;
+    return Range;
+}
+
+uint64_t FConstantDirtyTracker::Hash(const void* Data, size_t Size, uint64_t Seed)
+{
+    // FNV-1a over whole words, constants are made of 4 byte fields and the tail is rarely there.
+    const uint8_t* Bytes = static_cast<const uint8_t*>(Data);
+    uint64_t Result = (FNV_OFFSET_BASIS ^ Seed) * FNV_PRIME ^ Size;
+
+    size_t Index = 0u;
+    for (; Index + sizeof(uint64_t) <= Size; Index += sizeof(uint64_t))
+    {
+        uint64_t Word;
+        std::memcpy(&Word, Bytes + Index, sizeof(uint64_t));
+        Result = (Result ^ Word) * FNV_PRIME;
+    }
+    for (; Index < Size; Index++)
+    {
+        Result = (Result ^ Bytes[Index]) * FNV_PRIME;
+    }
+    return Result;
+}
+
+std::optional<uint32_t> FConstantDirtyTracker::Update(const void* Data, size_t Size)
+{
+    const uint64_t NewHash = Hash(Data, Size);
+    if (bWritten && NewHash == ContentHash)
+    {
+        NumSkipped++;
+        return std::nullopt;
+    }
+
+    // The first write goes to copy 0, no frame has read any copy yet.
+    CurrentCopy = bWritten ? (CurrentCopy + 1u) % FRAMES_IN_FLIGHT : 0u;
+    ContentHash = NewHash;
+    bWritten = true;
+
+    NumUploads++;
+    return CurrentCopy;
+}
+
+FD3D12ConstantBufferStorage::FD3D12ConstantBufferStorage(FMemoryAllocator& MemoryAllocator, uint64_t SizeInBytes)
+{
+    const FBufferCreationDesc ConstantBufferCreationDesc = {
+        .Usage = EBufferUsage::UploadBuffer,
+        .Name = L"Frame Constant Buffer",
+    };
+
+    Allocation = MemoryAllocator.CreateBufferResourceAllocation(ConstantBufferCreationDesc,
+        FResourceCreationDesc::CreateBufferResourceCreationDesc(SizeInBytes));
+    MappedData = static_cast<uint8_t*>(Allocation.MappedPointer.value());
+}
+
+uint32_t FD3D12ConstantBufferStorage::CreateCbv()
+{
+    return RHIGetCbvSrvUavDescriptorHeap()->AllocateDescriptor();
+}
+
+void FD3D12ConstantBufferStorage::WriteCbv(uint32_t Cbv, uint64_t Offset, uint32_t Size)
+{
+    const D3D12_CONSTANT_BUFFER_VIEW_DESC CbvDesc = {
+        .BufferLocation = Allocation.Resource->GetGPUVirtualAddress() + Offset,
+        .SizeInBytes = Size,
+    };
+    RHIGetDevice()->CreateConstantBufferView(&CbvDesc,
+        RHIGetCbvSrvUavDescriptorHeap()->GetDescriptorHandleFromIndex(Cbv).CpuDescriptorHandle);
+}
+
+FConstantBufferAllocator::FConstantBufferAllocator(FMemoryAllocator& MemoryAllocator)
+    : FConstantBufferAllocator(std::make_unique<FD3D12ConstantBufferStorage>(MemoryAllocator, CAPACITY_PER_FRAME * FRAMES_IN_FLIGHT),
+        CAPACITY_PER_FRAME)
+{
+    static_assert(CAPACITY_PER_FRAME % FLinearConstantAllocator::ALIGNMENT == 0u);
+}
+
+FConstantBufferAllocator::FConstantBufferAllocator(std::unique_ptr<FConstantBufferStorage> InStorage, uint64_t CapacityPerFrame)
+    : Allocator(CapacityPerFrame), Storage(std::move(InStorage))
+{
+}
+
+void FConstantBufferAllocator::BeginFrame()
+{
+    std::scoped_lock Lock(Mutex);
+    Allocator.BeginFrame();
+}
+
+uint32_t FConstantBufferAllocator::Allocate(const void* Data, uint32_t Size)
+{
+    // Largest a single CBV can cover.
+    assert(Size <= D3D12_REQ_CONSTANT_BUFFER_ELEMENT_COUNT * 16u);
+
+    std::scoped_lock Lock(Mutex);
+
+    const std::optional<FConstantRange> Range = Allocator.Allocate(Size);
+    if (!Range)
+    {
+        FatalError(std::format("Frame constant buffer ran out of space, {} KB per frame.", Allocator.GetCapacityPerFrame() / 1024u));
+    }
+
+    std::memcpy(Storage->GetMappedData() + Range->Offset, Data, Size);
+
+    std::vector<uint32_t>& Cbvs = FrameCbvs[Allocator.GetFrameIndex()];
+    if (Range->Index == Cbvs.size())
+    {
+        Cbvs.push_back(Storage->CreateCbv());
+    }
+    Storage->WriteCbv(Cbvs[Range->Index], Range->Offset, Range->Size);
+
+    return Cbvs[Range->Index];
+}
+
+template<typename T>
+void TTrackedConstantBuffer<T>::Init(std::wstring_view Name)
+{
+    for (uint32_t Copy = 0; Copy < FRAMES_IN_FLIGHT; Copy++)
+    {
+        Buffers[Copy] = RHICreateBuffer<T>(FBufferCreationDesc{
+            .Usage = EBufferUsage::ConstantBuffer,
+            .Name = std::format(L"{} {}", Name, Copy),
+        });
+    }
+}
+
+template class TTrackedConstantBuffer<interlop::LightBuffer>;
+template class TTrackedConstantBuffer<interlop::ShadowBuffer>;
+template class TTrackedConstantBuffer<interlop::DebugBuffer>;
@@ -7,57 +7,195 @@ void FContext::CopyTextureRegion(
     const D3D12_TEXTURE_COPY_LOCATION* pSrc, const D3D12_BOX* pSrcBox)
 {
     D3D12CommandList->CopyTextureRegion(pDst, DstX, DstY, DstZ, pSrc, pSrcBox);
+
+    if (CommandCapture)
+    {
+        auto ToCaptured = [this](const D3D12_TEXTURE_COPY_LOCATION* Location)
+        {
+            Capture::FCopyLocation Captured{ .Resource = GetCaptureId(Location->pResource), .Type = static_cast<uint32_t>(Location->Type) };
+            if (Location->Type == D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX)
+            {
+                Captured.SubresourceIndex = Location->SubresourceIndex;
+            }
+            else
+            {
+                const D3D12_SUBRESOURCE_FOOTPRINT& Footprint = Location->PlacedFootprint.Footprint;
+                Captured.Format = static_cast<uint32_t>(Footprint.Format);
+                Captured.Offset = Location->PlacedFootprint.Offset;
+                Captured.Width = Footprint.Width;
+                Captured.Height = Footprint.Height;
+                Captured.Depth = Footprint.Depth;
+                Captured.RowPitch = Footprint.RowPitch;
+            }
+            return Captured;
+        };
+
+        Capture::FCopyTextureRegion Copy{
+            .Destination = ToCaptured(pDst),
+            .Source = ToCaptured(pSrc),
+            .DstX = DstX,
+            .DstY = DstY,
+            .DstZ = DstZ,
+            .bHasSourceBox = pSrcBox != nullptr,
+        };
+        if (pSrcBox)
+        {
+            const uint32_t Box[] = { pSrcBox->left, pSrcBox->top, pSrcBox->front, pSrcBox->right, pSrcBox->bottom, pSrcBox->back };
+            std::copy(std::begin(Box), std::end(Box), Copy.SourceBox);
+        }
+        RecordCommand(ECapturedCommand::CopyTextureRegion, Copy);
+    }
 }
 
 void FContext::Reset()
 {
     ThrowIfFailed(D3D12CommandAllocator->Reset());
     ThrowIfFailed(D3D12CommandList->Reset(D3D12CommandAllocator.Get(), nullptr));
+    StateTracker.Reset();
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::ContextReset);
+    }
 }
 
 void FContext::AddResourceBarrier(ID3D12Resource* const Resource, const D3D12_RESOURCE_STATES PreviousState,
     const D3D12_RESOURCE_STATES NewState)
 {
-    ResourceBarriers.emplace_back(CD3DX12_RESOURCE_BARRIER::Transition(Resource, PreviousState, NewState));
+    StateTracker.AddBarrier(CD3DX12_RESOURCE_BARRIER::Transition(Resource, PreviousState, NewState));
 }
 
 void FContext::AddResourceBarrier(FTexture* Texture, const D3D12_RESOURCE_STATES NewState)
 {
-    if (Texture->ResourceState == NewState) return;
+    // A texture already readable in a wider read-only state needs no transition to read it in one of those.
+    if (NewState != Texture->ResourceState && FTexture::IsReadOnlyState(NewState) && FTexture::IsReadOnlyState(Texture->ResourceState)
+        && (Texture->ResourceState & NewState) == NewState) return;
 
-    AddResourceBarrier(Texture->GetResource(), Texture->ResourceState, NewState);
-    Texture->ResourceState = NewState;
+    TransitionResource(Texture, NewState);
 }
 
 void FContext::AddResourceBarrier(D3D12_RESOURCE_BARRIER& Barrier)
 {
-    ResourceBarriers.emplace_back(Barrier);
+    StateTracker.AddBarrier(Barrier);
+}
+
+void FContext::TransitionResource(FTexture* Texture, const D3D12_RESOURCE_STATES NewState, uint32_t Subresource)
+{
+    // The texture's state is what the list expects the first time it touches it.
+    StateTracker.Transition(Texture->GetResource(), Texture->NumSubresources, Texture->ResourceState, NewState, Subresource);
+    Texture->ResourceState = StateTracker.GetState(Texture->GetResource());
+}
+
+void FContext::BeginTransition(FTexture* Texture, const D3D12_RESOURCE_STATES NewState, uint32_t Subresource)
+{
+    StateTracker.BeginTransition(Texture->GetResource(), Texture->NumSubresources, Texture->ResourceState, NewState, Subresource);
+    Texture->ResourceState = StateTracker.GetState(Texture->GetResource());
+}
+
+void FContext::EndTransition(FTexture* Texture, uint32_t Subresource)
+{
+    StateTracker.EndTransition(Texture->GetResource(), Subresource);
 }
 
 void FContext::AddUAVBarrier(FTexture* Texture)
 {
-    ResourceBarriers.emplace_back(CD3DX12_RESOURCE_BARRIER::UAV(Texture->GetResource()));
+    StateTracker.UAVBarrier(Texture->GetResource());
 }
 
 void FContext::AddUAVBarrier(FBuffer& Buffer)
 {
-    ResourceBarriers.emplace_back(CD3DX12_RESOURCE_BARRIER::UAV(Buffer.Allocation.Resource.Get()));
+    StateTracker.UAVBarrier(Buffer.Allocation.Resource.Get());
+}
+
+void FContext::AddAliasingBarrier(FTexture* Before, FTexture* After)
+{
+    StateTracker.AliasingBarrier(Before ? Before->GetResource() : nullptr, After->GetResource());
 }
 
 void FContext::ExecuteResourceBarriers()
 {
+    const std::span<const D3D12_RESOURCE_BARRIER> ResourceBarriers = StateTracker.GetBarriers();
     if (ResourceBarriers.size() == 0) return;
 
-    D3D12CommandList->ResourceBarrier(static_cast<UINT>(ResourceBarriers.size()), ResourceBarriers.data());
-    ResourceBarriers.clear();
+    if (CommandCapture)
+    {
+        std::vector<uint8_t> Payload(sizeof(uint32_t) + ResourceBarriers.size() * sizeof(Capture::FBarrier));
+        const uint32_t NumBarriers = static_cast<uint32_t>(ResourceBarriers.size());
+        std::memcpy(Payload.data(), &NumBarriers, sizeof(NumBarriers));
+
+        Capture::FBarrier* Captured = reinterpret_cast<Capture::FBarrier*>(Payload.data() + sizeof(uint32_t));
+        for (const D3D12_RESOURCE_BARRIER& Barrier : ResourceBarriers)
+        {
+            *Captured = Capture::FBarrier{ .Type = static_cast<uint32_t>(Barrier.Type), .Flags = static_cast<uint32_t>(Barrier.Flags) };
+            if (Barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION)
+            {
+                Captured->Resource = GetCaptureId(Barrier.Transition.pResource);
+                Captured->Subresource = Barrier.Transition.Subresource;
+                Captured->StateBefore = static_cast<uint32_t>(Barrier.Transition.StateBefore);
+                Captured->StateAfter = static_cast<uint32_t>(Barrier.Transition.StateAfter);
+            }
+            else if (Barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_ALIASING)
+            {
+                Captured->Resource = GetCaptureId(Barrier.Aliasing.pResourceBefore);
+                Captured->ResourceAfter = GetCaptureId(Barrier.Aliasing.pResourceAfter);
+            }
+            else
+            {
+                Captured->Resource = GetCaptureId(Barrier.UAV.pResource);
+            }
+            Captured++;
+        }
+        CommandCapture->Record(GetCaptureId(this), ECapturedCommand::ResourceBarriers, Payload.data(), Payload.size());
+    }
+
+    StateTracker.Flush(*D3D12CommandList.Get());
+}
+
+void FContext::ResolvePendingBarriers(FResourceStateTable& Table, std::vector<D3D12_RESOURCE_BARRIER>& OutBarriers)
+{
+    StateTracker.ResolvePendingBarriers(Table, OutBarriers);
 }
 
 void FContext::BeginEvent(const char* Name)
 {
     PIXBeginEvent(D3D12CommandList.Get(), PIX_COLOR(255, 255, 255), Name);
+
+    if (CommandCapture)
+    {
+        CommandCapture->Record(GetCaptureId(this), ECapturedCommand::BeginEvent, Name, std::strlen(Name));
+    }
 }
 
 void FContext::EndEvent(const char* Name)
 {
     PIXEndEvent(D3D12CommandList.Get());
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::EndEvent);
+    }
+}
+
+void FContext::RecordCommand(ECapturedCommand Type) const
+{
+    CommandCapture->Record(CommandCapture->GetObjectId(this), Type);
+}
+
+void FContext::RecordRoot32BitConstants(bool bGraphics, uint32_t RootParameterIndex, const void* Values,
+    uint32_t Num32BitValues, uint32_t DestOffsetIn32BitValues) const
+{
+    const Capture::FRoot32BitConstants Constants{
+        .bGraphics = bGraphics,
+        .RootParameterIndex = RootParameterIndex,
+        .DestOffsetIn32BitValues = DestOffsetIn32BitValues,
+        .Num32BitValues = Num32BitValues,
+    };
+
+    std::array<uint8_t, sizeof(Capture::FRoot32BitConstants) + 64u * sizeof(uint32_t)> Payload;
+    assert(Num32BitValues <= 64u);
+    std::memcpy(Payload.data(), &Constants, sizeof(Constants));
+    std::memcpy(Payload.data() + sizeof(Constants), Values, Num32BitValues * sizeof(uint32_t));
+
+    CommandCapture->Record(GetCaptureId(this), ECapturedCommand::SetRoot32BitConstants,
+        Payload.data(), sizeof(Constants) + Num32BitValues * sizeof(uint32_t));
 }
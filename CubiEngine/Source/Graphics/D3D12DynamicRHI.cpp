@@ -6,6 +6,9 @@
 #include "Graphics/MemoryAllocator.h"
 #include "Graphics/CopyContext.h"
 #include "Graphics/TextureManager.h"
+#include "Graphics/GeometryPool.h"
+#include "Graphics/ConstantBufferAllocator.h"
+#include "Graphics/MaterialTable.h"
 #include "Core/FileSystem.h"
 #include "ShaderInterlop/ConstantBuffers.hlsli"
 #include "ShaderInterlop/RenderResources.hlsli"
@@ -22,7 +25,10 @@ FD3D12DynamicRHI::FD3D12DynamicRHI()
 
 FD3D12DynamicRHI::~FD3D12DynamicRHI()
 {
+    PipelineCompileQueue.WaitAll();
     FlushAllQueue();
+    // The GPU is idle, the frame that never ended included.
+    DeferredReleaseQueue.RetireAll();
 
     // Texture destruction accesses the texture manager and descriptor heaps.
     // Release swap-chain textures while those services are still alive.
@@ -44,6 +50,8 @@ void FD3D12DynamicRHI::Init(
 {
     SwapchainFormat = InSwapchainFormat;
     WindowHandle = InWindowHandle;
+    BackBufferWidth = InWidth;
+    BackBufferHeight = InHeight;
 
     // Todo : seperate Swapchain class from D3D12DynamicRHI
     InitDeviceResources();
@@ -52,6 +60,10 @@ void FD3D12DynamicRHI::Init(
     MipmapGenerator = std::make_unique<FMipmapGenerator>();
 
     TimeStampQueryHeap = std::make_unique<FQueryHeap>(D3D12_QUERY_TYPE_TIMESTAMP, D3D12_QUERY_HEAP_TYPE_TIMESTAMP);
+
+    GeometryPool = std::make_unique<FGeometryPool>();
+    ConstantBufferAllocator = std::make_unique<FConstantBufferAllocator>(*MemoryAllocator);
+    MaterialTable = std::make_unique<FMaterialTable>();
 }
 
 void CreateRHI(const uint32_t Width, const uint32_t Height, const DXGI_FORMAT SwapchainFormat, const HWND WindowHandle)
@@ -87,6 +99,11 @@ FCommandQueue* RHIGetDirectCommandQueue()
     return GD3D12RHI->GetDirectCommandQueue();
 }
 
+FCommandQueue* RHIGetComputeCommandQueue()
+{
+    return GD3D12RHI->GetComputeCommandQueue();
+}
+
 FPipelineState RHICreatePipelineState(const FGraphicsPipelineStateCreationDesc& Desc)
 {
     return GD3D12RHI->CreatePipelineState(Desc);
@@ -97,6 +114,11 @@ FPipelineState RHICreatePipelineState(const FComputePipelineStateCreationDesc& D
     return GD3D12RHI->CreatePipelineState(Desc);
 }
 
+ComPtr<ID3D12CommandSignature> RHICreateCommandSignature(const D3D12_COMMAND_SIGNATURE_DESC& Desc)
+{
+    return GD3D12RHI->CreateCommandSignature(Desc);
+}
+
 DXGI_FORMAT RHIGetSwapChainFormat()
 {
     return GD3D12RHI->GetSwapChainFormat();
@@ -172,11 +194,51 @@ std::unique_ptr<FTexture> RHICreateTexture(const FTextureCreationDesc& InTexture
     return std::move(GD3D12RHI->CreateTexture(InTextureCreationDesc, Data));
 }
 
+D3D12_RESOURCE_ALLOCATION_INFO RHIGetTextureAllocationInfo(const FTextureCreationDesc& TextureCreationDesc)
+{
+    return GD3D12RHI->GetTextureAllocationInfo(TextureCreationDesc);
+}
+
+wrl::ComPtr<D3D12MA::Allocation> RHIAllocateHeap(uint64_t Size, uint64_t Alignment, D3D12_HEAP_FLAGS HeapFlags)
+{
+    return GD3D12RHI->AllocateHeap(Size, Alignment, HeapFlags);
+}
+
+std::unique_ptr<FTexture> RHICreatePlacedTexture(const FTextureCreationDesc& TextureCreationDesc, const FTexturePlacement& Placement)
+{
+    return GD3D12RHI->CreateTexture(TextureCreationDesc, nullptr, &Placement);
+}
+
 FBuffer RHICreateBuffer(const FBufferCreationDesc& BufferCreationDesc, size_t TotalBytes)
 {
     return GD3D12RHI->CreateBuffer(BufferCreationDesc, TotalBytes);
 }
 
+FBuffer RHICreateBuffer(const FBufferCreationDesc& BufferCreationDesc, size_t NumElements, size_t ElementSizeInBytes)
+{
+    return GD3D12RHI->CreateBuffer(BufferCreationDesc, NumElements, ElementSizeInBytes);
+}
+
+void RHIUploadBufferRegion(const FBuffer& Buffer, uint64_t DstOffset, const void* Data, uint64_t Size)
+{
+    GD3D12RHI->UploadBufferRegion(Buffer, DstOffset, Data, Size);
+}
+
+void RHICopyBufferRegion(const FBuffer& DstBuffer, uint64_t DstOffset, const FBuffer& SrcBuffer, uint64_t SrcOffset, uint64_t Size)
+{
+    GD3D12RHI->CopyBufferRegion(DstBuffer, DstOffset, SrcBuffer, SrcOffset, Size);
+}
+
+uint32_t RHIAllocateConstants(const void* Data, uint32_t Size)
+{
+    return GD3D12RHI->GetConstantBufferAllocator()->Allocate(Data, Size);
+}
+
+void RHIFlushUploads()
+{
+    GD3D12RHI->FlushUploads();
+}
+
 
 #define RHI_CREATE_BUFFER_TEMPLATE_FUNC(TYPE) \
     template FBuffer RHICreateBuffer<TYPE>( \
@@ -207,9 +269,19 @@ void RHIPresent()
     GD3D12RHI->Present();
 }
 
-void RHIExecuteAndFlushComputeContext(std::unique_ptr<FComputeContext>&& ComputeContext)
+void RHIExecuteComputeContext(std::unique_ptr<FComputeContext>&& ComputeContext)
+{
+    GD3D12RHI->ExecuteComputeContext(std::move(ComputeContext));
+}
+
+FGraphicsContext* RHIAcquireAsyncComputeContext()
 {
-    GD3D12RHI->ExecuteAndFlushComputeContext(std::move(ComputeContext));
+    return GD3D12RHI->AcquireAsyncComputeContext();
+}
+
+uint64_t RHISubmitAsyncComputeContext(FGraphicsContext* Context)
+{
+    return GD3D12RHI->SubmitAsyncComputeContext(Context);
 }
 
 void RHIFlushAllQueue()
@@ -217,11 +289,51 @@ void RHIFlushAllQueue()
 	GD3D12RHI->FlushAllQueue();
 }
 
+void RHISetCommandCapture(FCommandCapture* Capture)
+{
+    GD3D12RHI->SetCommandCapture(Capture);
+}
+
+bool RHIIsHeadless()
+{
+    return GD3D12RHI->IsHeadless();
+}
+
+const FRHIStats& RHIGetStats()
+{
+    return GD3D12RHI->GetStats();
+}
+
+void RHIDeferReleaseCallback(std::function<void()> Release, uint64_t NumBytes)
+{
+    GD3D12RHI->GetDeferredReleaseQueue().EnqueueCallback(FDeferredReleaseQueue::OPEN_BATCH, std::move(Release), NumBytes);
+}
+
+FDeferredReleaseStats RHIGetDeferredReleaseStats()
+{
+    return GD3D12RHI->GetDeferredReleaseQueue().GetStats();
+}
+
 FTextureManager* RHIGetTextureManager()
 {
     return GD3D12RHI->GetTextureManager();
 }
 
+FGeometryPool* RHIGetGeometryPool()
+{
+    return GD3D12RHI->GetGeometryPool();
+}
+
+FMaterialTable* RHIGetMaterialTable()
+{
+    return GD3D12RHI->GetMaterialTable();
+}
+
+FResourceStateTable& RHIGetResourceStateTable()
+{
+    return GD3D12RHI->GetResourceStateTable();
+}
+
 FSampler FD3D12DynamicRHI::CreateSampler(const FSamplerCreationDesc& Desc) const
 {
     FSampler Sampler{};
@@ -234,8 +346,15 @@ FSampler FD3D12DynamicRHI::CreateSampler(const FSamplerCreationDesc& Desc) const
     return Sampler;
 }
 
-std::unique_ptr<FTexture> FD3D12DynamicRHI::CreateTexture(const FTextureCreationDesc& InTextureCreationDesc, const void* Data) const
+std::unique_ptr<FTexture> FD3D12DynamicRHI::CreateTexture(const FTextureCreationDesc& InTextureCreationDesc, const void* Data,
+    const FTexturePlacement* Placement) const
 {
+    // Placed textures share memory the GPU may still be using for another texture, nothing can be written at creation.
+    assert(!Placement || (!Data && (InTextureCreationDesc.Usage == ETextureUsage::RenderTarget
+        || InTextureCreationDesc.Usage == ETextureUsage::DepthStencil || InTextureCreationDesc.Usage == ETextureUsage::UAVTexture)));
+
+    Stats.NumTexturesCreated++;
+
     FTextureCreationDesc TextureCreationDesc = InTextureCreationDesc;
 
     DXGI_FORMAT dsFormat{};
@@ -320,10 +439,13 @@ std::unique_ptr<FTexture> FD3D12DynamicRHI::CreateTexture(const FTextureCreation
     std::unique_ptr<FTexture> Texture = std::make_unique<FTexture>();
     // GPU only memory
     D3D12_RESOURCE_STATES ResourceState;
-    Texture->Allocation = MemoryAllocator->CreateTextureResourceAllocation(TextureCreationDesc, ResourceState, bUAVAllowed);
+    Texture->Allocation = MemoryAllocator->CreateTextureResourceAllocation(TextureCreationDesc, ResourceState, bUAVAllowed, Placement);
     Texture->Width = TextureCreationDesc.Width;
     Texture->Height = TextureCreationDesc.Height;
+    Texture->NumSubresources = TextureCreationDesc.MipLevels * TextureCreationDesc.DepthOrArraySize
+        * D3D12GetFormatPlaneCount(Device.Get(), TextureCreationDesc.Format);
     Texture->ResourceState = ResourceState;
+    ResourceStateTable.Register(Texture->GetResource(), Texture->NumSubresources, ResourceState);
     Texture->Usage = TextureCreationDesc.Usage;
     Texture->Format = TextureCreationDesc.Format;
     Texture->DebugName = TextureCreationDesc.Name;
@@ -358,30 +480,38 @@ std::unique_ptr<FTexture> FD3D12DynamicRHI::CreateTexture(const FTextureCreation
                 });
         }
 
-        // Create upload buffer.
-        const FBufferCreationDesc UploadBufferCreationDesc = {
-            .Usage = EBufferUsage::UploadBuffer,
-            .Name = L"Upload buffer - " + std::wstring(TextureCreationDesc.Name),
-        };
-
-        const UINT64 UploadBufferSize = GetRequiredIntermediateSize(Texture->Allocation.Resource.Get(), 0, TextureSubresourceData.size());
-        const FResourceCreationDesc ResourceCreationDesc = FResourceCreationDesc::CreateBufferResourceCreationDesc(UploadBufferSize);
+        // Rows of a footprint are D3D12_TEXTURE_DATA_PITCH_ALIGNMENT apart and every subresource starts on
+        // D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, so the upload region is placed on that alignment as well.
+        const D3D12_RESOURCE_DESC ResourceDesc = Texture->Allocation.Resource->GetDesc();
+        const uint32_t NumSubresources = static_cast<uint32_t>(TextureSubresourceData.size());
+        std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> Footprints(NumSubresources);
+        std::vector<UINT> NumRows(NumSubresources);
+        std::vector<UINT64> RowSizesInBytes(NumSubresources);
+        UINT64 UploadSize = 0u;
+        Device->GetCopyableFootprints(&ResourceDesc, 0u, NumSubresources, 0u,
+            Footprints.data(), NumRows.data(), RowSizesInBytes.data(), &UploadSize);
 
-        FAllocation UploadAllocation =
-            MemoryAllocator->CreateBufferResourceAllocation(UploadBufferCreationDesc, ResourceCreationDesc);
-
-        // Use the copy context and execute UpdateSubresources functions on the copy command queue.
         std::scoped_lock<std::recursive_mutex> LockGuard(ResourceMutex);
 
-        CopyContext->Reset();
-
-        UpdateSubresources(CopyContext->GetD3D12CommandList(), Texture->Allocation.Resource.Get(),
-            UploadAllocation.Resource.Get(), 0u, 0u, TextureSubresourceData.size(), TextureSubresourceData.data());
+        const FUploadRegion Upload = AllocateUpload(UploadSize, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+        ID3D12GraphicsCommandList4* const CommandList = GetUploadBatchContext()->GetD3D12CommandList();
 
-        CopyCommandQueue->ExecuteContext(CopyContext.get());
-        CopyCommandQueue->Flush();
+        for (uint32_t Index = 0u; Index < NumSubresources; ++Index)
+        {
+            D3D12_PLACED_SUBRESOURCE_FOOTPRINT& Footprint = Footprints[Index];
+            const D3D12_MEMCPY_DEST Destination = {
+                .pData = Upload.CpuAddress + Footprint.Offset,
+                .RowPitch = Footprint.Footprint.RowPitch,
+                .SlicePitch = static_cast<SIZE_T>(Footprint.Footprint.RowPitch) * NumRows[Index],
+            };
+            MemcpySubresource(&Destination, &TextureSubresourceData[Index], static_cast<SIZE_T>(RowSizesInBytes[Index]),
+                NumRows[Index], Footprint.Footprint.Depth);
 
-        UploadAllocation.Reset();
+            Footprint.Offset += Upload.Offset;
+            const CD3DX12_TEXTURE_COPY_LOCATION CopyDestination(Texture->Allocation.Resource.Get(), Index);
+            const CD3DX12_TEXTURE_COPY_LOCATION CopySource(Upload.Resource, Footprint);
+            CommandList->CopyTextureRegion(&CopyDestination, 0u, 0u, 0u, &CopySource, nullptr);
+        }
     }
 
     {
@@ -508,15 +638,17 @@ std::unique_ptr<FTexture> FD3D12DynamicRHI::CreateTexture(const FTextureCreation
         }
     }
 
-    if (bUAVAllowed && !FTexture::IsCompressedFormat(TextureCreationDesc.Format))
+    if (bUAVAllowed && !FTexture::IsCompressedFormat(TextureCreationDesc.Format) && !Placement)
     {
         MipmapGenerator->GenerateMipmap(Texture.get());
     }
 
+    // Placed textures share their memory with other transients of the frame, by the time the debug view samples
+    // one its memory already belongs to another texture.
     std::string TextureName = wStringToString(InTextureCreationDesc.Name);
-    if (Texture->Usage == ETextureUsage::DepthStencil ||
+    if (!Placement && (Texture->Usage == ETextureUsage::DepthStencil ||
         Texture->Usage == ETextureUsage::RenderTarget ||
-        Texture->Usage == ETextureUsage::UAVTexture)
+        Texture->Usage == ETextureUsage::UAVTexture))
     {
         if (TextureManager)
         {
@@ -524,28 +656,264 @@ std::unique_ptr<FTexture> FD3D12DynamicRHI::CreateTexture(const FTextureCreation
         }
     }
 
+    RecordResourceCreation(Texture->GetResource());
     return Texture;
 }
 
+D3D12_RESOURCE_ALLOCATION_INFO FD3D12DynamicRHI::GetTextureAllocationInfo(const FTextureCreationDesc& TextureCreationDesc) const
+{
+    return MemoryAllocator->GetTextureAllocationInfo(TextureCreationDesc,
+        FTexture::IsUAVAllowed(TextureCreationDesc.Usage, TextureCreationDesc.Format));
+}
+
+wrl::ComPtr<D3D12MA::Allocation> FD3D12DynamicRHI::AllocateHeap(uint64_t Size, uint64_t Alignment, D3D12_HEAP_FLAGS HeapFlags) const
+{
+    return MemoryAllocator->AllocateHeap(Size, Alignment, HeapFlags);
+}
+
+namespace
+{
+    // Creation descs only hold views, a background compile keeps its own copy of every string they point at.
+    template<typename DescType>
+    struct TOwnedPipelineDesc
+    {
+        explicit TOwnedPipelineDesc(const DescType& InDesc)
+            : Desc(InDesc)
+        {
+            ShaderModule& Module = Desc.ShaderModule;
+            std::wstring_view* Views[] = {
+                &Module.vertexShaderPath, &Module.vertexEntryPoint,
+                &Module.pixelShaderPath, &Module.pixelEntryPoint,
+                &Module.computeShaderPath, &Module.computeEntryPoint,
+                &Desc.PipelineName,
+            };
+            static_assert(ArraySize_(Views) == std::tuple_size_v<decltype(Strings)>);
+
+            for (size_t Index = 0u; Index < Strings.size(); ++Index)
+            {
+                Strings[Index] = *Views[Index];
+                *Views[Index] = Strings[Index];
+            }
+        }
+
+        DescType Desc;
+        std::array<std::wstring, 7u> Strings;
+    };
+
+    template<typename DescType>
+    FPipelineState EnqueuePipelineState(FPipelineCompileQueue& Queue, ID3D12Device5* Device, const DescType& Desc)
+    {
+        auto OwnedDesc = std::make_shared<TOwnedPipelineDesc<DescType>>(Desc);
+        return FPipelineState(Queue.Enqueue<ComPtr<ID3D12PipelineState>>([Device, OwnedDesc]()
+        {
+            const FPipelineState PipelineState(Device, OwnedDesc->Desc);
+            return ComPtr<ID3D12PipelineState>(PipelineState.Get());
+        }));
+    }
+}
+
 FPipelineState FD3D12DynamicRHI::CreatePipelineState(const FGraphicsPipelineStateCreationDesc& Desc) const
 {
-    FPipelineState PipelineState(Device.Get(), Desc);
-    return PipelineState;
+    Stats.NumPipelineStatesCreated++;
+    return EnqueuePipelineState(PipelineCompileQueue, Device.Get(), Desc);
 }
 
 FPipelineState FD3D12DynamicRHI::CreatePipelineState(const FComputePipelineStateCreationDesc& Desc) const
 {
-    FPipelineState PipelineState(Device.Get(), Desc);
-    return PipelineState;
+    Stats.NumPipelineStatesCreated++;
+    return EnqueuePipelineState(PipelineCompileQueue, Device.Get(), Desc);
+}
+
+ComPtr<ID3D12CommandSignature> FD3D12DynamicRHI::CreateCommandSignature(const D3D12_COMMAND_SIGNATURE_DESC& Desc) const
+{
+    // Signatures that change root arguments have to be created against the root signature they modify.
+    ComPtr<ID3D12CommandSignature> CommandSignature;
+    ThrowIfFailed(Device->CreateCommandSignature(&Desc, FPipelineState::StaticRootSignature.Get(), IID_PPV_ARGS(&CommandSignature)));
+    return CommandSignature;
 }
 
-void FD3D12DynamicRHI::ExecuteAndFlushComputeContext(std::unique_ptr<FComputeContext>&& ComputeContext)
+void FD3D12DynamicRHI::ExecuteComputeContext(std::unique_ptr<FComputeContext>&& ComputeContext)
 {
-    // Execute compute context and push to the queue.
+    Stats.NumComputeSubmissions++;
     ComputeCommandQueue->ExecuteContext(ComputeContext.get());
-    ComputeCommandQueue->Flush();
+    const uint64_t FenceValue = ComputeCommandQueue->Signal();
+
+    // Results are consumed on the direct queue, which waits for them on the GPU.
+    DirectCommandQueue->WaitForQueue(*ComputeCommandQueue, FenceValue);
 
-    ComputeContextQueue.emplace(std::move(ComputeContext));
+    // The allocator can only be reset once the GPU is done with it, recycle the context from the fence callback.
+    FComputeContext* Context = ComputeContext.release();
+    ComputeCommandQueue->OnFenceCompletion(FenceValue, [this, Context]()
+    {
+        std::lock_guard Lock(ContextPoolMutex);
+        ComputeContextQueue.emplace(Context);
+    });
+}
+
+FGraphicsContext* FD3D12DynamicRHI::AcquireAsyncComputeContext()
+{
+    FGraphicsContext* Context = nullptr;
+    {
+        std::lock_guard Lock(ContextPoolMutex);
+        if (FreeAsyncComputeContexts.empty())
+        {
+            Context = AsyncComputeContexts.emplace_back(std::make_unique<FGraphicsContext>(D3D12_COMMAND_LIST_TYPE_COMPUTE)).get();
+        }
+        else
+        {
+            Context = FreeAsyncComputeContexts.back();
+            FreeAsyncComputeContexts.pop_back();
+        }
+    }
+
+    Context->SetCommandCapture(CommandCapture.load());
+    Context->Reset();
+    Context->SetComputeRootSignature();
+    return Context;
+}
+
+uint64_t FD3D12DynamicRHI::SubmitAsyncComputeContext(FGraphicsContext* Context)
+{
+    Stats.NumComputeSubmissions++;
+    ComputeCommandQueue->ExecuteContext(Context);
+    const uint64_t FenceValue = ComputeCommandQueue->Signal();
+
+    ComputeCommandQueue->OnFenceCompletion(FenceValue, [this, Context]()
+    {
+        std::lock_guard Lock(ContextPoolMutex);
+        FreeAsyncComputeContexts.push_back(Context);
+    });
+
+    return FenceValue;
+}
+
+FCopyContext* FD3D12DynamicRHI::AcquireCopyContext() const
+{
+    std::lock_guard Lock(ContextPoolMutex);
+    if (FreeCopyContexts.empty())
+    {
+        FCopyContext* Context = CopyContexts.emplace_back(std::make_unique<FCopyContext>()).get();
+        Context->SetCommandCapture(CommandCapture.load());
+        return Context;
+    }
+
+    FCopyContext* Context = FreeCopyContexts.back();
+    FreeCopyContexts.pop_back();
+    Context->SetCommandCapture(CommandCapture.load());
+    return Context;
+}
+
+uint64_t FD3D12DynamicRHI::SubmitCopyContext(FCopyContext* Context, std::vector<FAllocation>&& UploadAllocations) const
+{
+    Stats.NumCopySubmissions++;
+    CopyCommandQueue->ExecuteContext(Context);
+    const uint64_t FenceValue = CopyCommandQueue->Signal();
+
+    // Anything submitted to the other queues from now on may read the destination.
+    DirectCommandQueue->WaitForQueue(*CopyCommandQueue, FenceValue);
+    ComputeCommandQueue->WaitForQueue(*CopyCommandQueue, FenceValue);
+
+    CopyCommandQueue->OnFenceCompletion(FenceValue, [this, Context, Uploads = std::move(UploadAllocations)]() mutable
+    {
+        for (FAllocation& Upload : Uploads)
+        {
+            Upload.Reset();
+        }
+
+        std::lock_guard Lock(ContextPoolMutex);
+        FreeCopyContexts.push_back(Context);
+    });
+
+    return FenceValue;
+}
+
+FUploadRegion FD3D12DynamicRHI::AllocateUpload(uint64_t Size, uint64_t Alignment) const
+{
+    std::scoped_lock<std::recursive_mutex> LockGuard(ResourceMutex);
+
+    FUploadRingAllocator& Allocator = UploadRing->GetAllocator();
+    Allocator.Retire(CopyCommandQueue->GetCompletedFenceValue());
+
+    if (Size <= Allocator.GetCapacity())
+    {
+        std::optional<FUploadRegion> Region = UploadRing->Allocate(Size, Alignment);
+        if (!Region)
+        {
+            // Submit what is recorded so far so it can retire, then wait for the oldest batches until it fits.
+            // Once everything retired the ring is empty, so this always ends.
+            Stats.NumUploadRingStalls++;
+            FlushUploads();
+            while (!(Region = UploadRing->Allocate(Size, Alignment)))
+            {
+                CopyCommandQueue->WaitForFenceValue(Allocator.GetOldestPendingFenceValue());
+                Allocator.Retire(CopyCommandQueue->GetCompletedFenceValue());
+            }
+        }
+        return *Region;
+    }
+
+    // Larger than the whole ring, gets an upload buffer of its own that is released with the batch.
+    const FBufferCreationDesc UploadBufferCreationDesc = {
+        .Usage = EBufferUsage::UploadBuffer,
+        .Name = L"Upload buffer - oversized upload",
+    };
+
+    const FAllocation& Allocation = UploadBatchAllocations.emplace_back(MemoryAllocator->CreateBufferResourceAllocation(
+        UploadBufferCreationDesc, FResourceCreationDesc::CreateBufferResourceCreationDesc(Size)));
+    return FUploadRegion{
+        .Resource = Allocation.Resource.Get(),
+        .Offset = 0u,
+        .CpuAddress = static_cast<uint8_t*>(Allocation.MappedPointer.value()),
+    };
+}
+
+FCopyContext* FD3D12DynamicRHI::GetUploadBatchContext() const
+{
+    std::scoped_lock<std::recursive_mutex> LockGuard(ResourceMutex);
+
+    if (!UploadBatchContext)
+    {
+        UploadBatchContext = AcquireCopyContext();
+        UploadBatchContext->Reset();
+    }
+    return UploadBatchContext;
+}
+
+void FD3D12DynamicRHI::FlushUploads() const
+{
+    std::scoped_lock<std::recursive_mutex> LockGuard(ResourceMutex);
+
+    if (!UploadBatchContext)
+    {
+        return;
+    }
+
+    const uint64_t FenceValue = SubmitCopyContext(UploadBatchContext, std::exchange(UploadBatchAllocations, {}));
+    UploadBatchContext = nullptr;
+    UploadRing->GetAllocator().CloseBatch(FenceValue);
+}
+
+void FD3D12DynamicRHI::UploadBufferRegion(const FBuffer& Buffer, uint64_t DstOffset, const void* Data, uint64_t Size) const
+{
+    assert(DstOffset + Size <= Buffer.SizeInBytes);
+
+    std::scoped_lock<std::recursive_mutex> LockGuard(ResourceMutex);
+
+    const FUploadRegion Upload = AllocateUpload(Size, UPLOAD_BUFFER_ALIGNMENT);
+    std::memcpy(Upload.CpuAddress, Data, Size);
+
+    GetUploadBatchContext()->GetD3D12CommandList()->CopyBufferRegion(
+        Buffer.GetResource(), DstOffset, Upload.Resource, Upload.Offset, Size);
+}
+
+void FD3D12DynamicRHI::CopyBufferRegion(const FBuffer& DstBuffer, uint64_t DstOffset, const FBuffer& SrcBuffer, uint64_t SrcOffset, uint64_t Size) const
+{
+    assert(DstOffset + Size <= DstBuffer.SizeInBytes && SrcOffset + Size <= SrcBuffer.SizeInBytes);
+
+    std::scoped_lock<std::recursive_mutex> LockGuard(ResourceMutex);
+
+    GetUploadBatchContext()->GetD3D12CommandList()->CopyBufferRegion(
+        DstBuffer.GetResource(), DstOffset, SrcBuffer.GetResource(), SrcOffset, Size);
 }
 
 void FD3D12DynamicRHI::CreateRawBuffer(ComPtr<ID3D12Resource>& outBuffer, uint64_t size, D3D12_RESOURCE_FLAGS flags, D3D12_RESOURCE_STATES initState, const D3D12_HEAP_PROPERTIES& heapProps) const
@@ -574,23 +942,62 @@ void FD3D12DynamicRHI::CreateRawBuffer(ComPtr<ID3D12Resource>& outBuffer, uint64
 
     ThrowIfFailed(GetDevice()->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &bufDesc,
         initState, nullptr, IID_PPV_ARGS(&outBuffer)));
+
+    RecordResourceCreation(outBuffer.Get());
 }
 
 std::unique_ptr<FComputeContext> FD3D12DynamicRHI::GetComputeContext()
 {
+    std::lock_guard Lock(ContextPoolMutex);
+    std::unique_ptr<FComputeContext> Context;
     if (ComputeContextQueue.empty())
     {
-        std::unique_ptr<FComputeContext> Context = std::make_unique<FComputeContext>();
-        return Context;
+        Context = std::make_unique<FComputeContext>();
     }
     else
     {
-        std::unique_ptr<FComputeContext> Ret = std::move(ComputeContextQueue.front());
+        Context = std::move(ComputeContextQueue.front());
         ComputeContextQueue.pop();
-        return Ret;
+    }
+
+    Context->SetCommandCapture(CommandCapture.load());
+    return Context;
+}
+
+void FD3D12DynamicRHI::SetCommandCapture(FCommandCapture* Capture)
+{
+    // The open upload batch picked up the previous capture.
+    FlushUploads();
+    CommandCapture = Capture;
+
+    // Pooled compute and copy contexts pick the capture up when they are handed out.
+    for (const std::unique_ptr<FGraphicsContext>& Context : PerFrameGraphicsContexts)
+    {
+        Context->SetCommandCapture(Capture);
     }
 }
 
+void FD3D12DynamicRHI::RecordResourceCreation(ID3D12Resource* Resource) const
+{
+    FCommandCapture* Capture = CommandCapture.load();
+    if (!Capture || !Resource)
+    {
+        return;
+    }
+
+    const D3D12_RESOURCE_DESC Desc = Resource->GetDesc();
+    Capture->Record(Capture::NULL_OBJECT, ECapturedCommand::CreateResource, Capture::FCreateResource{
+        .Resource = Capture->GetObjectId(Resource),
+        .Dimension = static_cast<uint32_t>(Desc.Dimension),
+        .Width = Desc.Width,
+        .Height = Desc.Height,
+        .DepthOrArraySize = Desc.DepthOrArraySize,
+        .MipLevels = Desc.MipLevels,
+        .Format = static_cast<uint32_t>(Desc.Format),
+        .Flags = static_cast<uint32_t>(Desc.Flags),
+    });
+}
+
 void FD3D12DynamicRHI::GenerateMipmap(FTexture* Texture)
 {
     MipmapGenerator->GenerateMipmap(Texture);
@@ -624,6 +1031,13 @@ void FD3D12DynamicRHI::InitDeviceResources()
 
 void FD3D12DynamicRHI::InitSwapchainResources(const uint32_t Width, const uint32_t Height)
 {
+    if (IsHeadless())
+    {
+        CurrentFrameIndex = 0u;
+        CreateBackBufferRTVs();
+        return;
+    }
+
     const DXGI_SWAP_CHAIN_DESC1 swapChainDesc = {
         .Width = Width,
         .Height = Height,
@@ -665,6 +1079,16 @@ void FD3D12DynamicRHI::ResizeSwapchainResources(uint32_t InWidth, uint32_t InHei
         BackBuffers[i].reset();
     }
 
+    BackBufferWidth = InWidth;
+    BackBufferHeight = InHeight;
+
+    if (IsHeadless())
+    {
+        CurrentFrameIndex = 0u;
+        CreateBackBufferRTVs();
+        return;
+    }
+
     // Resize the swap chain buffers
     DXGI_SWAP_CHAIN_DESC swapChainDesc;
     SwapChain->GetDesc(&swapChainDesc);
@@ -701,9 +1125,16 @@ void FD3D12DynamicRHI::InitD3D12Core()
 
     ThrowIfFailed(::CreateDXGIFactory2(dxgiFactoryCreationFlags, IID_PPV_ARGS(&Factory)));
 
-    // Select the adapter (in this case GPU with best performance).
-    ThrowIfFailed(
-        Factory->EnumAdapterByGpuPreference(0u, DXGI_GPU_PREFERENCE_HIGH_PERFORMANCE, IID_PPV_ARGS(&Adapter)));
+    // Select the adapter (in this case GPU with best performance), headless runs use the software rasterizer.
+    if (IsHeadless())
+    {
+        ThrowIfFailed(Factory->EnumWarpAdapter(IID_PPV_ARGS(&Adapter)));
+    }
+    else
+    {
+        ThrowIfFailed(
+            Factory->EnumAdapterByGpuPreference(0u, DXGI_GPU_PREFERENCE_HIGH_PERFORMANCE, IID_PPV_ARGS(&Adapter)));
+    }
 
     if (!Adapter)
     {
@@ -728,13 +1159,13 @@ void FD3D12DynamicRHI::InitD3D12Core()
 void FD3D12DynamicRHI::InitCommandQueues()
 {
     DirectCommandQueue =
-        std::make_unique<FCommandQueue>(Device.Get(), D3D12_COMMAND_LIST_TYPE_DIRECT, L"Direct Command Queue");
+        std::make_unique<FCommandQueue>(Device.Get(), D3D12_COMMAND_LIST_TYPE_DIRECT, L"Direct Command Queue", &ResourceStateTable);
 
     CopyCommandQueue =
-        std::make_unique<FCommandQueue>(Device.Get(), D3D12_COMMAND_LIST_TYPE_COPY, L"Copy Command Queue");
+        std::make_unique<FCommandQueue>(Device.Get(), D3D12_COMMAND_LIST_TYPE_COPY, L"Copy Command Queue", &ResourceStateTable);
 
     ComputeCommandQueue =
-        std::make_unique<FCommandQueue>(Device.Get(), D3D12_COMMAND_LIST_TYPE_COMPUTE, L"Compute Command Queue");
+        std::make_unique<FCommandQueue>(Device.Get(), D3D12_COMMAND_LIST_TYPE_COMPUTE, L"Compute Command Queue", &ResourceStateTable);
 }
 
 void FD3D12DynamicRHI::InitDescriptorHeaps()
@@ -751,11 +1182,23 @@ void FD3D12DynamicRHI::InitDescriptorHeaps()
 
     SamplerDescriptorHeap = std::make_unique<FDescriptorHeap>(Device.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER,
         GNumSamplerDescriptorHeap, L"Sampler Descriptor Heap");
+
+    // Async compute joins the direct queue every frame and copies read no descriptor, once the direct queue is
+    // past the frame a slot was freed in nothing reads it anymore.
+    for (FDescriptorHeap* Heap : { CbvSrvUavDescriptorHeap.get(), RtvDescriptorHeap.get(), DsvDescriptorHeap.get(), SamplerDescriptorHeap.get() })
+    {
+        Heap->SetRetireQueue(DirectCommandQueue.get());
+    }
 }
 
 void FD3D12DynamicRHI::InitMemoryAllocator()
 {
     MemoryAllocator = std::make_unique<FMemoryAllocator>(Device.Get(), Adapter.Get());
+    UploadRing = std::make_unique<FUploadRing>(*MemoryAllocator, UPLOAD_RING_SIZE);
+
+    // Anything submitted to these queues may read a resource whose upload is still in the open batch.
+    DirectCommandQueue->SetPreExecuteCallback([this]() { FlushUploads(); });
+    ComputeCommandQueue->SetPreExecuteCallback([this]() { FlushUploads(); });
 }
 
 void FD3D12DynamicRHI::InitContexts()
@@ -766,7 +1209,7 @@ void FD3D12DynamicRHI::InitContexts()
         PerFrameGraphicsContexts[i] = std::make_unique<FGraphicsContext>();
     }
 
-    CopyContext = std::make_unique<FCopyContext>();
+    FreeCopyContexts.push_back(CopyContexts.emplace_back(std::make_unique<FCopyContext>()).get());
 }
 
 void FD3D12DynamicRHI::InitBindlessRootSignature()
@@ -829,6 +1272,8 @@ uint32_t FD3D12DynamicRHI::CreateRtv(const FRtvCreationDesc& RtvCreationDesc, ID
 template<typename T>
 FBuffer FD3D12DynamicRHI::CreateBuffer(const FBufferCreationDesc& BufferCreationDesc, const std::span<const T> Data) const
 {
+    Stats.NumBuffersCreated++;
+
     FBuffer Buffer{};
 
     // If data.size() == 0, it means that the data to fill the buffer will be passed later on (via the Update
@@ -851,37 +1296,24 @@ FBuffer FD3D12DynamicRHI::CreateBuffer(const FBufferCreationDesc& BufferCreation
 
     std::scoped_lock<std::recursive_mutex> LockGuard(ResourceMutex);
 
-    // Currently, not using a backing storage for upload context's and such. Simply using D3D12MA to create a upload
-    // buffer, copy the data onto the upload buffer, and then copy data from upload buffer -> GPU only buffer.
-    if (Data.data())
+    if (Data.data() && BufferCreationDesc.Usage == EBufferUsage::DynamicStructuredBuffer)
     {
-        // Create upload buffer.
-        const FBufferCreationDesc UploadBufferCreationDesc = {
-            .Usage = EBufferUsage::UploadBuffer,
-            .Name = L"Upload buffer - " + std::wstring(BufferCreationDesc.Name),
-        };
-
-        FResourceCreationDesc UploadResourceCreationDesc =
-            FResourceCreationDesc::CreateBufferResourceCreationDesc(SizeInBytes);
-
-        FAllocation UploadAllocation =
-            MemoryAllocator->CreateBufferResourceAllocation(UploadBufferCreationDesc, UploadResourceCreationDesc);
-
-        UploadAllocation.Update(Data.data(), SizeInBytes);
-
-        CopyContext->Reset();
-
-        // Get a copy command and list and execute copy resource functions on the command queue.
-        CopyContext->GetD3D12CommandList()->CopyResource(Buffer.Allocation.Resource.Get(), UploadAllocation.Resource.Get());
-
-        CopyCommandQueue->ExecuteContext(CopyContext.get());
-        CopyCommandQueue->Flush();
+        // Already in CPU visible memory.
+        Buffer.Allocation.Update(Data.data(), SizeInBytes);
+    }
+    else if (Data.data())
+    {
+        // Staged in the upload ring, the copy goes out with the next upload batch.
+        const FUploadRegion Upload = AllocateUpload(SizeInBytes, UPLOAD_BUFFER_ALIGNMENT);
+        std::memcpy(Upload.CpuAddress, Data.data(), SizeInBytes);
 
-        UploadAllocation.Reset();
+        GetUploadBatchContext()->GetD3D12CommandList()->CopyBufferRegion(
+            Buffer.Allocation.Resource.Get(), 0u, Upload.Resource, Upload.Offset, SizeInBytes);
     }
 
     // Create relevant descriptor's.
-    if (BufferCreationDesc.Usage == EBufferUsage::StructuredBuffer || BufferCreationDesc.Usage == EBufferUsage::StructuredBufferUAV)
+    if (BufferCreationDesc.Usage == EBufferUsage::StructuredBuffer || BufferCreationDesc.Usage == EBufferUsage::StructuredBufferUAV
+        || BufferCreationDesc.Usage == EBufferUsage::DynamicStructuredBuffer)
     {
         const FSrvCreationDesc SrvCreationDesc = {
             .SrvDesc =
@@ -934,13 +1366,22 @@ FBuffer FD3D12DynamicRHI::CreateBuffer(const FBufferCreationDesc& BufferCreation
         Buffer.UavIndex = CreateUav(UavCreationDesc, Buffer.Allocation.Resource.Get());
     }
 
+    RecordResourceCreation(Buffer.Allocation.Resource.Get());
     return Buffer;
 }
 
 FBuffer FD3D12DynamicRHI::CreateBuffer(const FBufferCreationDesc& BufferCreationDesc, size_t TotalBytes) const
 {
+    return CreateBuffer(BufferCreationDesc, 1u, TotalBytes);
+}
+
+FBuffer FD3D12DynamicRHI::CreateBuffer(const FBufferCreationDesc& BufferCreationDesc, size_t NumElements, size_t ElementSizeInBytes) const
+{
+    Stats.NumBuffersCreated++;
+
     FBuffer Buffer{};
 
+    const size_t TotalBytes = NumElements * ElementSizeInBytes;
     FResourceCreationDesc ResourceCreationDesc = FResourceCreationDesc::CreateBufferResourceCreationDesc(TotalBytes);
 
     if (BufferCreationDesc.Usage == EBufferUsage::StructuredBufferUAV)
@@ -950,13 +1391,14 @@ FBuffer FD3D12DynamicRHI::CreateBuffer(const FBufferCreationDesc& BufferCreation
 
     Buffer.Allocation = MemoryAllocator->CreateBufferResourceAllocation(BufferCreationDesc, ResourceCreationDesc);
     Buffer.SizeInBytes = TotalBytes;
-    Buffer.NumElement = 1;
-    Buffer.ElementSizeInBytes = TotalBytes;
+    Buffer.NumElement = NumElements;
+    Buffer.ElementSizeInBytes = ElementSizeInBytes;
 
     std::scoped_lock<std::recursive_mutex> LockGuard(ResourceMutex);
 
     // Create relevant descriptor's.
-    if (BufferCreationDesc.Usage == EBufferUsage::StructuredBuffer || BufferCreationDesc.Usage == EBufferUsage::StructuredBufferUAV)
+    if (BufferCreationDesc.Usage == EBufferUsage::StructuredBuffer || BufferCreationDesc.Usage == EBufferUsage::StructuredBufferUAV
+        || BufferCreationDesc.Usage == EBufferUsage::DynamicStructuredBuffer)
     {
         const FSrvCreationDesc SrvCreationDesc = {
             .SrvDesc =
@@ -967,8 +1409,8 @@ FBuffer FD3D12DynamicRHI::CreateBuffer(const FBufferCreationDesc& BufferCreation
                     .Buffer =
                         {
                             .FirstElement = 0u,
-                            .NumElements = 1,
-                            .StructureByteStride = (UINT)TotalBytes,
+                            .NumElements = (UINT)NumElements,
+                            .StructureByteStride = (UINT)ElementSizeInBytes,
                         },
                 },
         };
@@ -998,8 +1440,8 @@ FBuffer FD3D12DynamicRHI::CreateBuffer(const FBufferCreationDesc& BufferCreation
                     .Buffer =
                         {
                             .FirstElement = 0u,
-                            .NumElements = 1,
-                            .StructureByteStride = (UINT)TotalBytes,
+                            .NumElements = (UINT)NumElements,
+                            .StructureByteStride = (UINT)ElementSizeInBytes,
                             .CounterOffsetInBytes = 0u,
                             .Flags = D3D12_BUFFER_UAV_FLAG_NONE,
                         },
@@ -1009,6 +1451,7 @@ FBuffer FD3D12DynamicRHI::CreateBuffer(const FBufferCreationDesc& BufferCreation
         Buffer.UavIndex = CreateUav(UavCreationDesc, Buffer.Allocation.Resource.Get());
     }
 
+    RecordResourceCreation(Buffer.Allocation.Resource.Get());
     return Buffer;
 }
 
@@ -1016,7 +1459,6 @@ FBuffer FD3D12DynamicRHI::CreateBuffer(const FBufferCreationDesc& BufferCreation
     template FBuffer FD3D12DynamicRHI::CreateBuffer<TYPE>( \
         const FBufferCreationDesc& BufferCreationDesc, const std::span<const TYPE> Data) const; \
 
-CREATE_BUFFER_TEMPLATE_FUNC(interlop::MaterialBuffer)
 CREATE_BUFFER_TEMPLATE_FUNC(XMFLOAT4)
 CREATE_BUFFER_TEMPLATE_FUNC(XMFLOAT3)
 CREATE_BUFFER_TEMPLATE_FUNC(XMFLOAT2)
@@ -1030,9 +1472,26 @@ CREATE_BUFFER_TEMPLATE_FUNC(interlop::SSAOKernelBuffer)
 CREATE_BUFFER_TEMPLATE_FUNC(interlop::FRaytracingGeometryInfo)
 CREATE_BUFFER_TEMPLATE_FUNC(interlop::FRaytracingMaterial)
 CREATE_BUFFER_TEMPLATE_FUNC(interlop::MeshVertex)
+CREATE_BUFFER_TEMPLATE_FUNC(interlop::InstanceData)
 
 void FD3D12DynamicRHI::CreateBackBufferRTVs()
 {
+    if (IsHeadless())
+    {
+        // Nothing is presented, plain render targets take the place of the swapchain buffers.
+        for (const uint32_t i : std::views::iota(0u, FRAMES_IN_FLIGHT))
+        {
+            BackBuffers[i] = CreateTexture(FTextureCreationDesc{
+                .Usage = ETextureUsage::RenderTarget,
+                .Width = BackBufferWidth,
+                .Height = BackBufferHeight,
+                .Format = SwapchainFormat,
+                .Name = L"Headless BackBuffer",
+            });
+        }
+        return;
+    }
+
     // Create Backbuffer render target views.
     for (const uint32_t i : std::views::iota(0u, FRAMES_IN_FLIGHT))
     {
@@ -1048,32 +1507,56 @@ void FD3D12DynamicRHI::CreateBackBufferRTVs()
         BackBuffers[i]->Allocation.Resource->SetName(L"SwapChain BackBuffer");
         BackBuffers[i]->RtvIndex = RtvIndex;
         BackBuffers[i]->ResourceState = D3D12_RESOURCE_STATE_PRESENT;
+        ResourceStateTable.Register(BackBuffer.Get(), 1u, D3D12_RESOURCE_STATE_PRESENT);
     }
 }
 
 void FD3D12DynamicRHI::BeginFrame()
 {
     MaintainQueryHeap();
+    for (FDescriptorHeap* Heap : { CbvSrvUavDescriptorHeap.get(), RtvDescriptorHeap.get(), DsvDescriptorHeap.get(), SamplerDescriptorHeap.get() })
+    {
+        Heap->ReleaseRetiredDescriptors();
+    }
+    DeferredReleaseQueue.Retire(DirectCommandQueue->GetCompletedFenceValue());
+    GeometryPool->BeginFrame();
+    MaterialTable->BeginFrame();
     PerFrameGraphicsContexts[CurrentFrameIndex]->Reset();
 }
 
 void FD3D12DynamicRHI::Present()
 {
+    if (IsHeadless())
+    {
+        return;
+    }
+
     ThrowIfFailed(SwapChain->Present(1u, 0u));
 }
 
 void FD3D12DynamicRHI::EndFrame()
 {
     FenceValues[CurrentFrameIndex].DirectQueueFenceValue = DirectCommandQueue->Signal();
+    DeferredReleaseQueue.CloseBatch(FenceValues[CurrentFrameIndex].DirectQueueFenceValue);
+    for (FDescriptorHeap* Heap : { CbvSrvUavDescriptorHeap.get(), RtvDescriptorHeap.get(), DsvDescriptorHeap.get(), SamplerDescriptorHeap.get() })
+    {
+        Heap->CloseRetireBatch(FenceValues[CurrentFrameIndex].DirectQueueFenceValue);
+    }
+    Stats.NumFrames++;
 
-    CurrentFrameIndex = SwapChain->GetCurrentBackBufferIndex();
+    CurrentFrameIndex = IsHeadless() ? (CurrentFrameIndex + 1u) % FRAMES_IN_FLIGHT : SwapChain->GetCurrentBackBufferIndex();
 
     DirectCommandQueue->WaitForFenceValue(FenceValues[CurrentFrameIndex].DirectQueueFenceValue);
+
+    // The frame just waited on was the last to read the constants of the region the next frame writes.
+    ConstantBufferAllocator->BeginFrame();
 }
 
 void FD3D12DynamicRHI::FlushAllQueue()
 {
+    FlushUploads();
     DirectCommandQueue->Flush(); // flush GPU works
     CopyCommandQueue->Flush();
     ComputeCommandQueue->Flush();
+    DeferredReleaseQueue.Retire(DirectCommandQueue->GetCompletedFenceValue());
 }
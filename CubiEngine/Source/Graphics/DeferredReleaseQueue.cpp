@@ -0,0 +1,89 @@
+#include "Graphics/DeferredReleaseQueue.h"
+
+FDeferredReleaseQueue::~FDeferredReleaseQueue()
+{
+    assert(Entries.empty() && OpenEntries.empty() && "Retire everything while what the entries release is still alive.");
+}
+
+void FDeferredReleaseQueue::EnqueueCallback(uint64_t FenceValue, std::function<void()> Release, uint64_t NumBytes)
+{
+    EnqueueRelease(FenceValue, std::make_unique<FCallbackRelease>(std::move(Release)), NumBytes);
+}
+
+void FDeferredReleaseQueue::EnqueueRelease(uint64_t FenceValue, std::unique_ptr<FRelease>&& Release, uint64_t NumBytes)
+{
+    std::scoped_lock Lock(Mutex);
+
+    FEntry Entry{ .FenceValue = FenceValue, .NumBytes = NumBytes, .Release = std::move(Release) };
+    if (FenceValue == OPEN_BATCH)
+    {
+        OpenEntries.push_back(std::move(Entry));
+    }
+    else
+    {
+        Entries.push_back(std::move(Entry));
+    }
+
+    Stats.NumPending++;
+    Stats.PendingBytes += NumBytes;
+    if (Stats.PendingBytes > Stats.PeakPendingBytes)
+    {
+        Stats.PeakPendingBytes = Stats.PendingBytes;
+    }
+}
+
+void FDeferredReleaseQueue::CloseBatch(uint64_t FenceValue)
+{
+    assert(FenceValue != OPEN_BATCH);
+
+    std::scoped_lock Lock(Mutex);
+    for (FEntry& Entry : OpenEntries)
+    {
+        Entry.FenceValue = FenceValue;
+        Entries.push_back(std::move(Entry));
+    }
+    OpenEntries.clear();
+}
+
+uint32_t FDeferredReleaseQueue::RetireAll()
+{
+    {
+        std::scoped_lock Lock(Mutex);
+        for (FEntry& Entry : OpenEntries)
+        {
+            Entries.push_back(std::move(Entry));
+        }
+        OpenEntries.clear();
+    }
+    return Retire(OPEN_BATCH);
+}
+
+uint32_t FDeferredReleaseQueue::Retire(uint64_t CompletedFenceValue)
+{
+    std::vector<std::unique_ptr<FRelease>> Released;
+    {
+        std::scoped_lock Lock(Mutex);
+        while (!Entries.empty() && Entries.front().FenceValue <= CompletedFenceValue)
+        {
+            FEntry& Entry = Entries.front();
+            Stats.NumPending--;
+            Stats.PendingBytes -= Entry.NumBytes;
+            Stats.NumReleased++;
+            Stats.ReleasedBytes += Entry.NumBytes;
+
+            Released.push_back(std::move(Entry.Release));
+            Entries.pop_front();
+        }
+    }
+
+    // Releasing may enqueue more, e.g. a texture handing its descriptors back.
+    const uint32_t NumReleased = static_cast<uint32_t>(Released.size());
+    Released.clear();
+    return NumReleased;
+}
+
+FDeferredReleaseStats FDeferredReleaseQueue::GetStats() const
+{
+    std::scoped_lock Lock(Mutex);
+    return Stats;
+}
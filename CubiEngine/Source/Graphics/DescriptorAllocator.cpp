@@ -0,0 +1,221 @@
+#include "Graphics/DescriptorAllocator.h"
+
+namespace
+{
+    struct FThreadCacheEntry
+    {
+        uint64_t AllocatorId;
+        void* Cache;
+    };
+
+    // Caches of the calling thread, one per allocator it allocated from. Entries of destroyed allocators stay
+    // behind, their ids are never handed out again.
+    thread_local std::vector<FThreadCacheEntry> GCurrentThreadCaches;
+    std::atomic<uint64_t> GNextAllocatorId{ 0u };
+
+    constexpr uint64_t PackHead(uint64_t Tag, uint32_t Index)
+    {
+        return (Tag << 32u) | Index;
+    }
+}
+
+FDescriptorAllocator::FDescriptorAllocator(uint32_t InNumDescriptors)
+    : NumDescriptors(InNumDescriptors)
+    // Small heaps, RTVs and DSVs, would be mostly stranded in thread caches with large batches.
+    , BatchSize(std::clamp(InNumDescriptors / 64u, 1u, MAX_BATCH_SIZE))
+    , Id(GNextAllocatorId.fetch_add(1u, std::memory_order_relaxed))
+    , SlotNext(std::make_unique<uint32_t[]>(InNumDescriptors))
+    , BatchNext(std::make_unique<std::atomic<uint32_t>[]>(InNumDescriptors))
+    , BatchCount(std::make_unique<uint32_t[]>(InNumDescriptors))
+    , RetireFenceValue(std::make_unique<uint64_t[]>(InNumDescriptors))
+    , Allocated(std::make_unique<std::atomic<bool>[]>(InNumDescriptors))
+    , FreeBatches(PackHead(0u, INVALID_INDEX_U32))
+{
+    assert(InNumDescriptors > 0u && InNumDescriptors < INVALID_INDEX_U32);
+}
+
+FDescriptorAllocator::~FDescriptorAllocator() = default;
+
+uint32_t FDescriptorAllocator::Allocate()
+{
+    FThreadCache& Cache = GetThreadCache();
+    if (Cache.NumSlots == 0u && !Refill(Cache))
+    {
+        return INVALID_INDEX_U32;
+    }
+
+    const uint32_t Index = Cache.Slots[--Cache.NumSlots];
+    [[maybe_unused]] const bool bWasAllocated = Allocated[Index].exchange(true, std::memory_order_relaxed);
+    assert(!bWasAllocated);
+    return Index;
+}
+
+void FDescriptorAllocator::Free(uint32_t Index, uint64_t FenceValue)
+{
+    if (Index >= NumDescriptors || !Allocated[Index].exchange(false, std::memory_order_relaxed))
+    {
+        assert(false && "Attempted to free an invalid descriptor index.");
+        return;
+    }
+
+    RetireFenceValue[Index] = FenceValue;
+    PushSlots(FenceValue == OPEN_BATCH ? OpenHead : RetiredHead, Index, Index);
+}
+
+void FDescriptorAllocator::CloseBatch(uint64_t FenceValue)
+{
+    assert(FenceValue != OPEN_BATCH);
+
+    const uint32_t First = OpenHead.exchange(INVALID_INDEX_U32, std::memory_order_acquire);
+    if (First == INVALID_INDEX_U32)
+    {
+        return;
+    }
+
+    uint32_t Last = First;
+    for (uint32_t Index = First; Index != INVALID_INDEX_U32; Index = SlotNext[Index])
+    {
+        RetireFenceValue[Index] = FenceValue;
+        Last = Index;
+    }
+    PushSlots(RetiredHead, First, Last);
+}
+
+uint32_t FDescriptorAllocator::ReleaseRetired(uint64_t CompletedFenceValue)
+{
+    uint32_t NumReleased = 0u;
+    uint32_t BatchFirst = INVALID_INDEX_U32;
+    uint32_t NumBatchSlots = 0u;
+
+    auto Release = [&](uint32_t Index) {
+        SlotNext[Index] = BatchFirst;
+        BatchFirst = Index;
+        NumReleased++;
+        if (++NumBatchSlots == BatchSize)
+        {
+            PushBatch(BatchFirst, NumBatchSlots);
+            BatchFirst = INVALID_INDEX_U32;
+            NumBatchSlots = 0u;
+        }
+    };
+
+    std::erase_if(WaitingSlots, [&](uint32_t Index) {
+        if (RetireFenceValue[Index] > CompletedFenceValue)
+        {
+            return false;
+        }
+        Release(Index);
+        return true;
+    });
+
+    uint32_t Index = RetiredHead.exchange(INVALID_INDEX_U32, std::memory_order_acquire);
+    while (Index != INVALID_INDEX_U32)
+    {
+        // Release relinks the slot.
+        const uint32_t Next = SlotNext[Index];
+        if (RetireFenceValue[Index] <= CompletedFenceValue)
+        {
+            Release(Index);
+        }
+        else
+        {
+            WaitingSlots.push_back(Index);
+        }
+        Index = Next;
+    }
+
+    if (NumBatchSlots > 0u)
+    {
+        PushBatch(BatchFirst, NumBatchSlots);
+    }
+    return NumReleased;
+}
+
+FDescriptorAllocator::FThreadCache& FDescriptorAllocator::GetThreadCache()
+{
+    for (const FThreadCacheEntry& Entry : GCurrentThreadCaches)
+    {
+        if (Entry.AllocatorId == Id)
+        {
+            return *static_cast<FThreadCache*>(Entry.Cache);
+        }
+    }
+
+    FThreadCache* Cache = nullptr;
+    {
+        std::scoped_lock Lock(RegistrationMutex);
+        Cache = ThreadCaches.emplace_back(std::make_unique<FThreadCache>()).get();
+    }
+    GCurrentThreadCaches.push_back(FThreadCacheEntry{ .AllocatorId = Id, .Cache = Cache });
+    return *Cache;
+}
+
+bool FDescriptorAllocator::Refill(FThreadCache& Cache)
+{
+    // Recycled slots first, keeping the heap compact.
+    uint64_t Head = FreeBatches.load(std::memory_order_acquire);
+    while (static_cast<uint32_t>(Head) != INVALID_INDEX_U32)
+    {
+        const uint32_t First = static_cast<uint32_t>(Head);
+        // Stale when another thread popped First meanwhile, the tag then makes the exchange fail.
+        const uint64_t Next = PackHead((Head >> 32u) + 1u, BatchNext[First].load(std::memory_order_relaxed));
+        if (FreeBatches.compare_exchange_weak(Head, Next, std::memory_order_acquire, std::memory_order_acquire))
+        {
+            const uint32_t Count = BatchCount[First];
+            assert(Count > 0u && Count <= MAX_BATCH_SIZE);
+
+            // Stored backwards so the slots go out in batch order.
+            uint32_t Slot = First;
+            for (uint32_t SlotIndex = Count; SlotIndex > 0u; SlotIndex--)
+            {
+                Cache.Slots[SlotIndex - 1u] = Slot;
+                Slot = SlotNext[Slot];
+            }
+            Cache.NumSlots = Count;
+            return true;
+        }
+    }
+
+    // Checked first so a heap that stays exhausted does not keep growing the counter.
+    if (NextFreshIndex.load(std::memory_order_relaxed) >= NumDescriptors)
+    {
+        return false;
+    }
+    const uint32_t Begin = NextFreshIndex.fetch_add(BatchSize, std::memory_order_relaxed);
+    if (Begin >= NumDescriptors)
+    {
+        return false;
+    }
+
+    const uint32_t Count = NumDescriptors - Begin < BatchSize ? NumDescriptors - Begin : BatchSize;
+    for (uint32_t SlotIndex = 0u; SlotIndex < Count; SlotIndex++)
+    {
+        Cache.Slots[SlotIndex] = Begin + Count - 1u - SlotIndex;
+    }
+    Cache.NumSlots = Count;
+    return true;
+}
+
+void FDescriptorAllocator::PushSlots(std::atomic<uint32_t>& List, uint32_t First, uint32_t Last)
+{
+    // Only ReleaseRetired and CloseBatch take from the lists, and they take them whole, so pushes cannot suffer
+    // from ABA.
+    uint32_t Head = List.load(std::memory_order_relaxed);
+    do
+    {
+        SlotNext[Last] = Head;
+    } while (!List.compare_exchange_weak(Head, First, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void FDescriptorAllocator::PushBatch(uint32_t First, uint32_t Count)
+{
+    BatchCount[First] = Count;
+
+    uint64_t Head = FreeBatches.load(std::memory_order_relaxed);
+    uint64_t NewHead;
+    do
+    {
+        BatchNext[First].store(static_cast<uint32_t>(Head), std::memory_order_relaxed);
+        NewHead = PackHead((Head >> 32u) + 1u, First);
+    } while (!FreeBatches.compare_exchange_weak(Head, NewHead, std::memory_order_release, std::memory_order_relaxed));
+}
@@ -1,5 +1,7 @@
 #include "Graphics/DescriptorHeap.h"
 
+#include "Graphics/CommandQueue.h"
+
 FDescriptorHeap::FDescriptorHeap(ID3D12Device* const device, const D3D12_DESCRIPTOR_HEAP_TYPE descriptorHeapType,
     const uint32_t descriptorCount, const std::wstring_view descriptorHeapName)
 {
@@ -30,7 +32,7 @@ FDescriptorHeap::FDescriptorHeap(ID3D12Device* const device, const D3D12_DESCRIP
         .DescriptorSize = DescriptorSize,
     };
 
-    AllocatedDescriptors.resize(NumDescriptor, false);
+    Allocator = std::make_unique<FDescriptorAllocator>(NumDescriptor);
 }
 
 FDescriptorHandle FDescriptorHeap::GetDescriptorHandleFromIndex(const uint32_t Index) const
@@ -48,39 +50,27 @@ FDescriptorHandle FDescriptorHeap::GetDescriptorHandleFromIndex(const uint32_t I
 
 uint32_t FDescriptorHeap::AllocateDescriptor()
 {
-    std::scoped_lock Lock(AllocationMutex);
-
-    uint32_t Index{};
-    if (!FreeDescriptorIndices.empty())
-    {
-        Index = FreeDescriptorIndices.back();
-        FreeDescriptorIndices.pop_back();
-    }
-    else
+    const uint32_t Index = Allocator->Allocate();
+    if (Index == INVALID_INDEX_U32)
     {
-        if (NextDescriptorIndex >= NumDescriptor)
-        {
-            FatalError("Descriptor heap capacity exceeded.");
-        }
-        Index = NextDescriptorIndex++;
+        FatalError("Descriptor heap capacity exceeded.");
     }
-
-    assert(!AllocatedDescriptors[Index]);
-    AllocatedDescriptors[Index] = true;
     return Index;
 }
 
 void FDescriptorHeap::FreeDescriptor(uint32_t Index)
 {
-    std::scoped_lock Lock(AllocationMutex);
-    if (Index >= NumDescriptor || !AllocatedDescriptors[Index])
-    {
-        assert(false && "Attempted to free an invalid descriptor index.");
-        return;
-    }
+    Allocator->Free(Index, RetireQueue ? FDescriptorAllocator::OPEN_BATCH : 0u);
+}
+
+void FDescriptorHeap::CloseRetireBatch(uint64_t FenceValue)
+{
+    Allocator->CloseBatch(FenceValue);
+}
 
-    AllocatedDescriptors[Index] = false;
-    FreeDescriptorIndices.push_back(Index);
+void FDescriptorHeap::ReleaseRetiredDescriptors()
+{
+    Allocator->ReleaseRetired(RetireQueue ? RetireQueue->GetCompletedFenceValue() : UINT64_MAX);
 }
 
 void FDescriptorHeap::OffsetDescriptor(FDescriptorHandle& InHandle, const uint32_t Offset) const
@@ -0,0 +1,181 @@
+#include "Graphics/FenceWatcher.h"
+
+FD3D12Fence::FD3D12Fence(ID3D12Device5* const Device, const std::wstring_view Name)
+{
+    ThrowIfFailed(Device->CreateFence(0u, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&Fence)));
+    Fence->SetName(Name.data());
+
+    // Both auto reset, a stale completion or interrupt only causes one extra loop in the watcher.
+    CompletionEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    InterruptEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (!CompletionEvent || !InterruptEvent)
+    {
+        FatalError("Failed to create fence events.");
+    }
+}
+
+FD3D12Fence::~FD3D12Fence()
+{
+    CloseHandle(CompletionEvent);
+    CloseHandle(InterruptEvent);
+}
+
+uint64_t FD3D12Fence::GetCompletedValue() const
+{
+    return Fence->GetCompletedValue();
+}
+
+void FD3D12Fence::WaitForValue(uint64_t Value)
+{
+    if (Fence->GetCompletedValue() >= Value)
+    {
+        return;
+    }
+
+    ThrowIfFailed(Fence->SetEventOnCompletion(Value, CompletionEvent));
+
+    const HANDLE Events[] = { CompletionEvent, InterruptEvent };
+    WaitForMultipleObjects(_countof(Events), Events, FALSE, INFINITE);
+}
+
+void FD3D12Fence::Interrupt()
+{
+    SetEvent(InterruptEvent);
+}
+
+void FFakeFence::Signal(uint64_t Value)
+{
+    {
+        std::lock_guard Lock(Mutex);
+        CompletedValue = max(CompletedValue, Value);
+    }
+    Condition.notify_all();
+}
+
+uint64_t FFakeFence::GetCompletedValue() const
+{
+    std::lock_guard Lock(Mutex);
+    return CompletedValue;
+}
+
+void FFakeFence::WaitForValue(uint64_t Value)
+{
+    std::unique_lock Lock(Mutex);
+    Condition.wait(Lock, [&]() { return CompletedValue >= Value || bInterrupted; });
+    bInterrupted = false;
+}
+
+void FFakeFence::Interrupt()
+{
+    {
+        std::lock_guard Lock(Mutex);
+        bInterrupted = true;
+    }
+    Condition.notify_all();
+}
+
+FFenceWatcher::FFenceWatcher(FGPUFence& InFence)
+    : Fence(InFence)
+{
+    Thread = std::thread(&FFenceWatcher::WatchLoop, this);
+}
+
+FFenceWatcher::~FFenceWatcher()
+{
+    {
+        std::lock_guard Lock(Mutex);
+        bQuit = true;
+    }
+    Fence.Interrupt();
+    Thread.join();
+
+    // Owners flush before destroying the watcher, so whatever is left waits on a value nobody signals.
+    // Dropping it would leak what the callback recycles, captured resources are released with the callback.
+    if (!PendingCallbacks.empty())
+    {
+        Log(std::format("Fence watcher destroyed with {} pending callbacks.", PendingCallbacks.size()));
+    }
+    assert(PendingCallbacks.empty() && "Fence watcher destroyed with callbacks for values that were never signaled.");
+}
+
+void FFenceWatcher::OnCompletion(uint64_t Value, std::function<void()> Callback)
+{
+    bool bInterrupt = false;
+    {
+        std::lock_guard Lock(Mutex);
+        PendingCallbacks.push(FPendingCallback{ .Value = Value, .Order = NextOrder++, .Callback = std::move(Callback) });
+
+        // The watcher is blocked on a later value (or on nothing), wake it so it re-targets.
+        bInterrupt = WaitingValue != 0u && Value < WaitingValue;
+    }
+
+    if (bInterrupt)
+    {
+        Fence.Interrupt();
+    }
+}
+
+void FFenceWatcher::WaitForCallbacks(uint64_t Value)
+{
+    assert(std::this_thread::get_id() != Thread.get_id());
+
+    std::unique_lock Lock(Mutex);
+    CallbacksRetired.wait(Lock, [&]()
+    {
+        return bQuit || (!bRunningCallbacks && (PendingCallbacks.empty() || PendingCallbacks.top().Value > Value));
+    });
+}
+
+uint32_t FFenceWatcher::GetNumPendingCallbacks() const
+{
+    std::lock_guard Lock(Mutex);
+    return static_cast<uint32_t>(PendingCallbacks.size());
+}
+
+void FFenceWatcher::WatchLoop()
+{
+    std::vector<std::function<void()>> ReadyCallbacks;
+
+    std::unique_lock Lock(Mutex);
+    while (true)
+    {
+        const uint64_t CompletedValue = Fence.GetCompletedValue();
+        while (!PendingCallbacks.empty() && PendingCallbacks.top().Value <= CompletedValue)
+        {
+            // priority_queue only hands out const references, the entry is popped right after.
+            ReadyCallbacks.push_back(std::move(const_cast<FPendingCallback&>(PendingCallbacks.top()).Callback));
+            PendingCallbacks.pop();
+        }
+
+        if (!ReadyCallbacks.empty())
+        {
+            bRunningCallbacks = true;
+            Lock.unlock();
+
+            for (const std::function<void()>& Callback : ReadyCallbacks)
+            {
+                Callback();
+            }
+            ReadyCallbacks.clear();
+
+            Lock.lock();
+            bRunningCallbacks = false;
+            CallbacksRetired.notify_all();
+            continue;
+        }
+
+        if (bQuit)
+        {
+            break;
+        }
+
+        // With nothing pending, wait on a value the fence only reaches on device removal, OnCompletion interrupts it.
+        WaitingValue = PendingCallbacks.empty() ? UINT64_MAX : PendingCallbacks.top().Value;
+        Lock.unlock();
+        Fence.WaitForValue(WaitingValue);
+        Lock.lock();
+        WaitingValue = 0u;
+    }
+
+    CallbacksRetired.notify_all();
+}
@@ -0,0 +1,261 @@
+#include "Graphics/GeometryPool.h"
+#include "Graphics/D3D12DynamicRHI.h"
+
+namespace
+{
+    constexpr std::array<std::wstring_view, FGeometryPool::NumVertexStreams> VERTEX_STREAM_NAMES = {
+        L"Geometry pool position buffer",
+        L"Geometry pool texture coord buffer",
+        L"Geometry pool normal buffer",
+        L"Geometry pool tangent buffer",
+    };
+}
+
+FGeometryPool::FGeometryPool()
+    : VertexAllocator(INITIAL_VERTEX_CAPACITY), IndexAllocator(INITIAL_INDEX_CAPACITY)
+{
+    for (uint32_t Stream = 0; Stream < NumVertexStreams; Stream++)
+    {
+        VertexBuffers[Stream] = CreateStreamBuffer(INITIAL_VERTEX_CAPACITY, VERTEX_STRIDES[Stream], VERTEX_STREAM_NAMES[Stream]);
+    }
+    IndexBuffer = CreateStreamBuffer(INITIAL_INDEX_CAPACITY, sizeof(uint32_t), L"Geometry pool index buffer");
+}
+
+FGeometryHandle FGeometryPool::Allocate(const FGeometryData& Data, std::wstring_view Name)
+{
+    assert(!Data.Positions.empty() && !Data.Indices.empty());
+
+    const uint32_t NumVertices = static_cast<uint32_t>(Data.Positions.size());
+    const uint32_t NumIndices = static_cast<uint32_t>(Data.Indices.size());
+
+    std::scoped_lock Lock(Mutex);
+
+    if (!Reserve(VertexAllocator, NumVertices, true) || !Reserve(IndexAllocator, NumIndices, false))
+    {
+        FatalError(std::format("Geometry pool can not hold {} vertices and {} indices of {}.",
+            NumVertices, NumIndices, wStringToString(Name)));
+    }
+
+    const FTLSFAllocator::FAllocation Vertices = VertexAllocator.Allocate(NumVertices).value();
+    const FTLSFAllocator::FAllocation Indices = IndexAllocator.Allocate(NumIndices).value();
+
+    uint32_t EntryIndex;
+    if (!FreeEntries.empty())
+    {
+        EntryIndex = FreeEntries.back();
+        FreeEntries.pop_back();
+    }
+    else
+    {
+        EntryIndex = static_cast<uint32_t>(Entries.size());
+        Entries.emplace_back();
+    }
+
+    Entries[EntryIndex] = FEntry{
+        .Range =
+            {
+                .BaseVertex = Vertices.Offset,
+                .NumVertices = NumVertices,
+                .FirstIndex = Indices.Offset,
+                .NumIndices = NumIndices,
+            },
+        .VertexNode = Vertices.Node,
+        .IndexNode = Indices.Node,
+    };
+
+    const std::array<const void*, NumVertexStreams> StreamData = {
+        Data.Positions.data(), Data.TextureCoords.data(), Data.Normals.data(), Data.Tangents.data(),
+    };
+    const std::array<size_t, NumVertexStreams> StreamSizes = {
+        Data.Positions.size(), Data.TextureCoords.size(), Data.Normals.size(), Data.Tangents.size(),
+    };
+
+    for (uint32_t Stream = 0; Stream < NumVertexStreams; Stream++)
+    {
+        if (StreamSizes[Stream] == 0u)
+        {
+            continue;
+        }
+
+        assert(StreamSizes[Stream] == NumVertices);
+        RHIUploadBufferRegion(VertexBuffers[Stream], uint64_t(Vertices.Offset) * VERTEX_STRIDES[Stream],
+            StreamData[Stream], uint64_t(NumVertices) * VERTEX_STRIDES[Stream]);
+    }
+    RHIUploadBufferRegion(IndexBuffer, uint64_t(Indices.Offset) * sizeof(uint32_t), Data.Indices.data(), uint64_t(NumIndices) * sizeof(uint32_t));
+
+    return FGeometryHandle{ .Index = EntryIndex };
+}
+
+void FGeometryPool::Free(FGeometryHandle Handle)
+{
+    assert(Handle.IsValid());
+
+    std::scoped_lock Lock(Mutex);
+    PendingFrees.push_back(FPendingFree{ .FrameNumber = FrameNumber, .EntryIndex = Handle.Index });
+}
+
+void FGeometryPool::BeginFrame()
+{
+    std::scoped_lock Lock(Mutex);
+
+    FrameNumber++;
+
+    while (!PendingFrees.empty() && PendingFrees.front().FrameNumber + FRAMES_IN_FLIGHT <= FrameNumber)
+    {
+        FEntry& Entry = Entries[PendingFrees.front().EntryIndex];
+        VertexAllocator.Free(Entry.VertexNode);
+        IndexAllocator.Free(Entry.IndexNode);
+        Entry = FEntry{};
+
+        FreeEntries.push_back(PendingFrees.front().EntryIndex);
+        PendingFrees.pop_front();
+    }
+}
+
+void FGeometryPool::Defragment()
+{
+    std::scoped_lock Lock(Mutex);
+
+    Compact(VertexAllocator, true);
+    Compact(IndexAllocator, false);
+    NumDefragments++;
+}
+
+FGeometryPoolStats FGeometryPool::GetStats() const
+{
+    std::scoped_lock Lock(Mutex);
+
+    return FGeometryPoolStats{
+        .NumAllocations = VertexAllocator.GetNumAllocations(),
+        .NumVertices = VertexAllocator.GetUsedSize(),
+        .VertexCapacity = VertexAllocator.GetCapacity(),
+        .NumIndices = IndexAllocator.GetUsedSize(),
+        .IndexCapacity = IndexAllocator.GetCapacity(),
+        .VertexFragmentation = VertexAllocator.GetFragmentation(),
+        .IndexFragmentation = IndexAllocator.GetFragmentation(),
+        .NumGrows = NumGrows,
+        .NumDefragments = NumDefragments,
+    };
+}
+
+bool FGeometryPool::Reserve(FTLSFAllocator& Allocator, uint32_t Size, bool bVertices)
+{
+    if (Allocator.GetLargestFreeBlock() >= Size)
+    {
+        return true;
+    }
+
+    const uint32_t FreeSize = Allocator.GetCapacity() - Allocator.GetUsedSize();
+    if (FreeSize >= Size && Allocator.GetFragmentation() >= DEFRAGMENT_THRESHOLD)
+    {
+        // Only the allocator that ran out is compacted, the other one keeps its buffers.
+        Compact(Allocator, bVertices);
+        NumDefragments++;
+        return true;
+    }
+
+    // Growing by at least Size leaves a free block of Size at the end.
+    const uint64_t NewCapacity = uint64_t(Allocator.GetCapacity()) + max(uint64_t(Allocator.GetCapacity()), uint64_t(Size));
+    if (NewCapacity > UINT32_MAX)
+    {
+        return false;
+    }
+
+    // Offsets do not change, everything up to the old capacity is carried over as is.
+    const std::vector<FCopyRange> Copies = { FCopyRange{ .SrcOffset = 0u, .DstOffset = 0u, .Size = Allocator.GetCapacity() } };
+    Allocator.Grow(static_cast<uint32_t>(NewCapacity));
+    ReplaceBuffers(Copies, bVertices);
+
+    NumGrows++;
+    return true;
+}
+
+void FGeometryPool::Compact(FTLSFAllocator& Allocator, bool bVertices)
+{
+    const std::vector<FTLSFAllocator::FMove> Moves = Allocator.Compact();
+
+    for (FEntry& Entry : Entries)
+    {
+        const uint32_t Node = bVertices ? Entry.VertexNode : Entry.IndexNode;
+        if (Node != FTLSFAllocator::INVALID_NODE)
+        {
+            uint32_t& Offset = bVertices ? Entry.Range.BaseVertex : Entry.Range.FirstIndex;
+            Offset = Allocator.GetOffset(Node);
+        }
+    }
+
+    // Compaction keeps the order, so the ranges in front of the first move were already packed and go over as
+    // one run. The buffers are new, those need copying too.
+    std::vector<FCopyRange> Copies;
+    const uint32_t NumUnmoved = Moves.empty() ? Allocator.GetUsedSize() : Moves.front().NewOffset;
+    if (NumUnmoved > 0u)
+    {
+        AddCopyRange(Copies, 0u, 0u, NumUnmoved);
+    }
+    for (const FTLSFAllocator::FMove& Move : Moves)
+    {
+        AddCopyRange(Copies, Move.OldOffset, Move.NewOffset, Move.Size);
+    }
+
+    ReplaceBuffers(Copies, bVertices);
+}
+
+void FGeometryPool::ReplaceBuffers(const std::vector<FCopyRange>& Copies, bool bVertices)
+{
+    // Uploads into the current buffers may still sit in the open batch, the copies out of them go in a later one.
+    RHIFlushUploads();
+    BufferGeneration++;
+
+    if (!bVertices)
+    {
+        FBuffer NewBuffer = CreateStreamBuffer(IndexAllocator.GetCapacity(), sizeof(uint32_t), L"Geometry pool index buffer");
+        CopyRanges(NewBuffer, IndexBuffer, Copies, sizeof(uint32_t));
+        RetireBuffer(std::exchange(IndexBuffer, std::move(NewBuffer)));
+        return;
+    }
+
+    for (uint32_t Stream = 0; Stream < NumVertexStreams; Stream++)
+    {
+        FBuffer NewBuffer = CreateStreamBuffer(VertexAllocator.GetCapacity(), VERTEX_STRIDES[Stream], VERTEX_STREAM_NAMES[Stream]);
+        CopyRanges(NewBuffer, VertexBuffers[Stream], Copies, VERTEX_STRIDES[Stream]);
+        RetireBuffer(std::exchange(VertexBuffers[Stream], std::move(NewBuffer)));
+    }
+}
+
+void FGeometryPool::AddCopyRange(std::vector<FCopyRange>& Copies, uint32_t SrcOffset, uint32_t DstOffset, uint32_t Size)
+{
+    if (!Copies.empty())
+    {
+        FCopyRange& Last = Copies.back();
+        if (Last.SrcOffset + Last.Size == SrcOffset && Last.DstOffset + Last.Size == DstOffset)
+        {
+            Last.Size += Size;
+            return;
+        }
+    }
+    Copies.push_back(FCopyRange{ .SrcOffset = SrcOffset, .DstOffset = DstOffset, .Size = Size });
+}
+
+void FGeometryPool::CopyRanges(const FBuffer& DstBuffer, const FBuffer& SrcBuffer, const std::vector<FCopyRange>& Copies, uint32_t Stride)
+{
+    for (const FCopyRange& Copy : Copies)
+    {
+        RHICopyBufferRegion(DstBuffer, uint64_t(Copy.DstOffset) * Stride, SrcBuffer, uint64_t(Copy.SrcOffset) * Stride, uint64_t(Copy.Size) * Stride);
+    }
+}
+
+FBuffer FGeometryPool::CreateStreamBuffer(uint32_t NumElements, uint32_t Stride, std::wstring_view Name) const
+{
+    return RHICreateBuffer(FBufferCreationDesc{
+        .Usage = EBufferUsage::StructuredBuffer,
+        .Name = Name,
+    }, NumElements, Stride);
+}
+
+void FGeometryPool::RetireBuffer(FBuffer&& Buffer)
+{
+    // Slot and memory go back together, once the GPU is past the frames that may read them.
+    RHIDeferReleaseCallback([SrvIndex = Buffer.SrvIndex, Allocation = std::move(Buffer.Allocation)]() {
+        RHIGetCbvSrvUavDescriptorHeap()->FreeDescriptor(SrvIndex);
+    }, Buffer.SizeInBytes);
+}
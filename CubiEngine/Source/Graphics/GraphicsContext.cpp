@@ -2,15 +2,17 @@
 #include "Graphics/D3D12DynamicRHI.h"
 #include "Graphics/DescriptorHeap.h"
 
-FGraphicsContext::FGraphicsContext()
+FGraphicsContext::FGraphicsContext(D3D12_COMMAND_LIST_TYPE Type)
 {
-    ThrowIfFailed(RHIGetDevice()->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,
+    assert(Type == D3D12_COMMAND_LIST_TYPE_DIRECT || Type == D3D12_COMMAND_LIST_TYPE_COMPUTE);
+
+    ThrowIfFailed(RHIGetDevice()->CreateCommandAllocator(Type,
         IID_PPV_ARGS(&D3D12CommandAllocator)));
     
     wrl::ComPtr<ID3D12GraphicsCommandList> D3D12CommandListBase;
 
     ThrowIfFailed(RHIGetDevice()->CreateCommandList(
-        0u, D3D12_COMMAND_LIST_TYPE_DIRECT, D3D12CommandAllocator.Get(), nullptr, IID_PPV_ARGS(&D3D12CommandListBase)));
+        0u, Type, D3D12CommandAllocator.Get(), nullptr, IID_PPV_ARGS(&D3D12CommandListBase)));
 
     if (!SUCCEEDED(D3D12CommandListBase.As(&D3D12CommandList))) {
         // not supported
@@ -39,6 +41,11 @@ void FGraphicsContext::SetDescriptorHeaps() const
     };
 
     D3D12CommandList->SetDescriptorHeaps(static_cast<UINT>(descriptorHeaps.size()), descriptorHeaps.data());
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::SetDescriptorHeaps);
+    }
 }
 
 void FGraphicsContext::Reset()
@@ -48,12 +55,30 @@ void FGraphicsContext::Reset()
     SetDescriptorHeaps();
 }
 
+void FGraphicsContext::Reopen()
+{
+    ThrowIfFailed(D3D12CommandList->Reset(D3D12CommandAllocator.Get(), nullptr));
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::ContextReset);
+    }
+
+    SetDescriptorHeaps();
+}
+
 void FGraphicsContext::ClearRenderTargetView(const FTexture* InRenderTarget, std::span<const float, 4> Color)
 {
     const auto rtvDescriptorHandle =
         RHIGetRtvDescriptorHeap()->GetDescriptorHandleFromIndex(InRenderTarget->RtvIndex);
 
     D3D12CommandList->ClearRenderTargetView(rtvDescriptorHandle.CpuDescriptorHandle, Color.data(), 0u, nullptr);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::ClearRenderTargetView,
+            Capture::FClearRenderTarget{ .RtvIndex = InRenderTarget->RtvIndex, .Color = { Color[0], Color[1], Color[2], Color[3] } });
+    }
 }
 
 void FGraphicsContext::ClearUnorderedAccessViewFloat(const FTexture* Texture, std::span<const float, 4> Color)
@@ -67,6 +92,15 @@ void FGraphicsContext::ClearUnorderedAccessViewFloat(const FTexture* Texture, st
         Color.data(),
         0u,
         nullptr);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::ClearUnorderedAccessViewFloat, Capture::FClearUnorderedAccessView{
+            .UavIndex = Texture->UavIndex,
+            .Resource = GetCaptureId(Texture->GetResource()),
+            .Color = { Color[0], Color[1], Color[2], Color[3] },
+        });
+    }
 }
 
 void FGraphicsContext::ClearDepthStencilView(const FTexture* Texture)
@@ -76,6 +110,21 @@ void FGraphicsContext::ClearDepthStencilView(const FTexture* Texture)
 
     D3D12CommandList->ClearDepthStencilView(DsvHandle.CpuDescriptorHandle, D3D12_CLEAR_FLAG_DEPTH,
         0.0f, 1u, 0u, nullptr); // ReversedZ
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::ClearDepthStencilView, Capture::FClearDepthStencil{ Texture->DsvIndex });
+    }
+}
+
+void FGraphicsContext::DiscardResource(const FTexture* Texture)
+{
+    D3D12CommandList->DiscardResource(Texture->GetResource(), nullptr);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::DiscardResource, Capture::FObject{ GetCaptureId(Texture->GetResource()) });
+    }
 }
 
 void FGraphicsContext::SetRenderTarget(const FTexture* RenderTarget) const
@@ -84,6 +133,12 @@ void FGraphicsContext::SetRenderTarget(const FTexture* RenderTarget) const
         RHIGetRtvDescriptorHeap()->GetDescriptorHandleFromIndex(RenderTarget->RtvIndex).CpuDescriptorHandle;
 
     D3D12CommandList->OMSetRenderTargets(1, &RtvHandle, FALSE, nullptr);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::SetRenderTargets,
+            Capture::FRenderTargets{ .NumRtvs = 1u, .DsvIndex = INVALID_INDEX_U32, .RtvIndices = { RenderTarget->RtvIndex } });
+    }
 }
 
 void FGraphicsContext::SetRenderTarget(const FTexture* RenderTarget, const FTexture* DepthStencilTexture) const
@@ -95,6 +150,12 @@ void FGraphicsContext::SetRenderTarget(const FTexture* RenderTarget, const FText
         RHIGetDsvDescriptorHeap()->GetDescriptorHandleFromIndex(DepthStencilTexture->DsvIndex).CpuDescriptorHandle;
 
     D3D12CommandList->OMSetRenderTargets(1, &RtvHandle, TRUE, &DsvHandle);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::SetRenderTargets,
+            Capture::FRenderTargets{ .NumRtvs = 1u, .DsvIndex = DepthStencilTexture->DsvIndex, .RtvIndices = { RenderTarget->RtvIndex } });
+    }
 }
 
 void FGraphicsContext::SetRenderTargets(const std::span<const FTexture*> RenderTargets, const FTexture* DepthStencilTexture) const
@@ -115,6 +176,16 @@ void FGraphicsContext::SetRenderTargets(const std::span<const FTexture*> RenderT
 
     D3D12CommandList->OMSetRenderTargets(
         static_cast<UINT>(RtvHandles.size()), RtvHandles.data(), FALSE, &DsvHandle);
+
+    if (CommandCapture)
+    {
+        Capture::FRenderTargets Targets{ .NumRtvs = static_cast<uint32_t>(RenderTargets.size()), .DsvIndex = DepthStencilTexture->DsvIndex };
+        for (size_t i = 0; i < RenderTargets.size(); i++)
+        {
+            Targets.RtvIndices[i] = RenderTargets[i]->RtvIndex;
+        }
+        RecordCommand(ECapturedCommand::SetRenderTargets, Targets);
+    }
 }
 
 void FGraphicsContext::SetRenderTargetDepthOnly(const FTexture* DepthStencilTexture) const
@@ -123,26 +194,53 @@ void FGraphicsContext::SetRenderTargetDepthOnly(const FTexture* DepthStencilText
         RHIGetDsvDescriptorHeap()->GetDescriptorHandleFromIndex(DepthStencilTexture->DsvIndex).CpuDescriptorHandle;
 
     D3D12CommandList->OMSetRenderTargets(0, nullptr, FALSE, &DsvHandle);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::SetRenderTargets,
+            Capture::FRenderTargets{ .NumRtvs = 0u, .DsvIndex = DepthStencilTexture->DsvIndex });
+    }
 }
 
 void FGraphicsContext::SetGraphicsPipelineState(const FPipelineState& PipelineState) const
 {
-    D3D12CommandList->SetPipelineState(PipelineState.PipelineStateObject.Get());
+    D3D12CommandList->SetPipelineState(PipelineState.Get());
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::SetPipelineState, Capture::FObject{ GetCaptureId(PipelineState.Get()) });
+    }
 }
 
 void FGraphicsContext::SetComputePipelineState(const FPipelineState& PipelineState) const
 {
-    D3D12CommandList->SetPipelineState(PipelineState.PipelineStateObject.Get());
+    D3D12CommandList->SetPipelineState(PipelineState.Get());
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::SetPipelineState, Capture::FObject{ GetCaptureId(PipelineState.Get()) });
+    }
 }
 
 void FGraphicsContext::SetRaytracingPipelineState(const FRaytracingPipelineState& PipelineState) const
 {
     D3D12CommandList->SetPipelineState1(PipelineState.GetRTStateObjectPtr());
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::SetRaytracingPipelineState, Capture::FObject{ GetCaptureId(PipelineState.GetRTStateObjectPtr()) });
+    }
 }
 
 void FGraphicsContext::SetViewport(const D3D12_VIEWPORT& Viewport, bool bScissorRectAsSame) const
 {
     D3D12CommandList->RSSetViewports(1u, &Viewport);
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::SetViewport, Capture::FViewport{
+            Viewport.TopLeftX, Viewport.TopLeftY, Viewport.Width, Viewport.Height, Viewport.MinDepth, Viewport.MaxDepth });
+    }
+
     if (bScissorRectAsSame)
     {
         D3D12_RECT ScissorRect{ .left = 0u, .top = 0u, .right = (LONG)Viewport.Width, .bottom = (LONG)Viewport.Height };
@@ -153,11 +251,21 @@ void FGraphicsContext::SetViewport(const D3D12_VIEWPORT& Viewport, bool bScissor
 void FGraphicsContext::SetScissorRects(const D3D12_RECT& Rect) const
 {
     D3D12CommandList->RSSetScissorRects(1u, &Rect);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::SetScissorRect, Capture::FScissorRect{ Rect.left, Rect.top, Rect.right, Rect.bottom });
+    }
 }
 
 void FGraphicsContext::SetPrimitiveTopologyLayout(const D3D_PRIMITIVE_TOPOLOGY PrimitiveTopology) const
 {
     D3D12CommandList->IASetPrimitiveTopology(PrimitiveTopology);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::SetPrimitiveTopology, Capture::FPrimitiveTopology{ static_cast<uint32_t>(PrimitiveTopology) });
+    }
 }
 
 void FGraphicsContext::SetIndexBuffer(const FBuffer& Buffer) const
@@ -169,52 +277,121 @@ void FGraphicsContext::SetIndexBuffer(const FBuffer& Buffer) const
     };
 
     D3D12CommandList->IASetIndexBuffer(&indexBufferView);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::SetIndexBuffer,
+            Capture::FIndexBuffer{ GetCaptureId(Buffer.Allocation.Resource.Get()), static_cast<uint32_t>(Buffer.SizeInBytes) });
+    }
 }
 
-void FGraphicsContext::DrawIndexedInstanced(const uint32_t IndicesCount, const uint32_t InstanceCount) const
+void FGraphicsContext::DrawIndexedInstanced(const uint32_t IndicesCount, const uint32_t InstanceCount, const uint32_t StartIndexLocation) const
 {
-    D3D12CommandList->DrawIndexedInstanced(IndicesCount, InstanceCount, 0u, 0u, 0u);
+    D3D12CommandList->DrawIndexedInstanced(IndicesCount, InstanceCount, StartIndexLocation, 0u, 0u);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::DrawIndexedInstanced, Capture::FDrawIndexedInstanced{ IndicesCount, InstanceCount, StartIndexLocation });
+    }
 }
 
 void FGraphicsContext::DrawInstanced(uint32_t VertexCountPerInstance, 
     uint32_t InstanceCount, uint32_t StartVertexLocation, uint32_t StartInstanceLocation) const
 {
     D3D12CommandList->DrawInstanced(VertexCountPerInstance, InstanceCount, StartVertexLocation, StartInstanceLocation);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::DrawInstanced,
+            Capture::FDrawInstanced{ VertexCountPerInstance, InstanceCount, StartVertexLocation, StartInstanceLocation });
+    }
 }
 
 void FGraphicsContext::SetGraphicsRootSignature() const
 {
     D3D12CommandList->SetGraphicsRootSignature(FPipelineState::StaticRootSignature.Get());
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::SetGraphicsRootSignature, Capture::FObject{ GetCaptureId(FPipelineState::StaticRootSignature.Get()) });
+    }
 }
 
 void FGraphicsContext::SetComputeRootSignature() const
 {
     D3D12CommandList->SetComputeRootSignature(FPipelineState::StaticRootSignature.Get());
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::SetComputeRootSignature, Capture::FObject{ GetCaptureId(FPipelineState::StaticRootSignature.Get()) });
+    }
 }
 
 void FGraphicsContext::SetRaytracingComputeRootSignature() const
 {
     D3D12CommandList->SetComputeRootSignature(FRaytracingPipelineState::StaticGlobalRootSignature.Get());
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::SetComputeRootSignature,
+            Capture::FObject{ GetCaptureId(FRaytracingPipelineState::StaticGlobalRootSignature.Get()) });
+    }
 }
 
 void FGraphicsContext::CopyResource(ID3D12Resource* const Destination, ID3D12Resource* const Source) const
 {
     D3D12CommandList->CopyResource(Destination, Source);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::CopyResource, Capture::FCopyResource{ GetCaptureId(Destination), GetCaptureId(Source) });
+    }
+}
+
+void FGraphicsContext::ExecuteIndirect(ID3D12CommandSignature* const CommandSignature, uint32_t MaxCommandCount,
+    const FBuffer& ArgumentBuffer, uint64_t ArgumentBufferOffset) const
+{
+    D3D12CommandList->ExecuteIndirect(CommandSignature, MaxCommandCount, ArgumentBuffer.GetResource(), ArgumentBufferOffset, nullptr, 0u);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::ExecuteIndirect, Capture::FExecuteIndirect{
+            .CommandSignature = GetCaptureId(CommandSignature),
+            .MaxCommandCount = MaxCommandCount,
+            .ArgumentBuffer = GetCaptureId(ArgumentBuffer.GetResource()),
+            .ArgumentBufferOffset = ArgumentBufferOffset,
+        });
+    }
 }
 
 void FGraphicsContext::Dispatch(const uint32_t ThreadGroupDimX, const uint32_t ThreadGroupDimY, const uint32_t ThreadGroupDimZ)
 {
     D3D12CommandList->Dispatch(ThreadGroupDimX, ThreadGroupDimY, ThreadGroupDimZ);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::Dispatch, Capture::FDispatch{ ThreadGroupDimX, ThreadGroupDimY, ThreadGroupDimZ });
+    }
 }
 
 void FGraphicsContext::BeginQuery(FQueryHeap* Heap, D3D12_QUERY_TYPE Type, uint32_t Index)
 {
     D3D12CommandList->BeginQuery(Heap->GetD3D12QueryHeap(), Type, Index);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::BeginQuery, Capture::FQuery{ GetCaptureId(Heap), static_cast<uint32_t>(Type), Index });
+    }
 }
 
 void FGraphicsContext::EndQuery(FQueryHeap* Heap, D3D12_QUERY_TYPE Type, uint32_t Index)
 {
     D3D12CommandList->EndQuery(Heap->GetD3D12QueryHeap(), Type, Index);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::EndQuery, Capture::FQuery{ GetCaptureId(Heap), static_cast<uint32_t>(Type), Index });
+    }
 }
 
 void FGraphicsContext::ResolveQueryData(
@@ -226,19 +403,55 @@ void FGraphicsContext::ResolveQueryData(
 )
 {
     D3D12CommandList->ResolveQueryData(Heap->GetD3D12QueryHeap(), Type, StartIndex, NumQueries, Heap->GetQueryReadbackBuffer(), AlignedDestinationBufferOffset);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::ResolveQueryData, Capture::FResolveQueryData{
+            .Heap = GetCaptureId(Heap),
+            .Type = static_cast<uint32_t>(Type),
+            .StartIndex = StartIndex,
+            .NumQueries = NumQueries,
+            .DestinationOffset = AlignedDestinationBufferOffset,
+        });
+    }
 }
 
 void FGraphicsContext::DispatchRays(D3D12_DISPATCH_RAYS_DESC& RayDesc) const
 {
     D3D12CommandList->DispatchRays(&RayDesc);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::DispatchRays, Capture::FDispatchRays{
+            .Addresses = {
+                RayDesc.RayGenerationShaderRecord.StartAddress, RayDesc.RayGenerationShaderRecord.SizeInBytes,
+                RayDesc.MissShaderTable.StartAddress, RayDesc.MissShaderTable.SizeInBytes, RayDesc.MissShaderTable.StrideInBytes,
+                RayDesc.HitGroupTable.StartAddress, RayDesc.HitGroupTable.SizeInBytes, RayDesc.HitGroupTable.StrideInBytes,
+                RayDesc.CallableShaderTable.StartAddress, RayDesc.CallableShaderTable.SizeInBytes, RayDesc.CallableShaderTable.StrideInBytes,
+            },
+            .Width = RayDesc.Width,
+            .Height = RayDesc.Height,
+            .Depth = RayDesc.Depth,
+        });
+    }
 }
 
 void FGraphicsContext::SetComputeRootShaderResourceView(UINT RootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS BufferLocation)
 {
     D3D12CommandList->SetComputeRootShaderResourceView(RootParameterIndex, BufferLocation);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::SetComputeRootShaderResourceView, Capture::FRootAddress{ .RootParameterIndex = RootParameterIndex, .Address = BufferLocation });
+    }
 }
 
 void FGraphicsContext::SetComputeRootDescriptorTable(UINT RootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE BaseDescriptor)
 {
     D3D12CommandList->SetComputeRootDescriptorTable(RootParameterIndex, BaseDescriptor);
+
+    if (CommandCapture)
+    {
+        RecordCommand(ECapturedCommand::SetComputeRootDescriptorTable, Capture::FRootAddress{ .RootParameterIndex = RootParameterIndex, .Address = BaseDescriptor.ptr });
+    }
 }
@@ -0,0 +1,17 @@
+#include "Graphics/Material.h"
+#include "Graphics/D3D12DynamicRHI.h"
+#include "Graphics/MaterialTable.h"
+
+FPBRMaterial::~FPBRMaterial()
+{
+    if (MaterialIndex != INVALID_INDEX_U32 && GD3D12RHI)
+    {
+        RHIGetMaterialTable()->Release(MaterialIndex);
+    }
+}
+
+void FPBRMaterial::SetParameters(const interlop::MaterialData& InParameters)
+{
+    Parameters = InParameters;
+    MaterialIndex = RHIGetMaterialTable()->Replace(MaterialIndex, Parameters);
+}
@@ -0,0 +1,197 @@
+#include "Graphics/MaterialTable.h"
+#include "Graphics/ConstantBufferAllocator.h"
+#include "Graphics/D3D12DynamicRHI.h"
+
+FMaterialParameterTable::FMaterialParameterTable(uint32_t InitialCapacity)
+    : Data(InitialCapacity), Slots(InitialCapacity)
+{
+    assert(InitialCapacity > 0u);
+}
+
+uint32_t FMaterialParameterTable::Acquire(const interlop::MaterialData& Block)
+{
+    const uint64_t Hash = FConstantDirtyTracker::Hash(&Block, sizeof(Block));
+
+    uint32_t Slot = FindSlot(Block, Hash);
+    if (Slot != INVALID_SLOT)
+    {
+        Slots[Slot].RefCount++;
+        NumDeduplicated++;
+        return Slot;
+    }
+
+    Slot = AllocateSlot();
+    Data[Slot] = Block;
+    Slots[Slot] = FSlot{ .RefCount = 1u, .Hash = Hash };
+    SlotsByHash.emplace(Hash, Slot);
+    DirtySlots.push_back(Slot);
+    NumLiveSlots++;
+    return Slot;
+}
+
+void FMaterialParameterTable::Release(uint32_t Slot)
+{
+    assert(Slot < NumSlots && Slots[Slot].RefCount > 0u);
+
+    if (--Slots[Slot].RefCount > 0u)
+    {
+        return;
+    }
+
+    // Out of the lookup right away, an Acquire of the same block before the slot is reclaimed gets a new one.
+    auto [First, Last] = SlotsByHash.equal_range(Slots[Slot].Hash);
+    for (auto It = First; It != Last; ++It)
+    {
+        if (It->second == Slot)
+        {
+            SlotsByHash.erase(It);
+            break;
+        }
+    }
+
+    NumLiveSlots--;
+    PendingFrees.push_back(FPendingFree{ .FrameNumber = FrameNumber, .Slot = Slot });
+}
+
+uint32_t FMaterialParameterTable::Replace(uint32_t Slot, const interlop::MaterialData& Block)
+{
+    const uint32_t NewSlot = Acquire(Block);
+    if (Slot != INVALID_SLOT)
+    {
+        Release(Slot);
+    }
+    return NewSlot;
+}
+
+void FMaterialParameterTable::BeginFrame()
+{
+    FrameNumber++;
+
+    while (!PendingFrees.empty() && PendingFrees.front().FrameNumber + FRAMES_IN_FLIGHT <= FrameNumber)
+    {
+        FreeSlots.push_back(PendingFrees.front().Slot);
+        PendingFrees.pop_front();
+    }
+}
+
+std::vector<FMaterialSlotRange> FMaterialParameterTable::TakeDirtyRanges()
+{
+    std::sort(DirtySlots.begin(), DirtySlots.end());
+    DirtySlots.erase(std::unique(DirtySlots.begin(), DirtySlots.end()), DirtySlots.end());
+
+    std::vector<FMaterialSlotRange> Ranges;
+    for (const uint32_t Slot : DirtySlots)
+    {
+        if (!Ranges.empty() && Ranges.back().FirstSlot + Ranges.back().NumSlots == Slot)
+        {
+            Ranges.back().NumSlots++;
+        }
+        else
+        {
+            Ranges.push_back(FMaterialSlotRange{ .FirstSlot = Slot, .NumSlots = 1u });
+        }
+    }
+
+    DirtySlots.clear();
+    return Ranges;
+}
+
+uint32_t FMaterialParameterTable::FindSlot(const interlop::MaterialData& Block, uint64_t Hash) const
+{
+    auto [First, Last] = SlotsByHash.equal_range(Hash);
+    for (auto It = First; It != Last; ++It)
+    {
+        if (std::memcmp(&Data[It->second], &Block, sizeof(Block)) == 0)
+        {
+            return It->second;
+        }
+    }
+    return INVALID_SLOT;
+}
+
+uint32_t FMaterialParameterTable::AllocateSlot()
+{
+    if (!FreeSlots.empty())
+    {
+        const uint32_t Slot = FreeSlots.back();
+        FreeSlots.pop_back();
+        return Slot;
+    }
+
+    if (NumSlots == Data.size())
+    {
+        Data.resize(Data.size() * 2u);
+        Slots.resize(Slots.size() * 2u);
+    }
+    return NumSlots++;
+}
+
+FMaterialTable::FMaterialTable()
+    : Table(INITIAL_CAPACITY)
+{
+    Buffer = CreateTableBuffer(Table.GetCapacity());
+}
+
+uint32_t FMaterialTable::Acquire(const interlop::MaterialData& Data)
+{
+    std::scoped_lock Lock(Mutex);
+    return Table.Acquire(Data);
+}
+
+void FMaterialTable::Release(uint32_t Slot)
+{
+    std::scoped_lock Lock(Mutex);
+    Table.Release(Slot);
+}
+
+uint32_t FMaterialTable::Replace(uint32_t Slot, const interlop::MaterialData& Data)
+{
+    std::scoped_lock Lock(Mutex);
+    return Table.Replace(Slot, Data);
+}
+
+void FMaterialTable::BeginFrame()
+{
+    std::scoped_lock Lock(Mutex);
+
+    Table.BeginFrame();
+
+    const std::span<const interlop::MaterialData> Data = Table.GetData();
+    std::vector<FMaterialSlotRange> Ranges = Table.TakeDirtyRanges();
+
+    if (Table.GetCapacity() * sizeof(interlop::MaterialData) != Buffer.SizeInBytes)
+    {
+        // The CPU table has every block, a new buffer is filled from it in one go instead of copying the old one.
+        FBuffer OldBuffer = std::exchange(Buffer, CreateTableBuffer(Table.GetCapacity()));
+        RHIDeferReleaseCallback([SrvIndex = OldBuffer.SrvIndex, Allocation = std::move(OldBuffer.Allocation)]() {
+            RHIGetCbvSrvUavDescriptorHeap()->FreeDescriptor(SrvIndex);
+        }, OldBuffer.SizeInBytes);
+        Ranges = { FMaterialSlotRange{ .FirstSlot = 0u, .NumSlots = static_cast<uint32_t>(Data.size()) } };
+    }
+
+    for (const FMaterialSlotRange& Range : Ranges)
+    {
+        RHIUploadBufferRegion(Buffer, uint64_t(Range.FirstSlot) * sizeof(interlop::MaterialData),
+            &Data[Range.FirstSlot], uint64_t(Range.NumSlots) * sizeof(interlop::MaterialData));
+    }
+}
+
+uint32_t FMaterialTable::GetNumLiveSlots() const
+{
+    std::scoped_lock Lock(Mutex);
+    return Table.GetNumLiveSlots();
+}
+
+uint32_t FMaterialTable::GetNumDeduplicated() const
+{
+    std::scoped_lock Lock(Mutex);
+    return Table.GetNumDeduplicated();
+}
+
+FBuffer FMaterialTable::CreateTableBuffer(uint32_t Capacity) const
+{
+    return RHICreateBuffer(FBufferCreationDesc{
+        .Usage = EBufferUsage::StructuredBuffer,
+        .Name = L"Material Table",
+    }, Capacity, sizeof(interlop::MaterialData));
+}
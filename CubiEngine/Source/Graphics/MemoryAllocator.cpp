@@ -1,6 +1,64 @@
 #include "Graphics/MemoryAllocator.h"
 
+namespace
+{
+    D3D12_RESOURCE_DESC GetTextureResourceDesc(const FTextureCreationDesc& TextureCreationDesc, bool bUAVAllowed)
+    {
+        DXGI_FORMAT format = TextureCreationDesc.Format;
+        DXGI_FORMAT dsFormat{};
+
+        switch (TextureCreationDesc.Format)
+        {
+        case DXGI_FORMAT_R32_FLOAT:
+        case DXGI_FORMAT_D32_FLOAT:
+        case DXGI_FORMAT_R32_TYPELESS: {
+            dsFormat = DXGI_FORMAT_D32_FLOAT;
+            format = DXGI_FORMAT_R32_FLOAT;
+        }
+        break;
+        }
+
+        D3D12_RESOURCE_DESC ResourceDesc = {
+            .Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D,
+            .Alignment = 0u,
+            .Width = TextureCreationDesc.Width,
+            .Height = TextureCreationDesc.Height,
+            .DepthOrArraySize = static_cast<UINT16>(TextureCreationDesc.DepthOrArraySize),
+            .MipLevels = static_cast<UINT16>(TextureCreationDesc.MipLevels),
+            .Format = format,
+            .SampleDesc =
+                {
+                    .Count = 1u,
+                    .Quality = 0u,
+                },
+            .Flags = D3D12_RESOURCE_FLAG_NONE,
+        };
+
+        if (bUAVAllowed)
+        {
+            ResourceDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        }
+
+        switch (TextureCreationDesc.Usage)
+        {
+        case ETextureUsage::DepthStencil: {
+            ResourceDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+            ResourceDesc.Format = dsFormat;
+        }
+        break;
+
+        case ETextureUsage::RenderTarget: {
+            ResourceDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        }
+        break;
+        };
+
+        return ResourceDesc;
+    }
+}
+
 FMemoryAllocator::FMemoryAllocator(ID3D12Device* const Device, IDXGIAdapter* const Adapter)
+    : Device(Device)
 {
     // Create D3D12MA adapter.
     const D3D12MA::ALLOCATOR_DESC allocatorDesc = {
@@ -23,6 +81,7 @@ FAllocation FMemoryAllocator::CreateBufferResourceAllocation(const FBufferCreati
     {
         case EBufferUsage::UploadBuffer:
         case EBufferUsage::ConstantBuffer:
+        case EBufferUsage::DynamicStructuredBuffer:
         {
             // GenericRead implies readable data from the GPU memory. Required resourceState for upload heaps.
             // UploadHeap : CPU writable access, GPU readable access.
@@ -69,43 +128,15 @@ FAllocation FMemoryAllocator::CreateBufferResourceAllocation(const FBufferCreati
     return Allocation;
 }
 
-FAllocation FMemoryAllocator::CreateTextureResourceAllocation(const FTextureCreationDesc& TextureCreationDesc, D3D12_RESOURCE_STATES& ResourceState, bool bUAVAllowed)
+FAllocation FMemoryAllocator::CreateTextureResourceAllocation(const FTextureCreationDesc& TextureCreationDesc, D3D12_RESOURCE_STATES& ResourceState, bool bUAVAllowed,
+    const FTexturePlacement* Placement)
 {
     ResourceState = D3D12_RESOURCE_STATE_COMMON;
 
     FAllocation Allocation{};
 
-    DXGI_FORMAT format = TextureCreationDesc.Format;
-    DXGI_FORMAT dsFormat{};
-
-    switch (TextureCreationDesc.Format)
-    {
-    case DXGI_FORMAT_R32_FLOAT:
-    case DXGI_FORMAT_D32_FLOAT:
-    case DXGI_FORMAT_R32_TYPELESS: {
-        dsFormat = DXGI_FORMAT_D32_FLOAT;
-        format = DXGI_FORMAT_R32_FLOAT;
-    }
-    break;
-    }
-
-    FResourceCreationDesc ResourceCreationDesc = {
-        .ResourceDesc =
-            {
-                .Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D,
-                .Alignment = 0u,
-                .Width = TextureCreationDesc.Width,
-                .Height = TextureCreationDesc.Height,
-                .DepthOrArraySize = static_cast<UINT16>(TextureCreationDesc.DepthOrArraySize),
-                .MipLevels = static_cast<UINT16>(TextureCreationDesc.MipLevels),
-                .Format = format,
-                .SampleDesc =
-                    {
-                        .Count = 1u,
-                        .Quality = 0u,
-                    },
-                .Flags = D3D12_RESOURCE_FLAG_NONE,
-            },
+    const FResourceCreationDesc ResourceCreationDesc = {
+        .ResourceDesc = GetTextureResourceDesc(TextureCreationDesc, bUAVAllowed),
     };
 
     constexpr D3D12_HEAP_TYPE heapType = D3D12_HEAP_TYPE_DEFAULT;
@@ -114,24 +145,15 @@ FAllocation FMemoryAllocator::CreateTextureResourceAllocation(const FTextureCrea
         .HeapType = heapType,
     };
 
-    if (bUAVAllowed)
-    {
-		ResourceCreationDesc.ResourceDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
-    }
-
     switch (TextureCreationDesc.Usage)
     {
     case ETextureUsage::DepthStencil: {
-        ResourceCreationDesc.ResourceDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
-        ResourceCreationDesc.ResourceDesc.Format = dsFormat;
         AllocationDesc.Flags |= D3D12MA::ALLOCATION_FLAG_COMMITTED;
         ResourceState = D3D12_RESOURCE_STATE_DEPTH_WRITE;
     }
     break;
 
     case ETextureUsage::RenderTarget: {
-        ResourceCreationDesc.ResourceDesc.Flags =
-            D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
         AllocationDesc.ExtraHeapFlags = D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES;
         AllocationDesc.Flags |= D3D12MA::ALLOCATION_FLAG_COMMITTED;
         ResourceState = D3D12_RESOURCE_STATE_RENDER_TARGET;
@@ -139,6 +161,9 @@ FAllocation FMemoryAllocator::CreateTextureResourceAllocation(const FTextureCrea
     break;
     };
 
+    // The resource format, the depth format for depth stencil textures.
+    const DXGI_FORMAT format = ResourceCreationDesc.ResourceDesc.Format;
+
     std::optional<D3D12_CLEAR_VALUE> ClearValue{};
     if (TextureCreationDesc.Usage == ETextureUsage::RenderTarget)
     {
@@ -150,7 +175,7 @@ FAllocation FMemoryAllocator::CreateTextureResourceAllocation(const FTextureCrea
             .Depth = 0.0f, // ReversedZ
             .Stencil = 0u,
         };
-        ClearValue = { .Format = dsFormat, .DepthStencil = dsValue };
+        ClearValue = { .Format = format, .DepthStencil = dsValue };
     }
 
     std::lock_guard<std::recursive_mutex> Guard(ResourceAllocationMutex);
@@ -160,6 +185,16 @@ FAllocation FMemoryAllocator::CreateTextureResourceAllocation(const FTextureCrea
         ResourceState = TextureCreationDesc.InitialState;
     }
 
+    if (Placement)
+    {
+        ThrowIfFailed(
+            DmaAllocator->CreateAliasingResource(Placement->Heap, Placement->Offset, &ResourceCreationDesc.ResourceDesc, ResourceState,
+                ClearValue.has_value() ? &ClearValue.value() : nullptr, IID_PPV_ARGS(&Allocation.Resource)));
+
+        Allocation.Resource->SetName((LPCWSTR)TextureCreationDesc.Name.data());
+        return Allocation;
+    }
+
     ThrowIfFailed(
         DmaAllocator->CreateResource(&AllocationDesc, &ResourceCreationDesc.ResourceDesc, ResourceState,
             ClearValue.has_value() ? &ClearValue.value() : nullptr,
@@ -170,3 +205,28 @@ FAllocation FMemoryAllocator::CreateTextureResourceAllocation(const FTextureCrea
 
     return Allocation;
 }
+
+D3D12_RESOURCE_ALLOCATION_INFO FMemoryAllocator::GetTextureAllocationInfo(const FTextureCreationDesc& TextureCreationDesc, bool bUAVAllowed) const
+{
+    const D3D12_RESOURCE_DESC ResourceDesc = GetTextureResourceDesc(TextureCreationDesc, bUAVAllowed);
+    return Device->GetResourceAllocationInfo(0u, 1u, &ResourceDesc);
+}
+
+wrl::ComPtr<D3D12MA::Allocation> FMemoryAllocator::AllocateHeap(uint64_t Size, uint64_t Alignment, D3D12_HEAP_FLAGS HeapFlags)
+{
+    const D3D12MA::ALLOCATION_DESC AllocationDesc = {
+        .Flags = D3D12MA::ALLOCATION_FLAG_COMMITTED,
+        .HeapType = D3D12_HEAP_TYPE_DEFAULT,
+        .ExtraHeapFlags = HeapFlags,
+    };
+    const D3D12_RESOURCE_ALLOCATION_INFO AllocationInfo = {
+        .SizeInBytes = Size,
+        .Alignment = Alignment,
+    };
+
+    std::lock_guard<std::recursive_mutex> Guard(ResourceAllocationMutex);
+
+    wrl::ComPtr<D3D12MA::Allocation> Heap{};
+    ThrowIfFailed(DmaAllocator->AllocateMemory(&AllocationDesc, &AllocationInfo, &Heap));
+    return Heap;
+}
@@ -77,5 +77,5 @@ void FMipmapGenerator::GenerateMipmap(FTexture* Texture)
         Context->ExecuteResourceBarriers();
     }
 
-    RHIExecuteAndFlushComputeContext(std::move(Context));
+    RHIExecuteComputeContext(std::move(Context));
 }
@@ -0,0 +1,38 @@
+#include "Graphics/PipelineCompileQueue.h"
+
+FPipelineCompileQueue::~FPipelineCompileQueue()
+{
+    WaitAll();
+}
+
+void FPipelineCompileQueue::WaitAll()
+{
+    std::vector<FInFlightCompile> Compiles;
+    {
+        std::lock_guard Lock(Mutex);
+        Compiles.swap(InFlight);
+    }
+
+    for (const FInFlightCompile& Compile : Compiles)
+    {
+        GJobSystem->Wait(*Compile.Counter);
+    }
+}
+
+uint32_t FPipelineCompileQueue::GetNumPending() const
+{
+    std::lock_guard Lock(Mutex);
+
+    uint32_t NumPending = 0u;
+    for (const FInFlightCompile& Compile : InFlight)
+    {
+        NumPending += Compile.Counter->IsDone() ? 0u : 1u;
+    }
+    return NumPending;
+}
+
+uint32_t FPipelineCompileQueue::GetNumEnqueued() const
+{
+    std::lock_guard Lock(Mutex);
+    return NumEnqueued;
+}
@@ -1,5 +1,6 @@
 #include "Graphics/PipelineState.h"
 #include "Graphics/ShaderCompiler.h"
+#include "Graphics/D3D12DynamicRHI.h"
 #include "Core/FileSystem.h"
 
 FPipelineState::FPipelineState(ID3D12Device5* const device,
@@ -41,14 +42,18 @@ FPipelineState::FPipelineState(ID3D12Device5* const device,
         ShaderCompiler::Compile(
             ShaderTypes::Vertex,
             FFileSystem::GetFullPath(pipelineStateCreationDesc.ShaderModule.vertexShaderPath),
-            pipelineStateCreationDesc.ShaderModule.vertexEntryPoint)
+            pipelineStateCreationDesc.ShaderModule.vertexEntryPoint,
+            false,
+            pipelineStateCreationDesc.Defines)
         .shaderBlob;
 
     const auto& pixelShaderBlob =
         ShaderCompiler::Compile(
             ShaderTypes::Pixel,
             FFileSystem::GetFullPath(pipelineStateCreationDesc.ShaderModule.pixelShaderPath),
-            pipelineStateCreationDesc.ShaderModule.pixelEntryPoint)
+            pipelineStateCreationDesc.ShaderModule.pixelEntryPoint,
+            false,
+            pipelineStateCreationDesc.Defines)
         .shaderBlob;
 
     // Primitive topology type specifies how the pipeline interprets geometry or hull shader input primitives.
@@ -94,7 +99,8 @@ FPipelineState::FPipelineState(ID3D12Device5* const device, const FComputePipeli
     const auto& ComputeShaderBlob =
         ShaderCompiler::Compile(ShaderTypes::Compute,
         FFileSystem::GetFullPath(pipelineStateCreationDesc.ShaderModule.computeShaderPath),
-        pipelineStateCreationDesc.ShaderModule.computeEntryPoint).shaderBlob;
+        pipelineStateCreationDesc.ShaderModule.computeEntryPoint, false,
+        pipelineStateCreationDesc.Defines).shaderBlob;
 
     const D3D12_COMPUTE_PIPELINE_STATE_DESC psoDesc = {
         .pRootSignature = FPipelineState::StaticRootSignature.Get(),
@@ -108,6 +114,20 @@ FPipelineState::FPipelineState(ID3D12Device5* const device, const FComputePipeli
     PipelineStateObject->SetName(pipelineStateCreationDesc.PipelineName.data());
 }
 
+FPipelineState::FPipelineState(TCompileFuture<wrl::ComPtr<ID3D12PipelineState>> InPendingPipelineState)
+    : PendingPipelineState(std::move(InPendingPipelineState))
+{
+}
+
+ID3D12PipelineState* FPipelineState::Get() const
+{
+    if (PendingPipelineState.IsValid())
+    {
+        return PendingPipelineState.Get().Get();
+    }
+    return PipelineStateObject.Get();
+}
+
 void FPipelineState::CreateBindlessRootSignature(ID3D12Device* const device, const std::wstring_view shaderPath)
 {
     const auto path = FFileSystem::GetFullPath(shaderPath);
@@ -124,3 +144,47 @@ void FPipelineState::CreateBindlessRootSignature(ID3D12Device* const device, con
 
     StaticRootSignature->SetName(L"Bindless Root Signature");
 }
+
+FPipelineStatePermutations::FPipelineStatePermutations(const FGraphicsPipelineStateCreationDesc& InDesc, FShaderPermutationDomain InDomain)
+    : Desc(InDesc), Domain(std::move(InDomain))
+{
+}
+
+FPipelineStatePermutations::FPipelineStatePermutations(const FComputePipelineStateCreationDesc& InDesc, FShaderPermutationDomain InDomain)
+    : Desc(InDesc), Domain(std::move(InDomain))
+{
+}
+
+void FPipelineStatePermutations::PrecompileAll()
+{
+    for (const uint32_t Key : Domain.GetValidKeys())
+    {
+        Get(Key);
+    }
+}
+
+const FPipelineState& FPipelineStatePermutations::Get(uint32_t Key)
+{
+    auto It = PipelineStates.find(Key);
+    if (It != PipelineStates.end())
+    {
+        return It->second;
+    }
+
+    if (!Domain.IsValid(Key))
+    {
+        FatalError(std::format("Requested pruned shader permutation {}.", Key));
+    }
+
+    FPipelineState PipelineState = std::visit([&](const auto& BaseDesc)
+    {
+        auto PermutationDesc = BaseDesc;
+        const std::wstring PipelineName = std::format(L"{} [{}]", BaseDesc.PipelineName, Key);
+        PermutationDesc.PipelineName = PipelineName;
+        std::vector<std::wstring> Defines = Domain.GetDefines(Key);
+        PermutationDesc.Defines.insert(PermutationDesc.Defines.end(), Defines.begin(), Defines.end());
+        return RHICreatePipelineState(PermutationDesc);
+    }, Desc);
+
+    return PipelineStates.emplace(Key, std::move(PipelineState)).first->second;
+}
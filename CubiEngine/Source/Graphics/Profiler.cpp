@@ -3,23 +3,21 @@
 #include "Graphics/D3D12DynamicRHI.h"
 #include "Graphics/GraphicsContext.h"
 
-FGPUEventNode::FGPUEventNode(const char* Name, FGPUEventNode* Parent)
-    :Name(Name), Parent(Parent)
+FGPUEventNode::FGPUEventNode(const char* Name, FGPUEventNode* Parent, FLinearArena& Arena, FGraphicsContext* Context)
+    :Parent(Parent), Children(Arena), Context(Context), Name(Name)
 {
+    TimestampQueue = Context->GetD3D12CommandList()->GetType() == D3D12_COMMAND_LIST_TYPE_COMPUTE ?
+        RHIGetComputeCommandQueue() : RHIGetDirectCommandQueue();
 }
 
 void FGPUEventNode::StartTiming()
 {
-    FGraphicsContext* Context =  RHIGetCurrentGraphicsContext();
-    
     BeginQueryLocation = RHIAllocateQuery(D3D12_QUERY_TYPE_TIMESTAMP);
     Context->EndQuery(BeginQueryLocation.Heap, D3D12_QUERY_TYPE_TIMESTAMP, BeginQueryLocation.Index);
 }
 
 void FGPUEventNode::StopTiming()
 {
-    FGraphicsContext* Context = RHIGetCurrentGraphicsContext();
-
     EndQueryLocation = RHIAllocateQuery(D3D12_QUERY_TYPE_TIMESTAMP);
     Context->EndQuery(EndQueryLocation.Heap, D3D12_QUERY_TYPE_TIMESTAMP, EndQueryLocation.Index);
 }
@@ -29,8 +27,7 @@ double FGPUEventNode::GetTiming(UINT64* ReadBackData)
     double TimingMs = 0;
 
     UINT64 GpuFrequency = 0;
-    FCommandQueue* CommandQueue = RHIGetDirectCommandQueue();
-    CommandQueue->GetTimestampFrequency(&GpuFrequency); // Hz (ticks per second)
+    TimestampQueue->GetTimestampFrequency(&GpuFrequency); // Hz (ticks per second)
 
     uint32_t Timing = 0;
     if (BeginQueryLocation && EndQueryLocation)
@@ -78,6 +75,7 @@ void FGPUProfiler::EndFrameAfterFence()
         TraverseNode(PendingNodes[Index], ReadBackData);
 
         RHIGetTimestampQueryHeap()->UnmapReadbackBuffer();
+        NodeArenas[(GFrameCount - FRAMES_IN_FLIGHT) % NUM_NODE_ARENAS].Reset();
     }
 
     PendingNodes[Index] = RootNode;
@@ -109,24 +107,28 @@ void FGPUProfiler::TraverseNode(FGPUEventNode* Node, UINT64* ReadBackData)
         };
         ProfileData.push_back(PopData);
     }
-    
-    delete Node;
-    Node = nullptr;
 }
 
-void FGPUProfiler::PushEvent(const char* Name, bool bFrameStart)
+void FGPUProfiler::PushEvent(const char* Name, bool bFrameStart, FGraphicsContext* Context)
 {
+    if (!Context)
+    {
+        Context = RHIGetCurrentGraphicsContext();
+    }
+
     StackDepth++;
     if (CurrentEventNode)
     {
-        FGPUEventNode* Node = new FGPUEventNode(Name, CurrentEventNode);
+        FLinearArena& Arena = NodeArenas[GFrameCount % NUM_NODE_ARENAS];
+        FGPUEventNode* Node = Arena.New<FGPUEventNode>(Name, CurrentEventNode, Arena, Context);
         CurrentEventNode->Children.push_back(Node);
         CurrentEventNode = CurrentEventNode->Children[CurrentEventNode->Children.size() - 1];
     }
     else
     {
         // Add a new root node to the tree
-        RootNode = new FGPUEventNode(Name, nullptr);
+        FLinearArena& Arena = NodeArenas[GFrameCount % NUM_NODE_ARENAS];
+        RootNode = Arena.New<FGPUEventNode>(Name, nullptr, Arena, Context);
         CurrentEventNode = RootNode;
     }
 
@@ -171,9 +173,9 @@ void FGPUProfiler::ResolveQueryData()
     );
 }
 
-GPUProfileScopedObject::GPUProfileScopedObject(const char* Name)
+GPUProfileScopedObject::GPUProfileScopedObject(const char* Name, FGraphicsContext* Context)
 {
-    RHIGetGPUProfiler().PushEvent(Name);
+    RHIGetGPUProfiler().PushEvent(Name, false, Context);
 }
 
 GPUProfileScopedObject::~GPUProfileScopedObject()
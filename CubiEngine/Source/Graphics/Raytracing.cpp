@@ -1,23 +1,25 @@
 #include "Graphics/Raytracing.h"
+#include "Core/FrameArena.h"
 #include "Graphics/D3D12DynamicRHI.h"
+#include "Graphics/GeometryPool.h"
 #include "Graphics/GraphicsContext.h"
 #include "Graphics/Material.h"
 #include "Scene/Mesh.h"
 #include "Scene/Scene.h"
 
 FRaytracingGeometry::FRaytracingGeometry(
-    std::pair<wrl::ComPtr<ID3D12Resource>, uint32_t>& VertexBuffer,
-    std::pair<wrl::ComPtr<ID3D12Resource>, uint32_t>& IndexBuffer)
+    ID3D12Resource* VertexBuffer, uint64_t VertexOffsetInBytes, uint32_t VertexCount,
+    ID3D12Resource* IndexBuffer, uint64_t IndexOffsetInBytes, uint32_t IndexCount)
 {
     BLASGenerator bottomLevelASGenerator;
     bottomLevelASGenerator.AddVertexBuffer(
-        VertexBuffer.first.Get(),
-        0,
-        VertexBuffer.second,
+        VertexBuffer,
+        VertexOffsetInBytes,
+        VertexCount,
         sizeof(XMFLOAT3),
-        IndexBuffer.first.Get(),
-        0,
-        IndexBuffer.second,
+        IndexBuffer,
+        IndexOffsetInBytes,
+        IndexCount,
         0,
         0
     );
@@ -25,6 +27,7 @@ FRaytracingGeometry::FRaytracingGeometry(
     UINT64 scratchSize, resultSize;
     bottomLevelASGenerator.ComputeASBufferSizes(RHIGetDevice(), false, &scratchSize, &resultSize);
 
+    ComPtr<ID3D12Resource> scratch;
     RHICreateRawBuffer(
         scratch,
         scratchSize, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, kDefaultHeapProps
@@ -41,6 +44,9 @@ FRaytracingGeometry::FRaytracingGeometry(
         false,
         nullptr
     );
+
+    // Only the build reads the scratch memory.
+    RHIDeferRelease(std::move(scratch), scratchSize);
 }
 
 void FRaytracingScene::GenerateRaytracingScene(
@@ -51,12 +57,17 @@ void FRaytracingScene::GenerateRaytracingScene(
     if (pResult)
     {
         //Todo : rebuild if scene is changed
+        // The instances stay valid when the geometry pool moves, the stream SRVs and ranges in the geometry infos do not.
+        if (RHIGetGeometryPool()->GetBufferGeneration() != GeometryPoolGeneration)
+        {
+            GenerateRaytracingBuffers(GraphicsContext, RaytracingGeometryContextList);
+        }
         return;
     }
 
-    pScratch.Reset();
-    pResult.Reset();
-    pInstanceDesc.Reset();
+    // Frames in flight may still trace against the previous structure.
+    RHIDeferRelease(std::move(pResult));
+    RHIDeferRelease(std::move(pInstanceDesc));
 
     TopLevelASGenerator topLevelASGenerator;
 
@@ -74,6 +85,7 @@ void FRaytracingScene::GenerateRaytracingScene(
     topLevelASGenerator.ComputeASBufferSizes(RHIGetDevice(), true, &scratchSize,
         &resultSize, &instanceDescsSize);
 
+    ComPtr<ID3D12Resource> pScratch;
     RHICreateRawBuffer(
         pScratch,
         scratchSize, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
@@ -99,6 +111,8 @@ void FRaytracingScene::GenerateRaytracingScene(
         pResult.Get(),
         pInstanceDesc.Get()
     );
+    // The structure is never updated in place, a rebuild allocates new scratch memory.
+    RHIDeferRelease(std::move(pScratch), scratchSize);
 
     CreateTopLevelASResourceView();
 
@@ -111,14 +125,19 @@ void FRaytracingScene::GenerateRaytracingBuffers(FGraphicsContext* const Graphic
     uint32_t vtxOffset = 0;
     uint32_t idxOffset = 0;
 
-    std::vector<interlop::FRaytracingGeometryInfo> GeometryInfoList;
-    std::vector<interlop::FRaytracingMaterial> MaterialList;
+    // Only lives until the buffers below are created, keep it off the heap.
+    FLinearArena& FrameArena = GetFrameArena();
+    TArenaVector<interlop::FRaytracingGeometryInfo> GeometryInfoList(FrameArena);
+    TArenaVector<interlop::FRaytracingMaterial> MaterialList(FrameArena);
     GeometryInfoList.reserve(RaytracingGeometryContextList.size());
     MaterialList.reserve(RaytracingGeometryContextList.size());
 
     std::vector<interlop::MeshVertex> MeshVertexList;
     std::vector<uint32_t> IndexList;
 
+    const FGeometryPool* GeometryPool = RHIGetGeometryPool();
+    GeometryPoolGeneration = GeometryPool->GetBufferGeneration();
+
     for (size_t i = 0; i < RaytracingGeometryContextList.size(); i++)
     {
         FRaytracingGeometryContext& Context = RaytracingGeometryContextList[i];
@@ -129,14 +148,17 @@ void FRaytracingScene::GenerateRaytracingBuffers(FGraphicsContext* const Graphic
         if (Mesh)
         {
             // Geometry
+            const FGeometryRange& Range = Mesh->GetGeometryRange();
             GeometryInfoList.push_back(
                 interlop::FRaytracingGeometryInfo{
-					Context.Mesh->PositionBuffer.SrvIndex,
-					Context.Mesh->TextureCoordsBuffer.SrvIndex,
-					Context.Mesh->NormalBuffer.SrvIndex,
-					Context.Mesh->TangentBuffer.SrvIndex,
-					Context.Mesh->IndexBuffer.SrvIndex,
+					GeometryPool->GetVertexBufferSrv(FGeometryPool::Position),
+					GeometryPool->GetVertexBufferSrv(FGeometryPool::TextureCoord),
+					GeometryPool->GetVertexBufferSrv(FGeometryPool::Normal),
+					GeometryPool->GetVertexBufferSrv(FGeometryPool::Tangent),
+					GeometryPool->GetIndexBufferSrv(),
 					(uint32_t)i,
+					Range.BaseVertex,
+					Range.FirstIndex,
                 }
             );
 
@@ -151,17 +173,28 @@ void FRaytracingScene::GenerateRaytracingBuffers(FGraphicsContext* const Graphic
                     .normalTextureSamplerIndex = Material->NormalSampler.SamplerIndex,
 					.ormTextureIndex = Material->GetORMTextureSrv(),
 					.ormTextureSamplerIndex = Material->ORMSampler.SamplerIndex,
-                    .albedoColor = Material->MaterialBufferData.albedoColor,
-					.metallic = Material->MaterialBufferData.metallicFactor,
-					.roughness = Material->MaterialBufferData.roughnessFactor,
-                    .emissiveColor = Material->MaterialBufferData.emissiveColor,
-					.refractionFactor = Material->MaterialBufferData.refractionFactor,
-					.IOR = Material->MaterialBufferData.IOR,
+                    .albedoColor = Material->GetParameters().albedoColor,
+					.metallic = Material->GetParameters().metallicFactor,
+					.roughness = Material->GetParameters().roughnessFactor,
+                    .emissiveColor = Material->GetParameters().emissiveColor,
+					.refractionFactor = Material->GetParameters().refractionFactor,
+					.IOR = Material->GetParameters().IOR,
                 }
             );
         }
     }
 
+    // Frames in flight may still read the previous buffers.
+    for (FBuffer* Buffer : { &GeometryInfoBuffer, &MaterialBuffer })
+    {
+        if (Buffer->GetResource())
+        {
+            RHIDeferReleaseCallback([SrvIndex = Buffer->SrvIndex, Allocation = std::move(Buffer->Allocation)]() {
+                RHIGetCbvSrvUavDescriptorHeap()->FreeDescriptor(SrvIndex);
+            }, Buffer->SizeInBytes);
+        }
+    }
+
     GeometryInfoBuffer =
         RHICreateBuffer<interlop::FRaytracingGeometryInfo>(FBufferCreationDesc{
             .Usage = EBufferUsage::StructuredBuffer,
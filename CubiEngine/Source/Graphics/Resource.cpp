@@ -162,6 +162,13 @@ bool FTexture::IsUAVAllowed(ETextureUsage Usage, DXGI_FORMAT Format)
 	}
 }
 
+bool FTexture::IsReadOnlyState(D3D12_RESOURCE_STATES State)
+{
+    // COMMON is 0, it is not a read state even though it has no write bit.
+    return State != D3D12_RESOURCE_STATE_COMMON && (State & ~D3D12_RESOURCE_STATE_GENERIC_READ & ~D3D12_RESOURCE_STATE_DEPTH_READ
+        & ~D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE) == 0;
+}
+
 FTexture::~FTexture()
 {
 	std::string TextureName = wStringToString(DebugName);
@@ -177,6 +184,11 @@ FTexture::~FTexture()
         return;
     }
 
+    if (GetResource())
+    {
+        RHIGetResourceStateTable().Unregister(GetResource());
+    }
+
     FDescriptorHeap* CbvSrvUavHeap = RHIGetCbvSrvUavDescriptorHeap();
     if (SrvIndex != INVALID_INDEX_U32)
     {
@@ -0,0 +1,298 @@
+#include "Graphics/ResourceStateTracker.h"
+
+namespace
+{
+    bool ReferencesResource(const D3D12_RESOURCE_BARRIER& Barrier, ID3D12Resource* Resource)
+    {
+        switch (Barrier.Type)
+        {
+        case D3D12_RESOURCE_BARRIER_TYPE_TRANSITION:
+            return Barrier.Transition.pResource == Resource;
+        case D3D12_RESOURCE_BARRIER_TYPE_ALIASING:
+            // Without a resource before, the barrier concerns whatever used the memory.
+            return Barrier.Aliasing.pResourceBefore == nullptr || Barrier.Aliasing.pResourceBefore == Resource
+                || Barrier.Aliasing.pResourceAfter == Resource;
+        default:
+            return Barrier.UAV.pResource == nullptr || Barrier.UAV.pResource == Resource;
+        }
+    }
+}
+
+void FSubresourceStates::SetAll(D3D12_RESOURCE_STATES NewState)
+{
+    State = NewState;
+    PerSubresource.clear();
+}
+
+void FSubresourceStates::Set(uint32_t Subresource, D3D12_RESOURCE_STATES NewState, uint32_t NumSubresources)
+{
+    if (PerSubresource.empty())
+    {
+        if (State == NewState) return;
+        PerSubresource.assign(NumSubresources, State);
+    }
+
+    assert(Subresource < PerSubresource.size());
+    PerSubresource[Subresource] = NewState;
+
+    if (std::all_of(PerSubresource.begin(), PerSubresource.end(), [&](D3D12_RESOURCE_STATES Other) { return Other == NewState; }))
+    {
+        SetAll(NewState);
+    }
+}
+
+void FResourceStateTable::Register(ID3D12Resource* Resource, uint32_t NumSubresources, D3D12_RESOURCE_STATES State)
+{
+    assert(Resource != nullptr && NumSubresources > 0u);
+
+    std::scoped_lock Lock(Mutex);
+    // A resource created where a released one was takes its entry over.
+    FEntry& Entry = Entries[Resource];
+    Entry.NumSubresources = NumSubresources;
+    Entry.States.SetAll(State);
+}
+
+void FResourceStateTable::Unregister(ID3D12Resource* Resource)
+{
+    std::scoped_lock Lock(Mutex);
+    Entries.erase(Resource);
+}
+
+D3D12_RESOURCE_STATES FResourceStateTable::GetState(ID3D12Resource* Resource, uint32_t Subresource) const
+{
+    std::scoped_lock Lock(Mutex);
+    const auto Found = Entries.find(Resource);
+    if (Found == Entries.end())
+    {
+        return RESOURCE_STATE_UNKNOWN;
+    }
+
+    const FSubresourceStates& States = Found->second.States;
+    if (Subresource != D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES)
+    {
+        return States.Get(Subresource);
+    }
+    return States.IsUniform() ? States.State : RESOURCE_STATE_UNKNOWN;
+}
+
+void FResourceStateTracker::Transition(ID3D12Resource* Resource, uint32_t NumSubresources, D3D12_RESOURCE_STATES StateBefore,
+    D3D12_RESOURCE_STATES StateAfter, uint32_t Subresource)
+{
+    TransitionSubresources(Resource, NumSubresources, StateBefore, StateAfter, Subresource, D3D12_RESOURCE_BARRIER_FLAG_NONE);
+}
+
+void FResourceStateTracker::BeginTransition(ID3D12Resource* Resource, uint32_t NumSubresources, D3D12_RESOURCE_STATES StateBefore,
+    D3D12_RESOURCE_STATES StateAfter, uint32_t Subresource)
+{
+    TransitionSubresources(Resource, NumSubresources, StateBefore, StateAfter, Subresource, D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY);
+}
+
+void FResourceStateTracker::EndTransition(ID3D12Resource* Resource, uint32_t Subresource)
+{
+    std::erase_if(SplitTransitions, [&](const FSplitTransition& Split) {
+        if (Split.Resource != Resource
+            || (Subresource != D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES && Split.Subresource != Subresource))
+        {
+            return false;
+        }
+
+        Barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(Resource, Split.StateBefore, Split.StateAfter,
+            Split.Subresource, D3D12_RESOURCE_BARRIER_FLAG_END_ONLY));
+        return true;
+    });
+}
+
+void FResourceStateTracker::TransitionSubresources(ID3D12Resource* Resource, uint32_t NumSubresources,
+    D3D12_RESOURCE_STATES StateBefore, D3D12_RESOURCE_STATES StateAfter, uint32_t Subresource, D3D12_RESOURCE_BARRIER_FLAGS Flags)
+{
+    assert(Resource != nullptr && StateAfter != RESOURCE_STATE_UNKNOWN);
+    assert(!IsSplitInFlight(Resource, Subresource) && "A subresource is not used between the two halves of a split transition.");
+
+    const auto [Found, bInserted] = Resources.try_emplace(Resource);
+    FTrackedResource& Tracked = Found->second;
+    if (bInserted)
+    {
+        // Whatever the caller expects is what the list starts from, submission checks it.
+        Tracked.NumSubresources = NumSubresources;
+        Tracked.Initial.SetAll(StateBefore);
+        Tracked.Current.SetAll(StateBefore);
+    }
+
+    auto TransitionSubresource = [&](uint32_t Index, D3D12_RESOURCE_STATES Current) {
+        if (Current == RESOURCE_STATE_UNKNOWN)
+        {
+            // First use of a subresource in an unknown state, the list starts with it in StateAfter.
+            if (Index == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES)
+            {
+                Tracked.Initial.SetAll(StateAfter);
+            }
+            else
+            {
+                Tracked.Initial.Set(Index, StateAfter, Tracked.NumSubresources);
+            }
+        }
+        else if (Current != StateAfter)
+        {
+            QueueTransition(Resource, Index, Current, StateAfter, Flags);
+        }
+    };
+
+    if (Subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES)
+    {
+        if (Tracked.Current.IsUniform())
+        {
+            TransitionSubresource(Subresource, Tracked.Current.State);
+        }
+        else
+        {
+            for (uint32_t Index = 0; Index < Tracked.NumSubresources; Index++)
+            {
+                TransitionSubresource(Index, Tracked.Current.Get(Index));
+            }
+        }
+        Tracked.Current.SetAll(StateAfter);
+    }
+    else
+    {
+        assert(Subresource < Tracked.NumSubresources);
+        TransitionSubresource(Subresource, Tracked.Current.Get(Subresource));
+        Tracked.Current.Set(Subresource, StateAfter, Tracked.NumSubresources);
+    }
+}
+
+void FResourceStateTracker::QueueTransition(ID3D12Resource* Resource, uint32_t Subresource, D3D12_RESOURCE_STATES StateBefore,
+    D3D12_RESOURCE_STATES StateAfter, D3D12_RESOURCE_BARRIER_FLAGS Flags)
+{
+    if (Flags == D3D12_RESOURCE_BARRIER_FLAG_NONE)
+    {
+        // Only the latest queued barrier touching the subresource can absorb this one, anything after it would
+        // change order. Transitions of other subresources do not touch it.
+        const auto Last = std::find_if(Barriers.rbegin(), Barriers.rend(), [&](const D3D12_RESOURCE_BARRIER& Barrier) {
+            const bool bOtherSubresource = Barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION
+                && Subresource != D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES
+                && Barrier.Transition.Subresource != D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES
+                && Barrier.Transition.Subresource != Subresource;
+            return ReferencesResource(Barrier, Resource) && !bOtherSubresource;
+        });
+        if (Last != Barriers.rend() && Last->Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION
+            && Last->Flags == D3D12_RESOURCE_BARRIER_FLAG_NONE && Last->Transition.Subresource == Subresource)
+        {
+            assert(Last->Transition.StateAfter == StateBefore);
+            if (Last->Transition.StateBefore == StateAfter)
+            {
+                Barriers.erase(std::next(Last).base());
+            }
+            else
+            {
+                Last->Transition.StateAfter = StateAfter;
+            }
+            return;
+        }
+    }
+    else
+    {
+        SplitTransitions.push_back(FSplitTransition{
+            .Resource = Resource,
+            .Subresource = Subresource,
+            .StateBefore = StateBefore,
+            .StateAfter = StateAfter,
+        });
+    }
+
+    Barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(Resource, StateBefore, StateAfter, Subresource, Flags));
+}
+
+bool FResourceStateTracker::IsSplitInFlight(ID3D12Resource* Resource, uint32_t Subresource) const
+{
+    return std::any_of(SplitTransitions.begin(), SplitTransitions.end(), [&](const FSplitTransition& Split) {
+        return Split.Resource == Resource && (Subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES
+            || Split.Subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES || Split.Subresource == Subresource);
+    });
+}
+
+void FResourceStateTracker::UAVBarrier(ID3D12Resource* Resource)
+{
+    Barriers.push_back(CD3DX12_RESOURCE_BARRIER::UAV(Resource));
+}
+
+void FResourceStateTracker::AliasingBarrier(ID3D12Resource* Before, ID3D12Resource* After)
+{
+    Barriers.push_back(CD3DX12_RESOURCE_BARRIER::Aliasing(Before, After));
+}
+
+void FResourceStateTracker::AddBarrier(const D3D12_RESOURCE_BARRIER& Barrier)
+{
+    Barriers.push_back(Barrier);
+}
+
+D3D12_RESOURCE_STATES FResourceStateTracker::GetState(ID3D12Resource* Resource) const
+{
+    const auto Found = Resources.find(Resource);
+    return Found != Resources.end() && Found->second.Current.IsUniform() ? Found->second.Current.State : RESOURCE_STATE_UNKNOWN;
+}
+
+void FResourceStateTracker::ResolvePendingBarriers(FResourceStateTable& Table, std::vector<D3D12_RESOURCE_BARRIER>& OutBarriers)
+{
+    assert(Barriers.empty() && SplitTransitions.empty());
+
+    {
+        std::scoped_lock Lock(Table.Mutex);
+        for (const auto& [Resource, Tracked] : Resources)
+        {
+            const auto Found = Table.Entries.find(Resource);
+            if (Found == Table.Entries.end())
+            {
+                continue;
+            }
+
+            FResourceStateTable::FEntry& Entry = Found->second;
+            assert((Tracked.Initial.IsUniform() && Tracked.Current.IsUniform()) || Tracked.NumSubresources == Entry.NumSubresources);
+
+            if (Tracked.Initial.IsUniform() && Entry.States.IsUniform())
+            {
+                if (Tracked.Initial.State != RESOURCE_STATE_UNKNOWN && Tracked.Initial.State != Entry.States.State)
+                {
+                    OutBarriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(Resource, Entry.States.State, Tracked.Initial.State));
+                }
+            }
+            else
+            {
+                for (uint32_t Index = 0; Index < Entry.NumSubresources; Index++)
+                {
+                    const D3D12_RESOURCE_STATES Initial = Tracked.Initial.Get(Index);
+                    if (Initial != RESOURCE_STATE_UNKNOWN && Initial != Entry.States.Get(Index))
+                    {
+                        OutBarriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(Resource, Entry.States.Get(Index), Initial, Index));
+                    }
+                }
+            }
+
+            if (Tracked.Current.IsUniform())
+            {
+                if (Tracked.Current.State != RESOURCE_STATE_UNKNOWN)
+                {
+                    Entry.States.SetAll(Tracked.Current.State);
+                }
+            }
+            else
+            {
+                for (uint32_t Index = 0; Index < Entry.NumSubresources; Index++)
+                {
+                    if (Tracked.Current.Get(Index) != RESOURCE_STATE_UNKNOWN)
+                    {
+                        Entry.States.Set(Index, Tracked.Current.Get(Index), Entry.NumSubresources);
+                    }
+                }
+            }
+        }
+    }
+
+    Reset();
+}
+
+void FResourceStateTracker::Reset()
+{
+    Resources.clear();
+    Barriers.clear();
+    SplitTransitions.clear();
+}
@@ -0,0 +1,322 @@
+#include "Graphics/ShaderCache.h"
+
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+namespace
+{
+    // Bump whenever the key, manifest or blob layout changes, old entries then simply stop matching.
+    constexpr uint32_t CACHE_FORMAT_VERSION = 1u;
+    constexpr uint32_t MANIFEST_MAGIC = 0x4D485343; // CSHM
+    constexpr uint32_t BLOB_MAGIC = 0x42485343; // CSHB
+
+    constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+    constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+    uint64_t HashBytes(const void* Data, size_t Size, uint64_t Hash = FNV_OFFSET_BASIS)
+    {
+        const uint8_t* Bytes = static_cast<const uint8_t*>(Data);
+        for (size_t Index = 0u; Index < Size; ++Index)
+        {
+            Hash = (Hash ^ Bytes[Index]) * FNV_PRIME;
+        }
+        return Hash;
+    }
+
+    template<typename T>
+    uint64_t HashValue(const T& Value, uint64_t Hash)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return HashBytes(&Value, sizeof(T), Hash);
+    }
+
+    // Length first, so ("ab", "c") and ("a", "bc") do not collide.
+    uint64_t HashString(const std::wstring_view String, uint64_t Hash)
+    {
+        Hash = HashValue(static_cast<uint64_t>(String.size()), Hash);
+        return HashBytes(String.data(), String.size() * sizeof(wchar_t), Hash);
+    }
+
+    std::wstring NormalizePath(const std::wstring& Path)
+    {
+        return std::filesystem::path(Path).lexically_normal().wstring();
+    }
+
+    uint64_t HashBlobInputs(uint64_t KeyHash, const std::vector<std::wstring>& Dependencies, const std::vector<uint64_t>& DependencyHashes)
+    {
+        uint64_t Hash = KeyHash;
+        for (size_t Index = 0u; Index < Dependencies.size(); ++Index)
+        {
+            Hash = HashString(Dependencies[Index], Hash);
+            Hash = HashValue(DependencyHashes[Index], Hash);
+        }
+        return Hash;
+    }
+
+    template<typename T>
+    void WriteValue(std::ofstream& File, const T& Value)
+    {
+        File.write(reinterpret_cast<const char*>(&Value), sizeof(T));
+    }
+
+    template<typename T>
+    bool ReadValue(std::ifstream& File, T& Value)
+    {
+        return static_cast<bool>(File.read(reinterpret_cast<char*>(&Value), sizeof(T)));
+    }
+
+    bool ReadBytes(std::ifstream& File, std::vector<uint8_t>& Bytes, uint64_t Size)
+    {
+        Bytes.resize(Size);
+        return Size == 0u || static_cast<bool>(File.read(reinterpret_cast<char*>(Bytes.data()), Size));
+    }
+
+    // Written next to the destination and renamed over it, so a reader never sees half a file and two threads
+    // storing the same entry do not interleave.
+    template<typename WriteFunction>
+    void WriteFileAtomically(const std::filesystem::path& Path, WriteFunction&& Write)
+    {
+        std::filesystem::path TempPath = Path;
+        TempPath += std::format(L".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+        {
+            std::ofstream File(TempPath, std::ios::binary | std::ios::trunc);
+            if (!File)
+            {
+                Log(std::format(L"Failed to write shader cache file {}.", Path.wstring()));
+                return;
+            }
+            Write(File);
+        }
+
+        std::error_code Error;
+        std::filesystem::rename(TempPath, Path, Error);
+        if (Error)
+        {
+            std::filesystem::remove(TempPath, Error);
+        }
+    }
+}
+
+FShaderCache::FShaderCache(const std::filesystem::path& InDirectory)
+    : Directory(InDirectory)
+{
+    std::error_code Error;
+    std::filesystem::create_directories(Directory, Error);
+    if (Error)
+    {
+        Log(std::format("Failed to create shader cache directory {} : {}.", Directory.string(), Error.message()));
+    }
+}
+
+bool FShaderCache::GetOrCompile(const FShaderCacheKey& Key, const FShaderCompileFunction& Compile, FShaderCompileOutput& Output)
+{
+    if (Lookup(Key, Output))
+    {
+        return true;
+    }
+
+    Output = {};
+    if (!Compile(Key, Output))
+    {
+        return false;
+    }
+
+    Store(Key, Output);
+    return true;
+}
+
+bool FShaderCache::Lookup(const FShaderCacheKey& Key, FShaderCompileOutput& Output)
+{
+    const uint64_t KeyHash = HashKey(Key);
+
+    auto Miss = [&](bool bInvalidated)
+    {
+        std::lock_guard Lock(Mutex);
+        Stats.NumMisses++;
+        if (bInvalidated)
+        {
+            Stats.NumInvalidated++;
+        }
+        return false;
+    };
+
+    std::ifstream Manifest(GetManifestPath(KeyHash), std::ios::binary);
+    if (!Manifest)
+    {
+        return Miss(false);
+    }
+
+    uint32_t Magic = 0u;
+    uint32_t Version = 0u;
+    uint64_t StoredKeyHash = 0u;
+    uint64_t StoredBlobHash = 0u;
+    uint32_t NumDependencies = 0u;
+    if (!ReadValue(Manifest, Magic) || !ReadValue(Manifest, Version) || !ReadValue(Manifest, StoredKeyHash) ||
+        !ReadValue(Manifest, StoredBlobHash) || !ReadValue(Manifest, NumDependencies) ||
+        Magic != MANIFEST_MAGIC || Version != CACHE_FORMAT_VERSION || StoredKeyHash != KeyHash)
+    {
+        return Miss(false);
+    }
+
+    std::vector<std::wstring> Dependencies(NumDependencies);
+    std::vector<uint64_t> DependencyHashes(NumDependencies);
+    for (uint32_t Index = 0u; Index < NumDependencies; ++Index)
+    {
+        uint32_t Length = 0u;
+        if (!ReadValue(Manifest, Length))
+        {
+            return Miss(false);
+        }
+
+        Dependencies[Index].resize(Length);
+        if (!Manifest.read(reinterpret_cast<char*>(Dependencies[Index].data()), Length * sizeof(wchar_t)))
+        {
+            return Miss(false);
+        }
+
+        DependencyHashes[Index] = HashFile(Dependencies[Index]);
+    }
+
+    // Any dependency that changed or went missing moves the inputs to a different blob.
+    if (HashBlobInputs(KeyHash, Dependencies, DependencyHashes) != StoredBlobHash)
+    {
+        return Miss(true);
+    }
+
+    std::ifstream Blob(GetBlobPath(StoredBlobHash), std::ios::binary);
+    uint64_t ObjectSize = 0u;
+    uint64_t RootSignatureSize = 0u;
+    if (!Blob || !ReadValue(Blob, Magic) || !ReadValue(Blob, Version) || Magic != BLOB_MAGIC || Version != CACHE_FORMAT_VERSION ||
+        !ReadValue(Blob, ObjectSize) || !ReadValue(Blob, RootSignatureSize) ||
+        !ReadBytes(Blob, Output.Object, ObjectSize) || !ReadBytes(Blob, Output.RootSignature, RootSignatureSize))
+    {
+        Output = {};
+        return Miss(false);
+    }
+
+    Output.Dependencies = std::move(Dependencies);
+
+    std::lock_guard Lock(Mutex);
+    Stats.NumHits++;
+    return true;
+}
+
+void FShaderCache::Store(const FShaderCacheKey& Key, const FShaderCompileOutput& Output)
+{
+    const uint64_t KeyHash = HashKey(Key);
+
+    // Sorted, so the blob hash does not depend on the order the compiler opened includes in.
+    std::vector<std::wstring> Dependencies;
+    Dependencies.reserve(Output.Dependencies.size() + 1u);
+    Dependencies.push_back(NormalizePath(Key.SourcePath));
+    for (const std::wstring& Dependency : Output.Dependencies)
+    {
+        Dependencies.push_back(NormalizePath(Dependency));
+    }
+    std::sort(Dependencies.begin(), Dependencies.end());
+    Dependencies.erase(std::unique(Dependencies.begin(), Dependencies.end()), Dependencies.end());
+
+    std::vector<uint64_t> DependencyHashes;
+    DependencyHashes.reserve(Dependencies.size());
+    for (const std::wstring& Dependency : Dependencies)
+    {
+        DependencyHashes.push_back(HashFile(Dependency));
+    }
+
+    const uint64_t BlobHash = HashBlobInputs(KeyHash, Dependencies, DependencyHashes);
+
+    // Blob first, a manifest must never point at a blob that is not there yet.
+    WriteFileAtomically(GetBlobPath(BlobHash), [&](std::ofstream& File)
+    {
+        WriteValue(File, BLOB_MAGIC);
+        WriteValue(File, CACHE_FORMAT_VERSION);
+        WriteValue(File, static_cast<uint64_t>(Output.Object.size()));
+        WriteValue(File, static_cast<uint64_t>(Output.RootSignature.size()));
+        File.write(reinterpret_cast<const char*>(Output.Object.data()), Output.Object.size());
+        File.write(reinterpret_cast<const char*>(Output.RootSignature.data()), Output.RootSignature.size());
+    });
+
+    WriteFileAtomically(GetManifestPath(KeyHash), [&](std::ofstream& File)
+    {
+        WriteValue(File, MANIFEST_MAGIC);
+        WriteValue(File, CACHE_FORMAT_VERSION);
+        WriteValue(File, KeyHash);
+        WriteValue(File, BlobHash);
+        WriteValue(File, static_cast<uint32_t>(Dependencies.size()));
+        for (const std::wstring& Dependency : Dependencies)
+        {
+            WriteValue(File, static_cast<uint32_t>(Dependency.size()));
+            File.write(reinterpret_cast<const char*>(Dependency.data()), Dependency.size() * sizeof(wchar_t));
+        }
+    });
+}
+
+FShaderCacheStats FShaderCache::GetStats() const
+{
+    std::lock_guard Lock(Mutex);
+    return Stats;
+}
+
+uint64_t FShaderCache::HashKey(const FShaderCacheKey& Key)
+{
+    uint64_t Hash = HashValue(CACHE_FORMAT_VERSION, FNV_OFFSET_BASIS);
+    Hash = HashString(NormalizePath(Key.SourcePath), Hash);
+    Hash = HashString(Key.EntryPoint, Hash);
+    Hash = HashString(Key.TargetProfile, Hash);
+    Hash = HashValue(static_cast<uint64_t>(Key.Arguments.size()), Hash);
+    for (const std::wstring& Argument : Key.Arguments)
+    {
+        Hash = HashString(Argument, Hash);
+    }
+    return HashValue(Key.CompilerVersion, Hash);
+}
+
+uint64_t FShaderCache::HashFile(const std::wstring& Path)
+{
+    std::error_code Error;
+    const std::filesystem::file_time_type WriteTime = std::filesystem::last_write_time(Path, Error);
+    if (Error)
+    {
+        return 0u;
+    }
+    const uintmax_t Size = std::filesystem::file_size(Path, Error);
+    if (Error)
+    {
+        return 0u;
+    }
+
+    {
+        std::lock_guard Lock(Mutex);
+        auto It = FileHashes.find(Path);
+        if (It != FileHashes.end() && It->second.WriteTime == WriteTime && It->second.Size == Size)
+        {
+            return It->second.Hash;
+        }
+    }
+
+    std::ifstream File(std::filesystem::path(Path), std::ios::binary);
+    if (!File)
+    {
+        return 0u;
+    }
+    const std::vector<char> Contents{ std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>() };
+
+    // Mixed with the size so an empty file never hashes to the missing-file value.
+    const uint64_t Hash = HashBytes(Contents.data(), Contents.size(), HashValue(static_cast<uint64_t>(Contents.size()), FNV_OFFSET_BASIS));
+
+    std::lock_guard Lock(Mutex);
+    FileHashes[Path] = FFileHash{ .WriteTime = WriteTime, .Size = Size, .Hash = Hash };
+    return Hash;
+}
+
+std::filesystem::path FShaderCache::GetManifestPath(uint64_t KeyHash) const
+{
+    return Directory / std::format("{:016x}.manifest", KeyHash);
+}
+
+std::filesystem::path FShaderCache::GetBlobPath(uint64_t BlobHash) const
+{
+    return Directory / std::format("{:016x}.blob", BlobHash);
+}
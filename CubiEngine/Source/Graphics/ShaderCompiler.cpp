@@ -1,19 +1,147 @@
 #include "Graphics/ShaderCompiler.h"
+#include "Graphics/ShaderCache.h"
 #include "Core/FileSystem.h"
 
+#include <mutex>
+
 namespace ShaderCompiler
 {
+    // DXC objects are not thread safe, every thread compiling pipelines in the background gets its own.
     // Responsible for the actual compilation of shaders.
-    wrl::ComPtr<IDxcCompiler3> compiler{};
+    thread_local wrl::ComPtr<IDxcCompiler3> compiler{};
 
     // Used to create include handle and provides interfaces for loading shader to blob, etc.
-    wrl::ComPtr<IDxcUtils> utils{};
-    wrl::ComPtr<IDxcIncludeHandler> includeHandler{};
+    thread_local wrl::ComPtr<IDxcUtils> utils{};
+    thread_local wrl::ComPtr<IDxcIncludeHandler> includeHandler{};
 
+    // Shared by all threads, set up once by whichever thread compiles first.
+    std::once_flag initializeOnce{};
     std::wstring shaderDirectory{};
 
+    std::unique_ptr<FShaderCache> shaderCache{};
+    uint64_t compilerVersion{};
+
+    // Forwards to the default include handler and records every file it managed to open, which gives the
+    // transitive include closure of one compile. Lives on the stack for the duration of the compile.
+    class FTrackingIncludeHandler : public IDxcIncludeHandler
+    {
+    public:
+        explicit FTrackingIncludeHandler(IDxcIncludeHandler* InDefaultHandler) : defaultHandler(InDefaultHandler) {}
+
+        HRESULT STDMETHODCALLTYPE LoadSource(LPCWSTR fileName, IDxcBlob** includeSource) override
+        {
+            // DXC probes every include directory, only successful loads are dependencies.
+            const HRESULT hr = defaultHandler->LoadSource(fileName, includeSource);
+            if (SUCCEEDED(hr))
+            {
+                dependencies.emplace_back(fileName);
+            }
+            return hr;
+        }
+
+        HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) override
+        {
+            if (riid == __uuidof(IDxcIncludeHandler) || riid == __uuidof(IUnknown))
+            {
+                *object = static_cast<IDxcIncludeHandler*>(this);
+                return S_OK;
+            }
+            *object = nullptr;
+            return E_NOINTERFACE;
+        }
+
+        ULONG STDMETHODCALLTYPE AddRef() override { return 1u; }
+        ULONG STDMETHODCALLTYPE Release() override { return 1u; }
+
+        IDxcIncludeHandler* defaultHandler;
+        std::vector<std::wstring> dependencies{};
+    };
+
+    std::vector<uint8_t> CopyBlob(IDxcBlob* blob)
+    {
+        if (!blob)
+        {
+            return {};
+        }
+
+        const uint8_t* data = static_cast<const uint8_t*>(blob->GetBufferPointer());
+        return std::vector<uint8_t>(data, data + blob->GetBufferSize());
+    }
+
+    wrl::ComPtr<IDxcBlob> CreateBlob(const std::vector<uint8_t>& data)
+    {
+        if (data.empty())
+        {
+            return nullptr;
+        }
+
+        wrl::ComPtr<IDxcBlobEncoding> blob{};
+        ThrowIfFailed(utils->CreateBlob(data.data(), static_cast<uint32_t>(data.size()), DXC_CP_ACP, &blob));
+        return blob;
+    }
+
+    bool CompileWithDxc(const FShaderCacheKey& key, FShaderCompileOutput& output)
+    {
+        std::vector<LPCWSTR> compilationArguments = {
+            L"-E",
+            key.EntryPoint.c_str(),
+            L"-T",
+            key.TargetProfile.c_str(),
+        };
+        for (const std::wstring& argument : key.Arguments)
+        {
+            compilationArguments.push_back(argument.c_str());
+        }
+
+        // Load the shader source file to a blob.
+        wrl::ComPtr<IDxcBlobEncoding> sourceBlob{ nullptr };
+        ThrowIfFailed(utils->LoadFile(key.SourcePath.c_str(), nullptr, &sourceBlob));
+
+        const DxcBuffer sourceBuffer = {
+            .Ptr = sourceBlob->GetBufferPointer(),
+            .Size = sourceBlob->GetBufferSize(),
+            .Encoding = 0u,
+        };
+
+        // Compile the shader.
+        FTrackingIncludeHandler trackingIncludeHandler(includeHandler.Get());
+        wrl::ComPtr<IDxcResult> compiledShaderBuffer{};
+        const HRESULT hr = compiler->Compile(&sourceBuffer, compilationArguments.data(),
+            static_cast<uint32_t>(compilationArguments.size()), &trackingIncludeHandler,
+            IID_PPV_ARGS(&compiledShaderBuffer));
+        if (FAILED(hr))
+        {
+            FatalError(std::format("Failed to compile shader with path : {}", wStringToString(key.SourcePath)));
+        }
+
+        // Get compilation errors (if any).
+        wrl::ComPtr<IDxcBlobUtf8> errors{};
+        ThrowIfFailed(compiledShaderBuffer->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&errors), nullptr));
+        if (errors && errors->GetStringLength() > 0)
+        {
+            const LPCSTR errorMessage = errors->GetStringPointer();
+            FatalError(std::format("Shader path : {}, Error : {}", wStringToString(key.SourcePath), errorMessage));
+        }
+
+        wrl::ComPtr<IDxcBlob> compiledShaderBlob{ nullptr };
+        compiledShaderBuffer->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&compiledShaderBlob), nullptr);
+        output.Object = CopyBlob(compiledShaderBlob.Get());
+
+        // Always kept, whether the caller extracts the root signature is not part of the cache key.
+        if (compiledShaderBuffer->HasOutput(DXC_OUT_ROOT_SIGNATURE))
+        {
+            wrl::ComPtr<IDxcBlob> rootSignatureBlob{ nullptr };
+            compiledShaderBuffer->GetOutput(DXC_OUT_ROOT_SIGNATURE, IID_PPV_ARGS(&rootSignatureBlob), nullptr);
+            output.RootSignature = CopyBlob(rootSignatureBlob.Get());
+        }
+
+        output.Dependencies = std::move(trackingIncludeHandler.dependencies);
+        return true;
+    }
+
     Shader Compile(const ShaderTypes& shaderType, const std::wstring_view shaderPath,
-        const std::wstring_view entryPoint, const bool extractRootSignature)
+        const std::wstring_view entryPoint, const bool extractRootSignature,
+        const std::vector<std::wstring>& defines)
     {
         Shader shader{};
 
@@ -22,10 +150,37 @@ namespace ShaderCompiler
             ThrowIfFailed(::DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&utils)));
             ThrowIfFailed(::DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&compiler)));
             ThrowIfFailed(utils->CreateDefaultIncludeHandler(&includeHandler));
+        }
 
+        std::call_once(initializeOnce, []()
+        {
             shaderDirectory = FFileSystem::GetFullPath(L"Shaders");
             Log(std::format(L"Shader base directory : {}.", shaderDirectory));
-        }
+
+            // A compiler update may change the output for the same inputs.
+            wrl::ComPtr<IDxcVersionInfo> versionInfo{};
+            if (SUCCEEDED(compiler.As(&versionInfo)))
+            {
+                uint32_t major = 0u;
+                uint32_t minor = 0u;
+                versionInfo->GetVersion(&major, &minor);
+                compilerVersion = (static_cast<uint64_t>(major) << 32u) | minor;
+            }
+
+            wrl::ComPtr<IDxcVersionInfo2> versionInfo2{};
+            if (SUCCEEDED(compiler.As(&versionInfo2)))
+            {
+                uint32_t commitCount = 0u;
+                char* commitHash = nullptr;
+                if (SUCCEEDED(versionInfo2->GetCommitInfo(&commitCount, &commitHash)))
+                {
+                    compilerVersion ^= static_cast<uint64_t>(commitCount) << 48u;
+                    ::CoTaskMemFree(commitHash);
+                }
+            }
+
+            shaderCache = std::make_unique<FShaderCache>(FFileSystem::GetFullPath("Intermediate/ShaderCache"));
+        });
 
         // Setup compilation arguments.
         // need 6_6 for bindless raytracing shaders.
@@ -48,72 +203,52 @@ namespace ShaderCompiler
                 return L"";
             }
         }();
-        
-        std::vector<LPCWSTR> compilationArguments = {
-            L"-HV",
-            L"2021",
-            L"-E",
-            entryPoint.data(),
-            L"-T",
-            targetProfile.c_str(),
-            DXC_ARG_PACK_MATRIX_ROW_MAJOR,
-            DXC_ARG_WARNINGS_ARE_ERRORS,
-            DXC_ARG_ALL_RESOURCES_BOUND,
-            L"-I",
-            shaderDirectory.c_str(),
+
+        FShaderCacheKey key{
+            .SourcePath = std::wstring(shaderPath),
+            .EntryPoint = std::wstring(entryPoint),
+            .TargetProfile = targetProfile,
+            .Arguments = {
+                L"-HV",
+                L"2021",
+                DXC_ARG_PACK_MATRIX_ROW_MAJOR,
+                DXC_ARG_WARNINGS_ARE_ERRORS,
+                DXC_ARG_ALL_RESOURCES_BOUND,
+                L"-I",
+                shaderDirectory,
+            },
+            .CompilerVersion = compilerVersion,
         };
 
         // Indicate that the shader should be in a debuggable state if in debug mode.
         // Else, set optimization level to 03.
         if constexpr (DEBUG_MODE)
         {
-            compilationArguments.push_back(DXC_ARG_DEBUG);
-            compilationArguments.push_back(L"/Qembed_debug");
+            key.Arguments.push_back(DXC_ARG_DEBUG);
+            key.Arguments.push_back(L"/Qembed_debug");
         }
         else
         {
-            compilationArguments.push_back(DXC_ARG_OPTIMIZATION_LEVEL3);
+            key.Arguments.push_back(DXC_ARG_OPTIMIZATION_LEVEL3);
         }
 
-        // Load the shader source file to a blob.
-        wrl::ComPtr<IDxcBlobEncoding> sourceBlob{ nullptr };
-        ThrowIfFailed(utils->LoadFile(shaderPath.data(), nullptr, &sourceBlob));
-
-        const DxcBuffer sourceBuffer = {
-            .Ptr = sourceBlob->GetBufferPointer(),
-            .Size = sourceBlob->GetBufferSize(),
-            .Encoding = 0u,
-        };
-
-        // Compile the shader.
-        wrl::ComPtr<IDxcResult> compiledShaderBuffer{};
-        const HRESULT hr = compiler->Compile(&sourceBuffer, compilationArguments.data(),
-            static_cast<uint32_t>(compilationArguments.size()), includeHandler.Get(),
-            IID_PPV_ARGS(&compiledShaderBuffer));
-        if (FAILED(hr))
+        for (const std::wstring& define : defines)
         {
-            FatalError(std::format("Failed to compile shader with path : {}", wStringToString(shaderPath)));
+            key.Arguments.push_back(L"-D");
+            key.Arguments.push_back(define);
         }
 
-        // Get compilation errors (if any).
-        wrl::ComPtr<IDxcBlobUtf8> errors{};
-        ThrowIfFailed(compiledShaderBuffer->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&errors), nullptr));
-        if (errors && errors->GetStringLength() > 0)
+        FShaderCompileOutput output{};
+        if (!shaderCache->GetOrCompile(key, CompileWithDxc, output))
         {
-            const LPCSTR errorMessage = errors->GetStringPointer();
-            FatalError(std::format("Shader path : {}, Error : {}", wStringToString(shaderPath), errorMessage));
+            FatalError(std::format("Failed to compile shader with path : {}", wStringToString(shaderPath)));
         }
 
-        wrl::ComPtr<IDxcBlob> compiledShaderBlob{ nullptr };
-        compiledShaderBuffer->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&compiledShaderBlob), nullptr);
-
-        shader.shaderBlob = compiledShaderBlob;
+        shader.shaderBlob = CreateBlob(output.Object);
 
-        wrl::ComPtr<IDxcBlob> rootSignatureBlob{ nullptr };
         if (extractRootSignature)
         {
-            compiledShaderBuffer->GetOutput(DXC_OUT_ROOT_SIGNATURE, IID_PPV_ARGS(&rootSignatureBlob), nullptr);
-            shader.rootSignatureBlob = rootSignatureBlob;
+            shader.rootSignatureBlob = CreateBlob(output.RootSignature);
         }
 
         return shader;
@@ -0,0 +1,95 @@
+#include "Graphics/ShaderPermutation.h"
+
+uint32_t FShaderPermutationDomain::AddBool(std::wstring_view Name)
+{
+    return AddDimension(Name, 0, 2u);
+}
+
+uint32_t FShaderPermutationDomain::AddEnum(std::wstring_view Name, uint32_t NumValues)
+{
+    return AddDimension(Name, 0, NumValues);
+}
+
+uint32_t FShaderPermutationDomain::AddIntRange(std::wstring_view Name, int32_t Min, int32_t Max)
+{
+    assert(Max >= Min);
+    return AddDimension(Name, Min, static_cast<uint32_t>(Max - Min) + 1u);
+}
+
+uint32_t FShaderPermutationDomain::AddDimension(std::wstring_view Name, int32_t Min, uint32_t NumValues)
+{
+    assert(NumValues > 0u);
+    if (static_cast<uint64_t>(NumPermutations) * NumValues > UINT32_MAX)
+    {
+        FatalError(std::format("Shader permutation dimension {} overflows the permutation key.", wStringToString(Name)));
+    }
+
+    Dimensions.push_back(FDimension{ .Name = std::wstring(Name), .Min = Min, .NumValues = NumValues, .Stride = NumPermutations });
+    NumPermutations *= NumValues;
+    return static_cast<uint32_t>(Dimensions.size()) - 1u;
+}
+
+uint32_t FShaderPermutationDomain::GetKey(std::span<const int32_t> Values) const
+{
+    assert(Values.size() == Dimensions.size());
+
+    uint32_t Key = 0u;
+    for (size_t Index = 0u; Index < Dimensions.size(); ++Index)
+    {
+        const FDimension& Dimension = Dimensions[Index];
+        const int64_t Offset = static_cast<int64_t>(Values[Index]) - Dimension.Min;
+        assert(Offset >= 0 && Offset < Dimension.NumValues);
+        Key += static_cast<uint32_t>(Offset) * Dimension.Stride;
+    }
+    return Key;
+}
+
+int32_t FShaderPermutationDomain::GetValue(uint32_t Key, uint32_t Dimension) const
+{
+    assert(Key < NumPermutations);
+    const FDimension& Dim = Dimensions[Dimension];
+    return Dim.Min + static_cast<int32_t>((Key / Dim.Stride) % Dim.NumValues);
+}
+
+std::vector<int32_t> FShaderPermutationDomain::GetValues(uint32_t Key) const
+{
+    std::vector<int32_t> Values(Dimensions.size());
+    for (uint32_t Index = 0u; Index < Values.size(); ++Index)
+    {
+        Values[Index] = GetValue(Key, Index);
+    }
+    return Values;
+}
+
+bool FShaderPermutationDomain::IsValid(uint32_t Key) const
+{
+    if (Key >= NumPermutations)
+    {
+        return false;
+    }
+    return !Filter || Filter(GetValues(Key));
+}
+
+std::vector<uint32_t> FShaderPermutationDomain::GetValidKeys() const
+{
+    std::vector<uint32_t> Keys;
+    for (uint32_t Key = 0u; Key < NumPermutations; ++Key)
+    {
+        if (IsValid(Key))
+        {
+            Keys.push_back(Key);
+        }
+    }
+    return Keys;
+}
+
+std::vector<std::wstring> FShaderPermutationDomain::GetDefines(uint32_t Key) const
+{
+    std::vector<std::wstring> Defines;
+    Defines.reserve(Dimensions.size());
+    for (uint32_t Index = 0u; Index < Dimensions.size(); ++Index)
+    {
+        Defines.push_back(std::format(L"{}={}", Dimensions[Index].Name, GetValue(Key, Index)));
+    }
+    return Defines;
+}
@@ -0,0 +1,367 @@
+#include "Graphics/TLSFAllocator.h"
+
+#include <bit>
+
+FTLSFAllocator::FTLSFAllocator(uint32_t InCapacity)
+{
+    for (std::array<uint32_t, SL_COUNT>& FreeList : FreeLists)
+    {
+        FreeList.fill(INVALID_NODE);
+    }
+
+    Grow(InCapacity);
+}
+
+void FTLSFAllocator::MapInsert(uint32_t Size, uint32_t& Fl, uint32_t& Sl)
+{
+    if (Size < SL_COUNT)
+    {
+        // Small sizes get one class each.
+        Fl = 0u;
+        Sl = Size;
+        return;
+    }
+
+    const uint32_t Log2 = static_cast<uint32_t>(std::bit_width(Size)) - 1u;
+    Sl = (Size >> (Log2 - SL_LOG2)) - SL_COUNT;
+    Fl = Log2 - SL_LOG2 + 1u;
+}
+
+void FTLSFAllocator::MapSearch(uint32_t Size, uint32_t& Fl, uint32_t& Sl)
+{
+    uint64_t RoundedSize = Size;
+    if (Size >= SL_COUNT)
+    {
+        // Round up to the next class boundary, so any block of the class found is large enough.
+        const uint32_t Log2 = static_cast<uint32_t>(std::bit_width(Size)) - 1u;
+        RoundedSize += (1ull << (Log2 - SL_LOG2)) - 1u;
+    }
+
+    if (RoundedSize > UINT32_MAX)
+    {
+        Fl = FL_COUNT;
+        Sl = 0u;
+        return;
+    }
+
+    MapInsert(static_cast<uint32_t>(RoundedSize), Fl, Sl);
+}
+
+std::optional<FTLSFAllocator::FAllocation> FTLSFAllocator::Allocate(uint32_t Size)
+{
+    assert(Size > 0u);
+
+    const uint32_t Node = FindFreeBlock(Size);
+    if (Node == INVALID_NODE)
+    {
+        return std::nullopt;
+    }
+    RemoveFreeBlock(Node);
+
+    if (Nodes[Node].Size > Size)
+    {
+        // Hand the tail back as a free block of its own.
+        const uint32_t Remainder = CreateNode(Nodes[Node].Offset + Size, Nodes[Node].Size - Size);
+        Nodes[Node].Size = Size;
+        LinkPhysical(Node, Remainder);
+        InsertFreeBlock(Remainder);
+    }
+
+    UsedSize += Size;
+    NumAllocations++;
+    return FAllocation{ .Node = Node, .Offset = Nodes[Node].Offset, .Size = Size };
+}
+
+uint32_t FTLSFAllocator::FindFreeBlock(uint32_t Size) const
+{
+    uint32_t Fl, Sl;
+    MapSearch(Size, Fl, Sl);
+    if (Fl < FL_COUNT)
+    {
+        uint32_t SlMap = SlBitmaps[Fl] & (~0u << Sl);
+        if (SlMap == 0u)
+        {
+            const uint32_t FlMap = Fl + 1u < FL_COUNT ? FlBitmap & (~0u << (Fl + 1u)) : 0u;
+            if (FlMap != 0u)
+            {
+                Fl = static_cast<uint32_t>(std::countr_zero(FlMap));
+                SlMap = SlBitmaps[Fl];
+            }
+        }
+
+        if (SlMap != 0u)
+        {
+            return FreeLists[Fl][static_cast<uint32_t>(std::countr_zero(SlMap))];
+        }
+    }
+
+    // Nothing in the classes above, blocks of Size's own class may still fit. Scanning it is what lets the
+    // last free block be handed out whole once the pool is nearly full.
+    MapInsert(Size, Fl, Sl);
+    for (uint32_t Node = FreeLists[Fl][Sl]; Node != INVALID_NODE; Node = Nodes[Node].NextFree)
+    {
+        if (Nodes[Node].Size >= Size)
+        {
+            return Node;
+        }
+    }
+    return INVALID_NODE;
+}
+
+void FTLSFAllocator::Free(uint32_t Node)
+{
+    assert(Node < Nodes.size() && !Nodes[Node].bFree);
+
+    UsedSize -= Nodes[Node].Size;
+    NumAllocations--;
+
+    const uint32_t Prev = Nodes[Node].PrevPhysical;
+    if (Prev != INVALID_NODE && Nodes[Prev].bFree)
+    {
+        RemoveFreeBlock(Prev);
+        Nodes[Prev].Size += Nodes[Node].Size;
+        UnlinkPhysical(Node);
+        ReleaseNode(Node);
+        Node = Prev;
+    }
+
+    const uint32_t Next = Nodes[Node].NextPhysical;
+    if (Next != INVALID_NODE && Nodes[Next].bFree)
+    {
+        RemoveFreeBlock(Next);
+        Nodes[Node].Size += Nodes[Next].Size;
+        UnlinkPhysical(Next);
+        ReleaseNode(Next);
+    }
+
+    InsertFreeBlock(Node);
+}
+
+void FTLSFAllocator::Grow(uint32_t NewCapacity)
+{
+    assert(NewCapacity >= Capacity);
+    if (NewCapacity == Capacity)
+    {
+        return;
+    }
+
+    const uint32_t Extra = NewCapacity - Capacity;
+    if (LastNode != INVALID_NODE && Nodes[LastNode].bFree)
+    {
+        RemoveFreeBlock(LastNode);
+        Nodes[LastNode].Size += Extra;
+        InsertFreeBlock(LastNode);
+    }
+    else
+    {
+        const uint32_t Node = CreateNode(Capacity, Extra);
+        LinkPhysical(LastNode, Node);
+        InsertFreeBlock(Node);
+    }
+
+    Capacity = NewCapacity;
+}
+
+std::vector<FTLSFAllocator::FMove> FTLSFAllocator::Compact()
+{
+    std::vector<FMove> Moves;
+
+    FlBitmap = 0u;
+    SlBitmaps.fill(0u);
+    for (std::array<uint32_t, SL_COUNT>& FreeList : FreeLists)
+    {
+        FreeList.fill(INVALID_NODE);
+    }
+
+    // Rebuild the physical list out of the live allocations only, slid down to the front.
+    uint32_t Cursor = 0u;
+    uint32_t PrevUsed = INVALID_NODE;
+    uint32_t Node = FirstNode;
+    FirstNode = INVALID_NODE;
+    LastNode = INVALID_NODE;
+    while (Node != INVALID_NODE)
+    {
+        const uint32_t Next = Nodes[Node].NextPhysical;
+        if (Nodes[Node].bFree)
+        {
+            ReleaseNode(Node);
+        }
+        else
+        {
+            if (Nodes[Node].Offset != Cursor)
+            {
+                Moves.push_back(FMove{ .Node = Node, .OldOffset = Nodes[Node].Offset, .NewOffset = Cursor, .Size = Nodes[Node].Size });
+                Nodes[Node].Offset = Cursor;
+            }
+            Cursor += Nodes[Node].Size;
+
+            Nodes[Node].NextPhysical = INVALID_NODE;
+            LinkPhysical(PrevUsed, Node);
+            PrevUsed = Node;
+        }
+        Node = Next;
+    }
+
+    if (Cursor < Capacity)
+    {
+        const uint32_t Tail = CreateNode(Cursor, Capacity - Cursor);
+        LinkPhysical(PrevUsed, Tail);
+        InsertFreeBlock(Tail);
+    }
+
+    return Moves;
+}
+
+uint32_t FTLSFAllocator::GetLargestFreeBlock() const
+{
+    if (FlBitmap == 0u)
+    {
+        return 0u;
+    }
+
+    // Blocks of the highest non empty class differ by less than a class step, scan that one list.
+    const uint32_t Fl = 31u - static_cast<uint32_t>(std::countl_zero(FlBitmap));
+    const uint32_t Sl = 31u - static_cast<uint32_t>(std::countl_zero(SlBitmaps[Fl]));
+
+    uint32_t Largest = 0u;
+    for (uint32_t Node = FreeLists[Fl][Sl]; Node != INVALID_NODE; Node = Nodes[Node].NextFree)
+    {
+        Largest = max(Largest, Nodes[Node].Size);
+    }
+    return Largest;
+}
+
+float FTLSFAllocator::GetFragmentation() const
+{
+    const uint32_t FreeSize = Capacity - UsedSize;
+    if (FreeSize == 0u)
+    {
+        return 0.f;
+    }
+
+    return 1.f - static_cast<float>(GetLargestFreeBlock()) / static_cast<float>(FreeSize);
+}
+
+uint32_t FTLSFAllocator::CreateNode(uint32_t Offset, uint32_t Size)
+{
+    uint32_t Node = UnusedNodes;
+    if (Node != INVALID_NODE)
+    {
+        UnusedNodes = Nodes[Node].NextFree;
+    }
+    else
+    {
+        Node = static_cast<uint32_t>(Nodes.size());
+        Nodes.emplace_back();
+    }
+
+    Nodes[Node] = FNode{ .Offset = Offset, .Size = Size };
+    return Node;
+}
+
+void FTLSFAllocator::ReleaseNode(uint32_t Node)
+{
+    Nodes[Node] = FNode{ .NextFree = UnusedNodes };
+    UnusedNodes = Node;
+}
+
+void FTLSFAllocator::InsertFreeBlock(uint32_t Node)
+{
+    uint32_t Fl, Sl;
+    MapInsert(Nodes[Node].Size, Fl, Sl);
+
+    const uint32_t Head = FreeLists[Fl][Sl];
+    Nodes[Node].PrevFree = INVALID_NODE;
+    Nodes[Node].NextFree = Head;
+    Nodes[Node].bFree = true;
+    if (Head != INVALID_NODE)
+    {
+        Nodes[Head].PrevFree = Node;
+    }
+
+    FreeLists[Fl][Sl] = Node;
+    SlBitmaps[Fl] |= 1u << Sl;
+    FlBitmap |= 1u << Fl;
+}
+
+void FTLSFAllocator::RemoveFreeBlock(uint32_t Node)
+{
+    uint32_t Fl, Sl;
+    MapInsert(Nodes[Node].Size, Fl, Sl);
+
+    const uint32_t Prev = Nodes[Node].PrevFree;
+    const uint32_t Next = Nodes[Node].NextFree;
+    if (Prev != INVALID_NODE)
+    {
+        Nodes[Prev].NextFree = Next;
+    }
+    else
+    {
+        FreeLists[Fl][Sl] = Next;
+        if (Next == INVALID_NODE)
+        {
+            SlBitmaps[Fl] &= ~(1u << Sl);
+            if (SlBitmaps[Fl] == 0u)
+            {
+                FlBitmap &= ~(1u << Fl);
+            }
+        }
+    }
+    if (Next != INVALID_NODE)
+    {
+        Nodes[Next].PrevFree = Prev;
+    }
+
+    Nodes[Node].PrevFree = INVALID_NODE;
+    Nodes[Node].NextFree = INVALID_NODE;
+    Nodes[Node].bFree = false;
+}
+
+void FTLSFAllocator::LinkPhysical(uint32_t Prev, uint32_t Node)
+{
+    const uint32_t Next = Prev != INVALID_NODE ? Nodes[Prev].NextPhysical : FirstNode;
+    Nodes[Node].PrevPhysical = Prev;
+    Nodes[Node].NextPhysical = Next;
+
+    if (Prev != INVALID_NODE)
+    {
+        Nodes[Prev].NextPhysical = Node;
+    }
+    else
+    {
+        FirstNode = Node;
+    }
+
+    if (Next != INVALID_NODE)
+    {
+        Nodes[Next].PrevPhysical = Node;
+    }
+    else
+    {
+        LastNode = Node;
+    }
+}
+
+void FTLSFAllocator::UnlinkPhysical(uint32_t Node)
+{
+    const uint32_t Prev = Nodes[Node].PrevPhysical;
+    const uint32_t Next = Nodes[Node].NextPhysical;
+
+    if (Prev != INVALID_NODE)
+    {
+        Nodes[Prev].NextPhysical = Next;
+    }
+    else
+    {
+        FirstNode = Next;
+    }
+
+    if (Next != INVALID_NODE)
+    {
+        Nodes[Next].PrevPhysical = Prev;
+    }
+    else
+    {
+        LastNode = Prev;
+    }
+}
@@ -0,0 +1,190 @@
+#include "Graphics/TransientAliasing.h"
+
+namespace
+{
+    uint64_t AlignUp(uint64_t Value, uint64_t Alignment)
+    {
+        return (Value + Alignment - 1u) & ~(Alignment - 1u);
+    }
+
+    bool LifetimesOverlap(const FTransientResourceDesc& A, const FTransientResourceDesc& B)
+    {
+        return A.FirstPass <= B.LastPass && B.FirstPass <= A.LastPass;
+    }
+
+    bool MemoryOverlaps(const FTransientPlacement& A, uint64_t SizeA, const FTransientPlacement& B, uint64_t SizeB)
+    {
+        return A.Heap == B.Heap && A.Offset < B.Offset + SizeB && B.Offset < A.Offset + SizeA;
+    }
+
+    struct FMemoryRange
+    {
+        uint64_t Offset;
+        uint64_t End;
+    };
+
+    // Lowest offset where Resource fits between Busy ranges, which are sorted by offset.
+    uint64_t FindOffset(const FTransientResourceDesc& Resource, std::span<const FMemoryRange> Busy)
+    {
+        uint64_t Candidate = 0u;
+        for (const FMemoryRange& Range : Busy)
+        {
+            if (AlignUp(Candidate, Resource.Alignment) + Resource.Size <= Range.Offset)
+            {
+                break;
+            }
+            Candidate = max(Candidate, Range.End);
+        }
+
+        return AlignUp(Candidate, Resource.Alignment);
+    }
+}
+
+FTransientAliasingPlan PlanTransientAliasing(std::span<const FTransientResourceDesc> Resources, uint64_t MinHeapAlignment)
+{
+    FTransientAliasingPlan Plan;
+    Plan.Placements.resize(Resources.size());
+
+    // Most aligned first keeps padding out of the low offsets, largest first leaves the small resources to fill the
+    // gaps below the large ones, earliest first among equals keeps identically sized targets in lifetime order.
+    std::vector<uint32_t> Order(Resources.size());
+    std::iota(Order.begin(), Order.end(), 0u);
+    std::stable_sort(Order.begin(), Order.end(), [&](uint32_t A, uint32_t B) {
+        if (Resources[A].Alignment != Resources[B].Alignment)
+        {
+            return Resources[A].Alignment > Resources[B].Alignment;
+        }
+        if (Resources[A].Size != Resources[B].Size)
+        {
+            return Resources[A].Size > Resources[B].Size;
+        }
+        return Resources[A].FirstPass < Resources[B].FirstPass;
+    });
+
+    std::vector<std::vector<uint32_t>> HeapResources;
+    std::vector<FMemoryRange> Busy;
+
+    for (const uint32_t Index : Order)
+    {
+        const FTransientResourceDesc& Resource = Resources[Index];
+        assert(Resource.Size > 0u && Resource.FirstPass <= Resource.LastPass);
+        assert(Resource.Alignment > 0u && (Resource.Alignment & (Resource.Alignment - 1u)) == 0u);
+
+        Plan.UnaliasedBytes += AlignUp(Resource.Size, max(Resource.Alignment, MinHeapAlignment));
+
+        uint32_t Heap = 0u;
+        while (Heap < Plan.Heaps.size() && Plan.Heaps[Heap].HeapCategory != Resource.HeapCategory)
+        {
+            Heap++;
+        }
+        if (Heap == Plan.Heaps.size())
+        {
+            Plan.Heaps.push_back(FTransientHeapDesc{ .Alignment = MinHeapAlignment, .HeapCategory = Resource.HeapCategory });
+            HeapResources.emplace_back();
+        }
+
+        Busy.clear();
+        for (const uint32_t Other : HeapResources[Heap])
+        {
+            if (LifetimesOverlap(Resource, Resources[Other]))
+            {
+                Busy.push_back(FMemoryRange{ .Offset = Plan.Placements[Other].Offset, .End = Plan.Placements[Other].Offset + Resources[Other].Size });
+            }
+        }
+        std::sort(Busy.begin(), Busy.end(), [](const FMemoryRange& A, const FMemoryRange& B) { return A.Offset < B.Offset; });
+
+        const uint64_t Offset = FindOffset(Resource, Busy);
+        Plan.Placements[Index] = FTransientPlacement{ .Heap = Heap, .Offset = Offset };
+        HeapResources[Heap].push_back(Index);
+
+        // Offsets are aligned for their resource, a heap aligned for its most demanding resource suits them all.
+        FTransientHeapDesc& HeapDesc = Plan.Heaps[Heap];
+        HeapDesc.Alignment = max(HeapDesc.Alignment, Resource.Alignment);
+        HeapDesc.Size = max(HeapDesc.Size, Offset + Resource.Size);
+    }
+
+    for (uint32_t Heap = 0; Heap < Plan.Heaps.size(); Heap++)
+    {
+        FTransientHeapDesc& HeapDesc = Plan.Heaps[Heap];
+
+        // Padding between mixed alignments can leave the packing larger than the resources side by side, they are
+        // then laid out side by side. Placed in order, most aligned first, every offset stays aligned.
+        uint64_t StackedSize = 0u;
+        for (const uint32_t Index : HeapResources[Heap])
+        {
+            StackedSize += AlignUp(Resources[Index].Size, Resources[Index].Alignment);
+        }
+        if (StackedSize < HeapDesc.Size)
+        {
+            uint64_t Offset = 0u;
+            for (const uint32_t Index : HeapResources[Heap])
+            {
+                Plan.Placements[Index].Offset = Offset;
+                Offset += AlignUp(Resources[Index].Size, Resources[Index].Alignment);
+            }
+            HeapDesc.Size = StackedSize;
+        }
+
+        HeapDesc.Size = AlignUp(HeapDesc.Size, HeapDesc.Alignment);
+        Plan.HeapBytes += HeapDesc.Size;
+    }
+
+    // A resource takes its memory over when its first pass starts, from the resources sharing that memory that
+    // ended before and that nothing took the memory from since. With exactly one of them the barrier names it,
+    // with several, or none because the memory last belonged to the previous frame, it names no resource.
+    std::vector<uint32_t> Previous;
+    std::vector<uint32_t> Owners;
+    for (const std::vector<uint32_t>& InHeap : HeapResources)
+    {
+        for (const uint32_t After : InHeap)
+        {
+            const FTransientResourceDesc& Resource = Resources[After];
+
+            bool bShared = false;
+            Previous.clear();
+            for (const uint32_t Other : InHeap)
+            {
+                if (Other == After || !MemoryOverlaps(Plan.Placements[After], Resource.Size, Plan.Placements[Other], Resources[Other].Size))
+                {
+                    continue;
+                }
+
+                bShared = true;
+                if (Resources[Other].LastPass < Resource.FirstPass)
+                {
+                    Previous.push_back(Other);
+                }
+            }
+
+            if (!bShared)
+            {
+                continue;
+            }
+
+            Owners.clear();
+            for (const uint32_t Candidate : Previous)
+            {
+                const bool bTakenOver = std::any_of(Previous.begin(), Previous.end(), [&](uint32_t Later) {
+                    return Resources[Later].FirstPass > Resources[Candidate].LastPass
+                        && MemoryOverlaps(Plan.Placements[Later], Resources[Later].Size, Plan.Placements[Candidate], Resources[Candidate].Size);
+                });
+                if (!bTakenOver)
+                {
+                    Owners.push_back(Candidate);
+                }
+            }
+
+            Plan.Barriers.push_back(FTransientAliasingBarrier{
+                .Pass = Resource.FirstPass,
+                .ResourceBefore = Owners.size() == 1u ? Owners.front() : INVALID_INDEX_U32,
+                .ResourceAfter = After,
+            });
+        }
+    }
+
+    std::sort(Plan.Barriers.begin(), Plan.Barriers.end(), [](const FTransientAliasingBarrier& A, const FTransientAliasingBarrier& B) {
+        return A.Pass != B.Pass ? A.Pass < B.Pass : A.ResourceAfter < B.ResourceAfter;
+    });
+
+    return Plan;
+}
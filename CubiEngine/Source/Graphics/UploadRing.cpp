@@ -0,0 +1,111 @@
+#include "Graphics/UploadRing.h"
+#include "Graphics/MemoryAllocator.h"
+
+namespace
+{
+    uint64_t AlignUp(uint64_t Value, uint64_t Alignment)
+    {
+        return (Value + Alignment - 1u) & ~(Alignment - 1u);
+    }
+}
+
+FUploadRingAllocator::FUploadRingAllocator(uint64_t InCapacity)
+    : Capacity(InCapacity)
+{
+    assert(Capacity > 0u);
+}
+
+std::optional<uint64_t> FUploadRingAllocator::Allocate(uint64_t Size, uint64_t Alignment)
+{
+    assert((Alignment & (Alignment - 1u)) == 0u);
+
+    if (UsedBytes == 0u)
+    {
+        // Empty, start over at the front so large allocations do not have to wrap.
+        Head = 0u;
+        Tail = 0u;
+    }
+    else if (Head == Tail)
+    {
+        return std::nullopt;
+    }
+
+    uint64_t Offset = AlignUp(Head, Alignment);
+    uint64_t NumBytes = 0u;
+    if (Head >= Tail)
+    {
+        // Free space is [Head, Capacity) followed by [0, Tail).
+        if (Offset + Size <= Capacity)
+        {
+            NumBytes = Offset + Size - Head;
+        }
+        else if (Size <= Tail)
+        {
+            NumBytes = Capacity - Head + Size;
+            Offset = 0u;
+        }
+        else
+        {
+            return std::nullopt;
+        }
+    }
+    else if (Offset + Size <= Tail)
+    {
+        NumBytes = Offset + Size - Head;
+    }
+    else
+    {
+        return std::nullopt;
+    }
+
+    Head = (Offset + Size) % Capacity;
+    UsedBytes += NumBytes;
+    OpenBatchBytes += NumBytes;
+    return Offset;
+}
+
+void FUploadRingAllocator::CloseBatch(uint64_t FenceValue)
+{
+    if (OpenBatchBytes == 0u)
+    {
+        return;
+    }
+
+    assert(Batches.empty() || Batches.back().FenceValue <= FenceValue);
+    Batches.push_back(FBatch{ .FenceValue = FenceValue, .End = Head, .NumBytes = OpenBatchBytes });
+    OpenBatchBytes = 0u;
+}
+
+void FUploadRingAllocator::Retire(uint64_t CompletedFenceValue)
+{
+    while (!Batches.empty() && Batches.front().FenceValue <= CompletedFenceValue)
+    {
+        Tail = Batches.front().End;
+        UsedBytes -= Batches.front().NumBytes;
+        Batches.pop_front();
+    }
+}
+
+FUploadRing::FUploadRing(FMemoryAllocator& MemoryAllocator, uint64_t Capacity)
+    : Allocator(Capacity)
+{
+    const FBufferCreationDesc UploadBufferCreationDesc = {
+        .Usage = EBufferUsage::UploadBuffer,
+        .Name = L"Upload Ring Buffer",
+    };
+
+    Allocation = MemoryAllocator.CreateBufferResourceAllocation(UploadBufferCreationDesc,
+        FResourceCreationDesc::CreateBufferResourceCreationDesc(Capacity));
+    MappedData = static_cast<uint8_t*>(Allocation.MappedPointer.value());
+}
+
+std::optional<FUploadRegion> FUploadRing::Allocate(uint64_t Size, uint64_t Alignment)
+{
+    const std::optional<uint64_t> Offset = Allocator.Allocate(Size, Alignment);
+    if (!Offset)
+    {
+        return std::nullopt;
+    }
+
+    return FUploadRegion{ .Resource = Allocation.Resource.Get(), .Offset = *Offset, .CpuAddress = MappedData + *Offset };
+}
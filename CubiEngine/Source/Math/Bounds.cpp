@@ -0,0 +1,47 @@
+#include "Math/Bounds.h"
+
+void FAABB::Expand(const XMFLOAT3& Point)
+{
+    Min = { min(Min.x, Point.x), min(Min.y, Point.y), min(Min.z, Point.z) };
+    Max = { max(Max.x, Point.x), max(Max.y, Point.y), max(Max.z, Point.z) };
+}
+
+void FAABB::Expand(const FAABB& Other)
+{
+    if (Other.IsValid())
+    {
+        Expand(Other.Min);
+        Expand(Other.Max);
+    }
+}
+
+FAABB FAABB::Transform(const XMMATRIX& Matrix) const
+{
+    FAABB Result{};
+    if (!IsValid())
+    {
+        return Result;
+    }
+
+    for (uint32_t Corner = 0; Corner < 8; Corner++)
+    {
+        const XMVECTOR Point = XMVectorSet(
+            (Corner & 1) ? Max.x : Min.x,
+            (Corner & 2) ? Max.y : Min.y,
+            (Corner & 4) ? Max.z : Min.z,
+            1.f);
+
+        XMFLOAT3 TransformedPoint;
+        Dx::XMStoreFloat3(&TransformedPoint, XMVector3TransformCoord(Point, Matrix));
+        Result.Expand(TransformedPoint);
+    }
+
+    return Result;
+}
+
+bool FAABB::Intersects(const FAABB& Other) const
+{
+    return Min.x <= Other.Max.x && Max.x >= Other.Min.x
+        && Min.y <= Other.Max.y && Max.y >= Other.Min.y
+        && Min.z <= Other.Max.z && Max.z >= Other.Min.z;
+}
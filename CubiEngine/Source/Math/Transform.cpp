@@ -11,19 +11,30 @@ void FTransform::Set(const XMFLOAT3& InRotation, const XMFLOAT3& InScale, const
         Dx::XMMatrixTranslationFromVector(translationVector);
 
     TransformMatrix = modelMatrix;
-	InverseTransformMatrix = Dx::XMMatrixInverse(nullptr, modelMatrix);
+	bInverseDirty = true;
 }
 
 void FTransform::SetMatrix(const XMMATRIX& InMatrix)
 {
     TransformMatrix = InMatrix;
-    InverseTransformMatrix = Dx::XMMatrixInverse(nullptr, TransformMatrix);
+    bInverseDirty = true;
 }
 
 FTransform FTransform::Multiply(const FTransform& Other) const
 {
     FTransform Transform{};
     Transform.TransformMatrix = Dx::XMMatrixMultiply(TransformMatrix, Other.TransformMatrix);
-    Transform.InverseTransformMatrix = Dx::XMMatrixInverse(nullptr, Transform.TransformMatrix);
+    Transform.bInverseDirty = true;
     return Transform;
 }
+
+XMMATRIX FTransform::GetInverseModelMatrix() const
+{
+    if (bInverseDirty)
+    {
+        InverseTransformMatrix = Dx::XMMatrixInverse(nullptr, TransformMatrix);
+        bInverseDirty = false;
+    }
+
+    return InverseTransformMatrix;
+}
@@ -75,7 +75,7 @@ FCubeMap::FCubeMap(const FCubeMapCreationDesc& Desc)
         ComputeContext->Dispatch(numGroups, numGroups, 6u);
     }
    
-    RHIExecuteAndFlushComputeContext(std::move(ComputeContext));
+    RHIExecuteComputeContext(std::move(ComputeContext));
 
     GeneratePrefilteredCubemap(Desc, MipCount);
     GenerateBRDFLut(Desc);
@@ -134,7 +134,7 @@ void FCubeMap::GeneratePrefilteredCubemap(const FCubeMapCreationDesc& Desc, uint
     ComputeContext->AddResourceBarrier(PrefilteredCubemapTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
     ComputeContext->ExecuteResourceBarriers();
 
-    RHIExecuteAndFlushComputeContext(std::move(ComputeContext));
+    RHIExecuteComputeContext(std::move(ComputeContext));
 }
 
 void FCubeMap::GenerateBRDFLut(const FCubeMapCreationDesc& Desc)
@@ -177,7 +177,7 @@ void FCubeMap::GenerateBRDFLut(const FCubeMapCreationDesc& Desc)
     ComputeContext->AddResourceBarrier(BRDFLutTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
     ComputeContext->ExecuteResourceBarriers();
 
-    RHIExecuteAndFlushComputeContext(std::move(ComputeContext));
+    RHIExecuteComputeContext(std::move(ComputeContext));
 }
 
 void FCubeMap::GenerateIrradianceMap(const FCubeMapCreationDesc& Desc)
@@ -222,7 +222,7 @@ void FCubeMap::GenerateIrradianceMap(const FCubeMapCreationDesc& Desc)
     ComputeContext->AddResourceBarrier(IrradianceCubemapTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
     ComputeContext->ExecuteResourceBarriers();
 
-    RHIExecuteAndFlushComputeContext(std::move(ComputeContext));
+    RHIExecuteComputeContext(std::move(ComputeContext));
 }
 
 void FCubeMap::Render(FGraphicsContext* const GraphicsContext,
@@ -28,6 +28,15 @@ FDeferredGPass::FDeferredGPass(uint32_t Width, uint32_t Height)
     };
     
     GeometryPassPipelineState = RHICreatePipelineState(Desc);
+
+    Desc.ShaderModule =
+        {
+            .vertexShaderPath = L"Shaders/RenderPass/DeferredGPassIndirect.hlsl",
+            .pixelShaderPath = L"Shaders/RenderPass/DeferredGPassIndirect.hlsl",
+        };
+    Desc.PipelineName = L"Deferred GPass Indirect Pipeline";
+
+    GeometryPassIndirectPipelineState = RHICreatePipelineState(Desc);
     
     FGraphicsPipelineStateCreationDesc GeometryPassLightPipelineDesc{
         .ShaderModule =
@@ -56,7 +65,14 @@ FDeferredGPass::FDeferredGPass(uint32_t Width, uint32_t Height)
         .PipelineName = L"LightPass Pipeline"
     };
 
-    LightPassPipelineState = RHICreatePipelineState(LightPassPipelineDesc);
+    // Dimensions in the order RenderLightPass builds the key.
+    FShaderPermutationDomain LightPassDomain;
+    LightPassDomain.AddEnum(L"SHADOW_METHOD", 3u);
+    LightPassDomain.AddBool(L"USE_SSAO");
+    LightPassDomain.AddEnum(L"DIFFUSE_METHOD", 2u);
+
+    LightPassPipelineStates = FPipelineStatePermutations(LightPassPipelineDesc, std::move(LightPassDomain));
+    LightPassPipelineStates.PrecompileAll();
 }
 
 void FDeferredGPass::InitSizeDependantResource(uint32_t InWidth, uint32_t InHeight)
@@ -68,14 +84,16 @@ void FDeferredGPass::Render(FScene* const Scene, FGraphicsContext* const Graphic
     {
         SCOPED_NAMED_EVENT(GraphicsContext, DeferredGPassModel);
 
-        GraphicsContext->SetGraphicsPipelineState(GeometryPassPipelineState);
+        const bool bUseIndirectDraw = Scene->GetRenderSettings().bUseIndirectDraw;
+
+        GraphicsContext->SetGraphicsPipelineState(bUseIndirectDraw ? GeometryPassIndirectPipelineState : GeometryPassPipelineState);
         std::array<const FTexture*, 4> Textures = {
-            SceneTexture.GBufferA.get(),
-            SceneTexture.GBufferB.get(),
-            SceneTexture.GBufferC.get(),
-            SceneTexture.VelocityTexture.get(),
+            SceneTexture.GBufferA,
+            SceneTexture.GBufferB,
+            SceneTexture.GBufferC,
+            SceneTexture.VelocityTexture,
         };
-        GraphicsContext->SetRenderTargets(Textures, SceneTexture.DepthTexture.get());
+        GraphicsContext->SetRenderTargets(Textures, SceneTexture.DepthTexture);
         GraphicsContext->SetViewport(D3D12_VIEWPORT{
             .TopLeftX = 0.0f,
             .TopLeftY = 0.0f,
@@ -88,14 +106,23 @@ void FDeferredGPass::Render(FScene* const Scene, FGraphicsContext* const Graphic
         GraphicsContext->SetPrimitiveTopologyLayout(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
         
         // No need to clear GBuffer
-        GraphicsContext->ClearRenderTargetView(SceneTexture.GBufferA.get(), std::array<float, 4u>{0.0f, 0.0f, 0.0f, 1.0f});
-        GraphicsContext->ClearRenderTargetView(SceneTexture.GBufferB.get(), std::array<float, 4u>{0.0f, 0.0f, 0.0f, 1.0f});
-        GraphicsContext->ClearRenderTargetView(SceneTexture.GBufferC.get(), std::array<float, 4u>{0.0f, 0.0f, 0.0f, 1.0f});
-        GraphicsContext->ClearRenderTargetView(SceneTexture.HDRTexture.get(), std::array<float, 4u>{0.0f, 0.0f, 0.0f, 1.0f});
-
-        interlop::DeferredGPassRenderResources RenderResources{};
-
-        Scene->RenderModels(GraphicsContext, RenderResources);
+        GraphicsContext->ClearRenderTargetView(SceneTexture.GBufferA, std::array<float, 4u>{0.0f, 0.0f, 0.0f, 1.0f});
+        GraphicsContext->ClearRenderTargetView(SceneTexture.GBufferB, std::array<float, 4u>{0.0f, 0.0f, 0.0f, 1.0f});
+        GraphicsContext->ClearRenderTargetView(SceneTexture.GBufferC, std::array<float, 4u>{0.0f, 0.0f, 0.0f, 1.0f});
+        GraphicsContext->ClearRenderTargetView(SceneTexture.HDRTexture, std::array<float, 4u>{0.0f, 0.0f, 0.0f, 1.0f});
+
+        if (bUseIndirectDraw)
+        {
+            interlop::DeferredGPassIndirectRenderResources RenderResources{};
+
+            Scene->RenderModels(GraphicsContext, RenderResources);
+        }
+        else
+        {
+            interlop::DeferredGPassRenderResources RenderResources{};
+
+            Scene->RenderModels(GraphicsContext, RenderResources);
+        }
     }
 
     {
@@ -133,36 +160,33 @@ void FDeferredGPass::RenderLightPass(FScene* const Scene, FGraphicsContext* cons
         .vsmMomentTextureIndex = Scene->GetRenderSettings().bUseVSM ? ShadowDepthPass->GetMomentTexture()->SrvIndex : INVALID_INDEX_U32,
         .ssaoTextureIndex = SSAOTexture ? SSAOTexture->SrvIndex : INVALID_INDEX_U32,
         .outputTextureIndex = SceneTexture.HDRTexture->UavIndex,
-        .sceneBufferIndex = Scene->GetSceneBuffer().CbvIndex,
-        .lightBufferIndex = Scene->GetLightBuffer().CbvIndex,
-        .shadowBufferIndex = Scene->GetShadowBuffer().CbvIndex,
-        .debugBufferIndex = Scene->GetDebugBuffer().CbvIndex,
+        .sceneBufferIndex = Scene->GetSceneBufferCbv(),
+        .lightBufferIndex = Scene->GetLightBufferCbv(),
+        .shadowBufferIndex = Scene->GetShadowBufferCbv(),
+        .debugBufferIndex = Scene->GetDebugBufferCbv(),
         .EnvmapIntensity = Scene->GetRenderSettings().EnvmapIntensity,
         .bUseEnergyCompensation = Scene->GetRenderSettings().bUseEnergyCompensation ? 1u : 0u,
         .WhiteFurnaceMethod = uint(Scene->GetRenderSettings().WhiteFurnaceMethod),
         .bCSMDebug = Scene->GetRenderSettings().bCSMDebug ? 1u : 0u,
-        .diffuseMethod = uint(Scene->GetRenderSettings().DiffuseMethod),
         .sampleBias = GFrameCount,
     };
 
-    // Resource Barrier
-    GraphicsContext->AddResourceBarrier(SceneTexture.GBufferA.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(SceneTexture.GBufferB.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(SceneTexture.GBufferC.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(SceneTexture.VelocityTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(ShadowDepthPass->GetShadowDepthTexture(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(SceneTexture.HDRTexture.get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-    if (SSAOTexture)
+    const FSceneRenderSettings& Settings = Scene->GetRenderSettings();
+    // The shadow and SSAO inputs can be missing while their passes are skipped, the variant follows what was bound.
+    EShadowMethod ShadowMethod = static_cast<EShadowMethod>(Settings.ShadowMethod);
+    if (ShadowMethod == EShadowMethod::Raytracing && !RaytracingShadowTexture)
     {
-        GraphicsContext->AddResourceBarrier(SSAOTexture, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+        ShadowMethod = EShadowMethod::None;
     }
-    if (Scene->GetRenderSettings().bUseVSM)
-    {
-        GraphicsContext->AddResourceBarrier(ShadowDepthPass->GetMomentTexture(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    }
-    GraphicsContext->ExecuteResourceBarriers();
+    const int32_t PermutationValues[] = {
+        static_cast<int32_t>(ShadowMethod),
+        SSAOTexture != nullptr,
+        Settings.DiffuseMethod,
+    };
+    const uint32_t PermutationKey = LightPassPipelineStates.GetDomain().GetKey(PermutationValues);
 
-    GraphicsContext->SetComputePipelineState(LightPassPipelineState);
+    // The render graph moved every texture above to the state the pass declared.
+    GraphicsContext->SetComputePipelineState(LightPassPipelineStates.Get(PermutationKey));
     GraphicsContext->SetComputeRoot32BitConstants(&RenderResources);
 
     // shader (8,8,1)
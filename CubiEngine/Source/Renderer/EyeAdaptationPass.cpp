@@ -46,13 +46,23 @@ FEyeAdaptationPass::FEyeAdaptationPass(const uint32_t Width, const uint32_t Heig
 
     CalcuateAverageLuminancePipelineState = RHICreatePipelineState(CalculateAverageLuminancePipelineStateDesc);
 
-    EyeAdaptationTonemappingPipelineState = RHICreatePipelineState(FComputePipelineStateCreationDesc{
+    // Dimensions in the order ToneMapping builds the key.
+    FShaderPermutationDomain TonemappingDomain;
+    TonemappingDomain.AddEnum(L"TONEMAPPING_METHOD", 4u);
+    TonemappingDomain.AddBool(L"GAMMA_CORRECTION");
+    TonemappingDomain.AddBool(L"USE_BLOOM");
+    TonemappingDomain.AddBool(L"USE_EYE_ADAPTATION");
+
+    EyeAdaptationTonemappingPipelineStates = FPipelineStatePermutations(FComputePipelineStateCreationDesc{
         .ShaderModule
         {
             .computeShaderPath = L"Shaders/EyeAdaptation/Tonemapping.hlsl",
         },
         .PipelineName = L"EyeAdaptation Tonemapping Pipeline",
-    });
+    }, std::move(TonemappingDomain));
+
+    // All compile in the background, toggling a setting in the editor never waits on the compiler.
+    EyeAdaptationTonemappingPipelineStates.PrecompileAll();
 }
 
 void FEyeAdaptationPass::InitSizeDependantResource(uint32_t InWidth, uint32_t InHeight)
@@ -129,12 +139,19 @@ void FEyeAdaptationPass::ToneMapping(FGraphicsContext* GraphicsContext, FScene*
         .bloomTextureIndex = BloomTexture ? BloomTexture->SrvIndex : INVALID_INDEX_U32,
         .width = LDRTexture->Width,
         .height = LDRTexture->Height,
-        .toneMappingMethod = (uint)Scene->GetRenderSettings().ToneMappingMethod,
-        .bGammaCorrection = Scene->GetRenderSettings().bGammaCorrection,
         .averageLuminanceBufferIndex = Scene->GetRenderSettings().bUseEyeAdaptation ? AverageLuminanceBuffer.SrvIndex : INVALID_INDEX_U32,
     };
 
-    GraphicsContext->SetComputePipelineState(EyeAdaptationTonemappingPipelineState);
+    const FSceneRenderSettings& Settings = Scene->GetRenderSettings();
+    const int32_t PermutationValues[] = {
+        Settings.ToneMappingMethod,
+        Settings.bGammaCorrection,
+        BloomTexture != nullptr,
+        Settings.bUseEyeAdaptation,
+    };
+    const uint32_t PermutationKey = EyeAdaptationTonemappingPipelineStates.GetDomain().GetKey(PermutationValues);
+
+    GraphicsContext->SetComputePipelineState(EyeAdaptationTonemappingPipelineStates.Get(PermutationKey));
     GraphicsContext->SetComputeRoot32BitConstants(&RenderResources);
 
     // shader (8,8,1)
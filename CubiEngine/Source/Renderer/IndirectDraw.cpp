@@ -0,0 +1,112 @@
+#include "Renderer/IndirectDraw.h"
+#include "Graphics/D3D12DynamicRHI.h"
+#include "Graphics/GraphicsContext.h"
+
+static_assert(offsetof(FIndirectDrawArguments, InstanceIndex) == sizeof(D3D12_INDEX_BUFFER_VIEW),
+    "Indirect arguments must be tightly packed in command signature order.");
+static_assert(offsetof(FIndirectDrawArguments, DrawIndexedArguments) == sizeof(D3D12_INDEX_BUFFER_VIEW) + sizeof(uint32_t),
+    "Indirect arguments must be tightly packed in command signature order.");
+
+std::array<D3D12_INDIRECT_ARGUMENT_DESC, FIndirectDrawArgumentBuilder::NUM_COMMAND_SIGNATURE_ARGUMENTS> FIndirectDrawArgumentBuilder::GetCommandSignatureArguments()
+{
+    std::array<D3D12_INDIRECT_ARGUMENT_DESC, NUM_COMMAND_SIGNATURE_ARGUMENTS> ArgumentDescs{};
+
+    ArgumentDescs[0].Type = D3D12_INDIRECT_ARGUMENT_TYPE_INDEX_BUFFER_VIEW;
+
+    // instanceIndex is the first root constant of every indirect render resource struct.
+    ArgumentDescs[1].Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT;
+    ArgumentDescs[1].Constant.RootParameterIndex = 0u;
+    ArgumentDescs[1].Constant.DestOffsetIn32BitValues = 0u;
+    ArgumentDescs[1].Constant.Num32BitValuesToSet = 1u;
+
+    ArgumentDescs[2].Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED;
+
+    return ArgumentDescs;
+}
+
+void FIndirectDrawArgumentBuilder::Build(std::span<const FIndirectDrawItem> Items, std::span<const uint32_t> VisibleInstances)
+{
+    Arguments.clear();
+    Arguments.reserve(VisibleInstances.size());
+
+    for (const uint32_t InstanceIndex : VisibleInstances)
+    {
+        assert(InstanceIndex < Items.size());
+
+        const FIndirectDrawItem& Item = Items[InstanceIndex];
+        if (Item.IndexCount == 0u)
+        {
+            continue;
+        }
+
+        Arguments.push_back(FIndirectDrawArguments{
+            .IndexBufferView =
+                {
+                    .BufferLocation = Item.IndexBufferAddress,
+                    .SizeInBytes = Item.IndexBufferSizeInBytes,
+                    .Format = DXGI_FORMAT_R32_UINT,
+                },
+            .InstanceIndex = InstanceIndex,
+            .DrawIndexedArguments =
+                {
+                    .IndexCountPerInstance = Item.IndexCount,
+                    .InstanceCount = 1u,
+                    .StartIndexLocation = Item.FirstIndex,
+                    .BaseVertexLocation = 0,
+                    .StartInstanceLocation = 0u,
+                },
+        });
+    }
+}
+
+void FIndirectDrawBuffer::Upload(const FIndirectDrawArgumentBuilder& Builder)
+{
+    NumDraws = Builder.GetNumDraws();
+    if (NumDraws == 0u)
+    {
+        return;
+    }
+
+    // This frame's buffer was last read FRAMES_IN_FLIGHT frames ago, so it can be rewritten or replaced.
+    FBuffer& ArgumentBuffer = ArgumentBuffers[GFrameCount % FRAMES_IN_FLIGHT];
+    const size_t SizeInBytes = NumDraws * sizeof(FIndirectDrawArguments);
+    if (ArgumentBuffer.SizeInBytes < SizeInBytes)
+    {
+        ArgumentBuffer = RHICreateBuffer(FBufferCreationDesc{
+            .Usage = EBufferUsage::UploadBuffer,
+            .Name = Name,
+        }, SizeInBytes * 2);
+    }
+
+    ArgumentBuffer.Allocation.Update(Builder.GetArguments().data(), SizeInBytes);
+}
+
+void FIndirectDrawBuffer::Execute(FGraphicsContext* const GraphicsContext) const
+{
+    if (NumDraws == 0u)
+    {
+        return;
+    }
+
+    GraphicsContext->ExecuteIndirect(GetCommandSignature(), NumDraws, ArgumentBuffers[GFrameCount % FRAMES_IN_FLIGHT]);
+}
+
+ID3D12CommandSignature* FIndirectDrawBuffer::GetCommandSignature()
+{
+    static ComPtr<ID3D12CommandSignature> CommandSignature;
+    if (!CommandSignature)
+    {
+        const auto ArgumentDescs = FIndirectDrawArgumentBuilder::GetCommandSignatureArguments();
+        const D3D12_COMMAND_SIGNATURE_DESC Desc = {
+            .ByteStride = sizeof(FIndirectDrawArguments),
+            .NumArgumentDescs = static_cast<UINT>(ArgumentDescs.size()),
+            .pArgumentDescs = ArgumentDescs.data(),
+            .NodeMask = 0u,
+        };
+
+        CommandSignature = RHICreateCommandSignature(Desc);
+        CommandSignature->SetName(L"Indirect Draw Command Signature");
+    }
+
+    return CommandSignature.Get();
+}
@@ -85,22 +85,22 @@ void FPathTracingPass::AddPass(FGraphicsContext* GraphicsContext, FScene* Scene)
     GraphicsContext->SetComputeRootShaderResourceView(
         RTParams_SceneDescriptor, Scene->GetRaytracingScene().GetTopLevelASGPUVirtualAddress()); // t0
 
-    bool IsViewProjectChanged = Scene->GetCamera().IsViewProjMatrixChanged();
+    bool IsViewProjectChanged = Scene->GetFrameSnapshot().bViewProjMatrixChanged;
 
     interlop::PathTraceRenderResources RenderResources = {
-        .invViewProjectionMatrix = Scene->GetCamera().GetInvViewProjMatrix(),
+        .invViewProjectionMatrix = Scene->GetFrameSnapshot().InvViewProjectionMatrix,
         .dstTextureIndex = PathTracingSceneTexture->UavIndex,
         .albedoTextureIndex = PathTracingAlbedoTexture->UavIndex,
         .normalTextureIndex = PathTracingNormalTexture->UavIndex,
 		.frameAccumulatedTextureIndex = FrameAccumulatedTexture->UavIndex,
         .geometryInfoBufferIdx = Scene->GetRaytracingScene().GetGeometryInfoBufferSrv(),
         .materialBufferIdx = Scene->GetRaytracingScene().GetMaterialBufferSrv(),
-        .sceneBufferIndex = Scene->GetSceneBuffer().CbvIndex,
-        .lightBufferIndex = Scene->GetLightBuffer().CbvIndex,
+        .sceneBufferIndex = Scene->GetSceneBufferCbv(),
+        .lightBufferIndex = Scene->GetLightBufferCbv(),
         .envmapTextureIndex = Scene->GetEnvironmentMap()->CubeMapTexture->SrvIndex,
 		.envmapIntensity = Scene->GetRenderSettings().EnvmapIntensity,
         .envBRDFTextureIndex = Scene->GetEnvironmentMap()->BRDFLutTexture->SrvIndex,
-        .debugBufferIndex = Scene->GetDebugBuffer().CbvIndex,
+        .debugBufferIndex = Scene->GetDebugBufferCbv(),
         .maxPathDepth = 10,
         .numSamples = (uint32_t)Scene->GetRenderSettings().PathTracingSamplePerPixel,
 		.bRefreshPathTracingTexture = (IsViewProjectChanged || bResetAccumulation) ? 1u : 0u,
@@ -16,7 +16,14 @@ FPostProcess::FPostProcess(uint32_t Width, uint32_t Height)
         },
         .PipelineName = L"Tonemapping Pipeline"
     };
-    TonemappingPipelineState = RHICreatePipelineState(TonemappingPipelineDesc);
+
+    // Dimensions in the order Tonemapping builds the key.
+    FShaderPermutationDomain TonemappingDomain;
+    TonemappingDomain.AddEnum(L"TONEMAPPING_METHOD", 4u);
+    TonemappingDomain.AddBool(L"GAMMA_CORRECTION");
+
+    TonemappingPipelineStates = FPipelineStatePermutations(TonemappingPipelineDesc, std::move(TonemappingDomain));
+    TonemappingPipelineStates.PrecompileAll();
     
     FComputePipelineStateCreationDesc DebugVisualizePipelineDesc = FComputePipelineStateCreationDesc
     {
@@ -58,12 +65,16 @@ void FPostProcess::Tonemapping(FGraphicsContext* const GraphicsContext, FScene*
         .bloomTextureIndex = INVALID_INDEX_U32,
         .width = Width,
         .height = Height,
-        .toneMappingMethod = (uint)Scene->GetRenderSettings().ToneMappingMethod,
-        .bGammaCorrection = Scene->GetRenderSettings().bGammaCorrection,
         .averageLuminanceBufferIndex = INVALID_INDEX_U32,
     };
 
-    GraphicsContext->SetComputePipelineState(TonemappingPipelineState);
+    const int32_t PermutationValues[] = {
+        Scene->GetRenderSettings().ToneMappingMethod,
+        Scene->GetRenderSettings().bGammaCorrection,
+    };
+    const uint32_t PermutationKey = TonemappingPipelineStates.GetDomain().GetKey(PermutationValues);
+
+    GraphicsContext->SetComputePipelineState(TonemappingPipelineStates.Get(PermutationKey));
     GraphicsContext->SetComputeRoot32BitConstants(&RenderResources);
 
     // shader (8,8,1)
@@ -45,12 +45,12 @@ void FRaytracingDebugScenePass::AddPass(FGraphicsContext* GraphicsContext, FScen
         RTParams_SceneDescriptor, Scene->GetRaytracingScene().GetTopLevelASGPUVirtualAddress()); // t0
 
     interlop::RTSceneDebugRenderResource RenderResources = {
-        .invViewProjectionMatrix = Scene->GetCamera().GetInvViewProjMatrix(),
+        .invViewProjectionMatrix = Scene->GetFrameSnapshot().InvViewProjectionMatrix,
         .dstTextureIndex = RaytracingDebugSceneTexture->UavIndex,
         .geometryInfoBufferIdx = Scene->GetRaytracingScene().GetGeometryInfoBufferSrv(),
         .materialBufferIdx = Scene->GetRaytracingScene().GetMaterialBufferSrv(),
-        .sceneBufferIndex = Scene->GetSceneBuffer().CbvIndex,
-        .lightBufferIndex = Scene->GetLightBuffer().CbvIndex,
+        .sceneBufferIndex = Scene->GetSceneBufferCbv(),
+        .lightBufferIndex = Scene->GetLightBufferCbv(),
         .envmapTextureIndex = Scene->GetEnvironmentMap()->CubeMapTexture->SrvIndex,
     };
 
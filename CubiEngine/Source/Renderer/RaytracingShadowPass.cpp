@@ -32,7 +32,7 @@ void FRaytracingShadowPass::InitSizeDependantResource(uint32_t InWidth, uint32_t
 
 void FRaytracingShadowPass::AddPass(FGraphicsContext* GraphicsContext, FScene* Scene, FSceneTexture& SceneTexture)
 {
-    GraphicsContext->AddResourceBarrier(SceneTexture.DepthTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+    GraphicsContext->AddResourceBarrier(SceneTexture.DepthTexture, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
     GraphicsContext->AddResourceBarrier(RaytracingShadowTexture.get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
     GraphicsContext->ExecuteResourceBarriers();
 
@@ -47,11 +47,11 @@ void FRaytracingShadowPass::AddPass(FGraphicsContext* GraphicsContext, FScene* S
         RTParams_SceneDescriptor, Scene->GetRaytracingScene().GetTopLevelASGPUVirtualAddress()); // t0
 
     interlop::RaytracingShadowRenderResource RenderResources = {
-        .invViewProjectionMatrix = Scene->GetCamera().GetInvViewProjMatrix(),
+        .invViewProjectionMatrix = Scene->GetFrameSnapshot().InvViewProjectionMatrix,
         .dstTextureIndex = RaytracingShadowTexture->UavIndex,
         .depthTextureIndex = SceneTexture.DepthTexture->SrvIndex,
-        .sceneBufferIndex = Scene->GetSceneBuffer().CbvIndex,
-        .lightBufferIndex = Scene->GetLightBuffer().CbvIndex
+        .sceneBufferIndex = Scene->GetSceneBufferCbv(),
+        .lightBufferIndex = Scene->GetLightBufferCbv()
     };
 
     GraphicsContext->SetComputeRoot32BitConstants(RTParams_CBuffer, &RenderResources);
@@ -0,0 +1,920 @@
+#include "Renderer/RenderGraph.h"
+#include "Graphics/D3D12DynamicRHI.h"
+#include "Graphics/GraphicsContext.h"
+#include "Graphics/TransientAliasing.h"
+
+namespace
+{
+    // Whether a texture in Current can be used as Requested without a transition.
+    bool IsStateSatisfied(D3D12_RESOURCE_STATES Current, D3D12_RESOURCE_STATES Requested)
+    {
+        if (Current == Requested)
+        {
+            return true;
+        }
+        if (FTexture::IsReadOnlyState(Current) && FTexture::IsReadOnlyState(Requested))
+        {
+            return (Current & Requested) == Requested;
+        }
+        // Depth testing against a depth buffer still bound for writing.
+        return Current == D3D12_RESOURCE_STATE_DEPTH_WRITE && Requested == D3D12_RESOURCE_STATE_DEPTH_READ;
+    }
+
+    // Whether a compute queue can use a texture in State and transition it from or to State.
+    bool IsComputeQueueState(D3D12_RESOURCE_STATES State)
+    {
+        constexpr D3D12_RESOURCE_STATES ComputeQueueStates = D3D12_RESOURCE_STATE_UNORDERED_ACCESS
+            | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE
+            | D3D12_RESOURCE_STATE_COPY_DEST
+            | D3D12_RESOURCE_STATE_COPY_SOURCE
+            | D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT
+            | D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER;
+        return (State & ~ComputeQueueStates) == 0;
+    }
+
+    // Textures that can stand in for each other, names aside.
+    bool IsCompatible(const FTextureCreationDesc& A, const FTextureCreationDesc& B)
+    {
+        return A.Usage == B.Usage
+            && A.Width == B.Width
+            && A.Height == B.Height
+            && A.Format == B.Format
+            && A.MipLevels == B.MipLevels
+            && A.DepthOrArraySize == B.DepthOrArraySize;
+    }
+}
+
+FRGTextureHandle FRenderGraph::CreateTexture(const FTextureCreationDesc& Desc)
+{
+    assert(!bCompiled);
+
+    Textures.push_back(FTextureEntry{ .Desc = Desc });
+    return FRGTextureHandle{ .Index = static_cast<uint32_t>(Textures.size() - 1u) };
+}
+
+FRGTextureHandle FRenderGraph::ImportTexture(FTexture* Texture)
+{
+    assert(!bCompiled && Texture != nullptr);
+
+    const FTextureCreationDesc Desc = {
+        .Usage = Texture->Usage,
+        .Width = Texture->Width,
+        .Height = Texture->Height,
+        .Format = Texture->Format,
+        .InitialState = Texture->ResourceState,
+        .Name = Texture->DebugName,
+    };
+    Textures.push_back(FTextureEntry{ .Desc = Desc, .ImportedTexture = Texture });
+    return FRGTextureHandle{ .Index = static_cast<uint32_t>(Textures.size() - 1u) };
+}
+
+void FRenderGraph::ExportTexture(FRGTextureHandle Texture, std::optional<D3D12_RESOURCE_STATES> FinalState)
+{
+    assert(!bCompiled && Texture.IsValid());
+
+    Textures[Texture.Index].bExported = true;
+    Textures[Texture.Index].FinalState = FinalState;
+}
+
+uint32_t FRenderGraph::AddPass(std::string_view Name, std::vector<FRGTextureAccess> Accesses, FExecuteFunction Execute,
+    uint32_t Flags)
+{
+    assert(!bCompiled);
+
+    for (size_t Index = 0; Index < Accesses.size(); Index++)
+    {
+        assert(Accesses[Index].Texture.IsValid() && Accesses[Index].Texture.Index < Textures.size());
+        for (size_t Other = Index + 1u; Other < Accesses.size(); Other++)
+        {
+            assert(Accesses[Index].Texture != Accesses[Other].Texture);
+        }
+        assert((Flags & RenderGraphPassFlag_AsyncCompute) == 0u || IsComputeQueueState(Accesses[Index].State));
+    }
+
+    Passes.push_back(FPass{
+        .Name = std::string(Name),
+        .Accesses = std::move(Accesses),
+        .Execute = std::move(Execute),
+        .Flags = Flags,
+        .Queue = (Flags & RenderGraphPassFlag_AsyncCompute) != 0u ? ERGQueue::AsyncCompute : ERGQueue::Graphics,
+    });
+    return static_cast<uint32_t>(Passes.size() - 1u);
+}
+
+void FRenderGraph::Compile()
+{
+    Stats = FRenderGraphStats{};
+
+    CullPasses();
+    BuildDependencies();
+    AssignPhysicalTextures();
+    PlanBarriers();
+    PlanQueueWaits();
+
+    Stats.NumPasses = static_cast<uint32_t>(Passes.size());
+    Stats.NumCulledPasses = static_cast<uint32_t>(Passes.size() - ExecutionOrder.size());
+    for (const uint32_t PassIndex : ExecutionOrder)
+    {
+        if (Passes[PassIndex].Queue == ERGQueue::AsyncCompute)
+        {
+            Stats.NumAsyncComputePasses++;
+        }
+    }
+    for (const FTextureEntry& Entry : Textures)
+    {
+        if (!Entry.ImportedTexture && Entry.PhysicalTexture != INVALID_INDEX_U32)
+        {
+            Stats.NumTransientTextures++;
+        }
+    }
+    for (const FPhysicalTexture& PhysicalTexture : PhysicalTextures)
+    {
+        if (!PhysicalTexture.bImported)
+        {
+            Stats.NumPhysicalTextures++;
+        }
+    }
+
+    bCompiled = true;
+}
+
+void FRenderGraph::CullPasses()
+{
+    // Walks back from the exported textures. A write is not assumed to cover the whole texture, so it leaves the
+    // earlier writers needed too.
+    std::vector<bool> Needed(Textures.size());
+    for (size_t Index = 0; Index < Textures.size(); Index++)
+    {
+        Needed[Index] = Textures[Index].bExported;
+    }
+
+    for (size_t PassIndex = Passes.size(); PassIndex-- > 0u;)
+    {
+        FPass& Pass = Passes[PassIndex];
+
+        bool bLive = (Pass.Flags & RenderGraphPassFlag_NeverCull) != 0u;
+        for (const FRGTextureAccess& Access : Pass.Accesses)
+        {
+            bLive |= Access.bWrite && Needed[Access.Texture.Index];
+        }
+
+        Pass.bCulled = !bLive;
+        if (bLive)
+        {
+            for (const FRGTextureAccess& Access : Pass.Accesses)
+            {
+                Needed[Access.Texture.Index] = true;
+            }
+        }
+    }
+
+    ExecutionOrder.clear();
+    for (uint32_t PassIndex = 0; PassIndex < Passes.size(); PassIndex++)
+    {
+        if (!Passes[PassIndex].bCulled)
+        {
+            ExecutionOrder.push_back(PassIndex);
+        }
+    }
+}
+
+void FRenderGraph::BuildDependencies()
+{
+    std::vector<uint32_t> LastWriters(Textures.size(), INVALID_INDEX_U32);
+    std::vector<std::vector<uint32_t>> ReadersSinceWrite(Textures.size());
+
+    for (FPass& Pass : Passes)
+    {
+        Pass.Dependencies.clear();
+    }
+    for (FTextureEntry& Entry : Textures)
+    {
+        Entry.Lifetime = FRGLifetime{};
+    }
+
+    for (uint32_t Position = 0; Position < ExecutionOrder.size(); Position++)
+    {
+        const uint32_t PassIndex = ExecutionOrder[Position];
+        FPass& Pass = Passes[PassIndex];
+
+        for (const FRGTextureAccess& Access : Pass.Accesses)
+        {
+            const uint32_t Texture = Access.Texture.Index;
+
+            if (LastWriters[Texture] != INVALID_INDEX_U32)
+            {
+                Pass.Dependencies.push_back(LastWriters[Texture]);
+            }
+            if (Access.bWrite)
+            {
+                // Readers of the previous contents have to be done before they are overwritten.
+                Pass.Dependencies.insert(Pass.Dependencies.end(), ReadersSinceWrite[Texture].begin(), ReadersSinceWrite[Texture].end());
+                LastWriters[Texture] = PassIndex;
+                ReadersSinceWrite[Texture].clear();
+            }
+            else
+            {
+                ReadersSinceWrite[Texture].push_back(PassIndex);
+            }
+
+            FRGLifetime& Lifetime = Textures[Texture].Lifetime;
+            if (Lifetime.FirstPass == INVALID_INDEX_U32)
+            {
+                Lifetime.FirstPass = Position;
+            }
+            Lifetime.LastPass = Position;
+        }
+
+        std::erase(Pass.Dependencies, PassIndex);
+        std::sort(Pass.Dependencies.begin(), Pass.Dependencies.end());
+        Pass.Dependencies.erase(std::unique(Pass.Dependencies.begin(), Pass.Dependencies.end()), Pass.Dependencies.end());
+    }
+
+    // Exported textures are read after the graph.
+    for (FTextureEntry& Entry : Textures)
+    {
+        if (Entry.bExported && Entry.Lifetime.FirstPass != INVALID_INDEX_U32)
+        {
+            Entry.Lifetime.LastPass = static_cast<uint32_t>(ExecutionOrder.size() - 1u);
+        }
+    }
+}
+
+void FRenderGraph::AssignPhysicalTextures()
+{
+    PhysicalTextures.clear();
+
+    std::vector<uint32_t> TransientTextures;
+    for (uint32_t Index = 0; Index < Textures.size(); Index++)
+    {
+        FTextureEntry& Entry = Textures[Index];
+        Entry.PhysicalTexture = INVALID_INDEX_U32;
+
+        if (Entry.ImportedTexture)
+        {
+            Entry.PhysicalTexture = static_cast<uint32_t>(PhysicalTextures.size());
+            PhysicalTextures.push_back(FPhysicalTexture{
+                .Textures = { Index },
+                .bImported = true,
+                .InitialState = Entry.Desc.InitialState,
+                .Texture = Entry.ImportedTexture,
+            });
+        }
+        else if (Entry.Lifetime.FirstPass != INVALID_INDEX_U32)
+        {
+            TransientTextures.push_back(Index);
+        }
+    }
+
+    // Greedy interval colouring : by first use, each texture takes the first compatible physical texture whose
+    // last user already ran.
+    std::stable_sort(TransientTextures.begin(), TransientTextures.end(), [this](uint32_t A, uint32_t B) {
+        return Textures[A].Lifetime.FirstPass < Textures[B].Lifetime.FirstPass;
+    });
+
+    for (const uint32_t Index : TransientTextures)
+    {
+        FTextureEntry& Entry = Textures[Index];
+
+        for (uint32_t Physical = 0; Physical < PhysicalTextures.size(); Physical++)
+        {
+            FPhysicalTexture& PhysicalTexture = PhysicalTextures[Physical];
+            if (PhysicalTexture.bImported)
+            {
+                continue;
+            }
+
+            const FTextureEntry& Previous = Textures[PhysicalTexture.Textures.back()];
+            if (Previous.Lifetime.LastPass < Entry.Lifetime.FirstPass && IsCompatible(Previous.Desc, Entry.Desc))
+            {
+                Entry.PhysicalTexture = Physical;
+                PhysicalTexture.Textures.push_back(Index);
+                break;
+            }
+        }
+
+        if (Entry.PhysicalTexture == INVALID_INDEX_U32)
+        {
+            Entry.PhysicalTexture = static_cast<uint32_t>(PhysicalTextures.size());
+            PhysicalTextures.push_back(FPhysicalTexture{
+                .Textures = { Index },
+                .InitialState = Entry.Desc.InitialState,
+            });
+        }
+    }
+}
+
+void FRenderGraph::PlanBarriers()
+{
+    struct FUse
+    {
+        uint32_t Pass;
+        FRGTextureAccess Access;
+    };
+
+    std::vector<std::vector<FUse>> Uses(PhysicalTextures.size());
+    for (const uint32_t PassIndex : ExecutionOrder)
+    {
+        FPass& Pass = Passes[PassIndex];
+        Pass.Barriers.clear();
+        Pass.PostBarriers.clear();
+        Pass.StateDependencies.clear();
+        for (const FRGTextureAccess& Access : Pass.Accesses)
+        {
+            Uses[Textures[Access.Texture.Index].PhysicalTexture].push_back(FUse{ .Pass = PassIndex, .Access = Access });
+        }
+    }
+    PrologueBarriers.clear();
+
+    auto IsAsyncCompute = [this](uint32_t PassIndex) { return Passes[PassIndex].Queue == ERGQueue::AsyncCompute; };
+
+    std::vector<D3D12_RESOURCE_STATES> FinalStates(PhysicalTextures.size());
+    for (uint32_t Physical = 0; Physical < PhysicalTextures.size(); Physical++)
+    {
+        D3D12_RESOURCE_STATES State = PhysicalTextures[Physical].InitialState;
+        const FRGTextureAccess* PreviousAccess = nullptr;
+        // Pass whose barrier left the texture in State, INVALID_INDEX_U32 while it is in its initial state or in
+        // one the prologue moved it to.
+        uint32_t StatePass = INVALID_INDEX_U32;
+        std::array<uint32_t, static_cast<size_t>(ERGQueue::Count)> LastUsers;
+        LastUsers.fill(INVALID_INDEX_U32);
+
+        for (size_t UseIndex = 0; UseIndex < Uses[Physical].size(); UseIndex++)
+        {
+            const FUse& Use = Uses[Physical][UseIndex];
+            const FRGTextureAccess& Access = Use.Access;
+            FPass& Pass = Passes[Use.Pass];
+            const bool bAsyncCompute = Pass.Queue == ERGQueue::AsyncCompute;
+
+            // The other queues have to be done with the texture before its state or contents change under them.
+            // Transient textures sharing a physical texture have no dependencies between them otherwise.
+            auto WaitForOtherQueues = [&]() {
+                for (const uint32_t LastUser : LastUsers)
+                {
+                    if (LastUser != INVALID_INDEX_U32 && Passes[LastUser].Queue != Pass.Queue)
+                    {
+                        Pass.StateDependencies.push_back(LastUser);
+                    }
+                }
+            };
+
+            auto AddBarrier = [&](const FRGBarrier& Barrier) {
+                if (!bAsyncCompute || IsComputeQueueState(Barrier.StateBefore))
+                {
+                    WaitForOtherQueues();
+                    Pass.Barriers.push_back(Barrier);
+                    StatePass = Use.Pass;
+                }
+                else if (UseIndex > 0u)
+                {
+                    // Only a graphics pass leaves a texture in a state the compute queue does not know, and only
+                    // graphics passes used it since.
+                    const uint32_t Previous = Uses[Physical][UseIndex - 1u].Pass;
+                    assert(Passes[Previous].Queue == ERGQueue::Graphics);
+                    Passes[Previous].PostBarriers.push_back(Barrier);
+                    StatePass = Previous;
+                }
+                else
+                {
+                    PrologueBarriers.push_back(Barrier);
+                    StatePass = INVALID_INDEX_U32;
+                }
+            };
+
+            if (Access.State == D3D12_RESOURCE_STATE_UNORDERED_ACCESS && State == D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+            {
+                // Back to back unordered access only has to wait when one of the two writes.
+                if (PreviousAccess && PreviousAccess->State == D3D12_RESOURCE_STATE_UNORDERED_ACCESS
+                    && (PreviousAccess->bWrite || Access.bWrite))
+                {
+                    AddBarrier(FRGBarrier{
+                        .Texture = Access.Texture,
+                        .Type = ERGBarrierType::UAV,
+                        .StateBefore = State,
+                        .StateAfter = State,
+                    });
+                }
+            }
+            else if (Access.bWrite)
+            {
+                if (State != Access.State)
+                {
+                    AddBarrier(FRGBarrier{ .Texture = Access.Texture, .StateBefore = State, .StateAfter = Access.State });
+                    State = Access.State;
+                }
+            }
+            else if (!IsStateSatisfied(State, Access.State) || (bAsyncCompute && !IsComputeQueueState(State)))
+            {
+                // One transition to a state covering every read up to the next write, the readers after this one
+                // then need none. The compute queue only reads in states it knows, so once a compute pass is among
+                // the readers the others only merge in what keeps it that way.
+                D3D12_RESOURCE_STATES NewState = Access.State;
+                bool bAsyncComputeReaders = bAsyncCompute;
+                if (FTexture::IsReadOnlyState(Access.State))
+                {
+                    for (size_t Next = UseIndex + 1u; Next < Uses[Physical].size(); Next++)
+                    {
+                        const FRGTextureAccess& NextAccess = Uses[Physical][Next].Access;
+                        if (NextAccess.bWrite || !FTexture::IsReadOnlyState(NextAccess.State))
+                        {
+                            break;
+                        }
+
+                        const bool bNextAsyncCompute = IsAsyncCompute(Uses[Physical][Next].Pass);
+                        if ((bAsyncComputeReaders || bNextAsyncCompute) && !IsComputeQueueState(NewState | NextAccess.State))
+                        {
+                            break;
+                        }
+                        bAsyncComputeReaders |= bNextAsyncCompute;
+                        NewState |= NextAccess.State;
+                    }
+                }
+
+                AddBarrier(FRGBarrier{ .Texture = Access.Texture, .StateBefore = State, .StateAfter = NewState });
+                State = NewState;
+            }
+
+            if (Access.bWrite)
+            {
+                WaitForOtherQueues();
+            }
+            // Using the texture in the state another queue's barrier left it in waits for that barrier.
+            if (StatePass != INVALID_INDEX_U32 && Passes[StatePass].Queue != Pass.Queue)
+            {
+                Pass.StateDependencies.push_back(StatePass);
+            }
+
+            LastUsers[static_cast<size_t>(Pass.Queue)] = Use.Pass;
+            PreviousAccess = &Access;
+        }
+
+        FinalStates[Physical] = State;
+    }
+
+    // Same order whatever the physical textures, so a pass's barriers can be compared against a list.
+    auto SortBarriers = [](std::vector<FRGBarrier>& Barriers) {
+        std::ranges::stable_sort(Barriers, {}, [](const FRGBarrier& Barrier) { return Barrier.Texture.Index; });
+    };
+    SortBarriers(PrologueBarriers);
+    for (const uint32_t PassIndex : ExecutionOrder)
+    {
+        FPass& Pass = Passes[PassIndex];
+        SortBarriers(Pass.Barriers);
+        SortBarriers(Pass.PostBarriers);
+
+        std::sort(Pass.StateDependencies.begin(), Pass.StateDependencies.end());
+        Pass.StateDependencies.erase(std::unique(Pass.StateDependencies.begin(), Pass.StateDependencies.end()), Pass.StateDependencies.end());
+    }
+
+    FinalBarriers.clear();
+    for (uint32_t Index = 0; Index < Textures.size(); Index++)
+    {
+        const FTextureEntry& Entry = Textures[Index];
+        if (!Entry.bExported || !Entry.FinalState || Entry.PhysicalTexture == INVALID_INDEX_U32)
+        {
+            continue;
+        }
+
+        D3D12_RESOURCE_STATES& State = FinalStates[Entry.PhysicalTexture];
+        if (!IsStateSatisfied(State, *Entry.FinalState))
+        {
+            FinalBarriers.push_back(FRGBarrier{ .Texture = FRGTextureHandle{ Index }, .StateBefore = State, .StateAfter = *Entry.FinalState });
+            State = *Entry.FinalState;
+        }
+    }
+
+    Stats.NumBarriers = static_cast<uint32_t>(FinalBarriers.size() + PrologueBarriers.size());
+    for (const uint32_t PassIndex : ExecutionOrder)
+    {
+        Stats.NumBarriers += static_cast<uint32_t>(Passes[PassIndex].Barriers.size() + Passes[PassIndex].PostBarriers.size());
+    }
+}
+
+void FRenderGraph::PlanQueueWaits()
+{
+    constexpr size_t NumQueues = static_cast<size_t>(ERGQueue::Count);
+    constexpr size_t Graphics = static_cast<size_t>(ERGQueue::Graphics);
+
+    // The last position of each queue a queue knows to be done, through its own waits and the waits of the queues
+    // it waited for. Before the first pass, the graphics queue's prologue is -1.
+    using FProgress = std::array<int64_t, NumQueues>;
+    constexpr int64_t Nothing = -2;
+    constexpr int64_t Prologue = -1;
+
+    std::vector<uint32_t> Positions(Passes.size(), INVALID_INDEX_U32);
+    for (uint32_t Position = 0; Position < ExecutionOrder.size(); Position++)
+    {
+        Positions[ExecutionOrder[Position]] = Position;
+    }
+
+    FProgress NothingDone;
+    NothingDone.fill(Nothing);
+    FProgress PrologueProgress = NothingDone;
+    PrologueProgress[Graphics] = Prologue;
+
+    std::array<FProgress, NumQueues> Known;
+    Known.fill(NothingDone);
+    Known[Graphics] = PrologueProgress;
+    // What the queue of the pass at a position knew once it ran it.
+    std::vector<FProgress> Signalled(ExecutionOrder.size());
+
+    QueueWaits.clear();
+    auto Wait = [&](size_t Queue, uint32_t Position, size_t SignalQueue, int64_t SignalPosition) {
+        FProgress& Progress = Known[Queue];
+        if (Progress[SignalQueue] >= SignalPosition)
+        {
+            return;
+        }
+
+        QueueWaits.push_back(FRGQueueWait{
+            .Queue = static_cast<ERGQueue>(Queue),
+            .Position = Position,
+            .SignalQueue = static_cast<ERGQueue>(SignalQueue),
+            .SignalPosition = SignalPosition == Prologue ? INVALID_INDEX_U32 : static_cast<uint32_t>(SignalPosition),
+        });
+
+        const FProgress& Other = SignalPosition == Prologue ? PrologueProgress : Signalled[SignalPosition];
+        for (size_t Index = 0; Index < NumQueues; Index++)
+        {
+            Progress[Index] = max(Progress[Index], Other[Index]);
+        }
+    };
+
+    int64_t LastAsyncComputePosition = Nothing;
+    for (uint32_t Position = 0; Position < ExecutionOrder.size(); Position++)
+    {
+        const FPass& Pass = Passes[ExecutionOrder[Position]];
+        const size_t Queue = static_cast<size_t>(Pass.Queue);
+
+        FProgress Required;
+        Required.fill(Nothing);
+        // Compute passes may use what the graphics queue used before the graph, this frame or the last one.
+        if (Queue != Graphics)
+        {
+            Required[Graphics] = Prologue;
+        }
+        for (const std::vector<uint32_t>* Dependencies : { &Pass.Dependencies, &Pass.StateDependencies })
+        {
+            for (const uint32_t Dependency : *Dependencies)
+            {
+                const size_t DependencyQueue = static_cast<size_t>(Passes[Dependency].Queue);
+                Required[DependencyQueue] = max(Required[DependencyQueue], static_cast<int64_t>(Positions[Dependency]));
+            }
+        }
+
+        for (size_t Other = 0; Other < NumQueues; Other++)
+        {
+            if (Other != Queue && Required[Other] != Nothing)
+            {
+                Wait(Queue, Position, Other, Required[Other]);
+            }
+        }
+
+        Known[Queue][Queue] = Position;
+        Signalled[Position] = Known[Queue];
+        if (Pass.Queue == ERGQueue::AsyncCompute)
+        {
+            LastAsyncComputePosition = Position;
+        }
+    }
+
+    // The final barriers and whatever runs after the graph may use anything the compute queue did.
+    if (LastAsyncComputePosition != Nothing)
+    {
+        Wait(Graphics, static_cast<uint32_t>(ExecutionOrder.size()), static_cast<size_t>(ERGQueue::AsyncCompute), LastAsyncComputePosition);
+    }
+
+    Stats.NumQueueWaits = static_cast<uint32_t>(QueueWaits.size());
+}
+
+void FRenderGraph::Realize(FRenderGraphTexturePool& Pool)
+{
+    assert(bCompiled);
+
+    // Positions only order passes within a queue. Textures the compute queue uses keep their memory for the whole
+    // frame, so no aliasing barrier on one queue ever lands on memory the other one is using.
+    std::vector<bool> UsedByAsyncCompute(PhysicalTextures.size());
+    for (const uint32_t PassIndex : ExecutionOrder)
+    {
+        if (Passes[PassIndex].Queue == ERGQueue::AsyncCompute)
+        {
+            for (const FRGTextureAccess& Access : Passes[PassIndex].Accesses)
+            {
+                UsedByAsyncCompute[Textures[Access.Texture.Index].PhysicalTexture] = true;
+            }
+        }
+    }
+
+    // Textures of a physical texture never overlap, the last one by first use is also the last one to end.
+    std::vector<FRGTransientTextureRequest> Requests;
+    std::vector<uint32_t> RequestPhysicalTextures;
+    for (uint32_t Index = 0; Index < PhysicalTextures.size(); Index++)
+    {
+        const FPhysicalTexture& PhysicalTexture = PhysicalTextures[Index];
+        if (!PhysicalTexture.bImported)
+        {
+            Requests.push_back(FRGTransientTextureRequest{
+                .Desc = Textures[PhysicalTexture.Textures.front()].Desc,
+                .FirstPass = UsedByAsyncCompute[Index] ? 0u : Textures[PhysicalTexture.Textures.front()].Lifetime.FirstPass,
+                .LastPass = UsedByAsyncCompute[Index] ? static_cast<uint32_t>(ExecutionOrder.size() - 1u)
+                    : Textures[PhysicalTexture.Textures.back()].Lifetime.LastPass,
+            });
+            RequestPhysicalTextures.push_back(Index);
+        }
+    }
+
+    const FRenderGraphTexturePool::FLayout& Layout = Pool.Acquire(Requests);
+    for (uint32_t Request = 0; Request < Requests.size(); Request++)
+    {
+        PhysicalTextures[RequestPhysicalTextures[Request]].Texture = Layout.Textures[Request];
+    }
+
+    // Pooled textures come in whatever state the last frame left them, the plan starts from there. Textures
+    // taking memory over start from the state they are discarded in instead.
+    for (FPhysicalTexture& PhysicalTexture : PhysicalTextures)
+    {
+        PhysicalTexture.InitialState = PhysicalTexture.Texture->ResourceState;
+    }
+
+    AliasingActivations.clear();
+    for (const FRenderGraphTexturePool::FAliasingBarrier& Barrier : Layout.AliasingBarriers)
+    {
+        FPhysicalTexture& PhysicalTexture = PhysicalTextures[RequestPhysicalTextures[Barrier.After]];
+        const ETextureUsage Usage = PhysicalTexture.Texture->Usage;
+
+        AliasingActivations.push_back(FAliasingActivation{
+            .Position = Barrier.Pass,
+            .PhysicalTexture = RequestPhysicalTextures[Barrier.After],
+            .Before = Barrier.Before,
+            .bDiscard = Usage == ETextureUsage::RenderTarget || Usage == ETextureUsage::DepthStencil,
+        });
+
+        if (AliasingActivations.back().bDiscard)
+        {
+            PhysicalTexture.InitialState = Usage == ETextureUsage::RenderTarget ? D3D12_RESOURCE_STATE_RENDER_TARGET : D3D12_RESOURCE_STATE_DEPTH_WRITE;
+        }
+    }
+
+    PlanBarriers();
+    PlanQueueWaits();
+}
+
+void FRenderGraph::Execute(FGraphicsContext* GraphicsContext)
+{
+    assert(bCompiled);
+
+    auto IssueBarriers = [&](FGraphicsContext* Context, std::span<const FRGBarrier> Barriers) {
+        for (const FRGBarrier& Barrier : Barriers)
+        {
+            FTexture* Texture = GetTexture(Barrier.Texture);
+            if (Barrier.Type == ERGBarrierType::UAV)
+            {
+                Context->AddUAVBarrier(Texture);
+            }
+            else
+            {
+                // As planned, even into a narrower read state, which is how a texture read more widely on the
+                // graphics queue comes back to the states the compute queue knows.
+                Context->TransitionResource(Texture, Barrier.StateAfter);
+            }
+        }
+        Context->ExecuteResourceBarriers();
+    };
+
+    FCommandQueue* const DirectQueue = RHIGetDirectCommandQueue();
+    FCommandQueue* const ComputeQueue = RHIGetComputeCommandQueue();
+    FGraphicsContext* ComputeContext = nullptr;
+
+    // The frame's graphics context is submitted where a wait or a signal splits the graphics work, then goes on
+    // recording on the same allocator.
+    auto SubmitGraphics = [&](bool bSignal) {
+        DirectQueue->ExecuteContext(GraphicsContext);
+        const uint64_t FenceValue = bSignal ? DirectQueue->Signal() : 0u;
+        GraphicsContext->Reopen();
+        GraphicsContext->SetGraphicsRootSignature();
+        GraphicsContext->SetComputeRootSignature();
+        return FenceValue;
+    };
+
+    std::vector<bool> Signals(ExecutionOrder.size());
+    bool bSignalPrologue = false;
+    for (const FRGQueueWait& Wait : QueueWaits)
+    {
+        if (Wait.SignalPosition == INVALID_INDEX_U32)
+        {
+            bSignalPrologue = true;
+        }
+        else
+        {
+            Signals[Wait.SignalPosition] = true;
+        }
+    }
+
+    std::vector<uint64_t> FenceValues(ExecutionOrder.size());
+    uint64_t PrologueFenceValue = 0u;
+
+    IssueBarriers(GraphicsContext, PrologueBarriers);
+    if (bSignalPrologue)
+    {
+        PrologueFenceValue = SubmitGraphics(true);
+    }
+
+    // A wait only holds back what is submitted after it, the work recorded so far goes out first.
+    size_t NextWait = 0u;
+    auto IssueWaits = [&](uint32_t Position) {
+        for (; NextWait < QueueWaits.size() && QueueWaits[NextWait].Position == Position; NextWait++)
+        {
+            const FRGQueueWait& Wait = QueueWaits[NextWait];
+            const uint64_t FenceValue = Wait.SignalPosition == INVALID_INDEX_U32 ? PrologueFenceValue : FenceValues[Wait.SignalPosition];
+            if (Wait.Queue == ERGQueue::Graphics)
+            {
+                SubmitGraphics(false);
+                DirectQueue->WaitForQueue(*ComputeQueue, FenceValue);
+            }
+            else
+            {
+                if (ComputeContext)
+                {
+                    RHISubmitAsyncComputeContext(ComputeContext);
+                    ComputeContext = nullptr;
+                }
+                ComputeQueue->WaitForQueue(*DirectQueue, FenceValue);
+            }
+        }
+    };
+
+    uint32_t NextActivation = 0u;
+    for (uint32_t Position = 0; Position < ExecutionOrder.size(); Position++)
+    {
+        const FPass& Pass = Passes[ExecutionOrder[Position]];
+        IssueWaits(Position);
+
+        FGraphicsContext* Context = GraphicsContext;
+        if (Pass.Queue == ERGQueue::AsyncCompute)
+        {
+            if (!ComputeContext)
+            {
+                ComputeContext = RHIAcquireAsyncComputeContext();
+            }
+            Context = ComputeContext;
+        }
+
+        // Transitions on a placed texture only come after the aliasing barrier that makes it the active one. The
+        // compute queue's textures never share memory, every activation is on the graphics queue.
+        const uint32_t FirstActivation = NextActivation;
+        for (; NextActivation < AliasingActivations.size() && AliasingActivations[NextActivation].Position == Position; NextActivation++)
+        {
+            assert(Pass.Queue == ERGQueue::Graphics);
+            const FAliasingActivation& Activation = AliasingActivations[NextActivation];
+            GraphicsContext->AddAliasingBarrier(Activation.Before, PhysicalTextures[Activation.PhysicalTexture].Texture);
+        }
+        GraphicsContext->ExecuteResourceBarriers();
+
+        for (uint32_t Index = FirstActivation; Index < NextActivation; Index++)
+        {
+            const FPhysicalTexture& PhysicalTexture = PhysicalTextures[AliasingActivations[Index].PhysicalTexture];
+            if (AliasingActivations[Index].bDiscard)
+            {
+                GraphicsContext->AddResourceBarrier(PhysicalTexture.Texture, PhysicalTexture.InitialState);
+            }
+        }
+        GraphicsContext->ExecuteResourceBarriers();
+
+        for (uint32_t Index = FirstActivation; Index < NextActivation; Index++)
+        {
+            if (AliasingActivations[Index].bDiscard)
+            {
+                GraphicsContext->DiscardResource(PhysicalTextures[AliasingActivations[Index].PhysicalTexture].Texture);
+            }
+        }
+
+        IssueBarriers(Context, Pass.Barriers);
+        Pass.Execute(Context);
+        IssueBarriers(GraphicsContext, Pass.PostBarriers);
+
+        if (Signals[Position])
+        {
+            if (Pass.Queue == ERGQueue::Graphics)
+            {
+                FenceValues[Position] = SubmitGraphics(true);
+            }
+            else
+            {
+                FenceValues[Position] = RHISubmitAsyncComputeContext(ComputeContext);
+                ComputeContext = nullptr;
+            }
+        }
+    }
+
+    // The graphics queue waits for the last compute pass, which submitted everything the compute queue recorded.
+    IssueWaits(static_cast<uint32_t>(ExecutionOrder.size()));
+    assert(ComputeContext == nullptr);
+
+    IssueBarriers(GraphicsContext, FinalBarriers);
+}
+
+FTexture* FRenderGraph::GetTexture(FRGTextureHandle Texture) const
+{
+    const FTextureEntry& Entry = Textures[Texture.Index];
+    if (Entry.PhysicalTexture == INVALID_INDEX_U32)
+    {
+        return Entry.ImportedTexture;
+    }
+    return PhysicalTextures[Entry.PhysicalTexture].Texture;
+}
+
+const FRenderGraphTexturePool::FLayout& FRenderGraphTexturePool::Acquire(std::span<const FRGTransientTextureRequest> Requests)
+{
+    auto Matches = [Requests](const FPooledLayout& PooledLayout) {
+        return std::equal(Requests.begin(), Requests.end(), PooledLayout.Requests.begin(), PooledLayout.Requests.end(),
+            [](const FRGTransientTextureRequest& A, const FRGTransientTextureRequest& B) {
+                return IsCompatible(A.Desc, B.Desc) && A.FirstPass == B.FirstPass && A.LastPass == B.LastPass;
+            });
+    };
+
+    for (const std::unique_ptr<FPooledLayout>& PooledLayout : Layouts)
+    {
+        if (PooledLayout->LastUsedFrame != GFrameCount && Matches(*PooledLayout))
+        {
+            PooledLayout->LastUsedFrame = GFrameCount;
+            return PooledLayout->Layout;
+        }
+    }
+
+    Layouts.push_back(CreateLayout(Requests));
+    return Layouts.back()->Layout;
+}
+
+bool FRenderGraphTexturePool::ReleaseIfIdle(uint32_t IdleFrames)
+{
+    return std::erase_if(Layouts, [IdleFrames](const std::unique_ptr<FPooledLayout>& PooledLayout) {
+        return GFrameCount - PooledLayout->LastUsedFrame >= IdleFrames;
+    }) > 0u;
+}
+
+void FRenderGraphTexturePool::ReleaseAll()
+{
+    Layouts.clear();
+}
+
+std::unique_ptr<FRenderGraphTexturePool::FPooledLayout> FRenderGraphTexturePool::CreateLayout(std::span<const FRGTransientTextureRequest> Requests) const
+{
+    // Render targets and depth buffers get heaps of their own, as resource heap tier 1 requires.
+    constexpr uint32_t RenderTargetHeapCategory = 0u;
+    constexpr uint32_t TextureHeapCategory = 1u;
+
+    std::vector<FTransientResourceDesc> Resources;
+    for (const FRGTransientTextureRequest& Request : Requests)
+    {
+        const D3D12_RESOURCE_ALLOCATION_INFO AllocationInfo = RHIGetTextureAllocationInfo(Request.Desc);
+        const bool bRenderTarget = Request.Desc.Usage == ETextureUsage::RenderTarget || Request.Desc.Usage == ETextureUsage::DepthStencil;
+
+        Resources.push_back(FTransientResourceDesc{
+            .Size = AllocationInfo.SizeInBytes,
+            .Alignment = AllocationInfo.Alignment,
+            .FirstPass = Request.FirstPass,
+            .LastPass = Request.LastPass,
+            .HeapCategory = bRenderTarget ? RenderTargetHeapCategory : TextureHeapCategory,
+        });
+    }
+
+    const FTransientAliasingPlan Plan = PlanTransientAliasing(Resources);
+
+    std::unique_ptr<FPooledLayout> PooledLayout = std::make_unique<FPooledLayout>();
+    PooledLayout->Requests.assign(Requests.begin(), Requests.end());
+    PooledLayout->LastUsedFrame = GFrameCount;
+
+    for (const FTransientHeapDesc& Heap : Plan.Heaps)
+    {
+        PooledLayout->Heaps.push_back(RHIAllocateHeap(Heap.Size, Heap.Alignment, Heap.HeapCategory == RenderTargetHeapCategory
+            ? D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES : D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES));
+    }
+
+    FLayout& Layout = PooledLayout->Layout;
+    for (uint32_t Index = 0; Index < Requests.size(); Index++)
+    {
+        const FTransientPlacement& Placement = Plan.Placements[Index];
+        PooledLayout->Textures.push_back(RHICreatePlacedTexture(Requests[Index].Desc, FTexturePlacement{
+            .Heap = PooledLayout->Heaps[Placement.Heap].Get(),
+            .Offset = Placement.Offset,
+        }));
+        Layout.Textures.push_back(PooledLayout->Textures.back().get());
+    }
+
+    for (const FTransientAliasingBarrier& Barrier : Plan.Barriers)
+    {
+        Layout.AliasingBarriers.push_back(FAliasingBarrier{
+            .Pass = Barrier.Pass,
+            .Before = Barrier.ResourceBefore != INVALID_INDEX_U32 ? Layout.Textures[Barrier.ResourceBefore] : nullptr,
+            .After = Barrier.ResourceAfter,
+        });
+    }
+
+    Layout.HeapBytes = Plan.HeapBytes;
+    Layout.UnaliasedBytes = Plan.UnaliasedBytes;
+
+    Log(std::format("Render graph texture pool : {} textures in {} heaps, {} MB instead of {} MB.", Requests.size(), Plan.Heaps.size(),
+        Plan.HeapBytes / (1024u * 1024u), Plan.UnaliasedBytes / (1024u * 1024u)));
+
+    return PooledLayout;
+}
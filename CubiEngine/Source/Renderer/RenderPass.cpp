@@ -16,3 +16,45 @@ void FRenderPass::OnWindowResized(uint32_t InWidth, uint32_t InHeight)
 	Height = InHeight;
 	InitSizeDependantResource(InWidth, InHeight);
 }
+
+FLazyRenderPass::FLazyRenderPass(std::string_view InName, FFactory InFactory)
+    : Name(InName), Factory(std::move(InFactory))
+{
+}
+
+FRenderPass* FLazyRenderPass::Get()
+{
+    if (!Pass)
+    {
+        assert(Width != 0u && Height != 0u);
+        Log(std::format("Creating render pass {}.", Name));
+
+        Pass = Factory(Width, Height);
+        Pass->Initialize();
+    }
+
+    LastUsedFrame = GFrameCount;
+    return Pass.get();
+}
+
+void FLazyRenderPass::SetSize(uint32_t InWidth, uint32_t InHeight)
+{
+    Width = InWidth;
+    Height = InHeight;
+    if (Pass)
+    {
+        Pass->OnWindowResized(InWidth, InHeight);
+    }
+}
+
+bool FLazyRenderPass::ReleaseIfIdle(uint32_t IdleFrames)
+{
+    if (!Pass || GFrameCount - LastUsedFrame < IdleFrames)
+    {
+        return false;
+    }
+
+    Log(std::format("Releasing render pass {}, unused for {} frames.", Name, GFrameCount - LastUsedFrame));
+    Pass.reset();
+    return true;
+}
@@ -0,0 +1,230 @@
+#include "Renderer/RenderQueue.h"
+#include "Graphics/D3D12DynamicRHI.h"
+#include "Graphics/GraphicsContext.h"
+#include "Scene/Mesh.h"
+
+#include "Core/JobSystem.h"
+#include <algorithm>
+
+namespace
+{
+    constexpr uint32_t RADIX_BITS = 8u;
+    constexpr uint32_t RADIX_SIZE = 1u << RADIX_BITS;
+    constexpr uint32_t RADIX_PASSES = 64u / RADIX_BITS;
+
+    // Below this the cost of dispatching jobs outweighs the sort itself.
+    constexpr size_t PARALLEL_SORT_THRESHOLD = 4096u;
+    constexpr uint32_t MAX_SORT_CHUNKS = 8u;
+
+    // LSD radix sort, 8 bits per pass. Each chunk histograms and scatters its own range on the
+    // job system, and offsets are laid out per (digit, chunk) so the sort stays stable. Returns the number of passes skipped.
+    uint32_t ParallelRadixSort(std::vector<FDrawCommand>& Commands, std::vector<FDrawCommand>& Scratch)
+    {
+        const size_t Count = Commands.size();
+        Scratch.resize(Count);
+
+        const uint32_t NumChunks = (Count < PARALLEL_SORT_THRESHOLD || !GJobSystem) ? 1u
+            : min(MAX_SORT_CHUNKS, GJobSystem->GetNumWorkers());
+        const size_t ChunkSize = (Count + NumChunks - 1) / NumChunks;
+
+        std::vector<std::array<uint32_t, RADIX_SIZE>> Histograms(NumChunks);
+        std::vector<std::array<uint32_t, RADIX_SIZE>> Offsets(NumChunks);
+
+        auto ForEachChunk = [&](const std::function<void(uint32_t, uint32_t)>& Function)
+        {
+            if (NumChunks > 1u)
+            {
+                GJobSystem->ParallelFor(NumChunks, Function);
+            }
+            else
+            {
+                Function(0u, 1u);
+            }
+        };
+
+        FDrawCommand* Source = Commands.data();
+        FDrawCommand* Destination = Scratch.data();
+        uint32_t NumPassesSkipped = 0u;
+
+        for (uint32_t Pass = 0; Pass < RADIX_PASSES; Pass++)
+        {
+            const uint32_t Shift = Pass * RADIX_BITS;
+
+            ForEachChunk([&](uint32_t FirstChunk, uint32_t LastChunk)
+            {
+                for (uint32_t Chunk = FirstChunk; Chunk < LastChunk; Chunk++)
+                {
+                    const size_t Begin = min(Count, Chunk * ChunkSize);
+                    const size_t End = min(Count, Begin + ChunkSize);
+
+                    std::array<uint32_t, RADIX_SIZE>& Histogram = Histograms[Chunk];
+                    Histogram.fill(0u);
+                    for (size_t i = Begin; i < End; i++)
+                    {
+                        Histogram[(Source[i].SortKey >> Shift) & (RADIX_SIZE - 1)]++;
+                    }
+                }
+            });
+
+            // Passes where every key has the same digit are a no-op, which is common for the high bits.
+            bool bSkipPass = false;
+            uint32_t Offset = 0u;
+            for (uint32_t Digit = 0; Digit < RADIX_SIZE; Digit++)
+            {
+                uint32_t DigitCount = 0u;
+                for (uint32_t Chunk = 0; Chunk < NumChunks; Chunk++)
+                {
+                    Offsets[Chunk][Digit] = Offset + DigitCount;
+                    DigitCount += Histograms[Chunk][Digit];
+                }
+                bSkipPass |= (DigitCount == Count);
+                Offset += DigitCount;
+            }
+
+            if (bSkipPass)
+            {
+                NumPassesSkipped++;
+                continue;
+            }
+
+            ForEachChunk([&](uint32_t FirstChunk, uint32_t LastChunk)
+            {
+                for (uint32_t Chunk = FirstChunk; Chunk < LastChunk; Chunk++)
+                {
+                    const size_t Begin = min(Count, Chunk * ChunkSize);
+                    const size_t End = min(Count, Begin + ChunkSize);
+
+                    std::array<uint32_t, RADIX_SIZE>& ChunkOffsets = Offsets[Chunk];
+                    for (size_t i = Begin; i < End; i++)
+                    {
+                        Destination[ChunkOffsets[(Source[i].SortKey >> Shift) & (RADIX_SIZE - 1)]++] = Source[i];
+                    }
+                }
+            });
+
+            std::swap(Source, Destination);
+        }
+
+        if (Source != Commands.data())
+        {
+            std::copy(Source, Source + Count, Commands.data());
+        }
+        return NumPassesSkipped;
+    }
+
+    constexpr size_t TRANSFORM_OFFSET = offsetof(interlop::DeferredGPassRenderResources, modelMatrix);
+    constexpr size_t TRANSFORM_SIZE = offsetof(interlop::DeferredGPassRenderResources, positionBufferIndex) - TRANSFORM_OFFSET;
+    constexpr size_t GEOMETRY_OFFSET = offsetof(interlop::DeferredGPassRenderResources, positionBufferIndex);
+    constexpr size_t GEOMETRY_SIZE = offsetof(interlop::DeferredGPassRenderResources, debugBufferIndex) - GEOMETRY_OFFSET;
+    constexpr size_t MATERIAL_OFFSET = offsetof(interlop::DeferredGPassRenderResources, albedoTextureIndex);
+    constexpr size_t MATERIAL_SIZE = offsetof(interlop::DeferredGPassRenderResources, materialTableIndex) + sizeof(uint32_t) - MATERIAL_OFFSET;
+
+    bool HasSameTransform(const FMesh* A, const FMesh* B)
+    {
+        const XMMATRIX ModelA = A->GetModelMatrix();
+        const XMMATRIX ModelB = B->GetModelMatrix();
+        return memcmp(&ModelA, &ModelB, sizeof(XMMATRIX)) == 0;
+    }
+
+    // Every mesh reads the same pool streams, only where its vertices start differs.
+    bool HasSameGeometry(const FMesh* A, const FMesh* B)
+    {
+        return A->GetGeometryRange().BaseVertex == B->GetGeometryRange().BaseVertex;
+    }
+}
+
+static_assert(FRenderQueue::PIPELINE_BITS + FRenderQueue::DEPTH_BUCKET_BITS + FRenderQueue::MATERIAL_BITS + FRenderQueue::GEOMETRY_BITS + 28u == 64u,
+    "Sort key fields do not add up to 64 bits.");
+static_assert(GNumCbvSrvUavDescriptorHeap <= (1u << FRenderQueue::MATERIAL_BITS), "Material id does not fit in the sort key.");
+// Geometry ids are geometry pool entries, only their low bits sort. Ids that collide still draw correctly.
+
+uint64_t FRenderQueue::MakeSortKey(uint32_t PipelineId, uint32_t MaterialId, uint32_t GeometryId, float ViewDepth)
+{
+    // Non negative floats keep their order when compared as integers.
+    const float ClampedDepth = max(ViewDepth, 0.f);
+    uint32_t DepthBits;
+    memcpy(&DepthBits, &ClampedDepth, sizeof(uint32_t));
+
+    // floor(log2(depth)) from the float exponent : [0, 2) is bucket 0, [2, 4) bucket 1, and so on.
+    const int32_t Exponent = static_cast<int32_t>(DepthBits >> 23) - 127;
+    const uint32_t DepthBucket = static_cast<uint32_t>(std::clamp(Exponent, 0, static_cast<int32_t>((1u << DEPTH_BUCKET_BITS) - 1)));
+
+    return (static_cast<uint64_t>(PipelineId & ((1u << PIPELINE_BITS) - 1)) << 60)
+        | (static_cast<uint64_t>(DepthBucket) << 56)
+        | (static_cast<uint64_t>(MaterialId & ((1u << MATERIAL_BITS) - 1)) << 42)
+        | (static_cast<uint64_t>(GeometryId & ((1u << GEOMETRY_BITS) - 1)) << 28)
+        // The low mantissa bits only reorder draws a hair apart.
+        | static_cast<uint64_t>(DepthBits >> 4);
+}
+
+void FRenderQueue::Reset()
+{
+    DrawCommands.clear();
+    Stats = FRenderQueueStats{};
+}
+
+void FRenderQueue::Sort()
+{
+    Stats.NumSortPassesSkipped = ParallelRadixSort(DrawCommands, SortScratch);
+}
+
+void FRenderQueue::Submit(FGraphicsContext* const GraphicsContext, interlop::DeferredGPassRenderResources& RenderResources)
+{
+    Stats = FRenderQueueStats{ .NumSortPassesSkipped = Stats.NumSortPassesSkipped };
+    Stats.NumDraws = static_cast<uint32_t>(DrawCommands.size());
+
+    const FMesh* PrevMesh = nullptr;
+    for (const FDrawCommand& DrawCommand : DrawCommands)
+    {
+        const FMesh* Mesh = DrawCommand.Mesh;
+
+        if (!PrevMesh)
+        {
+            GraphicsContext->SetIndexBuffer(RHIGetGeometryPool()->GetIndexBuffer());
+
+            Mesh->SetTransformRenderResources(RenderResources);
+            Mesh->SetGeometryRenderResources(RenderResources);
+            Mesh->SetMaterialRenderResources(RenderResources);
+            GraphicsContext->SetGraphicsRoot32BitConstants(&RenderResources);
+        }
+        else
+        {
+            // The pool index buffer is bound once for the whole queue.
+            Stats.NumIndexBufferBindsSkipped++;
+
+            if (!HasSameTransform(Mesh, PrevMesh))
+            {
+                Mesh->SetTransformRenderResources(RenderResources);
+                GraphicsContext->SetGraphicsRoot32BitConstants(&RenderResources, TRANSFORM_OFFSET, TRANSFORM_SIZE);
+            }
+            else
+            {
+                Stats.NumTransformUpdatesSkipped++;
+            }
+
+            if (!HasSameGeometry(Mesh, PrevMesh))
+            {
+                Mesh->SetGeometryRenderResources(RenderResources);
+                GraphicsContext->SetGraphicsRoot32BitConstants(&RenderResources, GEOMETRY_OFFSET, GEOMETRY_SIZE);
+            }
+            else
+            {
+                Stats.NumGeometryUpdatesSkipped++;
+            }
+
+            if (Mesh->Material != PrevMesh->Material)
+            {
+                Mesh->SetMaterialRenderResources(RenderResources);
+                GraphicsContext->SetGraphicsRoot32BitConstants(&RenderResources, MATERIAL_OFFSET, MATERIAL_SIZE);
+            }
+            else
+            {
+                Stats.NumMaterialUpdatesSkipped++;
+            }
+        }
+
+        const FGeometryRange& Range = Mesh->GetGeometryRange();
+        GraphicsContext->DrawIndexedInstanced(Range.NumIndices, 1u, Range.FirstIndex);
+        PrevMesh = Mesh;
+    }
+}
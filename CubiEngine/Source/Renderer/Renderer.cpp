@@ -3,17 +3,19 @@
 #include "Graphics/GraphicsContext.h"
 #include "Core/Input.h"
 #include "Core/Editor.h"
+#include "Core/FrameArena.h"
+#include "Core/FileSystem.h"
+#include "Graphics/CommandCapture.h"
 #include "Graphics/Profiler.h"
 
 #include "Renderer/PathTracing.h"
 
 #define GI_METHOD_SSGI 1
 
-#define INITIALIZE_RENDER_PASS(TYPE, VAR_NAME)\
-    VAR_NAME = std::make_unique<TYPE>(Width, Height); \
-    VAR_NAME->Initialize(); \
-    RenderPasses.push_back(VAR_NAME.get());
-    
+#define REGISTER_RENDER_PASS(VAR_NAME)\
+    VAR_NAME.SetSize(Width, Height); \
+    RenderPasses.push_back(&VAR_NAME);
+
 
 FRenderer::FRenderer(SDL_Window* Window, uint32_t Width, uint32_t Height)
     :Width(Width), Height(Height)
@@ -22,21 +24,21 @@ FRenderer::FRenderer(SDL_Window* Window, uint32_t Width, uint32_t Height)
     Scene = std::make_unique<FScene>(Width, Height);
     Editor = std::make_unique<FEditor>(Window, Width, Height);
 
-    INITIALIZE_RENDER_PASS(FDeferredGPass, DeferredGPass);
-    INITIALIZE_RENDER_PASS(FDebugPass, DebugPass);
-    INITIALIZE_RENDER_PASS(FPostProcess, PostProcess);
-    INITIALIZE_RENDER_PASS(FTemporalAAPass, TemporalAA);
-    INITIALIZE_RENDER_PASS(FShadowDepthPass, ShadowDepthPass);
-    INITIALIZE_RENDER_PASS(FScreenSpaceGIPass, ScreenSpaceGI);
-    INITIALIZE_RENDER_PASS(FEyeAdaptationPass, EyeAdaptationPass);
-    INITIALIZE_RENDER_PASS(FBloomPass, BloomPass);
-    INITIALIZE_RENDER_PASS(FSSAOPass, SSAOPass);
-
-    INITIALIZE_RENDER_PASS(FRaytracingDebugScenePass, RaytracingDebugScenePass);
-    INITIALIZE_RENDER_PASS(FRaytracingShadowPass, RaytracingShadowPass);
-    INITIALIZE_RENDER_PASS(FPathTracingPass, PathTracingPass);
-
-    INITIALIZE_RENDER_PASS(FDenoisePass, DenoisePass);
+    REGISTER_RENDER_PASS(DeferredGPass);
+    REGISTER_RENDER_PASS(DebugPass);
+    REGISTER_RENDER_PASS(PostProcess);
+    REGISTER_RENDER_PASS(TemporalAA);
+    REGISTER_RENDER_PASS(ShadowDepthPass);
+    REGISTER_RENDER_PASS(ScreenSpaceGI);
+    REGISTER_RENDER_PASS(EyeAdaptationPass);
+    REGISTER_RENDER_PASS(BloomPass);
+    REGISTER_RENDER_PASS(SSAOPass);
+
+    REGISTER_RENDER_PASS(RaytracingDebugScenePass);
+    REGISTER_RENDER_PASS(RaytracingShadowPass);
+    REGISTER_RENDER_PASS(PathTracingPass);
+
+    REGISTER_RENDER_PASS(DenoisePass);
 }
 
 FRenderer::~FRenderer()
@@ -48,48 +50,53 @@ void FRenderer::Cleanup()
     RHIFlushAllQueue();
 }
 
-void FRenderer::GameTick(float DeltaTime, FInput* Input)
+void FRenderer::GameTick(float DeltaTime, FInput* Input, FFrameSnapshot& Snapshot)
 {
-    Scene->GameTick(DeltaTime, Input, Width, Height);
+    Scene->GameTick(DeltaTime, Input, Width, Height, Snapshot);
     Editor->GameTick(DeltaTime, Input);
+
+    Snapshot.bShowEditor = Editor->IsUIVisible();
+}
+
+void FRenderer::RenderFrame(const FFrameSnapshot& Snapshot)
+{
+    Scene->BeginRenderFrame(Snapshot);
+    Render();
+}
+
+void FRenderer::FlushFrames()
+{
+    RHIFlushAllQueue();
 }
 
 void FRenderer::BeginFrame(FGraphicsContext* GraphicsContext, FTexture* BackBuffer)
 {
+    // Scene textures other than depth are moved to their states by the render graph.
     GraphicsContext->AddResourceBarrier(BackBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET);
-    if (DeferredGPass)
-    {
-        GraphicsContext->AddResourceBarrier(SceneTexture.GBufferA.get(), D3D12_RESOURCE_STATE_RENDER_TARGET);
-        GraphicsContext->AddResourceBarrier(SceneTexture.GBufferB.get(), D3D12_RESOURCE_STATE_RENDER_TARGET);
-        GraphicsContext->AddResourceBarrier(SceneTexture.GBufferC.get(), D3D12_RESOURCE_STATE_RENDER_TARGET);
-        GraphicsContext->AddResourceBarrier(SceneTexture.VelocityTexture.get(), D3D12_RESOURCE_STATE_RENDER_TARGET);
-        GraphicsContext->AddResourceBarrier(SceneTexture.HDRTexture.get(), D3D12_RESOURCE_STATE_RENDER_TARGET);
-    }
-    GraphicsContext->AddResourceBarrier(SceneTexture.DepthTexture.get(), D3D12_RESOURCE_STATE_DEPTH_WRITE);
+    GraphicsContext->AddResourceBarrier(DepthTexture.get(), D3D12_RESOURCE_STATE_DEPTH_WRITE);
     GraphicsContext->ExecuteResourceBarriers();
 
     float RenderTargetClearValue[4] = { 0,0,0,1 };
     GraphicsContext->ClearRenderTargetView(BackBuffer, RenderTargetClearValue);
-    GraphicsContext->ClearDepthStencilView(SceneTexture.DepthTexture.get());
+    GraphicsContext->ClearDepthStencilView(DepthTexture.get());
 
     GraphicsContext->SetGraphicsRootSignature();
     GraphicsContext->SetComputeRootSignature();
 }
 
-void FRenderer::CopyHistoricalTexture(FGraphicsContext* GraphicsContext)
-{
-    SCOPED_NAMED_EVENT(GraphicsContext, CopyHistoricalTexture);
-
-    // Copy Prev Depth Texture
-    GraphicsContext->AddResourceBarrier(SceneTexture.DepthTexture.get(), D3D12_RESOURCE_STATE_COPY_SOURCE);
-    GraphicsContext->AddResourceBarrier(SceneTexture.PrevDepthTexture.get(), D3D12_RESOURCE_STATE_COPY_DEST);
-    GraphicsContext->ExecuteResourceBarriers();
-    GraphicsContext->CopyResource(SceneTexture.PrevDepthTexture->GetResource(), SceneTexture.DepthTexture->GetResource());
-}
-
 void FRenderer::Render()
 {
+    std::unique_ptr<FCommandCapture> FrameCapture;
+    if (Scene->GetRenderSettings().bCaptureNextFrame)
+    {
+        Scene->GetRenderSettings().bCaptureNextFrame = false;
+        FrameCapture = std::make_unique<FCommandCapture>();
+        RHISetCommandCapture(FrameCapture.get());
+    }
+
     RHIBeginFrame();
+    GFrameArenas.BeginFrame();
+    ReleaseIdleRenderPasses();
     RHIGetGPUProfiler().BeginFrame();
 
     FGraphicsContext* GraphicsContext = RHIGetCurrentGraphicsContext();
@@ -152,6 +159,11 @@ void FRenderer::Render()
     RHIGetGPUProfiler().EndFrame();
 
     RHIGetDirectCommandQueue()->ExecuteContext(GraphicsContext);
+    if (FrameCapture)
+    {
+        RHISetCommandCapture(nullptr);
+        SaveFrameCapture(*FrameCapture);
+    }
     RHIPresent();
 
     RHIEndFrame();
@@ -160,203 +172,513 @@ void FRenderer::Render()
     GFrameCount++;
 }
 
-FTexture* FRenderer::RenderDeferredShading(FGraphicsContext* GraphicsContext)
+void FRenderer::SaveFrameCapture(const FCommandCapture& FrameCapture) const
 {
-    FTexture* Output = nullptr;
+    const std::string Path = FFileSystem::GetFullPath(std::format("Captures/Frame{}.cubicap", GFrameCount));
+    std::filesystem::create_directories(std::filesystem::path(Path).parent_path());
+    if (!FrameCapture.SaveToFile(Path))
+    {
+        Log(std::format("Failed to save frame capture to {}.", Path));
+        return;
+    }
 
-    // ----- Deferred GPass ----
-    if (DeferredGPass)
+    Log(std::format("Captured {} commands ({} KB) to {}.", FrameCapture.GetNumCommands(), FrameCapture.GetStream().size() / 1024u, Path));
+
+    if constexpr (DEBUG_MODE)
     {
-        SCOPED_NAMED_EVENT(GraphicsContext, DeferredGPass);
-        SCOPED_GPU_EVENT(DeferredGPass);
-        DeferredGPass->Render(Scene.get(), GraphicsContext, SceneTexture);
+        // A capture replayed into a recording sink must come back byte for byte.
+        FCommandCapture Reencoded;
+        FRecordingCommandSink Sink(Reencoded);
+        ReplayCommandStream(FrameCapture.GetStream(), Sink);
+        assert(Reencoded.GetStream() == FrameCapture.GetStream());
+    }
+}
 
-        // Render Skybox
-        {
+FTexture* FRenderer::RenderDeferredShading(FGraphicsContext* GraphicsContext)
+{
+    const FSceneRenderSettings& Settings = Scene->GetRenderSettings();
+
+    FRenderGraph Graph;
+    const FSceneTextureHandles Textures = AddSceneTextures(Graph);
+
+    // ----- Deferred GPass ----
+    Graph.AddPass("DeferredGPass", {
+            RGWrite(Textures.GBufferA, D3D12_RESOURCE_STATE_RENDER_TARGET),
+            RGWrite(Textures.GBufferB, D3D12_RESOURCE_STATE_RENDER_TARGET),
+            RGWrite(Textures.GBufferC, D3D12_RESOURCE_STATE_RENDER_TARGET),
+            RGWrite(Textures.Velocity, D3D12_RESOURCE_STATE_RENDER_TARGET),
+            RGWrite(Textures.Depth, D3D12_RESOURCE_STATE_DEPTH_WRITE),
+            // Cleared here, the skybox and lighting add to it.
+            RGWrite(Textures.HDR, D3D12_RESOURCE_STATE_RENDER_TARGET),
+        }, [&](FGraphicsContext* GraphicsContext) {
+            SCOPED_NAMED_EVENT(GraphicsContext, DeferredGPass);
+            SCOPED_GPU_EVENT(DeferredGPass);
+            DeferredGPass->Render(Scene.get(), GraphicsContext, SceneTexture);
+        });
+
+    // Render Skybox
+    Graph.AddPass("EnvironmentMap", {
+            RGWrite(Textures.HDR, D3D12_RESOURCE_STATE_RENDER_TARGET),
+            RGRead(Textures.Depth, D3D12_RESOURCE_STATE_DEPTH_READ),
+        }, [&](FGraphicsContext* GraphicsContext) {
             SCOPED_NAMED_EVENT(GraphicsContext, EnvironmentMap);
             SCOPED_GPU_EVENT(EnvironmentMap);
             Scene->RenderEnvironmentMap(GraphicsContext, SceneTexture);
-        }
-    }
+        });
     // ----- Deferred GPass ----
 
     // ----- Shadow pass -----
-    RenderShadow(GraphicsContext, SceneTexture);
+    // The lighting shader reads the shadow depth texture whatever the shadow method.
+    const FRGTextureHandle ShadowDepth = Graph.ImportTexture(ShadowDepthPass->GetShadowDepthTexture());
+    const FRGTextureHandle Moment = Settings.bUseVSM ? Graph.ImportTexture(ShadowDepthPass->GetMomentTexture()) : FRGTextureHandle{};
+    // Only read by the lighting shader with raytraced shadows, the pass is not created otherwise.
+    const FRGTextureHandle RaytracingShadow = Settings.ShadowMethod == (int)EShadowMethod::Raytracing ?
+        Graph.ImportTexture(RaytracingShadowPass->GetRaytracingShadowTexture()) : FRGTextureHandle{};
+
+    if (Settings.ShadowMethod == (int)EShadowMethod::ShadowMap)
+    {
+        std::vector<FRGTextureAccess> Accesses = { RGWrite(ShadowDepth, D3D12_RESOURCE_STATE_DEPTH_WRITE) };
+        if (Moment.IsValid())
+        {
+            Accesses.push_back(RGWrite(Moment, D3D12_RESOURCE_STATE_RENDER_TARGET));
+        }
+
+        Graph.AddPass("ShadowDepth", std::move(Accesses), [&](FGraphicsContext* GraphicsContext) {
+            SCOPED_NAMED_EVENT(GraphicsContext, ShadowDepth);
+            SCOPED_GPU_EVENT(ShadowDepth);
+            ShadowDepthPass->Render(GraphicsContext, Scene.get());
+        });
+    }
+    else if (RaytracingShadow.IsValid())
+    {
+        Graph.AddPass("RaytracingShadow", {
+                RGRead(Textures.Depth, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGWrite(RaytracingShadow, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+            }, [&](FGraphicsContext* GraphicsContext) {
+                SCOPED_NAMED_EVENT(GraphicsContext, RaytracingShadow);
+                SCOPED_GPU_EVENT(RaytracingShadow);
+                RaytracingShadowPass->AddPass(GraphicsContext, Scene.get(), SceneTexture);
+            });
+    }
     // ----- Shadow Depth pass -----
 
     // ----- Screen Space Ambient Occlusion -----
-    if (Scene->GetRenderSettings().bUseSSAO)
+    // Lighting runs without AO until the SSAO pipeline finished compiling.
+    const bool bUseSSAO = Settings.bUseSSAO && SSAOPass->IsReady();
+    const FRGTextureHandle SSAO = bUseSSAO ? Graph.ImportTexture(SSAOPass->SSAOTexture.get()) : FRGTextureHandle{};
+    if (bUseSSAO)
     {
-        SCOPED_NAMED_EVENT(GraphicsContext, SSAO);
-        SCOPED_GPU_EVENT(SSAO);
-
-        SSAOPass->AddSSAOPass(GraphicsContext, Scene.get(), SceneTexture);
+        Graph.AddPass("SSAO", {
+                RGRead(Textures.GBufferB, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGRead(Textures.Depth, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGWrite(SSAO, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+            }, [&](FGraphicsContext* GraphicsContext) {
+                SCOPED_NAMED_EVENT(GraphicsContext, SSAO);
+                // On the async compute queue this is the compute context, the timestamps go on its list.
+                SCOPED_GPU_EVENT_ON_CONTEXT(GraphicsContext, SSAO);
+                SSAOPass->AddSSAOPass(GraphicsContext, Scene.get(), SceneTexture);
+            }, Settings.bSSAOAsyncCompute ? RenderGraphPassFlag_AsyncCompute : RenderGraphPassFlag_None);
     }
     // ----- Screen Space Ambient Occlusion -----
 
     // ----- Deferred Lighting Pass -----
-    if (DeferredGPass)
     {
-        SCOPED_NAMED_EVENT(GraphicsContext, LightPass);
-        SCOPED_GPU_EVENT(LightPass);
+        std::vector<FRGTextureAccess> Accesses = {
+            RGRead(Textures.GBufferA, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+            RGRead(Textures.GBufferB, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+            RGRead(Textures.GBufferC, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+            RGRead(Textures.Velocity, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+            RGRead(Textures.Depth, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+            RGRead(ShadowDepth, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+            RGWrite(Textures.HDR, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+        };
+        for (const FRGTextureHandle Optional : { Moment, RaytracingShadow, SSAO })
+        {
+            if (Optional.IsValid())
+            {
+                Accesses.push_back(RGRead(Optional, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE));
+            }
+        }
 
-        FTexture* SSAOTexture = Scene->GetRenderSettings().bUseSSAO ? SSAOPass->SSAOTexture.get() : nullptr;
-        DeferredGPass->RenderLightPass(Scene.get(), GraphicsContext,
-            ShadowDepthPass.get(), SceneTexture, SSAOTexture, RaytracingShadowPass->GetRaytracingShadowTexture()
-        );
+        Graph.AddPass("LightPass", std::move(Accesses), [&](FGraphicsContext* GraphicsContext) {
+            SCOPED_NAMED_EVENT(GraphicsContext, LightPass);
+            SCOPED_GPU_EVENT(LightPass);
+            DeferredGPass->RenderLightPass(Scene.get(), GraphicsContext, ShadowDepthPass.Get(), SceneTexture,
+                SSAO.IsValid() ? Graph.GetTexture(SSAO) : nullptr,
+                RaytracingShadow.IsValid() ? Graph.GetTexture(RaytracingShadow) : nullptr
+            );
+        });
     }
     // ----- Deferred Lighting Pass -----
 
-    if (Scene->GetRenderSettings().GIMethod == GI_METHOD_SSGI)
+    if (Settings.GIMethod == GI_METHOD_SSGI)
     {
-        SCOPED_NAMED_EVENT(GraphicsContext, ScreenSpaceGI);
-        SCOPED_GPU_EVENT(ScreenSpaceGI);
-
-        ScreenSpaceGI->AddPass(GraphicsContext, Scene.get(), SceneTexture);
+        // Reads the lit scene and adds the indirect light back into it. Every step is its own pass so the graph
+        // issues all of the transitions between them.
+        const FRGTextureHandle Raycast = Graph.ImportTexture(ScreenSpaceGI->ScreenSpaceGITexture.get());
+        const FRGTextureHandle Half = Graph.ImportTexture(ScreenSpaceGI->HalfTexture.get());
+        const FRGTextureHandle Quarter = Graph.ImportTexture(ScreenSpaceGI->QuarterTexture.get());
+        const FRGTextureHandle BlurX = Graph.ImportTexture(ScreenSpaceGI->BlurXTexture.get());
+        const FRGTextureHandle Denoised = Graph.ImportTexture(ScreenSpaceGI->DenoisedScreenSpaceGITexture.get());
+        const FRGTextureHandle History = Graph.ImportTexture(ScreenSpaceGI->HistoryTexture.get());
+        const FRGTextureHandle NumFramesAccumulated = Graph.ImportTexture(ScreenSpaceGI->HistroyNumFrameAccumulated.get());
+        const FRGTextureHandle Resolve = Graph.ImportTexture(ScreenSpaceGI->ResolveTexture.get());
+
+        Graph.AddPass("SSGIRaycast", {
+                RGRead(Textures.HDR, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGRead(Textures.GBufferB, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGRead(Textures.Depth, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGWrite(Raycast, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+            }, [&](FGraphicsContext* GraphicsContext) {
+                SCOPED_GPU_EVENT(SSGIRaycast);
+                ScreenSpaceGI->RaycastDiffuse(GraphicsContext, Scene.get(), SceneTexture);
+            });
+
+        Graph.AddPass("SSGIDownSampleHalf", {
+                RGRead(Raycast, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGWrite(Half, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+            }, [&](FGraphicsContext* GraphicsContext) {
+                SCOPED_GPU_EVENT(SSGIDownSampleHalf);
+                ScreenSpaceGI->DownSample(GraphicsContext, ScreenSpaceGI->ScreenSpaceGITexture.get(), ScreenSpaceGI->HalfTexture.get());
+            });
+
+        Graph.AddPass("SSGIDownSampleQuarter", {
+                RGRead(Half, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGWrite(Quarter, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+            }, [&](FGraphicsContext* GraphicsContext) {
+                SCOPED_GPU_EVENT(SSGIDownSampleQuarter);
+                ScreenSpaceGI->DownSample(GraphicsContext, ScreenSpaceGI->HalfTexture.get(), ScreenSpaceGI->QuarterTexture.get());
+            });
+
+        Graph.AddPass("SSGIBlurX", {
+                RGRead(Quarter, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGWrite(BlurX, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+            }, [&](FGraphicsContext* GraphicsContext) {
+                SCOPED_GPU_EVENT(SSGIBlurX);
+                ScreenSpaceGI->GaussianBlur(GraphicsContext, Scene.get(), ScreenSpaceGI->QuarterTexture.get(), ScreenSpaceGI->BlurXTexture.get(), true);
+            });
+
+        Graph.AddPass("SSGIBlurY", {
+                RGRead(BlurX, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGWrite(Quarter, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+            }, [&](FGraphicsContext* GraphicsContext) {
+                SCOPED_GPU_EVENT(SSGIBlurY);
+                ScreenSpaceGI->GaussianBlur(GraphicsContext, Scene.get(), ScreenSpaceGI->BlurXTexture.get(), ScreenSpaceGI->QuarterTexture.get(), false);
+            });
+
+        Graph.AddPass("SSGIUpSample", {
+                RGRead(Quarter, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGWrite(Denoised, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+            }, [&](FGraphicsContext* GraphicsContext) {
+                SCOPED_GPU_EVENT(SSGIUpSample);
+                ScreenSpaceGI->UpSample(GraphicsContext, ScreenSpaceGI->QuarterTexture.get(), ScreenSpaceGI->DenoisedScreenSpaceGITexture.get());
+            });
+
+        Graph.AddPass("SSGIResolve", {
+                RGRead(Denoised, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGRead(History, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGRead(Textures.Velocity, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGRead(Textures.PrevDepth, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGRead(Textures.Depth, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGWrite(Resolve, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+                RGWrite(NumFramesAccumulated, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+            }, [&](FGraphicsContext* GraphicsContext) {
+                SCOPED_GPU_EVENT(SSGIResolve);
+                ScreenSpaceGI->Resolve(GraphicsContext, Scene.get(), SceneTexture);
+            });
+
+        // Nothing reads the history this frame, exporting it keeps the pass from being culled.
+        Graph.AddPass("SSGIUpdateHistory", {
+                RGRead(Resolve, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGWrite(History, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+            }, [&](FGraphicsContext* GraphicsContext) {
+                SCOPED_GPU_EVENT(SSGIUpdateHistory);
+                ScreenSpaceGI->UpdateHistory(GraphicsContext, Scene.get());
+            });
+        Graph.ExportTexture(History);
+
+        Graph.AddPass("SSGIComposition", {
+                RGRead(Resolve, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGRead(Textures.GBufferA, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGWrite(Textures.HDR, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+            }, [&](FGraphicsContext* GraphicsContext) {
+                SCOPED_GPU_EVENT(SSGIComposition);
+                ScreenSpaceGI->CompositionSSGI(GraphicsContext, Scene.get(), SceneTexture);
+            });
     }
-    
-    // ----- Post Process -----
-    {
-        SCOPED_NAMED_EVENT(GraphicsContext, PostProcess);
-        SCOPED_GPU_EVENT(PostProcess);
 
-        FTexture* HDR = SceneTexture.HDRTexture.get();
-        Output = SceneTexture.LDRTexture.get();
-
-        if (Scene.get()->GetRenderSettings().bUseTaa)
-        {
-            SCOPED_NAMED_EVENT(GraphicsContext, TemporalAA);
-            SCOPED_GPU_EVENT(TemporalAA);
-
-            TemporalAA->Resolve(GraphicsContext, Scene.get(), SceneTexture);
-            HDR = TemporalAA->ResolveTexture.get();
+    // ----- Post Process -----
+    FRGTextureHandle HDR = Textures.HDR;
 
-            TemporalAA->UpdateHistory(GraphicsContext, Scene.get());
-        }
+    if (Settings.bUseTaa)
+    {
+        const FRGTextureHandle History = Graph.ImportTexture(TemporalAA->HistoryTexture.get());
+        const FRGTextureHandle Resolve = Graph.ImportTexture(TemporalAA->ResolveTexture.get());
+        Graph.AddPass("TemporalAA", {
+                RGRead(HDR, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGRead(Textures.Velocity, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGRead(History, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGWrite(Resolve, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+            }, [&](FGraphicsContext* GraphicsContext) {
+                SCOPED_NAMED_EVENT(GraphicsContext, TemporalAA);
+                SCOPED_GPU_EVENT(TemporalAA);
+                TemporalAA->Resolve(GraphicsContext, Scene.get(), SceneTexture);
+            });
+
+        // Only next frame's resolve reads the history, exporting it keeps the pass from being culled.
+        Graph.AddPass("TemporalAAUpdateHistory", {
+                RGRead(Resolve, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGWrite(History, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+            }, [&](FGraphicsContext* GraphicsContext) {
+                SCOPED_GPU_EVENT(TemporalAAUpdateHistory);
+                TemporalAA->UpdateHistory(GraphicsContext, Scene.get());
+            });
+        Graph.ExportTexture(History);
+        HDR = Resolve;
+    }
 
-        if (Scene.get()->GetRenderSettings().bUseEyeAdaptation)
-        {
-            SCOPED_NAMED_EVENT(GraphicsContext, EyeAdaptation);
-            SCOPED_GPU_EVENT(EyeAdaptation);
+    if (Settings.bUseEyeAdaptation)
+    {
+        // Writes the luminance buffers tone mapping reads, which the graph does not track.
+        Graph.AddPass("EyeAdaptation", {
+                RGRead(HDR, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+            }, [&, HDR](FGraphicsContext* GraphicsContext) {
+                SCOPED_NAMED_EVENT(GraphicsContext, EyeAdaptation);
+                SCOPED_GPU_EVENT(EyeAdaptation);
+                EyeAdaptationPass->GenerateHistogram(GraphicsContext, Scene.get(), Graph.GetTexture(HDR));
+                EyeAdaptationPass->CalculateAverageLuminance(GraphicsContext, Scene.get(), Width, Height);
+            }, RenderGraphPassFlag_NeverCull);
+    }
 
-            EyeAdaptationPass->GenerateHistogram(GraphicsContext, Scene.get(), HDR);
-            EyeAdaptationPass->CalculateAverageLuminance(GraphicsContext, Scene.get(), Width, Height);
-        }
+    const bool bUseBloom = Settings.bUseBloom && BloomPass->IsReady();
+    const FRGTextureHandle Bloom = bUseBloom ? Graph.ImportTexture(BloomPass->BloomResultTexture.get()) : FRGTextureHandle{};
+    if (bUseBloom)
+    {
+        Graph.AddPass("Bloom", {
+                RGRead(HDR, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+                RGWrite(Bloom, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+            }, [&, HDR](FGraphicsContext* GraphicsContext) {
+                SCOPED_NAMED_EVENT(GraphicsContext, Bloom);
+                SCOPED_GPU_EVENT(Bloom);
+                BloomPass->AddBloomPass(GraphicsContext, Scene.get(), Graph.GetTexture(HDR));
+            });
+    }
 
-        if (Scene->GetRenderSettings().bUseBloom)
+    {
+        std::vector<FRGTextureAccess> Accesses = {
+            RGRead(HDR, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+            RGWrite(Textures.LDR, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+        };
+        if (Bloom.IsValid())
         {
-            SCOPED_NAMED_EVENT(GraphicsContext, Bloom);
-            SCOPED_GPU_EVENT(Bloom);
-            BloomPass->AddBloomPass(GraphicsContext, Scene.get(), HDR);
+            Accesses.push_back(RGRead(Bloom, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE));
         }
 
-        {
+        Graph.AddPass("ToneMapping", std::move(Accesses), [&, HDR](FGraphicsContext* GraphicsContext) {
             SCOPED_NAMED_EVENT(GraphicsContext, ToneMapping);
             SCOPED_GPU_EVENT(ToneMapping);
-            EyeAdaptationPass->ToneMapping(GraphicsContext, Scene.get(), HDR, Output,
-                Scene->GetRenderSettings().bUseBloom ? BloomPass->BloomResultTexture.get() : nullptr);
-        }
-
-        // PostProcess->Tonemapping(GraphicsContext, Scene.get(), *HDR, Width, Height);
+            EyeAdaptationPass->ToneMapping(GraphicsContext, Scene.get(), Graph.GetTexture(HDR), Graph.GetTexture(Textures.LDR),
+                Bloom.IsValid() ? Graph.GetTexture(Bloom) : nullptr);
+        });
     }
+    // ----- Post Process -----
 
-    CopyHistoricalTexture(GraphicsContext);
-
-    assert(Output != nullptr);
-    return Output;
+    // The next frame reads this one's depth.
+    Graph.AddPass("CopyHistoricalTexture", {
+            RGRead(Textures.Depth, D3D12_RESOURCE_STATE_COPY_SOURCE),
+            RGWrite(Textures.PrevDepth, D3D12_RESOURCE_STATE_COPY_DEST),
+        }, [&](FGraphicsContext* GraphicsContext) {
+            SCOPED_NAMED_EVENT(GraphicsContext, CopyHistoricalTexture);
+            GraphicsContext->CopyResource(PrevDepthTexture->GetResource(), DepthTexture->GetResource());
+        });
+    Graph.ExportTexture(Textures.PrevDepth);
+
+    Graph.Compile();
+    Graph.Realize(TransientTexturePool);
+    BindSceneTextures(Graph, Textures);
+    Graph.Execute(GraphicsContext);
+
+    return Graph.GetTexture(Textures.LDR);
 }
 
 FTexture* FRenderer::RenderDebugRaytracingScene(FGraphicsContext* GraphicsContext)
 {
-    FTexture* Output = nullptr;
-
-    if (RaytracingDebugScenePass)
-    {
-        SCOPED_NAMED_EVENT(GraphicsContext, RaytracingDebugScene);
-        SCOPED_GPU_EVENT(RaytracingDebugScene);
-
-        RaytracingDebugScenePass->AddPass(GraphicsContext, Scene.get());
-    }
-
-    {
-        SCOPED_NAMED_EVENT(GraphicsContext, PostProcess);
-        SCOPED_GPU_EVENT(PostProcess);
-
-        FTexture* HDR = RaytracingDebugScenePass->GetRaytracingDebugSceneTexture();
-        Output = SceneTexture.LDRTexture.get();
-
-        {
+    FRenderGraph Graph;
+    const FSceneTextureHandles Textures = AddSceneTextures(Graph);
+    const FRGTextureHandle HDR = Graph.ImportTexture(RaytracingDebugScenePass->GetRaytracingDebugSceneTexture());
+
+    Graph.AddPass("RaytracingDebugScene", {
+            RGWrite(HDR, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+        }, [&](FGraphicsContext* GraphicsContext) {
+            SCOPED_NAMED_EVENT(GraphicsContext, RaytracingDebugScene);
+            SCOPED_GPU_EVENT(RaytracingDebugScene);
+            RaytracingDebugScenePass->AddPass(GraphicsContext, Scene.get());
+        });
+
+    Graph.AddPass("ToneMapping", {
+            RGRead(HDR, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+            RGWrite(Textures.LDR, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+        }, [&](FGraphicsContext* GraphicsContext) {
             SCOPED_NAMED_EVENT(GraphicsContext, ToneMapping);
             SCOPED_GPU_EVENT(ToneMapping);
-            PostProcess->Tonemapping(GraphicsContext, Scene.get(), HDR, Output, Width, Height);
-        }
-    }
+            PostProcess->Tonemapping(GraphicsContext, Scene.get(), Graph.GetTexture(HDR), Graph.GetTexture(Textures.LDR), Width, Height);
+        });
+
+    Graph.Compile();
+    Graph.Realize(TransientTexturePool);
+    Graph.Execute(GraphicsContext);
 
-    assert(Output != nullptr);
-    return Output;
+    return Graph.GetTexture(Textures.LDR);
 }
 
 FTexture* FRenderer::RenderPathTracingScene(FGraphicsContext* GraphicsContext)
 {
-    if (PathTracingPass)
-    {
-        SCOPED_NAMED_EVENT(GraphicsContext, PathTracing);
-        SCOPED_GPU_EVENT(PathTracing);
-
-        PathTracingPass->AddPass(GraphicsContext, Scene.get());
-    }
-
-    FTexture* HDR = PathTracingPass->GetPathTracingSceneTexture();
+    FRenderGraph Graph;
+    const FSceneTextureHandles Textures = AddSceneTextures(Graph);
+    const FRGTextureHandle PathTracingScene = Graph.ImportTexture(PathTracingPass->GetPathTracingSceneTexture());
+    const FRGTextureHandle Albedo = Graph.ImportTexture(PathTracingPass->GetPathTracingAlbedo());
+    const FRGTextureHandle Normal = Graph.ImportTexture(PathTracingPass->GetPathTracingNormal());
+
+    Graph.AddPass("PathTracing", {
+            RGWrite(PathTracingScene, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+            RGWrite(Albedo, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+            RGWrite(Normal, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+        }, [&](FGraphicsContext* GraphicsContext) {
+            SCOPED_NAMED_EVENT(GraphicsContext, PathTracing);
+            SCOPED_GPU_EVENT(PathTracing);
+            PathTracingPass->AddPass(GraphicsContext, Scene.get());
+        });
+
+    FRGTextureHandle HDR = PathTracingScene;
     if (Scene->GetRenderSettings().bEnablePathTracingDenoiser)
     {
-        if (Scene->GetRenderSettings().bDenoiserAlbedoNormal)
+        const bool bAlbedoNormal = Scene->GetRenderSettings().bDenoiserAlbedoNormal;
+        const FRGTextureHandle DenoisedOutput = Graph.ImportTexture(DenoisePass->GetDenoisedOutput());
+
+        std::vector<FRGTextureAccess> Accesses = {
+            RGRead(PathTracingScene, D3D12_RESOURCE_STATE_COPY_SOURCE),
+            RGWrite(DenoisedOutput, D3D12_RESOURCE_STATE_COPY_DEST),
+        };
+        if (bAlbedoNormal)
         {
-			HDR = DenoisePass->AddPass(GraphicsContext, HDR,
-                PathTracingPass->GetPathTracingAlbedo(), PathTracingPass->GetPathTracingNormal()
-            );
+            Accesses.push_back(RGRead(Albedo, D3D12_RESOURCE_STATE_COPY_SOURCE));
+            Accesses.push_back(RGRead(Normal, D3D12_RESOURCE_STATE_COPY_SOURCE));
         }
-        else
-        {
-			HDR = DenoisePass->AddPass(GraphicsContext, HDR);
-        }
-    }
 
-    FTexture* Output = SceneTexture.LDRTexture.get();
-    {
-        SCOPED_NAMED_EVENT(GraphicsContext, PostProcess);
-        SCOPED_GPU_EVENT(PostProcess);
+        Graph.AddPass("Denoise", std::move(Accesses), [&, bAlbedoNormal](FGraphicsContext* GraphicsContext) {
+            SCOPED_NAMED_EVENT(GraphicsContext, Denoise);
+            SCOPED_GPU_EVENT(Denoise);
+            if (bAlbedoNormal)
+            {
+                DenoisePass->AddPass(GraphicsContext, Graph.GetTexture(PathTracingScene),
+                    Graph.GetTexture(Albedo), Graph.GetTexture(Normal)
+                );
+            }
+            else
+            {
+                DenoisePass->AddPass(GraphicsContext, Graph.GetTexture(PathTracingScene));
+            }
+        });
+        HDR = DenoisedOutput;
+    }
 
-        {
+    Graph.AddPass("ToneMapping", {
+            RGRead(HDR, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+            RGWrite(Textures.LDR, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+        }, [&, HDR](FGraphicsContext* GraphicsContext) {
             SCOPED_NAMED_EVENT(GraphicsContext, ToneMapping);
             SCOPED_GPU_EVENT(ToneMapping);
-            PostProcess->Tonemapping(GraphicsContext, Scene.get(), HDR, Output, Width, Height);
-        }
-    }
+            PostProcess->Tonemapping(GraphicsContext, Scene.get(), Graph.GetTexture(HDR), Graph.GetTexture(Textures.LDR), Width, Height);
+        });
 
-    assert(Output != nullptr);
-    return Output;
+    Graph.Compile();
+    Graph.Realize(TransientTexturePool);
+    Graph.Execute(GraphicsContext);
+
+    return Graph.GetTexture(Textures.LDR);
 }
 
-void FRenderer::RenderShadow(FGraphicsContext* GraphicsContext, FSceneTexture& SceneTexture)
+FSceneTextureHandles FRenderer::AddSceneTextures(FRenderGraph& Graph)
 {
-    if (Scene->GetRenderSettings().ShadowMethod == (int)EShadowMethod::ShadowMap)
-    {
-        if (ShadowDepthPass)
-        {
-            SCOPED_NAMED_EVENT(GraphicsContext, ShadowDepth);
-            SCOPED_GPU_EVENT(ShadowDepth)
-            ShadowDepthPass->Render(GraphicsContext, Scene.get());
-        }
-    }
-    else if (Scene->GetRenderSettings().ShadowMethod == (int)EShadowMethod::Raytracing)
-    {
-        if (RaytracingShadowPass)
-        {
-            SCOPED_NAMED_EVENT(GraphicsContext, RaytracingShadow);
-            SCOPED_GPU_EVENT(RaytracingShadow);
-            RaytracingShadowPass->AddPass(GraphicsContext, Scene.get(), SceneTexture);
-        }
-    }
+    FTextureCreationDesc LDRTextureDesc{
+        .Usage = ETextureUsage::RenderTarget,
+        .Width = Width,
+        .Height = Height,
+        .Format = DXGI_FORMAT_R10G10B10A2_UNORM,
+        .InitialState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
+        .Name = L"LDR Texture",
+    };
+
+    FTextureCreationDesc GBufferADesc{
+        .Usage = ETextureUsage::RenderTarget,
+        .Width = Width,
+        .Height = Height,
+        .Format = DXGI_FORMAT_R8G8B8A8_UNORM,
+        .InitialState = D3D12_RESOURCE_STATE_RENDER_TARGET,
+        .Name = L"GBuffer A",
+    };
+    FTextureCreationDesc GBufferBDesc{
+        .Usage = ETextureUsage::RenderTarget,
+        .Width = Width,
+        .Height = Height,
+        .Format = DXGI_FORMAT_R16G16B16A16_FLOAT,
+        .InitialState = D3D12_RESOURCE_STATE_RENDER_TARGET,
+        .Name = L"GBuffer B",
+    };
+    FTextureCreationDesc GBufferCDesc{
+        .Usage = ETextureUsage::RenderTarget,
+        .Width = Width,
+        .Height = Height,
+        .Format = DXGI_FORMAT_R8G8B8A8_UNORM,
+        .InitialState = D3D12_RESOURCE_STATE_RENDER_TARGET,
+        .Name = L"GBuffer C",
+    };
+    FTextureCreationDesc HDRTextureDesc{
+        .Usage = ETextureUsage::RenderTarget,
+        .Width = Width,
+        .Height = Height,
+        .Format = DXGI_FORMAT_R16G16B16A16_FLOAT,
+        .InitialState = D3D12_RESOURCE_STATE_RENDER_TARGET,
+        .Name = L"HDR",
+    };
+    FTextureCreationDesc VelocityTextureDesc{
+        .Usage = ETextureUsage::RenderTarget,
+        .Width = Width,
+        .Height = Height,
+        .Format = DXGI_FORMAT_R16G16_FLOAT,
+        .InitialState = D3D12_RESOURCE_STATE_RENDER_TARGET,
+        .Name = L"Velocity",
+    };
+
+    // Textures no pass of the frame uses never get a physical texture, every rendering mode can add them all.
+    FSceneTextureHandles Textures = {
+        .GBufferA = Graph.CreateTexture(GBufferADesc),
+        .GBufferB = Graph.CreateTexture(GBufferBDesc),
+        .GBufferC = Graph.CreateTexture(GBufferCDesc),
+        .Velocity = Graph.CreateTexture(VelocityTextureDesc),
+        .Depth = Graph.ImportTexture(DepthTexture.get()),
+        .PrevDepth = Graph.ImportTexture(PrevDepthTexture.get()),
+        .HDR = Graph.CreateTexture(HDRTextureDesc),
+        .LDR = Graph.CreateTexture(LDRTextureDesc),
+    };
+
+    // Copied to the back buffer after the graph.
+    Graph.ExportTexture(Textures.LDR);
+    return Textures;
+}
+
+void FRenderer::BindSceneTextures(const FRenderGraph& Graph, const FSceneTextureHandles& Textures)
+{
+    SceneTexture.GBufferA = Graph.GetTexture(Textures.GBufferA);
+    SceneTexture.GBufferB = Graph.GetTexture(Textures.GBufferB);
+    SceneTexture.GBufferC = Graph.GetTexture(Textures.GBufferC);
+    SceneTexture.VelocityTexture = Graph.GetTexture(Textures.Velocity);
+
+    SceneTexture.DepthTexture = Graph.GetTexture(Textures.Depth);
+    SceneTexture.PrevDepthTexture = Graph.GetTexture(Textures.PrevDepth);
+
+    SceneTexture.HDRTexture = Graph.GetTexture(Textures.HDR);
+    SceneTexture.LDRTexture = Graph.GetTexture(Textures.LDR);
 }
 
 void FRenderer::OnWindowResized(uint32_t InWidth, uint32_t InHeight)
@@ -373,19 +695,60 @@ void FRenderer::OnWindowResized(uint32_t InWidth, uint32_t InHeight)
     // ResizeSwapchainResources flushes the GPU. Do this before releasing any
     // scene or pass resources that may still be referenced by submitted work.
     RHIResizeSwapchainResources(InWidth, InHeight);
+    TransientTexturePool.ReleaseAll();
 
     Width = InWidth;
     Height = InHeight;
     InitSizeDependantResource(InWidth, InHeight);
 
-	for (auto& RenderPass : RenderPasses)
+	for (FLazyRenderPass* RenderPass : RenderPasses)
 	{
-		RenderPass->OnWindowResized(InWidth, InHeight);
+		RenderPass->SetSize(InWidth, InHeight);
 	}
 
     Editor->OnWindowResized(InWidth, InHeight);
 }
 
+void FRenderer::ReleaseIdleRenderPasses()
+{
+    const int IdleFrames = Scene->GetRenderSettings().RenderPassIdleReleaseFrames;
+    if (IdleFrames <= 0)
+    {
+        return;
+    }
+
+    // RHIBeginFrame waited for the frame FRAMES_IN_FLIGHT ago, a pass unused since then is not referenced by the GPU.
+    const uint32_t MinIdleFrames = max(static_cast<uint32_t>(IdleFrames), FRAMES_IN_FLIGHT);
+
+    bool bReleasedAny = false;
+    for (FLazyRenderPass* RenderPass : RenderPasses)
+    {
+        bReleasedAny |= RenderPass->ReleaseIfIdle(MinIdleFrames);
+    }
+    // Transient textures of a rendering mode no longer used, or of passes turned off.
+    bReleasedAny |= TransientTexturePool.ReleaseIfIdle(MinIdleFrames);
+
+    // The editor may hold a raw pointer to a debug texture of the released pass.
+    if (bReleasedAny)
+    {
+        Scene->GetRenderSettings().SelectedDebugTexture = nullptr;
+        Scene->GetRenderSettings().SelectedTextureIndex = 0;
+    }
+}
+
+std::vector<std::string> FRenderer::GetCreatedRenderPassNames() const
+{
+    std::vector<std::string> Names;
+    for (const FLazyRenderPass* RenderPass : RenderPasses)
+    {
+        if (RenderPass->IsCreated())
+        {
+            Names.push_back(RenderPass->GetName());
+        }
+    }
+    return Names;
+}
+
 void FRenderer::InitSizeDependantResource(uint32_t InWidth, uint32_t InHeight)
 {
     InitializeSceneTexture(InWidth, InHeight);
@@ -395,81 +758,28 @@ void FRenderer::InitializeSceneTexture(uint32_t InWidth, uint32_t InHeight)
 {
     FTextureCreationDesc DepthTextureDesc = {
         .Usage = ETextureUsage::DepthStencil,
-        .Width = Width,
-        .Height = Height,
+        .Width = InWidth,
+        .Height = InHeight,
         .Format = DXGI_FORMAT_D32_FLOAT,
         .InitialState = D3D12_RESOURCE_STATE_DEPTH_WRITE,
         .Name = L"Depth Texture",
     };
     FTextureCreationDesc PrevDepthTextureDesc = {
         .Usage = ETextureUsage::DepthStencil,
-        .Width = Width,
-        .Height = Height,
+        .Width = InWidth,
+        .Height = InHeight,
         .Format = DXGI_FORMAT_D32_FLOAT,
         .InitialState = D3D12_RESOURCE_STATE_DEPTH_WRITE,
         .Name = L"PrevDepth Texture",
     };
-    FTextureCreationDesc LDRTextureDesc{
-        .Usage = ETextureUsage::RenderTarget,
-        .Width = InWidth,
-        .Height = InHeight,
-        .Format = DXGI_FORMAT_R10G10B10A2_UNORM,
-        .InitialState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
-        .Name = L"LDR Texture",
-    };
 
-    FTextureCreationDesc GBufferADesc{
-        .Usage = ETextureUsage::RenderTarget,
-        .Width = InWidth,
-        .Height = InHeight,
-        .Format = DXGI_FORMAT_R8G8B8A8_UNORM,
-        .InitialState = D3D12_RESOURCE_STATE_RENDER_TARGET,
-        .Name = L"GBuffer A",
-    };
-    FTextureCreationDesc GBufferBDesc{
-        .Usage = ETextureUsage::RenderTarget,
-        .Width = InWidth,
-        .Height = InHeight,
-        .Format = DXGI_FORMAT_R16G16B16A16_FLOAT,
-        .InitialState = D3D12_RESOURCE_STATE_RENDER_TARGET,
-        .Name = L"GBuffer B",
-    };
-    FTextureCreationDesc GBufferCDesc{
-        .Usage = ETextureUsage::RenderTarget,
-        .Width = InWidth,
-        .Height = InHeight,
-        .Format = DXGI_FORMAT_R8G8B8A8_UNORM,
-        .InitialState = D3D12_RESOURCE_STATE_RENDER_TARGET,
-        .Name = L"GBuffer C",
-    };
-    FTextureCreationDesc HDRTextureDesc{
-        .Usage = ETextureUsage::RenderTarget,
-        .Width = InWidth,
-        .Height = InHeight,
-        .Format = DXGI_FORMAT_R16G16B16A16_FLOAT,
-        .InitialState = D3D12_RESOURCE_STATE_RENDER_TARGET,
-        .Name = L"HDR",
-    };
-    FTextureCreationDesc VelocityTextureDesc{
-        .Usage = ETextureUsage::RenderTarget,
-        .Width = InWidth,
-        .Height = InHeight,
-        .Format = DXGI_FORMAT_R16G16_FLOAT,
-        .InitialState = D3D12_RESOURCE_STATE_RENDER_TARGET,
-        .Name = L"Velocity",
-    };
-
-
-    SceneTexture.DepthTexture = RHICreateTexture(DepthTextureDesc);
-    SceneTexture.PrevDepthTexture = RHICreateTexture(PrevDepthTextureDesc);
+    DepthTexture = RHICreateTexture(DepthTextureDesc);
+    PrevDepthTexture = RHICreateTexture(PrevDepthTextureDesc);
 
-    SceneTexture.GBufferA = RHICreateTexture(GBufferADesc);
-    SceneTexture.GBufferB = RHICreateTexture(GBufferBDesc);
-    SceneTexture.GBufferC = RHICreateTexture(GBufferCDesc);
-    SceneTexture.VelocityTexture = RHICreateTexture(VelocityTextureDesc);
-
-    SceneTexture.LDRTexture = RHICreateTexture(LDRTextureDesc);
-    SceneTexture.HDRTexture = RHICreateTexture(HDRTextureDesc);
-
-    SceneTexture.Size = { InWidth, InHeight };
+    // The other scene textures are transient, created by the render graph of each frame.
+    SceneTexture = FSceneTexture{
+        .Size = { InWidth, InHeight },
+        .DepthTexture = DepthTexture.get(),
+        .PrevDepthTexture = PrevDepthTexture.get(),
+    };
 }
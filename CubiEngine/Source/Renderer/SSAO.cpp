@@ -73,17 +73,12 @@ void FSSAOPass::AddSSAOPass(FGraphicsContext* GraphicsContext, FScene* Scene, FS
 {
     SCOPED_NAMED_EVENT(GraphicsContext, SSAO);
 
-    GraphicsContext->AddResourceBarrier(SceneTexture.GBufferB.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(SceneTexture.DepthTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(SSAOTexture.get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-    GraphicsContext->ExecuteResourceBarriers();
-
     interlop::SSAORenderResource RenderResources = {
         .GBufferBIndex = SceneTexture.GBufferB->SrvIndex,
         .depthTextureIndex = SceneTexture.DepthTexture->SrvIndex,
         .dstTextureIndex = SSAOTexture->UavIndex,
         .SSAOKernelBufferIndex = SSAOKernelBuffer.CbvIndex,
-        .sceneBufferIndex = Scene->GetSceneBuffer().CbvIndex,
+        .sceneBufferIndex = Scene->GetSceneBufferCbv(),
         .frameCount = GFrameCount,
         .kernelSize = (uint)Scene->GetRenderSettings().SSAOKernelSize,
         .kernelRadius = Scene->GetRenderSettings().SSAOKernelRadius,
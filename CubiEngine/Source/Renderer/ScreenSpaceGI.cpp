@@ -202,33 +202,16 @@ void FScreenSpaceGIPass::InitSizeDependantResource(uint32_t InWidth, uint32_t In
     RHIGetDirectCommandQueue()->Flush();
 }
 
-void FScreenSpaceGIPass::AddPass(FGraphicsContext* GraphicsContext, FScene* Scene, FSceneTexture& SceneTexture)
-{
-    SCOPED_NAMED_EVENT(GraphicsContext, ScreenSpaceGI);
-
-    RaycastDiffuse(GraphicsContext, Scene, SceneTexture);
-    Denoise(GraphicsContext, Scene, SceneTexture);
-    Resolve(GraphicsContext, Scene, SceneTexture);
-    UpdateHistory(GraphicsContext, Scene);
-    CompositionSSGI(GraphicsContext, Scene, SceneTexture);
-}
-
 void FScreenSpaceGIPass::RaycastDiffuse(FGraphicsContext* const GraphicsContext, FScene* Scene, FSceneTexture& SceneTexture)
 {
     SCOPED_NAMED_EVENT(GraphicsContext, RaycastDiffuse);
 
-    GraphicsContext->AddResourceBarrier(SceneTexture.HDRTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(SceneTexture.DepthTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(StochasticNormalTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(ScreenSpaceGITexture.get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-    GraphicsContext->ExecuteResourceBarriers();
-    
     interlop::RaycastDiffuseRenderResource RenderResources = {
         .sceneColorTextureIndex = SceneTexture.HDRTexture->SrvIndex,
         .depthTextureIndex = SceneTexture.DepthTexture->SrvIndex,
         .GBufferBTextureIndex = SceneTexture.GBufferB->SrvIndex,
         .dstTextureIndex = ScreenSpaceGITexture->UavIndex,
-        .sceneBufferIndex = Scene->GetSceneBuffer().CbvIndex,
+        .sceneBufferIndex = Scene->GetSceneBufferCbv(),
         .width = SceneTexture.Size.Width,
         .height = SceneTexture.Size.Height,
         .rayLength = Scene->GetRenderSettings().SSGIRayLength,
@@ -250,76 +233,27 @@ void FScreenSpaceGIPass::RaycastDiffuse(FGraphicsContext* const GraphicsContext,
     1);
 }
 
-void FScreenSpaceGIPass::Denoise(FGraphicsContext* const GraphicsContext, FScene* Scene, FSceneTexture& SceneTexture)
+void FScreenSpaceGIPass::DownSample(FGraphicsContext* const GraphicsContext, FTexture* Src, FTexture* Dst)
 {
-    SCOPED_NAMED_EVENT(GraphicsContext, Denoise);
-    {
-        GraphicsContext->AddResourceBarrier(ScreenSpaceGITexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-        GraphicsContext->AddResourceBarrier(HalfTexture.get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-        GraphicsContext->ExecuteResourceBarriers();
-
-        interlop::DownSampleRenderResource RenderResources = {
-            .srcTextureIndex = ScreenSpaceGITexture->SrvIndex,
-            .dstTextureIndex = HalfTexture->UavIndex,
-            .dstTexelSize = {1.0f / HalfTexture->Width, 1.0f / HalfTexture->Height},
-        };
-
-        GraphicsContext->SetComputePipelineState(SSGIDownSamplePipelineState);
-        GraphicsContext->SetComputeRoot32BitConstants(&RenderResources);
-
-        // shader (8,8,1)
-        GraphicsContext->Dispatch(
-            max((uint32_t)std::ceil(SceneTexture.Size.Width / 8.0f), 1u),
-            max((uint32_t)std::ceil(SceneTexture.Size.Height / 8.0f), 1u),
-        1);
-    }
-    {
-        GraphicsContext->AddResourceBarrier(HalfTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-        GraphicsContext->AddResourceBarrier(QuarterTexture.get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-        GraphicsContext->ExecuteResourceBarriers();
-
-        interlop::DownSampleRenderResource RenderResources = {
-            .srcTextureIndex = HalfTexture->SrvIndex,
-            .dstTextureIndex = QuarterTexture->UavIndex,
-            .dstTexelSize = {1.0f / QuarterTexture->Width, 1.0f / QuarterTexture->Height},
-        };
-
-        GraphicsContext->SetComputePipelineState(SSGIDownSamplePipelineState);
-        GraphicsContext->SetComputeRoot32BitConstants(&RenderResources);
-
-        // shader (8,8,1)
-        GraphicsContext->Dispatch(
-            max((uint32_t)std::ceil(QuarterTexture->Width / 8.0f), 1u),
-            max((uint32_t)std::ceil(QuarterTexture->Height / 8.0f), 1u),
-        1);
-    }
+    SCOPED_NAMED_EVENT(GraphicsContext, SSGIDownSample);
 
-    DenoiseGaussianBlur(GraphicsContext, Scene, SceneTexture);
+    interlop::DownSampleRenderResource RenderResources = {
+        .srcTextureIndex = Src->SrvIndex,
+        .dstTextureIndex = Dst->UavIndex,
+        .dstTexelSize = {1.0f / Dst->Width, 1.0f / Dst->Height},
+    };
 
-    {
-        GraphicsContext->AddResourceBarrier(QuarterTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-        GraphicsContext->AddResourceBarrier(DenoisedScreenSpaceGITexture.get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-        GraphicsContext->ExecuteResourceBarriers();
-
-        interlop::UpSampleResource RenderResources = {
-            .srcTextureIndex = QuarterTexture->SrvIndex,
-            .dstTextureIndex = DenoisedScreenSpaceGITexture->UavIndex,
-            .dstTexelSize = {1.0f / DenoisedScreenSpaceGITexture->Width, 1.0f / DenoisedScreenSpaceGITexture->Height},
-        };
-
-        GraphicsContext->SetComputePipelineState(SSGIUpSamplePipelineState);
-        GraphicsContext->SetComputeRoot32BitConstants(&RenderResources);
-
-        // shader (8,8,1)
-        GraphicsContext->Dispatch(
-            max((uint32_t)std::ceil(DenoisedScreenSpaceGITexture->Width / 8.0f), 1u),
-            max((uint32_t)std::ceil(DenoisedScreenSpaceGITexture->Height / 8.0f), 1u),
-        1);
-    }
+    GraphicsContext->SetComputePipelineState(SSGIDownSamplePipelineState);
+    GraphicsContext->SetComputeRoot32BitConstants(&RenderResources);
 
+    // shader (8,8,1)
+    GraphicsContext->Dispatch(
+        max((uint32_t)std::ceil(Dst->Width / 8.0f), 1u),
+        max((uint32_t)std::ceil(Dst->Height / 8.0f), 1u),
+    1);
 }
 
-void FScreenSpaceGIPass::DenoiseGaussianBlur(FGraphicsContext* const GraphicsContext, FScene* Scene, FSceneTexture& SceneTexture)
+void FScreenSpaceGIPass::GaussianBlur(FGraphicsContext* const GraphicsContext, FScene* Scene, FTexture* Src, FTexture* Dst, bool bHorizontal)
 {
     SCOPED_NAMED_EVENT(GraphicsContext, DenoiseGaussianBlur);
 
@@ -329,82 +263,57 @@ void FScreenSpaceGIPass::DenoiseGaussianBlur(FGraphicsContext* const GraphicsCon
 
     CreateGaussianBlurWeight(GaussianBlurWeight, KernelSize, StdDev);
 
+    interlop::GaussianBlurWRenderResource RenderResources = {
+        .srcTextureIndex = Src->SrvIndex,
+        .dstTextureIndex = Dst->UavIndex,
+        .dstTexelSize = {1.0f / Dst->Width, 1.0f / Dst->Height},
+        .additiveTextureIndex = INVALID_INDEX_U32,
+        .bHorizontal = bHorizontal ? 1u : 0u,
+        .kernelSize = (uint)KernelSize,
+    };
+    for (int i = 0; i < MAX_GAUSSIAN_KERNEL_SIZE / 4; i++)
     {
-        GraphicsContext->AddResourceBarrier(QuarterTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-        GraphicsContext->AddResourceBarrier(BlurXTexture.get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-        GraphicsContext->ExecuteResourceBarriers();
-        
-        interlop::GaussianBlurWRenderResource RenderResources = {
-            .srcTextureIndex = QuarterTexture->SrvIndex,
-            .dstTextureIndex = BlurXTexture->UavIndex,
-            .dstTexelSize = {1.0f / BlurXTexture->Width, 1.0f / BlurXTexture->Height},
-            .additiveTextureIndex = INVALID_INDEX_U32,
-            .bHorizontal = 1,
-            .kernelSize = (uint)KernelSize,
-        };
-        for (int i = 0; i < MAX_GAUSSIAN_KERNEL_SIZE / 4; i++)
-        {
-            RenderResources.weights[i] = XMFLOAT4(GaussianBlurWeight[i * 4],
-                GaussianBlurWeight[i * 4 + 1],
-                GaussianBlurWeight[i * 4 + 2],
-                GaussianBlurWeight[i * 4 + 3]
-            );
-        }
-
-        GraphicsContext->SetComputePipelineState(SSGIGaussianBlurWPipelineState);
-        GraphicsContext->SetComputeRoot32BitConstants(&RenderResources);
-
-        // shader (8,8,1)
-        GraphicsContext->Dispatch(
-            max((uint32_t)std::ceil(BlurXTexture->Width / 8.0f), 1u),
-            max((uint32_t)std::ceil(BlurXTexture->Height / 8.0f), 1u),
-        1);
-    }
-    {
-        GraphicsContext->AddResourceBarrier(BlurXTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-        GraphicsContext->AddResourceBarrier(QuarterTexture.get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-        GraphicsContext->ExecuteResourceBarriers();
-        
-        interlop::GaussianBlurWRenderResource RenderResources = {
-            .srcTextureIndex = BlurXTexture->SrvIndex,
-            .dstTextureIndex = QuarterTexture->UavIndex,
-            .dstTexelSize = {1.0f / QuarterTexture->Width, 1.0f / QuarterTexture->Height},
-            .additiveTextureIndex = INVALID_INDEX_U32,
-            .bHorizontal = 0,
-            .kernelSize = (uint)KernelSize,
-        };
-        for (int i = 0; i < MAX_GAUSSIAN_KERNEL_SIZE / 4; i++)
-        {
-            RenderResources.weights[i] = XMFLOAT4(GaussianBlurWeight[i * 4],
-                GaussianBlurWeight[i * 4 + 1],
-                GaussianBlurWeight[i * 4 + 2],
-                GaussianBlurWeight[i * 4 + 3]
-            );
-        }
-
-        GraphicsContext->SetComputePipelineState(SSGIGaussianBlurWPipelineState);
-        GraphicsContext->SetComputeRoot32BitConstants(&RenderResources);
-
-        // shader (8,8,1)
-        GraphicsContext->Dispatch(
-            max((uint32_t)std::ceil(QuarterTexture->Width / 8.0f), 1u),
-            max((uint32_t)std::ceil(QuarterTexture->Height / 8.0f), 1u),
-        1);
+        RenderResources.weights[i] = XMFLOAT4(GaussianBlurWeight[i * 4],
+            GaussianBlurWeight[i * 4 + 1],
+            GaussianBlurWeight[i * 4 + 2],
+            GaussianBlurWeight[i * 4 + 3]
+        );
     }
+
+    GraphicsContext->SetComputePipelineState(SSGIGaussianBlurWPipelineState);
+    GraphicsContext->SetComputeRoot32BitConstants(&RenderResources);
+
+    // shader (8,8,1)
+    GraphicsContext->Dispatch(
+        max((uint32_t)std::ceil(Dst->Width / 8.0f), 1u),
+        max((uint32_t)std::ceil(Dst->Height / 8.0f), 1u),
+    1);
+}
+
+void FScreenSpaceGIPass::UpSample(FGraphicsContext* const GraphicsContext, FTexture* Src, FTexture* Dst)
+{
+    SCOPED_NAMED_EVENT(GraphicsContext, SSGIUpSample);
+
+    interlop::UpSampleResource RenderResources = {
+        .srcTextureIndex = Src->SrvIndex,
+        .dstTextureIndex = Dst->UavIndex,
+        .dstTexelSize = {1.0f / Dst->Width, 1.0f / Dst->Height},
+    };
+
+    GraphicsContext->SetComputePipelineState(SSGIUpSamplePipelineState);
+    GraphicsContext->SetComputeRoot32BitConstants(&RenderResources);
+
+    // shader (8,8,1)
+    GraphicsContext->Dispatch(
+        max((uint32_t)std::ceil(Dst->Width / 8.0f), 1u),
+        max((uint32_t)std::ceil(Dst->Height / 8.0f), 1u),
+    1);
 }
 
 void FScreenSpaceGIPass::Resolve(FGraphicsContext* const GraphicsContext, FScene* Scene, FSceneTexture& SceneTexture)
 {
     SCOPED_NAMED_EVENT(GraphicsContext, ResolveSSGI);
 
-    GraphicsContext->AddResourceBarrier(DenoisedScreenSpaceGITexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(HistoryTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(SceneTexture.VelocityTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(SceneTexture.PrevDepthTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(SceneTexture.DepthTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(ResolveTexture.get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-    GraphicsContext->ExecuteResourceBarriers();
-
     interlop::SSGIResolveRenderResource RenderResources = {
         .denoisedTextureIndex = DenoisedScreenSpaceGITexture->SrvIndex,
         .historyTextureIndex = HistoryTexture->SrvIndex,
@@ -413,7 +322,7 @@ void FScreenSpaceGIPass::Resolve(FGraphicsContext* const GraphicsContext, FScene
         .depthTextureIndex = SceneTexture.DepthTexture->SrvIndex,
         .dstTextureIndex = ResolveTexture->UavIndex,
         .numFramesAccumulatedTextureIndex = HistroyNumFrameAccumulated->UavIndex,
-        .sceneBufferIndex = Scene->GetSceneBuffer().CbvIndex,
+        .sceneBufferIndex = Scene->GetSceneBufferCbv(),
         .dstTexelSize = {1.0f / ResolveTexture->Width, 1.0f / ResolveTexture->Height},
         .maxHistoryFrame = (uint)Scene->GetRenderSettings().MaxHistoryFrame,
     };
@@ -432,10 +341,6 @@ void FScreenSpaceGIPass::UpdateHistory(FGraphicsContext* const GraphicsContext,
 {
     SCOPED_NAMED_EVENT(GraphicsContext, SSGI_UpdateHistory);
 
-    GraphicsContext->AddResourceBarrier(ResolveTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(HistoryTexture.get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-    GraphicsContext->ExecuteResourceBarriers();
-
     interlop::SSGIUpdateHistoryRenderResource RenderResources = {
         .resolveTextureIndex = ResolveTexture->SrvIndex,
         .historyTextureIndex = HistoryTexture->UavIndex,
@@ -458,11 +363,6 @@ void FScreenSpaceGIPass::CompositionSSGI(FGraphicsContext* const GraphicsContext
 {
     SCOPED_NAMED_EVENT(GraphicsContext, CompositionSSGI);
 
-    GraphicsContext->AddResourceBarrier(ResolveTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(SceneTexture.GBufferA.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(SceneTexture.HDRTexture.get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-    GraphicsContext->ExecuteResourceBarriers();
-
     interlop::CompositionSSGIRenderResource RenderResources = {
         .resolveTextureIndex = ResolveTexture->SrvIndex,
         .gbufferAIndex = SceneTexture.GBufferA->SrvIndex,
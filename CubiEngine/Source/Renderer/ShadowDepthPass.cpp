@@ -41,6 +41,19 @@ FShadowDepthPass::FShadowDepthPass(uint32_t Width, uint32_t Height)
     };
 
     ShadowDepthPassPipelineState = RHICreatePipelineState(ShadowDepthPassPipelineStateDesc);
+
+    FGraphicsPipelineStateCreationDesc ShadowDepthPassIndirectPipelineStateDesc{
+        .ShaderModule =
+            {
+                .vertexShaderPath = L"Shaders/RenderPass/ShadowDepthPassIndirect.hlsl",
+                .pixelShaderPath = L"Shaders/RenderPass/ShadowDepthPassIndirect.hlsl",
+            },
+        .RtvFormats = {},
+        .RtvCount = 0,
+        .PipelineName = L"ShadowDepthPass Indirect Pipeline",
+    };
+
+    ShadowDepthPassIndirectPipelineState = RHICreatePipelineState(ShadowDepthPassIndirectPipelineStateDesc);
     
 
     FGraphicsPipelineStateCreationDesc VSMShadowDepthPassPipelineStateDesc{
@@ -95,8 +108,10 @@ void FShadowDepthPass::Render(FGraphicsContext* GraphicsContext, FScene* Scene)
     }
     else
     {
+        // VSM still draws directly, its moment shader has no indirect variant.
         GraphicsContext->SetRenderTargetDepthOnly(ShadowDepthTexture.get());
-        GraphicsContext->SetGraphicsPipelineState(ShadowDepthPassPipelineState);
+        GraphicsContext->SetGraphicsPipelineState(Scene->GetRenderSettings().bUseIndirectDraw
+            ? ShadowDepthPassIndirectPipelineState : ShadowDepthPassPipelineState);
     }
 
     GraphicsContext->SetViewport(D3D12_VIEWPORT{
@@ -118,11 +133,7 @@ void FShadowDepthPass::Render(FGraphicsContext* GraphicsContext, FScene* Scene)
 
     if (GNumCascadeShadowMap == 1)
     {
-        interlop::ShadowDepthPassRenderResource RenderResources{
-            .lightViewProjectionMatrix = Scene->Light.ShadowBufferData.lightViewProjectionMatrix[0],
-        };
-
-        Scene->RenderModels(GraphicsContext, RenderResources);
+        RenderCascade(GraphicsContext, Scene, 0);
     }
     else
     {
@@ -157,15 +168,31 @@ void FShadowDepthPass::Render(FGraphicsContext* GraphicsContext, FScene* Scene)
             //scissorRect.bottom = static_cast<LONG>(ShadowDepthTexture->Height);
             GraphicsContext->SetScissorRects(scissorRect);
 
-            interlop::ShadowDepthPassRenderResource RenderResources{
-                .lightViewProjectionMatrix = Scene->Light.ShadowBufferData.lightViewProjectionMatrix[CascadeIndex],
-            };
-
-            Scene->RenderModels(GraphicsContext, RenderResources);
+            RenderCascade(GraphicsContext, Scene, CascadeIndex);
         }
     }
 }
 
+void FShadowDepthPass::RenderCascade(FGraphicsContext* GraphicsContext, FScene* Scene, int CascadeIndex)
+{
+    if (Scene->GetRenderSettings().bUseIndirectDraw && !Scene->GetRenderSettings().bUseVSM)
+    {
+        interlop::ShadowDepthPassIndirectRenderResource RenderResources{
+            .lightViewProjectionMatrix = Scene->GetFrameSnapshot().ShadowBufferData.lightViewProjectionMatrix[CascadeIndex],
+        };
+
+        Scene->RenderModels(GraphicsContext, RenderResources);
+    }
+    else
+    {
+        interlop::ShadowDepthPassRenderResource RenderResources{
+            .lightViewProjectionMatrix = Scene->GetFrameSnapshot().ShadowBufferData.lightViewProjectionMatrix[CascadeIndex],
+        };
+
+        Scene->RenderModels(GraphicsContext, RenderResources);
+    }
+}
+
 void FShadowDepthPass::AddVSMPassCS(FGraphicsContext* GraphicsContext, FScene* Scene)
 {
     // this pass is not used currently.
@@ -61,11 +61,6 @@ void FTemporalAAPass::Resolve(FGraphicsContext* const GraphicsContext, FScene* S
 {
     SCOPED_NAMED_EVENT(GraphicsContext, TemporalAAResolve);
 
-    GraphicsContext->AddResourceBarrier(SceneTexture.HDRTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(SceneTexture.VelocityTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(HistoryTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->ExecuteResourceBarriers();
-
     interlop::TemporalAAResolveRenderResource RenderResources = {
         .sceneTextureIndex = SceneTexture.HDRTexture->SrvIndex,
         .historyTextureIndex = HistoryTexture->SrvIndex,
@@ -89,10 +84,6 @@ void FTemporalAAPass::UpdateHistory(FGraphicsContext* const GraphicsContext, FSc
 {
     SCOPED_NAMED_EVENT(GraphicsContext, TemporalAAUpdateHistory);
 
-    GraphicsContext->AddResourceBarrier(ResolveTexture.get(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-    GraphicsContext->AddResourceBarrier(HistoryTexture.get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-    GraphicsContext->ExecuteResourceBarriers();
-
     interlop::TemporalAAUpdateHistoryRenderResource RenderResources = {
         .resolveTextureIndex = ResolveTexture->SrvIndex,
         .historyTextureIndex = HistoryTexture->UavIndex,
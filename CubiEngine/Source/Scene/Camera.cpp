@@ -50,8 +50,9 @@ FCamera::FCamera(uint32_t Width, uint32_t Height)
     UpdateMatrix(false);
 }
 
-void FCamera::Update(float DeltaTime, FInput* Input, uint32_t Width, uint32_t Height, bool bApplyTAAJitter, float CSMExponentialFactor)
+void FCamera::Update(float DeltaTime, FInput* Input, uint32_t Width, uint32_t Height, bool bApplyTAAJitter, float CSMExponentialFactor, uint32_t FrameIndex)
 {
+    this->FrameIndex = FrameIndex;
     CamPositionXMV = XMLoadFloat4(&CamPosition);
 
     AspectRatio = static_cast<float>(Width) / Height;
@@ -142,7 +143,7 @@ void FCamera::UpdateMatrix(bool bApplyTAAJitter)
     
     if (bApplyTAAJitter)
     {
-        XMFLOAT2 JitterOffset_Current = GetHaltonJitterOffset(GFrameCount, Width, Height);
+        XMFLOAT2 JitterOffset_Current = GetHaltonJitterOffset(FrameIndex, Width, Height);
 
         XMMATRIX JitterMatrix = {
             1.0f,  0.0f,  0.0f, 0.0f,
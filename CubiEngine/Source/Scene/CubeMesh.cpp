@@ -64,58 +64,24 @@ FCubeMesh::FCubeMesh(FMeshCreationDesc MeshCreationDesc)
 		20,22,21,  20,23,22    // Left
 	};
 
-	PositionBuffer = RHICreateBuffer<XMFLOAT3>(
-		FBufferCreationDesc{
-			.Usage = EBufferUsage::StructuredBuffer,
-			.Name = Name + L" position buffer",
-		},
-		Positions);
-
-	TextureCoordsBuffer = RHICreateBuffer<XMFLOAT2>(
-		FBufferCreationDesc{
-			.Usage = EBufferUsage::StructuredBuffer,
-			.Name = Name + L" texture coord buffer",
-		},
-		TextureCoords);
-
-	NormalBuffer = RHICreateBuffer<XMFLOAT3>(
-		FBufferCreationDesc{
-			.Usage = EBufferUsage::StructuredBuffer,
-			.Name = Name + L" normal buffer",
-		},
-		Normals);
-
-	TangentBuffer = RHICreateBuffer<XMFLOAT3>( // Add tangent buffer creation
-		FBufferCreationDesc{
-			.Usage = EBufferUsage::StructuredBuffer,
-			.Name = Name + L" tangent buffer",
-		},
-		Tangents);
-
-	IndexBuffer = RHICreateBuffer<UINT>(
-		FBufferCreationDesc{
-			.Usage = EBufferUsage::StructuredBuffer,
-			.Name = Name + L" index buffer",
-		},
-		Indice);
-	IndicesCount = static_cast<uint32_t>(Indice.size());
+	SetGeometry(FGeometryData{
+		.Positions = Positions,
+		.TextureCoords = TextureCoords,
+		.Normals = Normals,
+		.Tangents = Tangents,
+		.Indices = Indice,
+	}, Name);
+	SetCPUGeometry(Positions, Indice);
 
 	Material = std::make_shared<FPBRMaterial>();
-	Material->MaterialBuffer = RHICreateBuffer<interlop::MaterialBuffer>(FBufferCreationDesc{
-		.Usage = EBufferUsage::ConstantBuffer,
-		.Name = Name + L"_MaterialBuffer",
-	});
-
-	Material->MaterialBufferData = {
+	Material->SetParameters(interlop::MaterialData{
 		.albedoColor = MeshCreationDesc.BaseColorValue,
 		.roughnessFactor = MeshCreationDesc.RoughnessValue,
 		.metallicFactor = MeshCreationDesc.MetallicValue,
 		.emissiveColor = MeshCreationDesc.EmissiveValue,
 		.refractionFactor = MeshCreationDesc.RefractionFactor,
 		.IOR = MeshCreationDesc.IOR
-	};
-
-	Material->MaterialBuffer.Update(&Material->MaterialBufferData);
+	});
 
 	FGraphicsContext* GraphicsContext = RHIGetCurrentGraphicsContext();
 	GraphicsContext->Reset();
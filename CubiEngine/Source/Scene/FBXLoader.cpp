@@ -130,23 +130,18 @@ void FFBXLoader::LoadMaterials(const aiScene* Scene)
         LoadTexture(material, ORMName, aiTextureType_SPECULAR, DXGI_FORMAT_UNKNOWN, PbrMaterial->ORMTexture, PbrMaterial->ORMSampler);
 
 
-        PbrMaterial->MaterialBuffer = RHICreateBuffer<interlop::MaterialBuffer>(FBufferCreationDesc{
-            .Usage = EBufferUsage::ConstantBuffer,
-            .Name = StringToWString(PbrMaterial->Name) + L"_MaterialBuffer",
-		});
-
+        interlop::MaterialData Parameters{};
         aiColor4D baseColor(1.0f, 1.0f, 1.0f, 1.0f); 
         if (material->Get(AI_MATKEY_BASE_COLOR, baseColor) == AI_SUCCESS)
         {
-            PbrMaterial->MaterialBufferData = {
+            Parameters = {
 				.albedoColor = XMFLOAT3 { baseColor.r, baseColor.g, baseColor.b },
                 .roughnessFactor = 1.0f,
                 .metallicFactor = 1.0f,
             };
         }
 
-        PbrMaterial->MaterialBuffer.Update(&PbrMaterial->MaterialBufferData);
-        PbrMaterial->MaterialIndex = materialIndex;
+        PbrMaterial->SetParameters(Parameters);
 
 		Materials.push_back(PbrMaterial);
 	}
@@ -230,43 +225,15 @@ void FFBXLoader::LoadMeshes(const aiScene* Scene, const FModelCreationDesc& Mode
             }
         }
 
-        ResultMesh->IndicesCount = static_cast<uint32_t>(Indice.size());
-
-        ResultMesh->PositionBuffer = RHICreateBuffer<XMFLOAT3>(
-            FBufferCreationDesc{
-                .Usage = EBufferUsage::StructuredBuffer,
-                .Name = MeshName + L" position buffer",
-            },
-            Positions);
-
-        ResultMesh->TextureCoordsBuffer = RHICreateBuffer<XMFLOAT2>(
-            FBufferCreationDesc{
-                .Usage = EBufferUsage::StructuredBuffer,
-                .Name = MeshName + L" texture coord buffer",
-            },
-            TextureCoords);
-
-        ResultMesh->NormalBuffer = RHICreateBuffer<XMFLOAT3>(
-            FBufferCreationDesc{
-                .Usage = EBufferUsage::StructuredBuffer,
-                .Name = MeshName + L" normal buffer",
-            },
-            Normals);
-
-        ResultMesh->TangentBuffer = RHICreateBuffer<XMFLOAT3>( // Add tangent buffer creation
-            FBufferCreationDesc{
-                .Usage = EBufferUsage::StructuredBuffer,
-                .Name = MeshName + L" tangent buffer",
-            },
-            Tangents);
-
-        ResultMesh->IndexBuffer = RHICreateBuffer<UINT>(
-            FBufferCreationDesc{
-                .Usage = EBufferUsage::StructuredBuffer,
-                .Name = MeshName + L" index buffer",
-            },
-            Indice);
+        ResultMesh->SetGeometry(FGeometryData{
+            .Positions = Positions,
+            .TextureCoords = TextureCoords,
+            .Normals = Normals,
+            .Tangents = Tangents,
+            .Indices = Indice,
+        }, MeshName);
 
+        ResultMesh->SetCPUGeometry(Positions, Indice);
         ResultMesh->Material = Materials[mesh->mMaterialIndex];
 		ResultMesh->Transform.Set(ModelCreationDesc.Rotation, ModelCreationDesc.Scale, ModelCreationDesc.Translate);
 
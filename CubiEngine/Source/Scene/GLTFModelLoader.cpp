@@ -48,6 +48,7 @@ FGLTFModelLoader::FGLTFModelLoader(const FModelCreationDesc& ModelCreationDesc)
 
     FTransform ModelTransform;
     ModelTransform.Set(ModelCreationDesc.Rotation, ModelCreationDesc.Scale, ModelCreationDesc.Translate);
+    const uint32_t RootTransformNode = TransformHierarchy.AddNode(FTransformHierarchy::INVALID_NODE, ModelTransform.GetModelMatrix());
 
     // RHI resource creation and the loader's output vectors are not independent;
     // preserve their dependency order instead of racing materials against samplers.
@@ -65,14 +66,35 @@ FGLTFModelLoader::FGLTFModelLoader(const FModelCreationDesc& ModelCreationDesc)
         FatalError("glTF default scene index is out of range.");
     }
 
+    // Walk breadth first so every transform node lands after its parent.
+    std::queue<std::pair<int, uint32_t>> PendingNodes;
     const tinygltf::Scene& Scene = GLTFModel.scenes[SceneIndex];
     for (const int NodeIndex : Scene.nodes)
     {
+        PendingNodes.emplace(NodeIndex, RootTransformNode);
+    }
+
+    while (!PendingNodes.empty())
+    {
+        const auto [NodeIndex, ParentTransformNode] = PendingNodes.front();
+        PendingNodes.pop();
+
         if (NodeIndex < 0)
         {
-            FatalError("glTF scene contains an invalid node index.");
+            FatalError("glTF model contains an invalid node index.");
+        }
+
+        const uint32_t TransformNode = LoadNode(static_cast<uint32_t>(NodeIndex), GLTFModel, ParentTransformNode);
+        for (const int ChildIndex : GLTFModel.nodes[NodeIndex].children)
+        {
+            PendingNodes.emplace(ChildIndex, TransformNode);
         }
-        LoadNode(static_cast<uint32_t>(NodeIndex), GLTFModel, ModelTransform);
+    }
+
+    TransformHierarchy.Update();
+    for (size_t MeshIndex = 0; MeshIndex < Meshes.size(); MeshIndex++)
+    {
+        Meshes[MeshIndex]->Transform.SetMatrix(TransformHierarchy.GetWorldMatrix(MeshTransformNodes[MeshIndex]));
     }
 
     FGraphicsContext* GraphicsContext = RHIGetCurrentGraphicsContext();
@@ -389,12 +411,7 @@ void FGLTFModelLoader::LoadMaterials(const tinygltf::Model& GLTFModel)
         }
         PbrMaterial->AlphaCutoff = material.alphaCutoff;
 
-        PbrMaterial->MaterialBuffer = RHICreateBuffer<interlop::MaterialBuffer>(FBufferCreationDesc{
-            .Usage = EBufferUsage::ConstantBuffer,
-            .Name = ModelName + L"_MaterialBuffer" + std::to_wstring(index),
-        });
-
-        PbrMaterial->MaterialBufferData = {
+        PbrMaterial->SetParameters(interlop::MaterialData{
                 .albedoColor = bOverrideBaseColor ? OverrideBaseColorValue :
                 XMFLOAT3 {
                     (float)material.pbrMetallicRoughness.baseColorFactor[0],
@@ -409,28 +426,20 @@ void FGLTFModelLoader::LoadMaterials(const tinygltf::Model& GLTFModel)
                     static_cast<float>(material.emissiveFactor[2])},
                 .refractionFactor = ModelCreationDesc.RefractionFactor,
                 .IOR = ModelCreationDesc.IOR,
-        };
+        });
 
-        PbrMaterial->MaterialBuffer.Update(&PbrMaterial->MaterialBufferData);
-        PbrMaterial->MaterialIndex = index;
         Materials[index++] = PbrMaterial;
     }
 
     DefaultMaterial = std::make_shared<FPBRMaterial>();
-    DefaultMaterial->MaterialBuffer = RHICreateBuffer<interlop::MaterialBuffer>(FBufferCreationDesc{
-        .Usage = EBufferUsage::ConstantBuffer,
-        .Name = ModelName + L"_DefaultMaterialBuffer",
-    });
-    DefaultMaterial->MaterialBufferData = {
+    DefaultMaterial->SetParameters(interlop::MaterialData{
         .albedoColor = OverrideBaseColorValue.x >= 0.0f ? OverrideBaseColorValue : XMFLOAT3{ 1.0f, 1.0f, 1.0f },
         .roughnessFactor = OverrideRoughnessValue >= 0.0f ? OverrideRoughnessValue : 1.0f,
         .metallicFactor = OverrideMetallicValue >= 0.0f ? OverrideMetallicValue : 0.0f,
         .emissiveColor = OverrideEmissiveValue.x >= 0.0f ? OverrideEmissiveValue : XMFLOAT3{ 0.0f, 0.0f, 0.0f },
         .refractionFactor = ModelCreationDesc.RefractionFactor,
         .IOR = ModelCreationDesc.IOR,
-    };
-    DefaultMaterial->MaterialBuffer.Update(&DefaultMaterial->MaterialBufferData);
-    DefaultMaterial->MaterialIndex = static_cast<uint32_t>(Materials.size());
+    });
     DefaultMaterial->AlphaMode = EAlphaMode::Opaque;
     DefaultMaterial->AlphaCutoff = 0.5;
     Materials.push_back(DefaultMaterial);
@@ -604,7 +613,7 @@ namespace
     }
 }
 
-void FGLTFModelLoader::LoadNode(uint32_t NodeIndex, const tinygltf::Model& GLTFModel, const FTransform& ParentTransform)
+uint32_t FGLTFModelLoader::LoadNode(uint32_t NodeIndex, const tinygltf::Model& GLTFModel, uint32_t ParentTransformNode)
 {
     if (NodeIndex >= GLTFModel.nodes.size())
     {
@@ -612,7 +621,7 @@ void FGLTFModelLoader::LoadNode(uint32_t NodeIndex, const tinygltf::Model& GLTFM
     }
     const tinygltf::Node& Node = GLTFModel.nodes[NodeIndex];
 
-    FTransform LocalTransform;
+    uint32_t TransformNode;
     if (!Node.matrix.empty())
     {
         if (Node.matrix.size() != 16u)
@@ -621,7 +630,7 @@ void FGLTFModelLoader::LoadNode(uint32_t NodeIndex, const tinygltf::Model& GLTFM
         }
         // glTF stores column-major matrices for column vectors. Feeding each
         // consecutive column as a DirectX row yields the row-vector equivalent.
-        LocalTransform.SetMatrix(XMMATRIX(
+        TransformNode = TransformHierarchy.AddNode(ParentTransformNode, XMMATRIX(
             static_cast<float>(Node.matrix[0]), static_cast<float>(Node.matrix[1]), static_cast<float>(Node.matrix[2]), static_cast<float>(Node.matrix[3]),
             static_cast<float>(Node.matrix[4]), static_cast<float>(Node.matrix[5]), static_cast<float>(Node.matrix[6]), static_cast<float>(Node.matrix[7]),
             static_cast<float>(Node.matrix[8]), static_cast<float>(Node.matrix[9]), static_cast<float>(Node.matrix[10]), static_cast<float>(Node.matrix[11]),
@@ -642,19 +651,13 @@ void FGLTFModelLoader::LoadNode(uint32_t NodeIndex, const tinygltf::Model& GLTFM
         const XMFLOAT3 Translation = Node.translation.size() == 3u
             ? XMFLOAT3{ static_cast<float>(Node.translation[0]), static_cast<float>(Node.translation[1]), static_cast<float>(Node.translation[2]) }
             : XMFLOAT3{ 0.0f, 0.0f, 0.0f };
-        const XMVECTOR Rotation = Node.rotation.size() == 4u
-            ? XMVectorSet(static_cast<float>(Node.rotation[0]), static_cast<float>(Node.rotation[1]),
-                static_cast<float>(Node.rotation[2]), static_cast<float>(Node.rotation[3]))
-            : XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
-
-        LocalTransform.SetMatrix(
-            Dx::XMMatrixScalingFromVector(XMLoadFloat3(&Scale)) *
-            Dx::XMMatrixRotationQuaternion(Rotation) *
-            Dx::XMMatrixTranslationFromVector(XMLoadFloat3(&Translation)));
-    }
+        const XMFLOAT4 Rotation = Node.rotation.size() == 4u
+            ? XMFLOAT4{ static_cast<float>(Node.rotation[0]), static_cast<float>(Node.rotation[1]),
+                static_cast<float>(Node.rotation[2]), static_cast<float>(Node.rotation[3]) }
+            : XMFLOAT4{ 0.0f, 0.0f, 0.0f, 1.0f };
 
-    // CubiEngine uses row vectors: local transforms precede their parent.
-    const FTransform NodeTransform = LocalTransform.Multiply(ParentTransform);
+        TransformNode = TransformHierarchy.AddNode(ParentTransformNode, Translation, Rotation, Scale);
+    }
 
     if (Node.mesh >= 0)
     {
@@ -809,24 +812,19 @@ void FGLTFModelLoader::LoadNode(uint32_t NodeIndex, const tinygltf::Model& GLTFM
 
             std::unique_ptr<FMesh> Mesh = std::make_unique<FMesh>();
             const std::wstring MeshName = ModelName + L" Mesh " + std::to_wstring(NodeIndex) + L":" + std::to_wstring(PrimitiveIndex);
-            Mesh->PositionBuffer = RHICreateBuffer<XMFLOAT3>({ .Usage = EBufferUsage::StructuredBuffer, .Name = MeshName + L" position buffer" }, Positions);
-            Mesh->TextureCoordsBuffer = RHICreateBuffer<XMFLOAT2>({ .Usage = EBufferUsage::StructuredBuffer, .Name = MeshName + L" texture coord buffer" }, TextureCoords);
-            Mesh->NormalBuffer = RHICreateBuffer<XMFLOAT3>({ .Usage = EBufferUsage::StructuredBuffer, .Name = MeshName + L" normal buffer" }, Normals);
-            Mesh->TangentBuffer = RHICreateBuffer<XMFLOAT3>({ .Usage = EBufferUsage::StructuredBuffer, .Name = MeshName + L" tangent buffer" }, Tangents);
-            Mesh->IndexBuffer = RHICreateBuffer<UINT>({ .Usage = EBufferUsage::StructuredBuffer, .Name = MeshName + L" index buffer" }, Indices);
-            Mesh->IndicesCount = static_cast<uint32_t>(Indices.size());
+            Mesh->SetGeometry(FGeometryData{
+                .Positions = Positions,
+                .TextureCoords = TextureCoords,
+                .Normals = Normals,
+                .Tangents = Tangents,
+                .Indices = Indices,
+            }, MeshName);
+            Mesh->SetCPUGeometry(Positions, Indices);
             Mesh->Material = std::move(Material);
-            Mesh->Transform = NodeTransform;
             Meshes.push_back(std::move(Mesh));
+            MeshTransformNodes.push_back(TransformNode);
         }
     }
 
-    for (const int ChildIndex : Node.children)
-    {
-        if (ChildIndex < 0)
-        {
-            FatalError("glTF node contains an invalid child index.");
-        }
-        LoadNode(static_cast<uint32_t>(ChildIndex), GLTFModel, NodeTransform);
-    }
+    return TransformNode;
 }
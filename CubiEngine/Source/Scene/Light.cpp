@@ -1,5 +1,6 @@
 #include "Scene/Light.h"
 #include "Scene/Scene.h"
+#include "Graphics/ConstantBufferAllocator.h"
 
 FLight::FLight()
 {
@@ -72,6 +73,15 @@ void UpdateDirectionallightViewProjectionMatrix(FScene* Scene, XMMATRIX ViewProj
 
 interlop::LightBuffer FLight::GetLightBufferWithViewUpdate(FScene* Scene, XMMATRIX ViewMatrix)
 {
+    // View space positions only move with the camera or the lights, a still camera skips the transforms.
+    uint64_t InputHash = FConstantDirtyTracker::Hash(&ViewMatrix, sizeof(ViewMatrix));
+    InputHash = FConstantDirtyTracker::Hash(LightBufferData.lightPosition, LightBufferData.numLight * sizeof(XMFLOAT4), InputHash);
+    if (InputHash == ViewUpdateHash)
+    {
+        return LightBufferData;
+    }
+    ViewUpdateHash = InputHash;
+
     for (int i = 0; i < LightBufferData.numLight; i++)
     {
         XMFLOAT4 LightPositionXM = LightBufferData.lightPosition[i];
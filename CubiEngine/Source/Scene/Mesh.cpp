@@ -1,4 +1,6 @@
 #include "Scene/Mesh.h"
+#include "Graphics/D3D12DynamicRHI.h"
+#include "Graphics/MaterialTable.h"
 #include "Graphics/Material.h"
 #include "Graphics/GraphicsContext.h"
 #include "Scene/Scene.h"
@@ -7,33 +9,113 @@ FMesh::FMesh()
 {
 }
 
+FMesh::~FMesh()
+{
+    if (Geometry.IsValid())
+    {
+        RHIGetGeometryPool()->Free(Geometry);
+    }
+}
+
+void FMesh::SetGeometry(const FGeometryData& Data, std::wstring_view Name)
+{
+    FGeometryPool* GeometryPool = RHIGetGeometryPool();
+    if (Geometry.IsValid())
+    {
+        GeometryPool->Free(Geometry);
+    }
+    Geometry = GeometryPool->Allocate(Data, Name);
+}
+
+const FGeometryRange& FMesh::GetGeometryRange() const
+{
+    return RHIGetGeometryPool()->GetRange(Geometry);
+}
+
 void FMesh::Render(const FGraphicsContext* const GraphicsContext,
     interlop::UnlitPassRenderResources& UnlitRenderResources) const
 {
-    GraphicsContext->SetIndexBuffer(IndexBuffer);
+    const FGeometryPool* GeometryPool = RHIGetGeometryPool();
+    const FGeometryRange& Range = GetGeometryRange();
+    GraphicsContext->SetIndexBuffer(GeometryPool->GetIndexBuffer());
 
 	UnlitRenderResources.modelMatrix = GetModelMatrix();
 
     UnlitRenderResources.albedoTextureIndex = Material->GetAlbedoSrv();
     UnlitRenderResources.albedoTextureSamplerIndex = Material->AlbedoSampler.SamplerIndex;
 
-    UnlitRenderResources.materialBufferIndex = Material->MaterialBuffer.CbvIndex;
+    UnlitRenderResources.materialIndex = Material->MaterialIndex;
+    UnlitRenderResources.materialTableIndex = RHIGetMaterialTable()->GetSrv();
 
-    UnlitRenderResources.positionBufferIndex = PositionBuffer.SrvIndex;
-    UnlitRenderResources.textureCoordBufferIndex = TextureCoordsBuffer.SrvIndex;
+    UnlitRenderResources.positionBufferIndex = GeometryPool->GetVertexBufferSrv(FGeometryPool::Position);
+    UnlitRenderResources.textureCoordBufferIndex = GeometryPool->GetVertexBufferSrv(FGeometryPool::TextureCoord);
+    UnlitRenderResources.vertexOffset = Range.BaseVertex;
 
     GraphicsContext->SetGraphicsRoot32BitConstants(&UnlitRenderResources);
-    GraphicsContext->DrawIndexedInstanced(IndicesCount);
+    GraphicsContext->DrawIndexedInstanced(Range.NumIndices, 1u, Range.FirstIndex);
 }
 
 void FMesh::Render(const FGraphicsContext* const GraphicsContext, FScene* Scene,
 	interlop::DeferredGPassRenderResources& DeferredGPassRenderResources) const
 {
-	GraphicsContext->SetIndexBuffer(IndexBuffer);
+	const FGeometryRange& Range = GetGeometryRange();
+	GraphicsContext->SetIndexBuffer(RHIGetGeometryPool()->GetIndexBuffer());
+
+	SetTransformRenderResources(DeferredGPassRenderResources);
+	SetGeometryRenderResources(DeferredGPassRenderResources);
+	SetMaterialRenderResources(DeferredGPassRenderResources);
+	DeferredGPassRenderResources.debugBufferIndex = Scene->GetDebugBufferCbv();
+
+	GraphicsContext->SetGraphicsRoot32BitConstants(&DeferredGPassRenderResources);
+	GraphicsContext->DrawIndexedInstanced(Range.NumIndices, 1u, Range.FirstIndex);
+}
+
+void FMesh::Render(const FGraphicsContext* const GraphicsContext,
+	interlop::ShadowDepthPassRenderResource& ShadowDepthPassRenderResource) const
+{
+	const FGeometryPool* GeometryPool = RHIGetGeometryPool();
+	const FGeometryRange& Range = GetGeometryRange();
+	GraphicsContext->SetIndexBuffer(GeometryPool->GetIndexBuffer());
+
+	ShadowDepthPassRenderResource.modelMatrix = GetModelMatrix();
+
+	ShadowDepthPassRenderResource.positionBufferIndex = GeometryPool->GetVertexBufferSrv(FGeometryPool::Position);
+	ShadowDepthPassRenderResource.vertexOffset = Range.BaseVertex;
+
+	GraphicsContext->SetGraphicsRoot32BitConstants(&ShadowDepthPassRenderResource);
+	GraphicsContext->DrawIndexedInstanced(Range.NumIndices, 1u, Range.FirstIndex);
+}
+
+void FMesh::GenerateRaytracingGeometry()
+{
+    // The BLAS copies the triangles when it is built, moving them in the pool afterwards does not affect it.
+    const FGeometryPool* GeometryPool = RHIGetGeometryPool();
+    const FGeometryRange& Range = GetGeometryRange();
 
+    RaytracingGeometry = make_shared<FRaytracingGeometry>(
+        GeometryPool->GetVertexBuffer(FGeometryPool::Position).GetResource(), uint64_t(Range.BaseVertex) * sizeof(XMFLOAT3), Range.NumVertices,
+        GeometryPool->GetIndexBuffer().GetResource(), uint64_t(Range.FirstIndex) * sizeof(uint32_t), Range.NumIndices);
+}
+
+void FMesh::SetTransformRenderResources(interlop::DeferredGPassRenderResources& DeferredGPassRenderResources) const
+{
 	DeferredGPassRenderResources.modelMatrix = GetModelMatrix();
 	DeferredGPassRenderResources.inverseModelMatrix = GetInverseModelMatrix();
+}
+
+void FMesh::SetGeometryRenderResources(interlop::DeferredGPassRenderResources& DeferredGPassRenderResources) const
+{
+	const FGeometryPool* GeometryPool = RHIGetGeometryPool();
 
+	DeferredGPassRenderResources.positionBufferIndex = GeometryPool->GetVertexBufferSrv(FGeometryPool::Position);
+	DeferredGPassRenderResources.textureCoordBufferIndex = GeometryPool->GetVertexBufferSrv(FGeometryPool::TextureCoord);
+	DeferredGPassRenderResources.normalBufferIndex = GeometryPool->GetVertexBufferSrv(FGeometryPool::Normal);
+	DeferredGPassRenderResources.tangentBufferIndex = GeometryPool->GetVertexBufferSrv(FGeometryPool::Tangent);
+	DeferredGPassRenderResources.vertexOffset = GetGeometryRange().BaseVertex;
+}
+
+void FMesh::SetMaterialRenderResources(interlop::DeferredGPassRenderResources& DeferredGPassRenderResources) const
+{
 	DeferredGPassRenderResources.albedoTextureIndex = Material->GetAlbedoSrv();
 	DeferredGPassRenderResources.albedoTextureSamplerIndex = Material->AlbedoSampler.SamplerIndex;
 
@@ -52,37 +134,48 @@ void FMesh::Render(const FGraphicsContext* const GraphicsContext, FScene* Scene,
 	DeferredGPassRenderResources.ormTextureIndex = Material->GetORMTextureSrv();
 	DeferredGPassRenderResources.ormTextureSamplerIndex = Material->ORMSampler.SamplerIndex;
 
-	DeferredGPassRenderResources.materialBufferIndex = Material->MaterialBuffer.CbvIndex;
-
-	DeferredGPassRenderResources.positionBufferIndex = PositionBuffer.SrvIndex;
-	DeferredGPassRenderResources.textureCoordBufferIndex = TextureCoordsBuffer.SrvIndex;
-	DeferredGPassRenderResources.normalBufferIndex = NormalBuffer.SrvIndex;
-	DeferredGPassRenderResources.tangentBufferIndex = TangentBuffer.SrvIndex;
-	DeferredGPassRenderResources.debugBufferIndex = Scene->GetDebugBuffer().CbvIndex;
-
-	GraphicsContext->SetGraphicsRoot32BitConstants(&DeferredGPassRenderResources);
-	GraphicsContext->DrawIndexedInstanced(IndicesCount);
+	DeferredGPassRenderResources.materialIndex = Material->MaterialIndex;
+	DeferredGPassRenderResources.materialTableIndex = RHIGetMaterialTable()->GetSrv();
 }
 
-void FMesh::Render(const FGraphicsContext* const GraphicsContext,
-	interlop::ShadowDepthPassRenderResource& ShadowDepthPassRenderResource) const
+interlop::InstanceData FMesh::GetInstanceData() const
 {
-	GraphicsContext->SetIndexBuffer(IndexBuffer);
-
-	ShadowDepthPassRenderResource.modelMatrix = GetModelMatrix();
-
-	ShadowDepthPassRenderResource.positionBufferIndex = PositionBuffer.SrvIndex;
-
-	GraphicsContext->SetGraphicsRoot32BitConstants(&ShadowDepthPassRenderResource);
-	GraphicsContext->DrawIndexedInstanced(IndicesCount);
+	const FGeometryPool* GeometryPool = RHIGetGeometryPool();
+
+	return interlop::InstanceData{
+		.modelMatrix = GetModelMatrix(),
+		.inverseModelMatrix = GetInverseModelMatrix(),
+		.positionBufferIndex = GeometryPool->GetVertexBufferSrv(FGeometryPool::Position),
+		.textureCoordBufferIndex = GeometryPool->GetVertexBufferSrv(FGeometryPool::TextureCoord),
+		.normalBufferIndex = GeometryPool->GetVertexBufferSrv(FGeometryPool::Normal),
+		.tangentBufferIndex = GeometryPool->GetVertexBufferSrv(FGeometryPool::Tangent),
+		.vertexOffset = GetGeometryRange().BaseVertex,
+		.albedoTextureIndex = Material->GetAlbedoSrv(),
+		.albedoTextureSamplerIndex = Material->AlbedoSampler.SamplerIndex,
+		.metalRoughnessTextureIndex = Material->GetMetalRoughnessSrv(),
+		.metalRoughnessTextureSamplerIndex = Material->MetalRoughnessSampler.SamplerIndex,
+		.normalTextureIndex = Material->GetNormalSrv(),
+		.normalTextureSamplerIndex = Material->NormalSampler.SamplerIndex,
+		.aoTextureIndex = Material->GetAOTextureSrv(),
+		.aoTextureSamplerIndex = Material->AOSampler.SamplerIndex,
+		.emissiveTextureIndex = Material->GetEmissiveSrv(),
+		.emissiveTextureSamplerIndex = Material->EmissiveSampler.SamplerIndex,
+		.ormTextureIndex = Material->GetORMTextureSrv(),
+		.ormTextureSamplerIndex = Material->ORMSampler.SamplerIndex,
+		.materialIndex = Material->MaterialIndex,
+	};
 }
 
-void FMesh::GenerateRaytracingGeometry()
+void FMesh::SetCPUGeometry(const std::vector<XMFLOAT3>& Positions, const std::vector<UINT>& Indices)
 {
-    std::pair<ComPtr<ID3D12Resource>, uint32_t> A = std::pair<ComPtr<ID3D12Resource>, uint32_t>(PositionBuffer.GetResource(), (uint32_t)PositionBuffer.NumElement);
-    std::pair<ComPtr<ID3D12Resource>, uint32_t> B = std::pair<ComPtr<ID3D12Resource>, uint32_t>(IndexBuffer.GetResource(), (uint32_t)IndexBuffer.NumElement);
+    CPUPositions = Positions;
+    CPUIndices = Indices;
 
-    RaytracingGeometry = make_shared<FRaytracingGeometry>( A, B );
+    LocalBounds = FAABB{};
+    for (const XMFLOAT3& Position : Positions)
+    {
+        LocalBounds.Expand(Position);
+    }
 }
 
 void FMesh::GatherRaytracingGeometry(std::vector<FRaytracingGeometryContext>& RaytracingGeometryContextList)
@@ -0,0 +1,622 @@
+#include "Scene/PVS.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <thread>
+
+namespace
+{
+    constexpr uint32_t PVS_FILE_MAGIC = 0x53565043; // 'CPVS'
+    // 2 : scene placement hash after the mesh count.
+    constexpr uint32_t PVS_FILE_VERSION = 2u;
+    constexpr uint32_t BVH_LEAF_SIZE = 4u;
+    constexpr uint32_t INVALID_MESH = ~0u;
+    // Placement hash resolution in world units, well below anything that changes visibility.
+    constexpr float PLACEMENT_HASH_QUANTUM = 1.f / 256.f;
+
+    // One jittered value per stratum of [0, 1), shuffled so axes sampled with separate calls pair up randomly (latin hypercube).
+    void GenerateStrata(uint32_t Count, std::mt19937& Generator, std::vector<float>& OutValues)
+    {
+        std::uniform_real_distribution<float> Distribution(0.f, 1.f);
+        OutValues.resize(Count);
+        for (uint32_t i = 0; i < Count; i++)
+        {
+            OutValues[i] = (static_cast<float>(i) + Distribution(Generator)) / static_cast<float>(Count);
+        }
+        std::shuffle(OutValues.begin(), OutValues.end(), Generator);
+    }
+
+    void HashBytes(uint64_t& Hash, const void* Data, size_t Size)
+    {
+        // FNV-1a.
+        const uint8_t* Bytes = static_cast<const uint8_t*>(Data);
+        for (size_t i = 0; i < Size; i++)
+        {
+            Hash = (Hash ^ Bytes[i]) * 0x100000001B3ull;
+        }
+    }
+
+    void HashQuantized(uint64_t& Hash, const float* Values, size_t Count)
+    {
+        for (size_t i = 0; i < Count; i++)
+        {
+            const int64_t Quantized = static_cast<int64_t>(std::llround(Values[i] / PLACEMENT_HASH_QUANTUM));
+            HashBytes(Hash, &Quantized, sizeof(Quantized));
+        }
+    }
+
+    struct FPVSTriangle
+    {
+        XMFLOAT3 V0;
+        XMFLOAT3 Edge1;
+        XMFLOAT3 Edge2;
+        uint32_t MeshIndex;
+    };
+
+    struct FBVHNode
+    {
+        FAABB Bounds;
+        // Leaf : first triangle index. Interior : right child index (left child is the next node).
+        uint32_t Offset;
+        uint32_t Count;
+    };
+
+    // Simple median split BVH over every triangle of the scene, used only while baking.
+    class FTriangleBVH
+    {
+    public:
+        explicit FTriangleBVH(const std::vector<FPVSMeshGeometry>& MeshGeometries)
+        {
+            for (uint32_t MeshIndex = 0; MeshIndex < MeshGeometries.size(); MeshIndex++)
+            {
+                const FPVSMeshGeometry& Geometry = MeshGeometries[MeshIndex];
+                for (size_t i = 0; i + 2 < Geometry.Indices.size(); i += 3)
+                {
+                    const XMVECTOR P0 = XMLoadFloat3(&Geometry.Positions[Geometry.Indices[i]]);
+                    const XMVECTOR P1 = XMLoadFloat3(&Geometry.Positions[Geometry.Indices[i + 1]]);
+                    const XMVECTOR P2 = XMLoadFloat3(&Geometry.Positions[Geometry.Indices[i + 2]]);
+
+                    FPVSTriangle Triangle{ .MeshIndex = MeshIndex };
+                    Dx::XMStoreFloat3(&Triangle.V0, P0);
+                    Dx::XMStoreFloat3(&Triangle.Edge1, XMVectorSubtract(P1, P0));
+                    Dx::XMStoreFloat3(&Triangle.Edge2, XMVectorSubtract(P2, P0));
+                    Triangles.push_back(Triangle);
+                }
+            }
+
+            if (!Triangles.empty())
+            {
+                Nodes.reserve(Triangles.size() * 2 / BVH_LEAF_SIZE + 1);
+                Build(0u, static_cast<uint32_t>(Triangles.size()));
+            }
+        }
+
+        // Returns the mesh index of the closest hit, or INVALID_MESH when the ray escapes.
+        uint32_t Trace(const XMFLOAT3& Origin, const XMFLOAT3& Direction) const
+        {
+            if (Nodes.empty())
+            {
+                return INVALID_MESH;
+            }
+
+            const XMFLOAT3 InvDirection = { 1.f / Direction.x, 1.f / Direction.y, 1.f / Direction.z };
+
+            float ClosestT = FLT_MAX;
+            uint32_t ClosestMesh = INVALID_MESH;
+
+            uint32_t Stack[64];
+            uint32_t StackSize = 0;
+            Stack[StackSize++] = 0;
+
+            while (StackSize > 0)
+            {
+                const FBVHNode& Node = Nodes[Stack[--StackSize]];
+                if (!IntersectBox(Node.Bounds, Origin, InvDirection, ClosestT))
+                {
+                    continue;
+                }
+
+                if (Node.Count > 0)
+                {
+                    for (uint32_t i = Node.Offset; i < Node.Offset + Node.Count; i++)
+                    {
+                        float T;
+                        if (IntersectTriangle(Triangles[i], Origin, Direction, T) && T < ClosestT)
+                        {
+                            ClosestT = T;
+                            ClosestMesh = Triangles[i].MeshIndex;
+                        }
+                    }
+                }
+                else
+                {
+                    const uint32_t NodeIndex = static_cast<uint32_t>(&Node - Nodes.data());
+                    Stack[StackSize++] = Node.Offset;
+                    Stack[StackSize++] = NodeIndex + 1;
+                }
+            }
+
+            return ClosestMesh;
+        }
+
+    private:
+        static XMFLOAT3 GetCentroid(const FPVSTriangle& Triangle)
+        {
+            return {
+                Triangle.V0.x + (Triangle.Edge1.x + Triangle.Edge2.x) / 3.f,
+                Triangle.V0.y + (Triangle.Edge1.y + Triangle.Edge2.y) / 3.f,
+                Triangle.V0.z + (Triangle.Edge1.z + Triangle.Edge2.z) / 3.f,
+            };
+        }
+
+        uint32_t Build(uint32_t Begin, uint32_t End)
+        {
+            const uint32_t NodeIndex = static_cast<uint32_t>(Nodes.size());
+            Nodes.push_back({});
+
+            FAABB Bounds{};
+            FAABB CentroidBounds{};
+            for (uint32_t i = Begin; i < End; i++)
+            {
+                const FPVSTriangle& Triangle = Triangles[i];
+                Bounds.Expand(Triangle.V0);
+                Bounds.Expand(XMFLOAT3{ Triangle.V0.x + Triangle.Edge1.x, Triangle.V0.y + Triangle.Edge1.y, Triangle.V0.z + Triangle.Edge1.z });
+                Bounds.Expand(XMFLOAT3{ Triangle.V0.x + Triangle.Edge2.x, Triangle.V0.y + Triangle.Edge2.y, Triangle.V0.z + Triangle.Edge2.z });
+                CentroidBounds.Expand(GetCentroid(Triangle));
+            }
+
+            const XMFLOAT3 Extent = {
+                CentroidBounds.Max.x - CentroidBounds.Min.x,
+                CentroidBounds.Max.y - CentroidBounds.Min.y,
+                CentroidBounds.Max.z - CentroidBounds.Min.z,
+            };
+            const uint32_t Axis = (Extent.x > Extent.y && Extent.x > Extent.z) ? 0 : (Extent.y > Extent.z ? 1 : 2);
+            const float AxisExtent = (&Extent.x)[Axis];
+
+            // Stop splitting when all centroids collapse to a single point.
+            if (End - Begin <= BVH_LEAF_SIZE || AxisExtent <= 0.f)
+            {
+                Nodes[NodeIndex] = { .Bounds = Bounds, .Offset = Begin, .Count = End - Begin };
+                return NodeIndex;
+            }
+
+            const uint32_t Mid = Begin + (End - Begin) / 2;
+            std::nth_element(Triangles.begin() + Begin, Triangles.begin() + Mid, Triangles.begin() + End,
+                [Axis](const FPVSTriangle& A, const FPVSTriangle& B)
+                {
+                    const XMFLOAT3 CentroidA = GetCentroid(A);
+                    const XMFLOAT3 CentroidB = GetCentroid(B);
+                    return (&CentroidA.x)[Axis] < (&CentroidB.x)[Axis];
+                });
+
+            Build(Begin, Mid);
+            const uint32_t RightChild = Build(Mid, End);
+
+            Nodes[NodeIndex] = { .Bounds = Bounds, .Offset = RightChild, .Count = 0 };
+            return NodeIndex;
+        }
+
+        static bool IntersectBox(const FAABB& Box, const XMFLOAT3& Origin, const XMFLOAT3& InvDirection, float MaxT)
+        {
+            float TMin = 0.f;
+            float TMax = MaxT;
+            for (uint32_t Axis = 0; Axis < 3; Axis++)
+            {
+                const float O = (&Origin.x)[Axis];
+                const float InvD = (&InvDirection.x)[Axis];
+                float T0 = ((&Box.Min.x)[Axis] - O) * InvD;
+                float T1 = ((&Box.Max.x)[Axis] - O) * InvD;
+                if (T0 > T1)
+                {
+                    std::swap(T0, T1);
+                }
+
+                TMin = T0 > TMin ? T0 : TMin;
+                TMax = T1 < TMax ? T1 : TMax;
+                if (TMin > TMax)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Moller-Trumbore, double sided.
+        static bool IntersectTriangle(const FPVSTriangle& Triangle, const XMFLOAT3& Origin, const XMFLOAT3& Direction, float& OutT)
+        {
+            const XMVECTOR D = XMLoadFloat3(&Direction);
+            const XMVECTOR E1 = XMLoadFloat3(&Triangle.Edge1);
+            const XMVECTOR E2 = XMLoadFloat3(&Triangle.Edge2);
+
+            const XMVECTOR P = XMVector3Cross(D, E2);
+            const float Det = XMVectorGetX(Dx::XMVector3Dot(E1, P));
+            if (fabsf(Det) < 1e-10f)
+            {
+                return false;
+            }
+
+            const float InvDet = 1.f / Det;
+            const XMVECTOR S = XMVectorSubtract(XMLoadFloat3(&Origin), XMLoadFloat3(&Triangle.V0));
+            const float U = XMVectorGetX(Dx::XMVector3Dot(S, P)) * InvDet;
+            if (U < 0.f || U > 1.f)
+            {
+                return false;
+            }
+
+            const XMVECTOR Q = XMVector3Cross(S, E1);
+            const float V = XMVectorGetX(Dx::XMVector3Dot(D, Q)) * InvDet;
+            if (V < 0.f || U + V > 1.f)
+            {
+                return false;
+            }
+
+            OutT = XMVectorGetX(Dx::XMVector3Dot(E2, Q)) * InvDet;
+            return OutT > 0.f;
+        }
+
+        std::vector<FPVSTriangle> Triangles;
+        std::vector<FBVHNode> Nodes;
+    };
+}
+
+uint32_t FPVS::GetCellIndex(const XMFLOAT3& Position) const
+{
+    if (!IsValid())
+    {
+        return INVALID_CELL;
+    }
+
+    const float Local[3] = {
+        (Position.x - GridOrigin.x) / CellSize,
+        (Position.y - GridOrigin.y) / CellSize,
+        (Position.z - GridOrigin.z) / CellSize,
+    };
+
+    uint32_t Coord[3];
+    for (uint32_t Axis = 0; Axis < 3; Axis++)
+    {
+        if (Local[Axis] < 0.f || Local[Axis] >= static_cast<float>(GridDimension[Axis]))
+        {
+            return INVALID_CELL;
+        }
+        Coord[Axis] = static_cast<uint32_t>(Local[Axis]);
+    }
+
+    return (Coord[2] * GridDimension[1] + Coord[1]) * GridDimension[0] + Coord[0];
+}
+
+void FPVS::DecodeCell(uint32_t CellIndex, std::vector<uint8_t>& OutVisibleBits) const
+{
+    const uint32_t NumBytes = (NumMeshes + 7) / 8;
+    OutVisibleBits.assign(NumBytes, 0u);
+
+    if (CellIndex >= NumCells)
+    {
+        // Outside of the baked volume, everything is potentially visible.
+        OutVisibleBits.assign(NumBytes, 0xFFu);
+        return;
+    }
+
+    // Load checked every cell stream, so this can walk it without bounds checks.
+    const uint8_t* Source = CompressedVisibility.data() + CellOffsets[CellIndex];
+    uint32_t ByteIndex = 0;
+    while (ByteIndex < NumBytes)
+    {
+        const uint8_t Value = *Source++;
+        if (Value != 0u)
+        {
+            OutVisibleBits[ByteIndex++] = Value;
+        }
+        else
+        {
+            // A zero byte is followed by the length of the zero run.
+            ByteIndex += *Source++;
+        }
+    }
+}
+
+bool FPVS::IsCellStreamValid(uint32_t CellIndex) const
+{
+    const uint32_t NumBytes = (NumMeshes + 7) / 8;
+    const size_t End = CompressedVisibility.size();
+
+    size_t Offset = CellOffsets[CellIndex];
+    uint32_t ByteIndex = 0;
+    while (ByteIndex < NumBytes)
+    {
+        if (Offset >= End)
+        {
+            return false;
+        }
+
+        if (CompressedVisibility[Offset++] != 0u)
+        {
+            ByteIndex++;
+            continue;
+        }
+
+        // A zero run needs its length byte, and a run of 0 would never advance.
+        if (Offset >= End || CompressedVisibility[Offset] == 0u)
+        {
+            return false;
+        }
+        ByteIndex += CompressedVisibility[Offset++];
+    }
+
+    // Runs never span past the last mesh.
+    return ByteIndex == NumBytes;
+}
+
+uint64_t FPVS::HashScenePlacement(std::span<const Dx::XMFLOAT4X4> WorldMatrices, std::span<const FAABB> WorldBounds)
+{
+    assert(WorldMatrices.size() == WorldBounds.size());
+
+    uint64_t Hash = 0xCBF29CE484222325ull;
+    const uint64_t NumMeshes = WorldMatrices.size();
+    HashBytes(Hash, &NumMeshes, sizeof(NumMeshes));
+
+    for (size_t MeshIndex = 0; MeshIndex < WorldMatrices.size(); MeshIndex++)
+    {
+        HashQuantized(Hash, &WorldMatrices[MeshIndex].m[0][0], 16u);
+        HashQuantized(Hash, &WorldBounds[MeshIndex].Min.x, 3u);
+        HashQuantized(Hash, &WorldBounds[MeshIndex].Max.x, 3u);
+    }
+
+    return Hash;
+}
+
+void FPVS::CompressBits(const std::vector<uint8_t>& Bits, std::vector<uint8_t>& OutCompressed)
+{
+    for (size_t i = 0; i < Bits.size(); i++)
+    {
+        if (Bits[i] != 0u)
+        {
+            OutCompressed.push_back(Bits[i]);
+            continue;
+        }
+
+        uint8_t RunLength = 0;
+        while (i < Bits.size() && Bits[i] == 0u && RunLength < 255u)
+        {
+            RunLength++;
+            i++;
+        }
+        i--;
+
+        OutCompressed.push_back(0u);
+        OutCompressed.push_back(RunLength);
+    }
+}
+
+std::unique_ptr<FPVS> FPVS::Bake(const std::vector<FPVSMeshGeometry>& MeshGeometries, const FPVSBakeSettings& Settings, uint64_t SceneHash)
+{
+    std::unique_ptr<FPVS> PVS = std::make_unique<FPVS>();
+    PVS->SceneHash = SceneHash;
+
+    FAABB SceneBounds{};
+    for (const FPVSMeshGeometry& Geometry : MeshGeometries)
+    {
+        SceneBounds.Expand(Geometry.Bounds);
+    }
+
+    if (!SceneBounds.IsValid() || Settings.CellSize <= 0.f)
+    {
+        return PVS;
+    }
+
+    PVS->NumMeshes = static_cast<uint32_t>(MeshGeometries.size());
+    PVS->CellSize = Settings.CellSize;
+    PVS->GridOrigin = SceneBounds.Min;
+    PVS->GridDimension[0] = max(1u, static_cast<uint32_t>(std::ceil((SceneBounds.Max.x - SceneBounds.Min.x) / Settings.CellSize)));
+    PVS->GridDimension[1] = max(1u, static_cast<uint32_t>(std::ceil((SceneBounds.Max.y - SceneBounds.Min.y) / Settings.CellSize)));
+    PVS->GridDimension[2] = max(1u, static_cast<uint32_t>(std::ceil((SceneBounds.Max.z - SceneBounds.Min.z) / Settings.CellSize)));
+    const uint32_t NumCells = PVS->GridDimension[0] * PVS->GridDimension[1] * PVS->GridDimension[2];
+
+    const FTriangleBVH BVH(MeshGeometries);
+
+    const uint32_t NumBytes = (PVS->NumMeshes + 7) / 8;
+    std::vector<std::vector<uint8_t>> CellVisibility(NumCells);
+
+    std::atomic<uint32_t> NextCell = 0;
+    auto BakeCells = [&]()
+    {
+        for (uint32_t CellIndex = NextCell++; CellIndex < NumCells; CellIndex = NextCell++)
+        {
+            std::vector<uint8_t>& Bits = CellVisibility[CellIndex];
+            Bits.assign(NumBytes, 0u);
+
+            const uint32_t X = CellIndex % PVS->GridDimension[0];
+            const uint32_t Y = (CellIndex / PVS->GridDimension[0]) % PVS->GridDimension[1];
+            const uint32_t Z = CellIndex / (PVS->GridDimension[0] * PVS->GridDimension[1]);
+
+            FAABB CellBounds{};
+            CellBounds.Min = {
+                PVS->GridOrigin.x + X * Settings.CellSize,
+                PVS->GridOrigin.y + Y * Settings.CellSize,
+                PVS->GridOrigin.z + Z * Settings.CellSize,
+            };
+            CellBounds.Max = {
+                CellBounds.Min.x + Settings.CellSize,
+                CellBounds.Min.y + Settings.CellSize,
+                CellBounds.Min.z + Settings.CellSize,
+            };
+
+            // Meshes overlapping the cell are always visible from inside it.
+            for (uint32_t MeshIndex = 0; MeshIndex < PVS->NumMeshes; MeshIndex++)
+            {
+                if (MeshGeometries[MeshIndex].Bounds.Intersects(CellBounds))
+                {
+                    Bits[MeshIndex >> 3] |= 1u << (MeshIndex & 7u);
+                }
+            }
+
+            // Seed by cell index so rebaking the same scene gives the same result.
+            std::mt19937 Generator(CellIndex);
+            std::vector<float> SampleStrata[3];
+            std::vector<float> RayStrata[2];
+            for (std::vector<float>& Strata : SampleStrata)
+            {
+                GenerateStrata(Settings.SamplesPerCell, Generator, Strata);
+            }
+
+            for (uint32_t Sample = 0; Sample < Settings.SamplesPerCell; Sample++)
+            {
+                const XMFLOAT3 Origin = {
+                    CellBounds.Min.x + SampleStrata[0][Sample] * Settings.CellSize,
+                    CellBounds.Min.y + SampleStrata[1][Sample] * Settings.CellSize,
+                    CellBounds.Min.z + SampleStrata[2][Sample] * Settings.CellSize,
+                };
+
+                for (std::vector<float>& Strata : RayStrata)
+                {
+                    GenerateStrata(Settings.RaysPerSample, Generator, Strata);
+                }
+
+                for (uint32_t Ray = 0; Ray < Settings.RaysPerSample; Ray++)
+                {
+                    // Stratified in (cos theta, phi), which is uniform in solid angle.
+                    const float CosTheta = 1.f - 2.f * RayStrata[0][Ray];
+                    const float SinTheta = sqrtf(max(0.f, 1.f - CosTheta * CosTheta));
+                    const float Phi = Dx::XM_2PI * RayStrata[1][Ray];
+                    const XMFLOAT3 Direction = { SinTheta * cosf(Phi), CosTheta, SinTheta * sinf(Phi) };
+
+                    const uint32_t HitMesh = BVH.Trace(Origin, Direction);
+                    if (HitMesh != INVALID_MESH)
+                    {
+                        Bits[HitMesh >> 3] |= 1u << (HitMesh & 7u);
+                    }
+                }
+            }
+        }
+    };
+
+    const uint32_t NumThreads = Settings.NumThreads > 0 ? Settings.NumThreads : max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> Workers;
+    for (uint32_t i = 1; i < NumThreads; i++)
+    {
+        Workers.emplace_back(BakeCells);
+    }
+    BakeCells();
+
+    for (std::thread& Worker : Workers)
+    {
+        Worker.join();
+    }
+
+    PVS->CellOffsets.resize(NumCells);
+    for (uint32_t CellIndex = 0; CellIndex < NumCells; CellIndex++)
+    {
+        PVS->CellOffsets[CellIndex] = static_cast<uint32_t>(PVS->CompressedVisibility.size());
+        CompressBits(CellVisibility[CellIndex], PVS->CompressedVisibility);
+    }
+    PVS->NumCells = NumCells;
+
+    Log(std::format("PVS baked : {} cells, {} meshes, {} bytes compressed ({} bytes raw)",
+        NumCells, PVS->NumMeshes, PVS->CompressedVisibility.size(), static_cast<size_t>(NumCells) * NumBytes));
+
+    return PVS;
+}
+
+bool FPVS::Save(const std::string& Path) const
+{
+    std::ofstream File(Path, std::ios::binary);
+    if (!File)
+    {
+        return false;
+    }
+
+    const uint32_t NumCompressedBytes = static_cast<uint32_t>(CompressedVisibility.size());
+
+    File.write(reinterpret_cast<const char*>(&PVS_FILE_MAGIC), sizeof(uint32_t));
+    File.write(reinterpret_cast<const char*>(&PVS_FILE_VERSION), sizeof(uint32_t));
+    File.write(reinterpret_cast<const char*>(&NumMeshes), sizeof(uint32_t));
+    File.write(reinterpret_cast<const char*>(&SceneHash), sizeof(uint64_t));
+    File.write(reinterpret_cast<const char*>(&GridOrigin), sizeof(XMFLOAT3));
+    File.write(reinterpret_cast<const char*>(&CellSize), sizeof(float));
+    File.write(reinterpret_cast<const char*>(GridDimension), sizeof(GridDimension));
+    File.write(reinterpret_cast<const char*>(&NumCells), sizeof(uint32_t));
+    File.write(reinterpret_cast<const char*>(&NumCompressedBytes), sizeof(uint32_t));
+    File.write(reinterpret_cast<const char*>(CellOffsets.data()), CellOffsets.size() * sizeof(uint32_t));
+    File.write(reinterpret_cast<const char*>(CompressedVisibility.data()), CompressedVisibility.size());
+
+    return File.good();
+}
+
+bool FPVS::Load(const std::string& Path)
+{
+    std::ifstream File(Path, std::ios::binary);
+    if (!File)
+    {
+        return false;
+    }
+
+    uint32_t Magic = 0;
+    uint32_t Version = 0;
+    uint32_t NumCompressedBytes = 0;
+
+    File.read(reinterpret_cast<char*>(&Magic), sizeof(uint32_t));
+    File.read(reinterpret_cast<char*>(&Version), sizeof(uint32_t));
+    if (Magic != PVS_FILE_MAGIC || Version != PVS_FILE_VERSION)
+    {
+        return false;
+    }
+
+    File.read(reinterpret_cast<char*>(&NumMeshes), sizeof(uint32_t));
+    File.read(reinterpret_cast<char*>(&SceneHash), sizeof(uint64_t));
+    File.read(reinterpret_cast<char*>(&GridOrigin), sizeof(XMFLOAT3));
+    File.read(reinterpret_cast<char*>(&CellSize), sizeof(float));
+    File.read(reinterpret_cast<char*>(GridDimension), sizeof(GridDimension));
+    File.read(reinterpret_cast<char*>(&NumCells), sizeof(uint32_t));
+    File.read(reinterpret_cast<char*>(&NumCompressedBytes), sizeof(uint32_t));
+
+    // Everything below sizes allocations or indexes memory, so check it against the header and the file before trusting it.
+    auto Reject = [this, &Path](const std::string& Reason)
+    {
+        *this = FPVS{};
+        Log(std::format("Rejecting PVS {} : {}", Path, Reason));
+        return false;
+    };
+
+    if (!File.good())
+    {
+        return Reject("truncated header");
+    }
+
+    const uint64_t NumGridCells = static_cast<uint64_t>(GridDimension[0]) * GridDimension[1] * GridDimension[2];
+    if (NumCells == 0u || NumGridCells != NumCells || !(CellSize > 0.f) || !std::isfinite(CellSize))
+    {
+        return Reject("invalid grid");
+    }
+
+    const std::streamoff HeaderEnd = File.tellg();
+    File.seekg(0, std::ios::end);
+    const uint64_t NumPayloadBytes = static_cast<uint64_t>(File.tellg() - HeaderEnd);
+    File.seekg(HeaderEnd);
+    if (NumPayloadBytes != static_cast<uint64_t>(NumCells) * sizeof(uint32_t) + NumCompressedBytes)
+    {
+        return Reject("size does not match the header");
+    }
+
+    CellOffsets.resize(NumCells);
+    CompressedVisibility.resize(NumCompressedBytes);
+    File.read(reinterpret_cast<char*>(CellOffsets.data()), CellOffsets.size() * sizeof(uint32_t));
+    File.read(reinterpret_cast<char*>(CompressedVisibility.data()), CompressedVisibility.size());
+
+    if (!File.good())
+    {
+        return Reject("truncated payload");
+    }
+
+    for (uint32_t CellIndex = 0; CellIndex < NumCells; CellIndex++)
+    {
+        if (CellOffsets[CellIndex] >= NumCompressedBytes || !IsCellStreamValid(CellIndex))
+        {
+            return Reject(std::format("corrupt cell {}", CellIndex));
+        }
+    }
+
+    return true;
+}
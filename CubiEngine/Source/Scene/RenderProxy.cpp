@@ -0,0 +1,139 @@
+#include "Scene/RenderProxy.h"
+#include "Scene/Mesh.h"
+#include "Graphics/Material.h"
+
+namespace
+{
+    template <typename T>
+    void SwapAndPop(std::vector<T>& Array, uint32_t Index)
+    {
+        Array[Index] = std::move(Array.back());
+        Array.pop_back();
+    }
+}
+
+FRenderProxyHandle FRenderProxyStore::Add(FMesh* Mesh, uint32_t ObjectId)
+{
+    uint32_t Slot;
+    if (!FreeSlots.empty())
+    {
+        Slot = FreeSlots.back();
+        FreeSlots.pop_back();
+    }
+    else
+    {
+        Slot = static_cast<uint32_t>(SlotToDense.size());
+        SlotToDense.push_back(FRenderProxyHandle::INVALID_SLOT);
+        SlotGenerations.push_back(0u);
+    }
+
+    const uint32_t DenseIndex = Num();
+    SlotToDense[Slot] = DenseIndex;
+
+    const XMMATRIX WorldMatrix = Mesh->GetModelMatrix();
+    XMStoreFloat4x4(&WorldMatrices.emplace_back(), WorldMatrix);
+    XMStoreFloat4x4(&InverseWorldMatrices.emplace_back(), Mesh->GetInverseModelMatrix());
+    LocalBounds.push_back(Mesh->LocalBounds);
+    WorldBounds.push_back(Mesh->LocalBounds.Transform(WorldMatrix));
+    PipelineIds.push_back(static_cast<uint32_t>(Mesh->Material->AlphaMode));
+    // Materials with the same parameters share a table slot, the albedo texture tells them apart.
+    MaterialIds.push_back(Mesh->Material->GetAlbedoSrv());
+    GeometryIds.push_back(Mesh->Geometry.Index);
+    ObjectIds.push_back(ObjectId);
+    Flags.push_back(RenderProxyFlag_Visible | RenderProxyFlag_CastShadow | RenderProxyFlag_RaytracingGeometry);
+    Meshes.push_back(Mesh);
+    DenseToSlot.push_back(Slot);
+
+    return FRenderProxyHandle{ .Slot = Slot, .Generation = SlotGenerations[Slot] };
+}
+
+bool FRenderProxyStore::Remove(FRenderProxyHandle Handle)
+{
+    if (!IsValid(Handle))
+    {
+        return false;
+    }
+
+    const uint32_t DenseIndex = SlotToDense[Handle.Slot];
+    const uint32_t LastSlot = DenseToSlot.back();
+
+    SwapAndPop(WorldMatrices, DenseIndex);
+    SwapAndPop(InverseWorldMatrices, DenseIndex);
+    SwapAndPop(LocalBounds, DenseIndex);
+    SwapAndPop(WorldBounds, DenseIndex);
+    SwapAndPop(PipelineIds, DenseIndex);
+    SwapAndPop(MaterialIds, DenseIndex);
+    SwapAndPop(GeometryIds, DenseIndex);
+    SwapAndPop(ObjectIds, DenseIndex);
+    SwapAndPop(Flags, DenseIndex);
+    SwapAndPop(Meshes, DenseIndex);
+    SwapAndPop(DenseToSlot, DenseIndex);
+
+    // The moved proxy keeps its handle, only its dense index changes.
+    SlotToDense[LastSlot] = DenseIndex;
+    SlotToDense[Handle.Slot] = FRenderProxyHandle::INVALID_SLOT;
+    SlotGenerations[Handle.Slot]++;
+    FreeSlots.push_back(Handle.Slot);
+
+    return true;
+}
+
+void FRenderProxyStore::Clear()
+{
+    WorldMatrices.clear();
+    InverseWorldMatrices.clear();
+    LocalBounds.clear();
+    WorldBounds.clear();
+    PipelineIds.clear();
+    MaterialIds.clear();
+    GeometryIds.clear();
+    ObjectIds.clear();
+    Flags.clear();
+    Meshes.clear();
+    DenseToSlot.clear();
+
+    FreeSlots.clear();
+    for (uint32_t Slot = 0; Slot < SlotToDense.size(); Slot++)
+    {
+        if (SlotToDense[Slot] != FRenderProxyHandle::INVALID_SLOT)
+        {
+            SlotToDense[Slot] = FRenderProxyHandle::INVALID_SLOT;
+            SlotGenerations[Slot]++;
+        }
+        FreeSlots.push_back(Slot);
+    }
+}
+
+bool FRenderProxyStore::IsValid(FRenderProxyHandle Handle) const
+{
+    return Handle.Slot < SlotToDense.size()
+        && SlotGenerations[Handle.Slot] == Handle.Generation
+        && SlotToDense[Handle.Slot] != FRenderProxyHandle::INVALID_SLOT;
+}
+
+uint32_t FRenderProxyStore::GetDenseIndex(FRenderProxyHandle Handle) const
+{
+    return IsValid(Handle) ? SlotToDense[Handle.Slot] : FRenderProxyHandle::INVALID_SLOT;
+}
+
+void FRenderProxyStore::SetTransform(FRenderProxyHandle Handle, const XMMATRIX& WorldMatrix)
+{
+    const uint32_t DenseIndex = GetDenseIndex(Handle);
+    if (DenseIndex == FRenderProxyHandle::INVALID_SLOT)
+    {
+        return;
+    }
+
+    XMStoreFloat4x4(&WorldMatrices[DenseIndex], WorldMatrix);
+    XMStoreFloat4x4(&InverseWorldMatrices[DenseIndex], XMMatrixInverse(nullptr, WorldMatrix));
+    WorldBounds[DenseIndex] = LocalBounds[DenseIndex].Transform(WorldMatrix);
+}
+
+void FRenderProxyStore::SetFlags(FRenderProxyHandle Handle, uint32_t InFlags)
+{
+    const uint32_t DenseIndex = GetDenseIndex(Handle);
+    if (DenseIndex != FRenderProxyHandle::INVALID_SLOT)
+    {
+        Flags[DenseIndex] = InFlags;
+    }
+}
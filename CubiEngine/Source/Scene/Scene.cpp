@@ -1,9 +1,39 @@
 #include "Scene/Scene.h"
 #include "Graphics/D3D12DynamicRHI.h"
+#include "Graphics/MaterialTable.h"
 #include "Scene/GLTFModelLoader.h"
 #include "Scene/FBXLoader.h"
 #include "Scene/SceneLoader.h"
+#include "Core/FileSystem.h"
 #include <thread>
+#include <xmmintrin.h>
+
+namespace
+{
+    constexpr size_t INSTANCE_MATRIX_ROWS = 8u;
+    constexpr size_t INSTANCE_ROWS = sizeof(interlop::InstanceData) / sizeof(__m128);
+    static_assert(sizeof(interlop::InstanceData) % sizeof(__m128) == 0, "Instance data is packed in whole 16 byte rows.");
+    static_assert(offsetof(interlop::InstanceData, positionBufferIndex) == INSTANCE_MATRIX_ROWS * sizeof(__m128),
+        "Instance data starts with the world and inverse world matrices.");
+
+    // The instance buffer lives in write combined upload memory. Whole 16 byte non temporal stores fill the
+    // combine buffers without reading anything back, where a memcpy of a staged copy touches every byte twice.
+    void PackInstance(float* Destination, const Dx::XMFLOAT4X4& WorldMatrix, const Dx::XMFLOAT4X4& InverseWorldMatrix,
+        const interlop::InstanceData& Source)
+    {
+        for (size_t Row = 0; Row < 4u; Row++)
+        {
+            _mm_stream_ps(Destination + Row * 4u, _mm_loadu_ps(WorldMatrix.m[Row]));
+            _mm_stream_ps(Destination + (Row + 4u) * 4u, _mm_loadu_ps(InverseWorldMatrix.m[Row]));
+        }
+
+        const float* SourceRows = reinterpret_cast<const float*>(&Source);
+        for (size_t Row = INSTANCE_MATRIX_ROWS; Row < INSTANCE_ROWS; Row++)
+        {
+            _mm_stream_ps(Destination + Row * 4u, _mm_loadu_ps(SourceRows + Row * 4u));
+        }
+    }
+}
 
 FScene::FScene(uint32_t Width, uint32_t Height)
     : Camera(Width, Height)
@@ -11,32 +41,18 @@ FScene::FScene(uint32_t Width, uint32_t Height)
     std::chrono::high_resolution_clock Clock{};
     PrevTime = Clock.now();
 
-    for (int i = 0; i < FRAMES_IN_FLIGHT; i++)
-    {
-        SceneBuffer[i] = RHICreateBuffer<interlop::SceneBuffer>(FBufferCreationDesc{
-           .Usage = EBufferUsage::ConstantBuffer,
-           .Name = L"Scene Buffer" + i,
-        });
-
-        LightBuffer[i] = RHICreateBuffer<interlop::LightBuffer>(FBufferCreationDesc{
-            .Usage = EBufferUsage::ConstantBuffer,
-            .Name = L"Light Buffer" + i,
-        });
-
-        ShadowBuffer[i] = RHICreateBuffer<interlop::ShadowBuffer>(FBufferCreationDesc{
-            .Usage = EBufferUsage::ConstantBuffer,
-            .Name = L"Shadow Buffer" + i,
-        });
-
-        DebugBuffer[i] = RHICreateBuffer<interlop::DebugBuffer>(FBufferCreationDesc{
-            .Usage = EBufferUsage::ConstantBuffer,
-            .Name = L"Debug Buffer" + i,
-        });
-    }
+    LightBuffer.Init(L"Light Buffer");
+    ShadowBuffer.Init(L"Shadow Buffer");
+    DebugBuffer.Init(L"Debug Buffer");
 
     ESceneType Scene = ESceneType::Sponza;
     FSceneLoader::LoadScene(Scene, this);
 
+    PVSPath = FFileSystem::GetAssetPath() + std::format("PVS/Scene{}.pvs", static_cast<int>(Scene));
+    LoadPVS();
+
+    GameThreadRenderSettings = RenderSettings;
+
     WhiteFurnaceMap = std::make_unique<FCubeMap>(FCubeMapCreationDesc{
         .EquirectangularTexturePath = L"Assets/Textures/WhiteFurnace.hdr",
         .Name = L"WhiteFurnace Map"
@@ -48,30 +64,121 @@ FScene::~FScene()
 
 }
 
-void FScene::GameTick(float DeltaTime, FInput* Input, uint32_t Width, uint32_t Height)
+void FScene::GameTick(float DeltaTime, FInput* Input, uint32_t Width, uint32_t Height, FFrameSnapshot& Snapshot)
 {
     this->Width = Width;
     this->Height = Height;
-    
+
+    ExecuteGameThreadCommands();
     HandleMaxTickRate();
 
-	bool bRasterizeMode = (RenderSettings.RenderingMode == (int)ERenderingMode::Rasterize);
-    bool bApplyJitter = RenderSettings.bUseTaa && bRasterizeMode;
+    const FSceneRenderSettings& Settings = GameThreadRenderSettings;
+	bool bRasterizeMode = (Settings.RenderingMode == (int)ERenderingMode::Rasterize);
+    bool bApplyJitter = Settings.bUseTaa && bRasterizeMode;
 
-    Camera.Update(DeltaTime, Input, Width, Height, bApplyJitter, RenderSettings.CSMExponentialFactor);
+    Camera.Update(DeltaTime, Input, Width, Height, bApplyJitter, Settings.CSMExponentialFactor, GameFrameIndex);
 
-    UpdateBuffers();
+    UpdateTransforms(Snapshot);
 
-    if (RenderSettings.bLightDanceDebug)
+    if (Settings.bLightDanceDebug)
     {
-        Light.LightBufferData.lightPosition[0].z = sinf(RenderSettings.bLightDanceSpeed * GFrameCount / 100.f);
+        Light.LightBufferData.lightPosition[0].z = sinf(Settings.bLightDanceSpeed * GameFrameIndex / 100.f);
 
         if (Light.LightBufferData.numLight > 1)
         {
-            Light.LightBufferData.lightPosition[1].x = 500.f * sinf(RenderSettings.bLightDanceSpeed * GFrameCount / 100.f);
-            Light.LightBufferData.lightPosition[1].z = 500.f * cosf(RenderSettings.bLightDanceSpeed * GFrameCount / 100.f);
+            Light.LightBufferData.lightPosition[1].x = 500.f * sinf(Settings.bLightDanceSpeed * GameFrameIndex / 100.f);
+            Light.LightBufferData.lightPosition[1].z = 500.f * cosf(Settings.bLightDanceSpeed * GameFrameIndex / 100.f);
         }
     }
+
+    CaptureFrameSnapshot(Snapshot, DeltaTime);
+    GameFrameIndex++;
+}
+
+void FScene::CaptureFrameSnapshot(FFrameSnapshot& Snapshot, float DeltaTime)
+{
+    Snapshot.FrameIndex = GameFrameIndex;
+    Snapshot.DeltaTime = DeltaTime;
+    Snapshot.CPUFrameMsTime = CPUFrameMsTime;
+
+    Snapshot.SceneBufferData = {
+        .viewProjectionMatrix = Camera.GetViewProjMatrix(),
+        .projectionMatrix = Camera.GetProjMatrix(),
+        .inverseProjectionMatrix = XMMatrixInverse(nullptr, Camera.GetProjMatrix()),
+        .viewMatrix = Camera.GetViewMatrix(),
+        .inverseViewMatrix = XMMatrixInverse(nullptr, Camera.GetViewMatrix()),
+        .prevViewProjMatrix = Camera.GetPrevViewProjMatrix(),
+        .clipToPrevClip = Camera.GetClipToPrevClip(),
+        .invDeviceZToWorldZTransform = Camera.CreateInvDeviceZToWorldZTransform(Camera.GetProjMatrix()),
+        .nearZ = Camera.NearZ,
+        .farZ = Camera.FarZ,
+        .width = Width,
+        .height = Height,
+		.cameraPosition = Camera.GetCameraPositionF3(),
+        .frameCount = GameFrameIndex,
+    };
+
+    Snapshot.LightBufferData = Light.GetLightBufferWithViewUpdate(this, Camera.GetViewMatrix());
+    Snapshot.ShadowBufferData = Light.GetShadowBuffer(this);
+
+    Snapshot.InvViewProjectionMatrix = Camera.GetInvViewProjMatrix();
+    Snapshot.CameraPosition = Camera.GetCameraPositionF3();
+    Snapshot.CameraFovY = Camera.FovY;
+    Snapshot.CameraFarZ = Camera.FarZ;
+    Snapshot.bViewProjMatrixChanged = Camera.IsViewProjMatrixChanged();
+
+    Snapshot.SelectedTransform = FSelectedTransformSnapshot{};
+    if (EditorSelectedMesh < MeshTransformNodes.size())
+    {
+        const uint32_t Node = MeshTransformNodes[EditorSelectedMesh];
+        Snapshot.SelectedTransform = {
+            .MeshIndex = EditorSelectedMesh,
+            .Node = Node,
+            .Parent = TransformHierarchy.GetParent(Node),
+            .Translation = TransformHierarchy.GetLocalTranslation(Node),
+            .Rotation = TransformHierarchy.GetLocalRotation(Node),
+            .Scale = TransformHierarchy.GetLocalScale(Node),
+        };
+    }
+}
+
+void FScene::BeginRenderFrame(const FFrameSnapshot& Snapshot)
+{
+    RenderSnapshot = &Snapshot;
+
+    ApplyMovedMeshes(Snapshot);
+    UpdatePVSVisibility();
+    UpdateBuffers();
+    if (RenderSettings.bUseIndirectDraw)
+    {
+        UpdateInstanceBuffer();
+    }
+
+    // The editor edits RenderSettings on this thread, the game thread picks the change up next tick.
+    EnqueueGameThreadCommand([Settings = RenderSettings](FScene& Scene)
+    {
+        Scene.GameThreadRenderSettings = Settings;
+    });
+}
+
+void FScene::EnqueueGameThreadCommand(std::function<void(FScene&)> Command)
+{
+    std::lock_guard Lock(GameThreadCommandMutex);
+    GameThreadCommands.push_back(std::move(Command));
+}
+
+void FScene::ExecuteGameThreadCommands()
+{
+    {
+        std::lock_guard Lock(GameThreadCommandMutex);
+        ExecutingGameThreadCommands.swap(GameThreadCommands);
+    }
+
+    for (const std::function<void(FScene&)>& Command : ExecutingGameThreadCommands)
+    {
+        Command(*this);
+    }
+    ExecutingGameThreadCommands.clear();
 }
 
 void FScene::HandleMaxTickRate()
@@ -81,7 +188,7 @@ void FScene::HandleMaxTickRate()
 
     const float DeltaTime = std::chrono::duration<double, std::milli>(CurTime - PrevTime).count();
     
-    float MsMax = (1000.f / RenderSettings.MaxFPS);
+    float MsMax = (1000.f / GameThreadRenderSettings.MaxFPS);
     if (DeltaTime < MsMax)
     {
         float MilliSleep = (MsMax - DeltaTime);
@@ -98,44 +205,27 @@ void FScene::HandleMaxTickRate()
 
 void FScene::UpdateBuffers()
 {
-    const interlop::SceneBuffer SceneBufferData = {
-        .viewProjectionMatrix = Camera.GetViewProjMatrix(),
-        .projectionMatrix = Camera.GetProjMatrix(),
-        .inverseProjectionMatrix = XMMatrixInverse(nullptr, Camera.GetProjMatrix()),
-        .viewMatrix = Camera.GetViewMatrix(),
-        .inverseViewMatrix = XMMatrixInverse(nullptr, Camera.GetViewMatrix()),
-        .prevViewProjMatrix = Camera.GetPrevViewProjMatrix(),
-        .clipToPrevClip = Camera.GetClipToPrevClip(),
-        .invDeviceZToWorldZTransform = Camera.CreateInvDeviceZToWorldZTransform(Camera.GetProjMatrix()),
-        .nearZ = Camera.NearZ,
-        .farZ = Camera.FarZ,
-        .width = Width,
-        .height = Height,
-		.cameraPosition = Camera.GetCameraPositionF3(),
-        .frameCount = GFrameCount,
-    };
-
-    GetSceneBuffer().Update(&SceneBufferData);
+    SceneBufferCbv = RHIAllocateConstants(RenderSnapshot->SceneBufferData);
+    LightBuffer.Update(RenderSnapshot->LightBufferData);
 
-    const interlop::LightBuffer LightBufferData = Light.GetLightBufferWithViewUpdate(this, Camera.GetViewMatrix());
-    GetLightBuffer().Update(&LightBufferData);
-
-    interlop::ShadowBuffer ShadowBufferData = Light.GetShadowBuffer(this);
+    interlop::ShadowBuffer ShadowBufferData = RenderSnapshot->ShadowBufferData;
     ShadowBufferData.shadowBias = RenderSettings.ShadowBias;
-    GetShadowBuffer().Update(&ShadowBufferData);
+    ShadowBuffer.Update(ShadowBufferData);
     
-    const interlop::DebugBuffer DebugBufferData = {
-        .bUseTaa = RenderSettings.bUseTaa ? 1u : 0u,
-        .ShadowMethod = (uint32_t)RenderSettings.ShadowMethod,
-        .bEnableDiffuse = (uint32_t)RenderSettings.bEnableDiffuse,
-        .bEnableSpecular = (uint32_t)RenderSettings.bEnableSpecular
-    };
-
-    GetDebugBuffer().Update(&DebugBufferData);
+    // Zeroed first, the tracker hashes the padding along with the fields.
+    interlop::DebugBuffer DebugBufferData{};
+    DebugBufferData.bUseTaa = RenderSettings.bUseTaa ? 1u : 0u;
+    DebugBufferData.ShadowMethod = (uint32_t)RenderSettings.ShadowMethod;
+    DebugBufferData.bEnableDiffuse = (uint32_t)RenderSettings.bEnableDiffuse;
+    DebugBufferData.bEnableSpecular = (uint32_t)RenderSettings.bEnableSpecular;
+
+    DebugBuffer.Update(DebugBufferData);
 }
 
 void FScene::AddModel(const FModelCreationDesc& Desc)
 {
+    const uint32_t FirstMeshIndex = static_cast<uint32_t>(Meshes.size());
+
     std::string_view Extension = GetExtension(Desc.ModelPath);
     if (Extension == "glb" || Extension == "gltf")
     {
@@ -145,6 +235,12 @@ void FScene::AddModel(const FModelCreationDesc& Desc)
 			std::make_move_iterator(Model.Meshes.begin()),
 			std::make_move_iterator(Model.Meshes.end())
 		);
+
+        const uint32_t NodeOffset = TransformHierarchy.Append(Model.TransformHierarchy);
+        for (const uint32_t Node : Model.MeshTransformNodes)
+        {
+            MeshTransformNodes.push_back(NodeOffset + Node);
+        }
     }
 	else if (Extension == "fbx")
     {
@@ -159,50 +255,268 @@ void FScene::AddModel(const FModelCreationDesc& Desc)
     {
 		throw std::runtime_error("Model format not supported");
 	}
+
+    AddRenderProxies(FirstMeshIndex);
 }
 
 void FScene::AddMesh(FMesh* Mesh)
 {
+    const uint32_t FirstMeshIndex = static_cast<uint32_t>(Meshes.size());
     Meshes.emplace_back(Mesh);
+
+    AddRenderProxies(FirstMeshIndex);
+}
+
+void FScene::AddRenderProxies(uint32_t FirstMeshIndex)
+{
+    for (uint32_t MeshIndex = FirstMeshIndex; MeshIndex < Meshes.size(); MeshIndex++)
+    {
+        // Loaders without a node hierarchy get one root node per mesh.
+        if (MeshIndex >= MeshTransformNodes.size())
+        {
+            MeshTransformNodes.push_back(TransformHierarchy.AddNode(FTransformHierarchy::INVALID_NODE, Meshes[MeshIndex]->GetModelMatrix()));
+        }
+
+        // The mesh index doubles as the proxy object id, which is what the PVS was baked against.
+        MeshProxyHandles.push_back(RenderProxies.Add(Meshes[MeshIndex].get(), MeshIndex));
+    }
+}
+
+void FScene::UpdateTransforms(FFrameSnapshot& Snapshot)
+{
+    TransformHierarchy.Update();
+    if (TransformHierarchy.GetUpdatedNodes().empty())
+    {
+        return;
+    }
+
+    // Meshes and proxies are read while recording, so moves are handed over through the snapshot.
+    for (uint32_t MeshIndex = 0; MeshIndex < MeshTransformNodes.size(); MeshIndex++)
+    {
+        const uint32_t Node = MeshTransformNodes[MeshIndex];
+        if (TransformHierarchy.WasUpdated(Node))
+        {
+            Snapshot.MovedMeshes.push_back(MeshIndex);
+            XMStoreFloat4x4(&Snapshot.MovedMeshWorldMatrices.emplace_back(), TransformHierarchy.GetWorldMatrix(Node));
+        }
+    }
+}
+
+void FScene::ApplyMovedMeshes(const FFrameSnapshot& Snapshot)
+{
+    for (size_t i = 0; i < Snapshot.MovedMeshes.size(); i++)
+    {
+        const uint32_t MeshIndex = Snapshot.MovedMeshes[i];
+        const XMMATRIX WorldMatrix = XMLoadFloat4x4(&Snapshot.MovedMeshWorldMatrices[i]);
+
+        // The first update after loading recomposes every node, only an actual move makes the PVS stale.
+        if (PVS && MeshIndex < PVS->GetNumMeshes())
+        {
+            const XMMATRIX OldWorldMatrix = Meshes[MeshIndex]->GetModelMatrix();
+            const XMVECTOR Epsilon = XMVectorReplicate(1e-3f);
+            for (uint32_t Row = 0; Row < 4; Row++)
+            {
+                if (!XMVector4NearEqual(OldWorldMatrix.r[Row], WorldMatrix.r[Row], Epsilon))
+                {
+                    InvalidatePVS(std::format("mesh {} moved", MeshIndex));
+                    break;
+                }
+            }
+        }
+
+        Meshes[MeshIndex]->Transform.SetMatrix(WorldMatrix);
+        RenderProxies.SetTransform(MeshProxyHandles[MeshIndex], WorldMatrix);
+    }
+}
+
+void FScene::SetMeshVisibility(uint32_t MeshIndex, bool bVisible)
+{
+    const bool bHasProxy = RenderProxies.IsValid(MeshProxyHandles[MeshIndex]);
+    if (bVisible && !bHasProxy)
+    {
+        MeshProxyHandles[MeshIndex] = RenderProxies.Add(Meshes[MeshIndex].get(), MeshIndex);
+    }
+    else if (!bVisible && bHasProxy)
+    {
+        RenderProxies.Remove(MeshProxyHandles[MeshIndex]);
+    }
 }
 
 void FScene::RenderModels(FGraphicsContext* const GraphicsContext,
     interlop::UnlitPassRenderResources& UnlitRenderResources)
 {
-    UnlitRenderResources.sceneBufferIndex = GetSceneBuffer().CbvIndex;
-    for (const auto& Mesh : Meshes)
+    UnlitRenderResources.sceneBufferIndex = GetSceneBufferCbv();
+
+    const std::span<const uint32_t> ObjectIds = RenderProxies.GetObjectIds();
+    const std::span<const uint32_t> Flags = RenderProxies.GetFlags();
+    const std::span<FMesh* const> ProxyMeshes = RenderProxies.GetMeshes();
+    for (uint32_t ProxyIndex = 0; ProxyIndex < RenderProxies.Num(); ProxyIndex++)
     {
-        Mesh->Render(GraphicsContext, UnlitRenderResources);
+        if ((Flags[ProxyIndex] & RenderProxyFlag_Visible) && IsPotentiallyVisible(ObjectIds[ProxyIndex]))
+        {
+            ProxyMeshes[ProxyIndex]->Render(GraphicsContext, UnlitRenderResources);
+        }
     }
 }
 
 void FScene::RenderModels(FGraphicsContext* const GraphicsContext,
     interlop::DeferredGPassRenderResources& DeferredGRenderResources)
 {
-    DeferredGRenderResources.sceneBufferIndex = GetSceneBuffer().CbvIndex;
-    for (const auto& Mesh : Meshes)
+    DeferredGRenderResources.sceneBufferIndex = GetSceneBufferCbv();
+    DeferredGRenderResources.debugBufferIndex = GetDebugBufferCbv();
+
+    BuildGPassRenderQueue();
+    GPassRenderQueue.Submit(GraphicsContext, DeferredGRenderResources);
+}
+
+void FScene::RenderModels(FGraphicsContext* const GraphicsContext, interlop::ShadowDepthPassRenderResource& ShadowDepthPassRenderResource)
+{
+    const std::span<const uint32_t> Flags = RenderProxies.GetFlags();
+    const std::span<FMesh* const> ProxyMeshes = RenderProxies.GetMeshes();
+    for (uint32_t ProxyIndex = 0; ProxyIndex < RenderProxies.Num(); ProxyIndex++)
     {
-        Mesh->Render(GraphicsContext, this, DeferredGRenderResources);
+        if (Flags[ProxyIndex] & RenderProxyFlag_CastShadow)
+        {
+            ProxyMeshes[ProxyIndex]->Render(GraphicsContext, ShadowDepthPassRenderResource);
+        }
     }
 }
 
-void FScene::RenderModels(FGraphicsContext* const GraphicsContext, interlop::ShadowDepthPassRenderResource& ShadowDepthPassRenderResource)
+void FScene::RenderModels(FGraphicsContext* const GraphicsContext,
+    interlop::DeferredGPassIndirectRenderResources& DeferredGIndirectRenderResources)
+{
+    DeferredGIndirectRenderResources.instanceBufferIndex = GetInstanceBuffer().SrvIndex;
+    DeferredGIndirectRenderResources.sceneBufferIndex = GetSceneBufferCbv();
+    DeferredGIndirectRenderResources.debugBufferIndex = GetDebugBufferCbv();
+    DeferredGIndirectRenderResources.materialTableIndex = RHIGetMaterialTable()->GetSrv();
+
+    // Same culling and ordering as the direct path, only the submission differs.
+    BuildGPassRenderQueue();
+
+    IndirectInstances.clear();
+    for (const FDrawCommand& DrawCommand : GPassRenderQueue.GetDrawCommands())
+    {
+        IndirectInstances.push_back(DrawCommand.InstanceIndex);
+    }
+
+    IndirectDrawArgumentBuilder.Build(IndirectDrawItems, IndirectInstances);
+    GPassIndirectDrawBuffer.Upload(IndirectDrawArgumentBuilder);
+
+    GraphicsContext->SetGraphicsRoot32BitConstants(&DeferredGIndirectRenderResources);
+    GPassIndirectDrawBuffer.Execute(GraphicsContext);
+}
+
+void FScene::RenderModels(FGraphicsContext* const GraphicsContext,
+    interlop::ShadowDepthPassIndirectRenderResource& ShadowDepthPassIndirectRenderResource)
+{
+    ShadowDepthPassIndirectRenderResource.instanceBufferIndex = GetInstanceBuffer().SrvIndex;
+
+    // Arguments are built once per frame in UpdateInstanceBuffer and shared by every cascade.
+    GraphicsContext->SetGraphicsRoot32BitConstants(&ShadowDepthPassIndirectRenderResource);
+    ShadowIndirectDrawBuffer.Execute(GraphicsContext);
+}
+
+void FScene::BuildGPassRenderQueue()
+{
+    const XMFLOAT3 CameraPositionF3 = RenderSnapshot->CameraPosition;
+    const XMVECTOR CameraPosition = XMLoadFloat3(&CameraPositionF3);
+
+    const std::span<const FAABB> WorldBounds = RenderProxies.GetWorldBounds();
+    const std::span<const uint32_t> PipelineIds = RenderProxies.GetPipelineIds();
+    const std::span<const uint32_t> MaterialIds = RenderProxies.GetMaterialIds();
+    const std::span<const uint32_t> GeometryIds = RenderProxies.GetGeometryIds();
+    const std::span<const uint32_t> ObjectIds = RenderProxies.GetObjectIds();
+    const std::span<const uint32_t> Flags = RenderProxies.GetFlags();
+    const std::span<FMesh* const> ProxyMeshes = RenderProxies.GetMeshes();
+
+    // Only the mesh pointer is dereferenced at submit time, everything the key needs is in the proxy arrays.
+    GPassRenderQueue.Reset();
+    for (uint32_t ProxyIndex = 0; ProxyIndex < RenderProxies.Num(); ProxyIndex++)
+    {
+        if (!(Flags[ProxyIndex] & RenderProxyFlag_Visible) || !IsPotentiallyVisible(ObjectIds[ProxyIndex]))
+        {
+            continue;
+        }
+
+        const FAABB& Bounds = WorldBounds[ProxyIndex];
+        const XMVECTOR Center = XMVectorScale(XMVectorAdd(XMLoadFloat3(&Bounds.Min), XMLoadFloat3(&Bounds.Max)), 0.5f);
+        const float ViewDepth = XMVectorGetX(Dx::XMVector3Length(XMVectorSubtract(Center, CameraPosition)));
+
+        const uint64_t SortKey = FRenderQueue::MakeSortKey(PipelineIds[ProxyIndex],
+            MaterialIds[ProxyIndex], GeometryIds[ProxyIndex], ViewDepth);
+        GPassRenderQueue.Add(ProxyMeshes[ProxyIndex], SortKey, ProxyIndex);
+    }
+
+    GPassRenderQueue.Sort();
+}
+
+void FScene::UpdateInstanceBuffer()
 {
-	for (const auto& Mesh : Meshes)
+    const uint32_t NumProxies = RenderProxies.Num();
+    const std::span<const Dx::XMFLOAT4X4> WorldMatrices = RenderProxies.GetWorldMatrices();
+    const std::span<const Dx::XMFLOAT4X4> InverseWorldMatrices = RenderProxies.GetInverseWorldMatrices();
+    const std::span<const uint32_t> Flags = RenderProxies.GetFlags();
+    const std::span<FMesh* const> ProxyMeshes = RenderProxies.GetMeshes();
+
+    // Every mesh draws out of the geometry pool index buffer.
+    const FBuffer& IndexBuffer = RHIGetGeometryPool()->GetIndexBuffer();
+    const D3D12_GPU_VIRTUAL_ADDRESS IndexBufferAddress = IndexBuffer.GetResource()->GetGPUVirtualAddress();
+
+    if (NumProxies == 0u)
     {
-        Mesh->Render(GraphicsContext, ShadowDepthPassRenderResource);
+        return;
+    }
+
+    // Instance indices are dense proxy indices, so the buffer always covers the whole proxy store.
+    FBuffer& Buffer = GetInstanceBuffer();
+    if (Buffer.NumElement < NumProxies)
+    {
+        Buffer = RHICreateBuffer(FBufferCreationDesc{
+            .Usage = EBufferUsage::DynamicStructuredBuffer,
+            .Name = L"Instance Buffer",
+        }, NumProxies, sizeof(interlop::InstanceData));
     }
+    float* const InstanceRows = static_cast<float*>(Buffer.Allocation.MappedPointer.value());
+
+    IndirectDrawItems.resize(NumProxies);
+    IndirectInstances.clear();
+    for (uint32_t ProxyIndex = 0; ProxyIndex < NumProxies; ProxyIndex++)
+    {
+        const FMesh* Mesh = ProxyMeshes[ProxyIndex];
+        const FGeometryRange& Range = Mesh->GetGeometryRange();
+        PackInstance(InstanceRows + ProxyIndex * INSTANCE_ROWS * 4u, WorldMatrices[ProxyIndex], InverseWorldMatrices[ProxyIndex],
+            Mesh->GetInstanceData());
+        IndirectDrawItems[ProxyIndex] = FIndirectDrawItem{
+            .IndexBufferAddress = IndexBufferAddress,
+            .IndexBufferSizeInBytes = static_cast<uint32_t>(IndexBuffer.SizeInBytes),
+            .IndexCount = Range.NumIndices,
+            .FirstIndex = Range.FirstIndex,
+        };
+
+        if (Flags[ProxyIndex] & RenderProxyFlag_CastShadow)
+        {
+            IndirectInstances.push_back(ProxyIndex);
+        }
+    }
+
+    // Non temporal stores are weakly ordered, make them visible before the buffer is submitted.
+    _mm_sfence();
+
+    // Shadow casters are not culled yet, every caster is drawn.
+    IndirectDrawArgumentBuilder.Build(IndirectDrawItems, IndirectInstances);
+    ShadowIndirectDrawBuffer.Upload(IndirectDrawArgumentBuilder);
 }
 
 void FScene::RenderLightsDeferred(FGraphicsContext* const GraphicsContext,
     interlop::DeferredGPassCubeRenderResources RenderResource)
 {
-    RenderResource.debugBufferIndex = GetDebugBuffer().CbvIndex;
-    RenderResource.sceneBufferIndex = GetSceneBuffer().CbvIndex;
+    RenderResource.debugBufferIndex = GetDebugBufferCbv();
+    RenderResource.sceneBufferIndex = GetSceneBufferCbv();
 
-    for (uint32_t i = 1; i < Light.LightBufferData.numLight; i++)
+    const interlop::LightBuffer& LightBufferData = RenderSnapshot->LightBufferData;
+    for (uint32_t i = 1; i < LightBufferData.numLight; i++)
     {
-        const XMVECTOR translationVector = XMLoadFloat4(&Light.LightBufferData.lightPosition[i]);
+        const XMVECTOR translationVector = XMLoadFloat4(&LightBufferData.lightPosition[i]);
         float scale = 1.f;
         const XMVECTOR scalingVector = { scale, scale, scale, 1.f };
 
@@ -211,8 +525,8 @@ void FScene::RenderLightsDeferred(FGraphicsContext* const GraphicsContext,
 
         RenderResource.modelMatrix = modelMatrix;
         RenderResource.inverseModelMatrix = XMMatrixInverse(nullptr, modelMatrix);
-        RenderResource.lightColor = Light.LightBufferData.lightColor[i];
-        RenderResource.intensityDistance = Light.LightBufferData.intensityDistance[i];
+        RenderResource.lightColor = LightBufferData.lightColor[i];
+        RenderResource.intensityDistance = LightBufferData.intensityDistance[i];
 
         GraphicsContext->SetGraphicsRoot32BitConstants(&RenderResource);
         GraphicsContext->DrawInstanced(36, 1, 0, 0);
@@ -222,13 +536,13 @@ void FScene::RenderLightsDeferred(FGraphicsContext* const GraphicsContext,
 void FScene::RenderEnvironmentMap(FGraphicsContext* const GraphicsContext, FSceneTexture& SceneTexture)
 {
     interlop::ScreenSpaceCubeMapRenderResources RenderResource = {
-        .sceneBufferIndex = GetSceneBuffer().CbvIndex,
+        .sceneBufferIndex = GetSceneBufferCbv(),
         .cubenmapTextureIndex = GetEnvironmentMap()->CubeMapTexture->SrvIndex,
     };
 
     if (GetEnvironmentMap())
     {
-        GetEnvironmentMap()->Render(GraphicsContext, RenderResource, SceneTexture.HDRTexture.get(), SceneTexture.DepthTexture.get());
+        GetEnvironmentMap()->Render(GraphicsContext, RenderResource, SceneTexture.HDRTexture, SceneTexture.DepthTexture);
     }
 }
 
@@ -236,9 +550,14 @@ void FScene::GenerateRaytracingScene(FGraphicsContext* const GraphicsContext)
 {
     std::vector<FRaytracingGeometryContext> RaytracingGeometryContextList;
 
-    for (const auto& Mesh : Meshes)
+    const std::span<const uint32_t> Flags = RenderProxies.GetFlags();
+    const std::span<FMesh* const> ProxyMeshes = RenderProxies.GetMeshes();
+    for (uint32_t ProxyIndex = 0; ProxyIndex < RenderProxies.Num(); ProxyIndex++)
     {
-        Mesh->GatherRaytracingGeometry(RaytracingGeometryContextList);
+        if (Flags[ProxyIndex] & RenderProxyFlag_RaytracingGeometry)
+        {
+            ProxyMeshes[ProxyIndex]->GatherRaytracingGeometry(RaytracingGeometryContextList);
+        }
     }
 
     if (RaytracingGeometryContextList.size() == 0)
@@ -248,3 +567,144 @@ void FScene::GenerateRaytracingScene(FGraphicsContext* const GraphicsContext)
 
     RaytracingScene.GenerateRaytracingScene(GraphicsContext, RaytracingGeometryContextList);
 }
+
+void FScene::BakePVS(const FPVSBakeSettings& Settings)
+{
+    if (IsBakingPVS())
+    {
+        return;
+    }
+
+    std::vector<FPVSMeshGeometry> MeshGeometries(Meshes.size());
+    for (size_t MeshIndex = 0; MeshIndex < Meshes.size(); MeshIndex++)
+    {
+        const FMesh* Mesh = Meshes[MeshIndex].get();
+        const XMMATRIX ModelMatrix = Mesh->GetModelMatrix();
+
+        FPVSMeshGeometry& Geometry = MeshGeometries[MeshIndex];
+        Geometry.Positions.resize(Mesh->CPUPositions.size());
+        for (size_t i = 0; i < Mesh->CPUPositions.size(); i++)
+        {
+            XMStoreFloat3(&Geometry.Positions[i], XMVector3TransformCoord(XMLoadFloat3(&Mesh->CPUPositions[i]), ModelMatrix));
+        }
+        Geometry.Indices = Mesh->CPUIndices;
+        Geometry.Bounds = Mesh->GetWorldBounds();
+    }
+
+    PVSBakeTask = std::async(std::launch::async, [MeshGeometries = std::move(MeshGeometries), Settings, SceneHash = ComputePVSSceneHash()]()
+    {
+        return FPVS::Bake(MeshGeometries, Settings, SceneHash);
+    });
+}
+
+void FScene::WaitForPVSBake()
+{
+    if (IsBakingPVS())
+    {
+        PVSBakeTask.wait();
+        FinishPVSBake();
+    }
+}
+
+void FScene::FinishPVSBake()
+{
+    if (!IsBakingPVS() || PVSBakeTask.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        return;
+    }
+
+    std::unique_ptr<FPVS> BakedPVS = PVSBakeTask.get();
+    if (BakedPVS->GetSceneHash() != ComputePVSSceneHash())
+    {
+        Log("Discarding PVS bake, meshes moved while it ran.");
+        return;
+    }
+
+    PVS = std::move(BakedPVS);
+    PVSCameraCell = FPVS::INVALID_CELL;
+    PVSVisibleBits.clear();
+
+    std::filesystem::create_directories(std::filesystem::path(PVSPath).parent_path());
+    if (!PVS->Save(PVSPath))
+    {
+        Log("Failed to save PVS : " + PVSPath);
+    }
+}
+
+void FScene::InvalidatePVS(const std::string& Reason)
+{
+    Log(std::format("PVS invalidated, {}.", Reason));
+    PVS.reset();
+    PVSCameraCell = FPVS::INVALID_CELL;
+    PVSVisibleBits.clear();
+}
+
+uint64_t FScene::ComputePVSSceneHash() const
+{
+    std::vector<Dx::XMFLOAT4X4> WorldMatrices(Meshes.size());
+    std::vector<FAABB> WorldBounds(Meshes.size());
+    for (size_t MeshIndex = 0; MeshIndex < Meshes.size(); MeshIndex++)
+    {
+        XMStoreFloat4x4(&WorldMatrices[MeshIndex], Meshes[MeshIndex]->GetModelMatrix());
+        WorldBounds[MeshIndex] = Meshes[MeshIndex]->GetWorldBounds();
+    }
+
+    return FPVS::HashScenePlacement(WorldMatrices, WorldBounds);
+}
+
+bool FScene::LoadPVS()
+{
+    std::unique_ptr<FPVS> LoadedPVS = std::make_unique<FPVS>();
+    if (!LoadedPVS->Load(PVSPath))
+    {
+        return false;
+    }
+
+    // Mesh indices are baked into the bitsets and occluders into the cells, so a PVS from another mesh list or
+    // with any mesh placed elsewhere is useless.
+    if (LoadedPVS->GetNumMeshes() != Meshes.size() || LoadedPVS->GetSceneHash() != ComputePVSSceneHash())
+    {
+        Log("Ignoring stale PVS : " + PVSPath);
+        return false;
+    }
+
+    PVS = std::move(LoadedPVS);
+    PVSCameraCell = FPVS::INVALID_CELL;
+    PVSVisibleBits.clear();
+    return true;
+}
+
+void FScene::UpdatePVSVisibility()
+{
+    FinishPVSBake();
+
+    NumPVSCulledMeshes = 0u;
+    if (!RenderSettings.bUsePVS || !PVS || !PVS->IsValid())
+    {
+        return;
+    }
+
+    // Only decompress when the camera moves to another cell.
+    const uint32_t CameraCell = PVS->GetCellIndex(RenderSnapshot->CameraPosition);
+    if (CameraCell != PVSCameraCell || PVSVisibleBits.empty())
+    {
+        PVS->DecodeCell(CameraCell, PVSVisibleBits);
+        PVSCameraCell = CameraCell;
+    }
+
+    for (const uint32_t ObjectId : RenderProxies.GetObjectIds())
+    {
+        NumPVSCulledMeshes += IsPotentiallyVisible(ObjectId) ? 0u : 1u;
+    }
+}
+
+bool FScene::IsPotentiallyVisible(uint32_t MeshIndex) const
+{
+    // Meshes added after the bake are not part of the PVS.
+    if (!RenderSettings.bUsePVS || !PVS || PVSVisibleBits.empty() || MeshIndex >= PVS->GetNumMeshes())
+    {
+        return true;
+    }
+
+    return FPVS::IsVisible(PVSVisibleBits, MeshIndex);
+}
@@ -0,0 +1,194 @@
+#include "Scene/TransformHierarchy.h"
+
+uint32_t FTransformHierarchy::AddNode(uint32_t Parent, const XMFLOAT3& Translation, const XMFLOAT4& Rotation, const XMFLOAT3& Scale)
+{
+    const uint32_t Node = Num();
+    assert(Parent == INVALID_NODE || Parent < Node);
+
+    PushNode(Parent, Translation, Rotation, Scale);
+    UpdateOrder.push_back(Node);
+
+    return Node;
+}
+
+void FTransformHierarchy::PushNode(uint32_t Parent, const XMFLOAT3& Translation, const XMFLOAT4& Rotation, const XMFLOAT3& Scale)
+{
+    Parents.push_back(Parent);
+    LocalTranslations.push_back(Translation);
+    LocalRotations.push_back(Rotation);
+    LocalScales.push_back(Scale);
+    XMStoreFloat4x4(&WorldMatrices.emplace_back(), Dx::XMMatrixIdentity());
+    XMStoreFloat4x4(&InverseWorldMatrices.emplace_back(), Dx::XMMatrixIdentity());
+
+    DirtyFlags.push_back(1u);
+    InverseDirtyFlags.push_back(1u);
+    UpdatedFlags.push_back(0u);
+}
+
+uint32_t FTransformHierarchy::AddNode(uint32_t Parent, const XMMATRIX& LocalMatrix)
+{
+    XMVECTOR Scale, Rotation, Translation;
+    if (!XMMatrixDecompose(&Scale, &Rotation, &Translation, LocalMatrix))
+    {
+        // Shear or a degenerate axis, keep the translation so the node is at least placed correctly.
+        Log("Transform node matrix could not be decomposed, dropping rotation and scale.");
+        Scale = XMVectorSet(1.f, 1.f, 1.f, 0.f);
+        Rotation = Dx::XMQuaternionIdentity();
+        Translation = LocalMatrix.r[3];
+    }
+
+    XMFLOAT3 ScaleF3, TranslationF3;
+    XMFLOAT4 RotationF4;
+    XMStoreFloat3(&ScaleF3, Scale);
+    XMStoreFloat4(&RotationF4, Rotation);
+    XMStoreFloat3(&TranslationF3, Translation);
+
+    return AddNode(Parent, TranslationF3, RotationF4, ScaleF3);
+}
+
+uint32_t FTransformHierarchy::Append(const FTransformHierarchy& Other)
+{
+    const uint32_t Offset = Num();
+    for (uint32_t Node = 0; Node < Other.Num(); Node++)
+    {
+        const uint32_t Parent = Other.Parents[Node];
+        PushNode(Parent == INVALID_NODE ? INVALID_NODE : Parent + Offset,
+            Other.LocalTranslations[Node], Other.LocalRotations[Node], Other.LocalScales[Node]);
+    }
+    // Other may have been reparented, its order is still valid once offset.
+    for (const uint32_t Node : Other.UpdateOrder)
+    {
+        UpdateOrder.push_back(Node + Offset);
+    }
+
+    return Offset;
+}
+
+bool FTransformHierarchy::SetParent(uint32_t Node, uint32_t NewParent)
+{
+    assert(Node < Num() && (NewParent == INVALID_NODE || NewParent < Num()));
+
+    for (uint32_t Ancestor = NewParent; Ancestor != INVALID_NODE; Ancestor = Parents[Ancestor])
+    {
+        if (Ancestor == Node)
+        {
+            return false;
+        }
+    }
+
+    if (Parents[Node] != NewParent)
+    {
+        Parents[Node] = NewParent;
+        DirtyFlags[Node] = 1u;
+        SortUpdateOrder();
+    }
+    return true;
+}
+
+void FTransformHierarchy::SortUpdateOrder()
+{
+    // Sorting by depth puts every parent before its children. Stable, so an order that was already valid
+    // only changes where the moved subtree now sits.
+    std::vector<uint32_t> Depths(Num(), INVALID_NODE);
+    std::vector<uint32_t> Chain;
+    for (uint32_t Node = 0; Node < Num(); Node++)
+    {
+        uint32_t Ancestor = Node;
+        for (; Ancestor != INVALID_NODE && Depths[Ancestor] == INVALID_NODE; Ancestor = Parents[Ancestor])
+        {
+            Chain.push_back(Ancestor);
+        }
+
+        uint32_t Depth = Ancestor == INVALID_NODE ? 0u : Depths[Ancestor] + 1u;
+        for (auto It = Chain.rbegin(); It != Chain.rend(); ++It)
+        {
+            Depths[*It] = Depth++;
+        }
+        Chain.clear();
+    }
+
+    std::stable_sort(UpdateOrder.begin(), UpdateOrder.end(),
+        [&Depths](uint32_t A, uint32_t B) { return Depths[A] < Depths[B]; });
+}
+
+void FTransformHierarchy::SetLocalTranslation(uint32_t Node, const XMFLOAT3& Translation)
+{
+    LocalTranslations[Node] = Translation;
+    DirtyFlags[Node] = 1u;
+}
+
+void FTransformHierarchy::SetLocalRotation(uint32_t Node, const XMFLOAT4& Rotation)
+{
+    LocalRotations[Node] = Rotation;
+    DirtyFlags[Node] = 1u;
+}
+
+void FTransformHierarchy::SetLocalScale(uint32_t Node, const XMFLOAT3& Scale)
+{
+    LocalScales[Node] = Scale;
+    DirtyFlags[Node] = 1u;
+}
+
+void FTransformHierarchy::Update()
+{
+    for (const uint32_t Node : UpdatedNodes)
+    {
+        UpdatedFlags[Node] = 0u;
+    }
+    UpdatedNodes.clear();
+
+    // Parents come first, so a single pass pushes dirtiness all the way down.
+    for (const uint32_t Node : UpdateOrder)
+    {
+        const uint32_t Parent = Parents[Node];
+        if (DirtyFlags[Node] || (Parent != INVALID_NODE && UpdatedFlags[Parent]))
+        {
+            UpdatedFlags[Node] = 1u;
+            UpdatedNodes.push_back(Node);
+        }
+    }
+
+    if (UpdatedNodes.empty())
+    {
+        return;
+    }
+
+    // Local matrices have no dependencies between nodes, compose them in one tight batch.
+    LocalMatrixScratch.resize(UpdatedNodes.size());
+    for (size_t i = 0; i < UpdatedNodes.size(); i++)
+    {
+        const uint32_t Node = UpdatedNodes[i];
+        const XMMATRIX LocalMatrix = Dx::XMMatrixScalingFromVector(XMLoadFloat3(&LocalScales[Node]))
+            * Dx::XMMatrixRotationQuaternion(XMLoadFloat4(&LocalRotations[Node]))
+            * Dx::XMMatrixTranslationFromVector(XMLoadFloat3(&LocalTranslations[Node]));
+        XMStoreFloat4x4(&LocalMatrixScratch[i], LocalMatrix);
+    }
+
+    // Row vectors : local precedes parent. UpdatedNodes follows the update order, so parents are already final.
+    for (size_t i = 0; i < UpdatedNodes.size(); i++)
+    {
+        const uint32_t Node = UpdatedNodes[i];
+        const uint32_t Parent = Parents[Node];
+
+        XMMATRIX WorldMatrix = XMLoadFloat4x4(&LocalMatrixScratch[i]);
+        if (Parent != INVALID_NODE)
+        {
+            WorldMatrix = XMMatrixMultiply(WorldMatrix, XMLoadFloat4x4(&WorldMatrices[Parent]));
+        }
+
+        XMStoreFloat4x4(&WorldMatrices[Node], WorldMatrix);
+        DirtyFlags[Node] = 0u;
+        InverseDirtyFlags[Node] = 1u;
+    }
+}
+
+XMMATRIX FTransformHierarchy::GetInverseWorldMatrix(uint32_t Node)
+{
+    if (InverseDirtyFlags[Node])
+    {
+        XMStoreFloat4x4(&InverseWorldMatrices[Node], XMMatrixInverse(nullptr, GetWorldMatrix(Node)));
+        InverseDirtyFlags[Node] = 0u;
+    }
+
+    return XMLoadFloat4x4(&InverseWorldMatrices[Node]);
+}
@@ -0,0 +1,178 @@
+#include "Test.h"
+#include "Graphics/CommandCapture.h"
+
+#include <fstream>
+
+namespace
+{
+    // Stand-ins for captured objects, only their addresses matter.
+    struct FFakeObjects
+    {
+        int Context = 0;
+        int Pipeline = 0;
+        int Texture = 0;
+        int Buffer = 0;
+    };
+
+    void RecordFrame(FCommandCapture& Capture, const FFakeObjects& Objects)
+    {
+        const uint32_t ContextId = Capture.GetObjectId(&Objects.Context);
+
+        Capture.Record(ContextId, ECapturedCommand::ContextReset);
+        Capture.Record(ContextId, ECapturedCommand::SetPipelineState, Capture::FObject{ Capture.GetObjectId(&Objects.Pipeline) });
+        Capture.Record(ContextId, ECapturedCommand::BeginEvent, "GPass", 5u);
+        Capture.Record(ContextId, ECapturedCommand::SetViewport, Capture::FViewport{ 0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f });
+        Capture.Record(ContextId, ECapturedCommand::DrawInstanced, Capture::FDrawInstanced{ 3u, 1u, 0u, 0u });
+
+        struct
+        {
+            uint32_t NumBarriers;
+            Capture::FBarrier Barrier;
+        } Barriers{ 1u, Capture::FBarrier{ .Resource = Capture.GetObjectId(&Objects.Texture), .StateAfter = 4u } };
+        Capture.Record(ContextId, ECapturedCommand::ResourceBarriers, Barriers);
+
+        Capture.Record(ContextId, ECapturedCommand::CopyResource,
+            Capture::FCopyResource{ Capture.GetObjectId(&Objects.Buffer), Capture.GetObjectId(&Objects.Texture) });
+        Capture.Record(ContextId, ECapturedCommand::EndEvent);
+    }
+
+    std::string GetCapturePath(const char* Name)
+    {
+        return (std::filesystem::temp_directory_path() / Name).string();
+    }
+
+    // Offset of the process token in the file, after the six uint32_t header fields.
+    constexpr std::streamoff PROCESS_TOKEN_OFFSET = 6 * sizeof(uint32_t);
+}
+
+TEST(CommandCapture, RecordingReplayIsByteExact)
+{
+    FFakeObjects Objects;
+    FCommandCapture Capture;
+    RecordFrame(Capture, Objects);
+
+    FCommandCapture Reencoded;
+    FRecordingCommandSink Sink(Reencoded);
+    const FReplayStats Stats = ReplayCommandStream(Capture.GetStream(), Sink);
+
+    CHECK(Stats.NumCommands == Capture.GetNumCommands());
+    CHECK(Stats.PerCommand[static_cast<size_t>(ECapturedCommand::DrawInstanced)].Count == 1u);
+    CHECK(Reencoded.GetStream() == Capture.GetStream());
+}
+
+TEST(CommandCapture, SaveAndLoadRestoresObjectTable)
+{
+    FFakeObjects Objects;
+    FCommandCapture Capture;
+    RecordFrame(Capture, Objects);
+
+    const std::string Path = GetCapturePath("CubiEngineTests.ObjectTable.cubicap");
+    CHECK(Capture.SaveToFile(Path));
+
+    FCommandCapture Loaded;
+    CHECK(Loaded.LoadFromFile(Path));
+    std::filesystem::remove(Path);
+
+    CHECK(Loaded.GetStream() == Capture.GetStream());
+    CHECK(Loaded.GetNumCommands() == Capture.GetNumCommands());
+    CHECK(Loaded.GetNumObjects() == Capture.GetNumObjects());
+    CHECK(Loaded.AreAllObjectsBound());
+    CHECK(Loaded.GetObject(Capture.GetObjectId(&Objects.Pipeline)) == &Objects.Pipeline);
+    CHECK(Loaded.GetObject(Capture.GetObjectId(&Objects.Texture)) == &Objects.Texture);
+
+    // Ids keep being handed out after the loaded ones.
+    int Later = 0;
+    CHECK(Loaded.GetObjectId(&Objects.Buffer) == Capture.GetObjectId(&Objects.Buffer));
+    CHECK(Loaded.GetObjectId(&Later) == Capture.GetNumObjects());
+}
+
+TEST(CommandCapture, ForeignCaptureLoadsUnboundUntilBound)
+{
+    FFakeObjects Objects;
+    FCommandCapture Capture;
+    RecordFrame(Capture, Objects);
+
+    const std::string Path = GetCapturePath("CubiEngineTests.Foreign.cubicap");
+    CHECK(Capture.SaveToFile(Path));
+    {
+        // As if another process had written it.
+        std::fstream File(Path, std::ios::binary | std::ios::in | std::ios::out);
+        const uint64_t ForeignToken = 0x1234u;
+        File.seekp(PROCESS_TOKEN_OFFSET);
+        File.write(reinterpret_cast<const char*>(&ForeignToken), sizeof(ForeignToken));
+    }
+
+    FCommandCapture Loaded;
+    CHECK(Loaded.LoadFromFile(Path));
+    std::filesystem::remove(Path);
+
+    CHECK(Loaded.GetStream() == Capture.GetStream());
+    CHECK(Loaded.GetNumObjects() == Capture.GetNumObjects());
+    CHECK(!Loaded.AreAllObjectsBound());
+    CHECK(Loaded.GetObject(Capture.GetObjectId(&Objects.Texture)) == nullptr);
+
+    FFakeObjects Rebound;
+    const int* ReboundObjects[] = { &Rebound.Context, &Rebound.Pipeline, &Rebound.Texture, &Rebound.Buffer };
+    const int* CapturedObjects[] = { &Objects.Context, &Objects.Pipeline, &Objects.Texture, &Objects.Buffer };
+    for (size_t i = 0; i < _countof(ReboundObjects); i++)
+    {
+        Loaded.BindObject(Capture.GetObjectId(CapturedObjects[i]), ReboundObjects[i]);
+    }
+
+    CHECK(Loaded.AreAllObjectsBound());
+    CHECK(Loaded.GetObject(Capture.GetObjectId(&Objects.Texture)) == &Rebound.Texture);
+    CHECK(Loaded.GetObjectId(&Rebound.Buffer) == Capture.GetObjectId(&Objects.Buffer));
+}
+
+TEST(CommandCapture, TruncatedFileIsRejected)
+{
+    FFakeObjects Objects;
+    FCommandCapture Capture;
+    RecordFrame(Capture, Objects);
+
+    const std::string Path = GetCapturePath("CubiEngineTests.Truncated.cubicap");
+    CHECK(Capture.SaveToFile(Path));
+    std::filesystem::resize_file(Path, std::filesystem::file_size(Path) - sizeof(uint64_t));
+
+    FCommandCapture Loaded;
+    CHECK(!Loaded.LoadFromFile(Path));
+    std::filesystem::remove(Path);
+}
+
+TEST(CommandCapture, ShortPayloadsAreInvalid)
+{
+    const uint8_t Zeroes[sizeof(Capture::FCopyTextureRegion)]{};
+    auto IsValid = [](ECapturedCommand Type, size_t PayloadSize, const void* Payload)
+    {
+        const FCapturedCommandHeader Header{ .Type = Type, .PayloadSize = static_cast<uint16_t>(PayloadSize) };
+        return IsCapturedPayloadValid(Header, static_cast<const uint8_t*>(Payload));
+    };
+
+    CHECK(IsValid(ECapturedCommand::Dispatch, sizeof(Capture::FDispatch), Zeroes));
+    CHECK(!IsValid(ECapturedCommand::Dispatch, sizeof(Capture::FDispatch) - 1u, Zeroes));
+    CHECK(!IsValid(ECapturedCommand::SetPipelineState, 0u, Zeroes));
+    CHECK(!IsValid(ECapturedCommand::CopyTextureRegion, sizeof(Capture::FCopyResource), Zeroes));
+    CHECK(IsValid(ECapturedCommand::EndEvent, 0u, Zeroes));
+    CHECK(!IsValid(ECapturedCommand::Count, 0u, Zeroes));
+
+    struct
+    {
+        Capture::FRoot32BitConstants Constants;
+        uint32_t Values[2];
+    } Constants{ { .Num32BitValues = 2u }, { 1u, 2u } };
+    CHECK(IsValid(ECapturedCommand::SetRoot32BitConstants, sizeof(Constants), &Constants));
+    Constants.Constants.Num32BitValues = 3u;
+    CHECK(!IsValid(ECapturedCommand::SetRoot32BitConstants, sizeof(Constants), &Constants));
+
+    struct
+    {
+        uint32_t NumBarriers;
+        Capture::FBarrier Barriers[1];
+    } Barriers{ 1u, {} };
+    CHECK(IsValid(ECapturedCommand::ResourceBarriers, sizeof(uint32_t) + sizeof(Capture::FBarrier), &Barriers));
+    Barriers.NumBarriers = 2u;
+    CHECK(!IsValid(ECapturedCommand::ResourceBarriers, sizeof(uint32_t) + sizeof(Capture::FBarrier), &Barriers));
+
+    Capture::FRenderTargets Targets{ .NumRtvs = 9u };
+    CHECK(!IsValid(ECapturedCommand::SetRenderTargets, sizeof(Targets), &Targets));
+}
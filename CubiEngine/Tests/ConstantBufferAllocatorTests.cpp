@@ -0,0 +1,211 @@
+#include "Test.h"
+#include "Graphics/ConstantBufferAllocator.h"
+
+namespace
+{
+    // Plain memory instead of an upload buffer, records which CBVs were created and where they point.
+    class FFakeConstantBufferStorage : public FConstantBufferStorage
+    {
+    public:
+        explicit FFakeConstantBufferStorage(uint64_t SizeInBytes)
+            : Memory(SizeInBytes, 0u)
+        {
+        }
+
+        uint8_t* GetMappedData() const override { return const_cast<uint8_t*>(Memory.data()); }
+
+        uint32_t CreateCbv() override
+        {
+            Views.push_back({});
+            return static_cast<uint32_t>(Views.size() - 1u);
+        }
+
+        void WriteCbv(uint32_t Cbv, uint64_t Offset, uint32_t Size) override
+        {
+            Views[Cbv] = { Offset, Size };
+        }
+
+        std::vector<uint8_t> Memory;
+        // Offset and size per CBV.
+        std::vector<std::pair<uint64_t, uint32_t>> Views;
+    };
+
+    constexpr uint64_t TEST_CAPACITY_PER_FRAME = 4u * FLinearConstantAllocator::ALIGNMENT;
+
+    struct FTestConstants
+    {
+        float Values[4];
+    };
+}
+
+TEST(ConstantBufferAllocator, LinearAllocatorAlignsAndFills)
+{
+    FLinearConstantAllocator Allocator(1000u);
+    // Rounded up so every region starts on a placement boundary.
+    CHECK(Allocator.GetCapacityPerFrame() == 1024u);
+
+    const std::optional<FConstantRange> First = Allocator.Allocate(16u);
+    const std::optional<FConstantRange> Second = Allocator.Allocate(300u);
+    CHECK(First && Second);
+    CHECK(First->Offset == 0u && First->Size == 256u && First->Index == 0u);
+    CHECK(Second->Offset == 256u && Second->Size == 512u && Second->Index == 1u);
+    CHECK(Allocator.GetUsedBytes() == 768u);
+
+    CHECK(!Allocator.Allocate(257u).has_value());
+    CHECK(Allocator.Allocate(256u).has_value());
+    CHECK(!Allocator.Allocate(1u).has_value());
+    CHECK(Allocator.GetNumAllocations() == 3u);
+}
+
+TEST(ConstantBufferAllocator, LinearAllocatorCyclesRegions)
+{
+    FLinearConstantAllocator Allocator(TEST_CAPACITY_PER_FRAME);
+    for (uint32_t Frame = 0; Frame < 2u * FRAMES_IN_FLIGHT; Frame++)
+    {
+        const uint32_t Region = Frame % FRAMES_IN_FLIGHT;
+        CHECK(Allocator.GetFrameIndex() == Region);
+        CHECK(Allocator.GetUsedBytes() == 0u);
+
+        // Allocations stay inside the region of the frame.
+        for (uint32_t i = 0; i <= Frame % 4u; i++)
+        {
+            const std::optional<FConstantRange> Range = Allocator.Allocate(64u);
+            CHECK(Range.has_value());
+            CHECK(Range->Offset >= Region * TEST_CAPACITY_PER_FRAME);
+            CHECK(Range->Offset + Range->Size <= (Region + 1u) * TEST_CAPACITY_PER_FRAME);
+            CHECK(Range->Index == i);
+        }
+        Allocator.BeginFrame();
+    }
+    CHECK(Allocator.GetHighWaterMark() == TEST_CAPACITY_PER_FRAME);
+}
+
+TEST(ConstantBufferAllocator, DirtyTrackerSkipsUnchangedContents)
+{
+    FConstantDirtyTracker Tracker;
+    FTestConstants Constants{};
+
+    CHECK(Tracker.Update(&Constants, sizeof(Constants)) == 0u);
+    CHECK(!Tracker.Update(&Constants, sizeof(Constants)).has_value());
+    CHECK(!Tracker.Update(&Constants, sizeof(Constants)).has_value());
+    CHECK(Tracker.GetCurrentCopy() == 0u);
+
+    // Each change moves to the next copy, the ones in flight keep what they were given.
+    for (uint32_t Change = 1; Change <= 2u * FRAMES_IN_FLIGHT; Change++)
+    {
+        Constants.Values[Change % 4u] += 1.f;
+        CHECK(Tracker.Update(&Constants, sizeof(Constants)) == Change % FRAMES_IN_FLIGHT);
+        CHECK(!Tracker.Update(&Constants, sizeof(Constants)).has_value());
+    }
+    CHECK(Tracker.GetNumUploads() == 1u + 2u * FRAMES_IN_FLIGHT);
+    CHECK(Tracker.GetNumSkipped() == 2u + 2u * FRAMES_IN_FLIGHT);
+}
+
+TEST(ConstantBufferAllocator, HashCoversEveryByteAndTheSeed)
+{
+    uint8_t Bytes[37] = {};
+    const uint64_t Hash = FConstantDirtyTracker::Hash(Bytes, sizeof(Bytes));
+    CHECK(FConstantDirtyTracker::Hash(Bytes, sizeof(Bytes)) == Hash);
+    CHECK(FConstantDirtyTracker::Hash(Bytes, sizeof(Bytes), 1u) != Hash);
+    CHECK(FConstantDirtyTracker::Hash(Bytes, sizeof(Bytes) - 1u) != Hash);
+
+    // Whole words and the tail both count.
+    for (size_t i = 0; i < sizeof(Bytes); i++)
+    {
+        Bytes[i] = 1u;
+        CHECK(FConstantDirtyTracker::Hash(Bytes, sizeof(Bytes)) != Hash);
+        Bytes[i] = 0u;
+    }
+}
+
+TEST(ConstantBufferAllocator, CopiesDataBehindTheReturnedView)
+{
+    auto Storage = std::make_unique<FFakeConstantBufferStorage>(TEST_CAPACITY_PER_FRAME * FRAMES_IN_FLIGHT);
+    FFakeConstantBufferStorage& Fake = *Storage;
+    FConstantBufferAllocator Allocator(std::move(Storage), TEST_CAPACITY_PER_FRAME);
+
+    const FTestConstants First = { { 1.f, 2.f, 3.f, 4.f } };
+    const FTestConstants Second = { { 5.f, 6.f, 7.f, 8.f } };
+    const uint32_t FirstCbv = Allocator.Allocate(First);
+    const uint32_t SecondCbv = Allocator.Allocate(Second);
+    CHECK(FirstCbv != SecondCbv);
+
+    for (const auto& [Cbv, Expected] : { std::pair{ FirstCbv, First }, std::pair{ SecondCbv, Second } })
+    {
+        const auto [Offset, Size] = Fake.Views[Cbv];
+        CHECK(Offset % FLinearConstantAllocator::ALIGNMENT == 0u);
+        CHECK(Size == FLinearConstantAllocator::ALIGNMENT);
+        CHECK(std::memcmp(Fake.Memory.data() + Offset, &Expected, sizeof(Expected)) == 0);
+    }
+}
+
+TEST(ConstantBufferAllocator, SteadyFramesReuseViews)
+{
+    auto Storage = std::make_unique<FFakeConstantBufferStorage>(TEST_CAPACITY_PER_FRAME * FRAMES_IN_FLIGHT);
+    FFakeConstantBufferStorage& Fake = *Storage;
+    FConstantBufferAllocator Allocator(std::move(Storage), TEST_CAPACITY_PER_FRAME);
+
+    std::array<std::vector<uint32_t>, FRAMES_IN_FLIGHT> CbvsPerRegion{};
+    for (uint32_t Frame = 0; Frame < 4u * FRAMES_IN_FLIGHT; Frame++)
+    {
+        std::vector<uint32_t> Cbvs;
+        for (uint32_t i = 0; i < 3u; i++)
+        {
+            Cbvs.push_back(Allocator.Allocate(FTestConstants{ { float(Frame), float(i) } }));
+        }
+
+        std::vector<uint32_t>& Expected = CbvsPerRegion[Frame % FRAMES_IN_FLIGHT];
+        if (Expected.empty())
+        {
+            Expected = Cbvs;
+        }
+        CHECK(Cbvs == Expected);
+        Allocator.BeginFrame();
+    }
+
+    // Three views per region, created once.
+    CHECK(Fake.Views.size() == 3u * FRAMES_IN_FLIGHT);
+}
+
+TEST(ConstantBufferAllocator, ConcurrentAllocationsGetDistinctRanges)
+{
+    constexpr uint32_t NumThreads = 4u;
+    constexpr uint32_t NumPerThread = 64u;
+    constexpr uint64_t CapacityPerFrame = NumThreads * NumPerThread * FLinearConstantAllocator::ALIGNMENT;
+
+    auto Storage = std::make_unique<FFakeConstantBufferStorage>(CapacityPerFrame * FRAMES_IN_FLIGHT);
+    FFakeConstantBufferStorage& Fake = *Storage;
+    FConstantBufferAllocator Allocator(std::move(Storage), CapacityPerFrame);
+
+    std::array<std::vector<uint32_t>, NumThreads> Cbvs{};
+    {
+        std::vector<std::jthread> Threads;
+        for (uint32_t Thread = 0; Thread < NumThreads; Thread++)
+        {
+            Threads.emplace_back([&, Thread]()
+            {
+                for (uint32_t i = 0; i < NumPerThread; i++)
+                {
+                    Cbvs[Thread].push_back(Allocator.Allocate(FTestConstants{ { float(Thread), float(i) } }));
+                }
+            });
+        }
+    }
+
+    std::vector<uint64_t> Offsets;
+    for (uint32_t Thread = 0; Thread < NumThreads; Thread++)
+    {
+        for (uint32_t i = 0; i < NumPerThread; i++)
+        {
+            const uint64_t Offset = Fake.Views[Cbvs[Thread][i]].first;
+            Offsets.push_back(Offset);
+
+            // Nobody else wrote over this thread's constants.
+            FTestConstants Stored;
+            std::memcpy(&Stored, Fake.Memory.data() + Offset, sizeof(Stored));
+            CHECK(Stored.Values[0] == float(Thread) && Stored.Values[1] == float(i));
+        }
+    }
+    std::sort(Offsets.begin(), Offsets.end());
+    CHECK(std::unique(Offsets.begin(), Offsets.end()) == Offsets.end());
+}
@@ -0,0 +1,142 @@
+#include "Test.h"
+#include "Graphics/DeferredReleaseQueue.h"
+
+namespace
+{
+    // Counts its destruction, what a resource handing its memory back looks like to the queue.
+    struct FTracked
+    {
+        explicit FTracked(std::atomic<uint32_t>* InNumDestroyed) : NumDestroyed(InNumDestroyed) {}
+        FTracked(FTracked&& Other) noexcept : NumDestroyed(std::exchange(Other.NumDestroyed, nullptr)) {}
+        ~FTracked()
+        {
+            if (NumDestroyed)
+            {
+                (*NumDestroyed)++;
+            }
+        }
+
+        std::atomic<uint32_t>* NumDestroyed;
+    };
+}
+
+TEST(DeferredReleaseQueue, RetiresInOrder)
+{
+    FDeferredReleaseQueue Queue;
+    std::atomic<uint32_t> NumDestroyed{ 0u };
+    uint32_t NumCalled = 0u;
+
+    Queue.Enqueue(3u, FTracked(&NumDestroyed), 100u);
+    Queue.Enqueue(5u, std::make_unique<FTracked>(&NumDestroyed), 50u);
+    // Tagged lower than the entry before it, waits for that one.
+    Queue.EnqueueCallback(4u, [&]() { NumCalled++; }, 10u);
+    CHECK(NumDestroyed == 0u);
+    CHECK(Queue.GetStats().NumPending == 3u);
+    CHECK(Queue.GetStats().PendingBytes == 160u);
+
+    CHECK(Queue.Retire(2u) == 0u);
+    CHECK(Queue.Retire(4u) == 1u);
+    CHECK(NumDestroyed == 1u && NumCalled == 0u);
+    CHECK(Queue.Retire(5u) == 2u);
+    CHECK(NumDestroyed == 2u && NumCalled == 1u);
+
+    const FDeferredReleaseStats Stats = Queue.GetStats();
+    CHECK(Stats.NumPending == 0u);
+    CHECK(Stats.PendingBytes == 0u);
+    CHECK(Stats.PeakPendingBytes == 160u);
+    CHECK(Stats.NumReleased == 3u);
+    CHECK(Stats.ReleasedBytes == 160u);
+}
+
+TEST(DeferredReleaseQueue, OpenBatchWaitsForItsClose)
+{
+    FDeferredReleaseQueue Queue;
+    std::atomic<uint32_t> NumDestroyed{ 0u };
+
+    // Past any completed value, the open batch still waits for the frame's signal.
+    Queue.Enqueue(FDeferredReleaseQueue::OPEN_BATCH, FTracked(&NumDestroyed), 7u);
+    Queue.Enqueue(6u, FTracked(&NumDestroyed));
+    CHECK(Queue.Retire(UINT64_MAX - 1u) == 1u);
+    CHECK(NumDestroyed == 1u);
+
+    Queue.CloseBatch(8u);
+    // Nothing open, closing is a no-op.
+    Queue.CloseBatch(9u);
+    CHECK(Queue.Retire(7u) == 0u);
+    CHECK(Queue.Retire(8u) == 1u);
+    CHECK(NumDestroyed == 2u);
+    CHECK(Queue.GetStats().NumPending == 0u);
+}
+
+TEST(DeferredReleaseQueue, ReleaseMayEnqueueMore)
+{
+    FDeferredReleaseQueue Queue;
+    std::atomic<uint32_t> NumDestroyed{ 0u };
+
+    // E.g. a texture handing its descriptors back from its destructor.
+    Queue.EnqueueCallback(10u, [&]() { Queue.Enqueue(11u, FTracked(&NumDestroyed)); });
+    CHECK(Queue.Retire(10u) == 1u);
+    CHECK(Queue.GetStats().NumPending == 1u);
+
+    Queue.Enqueue(FDeferredReleaseQueue::OPEN_BATCH, FTracked(&NumDestroyed));
+    CHECK(Queue.RetireAll() == 2u);
+    CHECK(NumDestroyed == 2u);
+}
+
+TEST(DeferredReleaseQueue, StressNeverReleasesEarly)
+{
+    // Producers enqueue into the open batch and with their last use, a render thread closes the batch and sweeps
+    // every frame with the GPU a couple of frames behind. Producers only count violations, the test thread checks them.
+    constexpr uint32_t NumThreads = 8u;
+    constexpr uint32_t NumIterations = 20000u;
+
+    FDeferredReleaseQueue Queue;
+    std::atomic<uint64_t> FenceValue{ 0u };
+    std::atomic<uint64_t> CompletedFenceValue{ 0u };
+    std::atomic<bool> bStop{ false };
+    std::atomic<uint32_t> NumReleased{ 0u };
+    std::atomic<uint32_t> NumEarly{ 0u };
+
+    std::thread RenderThread([&]() {
+        while (!bStop.load())
+        {
+            const uint64_t Signal = ++FenceValue;
+            Queue.CloseBatch(Signal);
+            if (Signal > 2u)
+            {
+                CompletedFenceValue.store(Signal - 2u);
+            }
+            Queue.Retire(CompletedFenceValue.load());
+            std::this_thread::yield();
+        }
+    });
+
+    {
+        std::vector<std::jthread> Producers;
+        for (uint32_t Thread = 0; Thread < NumThreads; Thread++)
+        {
+            Producers.emplace_back([&]() {
+                for (uint32_t Iteration = 0; Iteration < NumIterations; Iteration++)
+                {
+                    // Last used by the next signal.
+                    const uint64_t LastUse = FenceValue.load() + 1u;
+                    Queue.EnqueueCallback(Iteration % 2u ? FDeferredReleaseQueue::OPEN_BATCH : LastUse, [&, LastUse]() {
+                        NumEarly += (CompletedFenceValue.load() < LastUse && !bStop.load()) ? 1u : 0u;
+                        NumReleased++;
+                    }, 64u);
+                }
+            });
+        }
+    }
+
+    bStop = true;
+    RenderThread.join();
+    Queue.RetireAll();
+
+    const FDeferredReleaseStats Stats = Queue.GetStats();
+    CHECK(NumEarly.load() == 0u);
+    CHECK(NumReleased.load() == NumThreads * NumIterations);
+    CHECK(Stats.NumReleased == NumThreads * NumIterations);
+    CHECK(Stats.PendingBytes == 0u);
+    CHECK(Stats.PeakPendingBytes <= uint64_t(NumThreads) * NumIterations * 64u);
+}
@@ -0,0 +1,308 @@
+#include "Test.h"
+#include "Graphics/DescriptorAllocator.h"
+
+#include <set>
+
+namespace
+{
+    // What FDescriptorHeap did before the allocator, the baseline of the contention benchmark.
+    class FMutexDescriptorAllocator
+    {
+    public:
+        explicit FMutexDescriptorAllocator(uint32_t InNumDescriptors) : NumDescriptors(InNumDescriptors) {}
+
+        uint32_t Allocate()
+        {
+            std::scoped_lock Lock(Mutex);
+            if (!FreeSlots.empty())
+            {
+                const uint32_t Index = FreeSlots.back();
+                FreeSlots.pop_back();
+                return Index;
+            }
+            return NextIndex < NumDescriptors ? NextIndex++ : INVALID_INDEX_U32;
+        }
+
+        void Free(uint32_t Index)
+        {
+            std::scoped_lock Lock(Mutex);
+            FreeSlots.push_back(Index);
+        }
+
+    private:
+        const uint32_t NumDescriptors;
+        uint32_t NextIndex = 0u;
+        std::vector<uint32_t> FreeSlots;
+        std::mutex Mutex;
+    };
+
+    // Workers allocate and free against a fake fence, a render thread advances it, closes the open batch and
+    // releases the completed slots every frame with the GPU a couple of frames behind. Workers only count
+    // violations, the test thread checks them.
+    void RunStress(uint32_t NumThreads, uint32_t NumDescriptors, uint32_t NumIterations, bool bOpenBatch)
+    {
+        FDescriptorAllocator Allocator(NumDescriptors);
+        std::atomic<uint64_t> NextFenceValue{ 1u };
+        std::atomic<uint64_t> CompletedFenceValue{ 0u };
+
+        // Thread holding each slot, and the fence value current when it was freed : it cannot be handed out again
+        // before that value completed.
+        std::unique_ptr<std::atomic<uint32_t>[]> Owners = std::make_unique<std::atomic<uint32_t>[]>(NumDescriptors);
+        std::unique_ptr<std::atomic<uint64_t>[]> FreedAt = std::make_unique<std::atomic<uint64_t>[]>(NumDescriptors);
+        for (uint32_t Index = 0; Index < NumDescriptors; Index++)
+        {
+            Owners[Index] = INVALID_INDEX_U32;
+            FreedAt[Index] = 0u;
+        }
+
+        std::atomic<uint32_t> NumViolations{ 0u };
+        std::atomic<uint64_t> NumAllocations{ 0u };
+        std::atomic<bool> bStop{ false };
+
+        std::thread RenderThread([&]() {
+            while (!bStop.load())
+            {
+                const uint64_t FenceValue = NextFenceValue.fetch_add(1u);
+                Allocator.CloseBatch(FenceValue);
+                if (FenceValue > 2u)
+                {
+                    CompletedFenceValue.store(FenceValue - 2u);
+                }
+                Allocator.ReleaseRetired(CompletedFenceValue.load());
+                std::this_thread::yield();
+            }
+        });
+
+        {
+            std::vector<std::jthread> Workers;
+            for (uint32_t Thread = 0; Thread < NumThreads; Thread++)
+            {
+                Workers.emplace_back([&, Thread]() {
+                    const auto Free = [&](uint32_t Index) {
+                        uint32_t Expected = Thread;
+                        NumViolations += Owners[Index].compare_exchange_strong(Expected, INVALID_INDEX_U32) ? 0u : 1u;
+                        const uint64_t FenceValue = NextFenceValue.load();
+                        FreedAt[Index].store(FenceValue);
+                        Allocator.Free(Index, bOpenBatch ? FDescriptorAllocator::OPEN_BATCH : FenceValue);
+                    };
+
+                    std::mt19937 Random(Thread);
+                    std::vector<uint32_t> Held;
+                    for (uint32_t Iteration = 0; Iteration < NumIterations; Iteration++)
+                    {
+                        if (Held.empty() || (Held.size() < 40u && Random() % 3u != 0u))
+                        {
+                            const uint32_t Index = Allocator.Allocate();
+                            if (Index == INVALID_INDEX_U32)
+                            {
+                                std::this_thread::yield();
+                                continue;
+                            }
+
+                            uint32_t Expected = INVALID_INDEX_U32;
+                            if (Index >= NumDescriptors || !Owners[Index].compare_exchange_strong(Expected, Thread))
+                            {
+                                NumViolations++;
+                                continue;
+                            }
+                            NumViolations += (FreedAt[Index].load() <= CompletedFenceValue.load() && Allocator.IsAllocated(Index)) ? 0u : 1u;
+                            Held.push_back(Index);
+                            NumAllocations++;
+                        }
+                        else
+                        {
+                            const size_t Slot = Random() % Held.size();
+                            const uint32_t Index = Held[Slot];
+                            Held[Slot] = Held.back();
+                            Held.pop_back();
+                            Free(Index);
+                        }
+                    }
+                    for (const uint32_t Index : Held)
+                    {
+                        Free(Index);
+                    }
+                });
+            }
+        }
+
+        bStop = true;
+        RenderThread.join();
+
+        CHECK(NumViolations.load() == 0u);
+        CHECK(NumAllocations.load() > 0u);
+
+        // Every slot is reachable again, but for those sitting in the caches of the exited workers.
+        Allocator.CloseBatch(NextFenceValue.load());
+        Allocator.ReleaseRetired(UINT64_MAX);
+        uint32_t NumReachable = 0u;
+        while (Allocator.Allocate() != INVALID_INDEX_U32)
+        {
+            NumReachable++;
+        }
+        CHECK(NumReachable + NumThreads * Allocator.GetBatchSize() >= NumDescriptors);
+    }
+
+    // Nanoseconds per allocation or free, every thread allocating 16 slots and freeing them again.
+    template<typename TAllocate, typename TFree>
+    double MeasureContention(uint32_t NumThreads, uint32_t NumIterations, TAllocate&& Allocate, TFree&& Free)
+    {
+        const FBenchmarkTimer Timer;
+        {
+            std::vector<std::jthread> Threads;
+            for (uint32_t Thread = 0; Thread < NumThreads; Thread++)
+            {
+                Threads.emplace_back([&]() {
+                    std::array<uint32_t, 16u> Held{};
+                    for (uint32_t Iteration = 0; Iteration < NumIterations; Iteration++)
+                    {
+                        for (uint32_t& Index : Held)
+                        {
+                            Index = Allocate();
+                        }
+                        for (const uint32_t Index : Held)
+                        {
+                            Free(Index);
+                        }
+                    }
+                });
+            }
+        }
+        return Timer.GetElapsedMs() * 1.0e6 / (static_cast<double>(NumThreads) * NumIterations * 16u * 2u);
+    }
+}
+
+TEST(DescriptorAllocator, HandsOutEverySlotOnce)
+{
+    FDescriptorAllocator Allocator(10000u);
+    CHECK(Allocator.GetBatchSize() == FDescriptorAllocator::MAX_BATCH_SIZE);
+
+    std::set<uint32_t> Allocated;
+    for (uint32_t Index = 0; Index < 10000u; Index++)
+    {
+        const uint32_t Slot = Allocator.Allocate();
+        CHECK(Slot < 10000u);
+        CHECK(Allocated.insert(Slot).second);
+    }
+    CHECK(Allocator.Allocate() == INVALID_INDEX_U32);
+    CHECK(*Allocated.begin() == 0u);
+}
+
+TEST(DescriptorAllocator, FreesWaitForTheirFenceValue)
+{
+    FDescriptorAllocator Allocator(10000u);
+    while (Allocator.Allocate() != INVALID_INDEX_U32)
+    {
+    }
+
+    for (uint32_t Index = 0; Index < 100u; Index++)
+    {
+        Allocator.Free(Index, Index < 50u ? 5u : 10u);
+    }
+    CHECK(Allocator.Allocate() == INVALID_INDEX_U32);
+    CHECK(Allocator.ReleaseRetired(4u) == 0u);
+    CHECK(Allocator.Allocate() == INVALID_INDEX_U32);
+
+    CHECK(Allocator.ReleaseRetired(5u) == 50u);
+    std::set<uint32_t> Reused;
+    for (uint32_t Index = 0; Index < 50u; Index++)
+    {
+        const uint32_t Slot = Allocator.Allocate();
+        CHECK(Slot < 50u);
+        CHECK(Reused.insert(Slot).second);
+    }
+    CHECK(Allocator.Allocate() == INVALID_INDEX_U32);
+
+    // The slots still waiting are picked up by the next release.
+    CHECK(Allocator.ReleaseRetired(10u) == 50u);
+    for (uint32_t Index = 0; Index < 50u; Index++)
+    {
+        const uint32_t Slot = Allocator.Allocate();
+        CHECK(Slot >= 50u && Slot < 100u);
+    }
+    CHECK(Allocator.Allocate() == INVALID_INDEX_U32);
+}
+
+TEST(DescriptorAllocator, OpenBatchWaitsForItsClose)
+{
+    FDescriptorAllocator Allocator(7u);
+    CHECK(Allocator.GetBatchSize() == 1u);
+    for (uint32_t Index = 0; Index < 7u; Index++)
+    {
+        CHECK(Allocator.Allocate() == Index);
+    }
+
+    // Freed during the frame, before the frame's signal is known.
+    Allocator.Free(3u, FDescriptorAllocator::OPEN_BATCH);
+    CHECK(Allocator.ReleaseRetired(UINT64_MAX - 1u) == 0u);
+    CHECK(Allocator.Allocate() == INVALID_INDEX_U32);
+
+    Allocator.CloseBatch(12u);
+    CHECK(Allocator.ReleaseRetired(11u) == 0u);
+    CHECK(Allocator.ReleaseRetired(12u) == 1u);
+    CHECK(Allocator.Allocate() == 3u);
+
+    // Nothing open, closing is a no-op.
+    Allocator.CloseBatch(13u);
+    CHECK(Allocator.ReleaseRetired(13u) == 0u);
+}
+
+TEST(DescriptorAllocator, StressLargeHeap)
+{
+    RunStress(8u, 10000u, 20000u, false);
+}
+
+TEST(DescriptorAllocator, StressSmallHeap)
+{
+    // Runs dry often, the workers keep hitting the fresh slot and the pool paths at once.
+    RunStress(16u, 500u, 10000u, false);
+}
+
+TEST(DescriptorAllocator, StressManyThreads)
+{
+    RunStress(32u, 1024u, 5000u, false);
+}
+
+TEST(DescriptorAllocator, StressOpenBatch)
+{
+    RunStress(16u, 1024u, 10000u, true);
+}
+
+TEST(DescriptorAllocatorBenchmark, Contention)
+{
+    constexpr uint32_t NumDescriptors = 1u << 20u;
+    constexpr uint32_t NumIterations = 100000u;
+
+    for (const uint32_t NumThreads : { 1u, 4u, 8u, 16u })
+    {
+        FMutexDescriptorAllocator MutexAllocator(NumDescriptors);
+        const double MutexNs = MeasureContention(NumThreads, NumIterations,
+            [&]() { return MutexAllocator.Allocate(); },
+            [&](uint32_t Index) { MutexAllocator.Free(Index); });
+
+        FDescriptorAllocator Allocator(NumDescriptors);
+        std::atomic<bool> bStop{ false };
+        std::thread RenderThread([&]() {
+            while (!bStop.load())
+            {
+                Allocator.ReleaseRetired(UINT64_MAX);
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }
+        });
+        // Frees only come back with the render thread's release, a thread running ahead of it waits.
+        const double LockFreeNs = MeasureContention(NumThreads, NumIterations,
+            [&]() {
+                uint32_t Index = Allocator.Allocate();
+                for (; Index == INVALID_INDEX_U32; Index = Allocator.Allocate())
+                {
+                    std::this_thread::yield();
+                }
+                return Index;
+            },
+            [&](uint32_t Index) { Allocator.Free(Index, 0u); });
+        bStop = true;
+        RenderThread.join();
+
+        Log(std::format("{} threads : mutex {:.1f} ns/op, lock free {:.1f} ns/op", NumThreads, MutexNs, LockFreeNs));
+    }
+}
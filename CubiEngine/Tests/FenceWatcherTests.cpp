@@ -0,0 +1,175 @@
+#include "Test.h"
+#include "Graphics/FenceWatcher.h"
+
+namespace
+{
+    // Polls instead of sleeping a fixed time, the watcher thread runs callbacks asynchronously.
+    template<typename TPredicate>
+    bool WaitUntil(TPredicate Predicate)
+    {
+        const auto Deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!Predicate())
+        {
+            if (std::chrono::steady_clock::now() > Deadline)
+            {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+}
+
+TEST(FenceWatcher, CallbackRunsOnWatcherThreadOnceValueCompletes)
+{
+    FFakeFence Fence;
+    FFenceWatcher Watcher(Fence);
+
+    std::atomic<bool> bRan{ false };
+    std::thread::id CallbackThread{};
+    Watcher.OnCompletion(2u, [&]()
+    {
+        CallbackThread = std::this_thread::get_id();
+        bRan = true;
+    });
+
+    Fence.Signal(1u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(!bRan.load());
+    CHECK(Watcher.GetNumPendingCallbacks() == 1u);
+
+    Fence.Signal(2u);
+    Watcher.WaitForCallbacks(2u);
+    CHECK(bRan.load());
+    CHECK(CallbackThread != std::this_thread::get_id());
+    CHECK(Watcher.GetNumPendingCallbacks() == 0u);
+}
+
+TEST(FenceWatcher, AlreadyCompletedValueStillRunsOnWatcherThread)
+{
+    FFakeFence Fence;
+    Fence.Signal(10u);
+    FFenceWatcher Watcher(Fence);
+
+    std::atomic<bool> bRan{ false };
+    std::thread::id CallbackThread{};
+    Watcher.OnCompletion(5u, [&]()
+    {
+        CallbackThread = std::this_thread::get_id();
+        bRan = true;
+    });
+
+    Watcher.WaitForCallbacks(5u);
+    CHECK(bRan.load());
+    CHECK(CallbackThread != std::this_thread::get_id());
+}
+
+TEST(FenceWatcher, CallbacksRunByValueThenRegistrationOrder)
+{
+    FFakeFence Fence;
+    FFenceWatcher Watcher(Fence);
+
+    std::mutex OrderMutex;
+    std::vector<uint32_t> Order;
+    auto Record = [&](uint32_t Id)
+    {
+        return [&, Id]()
+        {
+            std::lock_guard Lock(OrderMutex);
+            Order.push_back(Id);
+        };
+    };
+
+    // The watcher is already blocked on 30 when 10 arrives, it has to re-target.
+    Watcher.OnCompletion(30u, Record(4u));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    Watcher.OnCompletion(10u, Record(0u));
+    Watcher.OnCompletion(20u, Record(2u));
+    Watcher.OnCompletion(10u, Record(1u));
+    Watcher.OnCompletion(20u, Record(3u));
+
+    Fence.Signal(10u);
+    CHECK(WaitUntil([&]() { std::lock_guard Lock(OrderMutex); return Order.size() == 2u; }));
+
+    Fence.Signal(30u);
+    Watcher.WaitForCallbacks(30u);
+
+    CHECK((Order == std::vector<uint32_t>{ 0u, 1u, 2u, 3u, 4u }));
+}
+
+TEST(FenceWatcher, WaitForCallbacksLeavesLaterValuesPending)
+{
+    FFakeFence Fence;
+    FFenceWatcher Watcher(Fence);
+
+    std::atomic<uint32_t> NumRan{ 0u };
+    Watcher.OnCompletion(1u, [&]() { NumRan++; });
+    Watcher.OnCompletion(3u, [&]() { NumRan++; });
+
+    Fence.Signal(2u);
+    Watcher.WaitForCallbacks(2u);
+    CHECK(NumRan.load() == 1u);
+    CHECK(Watcher.GetNumPendingCallbacks() == 1u);
+
+    Fence.Signal(3u);
+    Watcher.WaitForCallbacks(3u);
+    CHECK(NumRan.load() == 2u);
+}
+
+TEST(FenceWatcher, DestructionRunsCompletedCallbacks)
+{
+    FFakeFence Fence;
+    std::atomic<uint32_t> NumRan{ 0u };
+    {
+        FFenceWatcher Watcher(Fence);
+        for (uint32_t Value = 1u; Value <= 100u; Value++)
+        {
+            Watcher.OnCompletion(Value, [&]() { NumRan++; });
+        }
+        // Destroyed right after the signal, nothing may be dropped.
+        Fence.Signal(100u);
+    }
+    CHECK(NumRan.load() == 100u);
+}
+
+TEST(FenceWatcher, ConcurrentRegistrationWhileSignaling)
+{
+    FFakeFence Fence;
+    FFenceWatcher Watcher(Fence);
+
+    constexpr uint32_t NumThreads = 4u;
+    constexpr uint32_t NumCallbacksPerThread = 2000u;
+    constexpr uint64_t LastValue = 1000u;
+
+    std::atomic<uint32_t> NumRan{ 0u };
+    std::atomic<uint32_t> NumEarly{ 0u };
+    std::vector<std::thread> Threads;
+    for (uint32_t ThreadIndex = 0; ThreadIndex < NumThreads; ThreadIndex++)
+    {
+        Threads.emplace_back([&, ThreadIndex]()
+        {
+            for (uint32_t i = 0; i < NumCallbacksPerThread; i++)
+            {
+                const uint64_t Value = 1u + (i * 7u + ThreadIndex * 13u) % LastValue;
+                Watcher.OnCompletion(Value, [&, Value]()
+                {
+                    NumEarly += Fence.GetCompletedValue() < Value ? 1u : 0u;
+                    NumRan++;
+                });
+            }
+        });
+    }
+
+    for (uint64_t Value = 1u; Value <= LastValue; Value++)
+    {
+        Fence.Signal(Value);
+    }
+    for (std::thread& Thread : Threads)
+    {
+        Thread.join();
+    }
+
+    Watcher.WaitForCallbacks(LastValue);
+    CHECK(NumEarly.load() == 0u);
+    CHECK(NumRan.load() == NumThreads * NumCallbacksPerThread);
+}
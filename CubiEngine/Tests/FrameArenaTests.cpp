@@ -0,0 +1,248 @@
+#include "Test.h"
+#include "Core/FrameArena.h"
+
+namespace
+{
+    bool IsAligned(const void* Pointer, size_t Alignment)
+    {
+        return (reinterpret_cast<size_t>(Pointer) & (Alignment - 1u)) == 0u;
+    }
+}
+
+TEST(FrameArena, AllocationsAreAlignedAndDisjoint)
+{
+    FLinearArena Arena(4096u);
+
+    struct FRange
+    {
+        uint8_t* Begin;
+        size_t Size;
+        uint8_t Pattern;
+    };
+    std::vector<FRange> Ranges;
+
+    for (uint32_t i = 0; i < 2000u; i++)
+    {
+        const size_t Alignment = size_t(1u) << (i % 7u);
+        const size_t Size = 1u + (i * 37u) % 300u;
+        uint8_t* Memory = static_cast<uint8_t*>(Arena.Allocate(Size, Alignment));
+        CHECK(IsAligned(Memory, Alignment));
+
+        const uint8_t Pattern = static_cast<uint8_t>(i);
+        std::memset(Memory, Pattern, Size);
+        Ranges.push_back({ Memory, Size, Pattern });
+    }
+
+    // Any overlap, including one across a chained block, would have overwritten an earlier pattern.
+    for (const FRange& Range : Ranges)
+    {
+        for (size_t i = 0; i < Range.Size; i++)
+        {
+            CHECK(Range.Begin[i] == Range.Pattern);
+        }
+    }
+}
+
+TEST(FrameArena, OverflowChainsThenCoalescesOnReset)
+{
+    constexpr size_t BlockSize = 1024u;
+    FLinearArena Arena(BlockSize);
+
+    auto RunWorkload = [&]()
+    {
+        for (uint32_t i = 0; i < 100u; i++)
+        {
+            Arena.Allocate(100u, 16u);
+        }
+    };
+
+    RunWorkload();
+    CHECK(Arena.GetCapacity() > BlockSize);
+    const size_t UsedBytes = Arena.GetUsedBytes();
+    CHECK(UsedBytes >= 100u * 100u);
+
+    Arena.Reset();
+    CHECK(Arena.GetUsedBytes() == 0u);
+    CHECK(Arena.GetHighWaterMark() == UsedBytes);
+
+    // The same load now fits one block, so a second round chains nothing.
+    RunWorkload();
+    const size_t CapacityAfterGrow = Arena.GetCapacity();
+    CHECK(CapacityAfterGrow >= 100u * 100u);
+    Arena.Reset();
+    RunWorkload();
+    CHECK(Arena.GetCapacity() == CapacityAfterGrow);
+}
+
+TEST(FrameArena, AllocationLargerThanBlock)
+{
+    FLinearArena Arena(256u);
+    Arena.Allocate(16u);
+
+    uint8_t* Large = static_cast<uint8_t*>(Arena.Allocate(10000u, 64u));
+    CHECK(IsAligned(Large, 64u));
+    std::memset(Large, 0xAB, 10000u);
+    CHECK(Large[9999] == 0xAB);
+    CHECK(Arena.GetCapacity() >= 10000u);
+}
+
+TEST(FrameArena, ResetPoisonsInDebugBuilds)
+{
+    if constexpr (!DEBUG_MODE)
+    {
+        return;
+    }
+
+    FLinearArena Arena(4096u);
+    uint32_t* Values = static_cast<uint32_t*>(Arena.Allocate(64u * sizeof(uint32_t), alignof(uint32_t)));
+    for (uint32_t i = 0; i < 64u; i++)
+    {
+        Values[i] = i;
+    }
+
+    // No overflow, so the block survives the reset and the stale pointer still points into it.
+    Arena.Reset();
+    const uint8_t* Bytes = reinterpret_cast<const uint8_t*>(Values);
+    for (size_t i = 0; i < 64u * sizeof(uint32_t); i++)
+    {
+        CHECK(Bytes[i] == 0xDD);
+    }
+}
+
+TEST(FrameArena, ArenaVectorAllocatesFromArena)
+{
+    FLinearArena Arena(64u * 1024u);
+
+    TArenaVector<uint32_t> Values{ TArenaAllocator<uint32_t>(Arena) };
+    Values.reserve(1000u);
+    const size_t UsedAfterReserve = Arena.GetUsedBytes();
+    CHECK(UsedAfterReserve >= 1000u * sizeof(uint32_t));
+
+    for (uint32_t i = 0; i < 1000u; i++)
+    {
+        Values.push_back(i * 3u);
+    }
+    CHECK(Arena.GetUsedBytes() == UsedAfterReserve);
+
+    // Growing past the reservation leaves the old buffer in the arena.
+    Values.push_back(0u);
+    CHECK(Arena.GetUsedBytes() > UsedAfterReserve);
+    for (uint32_t i = 0; i < 1000u; i++)
+    {
+        CHECK(Values[i] == i * 3u);
+    }
+
+    // Rebinding keeps the arena, so node based containers work too.
+    const TArenaAllocator<uint64_t> Rebound(Values.get_allocator());
+    CHECK(Rebound == Values.get_allocator());
+}
+
+TEST(FrameArena, FrameArenasLiveForFramesInFlight)
+{
+    GFrameArenas.BeginFrame();
+    FLinearArena& FirstArena = GetFrameArena();
+    CHECK(&FirstArena == &GetFrameArena());
+
+    uint32_t* Value = FirstArena.New<uint32_t>(0x12345678u);
+
+    // Still valid while the frame is in flight.
+    for (uint32_t Frame = 1; Frame < FRAMES_IN_FLIGHT; Frame++)
+    {
+        GFrameArenas.BeginFrame();
+        FLinearArena& Arena = GetFrameArena();
+        CHECK(&Arena != &FirstArena);
+        Arena.Allocate(128u);
+        CHECK(*Value == 0x12345678u);
+    }
+
+    // FRAMES_IN_FLIGHT frames later the slot comes around again and is reset on first use.
+    GFrameArenas.BeginFrame();
+    FLinearArena& Reused = GetFrameArena();
+    CHECK(&Reused == &FirstArena);
+    CHECK(Reused.GetUsedBytes() == 0u);
+}
+
+TEST(FrameArena, ThreadsGetTheirOwnArenas)
+{
+    GFrameArenas.BeginFrame();
+    FLinearArena* MainArena = &GetFrameArena();
+
+    constexpr uint32_t NumThreads = 4u;
+    std::array<FLinearArena*, NumThreads> ThreadArenas{};
+    std::atomic<uint32_t> NumCorrupted{ 0u };
+
+    std::vector<std::thread> Threads;
+    for (uint32_t ThreadIndex = 0; ThreadIndex < NumThreads; ThreadIndex++)
+    {
+        Threads.emplace_back([&, ThreadIndex]()
+        {
+            FLinearArena& Arena = GetFrameArena();
+            ThreadArenas[ThreadIndex] = &Arena;
+
+            std::vector<uint32_t*> Values;
+            for (uint32_t i = 0; i < 10000u; i++)
+            {
+                Values.push_back(Arena.New<uint32_t>(ThreadIndex * 100000u + i));
+            }
+            for (uint32_t i = 0; i < 10000u; i++)
+            {
+                NumCorrupted += *Values[i] != ThreadIndex * 100000u + i ? 1u : 0u;
+            }
+        });
+    }
+    for (std::thread& Thread : Threads)
+    {
+        Thread.join();
+    }
+
+    CHECK(NumCorrupted.load() == 0u);
+    for (uint32_t i = 0; i < NumThreads; i++)
+    {
+        CHECK(ThreadArenas[i] != MainArena);
+        for (uint32_t j = i + 1u; j < NumThreads; j++)
+        {
+            CHECK(ThreadArenas[i] != ThreadArenas[j]);
+        }
+    }
+}
+
+TEST(FrameArenaBenchmark, ArenaVersusMalloc)
+{
+    constexpr uint32_t NumFrames = 100u;
+    constexpr uint32_t NumAllocationsPerFrame = 10000u;
+
+    auto GetSize = [](uint32_t i) { return size_t(16u) + (i * 29u) % 240u; };
+
+    std::vector<void*> Pointers(NumAllocationsPerFrame);
+    FBenchmarkTimer MallocTimer;
+    for (uint32_t Frame = 0; Frame < NumFrames; Frame++)
+    {
+        for (uint32_t i = 0; i < NumAllocationsPerFrame; i++)
+        {
+            Pointers[i] = std::malloc(GetSize(i));
+            static_cast<uint8_t*>(Pointers[i])[0] = static_cast<uint8_t>(i);
+        }
+        for (void* Pointer : Pointers)
+        {
+            std::free(Pointer);
+        }
+    }
+    const double MallocMs = MallocTimer.GetElapsedMs();
+
+    FLinearArena Arena;
+    FBenchmarkTimer ArenaTimer;
+    for (uint32_t Frame = 0; Frame < NumFrames; Frame++)
+    {
+        for (uint32_t i = 0; i < NumAllocationsPerFrame; i++)
+        {
+            Pointers[i] = Arena.Allocate(GetSize(i));
+            static_cast<uint8_t*>(Pointers[i])[0] = static_cast<uint8_t>(i);
+        }
+        Arena.Reset();
+    }
+    const double ArenaMs = ArenaTimer.GetElapsedMs();
+
+    Log(std::format("{} frames x {} allocations : malloc/free {:.2f} ms, arena {:.2f} ms, {:.2f}x (high water {} KB)",
+        NumFrames, NumAllocationsPerFrame, MallocMs, ArenaMs, MallocMs / ArenaMs, Arena.GetHighWaterMark() / 1024u));
+    CHECK(Arena.GetCapacity() >= Arena.GetHighWaterMark());
+}
@@ -0,0 +1,178 @@
+#include "Test.h"
+#include "Core/FramePipeline.h"
+
+namespace
+{
+    // Counts what the render thread does. Only records violations, checks run on the test thread.
+    class FFakeFrameRenderer : public FFrameRenderer
+    {
+    public:
+        explicit FFakeFrameRenderer(std::chrono::microseconds InRenderTime = {}) : RenderTime(InRenderTime) {}
+
+        void RenderFrame(const FFrameSnapshot& Snapshot) override
+        {
+            const uint32_t FrameIndex = Snapshot.FrameIndex;
+            const uint32_t FirstMoved = Snapshot.MovedMeshes.empty() ? ~0u : Snapshot.MovedMeshes.front();
+            std::this_thread::sleep_for(RenderTime);
+
+            // The game thread must not be writing into the slot being rendered.
+            NumTornSnapshots += (Snapshot.FrameIndex != FrameIndex || FirstMoved != FrameIndex || Snapshot.MovedMeshes.size() != 1u) ? 1u : 0u;
+
+            std::lock_guard Lock(Mutex);
+            Events.push_back(FrameIndex);
+            NumRendered++;
+        }
+
+        void FlushFrames() override
+        {
+            std::lock_guard Lock(Mutex);
+            Events.push_back(FLUSH);
+        }
+
+        static constexpr uint32_t FLUSH = ~0u;
+
+        // Frame indices in render order, FLUSH where the GPU was waited for.
+        std::vector<uint32_t> GetEvents() const
+        {
+            std::lock_guard Lock(Mutex);
+            return Events;
+        }
+
+        std::atomic<uint64_t> NumRendered{ 0u };
+        std::atomic<uint32_t> NumTornSnapshots{ 0u };
+
+    private:
+        std::chrono::microseconds RenderTime;
+        mutable std::mutex Mutex;
+        std::vector<uint32_t> Events;
+    };
+
+    // What the game thread writes, enough for the renderer to tell frames apart.
+    void SubmitFrame(FFramePipeline& Pipeline, uint32_t FrameIndex)
+    {
+        FFrameSnapshot& Snapshot = Pipeline.BeginFrame();
+        Snapshot.FrameIndex = FrameIndex;
+        Snapshot.MovedMeshes.push_back(FrameIndex);
+        Pipeline.EndFrame();
+    }
+
+    std::vector<uint32_t> GetRenderedFrames(const FFakeFrameRenderer& Renderer)
+    {
+        std::vector<uint32_t> Frames = Renderer.GetEvents();
+        std::erase(Frames, FFakeFrameRenderer::FLUSH);
+        return Frames;
+    }
+
+    std::vector<uint32_t> GetFrameRange(uint32_t Count)
+    {
+        std::vector<uint32_t> Frames(Count);
+        std::iota(Frames.begin(), Frames.end(), 0u);
+        return Frames;
+    }
+}
+
+TEST(FramePipeline, GameThreadNeverRunsTooFarAhead)
+{
+    for (const uint32_t MaxFramesAhead : { 1u, 2u, 3u })
+    {
+        // A slow renderer keeps the ring full.
+        FFakeFrameRenderer Renderer(std::chrono::microseconds(300));
+        FFramePipeline Pipeline(Renderer, MaxFramesAhead);
+
+        uint64_t MaxAhead = 0u;
+        for (uint32_t FrameIndex = 0; FrameIndex < 60u; FrameIndex++)
+        {
+            FFrameSnapshot& Snapshot = Pipeline.BeginFrame();
+
+            // Frames published but not rendered yet, the one being written aside.
+            const uint64_t Ahead = FrameIndex - Renderer.NumRendered.load();
+            MaxAhead = max(MaxAhead, Ahead);
+            CHECK(Ahead <= MaxFramesAhead);
+
+            Snapshot.FrameIndex = FrameIndex;
+            Snapshot.MovedMeshes.push_back(FrameIndex);
+            Pipeline.EndFrame();
+        }
+        Pipeline.Stop();
+
+        // The bound is reached, the game thread did not just happen to be slow.
+        CHECK(MaxAhead == MaxFramesAhead);
+        CHECK(Renderer.NumTornSnapshots == 0u);
+        CHECK(GetRenderedFrames(Renderer) == GetFrameRange(60u));
+    }
+}
+
+TEST(FramePipeline, FlushDrainsEverySnapshot)
+{
+    FFakeFrameRenderer Renderer(std::chrono::microseconds(200));
+    FFramePipeline Pipeline(Renderer, 2u);
+
+    for (uint32_t FrameIndex = 0; FrameIndex < 5u; FrameIndex++)
+    {
+        SubmitFrame(Pipeline, FrameIndex);
+    }
+    Pipeline.Flush();
+
+    // Every published frame is rendered before the GPU is waited for.
+    CHECK(Pipeline.GetNumSubmittedFrames() == 5u);
+    CHECK(Pipeline.GetNumRenderedFrames() == 5u);
+    CHECK(Renderer.GetEvents() == (std::vector<uint32_t>{ 0u, 1u, 2u, 3u, 4u, FFakeFrameRenderer::FLUSH }));
+
+    // Nothing pending still waits for the GPU, and the pipeline keeps going afterwards.
+    Pipeline.Flush();
+    SubmitFrame(Pipeline, 5u);
+    Pipeline.Flush();
+    CHECK(Renderer.GetEvents() == (std::vector<uint32_t>{ 0u, 1u, 2u, 3u, 4u, FFakeFrameRenderer::FLUSH, FFakeFrameRenderer::FLUSH, 5u, FFakeFrameRenderer::FLUSH }));
+    CHECK(Renderer.NumTornSnapshots == 0u);
+}
+
+TEST(FramePipeline, StopRendersEveryPublishedFrameOnce)
+{
+    FFakeFrameRenderer Renderer(std::chrono::microseconds(500));
+    FFramePipeline Pipeline(Renderer, 2u);
+
+    for (uint32_t FrameIndex = 0; FrameIndex < 4u; FrameIndex++)
+    {
+        SubmitFrame(Pipeline, FrameIndex);
+    }
+
+    // Begun but never published : discarded, not rendered.
+    FFrameSnapshot& Unpublished = Pipeline.BeginFrame();
+    Unpublished.FrameIndex = 99u;
+    Unpublished.MovedMeshes.push_back(99u);
+
+    Pipeline.Stop();
+    const std::vector<uint32_t> Events = Renderer.GetEvents();
+    CHECK(GetRenderedFrames(Renderer) == GetFrameRange(4u));
+    CHECK(Events.back() == FFakeFrameRenderer::FLUSH);
+    CHECK(Pipeline.GetNumRenderedFrames() == 4u);
+
+    // Stopping again, or destroying the pipeline, renders nothing more.
+    Pipeline.Stop();
+    Pipeline.Flush();
+    CHECK(Renderer.GetEvents() == Events);
+}
+
+TEST(FramePipeline, StressRendersEveryFrameOnce)
+{
+    // No render time, the game thread and the render thread race over the ring.
+    FFakeFrameRenderer Renderer;
+    constexpr uint32_t NumFrames = 20000u;
+    {
+        FFramePipeline Pipeline(Renderer, 1u);
+        for (uint32_t FrameIndex = 0; FrameIndex < NumFrames; FrameIndex++)
+        {
+            SubmitFrame(Pipeline, FrameIndex);
+            if (FrameIndex % 1000u == 0u)
+            {
+                Pipeline.Flush();
+                CHECK(Renderer.NumRendered == FrameIndex + 1u);
+            }
+        }
+    }
+
+    // The destructor stops the pipeline.
+    CHECK(Renderer.NumRendered == NumFrames);
+    CHECK(Renderer.NumTornSnapshots == 0u);
+    CHECK(GetRenderedFrames(Renderer) == GetFrameRange(NumFrames));
+}
@@ -0,0 +1,117 @@
+#include "Test.h"
+#include "Renderer/IndirectDraw.h"
+
+namespace
+{
+    // Every mesh gets its own made up index buffer so records can be told apart.
+    std::vector<FIndirectDrawItem> MakeItems(uint32_t Count)
+    {
+        std::vector<FIndirectDrawItem> Items;
+        for (uint32_t Index = 0; Index < Count; Index++)
+        {
+            Items.push_back(FIndirectDrawItem{
+                .IndexBufferAddress = 0x10000ull * (Index + 1u),
+                .IndexBufferSizeInBytes = 1024u * (Index + 1u),
+                .IndexCount = 3u * (Index + 1u),
+                .FirstIndex = 7u * Index,
+            });
+        }
+        return Items;
+    }
+
+    void CheckRecord(const FIndirectDrawArguments& Arguments, const FIndirectDrawItem& Item, uint32_t InstanceIndex)
+    {
+        CHECK(Arguments.IndexBufferView.BufferLocation == Item.IndexBufferAddress);
+        CHECK(Arguments.IndexBufferView.SizeInBytes == Item.IndexBufferSizeInBytes);
+        CHECK(Arguments.IndexBufferView.Format == DXGI_FORMAT_R32_UINT);
+        CHECK(Arguments.InstanceIndex == InstanceIndex);
+        CHECK(Arguments.DrawIndexedArguments.IndexCountPerInstance == Item.IndexCount);
+        CHECK(Arguments.DrawIndexedArguments.InstanceCount == 1u);
+        CHECK(Arguments.DrawIndexedArguments.StartIndexLocation == Item.FirstIndex);
+        CHECK(Arguments.DrawIndexedArguments.BaseVertexLocation == 0);
+        CHECK(Arguments.DrawIndexedArguments.StartInstanceLocation == 0u);
+    }
+}
+
+TEST(IndirectDraw, CompactsCulledItems)
+{
+    const std::vector<FIndirectDrawItem> Items = MakeItems(8u);
+
+    // Culled instances leave no hole, records come in the visible order.
+    const uint32_t VisibleInstances[] = { 6u, 1u, 3u };
+    FIndirectDrawArgumentBuilder Builder;
+    Builder.Build(Items, VisibleInstances);
+
+    CHECK(Builder.GetNumDraws() == 3u);
+    for (uint32_t Draw = 0; Draw < 3u; Draw++)
+    {
+        CheckRecord(Builder.GetArguments()[Draw], Items[VisibleInstances[Draw]], VisibleInstances[Draw]);
+    }
+
+    // Rebuilding replaces the previous records.
+    Builder.Build(Items, std::span<const uint32_t>{});
+    CHECK(Builder.GetNumDraws() == 0u);
+    CHECK(Builder.GetArguments().empty());
+}
+
+TEST(IndirectDraw, DropsZeroIndexDraws)
+{
+    std::vector<FIndirectDrawItem> Items = MakeItems(6u);
+    Items[0].IndexCount = 0u;
+    Items[4].IndexCount = 0u;
+
+    const uint32_t VisibleInstances[] = { 0u, 1u, 2u, 3u, 4u, 5u };
+    FIndirectDrawArgumentBuilder Builder;
+    Builder.Build(Items, VisibleInstances);
+
+    // The instance index still names the item, not the record.
+    CHECK(Builder.GetNumDraws() == 4u);
+    const uint32_t Expected[] = { 1u, 2u, 3u, 5u };
+    for (uint32_t Draw = 0; Draw < 4u; Draw++)
+    {
+        CheckRecord(Builder.GetArguments()[Draw], Items[Expected[Draw]], Expected[Draw]);
+    }
+}
+
+TEST(IndirectDraw, RecordLayoutMatchesTheCommandSignature)
+{
+    const auto ArgumentDescs = FIndirectDrawArgumentBuilder::GetCommandSignatureArguments();
+    CHECK(ArgumentDescs[0].Type == D3D12_INDIRECT_ARGUMENT_TYPE_INDEX_BUFFER_VIEW);
+    CHECK(ArgumentDescs[1].Type == D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT);
+    CHECK(ArgumentDescs[1].Constant.RootParameterIndex == 0u);
+    CHECK(ArgumentDescs[1].Constant.DestOffsetIn32BitValues == 0u);
+    CHECK(ArgumentDescs[1].Constant.Num32BitValuesToSet == 1u);
+    CHECK(ArgumentDescs[2].Type == D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED);
+
+    // The command signature stride is the record size, the arguments packed back to back in signature order.
+    constexpr size_t ArgumentsSize = sizeof(D3D12_INDEX_BUFFER_VIEW) + sizeof(uint32_t) + sizeof(D3D12_DRAW_INDEXED_ARGUMENTS);
+    CHECK(sizeof(FIndirectDrawArguments) == ArgumentsSize);
+    CHECK(sizeof(FIndirectDrawArguments) % sizeof(uint32_t) == 0u);
+
+    const std::vector<FIndirectDrawItem> Items = MakeItems(4u);
+    const uint32_t VisibleInstances[] = { 3u, 0u, 2u };
+    FIndirectDrawArgumentBuilder Builder;
+    Builder.Build(Items, VisibleInstances);
+
+    // What the GPU reads : the upload copies the records as they are.
+    const uint8_t* Bytes = reinterpret_cast<const uint8_t*>(Builder.GetArguments().data());
+    for (uint32_t Draw = 0; Draw < 3u; Draw++)
+    {
+        const uint8_t* Record = Bytes + Draw * sizeof(FIndirectDrawArguments);
+
+        D3D12_GPU_VIRTUAL_ADDRESS BufferLocation;
+        uint32_t InstanceIndex;
+        uint32_t IndexCount;
+        uint32_t StartIndex;
+        memcpy(&BufferLocation, Record, sizeof(BufferLocation));
+        memcpy(&InstanceIndex, Record + sizeof(D3D12_INDEX_BUFFER_VIEW), sizeof(InstanceIndex));
+        memcpy(&IndexCount, Record + sizeof(D3D12_INDEX_BUFFER_VIEW) + sizeof(uint32_t), sizeof(IndexCount));
+        memcpy(&StartIndex, Record + sizeof(D3D12_INDEX_BUFFER_VIEW) + 3u * sizeof(uint32_t), sizeof(StartIndex));
+
+        const FIndirectDrawItem& Item = Items[VisibleInstances[Draw]];
+        CHECK(BufferLocation == Item.IndexBufferAddress);
+        CHECK(InstanceIndex == VisibleInstances[Draw]);
+        CHECK(IndexCount == Item.IndexCount);
+        CHECK(StartIndex == Item.FirstIndex);
+    }
+}
@@ -0,0 +1,269 @@
+#include "Test.h"
+#include "Core/JobSystem.h"
+
+namespace
+{
+    constexpr uint32_t NUM_TEST_WORKERS = 4u;
+}
+
+TEST(JobSystem, RunCompletesEveryJob)
+{
+    FJobSystem JobSystem(NUM_TEST_WORKERS);
+
+    constexpr uint32_t NumJobs = 20000u;
+    std::atomic<uint32_t> NumExecuted{ 0u };
+    FJobCounter Counter;
+    for (uint32_t i = 0; i < NumJobs; i++)
+    {
+        JobSystem.Run([&]() { NumExecuted.fetch_add(1u); }, &Counter);
+    }
+    JobSystem.Wait(Counter);
+
+    CHECK(Counter.IsDone());
+    CHECK(NumExecuted.load() == NumJobs);
+}
+
+TEST(JobSystem, RunAfterSeesDependencyResults)
+{
+    FJobSystem JobSystem(NUM_TEST_WORKERS);
+
+    constexpr uint32_t NumValues = 1024u;
+    for (uint32_t Iteration = 0; Iteration < 50u; Iteration++)
+    {
+        std::vector<uint32_t> Values(NumValues, 0u);
+        FJobCounter Producers;
+        for (uint32_t i = 0; i < NumValues; i++)
+        {
+            JobSystem.Run([&Values, i]() { Values[i] = i + 1u; }, &Producers);
+        }
+
+        // Scheduled while producers may still be running or already done, both must hold.
+        uint64_t Sum = 0u;
+        FJobCounter Consumer;
+        JobSystem.RunAfter(Producers, [&]()
+        {
+            for (const uint32_t Value : Values)
+            {
+                Sum += Value;
+            }
+        }, &Consumer);
+        JobSystem.Wait(Consumer);
+
+        CHECK(Producers.IsDone());
+        CHECK(Sum == static_cast<uint64_t>(NumValues) * (NumValues + 1u) / 2u);
+    }
+}
+
+TEST(JobSystem, RunAfterCompletedDependencyRunsImmediately)
+{
+    FJobSystem JobSystem(NUM_TEST_WORKERS);
+
+    FJobCounter Done;
+    std::atomic<bool> bRan{ false };
+    FJobCounter Counter;
+    JobSystem.RunAfter(Done, [&]() { bRan = true; }, &Counter);
+    JobSystem.Wait(Counter);
+
+    CHECK(bRan.load());
+}
+
+TEST(JobSystem, ParallelForVisitsEachIndexOnce)
+{
+    FJobSystem JobSystem(NUM_TEST_WORKERS);
+
+    for (const uint32_t Count : { 1u, 7u, 64u, 1000u, 100000u })
+    {
+        for (const uint32_t MinGrainSize : { 1u, 16u, 4096u })
+        {
+            std::vector<std::atomic<uint32_t>> Visits(Count);
+            std::atomic<bool> bBadRange{ false };
+            JobSystem.ParallelFor(Count, [&](uint32_t Begin, uint32_t End)
+            {
+                if (Begin >= End || End > Count)
+                {
+                    bBadRange = true;
+                    return;
+                }
+                for (uint32_t i = Begin; i < End; i++)
+                {
+                    Visits[i].fetch_add(1u);
+                }
+            }, MinGrainSize);
+
+            CHECK(!bBadRange.load());
+            for (uint32_t i = 0; i < Count; i++)
+            {
+                CHECK(Visits[i].load() == 1u);
+            }
+        }
+    }
+}
+
+TEST(JobSystem, NestedWaitHelpsInsteadOfBlocking)
+{
+    // Every job waits on jobs of its own. With blocking waits this deadlocks once all workers wait.
+    FJobSystem JobSystem(2u);
+
+    constexpr uint32_t NumOuter = 64u;
+    constexpr uint32_t NumInner = 64u;
+    std::atomic<uint32_t> NumInnerExecuted{ 0u };
+    FJobCounter Outer;
+    for (uint32_t i = 0; i < NumOuter; i++)
+    {
+        JobSystem.Run([&]()
+        {
+            FJobCounter Inner;
+            for (uint32_t j = 0; j < NumInner; j++)
+            {
+                JobSystem.Run([&]() { NumInnerExecuted.fetch_add(1u); }, &Inner);
+            }
+            JobSystem.Wait(Inner);
+        }, &Outer);
+    }
+    JobSystem.Wait(Outer);
+
+    CHECK(NumInnerExecuted.load() == NumOuter * NumInner);
+}
+
+TEST(JobSystem, ExternalThreadsInjectUnderContention)
+{
+    FJobSystem JobSystem(NUM_TEST_WORKERS);
+
+    constexpr uint32_t NumThreads = 4u;
+    constexpr uint32_t NumJobsPerThread = 5000u;
+    std::atomic<uint32_t> NumExecuted{ 0u };
+    std::atomic<uint32_t> NumThreadsDone{ 0u };
+
+    std::vector<std::thread> Threads;
+    for (uint32_t ThreadIndex = 0; ThreadIndex < NumThreads; ThreadIndex++)
+    {
+        Threads.emplace_back([&]()
+        {
+            // Not a worker, jobs go through the injection queue and Wait steals.
+            FJobCounter Counter;
+            for (uint32_t i = 0; i < NumJobsPerThread; i++)
+            {
+                JobSystem.Run([&]() { NumExecuted.fetch_add(1u); }, &Counter);
+            }
+            JobSystem.Wait(Counter);
+            NumThreadsDone.fetch_add(Counter.IsDone() ? 1u : 0u);
+        });
+    }
+    for (std::thread& Thread : Threads)
+    {
+        Thread.join();
+    }
+
+    CHECK(NumThreadsDone.load() == NumThreads);
+    CHECK(NumExecuted.load() == NumThreads * NumJobsPerThread);
+}
+
+TEST(JobSystem, WorkStealingQueueHandsOutEachJobOnce)
+{
+    // Small initial capacity so the owner grows the ring while thieves read it.
+    FWorkStealingQueue Queue(16u);
+
+    constexpr uint32_t NumJobs = 200000u;
+    constexpr uint32_t NumThieves = 3u;
+    std::vector<FJob> Jobs(NumJobs);
+    std::vector<std::atomic<uint32_t>> Taken(NumJobs);
+
+    auto Take = [&](FJob* Job)
+    {
+        Taken[static_cast<size_t>(Job - Jobs.data())].fetch_add(1u);
+    };
+
+    std::atomic<bool> bOwnerDone{ false };
+    std::vector<std::thread> Thieves;
+    for (uint32_t i = 0; i < NumThieves; i++)
+    {
+        Thieves.emplace_back([&]()
+        {
+            while (!bOwnerDone.load())
+            {
+                if (FJob* Job = Queue.Steal())
+                {
+                    Take(Job);
+                }
+            }
+        });
+    }
+
+    // The owner pushes in bursts and pops some back, racing thieves for the last item.
+    for (uint32_t i = 0; i < NumJobs; i++)
+    {
+        Queue.Push(&Jobs[i]);
+        if ((i % 3u) == 0u)
+        {
+            if (FJob* Job = Queue.Pop())
+            {
+                Take(Job);
+            }
+        }
+    }
+    while (FJob* Job = Queue.Pop())
+    {
+        Take(Job);
+    }
+
+    bOwnerDone = true;
+    for (std::thread& Thief : Thieves)
+    {
+        Thief.join();
+    }
+
+    CHECK(Queue.Pop() == nullptr);
+    CHECK(Queue.Steal() == nullptr);
+    for (uint32_t i = 0; i < NumJobs; i++)
+    {
+        CHECK(Taken[i].load() == 1u);
+    }
+}
+
+TEST(JobSystemBenchmark, Throughput)
+{
+    const uint32_t NumWorkers = max(1u, std::thread::hardware_concurrency());
+    FJobSystem JobSystem(NumWorkers);
+
+    constexpr uint32_t NumJobs = 1000000u;
+    std::atomic<uint32_t> NumExecuted{ 0u };
+    {
+        const FBenchmarkTimer Timer;
+        FJobCounter Counter;
+        for (uint32_t i = 0; i < NumJobs; i++)
+        {
+            JobSystem.Run([&]() { NumExecuted.fetch_add(1u, std::memory_order_relaxed); }, &Counter);
+        }
+        JobSystem.Wait(Counter);
+
+        const double Ms = Timer.GetElapsedMs();
+        Log(std::format("{} workers : {} empty jobs in {:.2f} ms, {:.2f} M jobs/s", NumWorkers, NumJobs, Ms, NumJobs / Ms / 1000.0));
+    }
+    CHECK(NumExecuted.load() == NumJobs);
+
+    // Uneven cost per index, which is what the adaptive grain and stealing are for.
+    constexpr uint32_t Count = 1u << 20;
+    std::vector<float> Values(Count);
+    auto Work = [&](uint32_t Begin, uint32_t End)
+    {
+        for (uint32_t i = Begin; i < End; i++)
+        {
+            float Value = static_cast<float>(i);
+            for (uint32_t Step = 0; Step < (i & 63u); Step++)
+            {
+                Value = sqrtf(Value + 1.f);
+            }
+            Values[i] = Value;
+        }
+    };
+
+    FBenchmarkTimer SerialTimer;
+    Work(0u, Count);
+    const double SerialMs = SerialTimer.GetElapsedMs();
+
+    FBenchmarkTimer ParallelTimer;
+    JobSystem.ParallelFor(Count, Work);
+    const double ParallelMs = ParallelTimer.GetElapsedMs();
+
+    Log(std::format("ParallelFor over {} items : serial {:.2f} ms, parallel {:.2f} ms, {:.2f}x", Count, SerialMs, ParallelMs, SerialMs / ParallelMs));
+}
@@ -0,0 +1,118 @@
+#include "Test.h"
+#include "Renderer/RenderPass.h"
+
+namespace
+{
+    // Counts what FLazyRenderPass does to the pass without touching a device.
+    struct FPassCounters
+    {
+        uint32_t NumConstructed = 0u;
+        uint32_t NumDestroyed = 0u;
+        uint32_t NumSized = 0u;
+        uint32_t Width = 0u;
+        uint32_t Height = 0u;
+    };
+
+    class FFakeRenderPass : public FRenderPass
+    {
+    public:
+        FFakeRenderPass(uint32_t Width, uint32_t Height, FPassCounters& InCounters)
+            : FRenderPass(Width, Height), Counters(InCounters)
+        {
+            Counters.NumConstructed++;
+        }
+
+        ~FFakeRenderPass() override { Counters.NumDestroyed++; }
+
+        void InitSizeDependantResource(uint32_t InWidth, uint32_t InHeight) override
+        {
+            Counters.NumSized++;
+            Counters.Width = InWidth;
+            Counters.Height = InHeight;
+        }
+
+    private:
+        FPassCounters& Counters;
+    };
+
+    FLazyRenderPass MakeLazyPass(FPassCounters& Counters)
+    {
+        return FLazyRenderPass("FakePass", [&Counters](uint32_t Width, uint32_t Height)
+        {
+            return std::make_unique<FFakeRenderPass>(Width, Height, Counters);
+        });
+    }
+}
+
+TEST(LazyRenderPass, CreatedOnFirstGetOnly)
+{
+    FPassCounters Counters;
+    FLazyRenderPass Pass = MakeLazyPass(Counters);
+    Pass.SetSize(1280u, 720u);
+
+    // Resizing a pass nobody used yet only records the size.
+    CHECK(!Pass.IsCreated());
+    CHECK(Counters.NumConstructed == 0u);
+    CHECK(Counters.NumSized == 0u);
+
+    FRenderPass* Created = Pass.Get();
+    CHECK(Pass.IsCreated());
+    CHECK(Counters.NumConstructed == 1u);
+    CHECK(Counters.NumSized == 1u);
+    CHECK(Counters.Width == 1280u && Counters.Height == 720u);
+
+    CHECK(Pass.Get() == Created);
+    CHECK(Counters.NumConstructed == 1u);
+    CHECK(Pass.GetName() == "FakePass");
+}
+
+TEST(LazyRenderPass, ResizeForwardsOnceCreated)
+{
+    FPassCounters Counters;
+    FLazyRenderPass Pass = MakeLazyPass(Counters);
+    Pass.SetSize(640u, 480u);
+    Pass.SetSize(800u, 600u);
+    Pass.Get();
+    CHECK(Counters.NumSized == 1u);
+    CHECK(Counters.Width == 800u && Counters.Height == 600u);
+
+    Pass.SetSize(1920u, 1080u);
+    CHECK(Counters.NumSized == 2u);
+    CHECK(Counters.Width == 1920u && Counters.Height == 1080u);
+    CHECK(Counters.NumConstructed == 1u);
+}
+
+TEST(LazyRenderPass, ReleasedAfterIdleFramesAndRecreated)
+{
+    const uint32_t StartFrame = GFrameCount;
+    FPassCounters Counters;
+    FLazyRenderPass Pass = MakeLazyPass(Counters);
+    Pass.SetSize(64u, 64u);
+
+    // Never created, nothing to release.
+    GFrameCount = StartFrame + 100u;
+    CHECK(!Pass.ReleaseIfIdle(10u));
+
+    Pass.Get();
+    GFrameCount += 9u;
+    CHECK(!Pass.ReleaseIfIdle(10u));
+    CHECK(Pass.IsCreated());
+
+    // Used again, the idle count starts over.
+    Pass.Get();
+    GFrameCount += 9u;
+    CHECK(!Pass.ReleaseIfIdle(10u));
+
+    GFrameCount += 1u;
+    CHECK(Pass.ReleaseIfIdle(10u));
+    CHECK(!Pass.IsCreated());
+    CHECK(Counters.NumDestroyed == 1u);
+
+    // The next frame that needs it gets a fresh pass at the current size.
+    Pass.SetSize(128u, 96u);
+    Pass.Get();
+    CHECK(Counters.NumConstructed == 2u);
+    CHECK(Counters.Width == 128u && Counters.Height == 96u);
+
+    GFrameCount = StartFrame;
+}
@@ -0,0 +1,219 @@
+#include "Test.h"
+#include "Graphics/MaterialTable.h"
+
+#include <random>
+
+namespace
+{
+    interlop::MaterialData MakeMaterial(float Roughness, float Metallic = 0.f)
+    {
+        // Zeroed first, the table compares whole blocks padding included.
+        interlop::MaterialData Data{};
+        Data.albedoColor = XMFLOAT3(1.f, 1.f, 1.f);
+        Data.roughnessFactor = Roughness;
+        Data.metallicFactor = Metallic;
+        Data.IOR = 1.f;
+        return Data;
+    }
+
+    bool IsSameBlock(const interlop::MaterialData& A, const interlop::MaterialData& B)
+    {
+        return std::memcmp(&A, &B, sizeof(A)) == 0;
+    }
+
+    void BeginFrames(FMaterialParameterTable& Table, uint32_t NumFrames)
+    {
+        for (uint32_t i = 0; i < NumFrames; i++)
+        {
+            Table.BeginFrame();
+        }
+    }
+}
+
+TEST(MaterialParameterTable, IdenticalBlocksShareASlot)
+{
+    FMaterialParameterTable Table(4u);
+    const uint32_t Rough = Table.Acquire(MakeMaterial(0.8f));
+    const uint32_t Shiny = Table.Acquire(MakeMaterial(0.1f, 1.f));
+    CHECK(Rough != Shiny);
+
+    CHECK(Table.Acquire(MakeMaterial(0.8f)) == Rough);
+    CHECK(Table.Acquire(MakeMaterial(0.8f)) == Rough);
+    CHECK(Table.GetRefCount(Rough) == 3u);
+    CHECK(Table.GetNumLiveSlots() == 2u);
+    CHECK(Table.GetNumDeduplicated() == 2u);
+    CHECK(IsSameBlock(Table.GetData()[Shiny], MakeMaterial(0.1f, 1.f)));
+
+    // The slot lives until its last reference goes.
+    Table.Release(Rough);
+    Table.Release(Rough);
+    CHECK(Table.GetNumLiveSlots() == 2u);
+    Table.Release(Rough);
+    CHECK(Table.GetNumLiveSlots() == 1u);
+}
+
+TEST(MaterialParameterTable, ReleasedSlotWaitsForFramesInFlight)
+{
+    FMaterialParameterTable Table(4u);
+    const uint32_t Slot = Table.Acquire(MakeMaterial(0.5f));
+    Table.Release(Slot);
+
+    // Even the same block gets a new slot, the released one is out of the lookup.
+    const uint32_t Again = Table.Acquire(MakeMaterial(0.5f));
+    CHECK(Again != Slot);
+
+    for (uint32_t Frame = 1; Frame < FRAMES_IN_FLIGHT; Frame++)
+    {
+        Table.BeginFrame();
+        const uint32_t Other = Table.Acquire(MakeMaterial(float(Frame)));
+        CHECK(Other != Slot);
+    }
+    // Frames in flight may still read the old block.
+    CHECK(IsSameBlock(Table.GetData()[Slot], MakeMaterial(0.5f)));
+
+    Table.BeginFrame();
+    CHECK(Table.Acquire(MakeMaterial(9.f)) == Slot);
+    CHECK(IsSameBlock(Table.GetData()[Slot], MakeMaterial(9.f)));
+}
+
+TEST(MaterialParameterTable, ReplaceMovesOnlyWhenChanged)
+{
+    FMaterialParameterTable Table(4u);
+    const uint32_t Slot = Table.Acquire(MakeMaterial(0.5f));
+
+    CHECK(Table.Replace(Slot, MakeMaterial(0.5f)) == Slot);
+    CHECK(Table.GetRefCount(Slot) == 1u);
+
+    // An edit never writes the slot frames in flight recorded against.
+    const uint32_t Edited = Table.Replace(Slot, MakeMaterial(0.6f));
+    CHECK(Edited != Slot);
+    CHECK(IsSameBlock(Table.GetData()[Slot], MakeMaterial(0.5f)));
+    CHECK(IsSameBlock(Table.GetData()[Edited], MakeMaterial(0.6f)));
+    CHECK(Table.GetNumLiveSlots() == 1u);
+
+    CHECK(Table.Replace(FMaterialParameterTable::INVALID_SLOT, MakeMaterial(0.6f)) == Edited);
+    CHECK(Table.GetRefCount(Edited) == 2u);
+}
+
+TEST(MaterialParameterTable, GrowsAndKeepsBlocks)
+{
+    FMaterialParameterTable Table(2u);
+    std::vector<uint32_t> Slots;
+    for (uint32_t i = 0; i < 5u; i++)
+    {
+        Slots.push_back(Table.Acquire(MakeMaterial(float(i))));
+    }
+    CHECK(Table.GetCapacity() == 8u);
+    CHECK(Table.GetNumSlots() == 5u);
+    CHECK(Table.GetData().size() == 5u);
+    for (uint32_t i = 0; i < 5u; i++)
+    {
+        CHECK(Slots[i] == i);
+        CHECK(IsSameBlock(Table.GetData()[Slots[i]], MakeMaterial(float(i))));
+    }
+}
+
+TEST(MaterialParameterTable, DirtyRangesMergeRuns)
+{
+    FMaterialParameterTable Table(16u);
+    for (uint32_t i = 0; i < 6u; i++)
+    {
+        Table.Acquire(MakeMaterial(float(i)));
+    }
+    // Deduplicated acquires do not write anything.
+    Table.Acquire(MakeMaterial(0.f));
+
+    std::vector<FMaterialSlotRange> Ranges = Table.TakeDirtyRanges();
+    CHECK(Ranges.size() == 1u);
+    CHECK(Ranges[0].FirstSlot == 0u && Ranges[0].NumSlots == 6u);
+    CHECK(Table.TakeDirtyRanges().empty());
+
+    // Reclaimed slots 1, 4 and 5 come back first, then slot 6 is new.
+    Table.Release(1u);
+    Table.Release(4u);
+    Table.Release(5u);
+    BeginFrames(Table, FRAMES_IN_FLIGHT);
+    for (uint32_t i = 0; i < 4u; i++)
+    {
+        Table.Acquire(MakeMaterial(10.f + float(i)));
+    }
+
+    Ranges = Table.TakeDirtyRanges();
+    CHECK(Ranges.size() == 2u);
+    CHECK(Ranges[0].FirstSlot == 1u && Ranges[0].NumSlots == 1u);
+    CHECK(Ranges[1].FirstSlot == 4u && Ranges[1].NumSlots == 3u);
+}
+
+TEST(MaterialParameterTable, RandomEditsNeverOverwriteFramesInFlight)
+{
+    FMaterialParameterTable Table(8u);
+    std::mt19937 Random(7u);
+
+    struct FHandle
+    {
+        uint32_t Slot;
+        interlop::MaterialData Data;
+    };
+    std::vector<FHandle> Live;
+
+    // What earlier frames may still read, with the frame they last referenced it in.
+    struct FRecorded
+    {
+        uint32_t Slot;
+        interlop::MaterialData Data;
+        uint32_t Frame;
+    };
+    std::vector<FRecorded> Recorded;
+
+    for (uint32_t Frame = 0; Frame < 500u; Frame++)
+    {
+        Table.BeginFrame();
+
+        for (uint32_t Edit = 0; Edit < 8u; Edit++)
+        {
+            // Few distinct values, so blocks are shared often.
+            const interlop::MaterialData Data = MakeMaterial(float(Random() % 16u), float(Random() % 2u));
+            const uint32_t Action = Random() % 3u;
+            if (Action == 0u || Live.empty())
+            {
+                Live.push_back(FHandle{ Table.Acquire(Data), Data });
+            }
+            else
+            {
+                const size_t Index = Random() % Live.size();
+                if (Action == 1u)
+                {
+                    Live[Index].Slot = Table.Replace(Live[Index].Slot, Data);
+                    Live[Index].Data = Data;
+                }
+                else
+                {
+                    Table.Release(Live[Index].Slot);
+                    Live.erase(Live.begin() + Index);
+                }
+            }
+        }
+
+        for (const FHandle& Handle : Live)
+        {
+            CHECK(IsSameBlock(Table.GetData()[Handle.Slot], Handle.Data));
+            Recorded.push_back(FRecorded{ Handle.Slot, Handle.Data, Frame });
+        }
+        std::erase_if(Recorded, [Frame](const FRecorded& Entry) { return Entry.Frame + FRAMES_IN_FLIGHT <= Frame; });
+        for (const FRecorded& Entry : Recorded)
+        {
+            CHECK(IsSameBlock(Table.GetData()[Entry.Slot], Entry.Data));
+        }
+        Table.TakeDirtyRanges();
+    }
+
+    // Every live slot holds a distinct block.
+    std::vector<uint32_t> Slots;
+    for (const FHandle& Handle : Live)
+    {
+        Slots.push_back(Handle.Slot);
+    }
+    std::sort(Slots.begin(), Slots.end());
+    Slots.erase(std::unique(Slots.begin(), Slots.end()), Slots.end());
+    CHECK(Slots.size() == Table.GetNumLiveSlots());
+}
@@ -0,0 +1,215 @@
+#include "Test.h"
+#include "Scene/PVS.h"
+
+#include <fstream>
+
+namespace
+{
+    // Offset of the first cell offset in the file, after the header.
+    constexpr std::streamoff CELL_OFFSETS_OFFSET = 56;
+
+    // No triangles, only bounds : no ray ever hits, so a cell sees exactly the meshes overlapping it.
+    FPVSMeshGeometry MakeBoundsOnly(const XMFLOAT3& Min, const XMFLOAT3& Max)
+    {
+        FPVSMeshGeometry Geometry;
+        Geometry.Bounds.Expand(Min);
+        Geometry.Bounds.Expand(Max);
+        return Geometry;
+    }
+
+    // Two triangles spanning [Min, Max], flat on the axis where both are equal.
+    FPVSMeshGeometry MakeQuad(const XMFLOAT3& Min, const XMFLOAT3& Max)
+    {
+        FPVSMeshGeometry Geometry;
+        if (Min.x == Max.x)
+        {
+            Geometry.Positions = { { Min.x, Min.y, Min.z }, { Min.x, Max.y, Min.z }, { Min.x, Max.y, Max.z }, { Min.x, Min.y, Max.z } };
+        }
+        else
+        {
+            Geometry.Positions = { { Min.x, Min.y, Min.z }, { Max.x, Min.y, Min.z }, { Max.x, Max.y, Max.z }, { Min.x, Max.y, Max.z } };
+        }
+        Geometry.Indices = { 0u, 1u, 2u, 0u, 2u, 3u };
+        Geometry.Bounds.Expand(Min);
+        Geometry.Bounds.Expand(Max);
+        return Geometry;
+    }
+
+    FAABB GetCellBounds(const XMFLOAT3& GridOrigin, float CellSize, uint32_t X, uint32_t Y, uint32_t Z)
+    {
+        FAABB Bounds{};
+        Bounds.Expand(XMFLOAT3{ GridOrigin.x + X * CellSize, GridOrigin.y + Y * CellSize, GridOrigin.z + Z * CellSize });
+        Bounds.Expand(XMFLOAT3{ GridOrigin.x + (X + 1u) * CellSize, GridOrigin.y + (Y + 1u) * CellSize, GridOrigin.z + (Z + 1u) * CellSize });
+        return Bounds;
+    }
+
+    std::string GetPVSPath(const char* Name)
+    {
+        return (std::filesystem::temp_directory_path() / Name).string();
+    }
+
+    // Wall at x = 4 over the whole scene cross section, one quad in front of it and one behind it.
+    std::vector<FPVSMeshGeometry> MakeOccludedScene()
+    {
+        return {
+            MakeQuad({ 4.f, 0.f, 0.f }, { 4.f, 4.f, 4.f }),
+            MakeQuad({ 7.f, 1.f, 1.f }, { 7.f, 3.f, 3.f }),
+            MakeQuad({ 1.f, 1.f, 1.f }, { 1.f, 3.f, 3.f }),
+        };
+    }
+}
+
+TEST(PVS, EncodesLongZeroRuns)
+{
+    // Unit boxes every 2 units along x, one cell each : cells see one or two neighbours out of thousands of
+    // meshes, so the bitsets are runs of zero bytes longer than a run length byte holds.
+    constexpr uint32_t NumMeshes = 3000u;
+    std::vector<FPVSMeshGeometry> Meshes;
+    for (uint32_t MeshIndex = 0; MeshIndex < NumMeshes; MeshIndex++)
+    {
+        const float X = 2.f * MeshIndex;
+        Meshes.push_back(MakeBoundsOnly({ X, 0.f, 0.f }, { X + 1.f, 1.f, 1.f }));
+    }
+
+    const std::unique_ptr<FPVS> PVS = FPVS::Bake(Meshes, FPVSBakeSettings{ .CellSize = 2.f, .SamplesPerCell = 1u, .RaysPerSample = 1u, .NumThreads = 4u }, 0u);
+    CHECK(PVS->IsValid());
+    CHECK(PVS->GetNumMeshes() == NumMeshes);
+    CHECK(PVS->GetNumCells() == NumMeshes);
+    // Raw, every cell would take NumMeshes / 8 bytes.
+    CHECK(PVS->GetCompressedSizeInBytes() < PVS->GetNumCells() * 16u);
+
+    std::vector<uint8_t> VisibleBits;
+    for (const uint32_t Cell : { 0u, 1u, 137u, 1500u, NumMeshes - 1u })
+    {
+        CHECK(PVS->GetCellIndex(XMFLOAT3{ 2.f * Cell + 0.5f, 0.5f, 0.5f }) == Cell);
+        PVS->DecodeCell(Cell, VisibleBits);
+        CHECK(VisibleBits.size() == (NumMeshes + 7u) / 8u);
+
+        const FAABB CellBounds = GetCellBounds(XMFLOAT3{ 0.f, 0.f, 0.f }, 2.f, Cell, 0u, 0u);
+        for (uint32_t MeshIndex = 0; MeshIndex < NumMeshes; MeshIndex++)
+        {
+            CHECK(FPVS::IsVisible(VisibleBits, MeshIndex) == Meshes[MeshIndex].Bounds.Intersects(CellBounds));
+        }
+    }
+}
+
+TEST(PVS, CellLookup)
+{
+    const std::unique_ptr<FPVS> PVS = FPVS::Bake(MakeOccludedScene(), FPVSBakeSettings{ .SamplesPerCell = 1u, .RaysPerSample = 1u, .NumThreads = 1u }, 0u);
+
+    // Origin at (1, 0, 0), 3 x 2 x 2 cells of 2 units, x fastest.
+    CHECK(PVS->GetNumCells() == 12u);
+    CHECK(PVS->GetCellIndex(XMFLOAT3{ 1.f, 0.f, 0.f }) == 0u);
+    CHECK(PVS->GetCellIndex(XMFLOAT3{ 3.5f, 0.5f, 0.5f }) == 1u);
+    CHECK(PVS->GetCellIndex(XMFLOAT3{ 1.5f, 2.5f, 0.5f }) == 3u);
+    CHECK(PVS->GetCellIndex(XMFLOAT3{ 6.9f, 3.9f, 3.9f }) == 11u);
+    CHECK(PVS->GetCellIndex(XMFLOAT3{ 0.9f, 1.f, 1.f }) == FPVS::INVALID_CELL);
+    CHECK(PVS->GetCellIndex(XMFLOAT3{ 7.f, 1.f, 1.f }) == FPVS::INVALID_CELL);
+    CHECK(PVS->GetCellIndex(XMFLOAT3{ 2.f, -0.1f, 1.f }) == FPVS::INVALID_CELL);
+
+    // Outside of the baked volume everything is potentially visible.
+    std::vector<uint8_t> VisibleBits;
+    PVS->DecodeCell(FPVS::INVALID_CELL, VisibleBits);
+    CHECK(VisibleBits.size() == 1u);
+    CHECK(FPVS::IsVisible(VisibleBits, 0u) && FPVS::IsVisible(VisibleBits, 1u) && FPVS::IsVisible(VisibleBits, 2u));
+
+    const FPVS Empty;
+    CHECK(!Empty.IsValid());
+    CHECK(Empty.GetCellIndex(XMFLOAT3{ 2.f, 2.f, 2.f }) == FPVS::INVALID_CELL);
+}
+
+TEST(PVS, WallHidesWhatIsBehindIt)
+{
+    const std::unique_ptr<FPVS> PVS = FPVS::Bake(MakeOccludedScene(), FPVSBakeSettings{ .NumThreads = 2u }, 0u);
+
+    // Every ray from the front cells to the quad behind the wall crosses the wall, whatever side it leaves by.
+    std::vector<uint8_t> VisibleBits;
+    for (const XMFLOAT3& Position : { XMFLOAT3{ 2.f, 1.f, 1.f }, XMFLOAT3{ 2.f, 3.f, 3.f } })
+    {
+        PVS->DecodeCell(PVS->GetCellIndex(Position), VisibleBits);
+        CHECK(FPVS::IsVisible(VisibleBits, 0u));
+        CHECK(!FPVS::IsVisible(VisibleBits, 1u));
+        CHECK(FPVS::IsVisible(VisibleBits, 2u));
+    }
+
+    PVS->DecodeCell(PVS->GetCellIndex(XMFLOAT3{ 6.f, 2.f, 2.f }), VisibleBits);
+    CHECK(FPVS::IsVisible(VisibleBits, 0u));
+    CHECK(FPVS::IsVisible(VisibleBits, 1u));
+    CHECK(!FPVS::IsVisible(VisibleBits, 2u));
+}
+
+TEST(PVS, SaveLoadRoundTrip)
+{
+    const std::unique_ptr<FPVS> PVS = FPVS::Bake(MakeOccludedScene(), FPVSBakeSettings{ .NumThreads = 2u }, 0x1234u);
+    const std::string Path = GetPVSPath("CubiEngineTests.PVS.RoundTrip.pvs");
+    CHECK(PVS->Save(Path));
+
+    FPVS Loaded;
+    CHECK(Loaded.Load(Path));
+    CHECK(Loaded.GetNumCells() == PVS->GetNumCells());
+    CHECK(Loaded.GetNumMeshes() == PVS->GetNumMeshes());
+    CHECK(Loaded.GetSceneHash() == 0x1234u);
+    CHECK(Loaded.GetCompressedSizeInBytes() == PVS->GetCompressedSizeInBytes());
+
+    std::vector<uint8_t> Expected;
+    std::vector<uint8_t> VisibleBits;
+    for (uint32_t Cell = 0; Cell < PVS->GetNumCells(); Cell++)
+    {
+        PVS->DecodeCell(Cell, Expected);
+        Loaded.DecodeCell(Cell, VisibleBits);
+        CHECK(VisibleBits == Expected);
+    }
+    CHECK(Loaded.GetCellIndex(XMFLOAT3{ 6.f, 2.f, 2.f }) == PVS->GetCellIndex(XMFLOAT3{ 6.f, 2.f, 2.f }));
+
+    std::filesystem::remove(Path);
+}
+
+TEST(PVS, RejectsCorruptFiles)
+{
+    const std::unique_ptr<FPVS> PVS = FPVS::Bake(MakeOccludedScene(), FPVSBakeSettings{ .SamplesPerCell = 1u, .RaysPerSample = 1u, .NumThreads = 1u }, 0u);
+    const std::string Path = GetPVSPath("CubiEngineTests.PVS.Corrupt.pvs");
+
+    // A cell pointing past the compressed data.
+    CHECK(PVS->Save(Path));
+    {
+        std::fstream File(Path, std::ios::binary | std::ios::in | std::ios::out);
+        const uint32_t BadOffset = ~0u;
+        File.seekp(CELL_OFFSETS_OFFSET);
+        File.write(reinterpret_cast<const char*>(&BadOffset), sizeof(BadOffset));
+    }
+    FPVS Loaded;
+    CHECK(!Loaded.Load(Path));
+    CHECK(!Loaded.IsValid());
+
+    // A payload shorter than the header says.
+    CHECK(PVS->Save(Path));
+    std::filesystem::resize_file(Path, std::filesystem::file_size(Path) - 1u);
+    CHECK(!Loaded.Load(Path));
+    CHECK(!Loaded.IsValid());
+
+    std::filesystem::remove(Path);
+    CHECK(!Loaded.Load(Path));
+}
+
+TEST(PVS, PlacementHashIgnoresTinyDifferences)
+{
+    Dx::XMFLOAT4X4 WorldMatrix{};
+    Dx::XMStoreFloat4x4(&WorldMatrix, Dx::XMMatrixTranslation(1.f, 2.f, 3.f));
+    FAABB Bounds{};
+    Bounds.Expand(XMFLOAT3{ 0.f, 1.f, 2.f });
+    Bounds.Expand(XMFLOAT3{ 2.f, 3.f, 4.f });
+
+    const uint64_t Hash = FPVS::HashScenePlacement(std::span(&WorldMatrix, 1u), std::span(&Bounds, 1u));
+
+    // Recomposing the same transform lands within the quantum.
+    Dx::XMFLOAT4X4 Recomposed = WorldMatrix;
+    Recomposed.m[3][0] += 1.e-5f;
+    CHECK(FPVS::HashScenePlacement(std::span(&Recomposed, 1u), std::span(&Bounds, 1u)) == Hash);
+
+    Dx::XMFLOAT4X4 Moved = WorldMatrix;
+    Moved.m[3][0] += 0.5f;
+    CHECK(FPVS::HashScenePlacement(std::span(&Moved, 1u), std::span(&Bounds, 1u)) != Hash);
+
+    // The mesh count is part of the hash.
+    CHECK(FPVS::HashScenePlacement({}, {}) != Hash);
+}
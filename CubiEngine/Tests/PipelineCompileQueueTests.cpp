@@ -0,0 +1,215 @@
+#include "Test.h"
+#include "Graphics/PipelineCompileQueue.h"
+
+namespace
+{
+    constexpr uint32_t NUM_TEST_WORKERS = 4u;
+
+    // FPipelineCompileQueue schedules on GJobSystem. Declared before the queue, so the queue waits for its
+    // compiles before the workers go away.
+    class FScopedJobSystem
+    {
+    public:
+        explicit FScopedJobSystem(uint32_t NumWorkers) { CreateJobSystem(NumWorkers); }
+        ~FScopedJobSystem() { ReleaseJobSystem(); }
+    };
+
+    // Holds mock compiles back until the test lets them finish.
+    class FGate
+    {
+    public:
+        void Wait()
+        {
+            std::unique_lock Lock(Mutex);
+            Condition.wait(Lock, [this]() { return bOpen; });
+        }
+
+        void Open()
+        {
+            {
+                std::lock_guard Lock(Mutex);
+                bOpen = true;
+            }
+            Condition.notify_all();
+        }
+
+    private:
+        std::mutex Mutex;
+        std::condition_variable Condition;
+        bool bOpen = false;
+    };
+
+    // Mock pipeline, stands in for the compiled shaders and PSO.
+    struct FMockPipeline
+    {
+        uint32_t Id = 0u;
+        std::thread::id CompiledOn{};
+    };
+}
+
+TEST(PipelineCompileQueue, CompilesInlineWithoutJobSystem)
+{
+    CHECK(GJobSystem == nullptr);
+
+    FPipelineCompileQueue Queue;
+    const TCompileFuture<FMockPipeline> Future = Queue.Enqueue<FMockPipeline>([]()
+    {
+        return FMockPipeline{ 7u, std::this_thread::get_id() };
+    });
+
+    CHECK(Future.IsReady());
+    CHECK(Future.Get().Id == 7u);
+    CHECK(Future.Get().CompiledOn == std::this_thread::get_id());
+    CHECK(Queue.GetNumPending() == 0u);
+}
+
+TEST(PipelineCompileQueue, CompilesOverlapAcrossWorkers)
+{
+    FScopedJobSystem JobSystem(NUM_TEST_WORKERS);
+    FPipelineCompileQueue Queue;
+
+    // Every compile waits for all of them to have started, which only finishes if they run at the same time.
+    std::atomic<uint32_t> NumStarted{ 0u };
+    std::vector<TCompileFuture<FMockPipeline>> Futures;
+    for (uint32_t i = 0; i < NUM_TEST_WORKERS; i++)
+    {
+        Futures.push_back(Queue.Enqueue<FMockPipeline>([&NumStarted, i]()
+        {
+            NumStarted.fetch_add(1u);
+            const auto Deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+            while (NumStarted.load() < NUM_TEST_WORKERS && std::chrono::steady_clock::now() < Deadline)
+            {
+                std::this_thread::yield();
+            }
+            return FMockPipeline{ i, std::this_thread::get_id() };
+        }));
+    }
+
+    std::vector<std::thread::id> Threads;
+    for (uint32_t i = 0; i < NUM_TEST_WORKERS; i++)
+    {
+        CHECK(Futures[i].Get().Id == i);
+        Threads.push_back(Futures[i].Get().CompiledOn);
+    }
+    CHECK(NumStarted.load() == NUM_TEST_WORKERS);
+
+    std::sort(Threads.begin(), Threads.end());
+    CHECK(std::unique(Threads.begin(), Threads.end()) == Threads.end());
+    CHECK(Queue.GetNumEnqueued() == NUM_TEST_WORKERS);
+}
+
+TEST(PipelineCompileQueue, PendingUntilCompileFinishes)
+{
+    FScopedJobSystem JobSystem(NUM_TEST_WORKERS);
+    FPipelineCompileQueue Queue;
+
+    FGate Gate;
+    const TCompileFuture<FMockPipeline> Future = Queue.Enqueue<FMockPipeline>([&Gate]()
+    {
+        Gate.Wait();
+        return FMockPipeline{ 3u };
+    });
+
+    // What FRenderPass::IsReady sees, an optional pass is skipped this frame.
+    CHECK(!Future.IsReady());
+    CHECK(Queue.GetNumPending() == 1u);
+
+    Gate.Open();
+    CHECK(Future.Get().Id == 3u);
+    CHECK(Future.IsReady());
+    CHECK(Queue.GetNumPending() == 0u);
+}
+
+TEST(PipelineCompileQueue, ErrorsRethrowOnGet)
+{
+    FScopedJobSystem JobSystem(NUM_TEST_WORKERS);
+    FPipelineCompileQueue Queue;
+
+    const TCompileFuture<FMockPipeline> Failing = Queue.Enqueue<FMockPipeline>([]() -> FMockPipeline
+    {
+        throw std::runtime_error("Shader compile failed.");
+    });
+    const TCompileFuture<FMockPipeline> Succeeding = Queue.Enqueue<FMockPipeline>([]() { return FMockPipeline{ 1u }; });
+
+    bool bThrew = false;
+    try
+    {
+        Failing.Get();
+    }
+    catch (const std::runtime_error& Error)
+    {
+        bThrew = std::string_view(Error.what()) == "Shader compile failed.";
+    }
+    CHECK(bThrew);
+
+    // One failure does not take the worker or the other compiles down.
+    CHECK(Succeeding.Get().Id == 1u);
+}
+
+TEST(PipelineCompileQueue, WaitAllCoversDroppedFutures)
+{
+    FScopedJobSystem JobSystem(NUM_TEST_WORKERS);
+    FPipelineCompileQueue Queue;
+
+    constexpr uint32_t NumCompiles = 64u;
+    std::atomic<uint32_t> NumCompiled{ 0u };
+    for (uint32_t i = 0; i < NumCompiles; i++)
+    {
+        Queue.Enqueue<FMockPipeline>([&NumCompiled]()
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            NumCompiled.fetch_add(1u);
+            return FMockPipeline{};
+        });
+    }
+
+    Queue.WaitAll();
+    CHECK(NumCompiled.load() == NumCompiles);
+    CHECK(Queue.GetNumPending() == 0u);
+}
+
+TEST(PipelineCompileQueue, GetOnWorkerRunsOtherCompiles)
+{
+    // A single worker waiting on a compile it depends on must run that compile itself rather than deadlock.
+    FScopedJobSystem JobSystem(1u);
+    FPipelineCompileQueue Queue;
+
+    const TCompileFuture<FMockPipeline> Outer = Queue.Enqueue<FMockPipeline>([&Queue]()
+    {
+        const TCompileFuture<FMockPipeline> Inner = Queue.Enqueue<FMockPipeline>([]() { return FMockPipeline{ 5u }; });
+        return FMockPipeline{ Inner.Get().Id + 1u };
+    });
+
+    CHECK(Outer.Get().Id == 6u);
+}
+
+TEST(PipelineCompileBenchmark, StartupScaling)
+{
+    // 32 pipelines of 20 ms each, roughly what the startup set costs.
+    constexpr uint32_t NumPipelines = 32u;
+    constexpr auto CompileTime = std::chrono::milliseconds(20);
+
+    const uint32_t MaxWorkers = max(1u, std::thread::hardware_concurrency());
+    for (uint32_t NumWorkers = 1u; NumWorkers <= MaxWorkers; NumWorkers *= 2u)
+    {
+        FScopedJobSystem JobSystem(NumWorkers);
+        FPipelineCompileQueue Queue;
+
+        const FBenchmarkTimer Timer;
+        std::vector<TCompileFuture<FMockPipeline>> Futures;
+        for (uint32_t i = 0; i < NumPipelines; i++)
+        {
+            Futures.push_back(Queue.Enqueue<FMockPipeline>([CompileTime, i]()
+            {
+                std::this_thread::sleep_for(CompileTime);
+                return FMockPipeline{ i };
+            }));
+        }
+        for (const TCompileFuture<FMockPipeline>& Future : Futures)
+        {
+            Future.Get();
+        }
+
+        Log(std::format("{} workers : {} compiles in {:.2f} ms", NumWorkers, NumPipelines, Timer.GetElapsedMs()));
+    }
+}
@@ -0,0 +1,365 @@
+#include "Test.h"
+#include "Renderer/RenderGraph.h"
+
+namespace
+{
+    // Compile never runs the passes.
+    const FRenderGraph::FExecuteFunction NoExecute = [](FGraphicsContext*) {};
+
+    FTextureCreationDesc MakeDesc(ETextureUsage Usage, DXGI_FORMAT Format = DXGI_FORMAT_R16G16B16A16_FLOAT,
+        D3D12_RESOURCE_STATES InitialState = D3D12_RESOURCE_STATE_COMMON)
+    {
+        return FTextureCreationDesc{ .Usage = Usage, .Width = 1920u, .Height = 1080u, .Format = Format, .InitialState = InitialState };
+    }
+
+    // A texture the graph does not own, never backed by a resource : the graph only reads its description and state.
+    std::unique_ptr<FTexture> MakeImported(ETextureUsage Usage, D3D12_RESOURCE_STATES State)
+    {
+        std::unique_ptr<FTexture> Texture = std::make_unique<FTexture>();
+        Texture->Usage = Usage;
+        Texture->Width = 1920u;
+        Texture->Height = 1080u;
+        Texture->Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        Texture->ResourceState = State;
+        return Texture;
+    }
+
+    FRGBarrier Transition(FRGTextureHandle Texture, D3D12_RESOURCE_STATES Before, D3D12_RESOURCE_STATES After)
+    {
+        return FRGBarrier{ .Texture = Texture, .Type = ERGBarrierType::Transition, .StateBefore = Before, .StateAfter = After };
+    }
+
+    FRGBarrier UAVBarrier(FRGTextureHandle Texture)
+    {
+        return FRGBarrier{ .Texture = Texture, .Type = ERGBarrierType::UAV,
+            .StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS, .StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS };
+    }
+
+    template<typename T>
+    std::vector<T> ToVector(std::span<const T> Span)
+    {
+        return std::vector<T>(Span.begin(), Span.end());
+    }
+
+    using FBarriers = std::vector<FRGBarrier>;
+    using FPasses = std::vector<uint32_t>;
+}
+
+TEST(RenderGraph, CullsPassesNothingDependsOn)
+{
+    FRenderGraph Graph;
+    const FRGTextureHandle Output = Graph.CreateTexture(MakeDesc(ETextureUsage::RenderTarget));
+    const FRGTextureHandle Unused = Graph.CreateTexture(MakeDesc(ETextureUsage::RenderTarget));
+    const FRGTextureHandle UnusedToo = Graph.CreateTexture(MakeDesc(ETextureUsage::RenderTarget));
+
+    const uint32_t Draw = Graph.AddPass("Draw", { RGWrite(Output, D3D12_RESOURCE_STATE_RENDER_TARGET) }, NoExecute);
+    const uint32_t Orphan = Graph.AddPass("Orphan", { RGWrite(Unused, D3D12_RESOURCE_STATE_RENDER_TARGET) }, NoExecute);
+    const uint32_t OrphanReader = Graph.AddPass("OrphanReader", { RGRead(Unused, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE), RGWrite(UnusedToo, D3D12_RESOURCE_STATE_RENDER_TARGET) }, NoExecute);
+    // A write is not assumed to cover the whole texture, Draw stays needed.
+    const uint32_t Overwrite = Graph.AddPass("Overwrite", { RGWrite(Output, D3D12_RESOURCE_STATE_UNORDERED_ACCESS) }, NoExecute);
+    const uint32_t SideEffect = Graph.AddPass("SideEffect", {}, NoExecute, RenderGraphPassFlag_NeverCull);
+    Graph.ExportTexture(Output);
+    Graph.Compile();
+
+    CHECK(!Graph.IsPassCulled(Draw) && !Graph.IsPassCulled(Overwrite) && !Graph.IsPassCulled(SideEffect));
+    CHECK(Graph.IsPassCulled(Orphan) && Graph.IsPassCulled(OrphanReader));
+    CHECK(ToVector(Graph.GetExecutionOrder()) == (FPasses{ Draw, Overwrite, SideEffect }));
+    CHECK(ToVector(Graph.GetDependencies(Overwrite)) == FPasses{ Draw });
+    CHECK(Graph.GetStats().NumPasses == 5u);
+    CHECK(Graph.GetStats().NumCulledPasses == 2u);
+
+    // Textures only culled passes use get no memory and no barriers.
+    CHECK(Graph.GetPhysicalTexture(Unused) == INVALID_INDEX_U32);
+    CHECK(Graph.GetPhysicalTexture(UnusedToo) == INVALID_INDEX_U32);
+    CHECK(Graph.GetStats().NumTransientTextures == 1u);
+    CHECK(ToVector(Graph.GetBarriers(Draw)) == FBarriers{ Transition(Output, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET) });
+    CHECK(ToVector(Graph.GetBarriers(Overwrite)) == FBarriers{ Transition(Output, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_UNORDERED_ACCESS) });
+    CHECK(Graph.GetBarriers(SideEffect).empty());
+    CHECK(Graph.GetFinalBarriers().empty());
+    CHECK(Graph.GetStats().NumBarriers == 2u);
+}
+
+TEST(RenderGraph, ConsecutiveReadsShareOneTransition)
+{
+    FRenderGraph Graph;
+    const FRGTextureHandle Color = Graph.CreateTexture(MakeDesc(ETextureUsage::RenderTarget));
+    const uint32_t Draw = Graph.AddPass("Draw", { RGWrite(Color, D3D12_RESOURCE_STATE_RENDER_TARGET) }, NoExecute);
+    const uint32_t PixelRead = Graph.AddPass("PixelRead", { RGRead(Color, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE) }, NoExecute, RenderGraphPassFlag_NeverCull);
+    const uint32_t ComputeRead = Graph.AddPass("ComputeRead", { RGRead(Color, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE) }, NoExecute, RenderGraphPassFlag_NeverCull);
+    const uint32_t Copy = Graph.AddPass("Copy", { RGRead(Color, D3D12_RESOURCE_STATE_COPY_SOURCE) }, NoExecute, RenderGraphPassFlag_NeverCull);
+    const uint32_t Redraw = Graph.AddPass("Redraw", { RGWrite(Color, D3D12_RESOURCE_STATE_RENDER_TARGET) }, NoExecute);
+    const uint32_t LastRead = Graph.AddPass("LastRead", { RGRead(Color, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE) }, NoExecute, RenderGraphPassFlag_NeverCull);
+    Graph.ExportTexture(Color);
+    Graph.Compile();
+
+    // Every read up to the next write is covered by the first reader's barrier.
+    const D3D12_RESOURCE_STATES MergedState = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE
+        | D3D12_RESOURCE_STATE_COPY_SOURCE;
+    CHECK(ToVector(Graph.GetBarriers(Draw)) == FBarriers{ Transition(Color, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET) });
+    CHECK(ToVector(Graph.GetBarriers(PixelRead)) == FBarriers{ Transition(Color, D3D12_RESOURCE_STATE_RENDER_TARGET, MergedState) });
+    CHECK(Graph.GetBarriers(ComputeRead).empty());
+    CHECK(Graph.GetBarriers(Copy).empty());
+    CHECK(ToVector(Graph.GetBarriers(Redraw)) == FBarriers{ Transition(Color, MergedState, D3D12_RESOURCE_STATE_RENDER_TARGET) });
+    CHECK(ToVector(Graph.GetBarriers(LastRead)) == FBarriers{ Transition(Color, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE) });
+    CHECK(Graph.GetStats().NumBarriers == 4u);
+
+    // The writer waits for every reader of the previous contents.
+    CHECK(ToVector(Graph.GetDependencies(Redraw)) == (FPasses{ Draw, PixelRead, ComputeRead, Copy }));
+    CHECK(ToVector(Graph.GetDependencies(LastRead)) == FPasses{ Redraw });
+
+    // Depth testing against a depth buffer still bound for writing needs no transition.
+    FRenderGraph DepthGraph;
+    const FRGTextureHandle Depth = DepthGraph.CreateTexture(MakeDesc(ETextureUsage::DepthStencil, DXGI_FORMAT_D32_FLOAT, D3D12_RESOURCE_STATE_DEPTH_WRITE));
+    const FRGTextureHandle Lit = DepthGraph.CreateTexture(MakeDesc(ETextureUsage::RenderTarget));
+    const uint32_t DepthPrepass = DepthGraph.AddPass("DepthPrepass", { RGWrite(Depth, D3D12_RESOURCE_STATE_DEPTH_WRITE) }, NoExecute);
+    const uint32_t Lighting = DepthGraph.AddPass("Lighting", { RGRead(Depth, D3D12_RESOURCE_STATE_DEPTH_READ), RGWrite(Lit, D3D12_RESOURCE_STATE_RENDER_TARGET) }, NoExecute);
+    DepthGraph.ExportTexture(Lit);
+    DepthGraph.Compile();
+
+    CHECK(DepthGraph.GetBarriers(DepthPrepass).empty());
+    CHECK(ToVector(DepthGraph.GetBarriers(Lighting)) == FBarriers{ Transition(Lit, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET) });
+}
+
+TEST(RenderGraph, UAVBarriersOnlyBetweenWrites)
+{
+    FRenderGraph Graph;
+    const FRGTextureHandle Buffer = Graph.CreateTexture(MakeDesc(ETextureUsage::UAVTexture));
+    const uint32_t Clear = Graph.AddPass("Clear", { RGWrite(Buffer, D3D12_RESOURCE_STATE_UNORDERED_ACCESS) }, NoExecute);
+    const uint32_t Accumulate = Graph.AddPass("Accumulate", { RGWrite(Buffer, D3D12_RESOURCE_STATE_UNORDERED_ACCESS) }, NoExecute);
+    const uint32_t ReadA = Graph.AddPass("ReadA", { RGRead(Buffer, D3D12_RESOURCE_STATE_UNORDERED_ACCESS) }, NoExecute, RenderGraphPassFlag_NeverCull);
+    const uint32_t ReadB = Graph.AddPass("ReadB", { RGRead(Buffer, D3D12_RESOURCE_STATE_UNORDERED_ACCESS) }, NoExecute, RenderGraphPassFlag_NeverCull);
+    const uint32_t Resolve = Graph.AddPass("Resolve", { RGWrite(Buffer, D3D12_RESOURCE_STATE_UNORDERED_ACCESS) }, NoExecute);
+    const uint32_t Sample = Graph.AddPass("Sample", { RGRead(Buffer, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE) }, NoExecute, RenderGraphPassFlag_NeverCull);
+    Graph.ExportTexture(Buffer);
+    Graph.Compile();
+
+    CHECK(ToVector(Graph.GetBarriers(Clear)) == FBarriers{ Transition(Buffer, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS) });
+    // Write after write, read after write, write after read.
+    CHECK(ToVector(Graph.GetBarriers(Accumulate)) == FBarriers{ UAVBarrier(Buffer) });
+    CHECK(ToVector(Graph.GetBarriers(ReadA)) == FBarriers{ UAVBarrier(Buffer) });
+    // Two readers do not wait for each other.
+    CHECK(Graph.GetBarriers(ReadB).empty());
+    CHECK(ToVector(Graph.GetBarriers(Resolve)) == FBarriers{ UAVBarrier(Buffer) });
+    CHECK(ToVector(Graph.GetBarriers(Sample)) == FBarriers{ Transition(Buffer, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE) });
+    CHECK(Graph.GetStats().NumBarriers == 5u);
+}
+
+TEST(RenderGraph, DisjointLifetimesShareAPhysicalTexture)
+{
+    FRenderGraph Graph;
+    const FRGTextureHandle GBuffer = Graph.CreateTexture(MakeDesc(ETextureUsage::RenderTarget));
+    const FRGTextureHandle Lighting = Graph.CreateTexture(MakeDesc(ETextureUsage::RenderTarget));
+    const FRGTextureHandle Bloom = Graph.CreateTexture(MakeDesc(ETextureUsage::RenderTarget, DXGI_FORMAT_R8G8B8A8_UNORM));
+    const FRGTextureHandle Composite = Graph.CreateTexture(MakeDesc(ETextureUsage::RenderTarget));
+    const std::unique_ptr<FTexture> BackBuffer = MakeImported(ETextureUsage::RenderTarget, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    const FRGTextureHandle Output = Graph.ImportTexture(BackBuffer.get());
+
+    const uint32_t GBufferPass = Graph.AddPass("GBuffer", { RGWrite(GBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET) }, NoExecute);
+    const uint32_t LightingPass = Graph.AddPass("Lighting", { RGRead(GBuffer, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE), RGWrite(Lighting, D3D12_RESOURCE_STATE_RENDER_TARGET) }, NoExecute);
+    const uint32_t BloomPass = Graph.AddPass("Bloom", { RGRead(Lighting, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE), RGWrite(Bloom, D3D12_RESOURCE_STATE_RENDER_TARGET) }, NoExecute);
+    const uint32_t CompositePass = Graph.AddPass("Composite", { RGRead(Bloom, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE), RGWrite(Composite, D3D12_RESOURCE_STATE_RENDER_TARGET) }, NoExecute);
+    const uint32_t OutputPass = Graph.AddPass("Output", { RGRead(Composite, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE), RGWrite(Output, D3D12_RESOURCE_STATE_RENDER_TARGET) }, NoExecute);
+    Graph.ExportTexture(Output, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    Graph.Compile();
+
+    CHECK(Graph.GetLifetime(GBuffer).FirstPass == 0u && Graph.GetLifetime(GBuffer).LastPass == 1u);
+    CHECK(Graph.GetLifetime(Composite).FirstPass == 3u && Graph.GetLifetime(Composite).LastPass == 4u);
+
+    // Composite takes the GBuffer's texture over : same description, and the GBuffer's last reader ran before. Lighting
+    // overlaps the GBuffer at the lighting pass and Bloom has another format.
+    CHECK(Graph.GetPhysicalTexture(Composite) == Graph.GetPhysicalTexture(GBuffer));
+    CHECK(Graph.GetPhysicalTexture(Lighting) != Graph.GetPhysicalTexture(GBuffer));
+    CHECK(Graph.GetPhysicalTexture(Bloom) != Graph.GetPhysicalTexture(GBuffer));
+    CHECK(Graph.GetPhysicalTexture(Bloom) != Graph.GetPhysicalTexture(Lighting));
+    CHECK(Graph.GetStats().NumTransientTextures == 4u);
+    CHECK(Graph.GetStats().NumPhysicalTextures == 3u);
+    CHECK(Graph.GetNumPhysicalTextures() == 4u);
+
+    CHECK(ToVector(Graph.GetBarriers(GBufferPass)) == FBarriers{ Transition(GBuffer, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET) });
+    CHECK(ToVector(Graph.GetBarriers(LightingPass)) == (FBarriers{
+        Transition(GBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE),
+        Transition(Lighting, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET) }));
+    CHECK(ToVector(Graph.GetBarriers(BloomPass)) == (FBarriers{
+        Transition(Lighting, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE),
+        Transition(Bloom, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET) }));
+    // The shared texture goes on from the state the GBuffer left it in.
+    CHECK(ToVector(Graph.GetBarriers(CompositePass)) == (FBarriers{
+        Transition(Bloom, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE),
+        Transition(Composite, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET) }));
+    // Imported textures start from their current state.
+    CHECK(ToVector(Graph.GetBarriers(OutputPass)) == (FBarriers{
+        Transition(Composite, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE),
+        Transition(Output, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET) }));
+    CHECK(ToVector(Graph.GetFinalBarriers()) == FBarriers{ Transition(Output, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE) });
+}
+
+TEST(RenderGraph, FinalBarriersLeaveExportsInTheirFinalState)
+{
+    FRenderGraph Graph;
+    const FRGTextureHandle Written = Graph.CreateTexture(MakeDesc(ETextureUsage::RenderTarget));
+    const FRGTextureHandle NoFinalState = Graph.CreateTexture(MakeDesc(ETextureUsage::RenderTarget));
+    const FRGTextureHandle Depth = Graph.CreateTexture(MakeDesc(ETextureUsage::DepthStencil, DXGI_FORMAT_D32_FLOAT, D3D12_RESOURCE_STATE_DEPTH_WRITE));
+    const FRGTextureHandle NeverUsed = Graph.CreateTexture(MakeDesc(ETextureUsage::RenderTarget));
+    const std::unique_ptr<FTexture> History = MakeImported(ETextureUsage::RenderTarget, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+    const std::unique_ptr<FTexture> Untouched = MakeImported(ETextureUsage::UAVTexture, D3D12_RESOURCE_STATE_COMMON);
+    const FRGTextureHandle HistoryHandle = Graph.ImportTexture(History.get());
+    const FRGTextureHandle UntouchedHandle = Graph.ImportTexture(Untouched.get());
+
+    Graph.AddPass("Draw", { RGRead(HistoryHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE), RGWrite(Written, D3D12_RESOURCE_STATE_RENDER_TARGET),
+        RGWrite(NoFinalState, D3D12_RESOURCE_STATE_RENDER_TARGET), RGWrite(Depth, D3D12_RESOURCE_STATE_DEPTH_WRITE) }, NoExecute);
+
+    Graph.ExportTexture(Written, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    Graph.ExportTexture(NoFinalState);
+    // Already in a state covering the final one.
+    Graph.ExportTexture(Depth, D3D12_RESOURCE_STATE_DEPTH_READ);
+    Graph.ExportTexture(HistoryHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+    // A transient texture no pass uses has no memory to transition, an imported one still does.
+    Graph.ExportTexture(NeverUsed, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    Graph.ExportTexture(UntouchedHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+    Graph.Compile();
+
+    CHECK(ToVector(Graph.GetBarriers(0u)) == (FBarriers{
+        Transition(Written, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET),
+        Transition(NoFinalState, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET) }));
+    CHECK(ToVector(Graph.GetFinalBarriers()) == (FBarriers{
+        Transition(Written, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE),
+        Transition(UntouchedHandle, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE) }));
+    CHECK(Graph.GetStats().NumBarriers == 4u);
+}
+
+TEST(RenderGraph, AsyncComputeWaitsRightBeforeItIsNeeded)
+{
+    FRenderGraph Graph;
+    const FRGTextureHandle Normals = Graph.CreateTexture(MakeDesc(ETextureUsage::RenderTarget));
+    const FRGTextureHandle AmbientOcclusion = Graph.CreateTexture(MakeDesc(ETextureUsage::UAVTexture));
+    const FRGTextureHandle ShadowMap = Graph.CreateTexture(MakeDesc(ETextureUsage::DepthStencil, DXGI_FORMAT_D32_FLOAT, D3D12_RESOURCE_STATE_DEPTH_WRITE));
+    const FRGTextureHandle Output = Graph.CreateTexture(MakeDesc(ETextureUsage::RenderTarget));
+
+    const uint32_t GBuffer = Graph.AddPass("GBuffer", { RGWrite(Normals, D3D12_RESOURCE_STATE_RENDER_TARGET) }, NoExecute);
+    const uint32_t SSAO = Graph.AddPass("SSAO", { RGRead(Normals, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+        RGWrite(AmbientOcclusion, D3D12_RESOURCE_STATE_UNORDERED_ACCESS) }, NoExecute, RenderGraphPassFlag_AsyncCompute);
+    const uint32_t Shadows = Graph.AddPass("Shadows", { RGWrite(ShadowMap, D3D12_RESOURCE_STATE_DEPTH_WRITE) }, NoExecute);
+    const uint32_t Lighting = Graph.AddPass("Lighting", { RGRead(Normals, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE),
+        RGRead(AmbientOcclusion, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE), RGRead(ShadowMap, D3D12_RESOURCE_STATE_DEPTH_READ),
+        RGWrite(Output, D3D12_RESOURCE_STATE_RENDER_TARGET) }, NoExecute);
+    Graph.ExportTexture(Output);
+    Graph.Compile();
+
+    CHECK(Graph.GetPassQueue(SSAO) == ERGQueue::AsyncCompute);
+    CHECK(Graph.GetPassQueue(Shadows) == ERGQueue::Graphics);
+    CHECK(Graph.GetStats().NumAsyncComputePasses == 1u);
+
+    // SSAO waits for the GBuffer and nothing else, Shadows overlaps it, Lighting waits for it. The wait after the
+    // last pass is already covered by Lighting's.
+    CHECK(ToVector(Graph.GetQueueWaits()) == (std::vector<FRGQueueWait>{
+        FRGQueueWait{ .Queue = ERGQueue::AsyncCompute, .Position = 1u, .SignalQueue = ERGQueue::Graphics, .SignalPosition = 0u },
+        FRGQueueWait{ .Queue = ERGQueue::Graphics, .Position = 3u, .SignalQueue = ERGQueue::AsyncCompute, .SignalPosition = 1u } }));
+    CHECK(Graph.GetStats().NumQueueWaits == 2u);
+
+    // The compute queue cannot take the normals out of RENDER_TARGET, the GBuffer pass does it once done.
+    CHECK(ToVector(Graph.GetBarriers(GBuffer)) == FBarriers{ Transition(Normals, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET) });
+    CHECK(ToVector(Graph.GetPostBarriers(GBuffer)) == FBarriers{ Transition(Normals, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE) });
+    CHECK(ToVector(Graph.GetBarriers(SSAO)) == FBarriers{ Transition(AmbientOcclusion, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS) });
+    CHECK(Graph.GetBarriers(Shadows).empty());
+    CHECK(ToVector(Graph.GetBarriers(Lighting)) == (FBarriers{
+        Transition(Normals, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE),
+        Transition(AmbientOcclusion, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE),
+        Transition(Output, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET) }));
+    CHECK(Graph.GetPrologueBarriers().empty());
+}
+
+TEST(RenderGraph, AsyncComputeSkipsWaitsAnEarlierOneCovers)
+{
+    FRenderGraph Graph;
+    const FRGTextureHandle Normals = Graph.CreateTexture(MakeDesc(ETextureUsage::RenderTarget));
+    const FRGTextureHandle First = Graph.CreateTexture(MakeDesc(ETextureUsage::UAVTexture));
+    const FRGTextureHandle Second = Graph.CreateTexture(MakeDesc(ETextureUsage::UAVTexture));
+    const FRGTextureHandle OutputA = Graph.CreateTexture(MakeDesc(ETextureUsage::RenderTarget, DXGI_FORMAT_R8G8B8A8_UNORM));
+    const FRGTextureHandle OutputB = Graph.CreateTexture(MakeDesc(ETextureUsage::RenderTarget, DXGI_FORMAT_R8G8B8A8_UNORM));
+
+    Graph.AddPass("GBuffer", { RGWrite(Normals, D3D12_RESOURCE_STATE_RENDER_TARGET) }, NoExecute);
+    Graph.AddPass("ComputeA", { RGRead(Normals, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+        RGWrite(First, D3D12_RESOURCE_STATE_UNORDERED_ACCESS) }, NoExecute, RenderGraphPassFlag_AsyncCompute);
+    // Needs the GBuffer too, the compute queue already waited for it.
+    const uint32_t ComputeB = Graph.AddPass("ComputeB", { RGRead(Normals, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+        RGWrite(Second, D3D12_RESOURCE_STATE_UNORDERED_ACCESS) }, NoExecute, RenderGraphPassFlag_AsyncCompute);
+    const uint32_t UseSecond = Graph.AddPass("UseSecond", { RGRead(Second, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+        RGWrite(OutputA, D3D12_RESOURCE_STATE_RENDER_TARGET) }, NoExecute);
+    // Needs ComputeA, which ran before ComputeB on the same queue.
+    const uint32_t UseFirst = Graph.AddPass("UseFirst", { RGRead(First, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+        RGWrite(OutputB, D3D12_RESOURCE_STATE_RENDER_TARGET) }, NoExecute);
+    Graph.ExportTexture(OutputA);
+    Graph.ExportTexture(OutputB);
+    Graph.Compile();
+
+    CHECK(ToVector(Graph.GetQueueWaits()) == (std::vector<FRGQueueWait>{
+        FRGQueueWait{ .Queue = ERGQueue::AsyncCompute, .Position = 1u, .SignalQueue = ERGQueue::Graphics, .SignalPosition = 0u },
+        FRGQueueWait{ .Queue = ERGQueue::Graphics, .Position = 3u, .SignalQueue = ERGQueue::AsyncCompute, .SignalPosition = 2u } }));
+
+    // One transition covers both compute readers.
+    CHECK(ToVector(Graph.GetBarriers(ComputeB)) == FBarriers{ Transition(Second, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS) });
+    CHECK(ToVector(Graph.GetBarriers(UseSecond)) == (FBarriers{
+        Transition(Second, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+        Transition(OutputA, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET) }));
+    CHECK(ToVector(Graph.GetBarriers(UseFirst)) == (FBarriers{
+        Transition(First, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+        Transition(OutputB, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET) }));
+}
+
+TEST(RenderGraph, AsyncComputeWaitsForTheGraphicsBarrierItUses)
+{
+    // A graphics reader merges in the compute reader's state, so the transition stays on the graphics pass and the
+    // compute pass waits for that pass rather than for the writer.
+    FRenderGraph Graph;
+    const FRGTextureHandle Color = Graph.CreateTexture(MakeDesc(ETextureUsage::RenderTarget));
+    const uint32_t Draw = Graph.AddPass("Draw", { RGWrite(Color, D3D12_RESOURCE_STATE_RENDER_TARGET) }, NoExecute);
+    const uint32_t GraphicsRead = Graph.AddPass("GraphicsRead", { RGRead(Color, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE) }, NoExecute, RenderGraphPassFlag_NeverCull);
+    const uint32_t ComputeRead = Graph.AddPass("ComputeRead", { RGRead(Color, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE) }, NoExecute,
+        RenderGraphPassFlag_NeverCull | RenderGraphPassFlag_AsyncCompute);
+    Graph.Compile();
+
+    CHECK(ToVector(Graph.GetBarriers(GraphicsRead)) == FBarriers{ Transition(Color, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE) });
+    CHECK(Graph.GetPostBarriers(Draw).empty());
+    CHECK(Graph.GetPostBarriers(GraphicsRead).empty());
+    CHECK(Graph.GetBarriers(ComputeRead).empty());
+
+    // The graphics queue also waits for the compute queue before whatever comes after the graph.
+    CHECK(ToVector(Graph.GetQueueWaits()) == (std::vector<FRGQueueWait>{
+        FRGQueueWait{ .Queue = ERGQueue::AsyncCompute, .Position = 2u, .SignalQueue = ERGQueue::Graphics, .SignalPosition = 1u },
+        FRGQueueWait{ .Queue = ERGQueue::Graphics, .Position = 3u, .SignalQueue = ERGQueue::AsyncCompute, .SignalPosition = 2u } }));
+}
+
+TEST(RenderGraph, TransitionsTheComputeQueueCannotMakeMoveToGraphics)
+{
+    FRenderGraph Graph;
+    const std::unique_ptr<FTexture> History = MakeImported(ETextureUsage::RenderTarget, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    const FRGTextureHandle HistoryHandle = Graph.ImportTexture(History.get());
+    const FRGTextureHandle Color = Graph.CreateTexture(MakeDesc(ETextureUsage::RenderTarget));
+    const FRGTextureHandle Result = Graph.CreateTexture(MakeDesc(ETextureUsage::UAVTexture));
+
+    const uint32_t Reproject = Graph.AddPass("Reproject", { RGRead(HistoryHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+        RGWrite(Result, D3D12_RESOURCE_STATE_UNORDERED_ACCESS) }, NoExecute, RenderGraphPassFlag_AsyncCompute);
+    const uint32_t Draw = Graph.AddPass("Draw", { RGWrite(Color, D3D12_RESOURCE_STATE_RENDER_TARGET) }, NoExecute);
+    const uint32_t Filter = Graph.AddPass("Filter", { RGRead(Color, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE),
+        RGWrite(Result, D3D12_RESOURCE_STATE_UNORDERED_ACCESS) }, NoExecute, RenderGraphPassFlag_AsyncCompute);
+    Graph.ExportTexture(Result, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    Graph.Compile();
+
+    // Used first by the compute queue out of a graphics state : the graphics queue transitions it before the graph.
+    CHECK(ToVector(Graph.GetPrologueBarriers()) == FBarriers{
+        Transition(HistoryHandle, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE) });
+    CHECK(ToVector(Graph.GetBarriers(Reproject)) == FBarriers{ Transition(Result, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS) });
+
+    // Used next by the compute queue : the last graphics pass using it transitions it after it runs.
+    CHECK(ToVector(Graph.GetBarriers(Draw)) == FBarriers{ Transition(Color, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET) });
+    CHECK(ToVector(Graph.GetPostBarriers(Draw)) == FBarriers{ Transition(Color, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE) });
+    CHECK(ToVector(Graph.GetBarriers(Filter)) == FBarriers{ UAVBarrier(Result) });
+
+    // The final transition runs on the graphics queue, after it waited for the compute queue.
+    CHECK(ToVector(Graph.GetFinalBarriers()) == FBarriers{ Transition(Result, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE) });
+    CHECK(ToVector(Graph.GetQueueWaits()) == (std::vector<FRGQueueWait>{
+        FRGQueueWait{ .Queue = ERGQueue::AsyncCompute, .Position = 0u, .SignalQueue = ERGQueue::Graphics, .SignalPosition = INVALID_INDEX_U32 },
+        FRGQueueWait{ .Queue = ERGQueue::AsyncCompute, .Position = 2u, .SignalQueue = ERGQueue::Graphics, .SignalPosition = 1u },
+        FRGQueueWait{ .Queue = ERGQueue::Graphics, .Position = 3u, .SignalQueue = ERGQueue::AsyncCompute, .SignalPosition = 2u } }));
+    CHECK(Graph.GetStats().NumBarriers == 6u);
+}
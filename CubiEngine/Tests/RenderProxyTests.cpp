@@ -0,0 +1,178 @@
+#include "Test.h"
+#include "Graphics/Material.h"
+#include "Scene/Mesh.h"
+#include "Scene/RenderProxy.h"
+
+namespace
+{
+    // Meshes without geometry or textures, placed along x so every proxy has its own transform and bounds.
+    class FFakeMeshes
+    {
+    public:
+        explicit FFakeMeshes(uint32_t Count)
+        {
+            for (uint32_t Index = 0; Index < Count; Index++)
+            {
+                std::unique_ptr<FMesh>& Mesh = Meshes.emplace_back(std::make_unique<FMesh>());
+                Mesh->Material = std::make_shared<FPBRMaterial>();
+                Mesh->Material->AlphaMode = static_cast<EAlphaMode>(Index % 3u);
+                Mesh->Transform.SetMatrix(Dx::XMMatrixTranslation(static_cast<float>(Index), 0.f, 0.f));
+                Mesh->LocalBounds.Expand(XMFLOAT3{ -0.5f, -0.5f, -0.5f });
+                Mesh->LocalBounds.Expand(XMFLOAT3{ 0.5f, 0.5f, 0.5f });
+            }
+        }
+
+        FMesh* operator[](uint32_t Index) const { return Meshes[Index].get(); }
+
+    private:
+        std::vector<std::unique_ptr<FMesh>> Meshes;
+    };
+
+    // The proxy a handle resolves to, every array at its dense index has to describe the same mesh.
+    void CheckProxy(const FRenderProxyStore& Store, FRenderProxyHandle Handle, const FMesh* Mesh, uint32_t ObjectId)
+    {
+        const uint32_t DenseIndex = Store.GetDenseIndex(Handle);
+        CHECK(DenseIndex < Store.Num());
+        CHECK(Store.GetMeshes()[DenseIndex] == Mesh);
+        CHECK(Store.GetObjectIds()[DenseIndex] == ObjectId);
+        CHECK(Store.GetPipelineIds()[DenseIndex] == static_cast<uint32_t>(Mesh->Material->AlphaMode));
+        CHECK(Store.GetWorldMatrices()[DenseIndex].m[3][0] == XMVectorGetX(Mesh->GetModelMatrix().r[3]));
+        CHECK(Store.GetWorldBounds()[DenseIndex].Min.x == Store.GetWorldMatrices()[DenseIndex].m[3][0] - 0.5f);
+    }
+}
+
+TEST(RenderProxy, RemoveSwapsTheLastProxyIntoTheHole)
+{
+    const FFakeMeshes Meshes(4u);
+    FRenderProxyStore Store;
+    std::vector<FRenderProxyHandle> Handles;
+    for (uint32_t Index = 0; Index < 4u; Index++)
+    {
+        Handles.push_back(Store.Add(Meshes[Index], 100u + Index));
+        CHECK(Store.GetDenseIndex(Handles.back()) == Index);
+    }
+
+    CHECK(Store.Remove(Handles[1]));
+    CHECK(Store.Num() == 3u);
+    CHECK(!Store.IsValid(Handles[1]));
+
+    // The last proxy moved into the hole and kept its handle and object id, the others did not move.
+    CHECK(Store.GetDenseIndex(Handles[3]) == 1u);
+    CHECK(Store.GetDenseIndex(Handles[0]) == 0u);
+    CHECK(Store.GetDenseIndex(Handles[2]) == 2u);
+    CheckProxy(Store, Handles[0], Meshes[0], 100u);
+    CheckProxy(Store, Handles[2], Meshes[2], 102u);
+    CheckProxy(Store, Handles[3], Meshes[3], 103u);
+
+    // Removing the last proxy moves nothing.
+    CHECK(Store.Remove(Handles[2]));
+    CHECK(Store.Num() == 2u);
+    CheckProxy(Store, Handles[0], Meshes[0], 100u);
+    CheckProxy(Store, Handles[3], Meshes[3], 103u);
+}
+
+TEST(RenderProxy, StaleHandlesNeverResolve)
+{
+    const FFakeMeshes Meshes(3u);
+    FRenderProxyStore Store;
+    const FRenderProxyHandle First = Store.Add(Meshes[0], 0u);
+    const FRenderProxyHandle Second = Store.Add(Meshes[1], 1u);
+
+    CHECK(Store.Remove(First));
+    CHECK(!Store.Remove(First));
+
+    // The freed slot is reused with the next generation, the old handle does not see the new proxy.
+    const FRenderProxyHandle Third = Store.Add(Meshes[2], 2u);
+    CHECK(Third.Slot == First.Slot);
+    CHECK(Third.Generation != First.Generation);
+    CHECK(!Store.IsValid(First));
+    CHECK(Store.GetDenseIndex(First) == FRenderProxyHandle::INVALID_SLOT);
+
+    Store.SetFlags(First, RenderProxyFlag_None);
+    Store.SetTransform(First, Dx::XMMatrixTranslation(50.f, 0.f, 0.f));
+    CHECK(Store.GetFlags()[Store.GetDenseIndex(Third)] != RenderProxyFlag_None);
+    CheckProxy(Store, Third, Meshes[2], 2u);
+    CheckProxy(Store, Second, Meshes[1], 1u);
+
+    // Handles that never came from the store.
+    CHECK(!Store.IsValid(FRenderProxyHandle{}));
+    CHECK(!Store.IsValid(FRenderProxyHandle{ .Slot = 7u, .Generation = 0u }));
+    CHECK(!Store.Remove(FRenderProxyHandle{}));
+
+    // Clearing invalidates every handle, and slots come back with new generations.
+    Store.Clear();
+    CHECK(Store.Num() == 0u);
+    CHECK(!Store.IsValid(Second));
+    CHECK(!Store.IsValid(Third));
+    const FRenderProxyHandle AfterClear = Store.Add(Meshes[0], 0u);
+    CHECK(AfterClear != Second && AfterClear != Third);
+    CheckProxy(Store, AfterClear, Meshes[0], 0u);
+}
+
+TEST(RenderProxy, SetTransformFollowsTheMovedProxy)
+{
+    const FFakeMeshes Meshes(3u);
+    FRenderProxyStore Store;
+    const FRenderProxyHandle First = Store.Add(Meshes[0], 0u);
+    Store.Add(Meshes[1], 1u);
+    const FRenderProxyHandle Last = Store.Add(Meshes[2], 2u);
+    CHECK(Store.Remove(First));
+
+    Store.SetTransform(Last, Dx::XMMatrixTranslation(10.f, 20.f, 30.f));
+    Store.SetFlags(Last, RenderProxyFlag_Visible);
+
+    const uint32_t DenseIndex = Store.GetDenseIndex(Last);
+    CHECK(DenseIndex == 0u);
+    CHECK(Store.GetWorldMatrices()[DenseIndex].m[3][0] == 10.f);
+    CHECK(Store.GetWorldMatrices()[DenseIndex].m[3][2] == 30.f);
+    CHECK(fabsf(Store.GetInverseWorldMatrices()[DenseIndex].m[3][1] + 20.f) < 1.e-4f);
+    CHECK(Store.GetWorldBounds()[DenseIndex].Min.y == 19.5f);
+    CHECK(Store.GetWorldBounds()[DenseIndex].Max.z == 30.5f);
+    CHECK(Store.GetFlags()[DenseIndex] == RenderProxyFlag_Visible);
+
+    // The other proxy is untouched.
+    CHECK(Store.GetWorldMatrices()[1].m[3][0] == 1.f);
+    CHECK(Store.GetFlags()[1] == (RenderProxyFlag_Visible | RenderProxyFlag_CastShadow | RenderProxyFlag_RaytracingGeometry));
+}
+
+TEST(RenderProxy, RandomAddRemoveKeepsHandlesResolving)
+{
+    constexpr uint32_t NumMeshes = 64u;
+    const FFakeMeshes Meshes(NumMeshes);
+    FRenderProxyStore Store;
+
+    // Mesh index of every live handle, and every handle ever removed.
+    std::vector<std::pair<FRenderProxyHandle, uint32_t>> Live;
+    std::vector<FRenderProxyHandle> Removed;
+
+    std::mt19937 Random(3u);
+    for (uint32_t Iteration = 0; Iteration < 5000u; Iteration++)
+    {
+        if (Live.empty() || (Live.size() < NumMeshes && Random() % 2u == 0u))
+        {
+            const uint32_t MeshIndex = static_cast<uint32_t>(Random() % NumMeshes);
+            Live.emplace_back(Store.Add(Meshes[MeshIndex], MeshIndex), MeshIndex);
+        }
+        else
+        {
+            const size_t Victim = Random() % Live.size();
+            CHECK(Store.Remove(Live[Victim].first));
+            Removed.push_back(Live[Victim].first);
+            Live[Victim] = Live.back();
+            Live.pop_back();
+        }
+
+        CHECK(Store.Num() == Live.size());
+        if (Iteration % 50u == 0u)
+        {
+            for (const auto& [Handle, MeshIndex] : Live)
+            {
+                CheckProxy(Store, Handle, Meshes[MeshIndex], MeshIndex);
+            }
+            for (const FRenderProxyHandle& Handle : Removed)
+            {
+                CHECK(!Store.IsValid(Handle));
+            }
+        }
+    }
+}
@@ -0,0 +1,169 @@
+#include "Test.h"
+#include "Core/JobSystem.h"
+#include "Renderer/RenderQueue.h"
+
+namespace
+{
+    // Large sorts split into chunks on GJobSystem, the guard keeps a failing check from leaking it into later tests.
+    struct FScopedJobSystem
+    {
+        explicit FScopedJobSystem(uint32_t NumWorkers) { CreateJobSystem(NumWorkers); }
+        ~FScopedJobSystem() { ReleaseJobSystem(); }
+    };
+
+    uint32_t GetPipeline(uint64_t Key) { return static_cast<uint32_t>(Key >> 60); }
+    uint32_t GetDepthBucket(uint64_t Key) { return static_cast<uint32_t>(Key >> 56) & 0xFu; }
+    uint32_t GetMaterial(uint64_t Key) { return static_cast<uint32_t>(Key >> 42) & ((1u << FRenderQueue::MATERIAL_BITS) - 1u); }
+    uint32_t GetGeometry(uint64_t Key) { return static_cast<uint32_t>(Key >> 28) & ((1u << FRenderQueue::GEOMETRY_BITS) - 1u); }
+
+    // Meshes are never touched before Submit, the instance index records where each draw was added.
+    FRenderQueue MakeQueue(const std::vector<uint64_t>& Keys)
+    {
+        FRenderQueue Queue;
+        for (uint32_t Index = 0; Index < Keys.size(); Index++)
+        {
+            Queue.Add(nullptr, Keys[Index], Index);
+        }
+        return Queue;
+    }
+
+    // Sorted by key, draws with equal keys in the order they were added.
+    bool IsStablySorted(const FRenderQueue& Queue)
+    {
+        return std::is_sorted(Queue.GetDrawCommands().begin(), Queue.GetDrawCommands().end(), [](const FDrawCommand& A, const FDrawCommand& B) {
+            return A.SortKey != B.SortKey ? A.SortKey < B.SortKey : A.InstanceIndex < B.InstanceIndex;
+        });
+    }
+
+    // Few distinct values per field so many keys collide, drawn from the full range of every field.
+    std::vector<uint64_t> MakeRandomKeys(uint32_t Count, uint32_t Seed)
+    {
+        std::mt19937 Random(Seed);
+        const float Depths[] = { 0.5f, 1.5f, 3.f, 17.f, 250.f, 1.0e5f };
+        std::vector<uint64_t> Keys(Count);
+        for (uint64_t& Key : Keys)
+        {
+            Key = FRenderQueue::MakeSortKey(static_cast<uint32_t>(Random() % 3u), static_cast<uint32_t>(Random() % 50u) * 300u,
+                static_cast<uint32_t>(Random() % 20u) * 800u, Depths[Random() % std::size(Depths)]);
+        }
+        return Keys;
+    }
+}
+
+TEST(RenderQueue, KeyPacksEveryField)
+{
+    const uint64_t Key = FRenderQueue::MakeSortKey(2u, 1234u, 5678u, 5.f);
+    CHECK(GetPipeline(Key) == 2u);
+    CHECK(GetDepthBucket(Key) == 2u);
+    CHECK(GetMaterial(Key) == 1234u);
+    CHECK(GetGeometry(Key) == 5678u);
+
+    // Fields wider than their bits keep their low bits and never spill into their neighbours.
+    const uint64_t Wrapped = FRenderQueue::MakeSortKey(0x13u, (1u << FRenderQueue::MATERIAL_BITS) + 7u, (1u << FRenderQueue::GEOMETRY_BITS) + 9u, 1.f);
+    CHECK(GetPipeline(Wrapped) == 3u);
+    CHECK(GetDepthBucket(Wrapped) == 0u);
+    CHECK(GetMaterial(Wrapped) == 7u);
+    CHECK(GetGeometry(Wrapped) == 9u);
+}
+
+TEST(RenderQueue, DepthBucketsDoubleWithDistance)
+{
+    const auto Bucket = [](float Depth) { return GetDepthBucket(FRenderQueue::MakeSortKey(0u, 0u, 0u, Depth)); };
+    CHECK(Bucket(-3.f) == 0u);
+    CHECK(Bucket(0.f) == 0u);
+    CHECK(Bucket(1.99f) == 0u);
+    CHECK(Bucket(2.f) == 1u);
+    CHECK(Bucket(3.99f) == 1u);
+    CHECK(Bucket(4.f) == 2u);
+    CHECK(Bucket(1000.f) == 9u);
+    // Everything past the last bucket shares it.
+    CHECK(Bucket(1.0e9f) == 15u);
+    CHECK(Bucket(1.0e30f) == 15u);
+}
+
+TEST(RenderQueue, KeyOrdersPipelineBucketMaterialGeometryDepth)
+{
+    // A nearer bucket goes first whatever its material, inside a bucket material batches over depth.
+    CHECK(FRenderQueue::MakeSortKey(0u, 9000u, 0u, 1.f) < FRenderQueue::MakeSortKey(0u, 1u, 0u, 3.f));
+    CHECK(FRenderQueue::MakeSortKey(0u, 1u, 0u, 7.f) < FRenderQueue::MakeSortKey(0u, 2u, 0u, 4.f));
+    CHECK(FRenderQueue::MakeSortKey(0u, 1u, 2u, 4.f) < FRenderQueue::MakeSortKey(0u, 1u, 3u, 4.f));
+    CHECK(FRenderQueue::MakeSortKey(0u, 1u, 2u, 4.f) < FRenderQueue::MakeSortKey(0u, 1u, 2u, 4.5f));
+    CHECK(FRenderQueue::MakeSortKey(0u, 9000u, 9000u, 1.0e9f) < FRenderQueue::MakeSortKey(1u, 0u, 0u, 0.f));
+
+    // Front to back inside a bucket, down to the 28 depth bits kept.
+    uint64_t Previous = 0u;
+    for (float Depth = 8.f; Depth < 16.f; Depth += 0.01f)
+    {
+        const uint64_t Key = FRenderQueue::MakeSortKey(0u, 5u, 5u, Depth);
+        CHECK(Key > Previous);
+        Previous = Key;
+    }
+}
+
+TEST(RenderQueue, SortIsStable)
+{
+    const std::vector<uint64_t> Keys = MakeRandomKeys(1000u, 1u);
+    FRenderQueue Queue = MakeQueue(Keys);
+    Queue.Sort();
+
+    CHECK(Queue.GetNumDraws() == Keys.size());
+    CHECK(IsStablySorted(Queue));
+}
+
+TEST(RenderQueue, ParallelSortIsStable)
+{
+    const FScopedJobSystem JobSystem(4u);
+
+    // Above the parallel threshold, with sizes that do not split evenly into chunks.
+    for (const uint32_t Count : { 4096u, 50001u })
+    {
+        const std::vector<uint64_t> Keys = MakeRandomKeys(Count, Count);
+        FRenderQueue Queue = MakeQueue(Keys);
+        Queue.Sort();
+
+        CHECK(Queue.GetNumDraws() == Count);
+        CHECK(IsStablySorted(Queue));
+
+        std::vector<uint64_t> Expected = Keys;
+        std::sort(Expected.begin(), Expected.end());
+        for (uint32_t Index = 0; Index < Count; Index++)
+        {
+            CHECK(Queue.GetDrawCommands()[Index].SortKey == Expected[Index]);
+        }
+    }
+}
+
+TEST(RenderQueue, SkipsPassesWhereEveryKeySharesADigit)
+{
+    // Only the lowest byte differs, the seven passes above it have one digit each.
+    std::vector<uint64_t> Keys;
+    for (uint32_t Index = 0; Index < 300u; Index++)
+    {
+        Keys.push_back(0xABCDEF0123456700ull | ((Index * 37u) & 0xFFu));
+    }
+    FRenderQueue Queue = MakeQueue(Keys);
+    Queue.Sort();
+    CHECK(Queue.GetStats().NumSortPassesSkipped == 7u);
+    CHECK(IsStablySorted(Queue));
+
+    // A single pipeline and bucket leave the top byte alone.
+    Queue = MakeQueue({ FRenderQueue::MakeSortKey(1u, 3u, 300u, 5.f), FRenderQueue::MakeSortKey(1u, 3u, 200u, 7.f), FRenderQueue::MakeSortKey(1u, 2u, 300u, 6.f) });
+    Queue.Sort();
+    CHECK(Queue.GetStats().NumSortPassesSkipped >= 1u);
+    CHECK(IsStablySorted(Queue));
+    CHECK(Queue.GetDrawCommands()[0].InstanceIndex == 2u);
+
+    // Identical keys skip every pass and keep their order.
+    Queue = MakeQueue(std::vector<uint64_t>(5000u, 42u));
+    {
+        const FScopedJobSystem JobSystem(4u);
+        Queue.Sort();
+    }
+    CHECK(Queue.GetStats().NumSortPassesSkipped == 8u);
+    CHECK(IsStablySorted(Queue));
+
+    // Reset clears the stats with the draws.
+    Queue.Reset();
+    CHECK(Queue.GetNumDraws() == 0u);
+    CHECK(Queue.GetStats().NumSortPassesSkipped == 0u);
+}
@@ -0,0 +1,407 @@
+#include "Test.h"
+#include "Graphics/ResourceStateTracker.h"
+
+#include <map>
+#include <numeric>
+
+namespace
+{
+    constexpr D3D12_RESOURCE_STATES SRV = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+    constexpr D3D12_RESOURCE_STATES CS = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+    constexpr D3D12_RESOURCE_STATES UAV = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+    constexpr D3D12_RESOURCE_STATES RT = D3D12_RESOURCE_STATE_RENDER_TARGET;
+    constexpr D3D12_RESOURCE_STATES COPY_DEST = D3D12_RESOURCE_STATE_COPY_DEST;
+
+    // The tracker only keys on the resource pointers, distinct addresses stand in for resources.
+    class FFakeResources
+    {
+    public:
+        explicit FFakeResources(size_t NumResources) : Storage(NumResources) {}
+
+        ID3D12Resource* operator[](size_t Index) { return reinterpret_cast<ID3D12Resource*>(&Storage[Index]); }
+
+    private:
+        std::vector<uint64_t> Storage;
+    };
+
+    // Records the barrier batches and the uses of subresources in the order a command list would.
+    class FMockCommandList
+    {
+    public:
+        struct FCommand
+        {
+            std::vector<D3D12_RESOURCE_BARRIER> Barriers;
+            // Used in State when there are no barriers.
+            ID3D12Resource* Resource = nullptr;
+            uint32_t Subresource{};
+            D3D12_RESOURCE_STATES State{};
+        };
+
+        void ResourceBarrier(UINT NumBarriers, const D3D12_RESOURCE_BARRIER* Barriers)
+        {
+            CHECK(NumBarriers > 0u);
+            NumCalls++;
+            Commands.push_back(FCommand{ .Barriers = std::vector<D3D12_RESOURCE_BARRIER>(Barriers, Barriers + NumBarriers) });
+        }
+
+        void Use(ID3D12Resource* Resource, uint32_t Subresource, D3D12_RESOURCE_STATES State)
+        {
+            Commands.push_back(FCommand{ .Resource = Resource, .Subresource = Subresource, .State = State });
+        }
+
+        std::vector<FCommand> Commands;
+        uint32_t NumCalls = 0u;
+    };
+
+    // State of every subresource as the GPU sees it, fails on any barrier or use that would be invalid.
+    class FSimulatedGPU
+    {
+    public:
+        void Register(ID3D12Resource* Resource, uint32_t NumSubresources, D3D12_RESOURCE_STATES State)
+        {
+            SubresourceCounts[Resource] = NumSubresources;
+            for (uint32_t Subresource = 0; Subresource < NumSubresources; Subresource++)
+            {
+                States[{ Resource, Subresource }] = State;
+            }
+        }
+
+        D3D12_RESOURCE_STATES GetState(ID3D12Resource* Resource, uint32_t Subresource) const
+        {
+            return States.at({ Resource, Subresource });
+        }
+
+        void Apply(const D3D12_RESOURCE_BARRIER& Barrier)
+        {
+            if (Barrier.Type != D3D12_RESOURCE_BARRIER_TYPE_TRANSITION)
+            {
+                return;
+            }
+
+            const D3D12_RESOURCE_TRANSITION_BARRIER& Transition = Barrier.Transition;
+            CHECK(Transition.StateBefore != Transition.StateAfter);
+
+            const bool bAll = Transition.Subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+            const uint32_t First = bAll ? 0u : Transition.Subresource;
+            const uint32_t End = bAll ? SubresourceCounts.at(Transition.pResource) : Transition.Subresource + 1u;
+            for (uint32_t Subresource = First; Subresource < End; Subresource++)
+            {
+                const FKey Key{ Transition.pResource, Subresource };
+                if (Barrier.Flags == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY)
+                {
+                    const auto InFlight = SplitsInFlight.find(Key);
+                    CHECK(InFlight != SplitsInFlight.end());
+                    CHECK(InFlight->second == std::make_pair(Transition.StateBefore, Transition.StateAfter));
+                    SplitsInFlight.erase(InFlight);
+                    States[Key] = Transition.StateAfter;
+                    continue;
+                }
+
+                CHECK(!SplitsInFlight.contains(Key));
+                CHECK(States.at(Key) == Transition.StateBefore);
+                if (Barrier.Flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
+                {
+                    SplitsInFlight[Key] = { Transition.StateBefore, Transition.StateAfter };
+                }
+                else
+                {
+                    States[Key] = Transition.StateAfter;
+                }
+            }
+        }
+
+        void Execute(const FMockCommandList& CommandList)
+        {
+            for (const FMockCommandList::FCommand& Command : CommandList.Commands)
+            {
+                for (const D3D12_RESOURCE_BARRIER& Barrier : Command.Barriers)
+                {
+                    Apply(Barrier);
+                }
+                if (Command.Barriers.empty())
+                {
+                    const FKey Key{ Command.Resource, Command.Subresource };
+                    CHECK(!SplitsInFlight.contains(Key));
+                    CHECK(States.at(Key) == Command.State);
+                }
+            }
+            CHECK(SplitsInFlight.empty());
+        }
+
+    private:
+        using FKey = std::pair<ID3D12Resource*, uint32_t>;
+
+        std::map<FKey, D3D12_RESOURCE_STATES> States;
+        std::map<ID3D12Resource*, uint32_t> SubresourceCounts;
+        std::map<FKey, std::pair<D3D12_RESOURCE_STATES, D3D12_RESOURCE_STATES>> SplitsInFlight;
+    };
+}
+
+TEST(ResourceStateTracker, RedundantTransitionsAreDropped)
+{
+    FFakeResources Resources(1u);
+    FResourceStateTracker Tracker;
+
+    Tracker.Transition(Resources[0], 1u, SRV, SRV);
+    CHECK(Tracker.GetBarriers().empty());
+
+    // Two transitions of one subresource within a batch merge into one.
+    Tracker.Transition(Resources[0], 1u, SRV, UAV);
+    Tracker.Transition(Resources[0], 1u, SRV, RT);
+    CHECK(Tracker.GetBarriers().size() == 1u);
+    CHECK(Tracker.GetBarriers()[0].Transition.StateBefore == SRV);
+    CHECK(Tracker.GetBarriers()[0].Transition.StateAfter == RT);
+
+    // Going back to where the batch started cancels the transition out.
+    Tracker.Transition(Resources[0], 1u, SRV, SRV);
+    CHECK(Tracker.GetBarriers().empty());
+    CHECK(Tracker.GetState(Resources[0]) == SRV);
+}
+
+TEST(ResourceStateTracker, UAVBarrierKeepsTransitionsApart)
+{
+    FFakeResources Resources(1u);
+    FResourceStateTracker Tracker;
+
+    Tracker.Transition(Resources[0], 1u, SRV, UAV);
+    Tracker.UAVBarrier(Resources[0]);
+    Tracker.Transition(Resources[0], 1u, SRV, SRV);
+    CHECK(Tracker.GetBarriers().size() == 3u);
+
+    FMockCommandList CommandList;
+    Tracker.Flush(CommandList);
+    CHECK(CommandList.NumCalls == 1u);
+    CHECK(CommandList.Commands[0].Barriers.size() == 3u);
+    CHECK(Tracker.GetBarriers().empty());
+}
+
+TEST(ResourceStateTracker, SubresourcesAreTrackedApart)
+{
+    FFakeResources Resources(1u);
+    FResourceStateTracker Tracker;
+
+    Tracker.Transition(Resources[0], 3u, SRV, UAV, 1u);
+    CHECK(Tracker.GetBarriers().size() == 1u);
+    CHECK(Tracker.GetBarriers()[0].Transition.Subresource == 1u);
+    CHECK(Tracker.GetState(Resources[0]) == RESOURCE_STATE_UNKNOWN);
+
+    // The subresource that moved merges, the other two get a barrier each.
+    Tracker.Transition(Resources[0], 3u, SRV, RT);
+    CHECK(Tracker.GetBarriers().size() == 3u);
+    CHECK(Tracker.GetState(Resources[0]) == RT);
+}
+
+TEST(ResourceStateTracker, SubmissionFixesStaleExpectations)
+{
+    FFakeResources Resources(2u);
+    FResourceStateTable Table;
+    Table.Register(Resources[0], 1u, SRV);
+    Table.Register(Resources[1], 3u, RT);
+
+    FResourceStateTracker Tracker;
+    FMockCommandList CommandList;
+    std::vector<D3D12_RESOURCE_BARRIER> Pending;
+
+    // The list expects RT, the table knows better.
+    Tracker.Transition(Resources[0], 1u, RT, CS);
+    Tracker.Flush(CommandList);
+    Tracker.ResolvePendingBarriers(Table, Pending);
+    CHECK(Pending.size() == 1u);
+    CHECK(Pending[0].Transition.StateBefore == SRV);
+    CHECK(Pending[0].Transition.StateAfter == RT);
+    CHECK(Table.GetState(Resources[0]) == CS);
+
+    // Unknown expectation : the first transition is left to submission, the second one is recorded in place.
+    Pending.clear();
+    Tracker.Transition(Resources[1], 3u, RESOURCE_STATE_UNKNOWN, UAV, 2u);
+    Tracker.Transition(Resources[1], 3u, RESOURCE_STATE_UNKNOWN, CS, 2u);
+    CHECK(Tracker.GetBarriers().size() == 1u);
+    CHECK(Tracker.GetBarriers()[0].Transition.StateBefore == UAV);
+    Tracker.Flush(CommandList);
+    Tracker.ResolvePendingBarriers(Table, Pending);
+    CHECK(Pending.size() == 1u);
+    CHECK(Pending[0].Transition.Subresource == 2u);
+    CHECK(Pending[0].Transition.StateBefore == RT);
+    CHECK(Pending[0].Transition.StateAfter == UAV);
+
+    CHECK(Table.GetState(Resources[1]) == RESOURCE_STATE_UNKNOWN);
+    CHECK(Table.GetState(Resources[1], 0u) == RT);
+    CHECK(Table.GetState(Resources[1], 2u) == CS);
+}
+
+TEST(ResourceStateTracker, SplitTransitionEndsWhereItBegan)
+{
+    FFakeResources Resources(2u);
+    FResourceStateTable Table;
+    Table.Register(Resources[0], 1u, CS);
+    Table.Register(Resources[1], 1u, RT);
+
+    FResourceStateTracker Tracker;
+    Tracker.BeginTransition(Resources[0], 1u, CS, UAV);
+    Tracker.Transition(Resources[1], 1u, RT, SRV);
+    Tracker.EndTransition(Resources[0]);
+
+    const std::span<const D3D12_RESOURCE_BARRIER> Barriers = Tracker.GetBarriers();
+    CHECK(Barriers.size() == 3u);
+    CHECK(Barriers[0].Flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY);
+    CHECK(Barriers[2].Flags == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY);
+
+    FMockCommandList CommandList;
+    Tracker.Flush(CommandList);
+    std::vector<D3D12_RESOURCE_BARRIER> Pending;
+    Tracker.ResolvePendingBarriers(Table, Pending);
+    CHECK(Pending.empty());
+    CHECK(Table.GetState(Resources[0]) == UAV);
+    CHECK(Table.GetState(Resources[1]) == SRV);
+}
+
+TEST(ResourceStateTracker, UnregisteredResourcesAreLeftOut)
+{
+    FFakeResources Resources(1u);
+    FResourceStateTable Table;
+    Table.Register(Resources[0], 1u, SRV);
+    Table.Unregister(Resources[0]);
+
+    FResourceStateTracker Tracker;
+    FMockCommandList CommandList;
+    Tracker.Transition(Resources[0], 1u, RT, SRV);
+    Tracker.Flush(CommandList);
+
+    std::vector<D3D12_RESOURCE_BARRIER> Pending;
+    Tracker.ResolvePendingBarriers(Table, Pending);
+    CHECK(Pending.empty());
+    CHECK(Table.GetState(Resources[0]) == RESOURCE_STATE_UNKNOWN);
+}
+
+TEST(ResourceStateTracker, ListsSubmittedOutOfOrderMatchTheGPU)
+{
+    // Lists are recorded one after another, with expectations right, stale or unknown, and submitted in a shuffled
+    // order. After each submission the table has to agree with what the GPU went through.
+    constexpr D3D12_RESOURCE_STATES States[] = { SRV, UAV, RT, CS, COPY_DEST };
+    std::mt19937 Random(7u);
+    const auto RandomState = [&Random, &States]() { return States[Random() % std::size(States)]; };
+
+    for (uint32_t Iteration = 0; Iteration < 1000u; Iteration++)
+    {
+        const uint32_t NumResources = 1u + static_cast<uint32_t>(Random() % 5u);
+        FFakeResources Resources(NumResources);
+        std::vector<uint32_t> NumSubresources(NumResources);
+        FResourceStateTable Table;
+        FSimulatedGPU GPU;
+        // What the recording code believes each resource is in, deliberately stale at times.
+        std::vector<D3D12_RESOURCE_STATES> Believed(NumResources);
+        for (uint32_t Index = 0; Index < NumResources; Index++)
+        {
+            NumSubresources[Index] = 1u + static_cast<uint32_t>(Random() % 4u);
+            Believed[Index] = RandomState();
+            Table.Register(Resources[Index], NumSubresources[Index], Believed[Index]);
+            GPU.Register(Resources[Index], NumSubresources[Index], Believed[Index]);
+        }
+
+        const uint32_t NumLists = 1u + static_cast<uint32_t>(Random() % 4u);
+        std::vector<FResourceStateTracker> Trackers(NumLists);
+        std::vector<FMockCommandList> CommandLists(NumLists);
+        for (uint32_t List = 0; List < NumLists; List++)
+        {
+            FResourceStateTracker& Tracker = Trackers[List];
+            FMockCommandList& CommandList = CommandLists[List];
+            std::vector<std::pair<uint32_t, uint32_t>> OpenSplits;
+            std::vector<bool> Touched(NumResources);
+
+            const uint32_t NumOps = static_cast<uint32_t>(Random() % 30u);
+            for (uint32_t Op = 0; Op < NumOps; Op++)
+            {
+                const uint32_t Index = static_cast<uint32_t>(Random() % NumResources);
+                const D3D12_RESOURCE_STATES StateAfter = RandomState();
+                const uint32_t Kind = static_cast<uint32_t>(Random() % 10u);
+                if (Kind == 0u)
+                {
+                    Tracker.Flush(CommandList);
+                    continue;
+                }
+                if (Kind == 1u && !OpenSplits.empty())
+                {
+                    Tracker.EndTransition(Resources[OpenSplits.back().first], OpenSplits.back().second);
+                    OpenSplits.pop_back();
+                    continue;
+                }
+                if (std::any_of(OpenSplits.begin(), OpenSplits.end(), [Index](const auto& Split) { return Split.first == Index; }))
+                {
+                    continue;
+                }
+
+                D3D12_RESOURCE_STATES StateBefore = Believed[Index];
+                if (!Touched[Index])
+                {
+                    const uint32_t Expectation = static_cast<uint32_t>(Random() % 4u);
+                    StateBefore = Expectation == 0u ? RESOURCE_STATE_UNKNOWN : Expectation == 1u ? RandomState() : StateBefore;
+                }
+                const uint32_t Subresource = (NumSubresources[Index] > 1u && Random() % 2u) ?
+                    static_cast<uint32_t>(Random() % NumSubresources[Index]) : D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+                if (StateBefore != RESOURCE_STATE_UNKNOWN || Subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES)
+                {
+                    Touched[Index] = true;
+                }
+
+                if (Kind == 2u)
+                {
+                    Tracker.BeginTransition(Resources[Index], NumSubresources[Index], StateBefore, StateAfter, Subresource);
+                    const std::span<const D3D12_RESOURCE_BARRIER> Barriers = Tracker.GetBarriers();
+                    if (!Barriers.empty() && Barriers.back().Flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
+                    {
+                        OpenSplits.emplace_back(Index, Subresource);
+                    }
+                    else
+                    {
+                        Tracker.EndTransition(Resources[Index], Subresource);
+                    }
+                }
+                else
+                {
+                    Tracker.Transition(Resources[Index], NumSubresources[Index], StateBefore, StateAfter, Subresource);
+                    if (Random() % 2u)
+                    {
+                        Tracker.Flush(CommandList);
+                        const uint32_t Used = Subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES ?
+                            static_cast<uint32_t>(Random() % NumSubresources[Index]) : Subresource;
+                        CommandList.Use(Resources[Index], Used, StateAfter);
+                    }
+                }
+
+                Believed[Index] = Tracker.GetState(Resources[Index]);
+                if (Believed[Index] == RESOURCE_STATE_UNKNOWN)
+                {
+                    Believed[Index] = States[0];
+                }
+            }
+
+            for (; !OpenSplits.empty(); OpenSplits.pop_back())
+            {
+                Tracker.EndTransition(Resources[OpenSplits.back().first], OpenSplits.back().second);
+            }
+            Tracker.Flush(CommandList);
+        }
+
+        std::vector<uint32_t> SubmitOrder(NumLists);
+        std::iota(SubmitOrder.begin(), SubmitOrder.end(), 0u);
+        std::shuffle(SubmitOrder.begin(), SubmitOrder.end(), Random);
+        for (const uint32_t List : SubmitOrder)
+        {
+            std::vector<D3D12_RESOURCE_BARRIER> Pending;
+            Trackers[List].ResolvePendingBarriers(Table, Pending);
+            for (const D3D12_RESOURCE_BARRIER& Barrier : Pending)
+            {
+                GPU.Apply(Barrier);
+            }
+            GPU.Execute(CommandLists[List]);
+
+            for (uint32_t Index = 0; Index < NumResources; Index++)
+            {
+                for (uint32_t Subresource = 0; Subresource < NumSubresources[Index]; Subresource++)
+                {
+                    CHECK(Table.GetState(Resources[Index], Subresource) == GPU.GetState(Resources[Index], Subresource));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,277 @@
+#include "Test.h"
+#include "Graphics/ShaderCache.h"
+
+#include <fstream>
+
+namespace
+{
+    // Fresh directory per test with the shader sources and the cache side by side.
+    class FShaderCacheFixture
+    {
+    public:
+        explicit FShaderCacheFixture(const char* Name)
+            : Root(std::filesystem::temp_directory_path() / std::format("CubiEngineTests.ShaderCache.{}", Name))
+        {
+            std::filesystem::remove_all(Root);
+            std::filesystem::create_directories(Root / "Shaders");
+        }
+
+        ~FShaderCacheFixture()
+        {
+            std::error_code Error;
+            std::filesystem::remove_all(Root, Error);
+        }
+
+        std::wstring WriteShader(const std::string& Name, const std::string& Contents) const
+        {
+            const std::filesystem::path Path = Root / "Shaders" / Name;
+            std::ofstream(Path, std::ios::binary | std::ios::trunc) << Contents;
+            return Path.wstring();
+        }
+
+        std::filesystem::path GetCacheDirectory() const { return Root / "Cache"; }
+
+        FShaderCacheKey MakeKey(const std::wstring& SourcePath) const
+        {
+            return FShaderCacheKey{
+                .SourcePath = SourcePath,
+                .EntryPoint = L"PsMain",
+                .TargetProfile = L"ps_6_6",
+                .Arguments = { L"-DUSE_SHADOWS=1" },
+                .CompilerVersion = 1u,
+            };
+        }
+
+    private:
+        std::filesystem::path Root;
+    };
+
+    // Stands in for DXC: follows #include "..." lines next to the including file and outputs the source with
+    // every include pasted in, so a changed include changes the object.
+    class FStubCompiler
+    {
+    public:
+        bool operator()(const FShaderCacheKey& Key, FShaderCompileOutput& Output)
+        {
+            NumCompiles++;
+            std::string Object;
+            if (!Preprocess(std::filesystem::path(Key.SourcePath), Object, Output.Dependencies))
+            {
+                return false;
+            }
+
+            Output.Object.assign(Object.begin(), Object.end());
+            Output.RootSignature = { 0xAAu, static_cast<uint8_t>(Key.EntryPoint.size()) };
+            return true;
+        }
+
+        std::atomic<uint32_t> NumCompiles = 0u;
+
+    private:
+        static bool Preprocess(const std::filesystem::path& Path, std::string& Object, std::vector<std::wstring>& Dependencies)
+        {
+            std::ifstream File(Path, std::ios::binary);
+            if (!File)
+            {
+                return false;
+            }
+            Dependencies.push_back(Path.wstring());
+
+            constexpr std::string_view IncludeDirective = "#include \"";
+            std::string Line;
+            while (std::getline(File, Line))
+            {
+                if (Line.starts_with(IncludeDirective))
+                {
+                    const std::string Name = Line.substr(IncludeDirective.size(), Line.find('"', IncludeDirective.size()) - IncludeDirective.size());
+                    if (!Preprocess(Path.parent_path() / Name, Object, Dependencies))
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    Object += Line;
+                    Object += '\n';
+                }
+            }
+            return true;
+        }
+    };
+
+    std::string ToString(const std::vector<uint8_t>& Bytes)
+    {
+        return std::string(Bytes.begin(), Bytes.end());
+    }
+}
+
+TEST(ShaderCache, SecondSessionHitsWithoutCompiling)
+{
+    FShaderCacheFixture Fixture("Hit");
+    Fixture.WriteShader("Common.hlsli", "float Common;\n");
+    const std::wstring Source = Fixture.WriteShader("Lighting.hlsl", "#include \"Common.hlsli\"\nfloat4 PsMain();\n");
+
+    FStubCompiler Compiler;
+    FShaderCompileOutput First;
+    {
+        FShaderCache Cache(Fixture.GetCacheDirectory());
+        CHECK(Cache.GetOrCompile(Fixture.MakeKey(Source), std::ref(Compiler), First));
+        CHECK(Cache.GetStats().NumMisses == 1u);
+    }
+    CHECK(Compiler.NumCompiles == 1u);
+    CHECK(ToString(First.Object) == "float Common;\nfloat4 PsMain();\n");
+
+    FShaderCache Cache(Fixture.GetCacheDirectory());
+    FShaderCompileOutput Second;
+    CHECK(Cache.GetOrCompile(Fixture.MakeKey(Source), std::ref(Compiler), Second));
+    CHECK(Compiler.NumCompiles == 1u);
+    CHECK(Cache.GetStats().NumHits == 1u);
+    CHECK(Second.Object == First.Object);
+    CHECK(Second.RootSignature == First.RootSignature);
+    // The recorded closure comes back with the hit.
+    CHECK(Second.Dependencies.size() == 2u);
+}
+
+TEST(ShaderCache, ChangedTransitiveIncludeInvalidates)
+{
+    FShaderCacheFixture Fixture("TransitiveInclude");
+    Fixture.WriteShader("Constants.hlsli", "static const float PI = 3.14;\n");
+    Fixture.WriteShader("Common.hlsli", "#include \"Constants.hlsli\"\n");
+    const std::wstring Source = Fixture.WriteShader("Lighting.hlsl", "#include \"Common.hlsli\"\nfloat4 PsMain();\n");
+
+    FStubCompiler Compiler;
+    FShaderCompileOutput Output;
+    {
+        FShaderCache Cache(Fixture.GetCacheDirectory());
+        CHECK(Cache.GetOrCompile(Fixture.MakeKey(Source), std::ref(Compiler), Output));
+    }
+
+    // Only reachable through Common.hlsli, the source itself is untouched.
+    Fixture.WriteShader("Constants.hlsli", "static const float PI = 3.14159;\n");
+
+    FShaderCache Cache(Fixture.GetCacheDirectory());
+    CHECK(!Cache.Lookup(Fixture.MakeKey(Source), Output));
+    CHECK(Cache.GetStats().NumInvalidated == 1u);
+
+    CHECK(Cache.GetOrCompile(Fixture.MakeKey(Source), std::ref(Compiler), Output));
+    CHECK(Compiler.NumCompiles == 2u);
+    CHECK(ToString(Output.Object) == "static const float PI = 3.14159;\nfloat4 PsMain();\n");
+
+    // The new entry is what the key resolves to from now on.
+    FShaderCompileOutput Cached;
+    CHECK(Cache.Lookup(Fixture.MakeKey(Source), Cached));
+    CHECK(Cached.Object == Output.Object);
+}
+
+TEST(ShaderCache, DeletedIncludeInvalidates)
+{
+    FShaderCacheFixture Fixture("DeletedInclude");
+    const std::wstring Include = Fixture.WriteShader("Common.hlsli", "float Common;\n");
+    const std::wstring Source = Fixture.WriteShader("Lighting.hlsl", "#include \"Common.hlsli\"\n");
+
+    FStubCompiler Compiler;
+    FShaderCompileOutput Output;
+    {
+        FShaderCache Cache(Fixture.GetCacheDirectory());
+        CHECK(Cache.GetOrCompile(Fixture.MakeKey(Source), std::ref(Compiler), Output));
+    }
+
+    std::filesystem::remove(Include);
+
+    FShaderCache Cache(Fixture.GetCacheDirectory());
+    CHECK(!Cache.Lookup(Fixture.MakeKey(Source), Output));
+    CHECK(Cache.GetStats().NumInvalidated == 1u);
+    // The stub fails like DXC would on a missing include, and nothing gets cached.
+    CHECK(!Cache.GetOrCompile(Fixture.MakeKey(Source), std::ref(Compiler), Output));
+    CHECK(!Cache.Lookup(Fixture.MakeKey(Source), Output));
+}
+
+TEST(ShaderCache, EveryKeyFieldChangesTheHash)
+{
+    const FShaderCacheKey Key{
+        .SourcePath = L"Shaders/Lighting.hlsl",
+        .EntryPoint = L"PsMain",
+        .TargetProfile = L"ps_6_6",
+        .Arguments = { L"-DA=1", L"-O3" },
+        .CompilerVersion = 7u,
+    };
+    const uint64_t Hash = FShaderCache::HashKey(Key);
+
+    FShaderCacheKey Changed = Key;
+    Changed.SourcePath = L"Shaders/Shadow.hlsl";
+    CHECK(FShaderCache::HashKey(Changed) != Hash);
+    Changed = Key;
+    Changed.EntryPoint = L"CsMain";
+    CHECK(FShaderCache::HashKey(Changed) != Hash);
+    Changed = Key;
+    Changed.TargetProfile = L"ps_6_5";
+    CHECK(FShaderCache::HashKey(Changed) != Hash);
+    Changed = Key;
+    Changed.Arguments[0] = L"-DA=2";
+    CHECK(FShaderCache::HashKey(Changed) != Hash);
+    Changed = Key;
+    Changed.CompilerVersion = 8u;
+    CHECK(FShaderCache::HashKey(Changed) != Hash);
+
+    // Argument boundaries are part of the key.
+    Changed = Key;
+    Changed.Arguments = { L"-DA=1-O3" };
+    CHECK(FShaderCache::HashKey(Changed) != Hash);
+
+    // Equivalent spellings of the source path share an entry.
+    Changed = Key;
+    Changed.SourcePath = L"Shaders/./Lighting.hlsl";
+    CHECK(FShaderCache::HashKey(Changed) == Hash);
+}
+
+TEST(ShaderCache, FailedCompileIsNotCached)
+{
+    FShaderCacheFixture Fixture("FailedCompile");
+    const std::wstring Source = Fixture.WriteShader("Broken.hlsl", "#include \"Missing.hlsli\"\n");
+
+    FStubCompiler Compiler;
+    FShaderCache Cache(Fixture.GetCacheDirectory());
+    FShaderCompileOutput Output;
+    CHECK(!Cache.GetOrCompile(Fixture.MakeKey(Source), std::ref(Compiler), Output));
+
+    Fixture.WriteShader("Missing.hlsli", "float Fixed;\n");
+    CHECK(Cache.GetOrCompile(Fixture.MakeKey(Source), std::ref(Compiler), Output));
+    CHECK(Compiler.NumCompiles == 2u);
+    CHECK(ToString(Output.Object) == "float Fixed;\n");
+}
+
+TEST(ShaderCache, ConcurrentCompilesOfOneKeyAgree)
+{
+    FShaderCacheFixture Fixture("Concurrent");
+    Fixture.WriteShader("Common.hlsli", "float Common;\n");
+    const std::wstring Source = Fixture.WriteShader("Lighting.hlsl", "#include \"Common.hlsli\"\nfloat4 PsMain();\n");
+
+    FStubCompiler Compiler;
+    FShaderCache Cache(Fixture.GetCacheDirectory());
+
+    constexpr uint32_t NumThreads = 8u;
+    std::vector<FShaderCompileOutput> Outputs(NumThreads);
+    std::vector<uint8_t> Succeeded(NumThreads, 0u);
+    {
+        std::vector<std::jthread> Threads;
+        for (uint32_t i = 0; i < NumThreads; i++)
+        {
+            Threads.emplace_back([&, i]()
+            {
+                Succeeded[i] = Cache.GetOrCompile(Fixture.MakeKey(Source), std::ref(Compiler), Outputs[i]);
+            });
+        }
+    }
+
+    for (uint32_t i = 0; i < NumThreads; i++)
+    {
+        CHECK(Succeeded[i]);
+        CHECK(Outputs[i].Object == Outputs[0].Object);
+    }
+
+    // Whatever interleaving the stores had, the entry on disk is complete.
+    FShaderCache Reloaded(Fixture.GetCacheDirectory());
+    FShaderCompileOutput Cached;
+    CHECK(Reloaded.Lookup(Fixture.MakeKey(Source), Cached));
+    CHECK(Cached.Object == Outputs[0].Object);
+}
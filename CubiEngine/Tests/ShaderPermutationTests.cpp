@@ -0,0 +1,82 @@
+#include "Test.h"
+#include "Graphics/ShaderPermutation.h"
+
+namespace
+{
+    // Same dimensions FDeferredGPass declares for the light pass.
+    FShaderPermutationDomain MakeLightPassDomain()
+    {
+        FShaderPermutationDomain Domain;
+        Domain.AddEnum(L"SHADOW_METHOD", 3u);
+        Domain.AddBool(L"USE_SSAO");
+        Domain.AddEnum(L"DIFFUSE_METHOD", 2u);
+        return Domain;
+    }
+}
+
+TEST(ShaderPermutation, KeysRoundTripEveryCombination)
+{
+    FShaderPermutationDomain Domain = MakeLightPassDomain();
+    Domain.AddIntRange(L"NUM_CASCADES", -1, 4);
+    CHECK(Domain.GetNumDimensions() == 4u);
+    CHECK(Domain.GetNumPermutations() == 3u * 2u * 2u * 6u);
+
+    std::vector<uint8_t> Seen(Domain.GetNumPermutations(), 0u);
+    for (int32_t Shadow = 0; Shadow < 3; Shadow++)
+    {
+        for (int32_t SSAO = 0; SSAO < 2; SSAO++)
+        {
+            for (int32_t Diffuse = 0; Diffuse < 2; Diffuse++)
+            {
+                for (int32_t Cascades = -1; Cascades <= 4; Cascades++)
+                {
+                    const int32_t Values[] = { Shadow, SSAO, Diffuse, Cascades };
+                    const uint32_t Key = Domain.GetKey(Values);
+                    CHECK(Key < Domain.GetNumPermutations());
+                    CHECK(!Seen[Key]);
+                    Seen[Key] = 1u;
+                    CHECK(Domain.GetValues(Key) == std::vector<int32_t>(std::begin(Values), std::end(Values)));
+                }
+            }
+        }
+    }
+}
+
+TEST(ShaderPermutation, DefinesFollowDimensionOrder)
+{
+    const FShaderPermutationDomain Domain = MakeLightPassDomain();
+    const int32_t Values[] = { 2, 1, 0 };
+
+    const std::vector<std::wstring> Defines = Domain.GetDefines(Domain.GetKey(Values));
+    CHECK(Defines.size() == 3u);
+    CHECK(Defines[0] == L"SHADOW_METHOD=2");
+    CHECK(Defines[1] == L"USE_SSAO=1");
+    CHECK(Defines[2] == L"DIFFUSE_METHOD=0");
+}
+
+TEST(ShaderPermutation, FilterPrunesCombinations)
+{
+    FShaderPermutationDomain Domain = MakeLightPassDomain();
+    // E.g. a device without raytracing never needs the raytraced shadow variants.
+    Domain.SetFilter([](std::span<const int32_t> Values) { return Values[0] != 2; });
+
+    const std::vector<uint32_t> ValidKeys = Domain.GetValidKeys();
+    CHECK(ValidKeys.size() == 2u * 2u * 2u);
+    for (const uint32_t Key : ValidKeys)
+    {
+        CHECK(Domain.GetValue(Key, 0u) != 2);
+    }
+
+    const int32_t Pruned[] = { 2, 0, 1 };
+    CHECK(!Domain.IsValid(Domain.GetKey(Pruned)));
+    CHECK(!Domain.IsValid(Domain.GetNumPermutations()));
+}
+
+TEST(ShaderPermutation, EmptyDomainHasOnePermutation)
+{
+    const FShaderPermutationDomain Domain;
+    CHECK(Domain.GetNumPermutations() == 1u);
+    CHECK(Domain.GetKey({}) == 0u);
+    CHECK(Domain.GetDefines(0u).empty());
+    CHECK(Domain.GetValidKeys() == std::vector<uint32_t>{ 0u });
+}
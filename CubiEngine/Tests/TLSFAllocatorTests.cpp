@@ -0,0 +1,276 @@
+#include "Test.h"
+#include "Graphics/TLSFAllocator.h"
+
+#include <map>
+#include <random>
+
+namespace
+{
+    // Live allocations of the allocator under test, keyed by node.
+    using FLiveMap = std::map<uint32_t, FTLSFAllocator::FAllocation>;
+
+    // No two live allocations overlap, every one lies inside the range and the used size adds up.
+    bool IsConsistent(const FTLSFAllocator& Allocator, const FLiveMap& Live)
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> Ranges;
+        uint32_t UsedSize = 0u;
+        for (const auto& [Node, Allocation] : Live)
+        {
+            if (Allocator.GetOffset(Node) != Allocation.Offset || Allocation.Offset + Allocation.Size > Allocator.GetCapacity())
+            {
+                return false;
+            }
+            Ranges.emplace_back(Allocation.Offset, Allocation.Offset + Allocation.Size);
+            UsedSize += Allocation.Size;
+        }
+
+        std::sort(Ranges.begin(), Ranges.end());
+        for (size_t i = 1; i < Ranges.size(); i++)
+        {
+            if (Ranges[i - 1].second > Ranges[i].first)
+            {
+                return false;
+            }
+        }
+        return UsedSize == Allocator.GetUsedSize() && Live.size() == Allocator.GetNumAllocations();
+    }
+}
+
+TEST(TLSFAllocator, FreeMergesWithBothNeighbours)
+{
+    FTLSFAllocator Allocator(1024u);
+    const auto A = Allocator.Allocate(100u);
+    const auto B = Allocator.Allocate(200u);
+    const auto C = Allocator.Allocate(300u);
+    CHECK(A && B && C);
+    CHECK(A->Offset == 0u && B->Offset == 100u && C->Offset == 300u);
+    CHECK(Allocator.GetUsedSize() == 600u);
+    CHECK(Allocator.GetLargestFreeBlock() == 424u);
+
+    Allocator.Free(A->Node);
+    Allocator.Free(C->Node);
+    // [0, 100) and [300, 1024) are apart.
+    CHECK(Allocator.GetLargestFreeBlock() == 724u);
+    CHECK(Allocator.GetFragmentation() > 0.f);
+
+    Allocator.Free(B->Node);
+    CHECK(Allocator.GetNumAllocations() == 0u);
+    CHECK(Allocator.GetLargestFreeBlock() == 1024u);
+    CHECK(Allocator.GetFragmentation() == 0.f);
+    CHECK(Allocator.Allocate(1024u)->Offset == 0u);
+}
+
+TEST(TLSFAllocator, FailsWhenNoBlockIsLargeEnough)
+{
+    FTLSFAllocator Allocator(256u);
+    const auto A = Allocator.Allocate(128u);
+    const auto B = Allocator.Allocate(128u);
+    CHECK(A && B);
+    CHECK(!Allocator.Allocate(1u).has_value());
+    CHECK(Allocator.GetFragmentation() == 0.f);
+
+    Allocator.Free(A->Node);
+    CHECK(!Allocator.Allocate(129u).has_value());
+    CHECK(Allocator.Allocate(128u)->Offset == 0u);
+}
+
+TEST(TLSFAllocator, GrowAppendsAndMergesWithTailBlock)
+{
+    FTLSFAllocator Allocator(100u);
+    const auto A = Allocator.Allocate(60u);
+    CHECK(A.has_value());
+    CHECK(!Allocator.Allocate(50u).has_value());
+
+    Allocator.Grow(200u);
+    CHECK(Allocator.GetCapacity() == 200u);
+    // The 40 free units before the grow and the new 100 are one block.
+    CHECK(Allocator.GetLargestFreeBlock() == 140u);
+    const auto B = Allocator.Allocate(140u);
+    CHECK(B && B->Offset == 60u);
+}
+
+TEST(TLSFAllocator, CompactPacksToFrontAndKeepsNodes)
+{
+    FTLSFAllocator Allocator(1000u);
+    std::vector<FTLSFAllocator::FAllocation> Allocations;
+    for (uint32_t i = 0; i < 10u; i++)
+    {
+        Allocations.push_back(*Allocator.Allocate(50u + i));
+    }
+    // Free every other one, leaving holes.
+    for (uint32_t i = 0; i < 10u; i += 2u)
+    {
+        Allocator.Free(Allocations[i].Node);
+    }
+    CHECK(Allocator.GetFragmentation() > 0.f);
+
+    const std::vector<FTLSFAllocator::FMove> Moves = Allocator.Compact();
+    CHECK(Allocator.GetFragmentation() == 0.f);
+    CHECK(Allocator.GetLargestFreeBlock() == Allocator.GetCapacity() - Allocator.GetUsedSize());
+
+    uint32_t ExpectedOffset = 0u;
+    uint32_t PrevOldOffset = 0u;
+    for (const FTLSFAllocator::FMove& Move : Moves)
+    {
+        CHECK(Move.NewOffset <= Move.OldOffset);
+        CHECK(Move.OldOffset >= PrevOldOffset);
+        PrevOldOffset = Move.OldOffset;
+        CHECK(Allocator.GetOffset(Move.Node) == Move.NewOffset);
+    }
+    for (uint32_t i = 1; i < 10u; i += 2u)
+    {
+        // Same node, packed in the original order.
+        CHECK(Allocator.GetOffset(Allocations[i].Node) == ExpectedOffset);
+        ExpectedOffset += Allocations[i].Size;
+    }
+    CHECK(Allocator.GetUsedSize() == ExpectedOffset);
+}
+
+TEST(TLSFAllocator, RandomAllocationsStayConsistent)
+{
+    FTLSFAllocator Allocator(1u << 16u);
+    FLiveMap Live;
+    std::mt19937 Random(42u);
+
+    uint32_t NumFailed = 0u;
+    for (uint32_t Step = 0; Step < 20000u; Step++)
+    {
+        const uint32_t Action = Random() % 100u;
+        if (Action < 55u || Live.empty())
+        {
+            // Mostly small, sometimes large, like meshes.
+            const uint32_t Size = 1u + (Random() % 8u == 0u ? Random() % 8192u : Random() % 256u);
+            const std::optional<FTLSFAllocator::FAllocation> Allocation = Allocator.Allocate(Size);
+            if (!Allocation)
+            {
+                NumFailed++;
+                // The fallback scan finds any block that fits, so failing means there is none.
+                CHECK(Allocator.GetLargestFreeBlock() < Size);
+                continue;
+            }
+            CHECK(Allocation->Size >= Size);
+            CHECK(!Live.contains(Allocation->Node));
+            Live.emplace(Allocation->Node, *Allocation);
+        }
+        else if (Action < 98u)
+        {
+            auto It = Live.begin();
+            std::advance(It, Random() % Live.size());
+            Allocator.Free(It->first);
+            Live.erase(It);
+        }
+        else
+        {
+            for (const FTLSFAllocator::FMove& Move : Allocator.Compact())
+            {
+                CHECK(Live.at(Move.Node).Offset == Move.OldOffset);
+                Live.at(Move.Node).Offset = Move.NewOffset;
+            }
+            CHECK(Allocator.GetFragmentation() == 0.f);
+        }
+
+        if (Step % 64u == 0u)
+        {
+            CHECK(IsConsistent(Allocator, Live));
+        }
+    }
+    CHECK(IsConsistent(Allocator, Live));
+    CHECK(NumFailed > 0u);
+
+    for (const auto& [Node, Allocation] : Live)
+    {
+        Allocator.Free(Node);
+    }
+    CHECK(Allocator.GetUsedSize() == 0u);
+    CHECK(Allocator.GetLargestFreeBlock() == Allocator.GetCapacity());
+}
+
+TEST(TLSFAllocatorBenchmark, RandomChurn)
+{
+    // A geometry pool kept around three quarters full while meshes stream in and out : every round frees a random
+    // quarter of the live allocations and refills up to the target with new sizes.
+    constexpr uint32_t Capacity = 1u << 26u;
+    constexpr uint32_t TargetUsedSize = Capacity / 4u * 3u;
+    constexpr uint32_t NumRounds = 200u;
+
+    // Drawn up front so only the allocator is timed. Mostly small, sometimes large, like meshes.
+    std::mt19937 Random(7u);
+    std::vector<uint32_t> Sizes(1u << 20u);
+    for (uint32_t& Size : Sizes)
+    {
+        Size = 1u + (Random() % 8u == 0u ? Random() % 65536u : Random() % 2048u);
+    }
+
+    FTLSFAllocator Allocator(Capacity);
+    std::vector<uint32_t> Live;
+    size_t NextSize = 0u;
+    uint64_t NumAllocations = 0u;
+    uint64_t NumFrees = 0u;
+    uint32_t NumFailed = 0u;
+    double AllocateMs = 0.0;
+    double FreeMs = 0.0;
+    double FragmentationSum = 0.0;
+    float MaxFragmentation = 0.f;
+
+    for (uint32_t Round = 0; Round <= NumRounds; Round++)
+    {
+        // The first round only fills.
+        if (Round > 0u)
+        {
+            const size_t NumVictims = Live.size() / 4u;
+            for (size_t i = 0; i < NumVictims; i++)
+            {
+                std::swap(Live[Live.size() - 1u - i], Live[Random() % (Live.size() - i)]);
+            }
+
+            const FBenchmarkTimer Timer;
+            for (size_t i = Live.size() - NumVictims; i < Live.size(); i++)
+            {
+                Allocator.Free(Live[i]);
+            }
+            FreeMs += Timer.GetElapsedMs();
+            Live.resize(Live.size() - NumVictims);
+            NumFrees += NumVictims;
+        }
+
+        const FBenchmarkTimer Timer;
+        while (Allocator.GetUsedSize() < TargetUsedSize)
+        {
+            const std::optional<FTLSFAllocator::FAllocation> Allocation = Allocator.Allocate(Sizes[NextSize++ % Sizes.size()]);
+            NumAllocations++;
+            if (!Allocation)
+            {
+                // Enough free space in total, but splintered.
+                NumFailed++;
+                break;
+            }
+            Live.push_back(Allocation->Node);
+        }
+        AllocateMs += Timer.GetElapsedMs();
+
+        if (Round > 0u)
+        {
+            FragmentationSum += Allocator.GetFragmentation();
+            MaxFragmentation = max(MaxFragmentation, Allocator.GetFragmentation());
+        }
+    }
+
+    const uint32_t UsedSize = Allocator.GetUsedSize();
+    const float Fragmentation = Allocator.GetFragmentation();
+    const uint32_t LargestFreeBlock = Allocator.GetLargestFreeBlock();
+
+    const FBenchmarkTimer CompactTimer;
+    const std::vector<FTLSFAllocator::FMove> Moves = Allocator.Compact();
+    const double CompactMs = CompactTimer.GetElapsedMs();
+
+    Log(std::format("{} rounds, {} live allocations, {:.1f}% used : allocate {:.1f} ns, free {:.1f} ns",
+        NumRounds, Live.size(), 100.0 * UsedSize / Capacity, AllocateMs * 1.0e6 / NumAllocations, FreeMs * 1.0e6 / NumFrees));
+    Log(std::format("Fragmentation {:.3f} at the end, {:.3f} average, {:.3f} peak, largest free block {} of {} free, {} failed allocations",
+        Fragmentation, FragmentationSum / NumRounds, MaxFragmentation, LargestFreeBlock, Capacity - UsedSize, NumFailed));
+    Log(std::format("Compact moved {} allocations in {:.2f} ms", Moves.size(), CompactMs));
+
+    CHECK(Allocator.GetNumAllocations() == Live.size());
+    CHECK(Allocator.GetUsedSize() == UsedSize);
+    CHECK(Allocator.GetFragmentation() == 0.f);
+    CHECK(Allocator.GetLargestFreeBlock() == Capacity - UsedSize);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <chrono>
+
+// Minimal self registering tests, run by CubiEngineTests without a device or window.
+// CubiEngineTests <Suite> runs one suite, no argument runs every suite except benchmarks.
+// CHECK throws, so only call it from the thread running the test and hand results from workers back through atomics.
+
+struct FTestCase
+{
+    const char* Suite;
+    const char* Name;
+    void (*Function)();
+};
+
+std::vector<FTestCase>& GetTestCases();
+
+struct FTestRegistrar
+{
+    FTestRegistrar(const char* Suite, const char* Name, void (*Function)())
+    {
+        GetTestCases().push_back({ Suite, Name, Function });
+    }
+};
+
+struct FTestFailure
+{
+    std::string Message;
+};
+
+#define TEST(Suite, Name) \
+    static void Suite##_##Name(); \
+    static const FTestRegistrar Suite##_##Name##_Registrar(#Suite, #Name, &Suite##_##Name); \
+    static void Suite##_##Name()
+
+#define CHECK(Condition) \
+    do \
+    { \
+        if (!(Condition)) \
+        { \
+            throw FTestFailure{ std::format("{}({}) : CHECK({}) failed", __FILE__, __LINE__, #Condition) }; \
+        } \
+    } while (false)
+
+// Benchmarks are suites whose name ends with Benchmark, they log their timings and only fail on wrong results.
+class FBenchmarkTimer
+{
+public:
+    FBenchmarkTimer() : Start(std::chrono::high_resolution_clock::now()) {}
+
+    double GetElapsedMs() const
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - Start).count();
+    }
+
+private:
+    std::chrono::high_resolution_clock::time_point Start;
+};
@@ -0,0 +1,49 @@
+#include "Test.h"
+
+std::vector<FTestCase>& GetTestCases()
+{
+    static std::vector<FTestCase> TestCases;
+    return TestCases;
+}
+
+int main(int Argc, char* Argv[])
+{
+    const std::string_view SuiteFilter = Argc > 1 ? Argv[1] : "";
+
+    uint32_t NumRun = 0u;
+    uint32_t NumFailed = 0u;
+    for (const FTestCase& TestCase : GetTestCases())
+    {
+        const std::string_view Suite = TestCase.Suite;
+        if (SuiteFilter.empty() ? Suite.ends_with("Benchmark") : Suite != SuiteFilter)
+        {
+            continue;
+        }
+
+        NumRun++;
+        try
+        {
+            TestCase.Function();
+            Log(std::format("[PASS] {}.{}", TestCase.Suite, TestCase.Name));
+        }
+        catch (const FTestFailure& Failure)
+        {
+            NumFailed++;
+            Log(std::format("[FAIL] {}.{} : {}", TestCase.Suite, TestCase.Name, Failure.Message));
+        }
+        catch (const std::exception& Exception)
+        {
+            NumFailed++;
+            Log(std::format("[FAIL] {}.{} : exception {}", TestCase.Suite, TestCase.Name, Exception.what()));
+        }
+    }
+
+    if (NumRun == 0u)
+    {
+        Log(std::format("No tests in suite {}.", SuiteFilter));
+        return 1;
+    }
+
+    Log(std::format("{} tests, {} failed.", NumRun, NumFailed));
+    return NumFailed == 0u ? 0 : 1;
+}
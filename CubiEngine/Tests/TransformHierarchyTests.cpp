@@ -0,0 +1,325 @@
+#include "Test.h"
+#include "Scene/TransformHierarchy.h"
+
+namespace
+{
+    const XMFLOAT4 IDENTITY_ROTATION{ 0.f, 0.f, 0.f, 1.f };
+    const XMFLOAT3 UNIT_SCALE{ 1.f, 1.f, 1.f };
+    // A quarter turn around y, takes +x to -z.
+    const XMFLOAT4 YAW_90{ 0.f, 0.70710678f, 0.f, 0.70710678f };
+
+    uint32_t AddTranslated(FTransformHierarchy& Hierarchy, uint32_t Parent, float X, float Y, float Z)
+    {
+        return Hierarchy.AddNode(Parent, XMFLOAT3{ X, Y, Z }, IDENTITY_ROTATION, UNIT_SCALE);
+    }
+
+    XMFLOAT3 GetWorldPosition(const FTransformHierarchy& Hierarchy, uint32_t Node)
+    {
+        XMFLOAT3 Position;
+        XMStoreFloat3(&Position, Hierarchy.GetWorldMatrix(Node).r[3]);
+        return Position;
+    }
+
+    bool IsNear(const XMFLOAT3& A, const XMFLOAT3& B)
+    {
+        return fabsf(A.x - B.x) < 1.e-4f && fabsf(A.y - B.y) < 1.e-4f && fabsf(A.z - B.z) < 1.e-4f;
+    }
+
+    bool IsNear(const XMMATRIX& A, const XMMATRIX& B)
+    {
+        Dx::XMFLOAT4X4 AF, BF;
+        XMStoreFloat4x4(&AF, A);
+        XMStoreFloat4x4(&BF, B);
+        for (uint32_t Row = 0; Row < 4u; Row++)
+        {
+            for (uint32_t Column = 0; Column < 4u; Column++)
+            {
+                // Relative past 1, deep chains compose large values.
+                const float Tolerance = 1.e-3f * max(1.f, max(fabsf(AF.m[Row][Column]), fabsf(BF.m[Row][Column])));
+                if (fabsf(AF.m[Row][Column] - BF.m[Row][Column]) > Tolerance)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    std::vector<uint32_t> GetSortedUpdatedNodes(const FTransformHierarchy& Hierarchy)
+    {
+        std::vector<uint32_t> Nodes(Hierarchy.GetUpdatedNodes().begin(), Hierarchy.GetUpdatedNodes().end());
+        std::sort(Nodes.begin(), Nodes.end());
+        return Nodes;
+    }
+
+    // Every parent has to be reported before its children.
+    bool IsParentFirst(const FTransformHierarchy& Hierarchy)
+    {
+        std::vector<uint8_t> Seen(Hierarchy.Num(), 0u);
+        for (const uint32_t Node : Hierarchy.GetUpdatedNodes())
+        {
+            const uint32_t Parent = Hierarchy.GetParent(Node);
+            if (Parent != FTransformHierarchy::INVALID_NODE && Hierarchy.WasUpdated(Parent) && !Seen[Parent])
+            {
+                return false;
+            }
+            Seen[Node] = 1u;
+        }
+        return true;
+    }
+
+    // The world matrix composed recursively from the local transforms, what the single pass has to match.
+    XMMATRIX ComposeWorldMatrix(const FTransformHierarchy& Hierarchy, uint32_t Node)
+    {
+        const XMMATRIX LocalMatrix = Dx::XMMatrixScalingFromVector(XMLoadFloat3(&Hierarchy.GetLocalScale(Node)))
+            * Dx::XMMatrixRotationQuaternion(XMLoadFloat4(&Hierarchy.GetLocalRotation(Node)))
+            * Dx::XMMatrixTranslationFromVector(XMLoadFloat3(&Hierarchy.GetLocalTranslation(Node)));
+        const uint32_t Parent = Hierarchy.GetParent(Node);
+        return Parent == FTransformHierarchy::INVALID_NODE ? LocalMatrix : LocalMatrix * ComposeWorldMatrix(Hierarchy, Parent);
+    }
+}
+
+TEST(TransformHierarchy, ChildrenFollowTheirParent)
+{
+    FTransformHierarchy Hierarchy;
+    const uint32_t Root = AddTranslated(Hierarchy, FTransformHierarchy::INVALID_NODE, 1.f, 0.f, 0.f);
+    const uint32_t Child = AddTranslated(Hierarchy, Root, 0.f, 2.f, 0.f);
+    const uint32_t GrandChild = AddTranslated(Hierarchy, Child, 0.f, 0.f, 3.f);
+    Hierarchy.Update();
+
+    CHECK(IsNear(GetWorldPosition(Hierarchy, GrandChild), XMFLOAT3{ 1.f, 2.f, 3.f }));
+
+    // Scale then rotation then translation, the parent's applied after the child's.
+    Hierarchy.SetLocalRotation(Root, YAW_90);
+    Hierarchy.SetLocalScale(Child, XMFLOAT3{ 2.f, 2.f, 2.f });
+    Hierarchy.Update();
+
+    CHECK(IsNear(GetWorldPosition(Hierarchy, Child), XMFLOAT3{ 1.f, 2.f, 0.f }));
+    // (0, 0, 3) doubled by the child, then turned to +x by the root.
+    CHECK(IsNear(GetWorldPosition(Hierarchy, GrandChild), XMFLOAT3{ 7.f, 2.f, 0.f }));
+
+    // Built from the matrix, the node lands where the recomposed one does.
+    FTransformHierarchy FromMatrices;
+    const uint32_t MatrixRoot = FromMatrices.AddNode(FTransformHierarchy::INVALID_NODE, ComposeWorldMatrix(Hierarchy, Root));
+    FromMatrices.AddNode(MatrixRoot, Dx::XMMatrixScaling(2.f, 2.f, 2.f) * Dx::XMMatrixTranslation(0.f, 2.f, 0.f));
+    FromMatrices.Update();
+    CHECK(IsNear(FromMatrices.GetWorldMatrix(1u), Hierarchy.GetWorldMatrix(Child)));
+}
+
+TEST(TransformHierarchy, DirtinessOnlyPropagatesDown)
+{
+    //      0
+    //    1   2
+    //  3       4
+    FTransformHierarchy Hierarchy;
+    AddTranslated(Hierarchy, FTransformHierarchy::INVALID_NODE, 0.f, 0.f, 0.f);
+    AddTranslated(Hierarchy, 0u, 1.f, 0.f, 0.f);
+    AddTranslated(Hierarchy, 0u, -1.f, 0.f, 0.f);
+    AddTranslated(Hierarchy, 1u, 0.f, 1.f, 0.f);
+    AddTranslated(Hierarchy, 2u, 0.f, -1.f, 0.f);
+
+    // New nodes are dirty.
+    Hierarchy.Update();
+    CHECK(Hierarchy.GetUpdatedNodes().size() == 5u);
+    CHECK(IsParentFirst(Hierarchy));
+
+    // Nothing changed, nothing updated, and last update's flags are cleared.
+    Hierarchy.Update();
+    CHECK(Hierarchy.GetUpdatedNodes().empty());
+    for (uint32_t Node = 0; Node < Hierarchy.Num(); Node++)
+    {
+        CHECK(!Hierarchy.WasUpdated(Node));
+    }
+
+    // A leaf moves alone, its parent and siblings stay put.
+    Hierarchy.SetLocalTranslation(3u, XMFLOAT3{ 0.f, 5.f, 0.f });
+    Hierarchy.Update();
+    CHECK(GetSortedUpdatedNodes(Hierarchy) == std::vector<uint32_t>{ 3u });
+
+    // An inner node takes its subtree along and nothing else.
+    Hierarchy.SetLocalScale(2u, XMFLOAT3{ 3.f, 3.f, 3.f });
+    Hierarchy.Update();
+    CHECK(GetSortedUpdatedNodes(Hierarchy) == (std::vector<uint32_t>{ 2u, 4u }));
+    CHECK(!Hierarchy.WasUpdated(0u) && !Hierarchy.WasUpdated(1u) && !Hierarchy.WasUpdated(3u));
+    CHECK(IsNear(GetWorldPosition(Hierarchy, 4u), XMFLOAT3{ -1.f, -3.f, 0.f }));
+
+    // The root takes everything.
+    Hierarchy.SetLocalTranslation(0u, XMFLOAT3{ 0.f, 0.f, 10.f });
+    Hierarchy.Update();
+    CHECK(Hierarchy.GetUpdatedNodes().size() == 5u);
+    CHECK(IsParentFirst(Hierarchy));
+    CHECK(IsNear(GetWorldPosition(Hierarchy, 3u), XMFLOAT3{ 1.f, 5.f, 10.f }));
+}
+
+TEST(TransformHierarchy, InverseFollowsTheWorldMatrix)
+{
+    FTransformHierarchy Hierarchy;
+    const uint32_t Root = AddTranslated(Hierarchy, FTransformHierarchy::INVALID_NODE, 1.f, 2.f, 3.f);
+    const uint32_t Child = Hierarchy.AddNode(Root, XMFLOAT3{ 0.f, 1.f, 0.f }, YAW_90, XMFLOAT3{ 2.f, 2.f, 2.f });
+    Hierarchy.Update();
+
+    CHECK(IsNear(Hierarchy.GetInverseWorldMatrix(Child) * Hierarchy.GetWorldMatrix(Child), Dx::XMMatrixIdentity()));
+
+    // The cached inverse is refreshed once the parent moved the child.
+    Hierarchy.SetLocalTranslation(Root, XMFLOAT3{ -4.f, 0.f, 0.f });
+    Hierarchy.Update();
+    CHECK(IsNear(Hierarchy.GetInverseWorldMatrix(Child) * Hierarchy.GetWorldMatrix(Child), Dx::XMMatrixIdentity()));
+    CHECK(IsNear(Hierarchy.GetInverseWorldMatrix(Root), Dx::XMMatrixTranslation(4.f, 0.f, 0.f)));
+}
+
+TEST(TransformHierarchy, SetParentKeepsTheLocalTransform)
+{
+    FTransformHierarchy Hierarchy;
+    const uint32_t A = AddTranslated(Hierarchy, FTransformHierarchy::INVALID_NODE, 10.f, 0.f, 0.f);
+    const uint32_t B = AddTranslated(Hierarchy, FTransformHierarchy::INVALID_NODE, 0.f, 20.f, 0.f);
+    const uint32_t Child = AddTranslated(Hierarchy, A, 1.f, 1.f, 1.f);
+    const uint32_t GrandChild = AddTranslated(Hierarchy, Child, 0.f, 0.f, 1.f);
+    Hierarchy.Update();
+    CHECK(IsNear(GetWorldPosition(Hierarchy, GrandChild), XMFLOAT3{ 11.f, 1.f, 2.f }));
+
+    // Under an earlier node : the storage order is still valid, only the moved subtree updates.
+    CHECK(Hierarchy.SetParent(Child, B));
+    CHECK(Hierarchy.GetParent(Child) == B);
+    Hierarchy.Update();
+    CHECK(GetSortedUpdatedNodes(Hierarchy) == (std::vector<uint32_t>{ Child, GrandChild }));
+    CHECK(IsNear(GetWorldPosition(Hierarchy, Child), XMFLOAT3{ 1.f, 21.f, 1.f }));
+    CHECK(IsNear(GetWorldPosition(Hierarchy, GrandChild), XMFLOAT3{ 1.f, 21.f, 2.f }));
+
+    // The same parent again is not a change.
+    CHECK(Hierarchy.SetParent(Child, B));
+    Hierarchy.Update();
+    CHECK(Hierarchy.GetUpdatedNodes().empty());
+
+    // Detached, the local transform becomes the world transform.
+    CHECK(Hierarchy.SetParent(Child, FTransformHierarchy::INVALID_NODE));
+    Hierarchy.Update();
+    CHECK(IsNear(GetWorldPosition(Hierarchy, GrandChild), XMFLOAT3{ 1.f, 1.f, 2.f }));
+
+    // Moving B afterwards no longer drags the detached subtree.
+    Hierarchy.SetLocalTranslation(B, XMFLOAT3{ 0.f, 30.f, 0.f });
+    Hierarchy.Update();
+    CHECK(GetSortedUpdatedNodes(Hierarchy) == std::vector<uint32_t>{ B });
+}
+
+TEST(TransformHierarchy, SetParentUnderALaterNodeReordersTheUpdate)
+{
+    FTransformHierarchy Hierarchy;
+    const uint32_t Moved = AddTranslated(Hierarchy, FTransformHierarchy::INVALID_NODE, 1.f, 0.f, 0.f);
+    const uint32_t MovedChild = AddTranslated(Hierarchy, Moved, 0.f, 1.f, 0.f);
+    const uint32_t Root = AddTranslated(Hierarchy, FTransformHierarchy::INVALID_NODE, 0.f, 0.f, 5.f);
+    const uint32_t Leaf = AddTranslated(Hierarchy, Root, 0.f, 0.f, 5.f);
+    Hierarchy.Update();
+
+    // Node indices stay, the subtree now updates after its new ancestors.
+    CHECK(Hierarchy.SetParent(Moved, Leaf));
+    Hierarchy.Update();
+    CHECK(IsNear(GetWorldPosition(Hierarchy, Moved), XMFLOAT3{ 1.f, 0.f, 10.f }));
+    CHECK(IsNear(GetWorldPosition(Hierarchy, MovedChild), XMFLOAT3{ 1.f, 1.f, 10.f }));
+
+    // Moving the new root in the same update as the subtree still composes parent first.
+    Hierarchy.SetLocalTranslation(Root, XMFLOAT3{ 0.f, 0.f, -5.f });
+    Hierarchy.SetLocalTranslation(MovedChild, XMFLOAT3{ 0.f, 2.f, 0.f });
+    Hierarchy.Update();
+    CHECK(Hierarchy.GetUpdatedNodes().size() == 4u);
+    CHECK(IsParentFirst(Hierarchy));
+    CHECK(IsNear(GetWorldPosition(Hierarchy, MovedChild), XMFLOAT3{ 1.f, 2.f, 0.f }));
+}
+
+TEST(TransformHierarchy, SetParentRejectsCycles)
+{
+    FTransformHierarchy Hierarchy;
+    const uint32_t Root = AddTranslated(Hierarchy, FTransformHierarchy::INVALID_NODE, 1.f, 0.f, 0.f);
+    const uint32_t Child = AddTranslated(Hierarchy, Root, 0.f, 1.f, 0.f);
+    const uint32_t GrandChild = AddTranslated(Hierarchy, Child, 0.f, 0.f, 1.f);
+    Hierarchy.Update();
+
+    CHECK(!Hierarchy.SetParent(Root, Root));
+    CHECK(!Hierarchy.SetParent(Root, GrandChild));
+    CHECK(!Hierarchy.SetParent(Child, GrandChild));
+
+    // Nothing changed.
+    CHECK(Hierarchy.GetParent(Root) == FTransformHierarchy::INVALID_NODE);
+    CHECK(Hierarchy.GetParent(Child) == Root);
+    Hierarchy.Update();
+    CHECK(Hierarchy.GetUpdatedNodes().empty());
+    CHECK(IsNear(GetWorldPosition(Hierarchy, GrandChild), XMFLOAT3{ 1.f, 1.f, 1.f }));
+}
+
+TEST(TransformHierarchy, AppendKeepsTheUpdateOrder)
+{
+    FTransformHierarchy Base;
+    AddTranslated(Base, FTransformHierarchy::INVALID_NODE, 100.f, 0.f, 0.f);
+
+    // Reparented before being appended, its order has to come along with its nodes.
+    FTransformHierarchy Other;
+    const uint32_t Moved = AddTranslated(Other, FTransformHierarchy::INVALID_NODE, 1.f, 0.f, 0.f);
+    const uint32_t Parent = AddTranslated(Other, FTransformHierarchy::INVALID_NODE, 0.f, 3.f, 0.f);
+    CHECK(Other.SetParent(Moved, Parent));
+
+    const uint32_t Offset = Base.Append(Other);
+    CHECK(Offset == 1u);
+    CHECK(Base.Num() == 3u);
+    CHECK(Base.GetParent(Offset + Moved) == Offset + Parent);
+
+    Base.Update();
+    CHECK(Base.GetUpdatedNodes().size() == 3u);
+    CHECK(IsParentFirst(Base));
+    CHECK(IsNear(GetWorldPosition(Base, Offset + Moved), XMFLOAT3{ 1.f, 3.f, 0.f }));
+}
+
+TEST(TransformHierarchy, RandomEditsMatchRecursiveComposition)
+{
+    std::mt19937 Random(7u);
+    const auto RandomFloat = [&Random](float Min, float Max) { return std::uniform_real_distribution<float>(Min, Max)(Random); };
+    const auto RandomRotation = [&]() {
+        XMFLOAT4 Rotation;
+        XMStoreFloat4(&Rotation, Dx::XMQuaternionNormalize(XMVectorSet(RandomFloat(-1.f, 1.f), RandomFloat(-1.f, 1.f), RandomFloat(-1.f, 1.f), RandomFloat(0.1f, 1.f))));
+        return Rotation;
+    };
+
+    constexpr uint32_t NumNodes = 200u;
+    FTransformHierarchy Hierarchy;
+    for (uint32_t Node = 0; Node < NumNodes; Node++)
+    {
+        const uint32_t Parent = Node == 0u || Random() % 8u == 0u ? FTransformHierarchy::INVALID_NODE : static_cast<uint32_t>(Random() % Node);
+        Hierarchy.AddNode(Parent, XMFLOAT3{ RandomFloat(-2.f, 2.f), RandomFloat(-2.f, 2.f), RandomFloat(-2.f, 2.f) }, RandomRotation(), XMFLOAT3{ 1.f, 1.f, 1.f });
+    }
+
+    for (uint32_t Iteration = 0; Iteration < 100u; Iteration++)
+    {
+        for (uint32_t Edit = 0; Edit < 5u; Edit++)
+        {
+            const uint32_t Node = static_cast<uint32_t>(Random() % NumNodes);
+            switch (Random() % 4u)
+            {
+            case 0u:
+                Hierarchy.SetLocalTranslation(Node, XMFLOAT3{ RandomFloat(-2.f, 2.f), RandomFloat(-2.f, 2.f), RandomFloat(-2.f, 2.f) });
+                break;
+            case 1u:
+                Hierarchy.SetLocalRotation(Node, RandomRotation());
+                break;
+            case 2u:
+                Hierarchy.SetLocalScale(Node, XMFLOAT3{ RandomFloat(0.8f, 1.2f), RandomFloat(0.8f, 1.2f), RandomFloat(0.8f, 1.2f) });
+                break;
+            default:
+            {
+                // Any node, later ones included : cycles are refused and change nothing.
+                const uint32_t NewParent = Random() % 4u == 0u ? FTransformHierarchy::INVALID_NODE : static_cast<uint32_t>(Random() % NumNodes);
+                const uint32_t OldParent = Hierarchy.GetParent(Node);
+                if (!Hierarchy.SetParent(Node, NewParent))
+                {
+                    CHECK(Hierarchy.GetParent(Node) == OldParent);
+                }
+                break;
+            }
+            }
+        }
+
+        Hierarchy.Update();
+        CHECK(IsParentFirst(Hierarchy));
+        for (uint32_t Node = 0; Node < NumNodes; Node++)
+        {
+            CHECK(IsNear(Hierarchy.GetWorldMatrix(Node), ComposeWorldMatrix(Hierarchy, Node)));
+        }
+    }
+}
@@ -0,0 +1,174 @@
+#include "Test.h"
+#include "Graphics/TransientAliasing.h"
+
+namespace
+{
+    constexpr uint64_t KB = 1024u;
+    constexpr uint64_t HEAP_ALIGNMENT = 64u * KB;
+
+    FTransientResourceDesc MakeResource(uint64_t Size, uint32_t FirstPass, uint32_t LastPass, uint32_t HeapCategory = 0u)
+    {
+        return FTransientResourceDesc{
+            .Size = Size,
+            .Alignment = HEAP_ALIGNMENT,
+            .FirstPass = FirstPass,
+            .LastPass = LastPass,
+            .HeapCategory = HeapCategory,
+        };
+    }
+
+    bool LifetimesOverlap(const FTransientResourceDesc& A, const FTransientResourceDesc& B)
+    {
+        return A.FirstPass <= B.LastPass && B.FirstPass <= A.LastPass;
+    }
+
+    bool MemoryOverlaps(const FTransientPlacement& A, uint64_t SizeA, const FTransientPlacement& B, uint64_t SizeB)
+    {
+        return A.Heap == B.Heap && A.Offset < B.Offset + SizeB && B.Offset < A.Offset + SizeA;
+    }
+}
+
+TEST(TransientAliasing, DisjointLifetimesShareMemory)
+{
+    const FTransientResourceDesc Resources[] = {
+        MakeResource(256u * KB, 0u, 1u),
+        MakeResource(256u * KB, 2u, 3u),
+    };
+    const FTransientAliasingPlan Plan = PlanTransientAliasing(Resources, HEAP_ALIGNMENT);
+
+    CHECK(Plan.Heaps.size() == 1u);
+    CHECK(Plan.Placements[0].Offset == Plan.Placements[1].Offset);
+    CHECK(Plan.HeapBytes == 256u * KB);
+    CHECK(Plan.UnaliasedBytes == 512u * KB);
+
+    // The first one takes the memory over from the previous frame, the second from the first.
+    CHECK(Plan.Barriers.size() == 2u);
+    CHECK((Plan.Barriers[0] == FTransientAliasingBarrier{ .Pass = 0u, .ResourceBefore = INVALID_INDEX_U32, .ResourceAfter = 0u }));
+    CHECK((Plan.Barriers[1] == FTransientAliasingBarrier{ .Pass = 2u, .ResourceBefore = 0u, .ResourceAfter = 1u }));
+}
+
+TEST(TransientAliasing, OverlappingLifetimesGetTheirOwnMemory)
+{
+    const FTransientResourceDesc Resources[] = {
+        MakeResource(256u * KB, 0u, 2u),
+        MakeResource(256u * KB, 2u, 3u),
+    };
+    const FTransientAliasingPlan Plan = PlanTransientAliasing(Resources, HEAP_ALIGNMENT);
+
+    CHECK(!MemoryOverlaps(Plan.Placements[0], Resources[0].Size, Plan.Placements[1], Resources[1].Size));
+    CHECK(Plan.HeapBytes == Plan.UnaliasedBytes);
+    // Alone in their memory, neither needs an aliasing barrier.
+    CHECK(Plan.Barriers.empty());
+}
+
+TEST(TransientAliasing, CategoriesNeverShareAHeap)
+{
+    const FTransientResourceDesc Resources[] = {
+        MakeResource(128u * KB, 0u, 0u, 0u),
+        MakeResource(128u * KB, 1u, 1u, 1u),
+        MakeResource(128u * KB, 2u, 2u, 0u),
+    };
+    const FTransientAliasingPlan Plan = PlanTransientAliasing(Resources, HEAP_ALIGNMENT);
+
+    CHECK(Plan.Heaps.size() == 2u);
+    CHECK(Plan.Placements[0].Heap == Plan.Placements[2].Heap);
+    CHECK(Plan.Placements[0].Heap != Plan.Placements[1].Heap);
+    for (uint32_t Index = 0; Index < 3u; Index++)
+    {
+        CHECK(Plan.Heaps[Plan.Placements[Index].Heap].HeapCategory == Resources[Index].HeapCategory);
+    }
+}
+
+TEST(TransientAliasing, SeveralPreviousOwnersNameNoResource)
+{
+    // Two halves alive together, then one resource over both of them.
+    const FTransientResourceDesc Resources[] = {
+        MakeResource(512u * KB, 1u, 1u),
+        MakeResource(256u * KB, 0u, 0u),
+        MakeResource(256u * KB, 0u, 0u),
+    };
+    const FTransientAliasingPlan Plan = PlanTransientAliasing(Resources, HEAP_ALIGNMENT);
+
+    CHECK(Plan.HeapBytes == 512u * KB);
+
+    const auto Barrier = std::find_if(Plan.Barriers.begin(), Plan.Barriers.end(),
+        [](const FTransientAliasingBarrier& Barrier) { return Barrier.ResourceAfter == 0u; });
+    CHECK(Barrier != Plan.Barriers.end());
+    CHECK(Barrier->Pass == 1u);
+    CHECK(Barrier->ResourceBefore == INVALID_INDEX_U32);
+}
+
+TEST(TransientAliasing, RandomPlansAreValid)
+{
+    std::mt19937 Random(7u);
+    for (uint32_t Iteration = 0; Iteration < 200u; Iteration++)
+    {
+        std::vector<FTransientResourceDesc> Resources(1u + Random() % 24u);
+        for (FTransientResourceDesc& Resource : Resources)
+        {
+            const uint32_t FirstPass = static_cast<uint32_t>(Random() % 16u);
+            Resource = FTransientResourceDesc{
+                .Size = (1u + Random() % 64u) * 4u * KB,
+                .Alignment = (Random() % 4u == 0u) ? 4u * 1024u * KB : HEAP_ALIGNMENT,
+                .FirstPass = FirstPass,
+                .LastPass = FirstPass + static_cast<uint32_t>(Random() % 6u),
+                .HeapCategory = static_cast<uint32_t>(Random() % 2u),
+            };
+        }
+        const FTransientAliasingPlan Plan = PlanTransientAliasing(Resources, HEAP_ALIGNMENT);
+
+        CHECK(Plan.Placements.size() == Resources.size());
+        CHECK(Plan.HeapBytes <= Plan.UnaliasedBytes);
+
+        uint64_t HeapBytes = 0u;
+        for (const FTransientHeapDesc& Heap : Plan.Heaps)
+        {
+            CHECK(Heap.Size % Heap.Alignment == 0u);
+            HeapBytes += Heap.Size;
+        }
+        CHECK(HeapBytes == Plan.HeapBytes);
+
+        for (size_t A = 0; A < Resources.size(); A++)
+        {
+            const FTransientPlacement& Placement = Plan.Placements[A];
+            CHECK(Placement.Heap < Plan.Heaps.size());
+            CHECK(Plan.Heaps[Placement.Heap].HeapCategory == Resources[A].HeapCategory);
+            CHECK(Placement.Offset % Resources[A].Alignment == 0u);
+            CHECK(Placement.Offset + Resources[A].Size <= Plan.Heaps[Placement.Heap].Size);
+
+            for (size_t B = A + 1u; B < Resources.size(); B++)
+            {
+                if (LifetimesOverlap(Resources[A], Resources[B]))
+                {
+                    CHECK(!MemoryOverlaps(Placement, Resources[A].Size, Plan.Placements[B], Resources[B].Size));
+                }
+            }
+        }
+
+        // Every resource sharing memory with another gets exactly one barrier, at its first pass.
+        for (uint32_t Index = 0; Index < Resources.size(); Index++)
+        {
+            bool bShared = false;
+            for (uint32_t Other = 0; Other < Resources.size(); Other++)
+            {
+                bShared |= Other != Index
+                    && MemoryOverlaps(Plan.Placements[Index], Resources[Index].Size, Plan.Placements[Other], Resources[Other].Size);
+            }
+
+            const auto NumBarriers = std::count_if(Plan.Barriers.begin(), Plan.Barriers.end(),
+                [Index](const FTransientAliasingBarrier& Barrier) { return Barrier.ResourceAfter == Index; });
+            CHECK(NumBarriers == (bShared ? 1 : 0));
+        }
+        for (const FTransientAliasingBarrier& Barrier : Plan.Barriers)
+        {
+            CHECK(Barrier.Pass == Resources[Barrier.ResourceAfter].FirstPass);
+            if (Barrier.ResourceBefore != INVALID_INDEX_U32)
+            {
+                CHECK(Resources[Barrier.ResourceBefore].LastPass < Barrier.Pass);
+            }
+        }
+        CHECK(std::is_sorted(Plan.Barriers.begin(), Plan.Barriers.end(), [](const FTransientAliasingBarrier& A, const FTransientAliasingBarrier& B) {
+            return A.Pass != B.Pass ? A.Pass < B.Pass : A.ResourceAfter < B.ResourceAfter;
+        }));
+    }
+}
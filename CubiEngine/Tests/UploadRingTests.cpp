@@ -0,0 +1,164 @@
+#include "Test.h"
+#include "Graphics/UploadRing.h"
+#include "Graphics/FenceWatcher.h"
+
+#include <random>
+
+TEST(UploadRing, AllocationsAreAlignedAndPacked)
+{
+    FUploadRingAllocator Ring(1024u);
+
+    CHECK(Ring.Allocate(10u, 1u) == 0u);
+    CHECK(Ring.Allocate(16u, 256u) == 256u);
+    // Alignment padding counts as used until the batch retires.
+    CHECK(Ring.GetUsedBytes() == 256u + 16u);
+    CHECK(Ring.Allocate(4u, 4u) == 272u);
+    CHECK(!Ring.HasPendingBatches());
+}
+
+TEST(UploadRing, FullRingFailsUntilBatchRetires)
+{
+    FFakeFence Fence;
+    FUploadRingAllocator Ring(256u);
+
+    CHECK(Ring.Allocate(192u, 1u) == 0u);
+    Ring.CloseBatch(1u);
+    CHECK(Ring.HasPendingBatches());
+    CHECK(Ring.GetOldestPendingFenceValue() == 1u);
+    CHECK(!Ring.Allocate(128u, 1u).has_value());
+
+    // Not completed yet, nothing comes back.
+    Ring.Retire(Fence.GetCompletedValue());
+    CHECK(Ring.GetUsedBytes() == 192u);
+    CHECK(!Ring.Allocate(128u, 1u).has_value());
+
+    Fence.Signal(1u);
+    Ring.Retire(Fence.GetCompletedValue());
+    CHECK(!Ring.HasPendingBatches());
+    CHECK(Ring.GetUsedBytes() == 0u);
+    // An empty ring starts over at the front.
+    CHECK(Ring.Allocate(128u, 1u) == 0u);
+}
+
+TEST(UploadRing, BatchesRetireInFenceOrder)
+{
+    FFakeFence Fence;
+    FUploadRingAllocator Ring(1024u);
+
+    Ring.Allocate(100u, 1u);
+    Ring.CloseBatch(1u);
+    Ring.Allocate(200u, 1u);
+    Ring.CloseBatch(2u);
+    Ring.Allocate(300u, 1u);
+    Ring.CloseBatch(3u);
+    CHECK(Ring.GetUsedBytes() == 600u);
+
+    Fence.Signal(2u);
+    Ring.Retire(Fence.GetCompletedValue());
+    CHECK(Ring.GetUsedBytes() == 300u);
+    CHECK(Ring.GetOldestPendingFenceValue() == 3u);
+
+    Fence.Signal(3u);
+    Ring.Retire(Fence.GetCompletedValue());
+    CHECK(Ring.GetUsedBytes() == 0u);
+}
+
+TEST(UploadRing, CloseWithoutAllocationsIsNoOp)
+{
+    FUploadRingAllocator Ring(256u);
+    Ring.CloseBatch(1u);
+    CHECK(!Ring.HasPendingBatches());
+
+    Ring.Allocate(16u, 1u);
+    Ring.CloseBatch(2u);
+    Ring.CloseBatch(3u);
+    CHECK(Ring.GetOldestPendingFenceValue() == 2u);
+    Ring.Retire(2u);
+    CHECK(!Ring.HasPendingBatches());
+}
+
+TEST(UploadRing, WrapSkipsEndAndRetiresPadding)
+{
+    FUploadRingAllocator Ring(256u);
+
+    CHECK(Ring.Allocate(128u, 1u) == 0u);
+    Ring.CloseBatch(1u);
+    CHECK(Ring.Allocate(64u, 1u) == 128u);
+    Ring.CloseBatch(2u);
+    Ring.Retire(1u);
+
+    // [192, 256) is too small, the allocation wraps and the skipped 64 bytes count against its batch.
+    CHECK(Ring.Allocate(100u, 1u) == 0u);
+    CHECK(Ring.GetUsedBytes() == 64u + 64u + 100u);
+    Ring.CloseBatch(3u);
+
+    // Only [100, 128) is free now.
+    CHECK(!Ring.Allocate(64u, 1u).has_value());
+    CHECK(Ring.Allocate(28u, 1u) == 100u);
+    Ring.CloseBatch(4u);
+    CHECK(!Ring.Allocate(1u, 1u).has_value());
+
+    Ring.Retire(4u);
+    CHECK(Ring.GetUsedBytes() == 0u);
+}
+
+TEST(UploadRing, RandomFramesNeverOverlapLiveAllocations)
+{
+    constexpr uint64_t Capacity = 64u * 1024u;
+    FFakeFence Fence;
+    FUploadRingAllocator Ring(Capacity);
+
+    struct FLiveRange
+    {
+        uint64_t FenceValue;
+        uint64_t Begin;
+        uint64_t End;
+    };
+    std::vector<FLiveRange> Live;
+
+    std::mt19937 Random(1234u);
+    uint64_t FenceValue = 0u;
+    uint32_t NumFailed = 0u;
+    for (uint32_t Frame = 0; Frame < 2000u; Frame++)
+    {
+        FenceValue++;
+        const uint32_t NumUploads = Random() % 8u;
+        for (uint32_t i = 0; i < NumUploads; i++)
+        {
+            const uint64_t Size = 1u + Random() % 8192u;
+            const uint64_t Alignment = 1ull << (Random() % 10u);
+            const std::optional<uint64_t> Offset = Ring.Allocate(Size, Alignment);
+            if (!Offset)
+            {
+                NumFailed++;
+                continue;
+            }
+
+            CHECK(*Offset % Alignment == 0u);
+            CHECK(*Offset + Size <= Capacity);
+            for (const FLiveRange& Range : Live)
+            {
+                CHECK(*Offset + Size <= Range.Begin || *Offset >= Range.End);
+            }
+            Live.push_back(FLiveRange{ FenceValue, *Offset, *Offset + Size });
+            CHECK(Ring.GetUsedBytes() <= Capacity);
+        }
+        Ring.CloseBatch(FenceValue);
+
+        // The GPU runs up to three frames behind.
+        if (FenceValue > FRAMES_IN_FLIGHT)
+        {
+            Fence.Signal(FenceValue - FRAMES_IN_FLIGHT);
+        }
+        Ring.Retire(Fence.GetCompletedValue());
+        std::erase_if(Live, [&Fence](const FLiveRange& Range) { return Range.FenceValue <= Fence.GetCompletedValue(); });
+    }
+
+    // Three frames of at most 56 KB do not always fit 64 KB, some uploads have to wait.
+    CHECK(NumFailed > 0u);
+
+    Fence.Signal(FenceValue);
+    Ring.Retire(Fence.GetCompletedValue());
+    CHECK(Ring.GetUsedBytes() == 0u);
+    CHECK(!Ring.HasPendingBatches());
+}
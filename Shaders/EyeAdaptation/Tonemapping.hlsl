@@ -30,6 +30,20 @@ float3 Tonemap_ACES(float3 x) {
 #define TONEMAPPING_REINHARD_MODIFIED 2
 #define TONEMAPPING_ACES 3
 
+// Permutation dimensions, FEyeAdaptationPass compiles one variant per combination.
+#ifndef TONEMAPPING_METHOD
+#define TONEMAPPING_METHOD TONEMAPPING_REINHARD
+#endif
+#ifndef GAMMA_CORRECTION
+#define GAMMA_CORRECTION 1
+#endif
+#ifndef USE_BLOOM
+#define USE_BLOOM 1
+#endif
+#ifndef USE_EYE_ADAPTATION
+#define USE_EYE_ADAPTATION 1
+#endif
+
 [numthreads(8, 8, 1)]
 void CsMain(uint3 dispatchThreadID : SV_DispatchThreadID)
 {
@@ -41,41 +55,37 @@ void CsMain(uint3 dispatchThreadID : SV_DispatchThreadID)
     
     float3 color = srcTexture.Sample(pointClampSampler, uv).xyz;
     
-    if (renderResources.bloomTextureIndex != INVALID_INDEX)
+#if USE_BLOOM
     {
         Texture2D<float4> bloomTexture = ResourceDescriptorHeap[renderResources.bloomTextureIndex];
         color = color + bloomTexture.Sample(pointClampSampler, uv).xyz;
     }
+#endif
 
-    if (renderResources.averageLuminanceBufferIndex != INVALID_INDEX)
+#if USE_EYE_ADAPTATION
     {
         StructuredBuffer<float4> averageLuminanceBuffer = ResourceDescriptorHeap[renderResources.averageLuminanceBufferIndex];
         float averageLuminance = averageLuminanceBuffer[0].x;
         color = color / (9.6 * averageLuminance);
     }
+#endif
 
-    if (renderResources.toneMappingMethod == TONEMAPPING_REINHARD)
-    {
-        color = Reinhard(color);
-    }
-    else if (renderResources.toneMappingMethod == TONEMAPPING_REINHARD_MODIFIED)
-    {
-        color = ReinhardModifed(color);
-    }
-    else if (renderResources.toneMappingMethod == TONEMAPPING_ACES)
-    {
-        color = Tonemap_ACES(color);
-    }
-    else
-    {
-        color = clamp(color, 0, 1);
-    }
+#if TONEMAPPING_METHOD == TONEMAPPING_REINHARD
+    color = Reinhard(color);
+#elif TONEMAPPING_METHOD == TONEMAPPING_REINHARD_MODIFIED
+    color = ReinhardModifed(color);
+#elif TONEMAPPING_METHOD == TONEMAPPING_ACES
+    color = Tonemap_ACES(color);
+#else
+    color = clamp(color, 0, 1);
+#endif
 
-    if (renderResources.bGammaCorrection)
+#if GAMMA_CORRECTION
     {
         float gamma = rcp(2.2f);
         color = pow(color, gamma);
     }
+#endif
 
     dstTexture[dispatchThreadID.xy] = float4(color, 1.f);
 }
\ No newline at end of file
@@ -99,10 +99,11 @@ interlop::MeshVertex GetHitSurface(in Attributes attr, BufferIndexContext contex
     StructuredBuffer<float3> tangentBuffer = ResourceDescriptorHeap[geoInfo.tangentBufferIndex];
     StructuredBuffer<uint> idxBuffer = ResourceDescriptorHeap[geoInfo.indexBufferIndex];
 
+    // The mesh is a range of the geometry pool, its indices are relative to its first vertex.
     const uint primIdx = PrimitiveIndex();
-    const uint idx0 = idxBuffer[primIdx * 3];
-    const uint idx1 = idxBuffer[primIdx * 3+1];
-    const uint idx2 = idxBuffer[primIdx * 3+2];
+    const uint idx0 = geoInfo.vertexOffset + idxBuffer[geoInfo.indexOffset + primIdx * 3];
+    const uint idx1 = geoInfo.vertexOffset + idxBuffer[geoInfo.indexOffset + primIdx * 3+1];
+    const uint idx2 = geoInfo.vertexOffset + idxBuffer[geoInfo.indexOffset + primIdx * 3+2];
 
     interlop::MeshVertex vtx0;
     vtx0.position = positionBuffer[idx0];
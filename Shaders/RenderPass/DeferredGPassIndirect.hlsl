@@ -0,0 +1,49 @@
+#include "RenderPass/DeferredGPassCommon.hlsli"
+
+ConstantBuffer<interlop::DeferredGPassIndirectRenderResources> indirectRenderResources : register(b0);
+
+interlop::DeferredGPassRenderResources loadRenderResources()
+{
+    StructuredBuffer<interlop::InstanceData> instanceBuffer = ResourceDescriptorHeap[indirectRenderResources.instanceBufferIndex];
+    const interlop::InstanceData instance = instanceBuffer[indirectRenderResources.instanceIndex];
+
+    interlop::DeferredGPassRenderResources renderResources;
+    renderResources.modelMatrix = instance.modelMatrix;
+    renderResources.inverseModelMatrix = instance.inverseModelMatrix;
+
+    renderResources.positionBufferIndex = instance.positionBufferIndex;
+    renderResources.textureCoordBufferIndex = instance.textureCoordBufferIndex;
+    renderResources.normalBufferIndex = instance.normalBufferIndex;
+    renderResources.tangentBufferIndex = instance.tangentBufferIndex;
+    renderResources.vertexOffset = instance.vertexOffset;
+
+    renderResources.debugBufferIndex = indirectRenderResources.debugBufferIndex;
+    renderResources.sceneBufferIndex = indirectRenderResources.sceneBufferIndex;
+
+    renderResources.albedoTextureIndex = instance.albedoTextureIndex;
+    renderResources.albedoTextureSamplerIndex = instance.albedoTextureSamplerIndex;
+    renderResources.metalRoughnessTextureIndex = instance.metalRoughnessTextureIndex;
+    renderResources.metalRoughnessTextureSamplerIndex = instance.metalRoughnessTextureSamplerIndex;
+    renderResources.normalTextureIndex = instance.normalTextureIndex;
+    renderResources.normalTextureSamplerIndex = instance.normalTextureSamplerIndex;
+    renderResources.aoTextureIndex = instance.aoTextureIndex;
+    renderResources.aoTextureSamplerIndex = instance.aoTextureSamplerIndex;
+    renderResources.emissiveTextureIndex = instance.emissiveTextureIndex;
+    renderResources.emissiveTextureSamplerIndex = instance.emissiveTextureSamplerIndex;
+    renderResources.ormTextureIndex = instance.ormTextureIndex;
+    renderResources.ormTextureSamplerIndex = instance.ormTextureSamplerIndex;
+
+    renderResources.materialIndex = instance.materialIndex;
+    renderResources.materialTableIndex = indirectRenderResources.materialTableIndex;
+    return renderResources;
+}
+
+VSOutput VsMain(uint vertexID : SV_VertexID) 
+{
+    return DeferredGPassVS(vertexID, loadRenderResources());
+}
+
+PsOutput PsMain(VSOutput psInput) 
+{
+    return DeferredGPassPS(psInput, loadRenderResources());
+}
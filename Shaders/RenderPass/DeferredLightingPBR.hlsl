@@ -27,6 +27,17 @@ float3 SingleScatteringIBL(float3 F0, float2 EnvBRDF, float3 diffuseColor, float
 #define DIFFUSE_METHOD_LAMBERTIAN 0
 #define DIFFUSE_METHOD_BURLEY 1
 
+// Permutation dimensions, FDeferredGPass compiles one variant per combination.
+#ifndef SHADOW_METHOD
+#define SHADOW_METHOD SHADOW_METHOD_SHADOWMAP
+#endif
+#ifndef USE_SSAO
+#define USE_SSAO 1
+#endif
+#ifndef DIFFUSE_METHOD
+#define DIFFUSE_METHOD DIFFUSE_METHOD_LAMBERTIAN
+#endif
+
 // A Multiple-Scattering Microfacet Model for Real-Time Image-based Lighting, from Fdez-Aguera
 // https://jcgt.org/published/0008/01/03/paper.pdf
 float3 MultipleScatteringIBL(float roughness, float3 F0, float NoV, float2 EnvBRDF, float3 albedo, float3 radiance, float3 irradiance)
@@ -96,15 +107,11 @@ float3 WhiteFurnaceSampling(float3 V, float3 N, float roughness, float metalic,
         
         if (context.NoL > 0)
         {
-            float3 diffuseTerm;
-            if (renderResources.diffuseMethod == DIFFUSE_METHOD_LAMBERTIAN)
-            {
-                diffuseTerm = lambertianDiffuseBRDF(albedo, context.VoH, metalic);
-            }
-            else
-            {
-                diffuseTerm = Fd_Burley(context.NoV, context.NoL, saturate(dot(L,H)), roughness, albedo, context.VoH, metalic);
-            }
+#if DIFFUSE_METHOD == DIFFUSE_METHOD_LAMBERTIAN
+            float3 diffuseTerm = lambertianDiffuseBRDF(albedo, context.VoH, metalic);
+#else
+            float3 diffuseTerm = Fd_Burley(context.NoV, context.NoL, saturate(dot(L,H)), roughness, albedo, context.VoH, metalic);
+#endif
 
             float3 sampleColor = context.NoL * diffuseTerm;
             color += sampleColor / pdf;
@@ -161,11 +168,12 @@ void CsMain(uint3 dispatchThreadID : SV_DispatchThreadID)
     if (depth < EPS) return;
 
     float ssao = 1.f;
-    if (renderResources.ssaoTextureIndex != -1)
+#if USE_SSAO
     {
         Texture2D<float> ssaoTexture = ResourceDescriptorHeap[renderResources.ssaoTextureIndex];
         ssao = ssaoTexture.Sample(pointClampSampler, uv);
     }
+#endif
 
     const float3 viewSpacePosition = viewSpaceCoordsFromDepthBuffer(depth, uv, sceneBuffer.inverseProjectionMatrix);
     const float3 V = normalize(-viewSpacePosition);
@@ -214,7 +222,7 @@ void CsMain(uint3 dispatchThreadID : SV_DispatchThreadID)
 
             float visibility = 1.f;
 
-            if (debugBuffer.ShadowMethod == SHADOW_METHOD_SHADOWMAP)
+#if SHADOW_METHOD == SHADOW_METHOD_SHADOWMAP
             {
                 float cascadeFarZ = sceneBuffer.farZ;
                 if (cascadeIndex < renderResources.numCascadeShadowMap-1)
@@ -226,22 +234,19 @@ void CsMain(uint3 dispatchThreadID : SV_DispatchThreadID)
                 
                 visibility = 1.f - shadow;
             }
-            else if (debugBuffer.ShadowMethod == SHADOW_METHOD_RAYTRACING)
+#elif SHADOW_METHOD == SHADOW_METHOD_RAYTRACING
             {
                 Texture2D<float4> RTShadowDepthTexture = ResourceDescriptorHeap[renderResources.rtShadowDepthTextureIndex];
                 const float RtShadowVisibility = RTShadowDepthTexture.Sample(pointClampSampler, uv).r;
                 visibility = RtShadowVisibility;
             }
+#endif
 
-            float3 diffuseTerm;
-            if (renderResources.diffuseMethod == DIFFUSE_METHOD_LAMBERTIAN)
-            {
-                diffuseTerm = lambertianDiffuseBRDF(albedo.xyz, context.VoH, metalic);
-            }
-            else
-            {
-                diffuseTerm = Fd_Burley(context.NoV, context.NoL, saturate(dot(L,H)), roughness, albedo.xyz, context.VoH, metalic);
-            }
+#if DIFFUSE_METHOD == DIFFUSE_METHOD_LAMBERTIAN
+            float3 diffuseTerm = lambertianDiffuseBRDF(albedo.xyz, context.VoH, metalic);
+#else
+            float3 diffuseTerm = Fd_Burley(context.NoV, context.NoL, saturate(dot(L,H)), roughness, albedo.xyz, context.VoH, metalic);
+#endif
             float3 specularTerm = CookTorrenceSpecular(roughness, metalic, F0, context) * energyCompensation;
             color += visibility * lightColor.xyz * lightIntensity * context.NoL * (diffuseTerm + max(specularTerm, float3(0,0,0))) * ssao * orm.x;
 
@@ -20,7 +20,7 @@ VSOutput VsMain(uint vertexID : SV_VertexID)
     const matrix mvpMatrix = mul(renderResources.modelMatrix, renderResources.lightViewProjectionMatrix);
 
     VSOutput output;
-    output.position = mul(float4(positionBuffer[vertexID], 1.0f), mvpMatrix);
+    output.position = mul(float4(positionBuffer[renderResources.vertexOffset + vertexID], 1.0f), mvpMatrix);
     return output;
 }
 
@@ -0,0 +1,33 @@
+// clang-format off
+
+#include "RootSignature/BindlessRS.hlsli"
+#include "ShaderInterlop/ConstantBuffers.hlsli"
+#include "ShaderInterlop/RenderResources.hlsli"
+#include "Utils.hlsli"
+
+struct VSOutput
+{
+    float4 position : SV_Position;
+};
+
+ConstantBuffer<interlop::ShadowDepthPassIndirectRenderResource> renderResources : register(b0);
+
+ 
+VSOutput VsMain(uint vertexID : SV_VertexID) 
+{
+    StructuredBuffer<interlop::InstanceData> instanceBuffer = ResourceDescriptorHeap[renderResources.instanceBufferIndex];
+    const interlop::InstanceData instance = instanceBuffer[renderResources.instanceIndex];
+
+    StructuredBuffer<float3> positionBuffer = ResourceDescriptorHeap[instance.positionBufferIndex];
+    
+    const matrix mvpMatrix = mul(instance.modelMatrix, renderResources.lightViewProjectionMatrix);
+
+    VSOutput output;
+    output.position = mul(float4(positionBuffer[instance.vertexOffset + vertexID], 1.0f), mvpMatrix);
+    return output;
+}
+
+ 
+void PsMain(VSOutput input) 
+{
+}
@@ -24,6 +24,8 @@ VSOutput VsMain(uint vertexID : SV_VertexID)
     const matrix mvpMatrix = mul(renderResources.modelMatrix, sceneBuffer.viewProjectionMatrix);
     const matrix mvMatrix = mul(renderResources.modelMatrix, sceneBuffer.viewMatrix);
 
+    vertexID += renderResources.vertexOffset;
+
     VSOutput output;
     output.position = mul(float4(positionBuffer[vertexID], 1.0f), mvpMatrix);
     output.textureCoord = textureCoordBuffer[vertexID];
@@ -40,10 +42,11 @@ struct PsOutput
  
 PsOutput PsMain(VSOutput psInput) 
 {
-    ConstantBuffer<interlop::MaterialBuffer> materialBuffer = ResourceDescriptorHeap[renderResources.materialBufferIndex];
+    StructuredBuffer<interlop::MaterialData> materialTable = ResourceDescriptorHeap[renderResources.materialTableIndex];
+    const interlop::MaterialData material = materialTable[renderResources.materialIndex];
 
     PsOutput output;
-    output.albedo = getAlbedo(psInput.textureCoord, renderResources.albedoTextureIndex, renderResources.albedoTextureSamplerIndex, materialBuffer.albedoColor);
+    output.albedo = getAlbedo(psInput.textureCoord, renderResources.albedoTextureIndex, renderResources.albedoTextureSamplerIndex, material.albedoColor);
     
     return output;
 }
\ No newline at end of file
@@ -49,7 +49,8 @@ namespace interlop
         uint frameCount;
     };
 
-    ConstantBufferStruct MaterialBuffer
+    // One slot of the material table, indexed by materialIndex.
+    struct MaterialData
     {
         float3 albedoColor;
         float roughnessFactor;
@@ -105,6 +106,39 @@ namespace interlop
         uint tangentBufferIndex;
         uint indexBufferIndex;
         uint materialIdx;
+        // Where the mesh starts in the geometry pool streams, indices are relative to vertexOffset.
+        uint vertexOffset;
+        uint indexOffset;
+    };
+
+    // Per draw data for indirect rendering, indexed by the instanceIndex root constant.
+    struct InstanceData
+    {
+        float4x4 modelMatrix;
+        float4x4 inverseModelMatrix;
+
+        uint positionBufferIndex;
+        uint textureCoordBufferIndex;
+        uint normalBufferIndex;
+        uint tangentBufferIndex;
+        uint vertexOffset;
+
+        uint albedoTextureIndex;
+        uint albedoTextureSamplerIndex;
+        uint metalRoughnessTextureIndex;
+        uint metalRoughnessTextureSamplerIndex;
+
+        uint normalTextureIndex;
+        uint normalTextureSamplerIndex;
+        uint aoTextureIndex;
+        uint aoTextureSamplerIndex;
+
+        uint emissiveTextureIndex;
+        uint emissiveTextureSamplerIndex;
+        uint ormTextureIndex;
+        uint ormTextureSamplerIndex;
+
+        uint materialIndex;
         float2 padding;
     };
 
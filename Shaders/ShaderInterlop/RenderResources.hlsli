@@ -28,7 +28,11 @@ namespace interlop
 
         uint albedoTextureIndex;
         uint albedoTextureSamplerIndex;
-        uint materialBufferIndex;
+        uint materialIndex;
+        uint materialTableIndex;
+
+        // First vertex of the mesh in the geometry pool streams, indices are relative to it.
+        uint vertexOffset;
     };
 
     struct DeferredGPassRenderResources
@@ -40,6 +44,7 @@ namespace interlop
         uint textureCoordBufferIndex;
         uint normalBufferIndex;
         uint tangentBufferIndex;
+        uint vertexOffset;
 
         uint debugBufferIndex;
         uint sceneBufferIndex;
@@ -59,7 +64,8 @@ namespace interlop
         uint ormTextureIndex;
         uint ormTextureSamplerIndex;
 
-        uint materialBufferIndex;
+        uint materialIndex;
+        uint materialTableIndex;
     };
 
     struct DeferredGPassCubeRenderResources
@@ -88,8 +94,7 @@ namespace interlop
         uint width;
         uint height;
 
-        uint toneMappingMethod;
-        uint bGammaCorrection;
+        // Tone mapping method and gamma correction are permutation dimensions.
         uint averageLuminanceBufferIndex;
     };
 
@@ -126,7 +131,6 @@ namespace interlop
         uint bUseEnergyCompensation;
         uint WhiteFurnaceMethod;
         uint bCSMDebug;
-        uint diffuseMethod;
         uint sampleBias;
 
     };
@@ -193,6 +197,26 @@ namespace interlop
         float4x4 lightViewProjectionMatrix;
 
         uint positionBufferIndex;
+        uint vertexOffset;
+    };
+
+    // instanceIndex must stay the first member, it is written by the indirect command signature.
+    struct DeferredGPassIndirectRenderResources
+    {
+        uint instanceIndex;
+        uint instanceBufferIndex;
+        uint sceneBufferIndex;
+        uint debugBufferIndex;
+        uint materialTableIndex;
+    };
+
+    struct ShadowDepthPassIndirectRenderResource
+    {
+        uint instanceIndex;
+        uint instanceBufferIndex;
+        float2 padding;
+
+        float4x4 lightViewProjectionMatrix;
     };
 
     struct TemporalAAResolveRenderResource